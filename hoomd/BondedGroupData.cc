@@ -14,6 +14,8 @@
 
 #include <pybind11/numpy.h>
 
+#include <algorithm>
+
 #ifdef ENABLE_HIP
 #include "BondedGroupData.cuh"
 #include "CachedAllocator.h"
@@ -43,7 +45,8 @@ template<unsigned int group_size, typename Group, const char *name, bool has_typ
 BondedGroupData<group_size, Group, name, has_type_mapping>::BondedGroupData(
     std::shared_ptr<ParticleData> pdata,
     unsigned int n_group_types)
-    : m_exec_conf(pdata->getExecConf()), m_pdata(pdata), m_n_groups(0), m_n_ghost(0), m_nglobal(0), m_groups_dirty(true)
+    : m_exec_conf(pdata->getExecConf()), m_pdata(pdata), m_n_groups(0), m_n_ghost(0), m_nglobal(0), m_groups_dirty(true),
+      m_idx_table_dirty(true)
     {
     m_exec_conf->msg->notice(5) << "Constructing BondedGroupData (" << name<< "s, n=" << group_size << ") "
         << endl;
@@ -80,7 +83,8 @@ template<unsigned int group_size, typename Group, const char *name, bool has_typ
 BondedGroupData<group_size, Group, name, has_type_mapping>::BondedGroupData(
     std::shared_ptr<ParticleData> pdata,
     const Snapshot& snapshot)
-    : m_exec_conf(pdata->getExecConf()), m_pdata(pdata), m_n_groups(0), m_n_ghost(0), m_nglobal(0), m_groups_dirty(true)
+    : m_exec_conf(pdata->getExecConf()), m_pdata(pdata), m_n_groups(0), m_n_ghost(0), m_nglobal(0), m_groups_dirty(true),
+      m_idx_table_dirty(true)
     {
     m_exec_conf->msg->notice(5) << "Constructing BondedGroupData (" << name << ") " << endl;
 
@@ -126,7 +130,6 @@ void BondedGroupData<group_size, Group, name, has_type_mapping>::initialize()
 
     // clear set of active tags
     m_tag_set.clear();
-    m_invalid_cached_tags = true;
 
     // clear reservoir of recycled tags
     while (! m_recycled_tags.empty())
@@ -145,6 +148,9 @@ void BondedGroupData<group_size, Group, name, has_type_mapping>::initialize()
     GPUVector<unsigned int> group_rtag(m_exec_conf);
     m_group_rtag.swap(group_rtag);
 
+    if (m_group_rtag_map)
+        m_group_rtag_map->clear();
+
     // Lookup by particle index table
     GPUVector<members_t> gpu_table(m_exec_conf);
     m_gpu_table.swap(gpu_table);
@@ -155,6 +161,16 @@ void BondedGroupData<group_size, Group, name, has_type_mapping>::initialize()
     GPUVector<unsigned int> n_groups(m_exec_conf);
     m_gpu_n_groups.swap(n_groups);
 
+    // Sorted lookup by index table for the CPU
+    GPUVector<members_t> idx_table(m_exec_conf);
+    m_idx_table.swap(idx_table);
+
+    GPUVector<typeval_t> idx_table_typeval(m_exec_conf);
+    m_idx_table_typeval.swap(idx_table_typeval);
+
+    GPUVector<unsigned int> idx_table_group(m_exec_conf);
+    m_idx_table_group.swap(idx_table_group);
+
     #ifdef ENABLE_MPI
     if (m_pdata->getDomainDecomposition())
         {
@@ -281,6 +297,210 @@ void BondedGroupData<group_size, Group, name, has_type_mapping>::initializeFromS
         }
     }
 
+#ifdef ENABLE_MPI
+//! Initialize from a snapshot that is distributed over the ranks
+/*! \param snapshot The part of the bonded groups held by this rank
+    \param particle_owner Rank that owns each particle of this rank's slice of the particle data, as set by
+           ParticleData::initializeFromDistributedSnapshot()
+
+    Every rank holds a contiguous slice of the groups, in rank order, and the group tags follow the slices. A group
+    must be stored on every rank that owns one of its members. The owners are looked up in the directory
+    \a particle_owner, which is distributed over the ranks like the particle data slices, and the groups are then
+    sent to the owners. This takes three all-to-all communications and no rank holds all groups at any time.
+
+    \pre The particle data has been initialized with ParticleData::initializeFromDistributedSnapshot()
+    \pre The type mapping is the same on all ranks.
+*/
+template<unsigned int group_size, typename Group, const char *name, bool has_type_mapping>
+void BondedGroupData<group_size, Group, name, has_type_mapping>::initializeFromDistributedSnapshot(
+    const Snapshot& snapshot,
+    const std::vector<unsigned int>& particle_owner)
+    {
+    const MPI_Comm mpi_comm = m_exec_conf->getMPICommunicator();
+    unsigned int n_ranks = m_exec_conf->getNRanks();
+    unsigned int my_rank = m_exec_conf->getRank();
+
+    // check that all fields in the snapshot have correct length, the ranks agree on the result before any
+    // collective call
+    unsigned char error = 0;
+    if (! snapshot.validate())
+        {
+        m_exec_conf->msg->errorAllRanks() << "init.*: invalid " << name << " data snapshot."
+                                          << std::endl << std::endl;
+        error = 1;
+        }
+    MPI_Allreduce(MPI_IN_PLACE, &error, 1, MPI_UNSIGNED_CHAR, MPI_LOR, mpi_comm);
+    if (error)
+        throw std::runtime_error(std::string("Error initializing ") + name + std::string(" data."));
+
+    // re-initialize data structures
+    initialize();
+
+    m_type_mapping = snapshot.type_mapping;
+
+    // the tag of the first group in this slice and the global number of groups
+    unsigned int n_slice = (unsigned int)snapshot.groups.size();
+    unsigned int tag_offset = 0;
+    MPI_Exscan(&n_slice, &tag_offset, 1, MPI_UNSIGNED, MPI_SUM, mpi_comm);
+    if (my_rank == 0)
+        tag_offset = 0;
+
+    unsigned int nglobal = 0;
+    MPI_Allreduce(&n_slice, &nglobal, 1, MPI_UNSIGNED, MPI_SUM, mpi_comm);
+
+    // first tag of the particle data slice on every rank
+    std::vector<unsigned int> particle_offset(n_ranks + 1, 0);
+    unsigned int n_particle_slice = (unsigned int)particle_owner.size();
+    MPI_Allgather(&n_particle_slice, 1, MPI_UNSIGNED, &particle_offset[1], 1, MPI_UNSIGNED, mpi_comm);
+    for (unsigned int rank = 0; rank < n_ranks; rank++)
+        particle_offset[rank + 1] += particle_offset[rank];
+
+    unsigned int n_particles = particle_offset[n_ranks];
+
+    // ask the directory for the owners of all member particles
+    std::vector< std::vector<unsigned int> > request(n_ranks);
+    std::vector<unsigned int> member_dir(n_slice * group_size);
+    for (unsigned int group_idx = 0; group_idx < n_slice && !error; group_idx++)
+        {
+        const members_t& members = snapshot.groups[group_idx];
+        for (unsigned int i = 0; i < group_size; ++i)
+            {
+            unsigned int member = members.tag[i];
+            if (member >= n_particles)
+                {
+                m_exec_conf->msg->errorAllRanks() << name << ".*: Particle tag out of bounds in " << name << " "
+                    << tag_offset + group_idx << std::endl;
+                error = 1;
+                break;
+                }
+
+            for (unsigned int j = 0; j < i; ++j)
+                if (members.tag[j] == member)
+                    {
+                    m_exec_conf->msg->errorAllRanks() << name << ".*: The same particle can only occur once in a "
+                        << name << ": " << tag_offset + group_idx << std::endl;
+                    error = 1;
+                    }
+            if (error)
+                break;
+
+            unsigned int dir = (unsigned int)(std::upper_bound(particle_offset.begin(), particle_offset.end(), member)
+                - particle_offset.begin()) - 1;
+            member_dir[group_idx * group_size + i] = dir;
+            request[dir].push_back(member);
+            }
+
+        if (!error && has_type_mapping && snapshot.type_id[group_idx] >= m_type_mapping.size())
+            {
+            m_exec_conf->msg->errorAllRanks() << name << ".*: Invalid " << name << " type "
+                << snapshot.type_id[group_idx] << "! The number of types is " << m_type_mapping.size() << std::endl;
+            error = 1;
+            }
+        }
+
+    // raise errors in the groups of any rank on all ranks before the exchange
+    MPI_Allreduce(MPI_IN_PLACE, &error, 1, MPI_UNSIGNED_CHAR, MPI_LOR, mpi_comm);
+    if (error)
+        throw std::runtime_error(std::string("Error initializing ") + name + std::string(" data."));
+
+    std::vector< std::vector<unsigned int> > reply;
+    all_to_all_v(request, reply, mpi_comm);
+
+    // answer the requests in place
+    for (unsigned int rank = 0; rank < n_ranks; rank++)
+        for (unsigned int& member : reply[rank])
+            member = particle_owner[member - particle_offset[my_rank]];
+
+    all_to_all_v(reply, request, mpi_comm);
+
+    // send every group to the owners of its members
+    std::vector< std::vector<packed_t> > send(n_ranks);
+    std::vector<unsigned int> cursor(n_ranks, 0);
+    for (unsigned int group_idx = 0; group_idx < n_slice; group_idx++)
+        {
+        packed_t g;
+        memset(&g, 0, sizeof(packed_t));
+        g.tags = snapshot.groups[group_idx];
+        if (has_type_mapping)
+            g.typeval.type = snapshot.type_id[group_idx];
+        else
+            g.typeval.val = snapshot.val[group_idx];
+        g.group_tag = tag_offset + group_idx;
+
+        unsigned int dest[group_size];
+        for (unsigned int i = 0; i < group_size; ++i)
+            {
+            unsigned int dir = member_dir[group_idx * group_size + i];
+            dest[i] = request[dir][cursor[dir]++];
+
+            // send only once to each rank
+            bool duplicate = false;
+            for (unsigned int j = 0; j < i; ++j)
+                if (dest[j] == dest[i])
+                    duplicate = true;
+
+            if (!duplicate)
+                send[dest[i]].push_back(g);
+            }
+        }
+
+    std::vector< std::vector<packed_t> > recv;
+    all_to_all_v(send, recv, mpi_comm);
+    send.clear();
+
+    // store the local groups, they arrive ordered by tag
+    m_n_groups = 0;
+    for (unsigned int rank = 0; rank < n_ranks; rank++)
+        m_n_groups += (unsigned int)recv[rank].size();
+
+    m_groups.resize(m_n_groups);
+    m_group_typeval.resize(m_n_groups);
+    m_group_tag.resize(m_n_groups);
+    m_group_ranks.resize(m_n_groups);
+    if (m_group_rtag_map)
+        m_group_rtag_map->reserve(m_n_groups);
+    else
+        {
+        m_group_rtag.resize(nglobal);
+
+        ArrayHandle<unsigned int> h_group_rtag(m_group_rtag, access_location::host, access_mode::overwrite);
+        for (unsigned int tag = 0; tag < nglobal; ++tag)
+            h_group_rtag.data[tag] = GROUP_NOT_LOCAL;
+        }
+
+        {
+        ArrayHandle<members_t> h_groups(m_groups, access_location::host, access_mode::overwrite);
+        ArrayHandle<typeval_t> h_typeval(m_group_typeval, access_location::host, access_mode::overwrite);
+        ArrayHandle<unsigned int> h_group_tag(m_group_tag, access_location::host, access_mode::overwrite);
+        ArrayHandle<ranks_t> h_group_ranks(m_group_ranks, access_location::host, access_mode::overwrite);
+        TagIndexHandle h_group_rtag(*this, access_mode::readwrite);
+
+        unsigned int idx = 0;
+        for (unsigned int rank = 0; rank < n_ranks; rank++)
+            {
+            for (const packed_t& g : recv[rank])
+                {
+                h_groups.data[idx] = g.tags;
+                h_typeval.data[idx] = g.typeval;
+                h_group_tag.data[idx] = g.group_tag;
+                h_group_ranks.data[idx] = g.ranks;
+                h_group_rtag.set(g.group_tag, idx);
+                idx++;
+                }
+            }
+        }
+
+    // update the set of active tags
+    m_tag_set.assignRange(nglobal);
+
+    m_nglobal = nglobal;
+
+    // notify observers
+    m_group_num_change_signal.emit();
+    notifyGroupReorder();
+    }
+#endif
+
 template<unsigned int group_size, typename Group, const char *name, bool has_type_mapping>
 unsigned int BondedGroupData<group_size, Group, name, has_type_mapping>::addBondedGroup(Group g)
     {
@@ -352,12 +572,6 @@ unsigned int BondedGroupData<group_size, Group, name, has_type_mapping>::addBond
         {
         tag = m_recycled_tags.top();
         m_recycled_tags.pop();
-
-        // update reverse-lookup tag to point to end of local group data
-        if (is_local)
-            m_group_rtag[tag] = getN();
-
-        assert(is_local || m_group_rtag[tag] == GROUP_NOT_LOCAL);
         }
     else
         {
@@ -365,13 +579,17 @@ unsigned int BondedGroupData<group_size, Group, name, has_type_mapping>::addBond
         tag = getNGlobal();
 
         // add new reverse-lookup tag
-        assert(m_group_rtag.size() == getNGlobal());
-        if (is_local)
-            m_group_rtag.push_back(getN());
-        else
+        if (!m_group_rtag_map)
+            {
+            assert(m_group_rtag.size() == getNGlobal());
             m_group_rtag.push_back(GROUP_NOT_LOCAL);
+            }
         }
 
+    // update reverse-lookup tag to point to end of local group data
+    if (is_local)
+        TagIndexHandle(*this, access_mode::readwrite).set(tag, getN());
+
     assert(tag <= m_recycled_tags.size() + getNGlobal());
 
     if (is_local)
@@ -396,7 +614,6 @@ unsigned int BondedGroupData<group_size, Group, name, has_type_mapping>::addBond
 
     // add to set of active tags
     m_tag_set.insert(tag);
-    m_invalid_cached_tags = true;
 
     // increment number of bonded groups
     m_nglobal++;
@@ -423,9 +640,7 @@ unsigned int BondedGroupData<group_size, Group, name, has_type_mapping>::getNthT
 
     assert(m_tag_set.size() == getNGlobal());
 
-    // maybe_rebuild_tag_cache only rebuilds if necessary
-    maybe_rebuild_tag_cache();
-    return m_cached_tag_set[n];
+    return m_tag_set.nth(n);
     }
 
 /*! \param tag Tag of bonded group
@@ -435,7 +650,7 @@ template<unsigned int group_size, typename Group, const char *name, bool has_typ
 const Group BondedGroupData<group_size, Group, name, has_type_mapping>::getGroupByTag(unsigned int tag) const
     {
     // Find position of bonded group in list
-    unsigned int group_idx = m_group_rtag[tag];
+    unsigned int group_idx = TagIndexHandle(*this, access_mode::read)[tag];
 
     typeval_t typeval;
     members_t members;
@@ -543,14 +758,16 @@ void BondedGroupData<group_size, Group, name, has_type_mapping>::removeBondedGro
     removeAllGhostGroups();
 
     // sanity check
-    if (tag >= m_group_rtag.size())
+    if (m_tag_set.empty() || tag > getMaximumTag())
         {
         m_exec_conf->msg->error() << "Trying to remove " << name << " " << tag << " which does not exist!" << endl;
         throw runtime_error(std::string("Error removing ") + name);
         }
 
+    TagIndexHandle h_group_rtag(*this, access_mode::readwrite);
+
     // Find position of bonded group in list
-    unsigned int id = m_group_rtag[tag];
+    unsigned int id = h_group_rtag[tag];
 
     bool is_local = id < getN();
     assert(is_local || id == GROUP_NOT_LOCAL);
@@ -583,7 +800,7 @@ void BondedGroupData<group_size, Group, name, has_type_mapping>::removeBondedGro
         }
 
     // delete from map
-    m_group_rtag[tag] = GROUP_NOT_LOCAL;
+    h_group_rtag.set(tag, GROUP_NOT_LOCAL);
 
     if (is_local)
         {
@@ -599,7 +816,7 @@ void BondedGroupData<group_size, Group, name, has_type_mapping>::removeBondedGro
                 m_group_ranks[id] = (ranks_t) m_group_ranks[size-1];
             #endif
             unsigned int last_tag = m_group_tag[size-1];
-            m_group_rtag[last_tag] = id;
+            h_group_rtag.set(last_tag, id);
             m_group_tag[id] = last_tag;
             }
 
@@ -616,7 +833,6 @@ void BondedGroupData<group_size, Group, name, has_type_mapping>::removeBondedGro
 
     // remove from set of active tags
     m_tag_set.erase(tag);
-    m_invalid_cached_tags = true;
 
     // maintain a stack of deleted group tags for future recycling
     m_recycled_tags.push(tag);
@@ -673,29 +889,63 @@ void BondedGroupData<group_size, Group, name, has_type_mapping>::setTypeName(uns
     m_type_mapping[type] = new_name;
     }
 
-/*! Rebuild the cached vector of active tags, if necessary
+/*! \param compact True to look up local and ghost groups in a hash map, false to use a dense array
+
+    \sa ParticleData::setCompactTagLookup()
 */
 template<unsigned int group_size, typename Group, const char *name, bool has_type_mapping>
-void BondedGroupData<group_size, Group, name, has_type_mapping>::maybe_rebuild_tag_cache()
+void BondedGroupData<group_size, Group, name, has_type_mapping>::setCompactTagLookup(bool compact)
     {
-    if(!m_invalid_cached_tags)
+    if (compact == getCompactTagLookup())
         return;
 
-    // GPUVector checks if the resize is necessary
-    m_cached_tag_set.resize(m_tag_set.size());
+    #ifdef ENABLE_HIP
+    if (compact && m_exec_conf->isCUDAEnabled())
+        {
+        m_exec_conf->msg->error() << "The compact tag lookup is not supported on the GPU." << std::endl;
+        throw std::runtime_error(std::string("Error setting the ") + name + std::string(" tag lookup"));
+        }
+    #endif
+
+    unsigned int n = m_n_groups + m_n_ghost;
+    ArrayHandle<unsigned int> h_group_tag(m_group_tag, access_location::host, access_mode::read);
 
-    ArrayHandle<unsigned int> h_active_tag(m_cached_tag_set, access_location::host, access_mode::overwrite);
+    if (compact)
+        {
+        m_group_rtag_map.reset(new TagIndexMap());
+        m_group_rtag_map->reserve(n);
+        for (unsigned int group_idx = 0; group_idx < n; ++group_idx)
+            m_group_rtag_map->set(h_group_tag.data[group_idx], group_idx);
 
-    // iterate over each element in the set, building a mapping
-    // from dense array indices to sparse particle tag indices
-    unsigned int i(0);
-    for(std::set<unsigned int>::const_iterator it(m_tag_set.begin());
-        it != m_tag_set.end(); ++it, ++i)
+        // release the dense array
+        GPUVector<unsigned int>(m_exec_conf).swap(m_group_rtag);
+        }
+    else
         {
-        h_active_tag.data[i] = *it;
+        m_group_rtag_map.reset();
+
+        // all tags that have been handed out, including the recycled ones
+        unsigned int n_tags = m_nglobal + (unsigned int)m_recycled_tags.size();
+        m_group_rtag.resize(n_tags);
+
+        ArrayHandle<unsigned int> h_group_rtag(m_group_rtag, access_location::host, access_mode::overwrite);
+        for (unsigned int tag = 0; tag < n_tags; ++tag)
+            h_group_rtag.data[tag] = GROUP_NOT_LOCAL;
+        for (unsigned int group_idx = 0; group_idx < n; ++group_idx)
+            h_group_rtag.data[h_group_tag.data[group_idx]] = group_idx;
         }
 
-    m_invalid_cached_tags = false;
+    m_tag_set.setCompact(compact);
+    }
+
+template<unsigned int group_size, typename Group, const char *name, bool has_type_mapping>
+void BondedGroupData<group_size, Group, name, has_type_mapping>::checkDenseRTags() const
+    {
+    if (m_group_rtag_map)
+        {
+        m_exec_conf->msg->error() << name << ": This method does not support the compact tag lookup." << std::endl;
+        throw std::runtime_error(std::string("Error accessing ") + name + std::string(" reverse-lookup tags"));
+        }
     }
 
 template<unsigned int group_size, typename Group, const char *name, bool has_type_mapping>
@@ -709,7 +959,7 @@ void BondedGroupData<group_size, Group, name, has_type_mapping>::rebuildGPUTable
         {
         if (m_prof) m_prof->push("update " + std::string(name) + " table");
 
-        ArrayHandle< unsigned int > h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
+        TagIndexHandle h_rtag(*m_pdata, access_mode::read);
 
         m_gpu_n_groups.resize(m_pdata->getN()+m_pdata->getNGhosts());
 
@@ -732,7 +982,7 @@ void BondedGroupData<group_size, Group, name, has_type_mapping>::rebuildGPUTable
                 for (unsigned int i = 0; i < group_size; ++i)
                     {
                     unsigned int tag = g.tag[i];
-                    unsigned int idx = h_rtag.data[tag];
+                    unsigned int idx = h_rtag[tag];
 
                     if (idx == NOT_LOCAL)
                         {
@@ -778,7 +1028,7 @@ void BondedGroupData<group_size, Group, name, has_type_mapping>::rebuildGPUTable
                 for (unsigned int i = 0; i < group_size; ++i)
                     {
                     unsigned int tag1 = g.tag[i];
-                    unsigned int idx1 = h_rtag.data[tag1];
+                    unsigned int idx1 = h_rtag[tag1];
                     unsigned int num = h_n_groups.data[idx1]++;
 
                     members_t h;
@@ -805,7 +1055,7 @@ void BondedGroupData<group_size, Group, name, has_type_mapping>::rebuildGPUTable
                             continue;
                             }
                         unsigned int tag2 = g.tag[j];
-                        unsigned int idx2 = h_rtag.data[tag2];
+                        unsigned int idx2 = h_rtag[tag2];
                         h.idx[n++] = idx2;
                         }
 
@@ -819,6 +1069,72 @@ void BondedGroupData<group_size, Group, name, has_type_mapping>::rebuildGPUTable
         }
     }
 
+/*! The local groups are bucketed by the lowest index of any of their members with a counting sort,
+    and the members are stored as particle indices. CPU kernels that loop over this table then access
+    the particle data in the order established by the last particle sort instead of in tag order.
+ */
+template<unsigned int group_size, typename Group, const char *name, bool has_type_mapping>
+void BondedGroupData<group_size, Group, name, has_type_mapping>::rebuildIndexTable()
+    {
+    if (m_prof) m_prof->push("update " + std::string(name) + " index table");
+
+    const unsigned int n_groups = m_n_groups;
+    const unsigned int N = m_pdata->getN()+m_pdata->getNGhosts();
+
+    m_idx_table.resize(n_groups);
+    m_idx_table_typeval.resize(n_groups);
+    m_idx_table_group.resize(n_groups);
+
+    // groups without any member on this rank are placed in the last bucket
+    m_idx_table_key.resize(n_groups);
+    m_idx_table_count.assign(N+2, 0);
+
+    TagIndexHandle h_rtag(*m_pdata, access_mode::read);
+    ArrayHandle<members_t> h_groups(m_groups, access_location::host, access_mode::read);
+    ArrayHandle<typeval_t> h_typeval(m_group_typeval, access_location::host, access_mode::read);
+
+    // count the number of groups per lowest member index
+    for (unsigned int group_idx = 0; group_idx < n_groups; ++group_idx)
+        {
+        const members_t& g = h_groups.data[group_idx];
+        unsigned int key = N;
+        for (unsigned int j = 0; j < group_size; ++j)
+            {
+            unsigned int idx = h_rtag[g.tag[j]];
+            if (idx < key)
+                key = idx;
+            }
+
+        m_idx_table_key[group_idx] = key;
+        m_idx_table_count[key+1]++;
+        }
+
+    // exclusive prefix sum gives the first table entry of every bucket
+    for (unsigned int i = 0; i < N+1; ++i)
+        m_idx_table_count[i+1] += m_idx_table_count[i];
+
+    ArrayHandle<members_t> h_idx_table(m_idx_table, access_location::host, access_mode::overwrite);
+    ArrayHandle<typeval_t> h_idx_table_typeval(m_idx_table_typeval, access_location::host, access_mode::overwrite);
+    ArrayHandle<unsigned int> h_idx_table_group(m_idx_table_group, access_location::host, access_mode::overwrite);
+
+    // scatter the groups into their buckets, preserving the original order within a bucket
+    for (unsigned int group_idx = 0; group_idx < n_groups; ++group_idx)
+        {
+        unsigned int pos = m_idx_table_count[m_idx_table_key[group_idx]]++;
+
+        const members_t& g = h_groups.data[group_idx];
+        members_t h;
+        for (unsigned int j = 0; j < group_size; ++j)
+            h.idx[j] = h_rtag[g.tag[j]];
+
+        h_idx_table.data[pos] = h;
+        h_idx_table_typeval.data[pos] = h_typeval.data[group_idx];
+        h_idx_table_group.data[pos] = group_idx;
+        }
+
+    if (m_prof) m_prof->pop();
+    }
+
 #ifdef ENABLE_HIP
 template<unsigned int group_size, typename Group, const char *name, bool has_type_mapping>
 void BondedGroupData<group_size, Group, name, has_type_mapping>::rebuildGPUTableGPU()
@@ -924,7 +1240,7 @@ std::map<unsigned int, unsigned int> BondedGroupData<group_size, Group, name, ha
     for (unsigned int group_idx = 0; group_idx < getN(); group_idx++)
         {
         unsigned int tag = m_group_tag[group_idx];
-        assert(m_group_rtag[tag] == group_idx);
+        assert(TagIndexHandle(*this, access_mode::read)[tag] == group_idx);
 
         rtag_map.insert(std::pair<unsigned int,unsigned int>(tag, group_idx));
         }
@@ -981,10 +1297,10 @@ std::map<unsigned int, unsigned int> BondedGroupData<group_size, Group, name, ha
             unsigned int snap_id = 0;
 
             // loop through active tags
-            std::set<unsigned int>::iterator active_tag_it;
-            for (active_tag_it = m_tag_set.begin(); active_tag_it != m_tag_set.end(); ++active_tag_it)
+            unsigned int group_tag = 0;
+            for (unsigned int i = 0; i < m_tag_set.size(); ++i)
                 {
-                unsigned int group_tag = *active_tag_it;
+                group_tag = i ? m_tag_set.next(group_tag) : m_tag_set.min();
                 rank_rtag_it = rank_rtag_map.find(group_tag);
                 if (rank_rtag_it == rank_rtag_map.end())
                     {
@@ -1027,10 +1343,10 @@ std::map<unsigned int, unsigned int> BondedGroupData<group_size, Group, name, ha
         unsigned int snap_id = 0;
 
         // loop through active tags
-        std::set<unsigned int>::iterator active_tag_it;
-        for (active_tag_it = m_tag_set.begin(); active_tag_it != m_tag_set.end(); ++active_tag_it)
+        unsigned int group_tag = 0;
+        for (unsigned int i = 0; i < m_tag_set.size(); ++i)
             {
-            unsigned int group_tag = *active_tag_it;
+            group_tag = i ? m_tag_set.next(group_tag) : m_tag_set.min();
             rtag_it = rtag_map.find(group_tag);
             if (rtag_it == rtag_map.end())
                 {
@@ -1098,7 +1414,7 @@ void BondedGroupData<group_size, Group, name, has_type_mapping>::moveParticleGro
             {
             // send group properties to other rank
             unsigned int group_tag = *it;
-            unsigned int group_idx = m_group_rtag[group_tag];
+            unsigned int group_idx = TagIndexHandle(*this, access_mode::read)[group_tag];
             assert(group_idx != GROUP_NOT_LOCAL);
 
             MPI_Isend(&group_tag, 1, MPI_UNSIGNED, new_rank, 0, m_exec_conf->getMPICommunicator(), &req);
@@ -1114,7 +1430,7 @@ void BondedGroupData<group_size, Group, name, has_type_mapping>::moveParticleGro
         for (std::vector<unsigned int>::iterator it = send_groups.begin(); it != send_groups.end(); ++it)
             {
             unsigned int group_tag = *it;
-            unsigned int group_idx = m_group_rtag[group_tag];
+            unsigned int group_idx = TagIndexHandle(*this, access_mode::read)[group_tag];
             members_t members = m_groups[group_idx];
             bool is_local = false;
             for (unsigned int i = 0; i < group_size; ++i)
@@ -1122,7 +1438,8 @@ void BondedGroupData<group_size, Group, name, has_type_mapping>::moveParticleGro
 
             if (!is_local)
                 {
-                m_group_rtag[group_tag] = GROUP_NOT_LOCAL;
+                TagIndexHandle h_group_rtag(*this, access_mode::readwrite);
+                h_group_rtag.set(group_tag, GROUP_NOT_LOCAL);
 
                 m_groups.erase(group_idx);
                 m_group_typeval.erase(group_idx);
@@ -1132,10 +1449,9 @@ void BondedGroupData<group_size, Group, name, has_type_mapping>::moveParticleGro
                 m_n_groups--;
 
                 // reindex rtags
-                ArrayHandle<unsigned int> h_group_rtag(m_group_rtag, access_location::host, access_mode::readwrite);
                 ArrayHandle<unsigned int> h_group_tag(m_group_tag, access_location::host, access_mode::read);
                 for (unsigned int i = 0; i < m_n_groups; ++i)
-                    h_group_rtag.data[h_group_tag.data[i]] = i;
+                    h_group_rtag.set(h_group_tag.data[i], i);
                 }
             }
         }
@@ -1163,7 +1479,7 @@ void BondedGroupData<group_size, Group, name, has_type_mapping>::moveParticleGro
             MPI_Irecv(&typeval, sizeof(typeval_t), MPI_BYTE, old_rank, 0, m_exec_conf->getMPICommunicator(), &req);
             MPI_Wait(&req, &stat);
 
-            bool is_local = m_group_rtag[tag] != NOT_LOCAL;
+            bool is_local = TagIndexHandle(*this, access_mode::read)[tag] != NOT_LOCAL;
 
             // if not already local
             if (! is_local)
@@ -1181,7 +1497,7 @@ void BondedGroupData<group_size, Group, name, has_type_mapping>::moveParticleGro
                 m_n_groups++;
 
                 m_group_ranks.push_back(r);
-                m_group_rtag[tag] = n;
+                TagIndexHandle(*this, access_mode::readwrite).set(tag, n);
                 }
             }
         }
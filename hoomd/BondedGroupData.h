@@ -25,6 +25,7 @@ const unsigned int GROUP_NOT_LOCAL ((unsigned int) 0xffffffff);
 #include "HOOMDMath.h"
 #include "HOOMDMPI.h"
 #include "ParticleData.h"
+#include "TagIndexMap.h"
 
 #ifdef ENABLE_HIP
 #include "CachedAllocator.h"
@@ -252,6 +253,12 @@ class BondedGroupData
         //! Initialize from a snapshot
         virtual void initializeFromSnapshot(const Snapshot& snapshot);
 
+        #ifdef ENABLE_MPI
+        //! Initialize from a snapshot that is distributed over the ranks
+        void initializeFromDistributedSnapshot(const Snapshot& snapshot,
+                                               const std::vector<unsigned int>& particle_owner);
+        #endif
+
         //! Take a snapshot
         virtual std::map<unsigned int, unsigned int> takeSnapshot(Snapshot& snapshot) const;
 
@@ -336,7 +343,7 @@ class BondedGroupData
         unsigned int getMaximumTag() const
             {
             assert(!m_tag_set.empty());
-            return *m_tag_set.rbegin();
+            return m_tag_set.max();
             }
 
         //! Return a bonded group by tag
@@ -399,11 +406,35 @@ class BondedGroupData
             }
 
         //! Return reverse-lookup table (group tag-> group index) (const)
+        /*! \note The dense array is not available with a compact tag lookup, see setCompactTagLookup()
+         */
         const GPUVector<unsigned int>& getRTags() const
             {
+            checkDenseRTags();
             return m_group_rtag;
             }
 
+        //! Return the dense reverse-lookup array, which is empty with a compact tag lookup
+        const GPUVector<unsigned int>& getRTagArray() const
+            {
+            return m_group_rtag;
+            }
+
+        //! Return the compact reverse-lookup map, or nullptr if the lookup is dense
+        TagIndexMap *getRTagMap() const
+            {
+            return m_group_rtag_map.get();
+            }
+
+        //! Switch between the dense and the compact reverse tag lookup
+        void setCompactTagLookup(bool compact);
+
+        //! Test if the reverse tag lookup is compact
+        bool getCompactTagLookup() const
+            {
+            return bool(m_group_rtag_map);
+            }
+
         #ifdef ENABLE_MPI
         //! Return auxiliary array of member particle ranks (const)
         const GPUVector<ranks_t>& getRanksArray() const
@@ -433,6 +464,7 @@ class BondedGroupData
         //! Return reverse-lookup table (group tag-> group index)
         GPUVector<unsigned int>& getRTags()
             {
+            checkDenseRTags();
             return m_group_rtag;
             }
 
@@ -564,6 +596,53 @@ class BondedGroupData
             return m_gpu_n_groups;
             }
 
+        /*
+         * CPU group table
+         */
+
+        //! Return local groups with their members resolved to particle indices
+        /*! Entries are ordered by the lowest local index of any member, so that a loop over the table
+            walks the particle arrays in nearly ascending order after a particle sort. Members that are
+            not available on this rank are stored as NOT_LOCAL. Only the getN() local groups are included.
+         */
+        const GPUVector<members_t>& getIndexTable()
+            {
+            // rebuild lookup table if necessary
+            if (m_idx_table_dirty)
+                {
+                rebuildIndexTable();
+                m_idx_table_dirty = false;
+                }
+
+            return m_idx_table;
+            }
+
+        //! Return the type/constraint value of every entry in the index table
+        const GPUVector<typeval_t>& getIndexTableTypeVal()
+            {
+            // rebuild lookup table if necessary
+            if (m_idx_table_dirty)
+                {
+                rebuildIndexTable();
+                m_idx_table_dirty = false;
+                }
+
+            return m_idx_table_typeval;
+            }
+
+        //! Return the local group index of every entry in the index table
+        const GPUVector<unsigned int>& getIndexTableGroups()
+            {
+            // rebuild lookup table if necessary
+            if (m_idx_table_dirty)
+                {
+                rebuildIndexTable();
+                m_idx_table_dirty = false;
+                }
+
+            return m_idx_table_group;
+            }
+
         /*
          * add/remove groups globally
          */
@@ -602,17 +681,19 @@ class BondedGroupData
         //! Notify subscribers that groups have been reordered
         void notifyGroupReorder()
             {
-            // set flag to trigger rebuild of GPU table
+            // set flag to trigger rebuild of GPU and CPU tables
             m_groups_dirty = true;
+            m_idx_table_dirty = true;
 
             // notify subscribers
             m_group_reorder_signal.emit();
             }
 
-        //! Indicate that GPU table needs to be rebuilt
+        //! Indicate that GPU and CPU tables need to be rebuilt
         void setDirty()
             {
             m_groups_dirty = true;
+            m_idx_table_dirty = true;
             }
 
     protected:
@@ -632,10 +713,14 @@ class BondedGroupData
         GPUVector<typeval_t> m_group_typeval;        //!< List of group types/constraint values
         GPUVector<unsigned int> m_group_tag;         //!< List of group tags
         GPUVector<unsigned int> m_group_rtag;        //!< Global reverse-lookup table for group tags
+        std::unique_ptr<TagIndexMap> m_group_rtag_map; //!< Reverse lookup of local and ghost groups, replaces m_group_rtag if set
         GPUVector<members_t> m_gpu_table;            //!< Storage for groups by particle index for access on the GPU
         GPUVector<unsigned int> m_gpu_pos_table;     //!< Position of particle idx in group table
         Index2D m_gpu_table_indexer;                 //!< Indexer for GPU table
         GPUVector<unsigned int> m_gpu_n_groups;      //!< Number of entries in lookup table per particle
+        GPUVector<members_t> m_idx_table;            //!< Local groups by particle index, sorted by lowest member index
+        GPUVector<typeval_t> m_idx_table_typeval;    //!< Type/constraint value per index table entry
+        GPUVector<unsigned int> m_idx_table_group;   //!< Local group index per index table entry
         std::vector<std::string> m_type_mapping;     //!< Mapping of types of bonded groups
 
         unsigned int m_n_groups;                     //!< Number of local groups
@@ -655,13 +740,14 @@ class BondedGroupData
 
         unsigned int m_nglobal;                      //!< Global number of groups
         std::stack<unsigned int> m_recycled_tags;    //!< Global tags of removed groups
-        std::set<unsigned int> m_tag_set;            //!< Lookup table for tags by active index
-        GPUVector<unsigned int> m_cached_tag_set;    //!< Cached constant-time lookup table for tags by active index
-        bool m_invalid_cached_tags;                  //!< true if m_cached_tag_set needs to be rebuilt
+        ActiveTagSet m_tag_set;                      //!< Lookup table for tags by active index
         std::shared_ptr<Profiler> m_prof;          //!< Profiler
 
     private:
         bool m_groups_dirty;                         //!< Is it necessary to rebuild the lookup-by-index table?
+        bool m_idx_table_dirty;                      //!< Is it necessary to rebuild the CPU index table?
+        std::vector<unsigned int> m_idx_table_key;   //!< Temporary sort key per group for the index table rebuild
+        std::vector<unsigned int> m_idx_table_count; //!< Temporary bucket offsets for the index table rebuild
 
         Nano::Signal<void ()> m_group_num_change_signal; //!< Signal that is triggered when groups are added or deleted (globally)
         Nano::Signal<void ()> m_group_reorder_signal;    //!< Signal that is triggered when groups are added or deleted locally
@@ -669,12 +755,15 @@ class BondedGroupData
         //! Initialize internal memory
         void initialize();
 
-        //! Helper function to rebuild the active tag cache if necessary
-        void maybe_rebuild_tag_cache();
+        //! Helper function to throw an error if the dense reverse-lookup table is not available
+        void checkDenseRTags() const;
 
         //! Helper function to rebuild lookup by index table
         void rebuildGPUTable();
 
+        //! Helper function to rebuild the sorted CPU index table
+        void rebuildIndexTable();
+
         //! Resize internal tables
         /*! \param new_size New size of local group tables, new_size = n_local + n_ghost
          */
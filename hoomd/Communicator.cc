@@ -41,11 +41,11 @@ void Communicator::GroupCommunicator<group_data>::migrateGroups(bool incomplete,
             {
             // wipe out reverse-lookup tag -> idx for old ghost groups
             ArrayHandle<unsigned int> h_group_tag(m_gdata->getTags(), access_location::host, access_mode::read);
-            ArrayHandle<unsigned int> h_group_rtag(m_gdata->getRTags(), access_location::host, access_mode::readwrite);
+            TagIndexHandle h_group_rtag(*m_gdata, access_mode::readwrite);
             for (unsigned int i = 0; i < m_gdata->getNGhosts(); i++)
                 {
                 unsigned int idx = m_gdata->getN() + i;
-                h_group_rtag.data[h_group_tag.data[idx]] = GROUP_NOT_LOCAL;
+                h_group_rtag.set(h_group_tag.data[idx], GROUP_NOT_LOCAL);
                 }
             }
 
@@ -62,7 +62,7 @@ void Communicator::GroupCommunicator<group_data>::migrateGroups(bool incomplete,
             ArrayHandle<typename group_data::members_t> h_members(m_gdata->getMembersArray(), access_location::host, access_mode::read);
             ArrayHandle<typename group_data::ranks_t> h_group_ranks(m_gdata->getRanksArray(), access_location::host, access_mode::readwrite);
             ArrayHandle<unsigned int> h_group_tag(m_gdata->getTags(), access_location::host, access_mode::read);
-            ArrayHandle<unsigned int> h_rtag(m_comm.m_pdata->getRTags(), access_location::host, access_mode::read);
+            TagIndexHandle h_rtag(*m_comm.m_pdata, access_mode::read);
 
             ArrayHandle<unsigned int> h_unique_neighbors(m_comm.m_unique_neighbors, access_location:: host, access_mode::read);
 
@@ -88,7 +88,7 @@ void Communicator::GroupCommunicator<group_data>::migrateGroups(bool incomplete,
                 for (unsigned int i = 0; i < group_data::size; i++)
                     {
                     unsigned int tag = g.tag[i];
-                    unsigned int pidx = h_rtag.data[tag];
+                    unsigned int pidx = h_rtag[tag];
 
                     if (pidx == NOT_LOCAL)
                         {
@@ -326,13 +326,13 @@ void Communicator::GroupCommunicator<group_data>::migrateGroups(bool incomplete,
             {
             // access receive buffers
             ArrayHandle<typename group_data::ranks_t> h_group_ranks(m_gdata->getRanksArray(), access_location::host, access_mode::readwrite);
-            ArrayHandle<unsigned int> h_group_rtag(m_gdata->getRTags(), access_location::host, access_mode::read);
+            TagIndexHandle h_group_rtag(*m_gdata, access_mode::read);
 
             for (unsigned int recv_idx = 0; recv_idx < n_recv_tot; ++recv_idx)
                 {
                 rank_element_t el = m_ranks_recvbuf[recv_idx];
                 unsigned int tag = el.tag;
-                unsigned int gidx = h_group_rtag.data[tag];
+                unsigned int gidx = h_group_rtag[tag];
 
                 if (gidx != GROUP_NOT_LOCAL)
                     {
@@ -358,9 +358,9 @@ void Communicator::GroupCommunicator<group_data>::migrateGroups(bool incomplete,
             ArrayHandle<typename group_data::members_t> h_groups(m_gdata->getMembersArray(), access_location::host, access_mode::read);
             ArrayHandle<typeval_t> h_group_typeval(m_gdata->getTypeValArray(), access_location::host, access_mode::read);
             ArrayHandle<unsigned int> h_group_tag(m_gdata->getTags(), access_location::host, access_mode::read);
-            ArrayHandle<unsigned int> h_group_rtag(m_gdata->getRTags(), access_location::host, access_mode::readwrite);
+            TagIndexHandle h_group_rtag(*m_gdata, access_mode::readwrite);
             ArrayHandle<typename group_data::ranks_t> h_group_ranks(m_gdata->getRanksArray(), access_location::host, access_mode::read);
-            ArrayHandle<unsigned int> h_rtag(m_comm.m_pdata->getRTags(), access_location::host, access_mode::read);
+            TagIndexHandle h_rtag(*m_comm.m_pdata, access_mode::read);
             ArrayHandle<unsigned int> h_comm_flags(m_comm.m_pdata->getCommFlags(), access_location::host, access_mode::read);
 
             unsigned int ngroups = m_gdata->getN();
@@ -375,7 +375,7 @@ void Communicator::GroupCommunicator<group_data>::migrateGroups(bool incomplete,
                 for (unsigned int i = 0; i < group_data::size; ++i)
                     {
                     unsigned int tag = members.tag[i];
-                    unsigned int pidx = h_rtag.data[tag];
+                    unsigned int pidx = h_rtag[tag];
 
                     if (pidx != NOT_LOCAL && h_comm_flags.data[pidx])
                         {
@@ -404,7 +404,7 @@ void Communicator::GroupCommunicator<group_data>::migrateGroups(bool incomplete,
                     for (unsigned int i = 0; i < group_data::size; ++i)
                         {
                         unsigned int tag = members.tag[i];
-                        unsigned int pidx = h_rtag.data[tag];
+                        unsigned int pidx = h_rtag[tag];
 
                         if (pidx != NOT_LOCAL && !h_comm_flags.data[pidx])
                             {
@@ -417,7 +417,7 @@ void Communicator::GroupCommunicator<group_data>::migrateGroups(bool incomplete,
 
                     // if group is no longer local, flag for removal
                     if (!is_local)
-                        h_group_rtag.data[el.group_tag] = GROUP_NOT_LOCAL;
+                        h_group_rtag.set(el.group_tag, GROUP_NOT_LOCAL);
                     }
                 } // end loop over groups
             }
@@ -436,14 +436,14 @@ void Communicator::GroupCommunicator<group_data>::migrateGroups(bool incomplete,
             ArrayHandle<typename group_data::ranks_t> h_group_ranks_alt(m_gdata->getAltRanksArray(), access_location::host, access_mode::overwrite);
 
             // access rtags
-            ArrayHandle<unsigned int> h_group_rtag(m_gdata->getRTags(), access_location::host, access_mode::readwrite);
+            TagIndexHandle h_group_rtag(*m_gdata, access_mode::readwrite);
 
             unsigned int ngroups = m_gdata->getN();
             unsigned int n = 0;
             for (unsigned int group_idx = 0; group_idx < ngroups; group_idx++)
                 {
                 unsigned int group_tag = h_group_tag.data[group_idx];
-                bool keep = h_group_rtag.data[group_tag] != GROUP_NOT_LOCAL;
+                bool keep = h_group_rtag[group_tag] != GROUP_NOT_LOCAL;
 
                 if (keep)
                     {
@@ -453,7 +453,7 @@ void Communicator::GroupCommunicator<group_data>::migrateGroups(bool incomplete,
                     h_group_ranks_alt.data[n] = h_group_ranks.data[group_idx];
 
                     // rebuild rtags
-                    h_group_rtag.data[group_tag] = n++;
+                    h_group_rtag.set(group_tag, n++);
                     }
                 }
 
@@ -634,7 +634,7 @@ void Communicator::GroupCommunicator<group_data>::migrateGroups(bool incomplete,
         unsigned int myrank = m_exec_conf->getRank();
 
             {
-            ArrayHandle<unsigned int> h_group_rtag(m_gdata->getRTags(), access_location::host, access_mode::readwrite);
+            TagIndexHandle h_group_rtag(*m_gdata, access_mode::readwrite);
             ArrayHandle<typename group_data::members_t> h_groups(groups_array, access_location::host, access_mode::readwrite);
             ArrayHandle<typeval_t> h_group_typeval(group_typeval_array, access_location::host, access_mode::readwrite);
             ArrayHandle<unsigned int> h_group_tag(group_tag_array, access_location::host, access_mode::readwrite);
@@ -647,7 +647,7 @@ void Communicator::GroupCommunicator<group_data>::migrateGroups(bool incomplete,
                 typename group_data::packed_t el = it->second;
 
                 unsigned int tag = el.group_tag;
-                unsigned int group_rtag = h_group_rtag.data[tag];
+                unsigned int group_rtag = h_group_rtag[tag];
 
                 bool remove = false;
                 if (! local_multiple)
@@ -670,7 +670,7 @@ void Communicator::GroupCommunicator<group_data>::migrateGroups(bool incomplete,
                         h_group_ranks.data[add_idx] = el.ranks;
 
                         // update reverse-lookup table
-                        h_group_rtag.data[tag] = add_idx++;
+                        h_group_rtag.set(tag, add_idx++);
                         }
                     else
                         {
@@ -702,7 +702,7 @@ void Communicator::GroupCommunicator<group_data>::markGhostParticles(
         {
         ArrayHandle<typename group_data::members_t> h_groups(m_gdata->getMembersArray(), access_location::host, access_mode::read);
         ArrayHandle<typename group_data::ranks_t> h_group_ranks(m_gdata->getRanksArray(), access_location::host, access_mode::read);
-        ArrayHandle<unsigned int> h_rtag(m_comm.m_pdata->getRTags(), access_location::host, access_mode::read);
+        TagIndexHandle h_rtag(*m_comm.m_pdata, access_mode::read);
         ArrayHandle<Scalar4> h_postype(m_comm.m_pdata->getPositions(), access_location::host, access_mode::read);
         ArrayHandle<unsigned int> h_plan(plans, access_location::host, access_mode::readwrite);
 
@@ -754,7 +754,7 @@ void Communicator::GroupCommunicator<group_data>::markGhostParticles(
                     for (unsigned int j = 0; j < group_data::size; ++j)
                         {
                         unsigned int tag_j = g.tag[j];
-                        unsigned int rtag_j = h_rtag.data[tag_j];
+                        unsigned int rtag_j = h_rtag[tag_j];
 
                         if (rtag_j != NOT_LOCAL)
                             {
@@ -808,7 +808,7 @@ void Communicator::GroupCommunicator<group_data>::exchangeGhostGroups(
 
             {
             ArrayHandle<typename group_data::members_t> h_groups(m_gdata->getMembersArray(), access_location::host, access_mode::read);
-            ArrayHandle<unsigned int> h_rtag(m_comm.m_pdata->getRTags(), access_location::host, access_mode::read);
+            TagIndexHandle h_rtag(*m_comm.m_pdata, access_mode::read);
             ArrayHandle<unsigned int> h_plan(plans, access_location::host, access_mode::read);
 
             unsigned int ngroups_local = m_gdata->getN();
@@ -825,7 +825,7 @@ void Communicator::GroupCommunicator<group_data>::exchangeGhostGroups(
                 for (unsigned int i = 0; i < group_data::size; ++i)
                     {
                     unsigned int tag = members.tag[i];
-                    unsigned int pidx = h_rtag.data[tag];
+                    unsigned int pidx = h_rtag[tag];
 
                     if (i==0 && pidx >= n_local)
                         {
@@ -998,10 +998,10 @@ void Communicator::GroupCommunicator<group_data>::exchangeGhostGroups(
                 ArrayHandle<typeval_t> h_group_typeval(m_gdata->getTypeValArray(), access_location::host, access_mode::readwrite);
                 ArrayHandle<unsigned int> h_group_tag(m_gdata->getTags(), access_location::host, access_mode::readwrite);
                 ArrayHandle<typename group_data::ranks_t> h_group_ranks(m_gdata->getRanksArray(), access_location::host, access_mode::readwrite);
-                ArrayHandle<unsigned int> h_group_rtag(m_gdata->getRTags(), access_location::host, access_mode::readwrite);
+                TagIndexHandle h_group_rtag(*m_gdata, access_mode::readwrite);
 
                 // access particle data
-                ArrayHandle<unsigned int> h_rtag(m_comm.m_pdata->getRTags(), access_location::host, access_mode::read);
+                TagIndexHandle h_rtag(*m_comm.m_pdata, access_mode::read);
 
                 unsigned int max_local = m_comm.m_pdata->getN() + m_comm.m_pdata->getNGhosts();
 
@@ -1009,7 +1009,7 @@ void Communicator::GroupCommunicator<group_data>::exchangeGhostGroups(
                 for (unsigned int i = 0; i < num_recv_ghosts; i++)
                     {
                     typename group_data::packed_t el = m_groups_recvbuf[i];
-                    if (h_group_rtag.data[el.group_tag] != GROUP_NOT_LOCAL)
+                    if (h_group_rtag[el.group_tag] != GROUP_NOT_LOCAL)
                         continue;
 
                     bool has_nonlocal_members = false;
@@ -1017,7 +1017,7 @@ void Communicator::GroupCommunicator<group_data>::exchangeGhostGroups(
                         {
                         unsigned int tag = el.tags.tag[j];
                         assert(tag <= m_comm.m_pdata->getMaximumTag());
-                        if (h_rtag.data[tag] >= max_local)
+                        if (h_rtag[tag] >= max_local)
                             {
                             has_nonlocal_members = true;
                             break;
@@ -1032,7 +1032,7 @@ void Communicator::GroupCommunicator<group_data>::exchangeGhostGroups(
                     h_group_typeval.data[start_idx + added_groups] = el.typeval;
                     h_group_tag.data[start_idx + added_groups] = el.group_tag;
                     h_group_ranks.data[start_idx + added_groups] = el.ranks;
-                    h_group_rtag.data[el.group_tag] = start_idx+added_groups;
+                    h_group_rtag.set(el.group_tag, start_idx+added_groups);
 
                     added_groups++;
                     }
@@ -1078,6 +1078,7 @@ Communicator::Communicator(std::shared_ptr<SystemDefinition> sysdef,
             m_nettorque_copybuf(m_exec_conf),
             m_netvirial_copybuf(m_exec_conf),
             m_netvirial_recvbuf(m_exec_conf),
+            m_scalar_copybuf(m_exec_conf),
             m_plan(m_exec_conf),
             m_plan_reverse(m_exec_conf),
             m_tag_reverse(m_exec_conf),
@@ -1343,11 +1344,16 @@ void Communicator::communicate(unsigned int timestep)
                                         }
                                       , timestep);
 
+    Instrumentation *instrumentation = m_instrumentation.get();
+
     if (!m_force_migrate && !m_compute_callbacks.empty() && m_has_ghost_particles)
         {
         // do an obligatory update before determining whether to migrate
-        beginUpdateGhosts(timestep);
-        finishUpdateGhosts(timestep);
+            {
+            Instrumentation::ScopedRegion region(instrumentation, m_update_ghosts_region);
+            beginUpdateGhosts(timestep);
+            finishUpdateGhosts(timestep);
+            }
 
         // call subscribers after ghost update, but before distance check
         m_compute_callbacks.emit(timestep);
@@ -1373,6 +1379,8 @@ void Communicator::communicate(unsigned int timestep)
     // Update ghosts if we are not migrating
     if (!migrate && m_compute_callbacks.empty())
         {
+        Instrumentation::ScopedRegion region(instrumentation, m_update_ghosts_region);
+
         beginUpdateGhosts(timestep);
 
         finishUpdateGhosts(timestep);
@@ -1384,10 +1392,16 @@ void Communicator::communicate(unsigned int timestep)
         m_force_migrate = false;
 
         // If so, migrate atoms
-        migrateParticles();
+            {
+            Instrumentation::ScopedRegion region(instrumentation, m_migrate_region);
+            migrateParticles();
+            }
 
         // Construct ghost send lists, exchange ghost atom data
-        exchangeGhosts();
+            {
+            Instrumentation::ScopedRegion region(instrumentation, m_exchange_ghosts_region);
+            exchangeGhosts();
+            }
 
         // update particle data now that ghosts are available
         m_compute_callbacks.emit(timestep);
@@ -2067,13 +2081,13 @@ void Communicator::exchangeGhosts()
             {
             // set reverse-lookup tag -> idx
             ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
-            ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::readwrite);
+            TagIndexHandle h_rtag(*m_pdata, access_mode::readwrite);
 
             for (unsigned int idx = start_idx; idx < start_idx + m_num_recv_ghosts[dir]; idx++)
                 {
                 assert(h_tag.data[idx] <= m_pdata->getMaximumTag());
-                assert(h_rtag.data[h_tag.data[idx]] == NOT_LOCAL);
-                h_rtag.data[h_tag.data[idx]] = idx;
+                assert(h_rtag[h_tag.data[idx]] == NOT_LOCAL);
+                h_rtag.set(h_tag.data[idx], idx);
                 }
 
             }
@@ -2352,12 +2366,12 @@ void Communicator::beginUpdateGhosts(unsigned int timestep)
             ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
             ArrayHandle<Scalar4> h_pos_copybuf(m_pos_copybuf, access_location::host, access_mode::overwrite);
             ArrayHandle<unsigned int> h_copy_ghosts(m_copy_ghosts[dir], access_location::host, access_mode::read);
-            ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
+            TagIndexHandle h_rtag(*m_pdata, access_mode::read);
 
             // copy positions of ghost particles
             for (unsigned int ghost_idx = 0; ghost_idx < m_num_copy_ghosts[dir]; ghost_idx++)
                 {
-                unsigned int idx = h_rtag.data[h_copy_ghosts.data[ghost_idx]];
+                unsigned int idx = h_rtag[h_copy_ghosts.data[ghost_idx]];
 
                 assert(idx < m_pdata->getN() + m_pdata->getNGhosts());
 
@@ -2371,12 +2385,12 @@ void Communicator::beginUpdateGhosts(unsigned int timestep)
             ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::read);
             ArrayHandle<Scalar4> h_velocity_copybuf(m_velocity_copybuf, access_location::host, access_mode::overwrite);
             ArrayHandle<unsigned int> h_copy_ghosts(m_copy_ghosts[dir], access_location::host, access_mode::read);
-            ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
+            TagIndexHandle h_rtag(*m_pdata, access_mode::read);
 
             // copy velocity of ghost particles
             for (unsigned int ghost_idx = 0; ghost_idx < m_num_copy_ghosts[dir]; ghost_idx++)
                 {
-                unsigned int idx = h_rtag.data[h_copy_ghosts.data[ghost_idx]];
+                unsigned int idx = h_rtag[h_copy_ghosts.data[ghost_idx]];
 
                 assert(idx < m_pdata->getN() + m_pdata->getNGhosts());
 
@@ -2390,12 +2404,12 @@ void Communicator::beginUpdateGhosts(unsigned int timestep)
             ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
             ArrayHandle<Scalar4> h_orientation_copybuf(m_orientation_copybuf, access_location::host, access_mode::overwrite);
             ArrayHandle<unsigned int> h_copy_ghosts(m_copy_ghosts[dir], access_location::host, access_mode::read);
-            ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
+            TagIndexHandle h_rtag(*m_pdata, access_mode::read);
 
             // copy orientation of ghost particles
             for (unsigned int ghost_idx = 0; ghost_idx < m_num_copy_ghosts[dir]; ghost_idx++)
                 {
-                unsigned int idx = h_rtag.data[h_copy_ghosts.data[ghost_idx]];
+                unsigned int idx = h_rtag[h_copy_ghosts.data[ghost_idx]];
 
                 assert(idx < m_pdata->getN() + m_pdata->getNGhosts());
 
@@ -2594,12 +2608,12 @@ void Communicator::updateNetForce(unsigned int timestep)
             ArrayHandle<Scalar4> h_netforce(m_pdata->getNetForce(), access_location::host, access_mode::read);
             ArrayHandle<Scalar4> h_netforce_copybuf(m_netforce_copybuf, access_location::host, access_mode::overwrite);
             ArrayHandle<unsigned int> h_copy_ghosts(m_copy_ghosts[dir], access_location::host, access_mode::read);
-            ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
+            TagIndexHandle h_rtag(*m_pdata, access_mode::read);
 
             // copy net forces of ghost particles
             for (unsigned int ghost_idx = 0; ghost_idx < m_num_copy_ghosts[dir]; ghost_idx++)
                 {
-                unsigned int idx = h_rtag.data[h_copy_ghosts.data[ghost_idx]];
+                unsigned int idx = h_rtag[h_copy_ghosts.data[ghost_idx]];
 
                 assert(idx < m_pdata->getN() + m_pdata->getNGhosts());
 
@@ -2615,12 +2629,12 @@ void Communicator::updateNetForce(unsigned int timestep)
             ArrayHandle<Scalar4> h_netforce_reverse_recvbuf(m_netforce_reverse_recvbuf, access_location::host, access_mode::read);
             ArrayHandle<unsigned int> h_forward_ghosts_reverse(m_forward_ghosts_reverse[dir], access_location::host, access_mode::overwrite);
             ArrayHandle<Scalar4> h_netforce(m_pdata->getNetForce(), access_location::host, access_mode::read);
-            ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
+            TagIndexHandle h_rtag(*m_pdata, access_mode::read);
 
             // copy reverse net force of ghost particles
             for (unsigned int ghost_idx = 0; ghost_idx < m_num_copy_local_ghosts_reverse[dir]; ghost_idx++)
                 {
-                unsigned int idx = h_rtag.data[h_copy_ghosts_reverse.data[ghost_idx]];
+                unsigned int idx = h_rtag[h_copy_ghosts_reverse.data[ghost_idx]];
 
                 assert(idx < m_pdata->getN() + m_pdata->getNGhosts());
 
@@ -2641,12 +2655,12 @@ void Communicator::updateNetForce(unsigned int timestep)
             ArrayHandle<Scalar4> h_nettorque(m_pdata->getNetTorqueArray(), access_location::host, access_mode::read);
             ArrayHandle<Scalar4> h_nettorque_copybuf(m_nettorque_copybuf, access_location::host, access_mode::overwrite);
             ArrayHandle<unsigned int> h_copy_ghosts(m_copy_ghosts[dir], access_location::host, access_mode::read);
-            ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
+            TagIndexHandle h_rtag(*m_pdata, access_mode::read);
 
             // copy net torques of ghost particles
             for (unsigned int ghost_idx = 0; ghost_idx < m_num_copy_ghosts[dir]; ghost_idx++)
                 {
-                unsigned int idx = h_rtag.data[h_copy_ghosts.data[ghost_idx]];
+                unsigned int idx = h_rtag[h_copy_ghosts.data[ghost_idx]];
 
                 assert(idx < m_pdata->getN() + m_pdata->getNGhosts());
 
@@ -2659,14 +2673,14 @@ void Communicator::updateNetForce(unsigned int timestep)
             ArrayHandle<Scalar> h_netvirial(m_pdata->getNetVirial(), access_location::host, access_mode::read);
             ArrayHandle<Scalar> h_netvirial_copybuf(m_netvirial_copybuf, access_location::host, access_mode::overwrite);
             ArrayHandle<unsigned int> h_copy_ghosts(m_copy_ghosts[dir], access_location::host, access_mode::read);
-            ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
+            TagIndexHandle h_rtag(*m_pdata, access_mode::read);
 
             unsigned int pitch = (unsigned int)m_pdata->getNetVirial().getPitch();
 
             // copy net torques of ghost particles
             for (unsigned int ghost_idx = 0; ghost_idx < m_num_copy_ghosts[dir]; ghost_idx++)
                 {
-                unsigned int idx = h_rtag.data[h_copy_ghosts.data[ghost_idx]];
+                unsigned int idx = h_rtag[h_copy_ghosts.data[ghost_idx]];
 
                 assert(idx < m_pdata->getN() + m_pdata->getNGhosts());
 
@@ -2742,12 +2756,12 @@ void Communicator::updateNetForce(unsigned int timestep)
             ArrayHandle<Scalar4> h_netforce(m_pdata->getNetForce(), access_location::host, access_mode::readwrite);
             ArrayHandle<Scalar4> h_netforce_reverse_recvbuf(m_netforce_reverse_recvbuf, access_location::host, access_mode::read);
             ArrayHandle<unsigned int> h_tag_reverse(m_tag_reverse, access_location::host, access_mode::read);
-            ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
+            TagIndexHandle h_rtag(*m_pdata, access_mode::read);
 
             unsigned int n_local_particles = m_pdata->getN();
             for(unsigned int i = 0; i < m_num_recv_forward_ghosts_reverse[dir] + m_num_recv_local_ghosts_reverse[dir]; i++)
                 {
-                unsigned int idx = h_rtag.data[h_tag_reverse.data[start_idx_reverse + i]];
+                unsigned int idx = h_rtag[h_tag_reverse.data[start_idx_reverse + i]];
                 if (idx < n_local_particles)
                     {
                     Scalar4 f = h_netforce_reverse_recvbuf.data[start_idx_reverse + i];
@@ -2821,19 +2835,87 @@ void Communicator::updateNetForce(unsigned int timestep)
             m_prof->pop();
     }
 
+void Communicator::updateGhostScalar(GPUArray<Scalar>& field)
+    {
+    if (m_prof)
+        m_prof->push("comm_ghost_scalar");
+
+    m_exec_conf->msg->notice(7) << "Communicator: update ghost scalar field" << std::endl;
+
+    assert(field.getNumElements() >= m_pdata->getN() + m_pdata->getNGhosts());
+
+    unsigned int num_tot_recv_ghosts = 0; // total number of ghosts received
+
+    for (unsigned int dir = 0; dir < 6; dir ++)
+        {
+        if (! isCommunicating(dir) ) continue;
+
+        m_scalar_copybuf.resize(m_num_copy_ghosts[dir]);
+
+            {
+            ArrayHandle<Scalar> h_field(field, access_location::host, access_mode::read);
+            ArrayHandle<Scalar> h_scalar_copybuf(m_scalar_copybuf, access_location::host, access_mode::overwrite);
+            ArrayHandle<unsigned int> h_copy_ghosts(m_copy_ghosts[dir], access_location::host, access_mode::read);
+            TagIndexHandle h_rtag(*m_pdata, access_mode::read);
+
+            // copy values of ghost particles, including those received in previous directions
+            for (unsigned int ghost_idx = 0; ghost_idx < m_num_copy_ghosts[dir]; ghost_idx++)
+                {
+                unsigned int idx = h_rtag[h_copy_ghosts.data[ghost_idx]];
+
+                assert(idx < m_pdata->getN() + m_pdata->getNGhosts());
+
+                h_scalar_copybuf.data[ghost_idx] = h_field.data[idx];
+                }
+            }
+
+        unsigned int send_neighbor = m_decomposition->getNeighborRank(dir);
+
+        // we receive from the direction opposite to the one we send to
+        unsigned int recv_neighbor;
+        if (dir % 2 == 0)
+            recv_neighbor = m_decomposition->getNeighborRank(dir+1);
+        else
+            recv_neighbor = m_decomposition->getNeighborRank(dir-1);
+
+        unsigned int start_idx = m_pdata->getN() + num_tot_recv_ghosts;
+
+        num_tot_recv_ghosts += m_num_recv_ghosts[dir];
+
+        if (m_prof)
+            m_prof->push("MPI send/recv");
+
+        m_reqs.resize(2);
+        m_stats.resize(2);
+
+        ArrayHandle<Scalar> h_field(field, access_location::host, access_mode::readwrite);
+        ArrayHandle<Scalar> h_scalar_copybuf(m_scalar_copybuf, access_location::host, access_mode::read);
+
+        // exchange ghost values, write directly to the field
+        MPI_Isend(h_scalar_copybuf.data, (unsigned int)(m_num_copy_ghosts[dir]*sizeof(Scalar)), MPI_BYTE, send_neighbor, 4, m_mpi_comm, &m_reqs[0]);
+        MPI_Irecv(h_field.data + start_idx, (unsigned int)(m_num_recv_ghosts[dir]*sizeof(Scalar)), MPI_BYTE, recv_neighbor, 4, m_mpi_comm, &m_reqs[1]);
+        MPI_Waitall(2, &m_reqs.front(), &m_stats.front());
+
+        if (m_prof)
+            m_prof->pop(0, (m_num_recv_ghosts[dir]+m_num_copy_ghosts[dir])*sizeof(Scalar));
+        } // end dir loop
+
+    if (m_prof)
+        m_prof->pop();
+    }
 
 void Communicator::removeGhostParticleTags()
     {
     // wipe out reverse-lookup tag -> idx for old ghost atoms
     ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
-    ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::readwrite);
+    TagIndexHandle h_rtag(*m_pdata, access_mode::readwrite);
 
     m_exec_conf->msg->notice(9) << "Communicator: removing " << m_ghosts_added << " ghost particles " << std::endl;
 
     for (unsigned int i = 0; i < m_ghosts_added; i++)
         {
         unsigned int idx = m_pdata->getN() + i;
-        h_rtag.data[h_tag.data[idx]] = NOT_LOCAL;
+        h_rtag.set(h_tag.data[idx], NOT_LOCAL);
         }
 
     m_ghosts_added = 0;
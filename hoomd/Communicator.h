@@ -19,6 +19,7 @@
 #include "ParticleData.h"
 #include "BondedGroupData.h"
 #include "DomainDecomposition.h"
+#include "Instrumentation.h"
 
 #include <memory>
 #include <hoomd/extern/nano-signal-slot/nano_signal_slot.hpp>
@@ -168,6 +169,20 @@ class PYBIND11_EXPORT Communicator
             m_prof = prof;
             }
 
+        //! Set the instrumentation used to time the communication phases
+        /*! \param instrumentation Instrumentation to record into, null to disable
+         */
+        void setInstrumentation(std::shared_ptr<Instrumentation> instrumentation)
+            {
+            m_instrumentation = instrumentation;
+            if (m_instrumentation)
+                {
+                m_update_ghosts_region = m_instrumentation->registerRegion("comm:update_ghosts");
+                m_migrate_region = m_instrumentation->registerRegion("comm:migrate");
+                m_exchange_ghosts_region = m_instrumentation->registerRegion("comm:exchange_ghosts");
+                }
+            }
+
         //! Subscribe to list of functions that determine when the particles are migrated
         /*! This method keeps track of all functions that may request particle migration.
          * \return A Nano::Signal object reference to be used for connect and disconnect calls.
@@ -323,6 +338,17 @@ class PYBIND11_EXPORT Communicator
          */
         virtual void updateNetForce(unsigned int timestep);
 
+        /*! Copy a per-particle scalar field from local particles to their ghost copies
+         * \param field Array indexed by local particle index, with at least N+N_ghost elements
+         *
+         * This allows computes to communicate intermediate per-particle quantities (e.g. the derivative of the
+         * embedding function in EAM) using the current ghost exchange lists.
+         *
+         * \pre The ghost exchange list has been constructed in a previous time step, using exchangeGhosts().
+         * \post The ghost elements of \a field hold the values of the corresponding particles on their owner ranks
+         */
+        virtual void updateGhostScalar(GPUArray<Scalar>& field);
+
         /*! This methods finds all the particles that are no longer inside the domain
          * boundaries and transfers them to neighboring processors.
          *
@@ -464,6 +490,10 @@ class PYBIND11_EXPORT Communicator
         const MPI_Comm m_mpi_comm; //!< MPI communicator
         std::shared_ptr<DomainDecomposition> m_decomposition;       //!< Domain decomposition information
         std::shared_ptr<Profiler> m_prof;                           //!< Profiler
+        std::shared_ptr<Instrumentation> m_instrumentation;         //!< Per-region timing, null when disabled
+        unsigned int m_update_ghosts_region=0;                      //!< Instrumented region of ghost updates
+        unsigned int m_migrate_region=0;                            //!< Instrumented region of particle migration
+        unsigned int m_exchange_ghosts_region=0;                    //!< Instrumented region of the ghost exchange
 
         bool m_is_communicating;               //!< Whether we are currently communicating
         bool m_force_migrate;                  //!< True if particle migration is forced
@@ -491,6 +521,7 @@ class PYBIND11_EXPORT Communicator
         GlobalVector<Scalar4> m_nettorque_copybuf;   //!< Buffer for net torque
         GlobalVector<Scalar> m_netvirial_copybuf;   //!< Buffer for net virial
         GlobalVector<Scalar> m_netvirial_recvbuf;   //!< Buffer for net virial (receive)
+        GlobalVector<Scalar> m_scalar_copybuf;      //!< Buffer for generic per-particle scalar fields
 
         GlobalVector<unsigned int> m_copy_ghosts[6]; //!< Per-direction list of indices of particles to send as ghosts
         unsigned int m_num_copy_ghosts[6];       //!< Number of local particles that are sent to neighboring processors
@@ -69,6 +69,13 @@ class PYBIND11_EXPORT CommunicatorGPU : public Communicator
          * \parm timestep The time step
          */
         virtual void updateNetForce(unsigned int timestep);
+
+        //! Copy a per-particle scalar field to ghost particles (not implemented on the GPU)
+        virtual void updateGhostScalar(GPUArray<Scalar>& field)
+            {
+            m_exec_conf->msg->error() << "Ghost communication of per-particle scalar fields is not implemented on the GPU" << std::endl;
+            throw std::runtime_error("Error communicating ghost particle data");
+            }
         //@}
 
         //! Set maximum number of communication stages
@@ -28,6 +28,7 @@
 #include <iostream>
 #include <stdexcept>
 #include <algorithm>
+#include <cstdint>
 #include <stdlib.h>
 #include <memory>
 
@@ -288,7 +289,16 @@ class ArrayHandleDispatch
     public:
         //! Constructor
         ArrayHandleDispatch(T* const _data)
-            : data(_data) {}
+            : data(_data), version(nullptr) {}
+
+        //! Move constructor
+        /*! The pending version increment is transferred, so that it is applied once when the handle is released
+         */
+        ArrayHandleDispatch(ArrayHandleDispatch&& other)
+            : data(other.data), version(other.version)
+            {
+            other.version = nullptr;
+            }
 
         //! Get the data pointer
         T * const get() const
@@ -296,12 +306,27 @@ class ArrayHandleDispatch
             return data;
             }
 
+        //! Increment a version counter when the data is released
+        /*! \param _version Counter to increment
+         */
+        void incrementVersionOnRelease(uint64_t *_version)
+            {
+            version = _version;
+            }
+
         //! Destructor
-        virtual ~ArrayHandleDispatch() = default;
+        virtual ~ArrayHandleDispatch()
+            {
+            if (version)
+                (*version)++;
+            }
 
     private:
         //! The data pointer
         T* const data;
+
+        //! Version counter of the array, incremented on release when the data was acquired for writing
+        uint64_t *version;
     };
 
 //! Handle to access the data pointer handled by GPUArray
@@ -19,21 +19,26 @@ namespace py = pybind11;
     \param name File name to read
     \param frame Frame index to read from the file
     \param from_end Count frames back from the end of the file
+    \param distributed Read a slice of the file on every rank
 
     The GSDReader constructor opens the GSD file, initializes an empty snapshot, and reads the file into
-    memory (on the root rank).
+    memory (on the root rank). When \a distributed is set and there is more than one rank, all ranks open the file
+    and read the header and their slice of the particles and bonded groups.
 */
 GSDReader::GSDReader(std::shared_ptr<const ExecutionConfiguration> exec_conf,
                      const std::string &name,
                      const uint64_t frame,
-                     bool from_end)
-    : m_exec_conf(exec_conf), m_timestep(0), m_name(name), m_frame(frame)
+                     bool from_end,
+                     bool distributed)
+    : m_exec_conf(exec_conf), m_timestep(0), m_name(name), m_frame(frame), m_distributed(false)
     {
     m_snapshot = std::shared_ptr< SnapshotSystemData<float> >(new SnapshotSystemData<float>);
 
     #ifdef ENABLE_MPI
+    m_distributed = distributed && m_exec_conf->getNRanks() > 1;
+
     // if we are not the root processor, do not perform file I/O
-    if (!m_exec_conf->isRoot())
+    if (!m_exec_conf->isRoot() && !m_distributed)
         {
         return;
         }
@@ -68,8 +73,8 @@ GSDReader::GSDReader(std::shared_ptr<const ExecutionConfiguration> exec_conf,
         throw runtime_error("Error opening GSD file");
         }
 
-    readHeader();
-    readParticles();
+    unsigned int N = readHeader();
+    readParticles(N);
     readTopology();
     }
 
@@ -77,7 +82,7 @@ GSDReader::~GSDReader()
     {
     #ifdef ENABLE_MPI
     // if we are not the root processor, do not perform file I/O
-    if (!m_exec_conf->isRoot())
+    if (!m_exec_conf->isRoot() && !m_distributed)
         {
         return;
         }
@@ -127,6 +132,77 @@ bool GSDReader::readChunk(void *data, uint64_t frame, const char *name, size_t e
         }
     }
 
+/*! \param N Number of rows in the chunk
+    \param begin Set to the first row read by this rank
+    \param end Set to one past the last row read by this rank
+
+    A distributed reader splits the rows evenly into contiguous slices, in rank order. Otherwise, the slice is the
+    whole chunk.
+*/
+void GSDReader::getSlice(unsigned int N, unsigned int& begin, unsigned int& end) const
+    {
+    begin = 0;
+    end = N;
+
+    #ifdef ENABLE_MPI
+    if (m_distributed)
+        {
+        uint64_t rank = m_exec_conf->getRank();
+        uint64_t n_ranks = m_exec_conf->getNRanks();
+        begin = (unsigned int)(uint64_t(N) * rank / n_ranks);
+        end = (unsigned int)(uint64_t(N) * (rank + 1) / n_ranks);
+        }
+    #endif
+    }
+
+/*! \param data Pointer to data to read into, with room for the rows of this rank's slice
+    \param frame Frame index to read from
+    \param name Name of the data chunk
+    \param row_size Expected size of one row of the data chunk in bytes.
+    \param N Expected number of rows in the data chunk.
+
+    Same as readChunk(), but reads only the rows of this rank's slice (see getSlice()) directly from their location
+    in the file.
+
+    Return true if the chunk is present in the file.
+*/
+bool GSDReader::readChunkSlice(void *data, uint64_t frame, const char *name, size_t row_size, unsigned int N)
+    {
+    const struct gsd_index_entry* entry = gsd_find_chunk(&m_handle, frame, name);
+    if (entry == NULL && frame != 0)
+        entry = gsd_find_chunk(&m_handle, 0, name);
+
+    if (entry == NULL || entry->N != N)
+        {
+        m_exec_conf->msg->notice(10) << "data.gsd_snapshot: chunk not found " << name << endl;
+        return false;
+        }
+
+    m_exec_conf->msg->notice(7) << "data.gsd_snapshot: reading chunk " << name << endl;
+    size_t actual_row_size = entry->M * gsd_sizeof_type((enum gsd_type)entry->type);
+    if (actual_row_size != row_size)
+        {
+        m_exec_conf->msg->error() << "data.gsd_snapshot: " << "Expecting " << N*row_size << " bytes in " << name
+                                  << " but found " << N*actual_row_size << endl;
+        throw runtime_error("Error reading GSD file");
+        }
+
+    unsigned int begin, end;
+    getSlice(N, begin, end);
+    if (end == begin)
+        return true;
+
+    // read the rows of the slice as a chunk of their own
+    struct gsd_index_entry slice = *entry;
+    slice.N = end - begin;
+    slice.location = entry->location + int64_t(begin) * int64_t(row_size);
+
+    int retval = gsd_read_chunk(&m_handle, data, &slice);
+    GSDUtils::checkError(retval, m_name);
+
+    return true;
+    }
+
 /*! \param frame Frame index to read from
     \param name Name of the data chunk
 
@@ -170,8 +246,10 @@ std::vector<std::string> GSDReader::readTypes(uint64_t frame, const char *name)
     }
 
 /*! Read the same data chunks written by GSDDumpWriter::writeFrameHeader
+
+    \returns The number of particles in the frame
 */
-void GSDReader::readHeader()
+unsigned int GSDReader::readHeader()
     {
     readChunk(&m_timestep, m_frame, "configuration/step", 8);
 
@@ -191,86 +269,98 @@ void GSDReader::readHeader()
         m_exec_conf->msg->error() << "data.gsd_snapshot: " << "cannot read a file with 0 particles" << endl;
         throw runtime_error("Error reading GSD file");
         }
-    m_snapshot->particle_data.resize(N);
+
+    unsigned int begin, end;
+    getSlice(N, begin, end);
+    m_snapshot->particle_data.resize(end - begin);
+    return N;
     }
 
 /*! Read the same data chunks for particles
+
+    \param N Number of particles in the frame
 */
-void GSDReader::readParticles()
+void GSDReader::readParticles(unsigned int N)
     {
-    unsigned int N = m_snapshot->particle_data.size;
-    m_snapshot->particle_data.type_mapping = readTypes(m_frame, "particles/types");
+    SnapshotParticleData<float>& pdata = m_snapshot->particle_data;
+    pdata.type_mapping = readTypes(m_frame, "particles/types");
 
     // the snapshot already has default values, if a chunk is not found, the value
     // is already at the default, and the failed read is not a problem
-    readChunk(&m_snapshot->particle_data.type[0], m_frame, "particles/typeid", N*4, N);
-    readChunk(&m_snapshot->particle_data.mass[0], m_frame, "particles/mass", N*4, N);
-    readChunk(&m_snapshot->particle_data.charge[0], m_frame, "particles/charge", N*4, N);
-    readChunk(&m_snapshot->particle_data.diameter[0], m_frame, "particles/diameter", N*4, N);
-    readChunk(&m_snapshot->particle_data.body[0], m_frame, "particles/body", N*4, N);
-    readChunk(&m_snapshot->particle_data.inertia[0], m_frame, "particles/moment_inertia", N*12, N);
-    readChunk(&m_snapshot->particle_data.pos[0], m_frame, "particles/position", N*12, N);
-    readChunk(&m_snapshot->particle_data.orientation[0], m_frame, "particles/orientation", N*16, N);
-    readChunk(&m_snapshot->particle_data.vel[0], m_frame, "particles/velocity", N*12, N);
-    readChunk(&m_snapshot->particle_data.angmom[0], m_frame, "particles/angmom", N*16, N);
-    readChunk(&m_snapshot->particle_data.image[0], m_frame, "particles/image", N*12, N);
+    readChunkSlice(pdata.type.data(), m_frame, "particles/typeid", 4, N);
+    readChunkSlice(pdata.mass.data(), m_frame, "particles/mass", 4, N);
+    readChunkSlice(pdata.charge.data(), m_frame, "particles/charge", 4, N);
+    readChunkSlice(pdata.diameter.data(), m_frame, "particles/diameter", 4, N);
+    readChunkSlice(pdata.body.data(), m_frame, "particles/body", 4, N);
+    readChunkSlice(pdata.inertia.data(), m_frame, "particles/moment_inertia", 12, N);
+    readChunkSlice(pdata.pos.data(), m_frame, "particles/position", 12, N);
+    readChunkSlice(pdata.orientation.data(), m_frame, "particles/orientation", 16, N);
+    readChunkSlice(pdata.vel.data(), m_frame, "particles/velocity", 12, N);
+    readChunkSlice(pdata.angmom.data(), m_frame, "particles/angmom", 16, N);
+    readChunkSlice(pdata.image.data(), m_frame, "particles/image", 12, N);
     }
 
 /*! Read the same data chunks for topology
 */
 void GSDReader::readTopology()
     {
+    unsigned int begin, end;
     unsigned int N = 0;
     readChunk(&N, m_frame, "bonds/N", 4);
     if (N > 0)
         {
-        m_snapshot->bond_data.resize(N);
+        getSlice(N, begin, end);
+        m_snapshot->bond_data.resize(end - begin);
         m_snapshot->bond_data.type_mapping = readTypes(m_frame, "bonds/types");
-        readChunk(&m_snapshot->bond_data.type_id[0], m_frame, "bonds/typeid", N*4, N);
-        readChunk(&m_snapshot->bond_data.groups[0], m_frame, "bonds/group", N*8, N);
+        readChunkSlice(m_snapshot->bond_data.type_id.data(), m_frame, "bonds/typeid", 4, N);
+        readChunkSlice(m_snapshot->bond_data.groups.data(), m_frame, "bonds/group", 8, N);
         }
 
     N = 0;
     readChunk(&N, m_frame, "angles/N", 4);
     if (N > 0)
         {
-        m_snapshot->angle_data.resize(N);
+        getSlice(N, begin, end);
+        m_snapshot->angle_data.resize(end - begin);
         m_snapshot->angle_data.type_mapping = readTypes(m_frame, "angles/types");
-        readChunk(&m_snapshot->angle_data.type_id[0], m_frame, "angles/typeid", N*4, N);
-        readChunk(&m_snapshot->angle_data.groups[0], m_frame, "angles/group", N*12, N);
+        readChunkSlice(m_snapshot->angle_data.type_id.data(), m_frame, "angles/typeid", 4, N);
+        readChunkSlice(m_snapshot->angle_data.groups.data(), m_frame, "angles/group", 12, N);
         }
 
     N = 0;
     readChunk(&N, m_frame, "dihedrals/N", 4);
     if (N > 0)
         {
-        m_snapshot->dihedral_data.resize(N);
+        getSlice(N, begin, end);
+        m_snapshot->dihedral_data.resize(end - begin);
         m_snapshot->dihedral_data.type_mapping = readTypes(m_frame, "dihedrals/types");
-        readChunk(&m_snapshot->dihedral_data.type_id[0], m_frame, "dihedrals/typeid", N*4, N);
-        readChunk(&m_snapshot->dihedral_data.groups[0], m_frame, "dihedrals/group", N*16, N);
+        readChunkSlice(m_snapshot->dihedral_data.type_id.data(), m_frame, "dihedrals/typeid", 4, N);
+        readChunkSlice(m_snapshot->dihedral_data.groups.data(), m_frame, "dihedrals/group", 16, N);
         }
 
     N = 0;
     readChunk(&N, m_frame, "impropers/N", 4);
     if (N > 0)
         {
-        m_snapshot->improper_data.resize(N);
+        getSlice(N, begin, end);
+        m_snapshot->improper_data.resize(end - begin);
         m_snapshot->improper_data.type_mapping = readTypes(m_frame, "impropers/types");
-        readChunk(&m_snapshot->improper_data.type_id[0], m_frame, "impropers/typeid", N*4, N);
-        readChunk(&m_snapshot->improper_data.groups[0], m_frame, "impropers/group", N*16, N);
+        readChunkSlice(m_snapshot->improper_data.type_id.data(), m_frame, "impropers/typeid", 4, N);
+        readChunkSlice(m_snapshot->improper_data.groups.data(), m_frame, "impropers/group", 16, N);
         }
 
     N = 0;
     readChunk(&N, m_frame, "constraints/N", 4);
     if (N > 0)
         {
-        m_snapshot->constraint_data.resize(N);
-        std::vector<float> data(N);
-        readChunk(&data[0], m_frame, "constraints/value", N*4, N);
-        for (unsigned int i=0; i < N; i++)
+        getSlice(N, begin, end);
+        m_snapshot->constraint_data.resize(end - begin);
+        std::vector<float> data(end - begin);
+        readChunkSlice(data.data(), m_frame, "constraints/value", 4, N);
+        for (unsigned int i=0; i < end - begin; i++)
             m_snapshot->constraint_data.val[i] = Scalar(data[i]);
 
-        readChunk(&m_snapshot->constraint_data.groups[0], m_frame, "constraints/group", N*8, N);
+        readChunkSlice(m_snapshot->constraint_data.groups.data(), m_frame, "constraints/group", 8, N);
         }
 
     if (m_handle.header.schema_version >= gsd_make_version(1,1))
@@ -279,10 +369,11 @@ void GSDReader::readTopology()
         readChunk(&N, m_frame, "pairs/N", 4);
         if (N > 0)
             {
-            m_snapshot->pair_data.resize(N);
+            getSlice(N, begin, end);
+            m_snapshot->pair_data.resize(end - begin);
             m_snapshot->pair_data.type_mapping = readTypes(m_frame, "pairs/types");
-            readChunk(&m_snapshot->pair_data.type_id[0], m_frame, "pairs/typeid", N*4, N);
-            readChunk(&m_snapshot->pair_data.groups[0], m_frame, "pairs/group", N*8, N);
+            readChunkSlice(m_snapshot->pair_data.type_id.data(), m_frame, "pairs/typeid", 4, N);
+            readChunkSlice(m_snapshot->pair_data.groups.data(), m_frame, "pairs/group", 8, N);
             }
         }
     }
@@ -444,7 +535,9 @@ void export_GSDReader(py::module& m)
     {
     py::class_< GSDReader, std::shared_ptr<GSDReader> >(m,"GSDReader")
     .def(py::init<std::shared_ptr<const ExecutionConfiguration>, const string&, const uint64_t, bool>())
+    .def(py::init<std::shared_ptr<const ExecutionConfiguration>, const string&, const uint64_t, bool, bool>())
     .def("getTimeStep", &GSDReader::getTimeStep)
+    .def("isDistributed", &GSDReader::isDistributed)
     .def("getSnapshot", &GSDReader::getSnapshot)
     .def("clearSnapshot", &GSDReader::clearSnapshot)
     .def("readTypeShapesPy", &GSDReader::readTypeShapesPy)
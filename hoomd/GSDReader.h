@@ -22,6 +22,11 @@ template <class Real> struct SnapshotSystemData;
 /*! Read an input GSD file and generate a system snapshot. GSDReader can read any frame from a GSD
     file into the snapshot. For information on the GSD specification, see http://gsd.readthedocs.io/
 
+    By default, only the root rank reads the file. A distributed reader opens the file on all ranks and every rank
+    reads a contiguous slice of the per-particle and per-group chunks into its snapshot, in rank order. Pass the
+    distributed snapshot to SystemDefinition with \a distributed set to initialize without a snapshot of the whole
+    system on the root rank.
+
     \ingroup data_structs
 */
 class PYBIND11_EXPORT GSDReader
@@ -31,7 +36,8 @@ class PYBIND11_EXPORT GSDReader
         GSDReader(std::shared_ptr<const ExecutionConfiguration> exec_conf,
                   const std::string &name,
                   const uint64_t frame,
-                  bool from_end);
+                  bool from_end,
+                  bool distributed=false);
 
         //! Destructor
         ~GSDReader();
@@ -62,6 +68,12 @@ class PYBIND11_EXPORT GSDReader
             return m_frame;
             }
 
+        //! Returns true if every rank holds a slice of the snapshot
+        bool isDistributed() const
+            {
+            return m_distributed;
+            }
+
         //! Helper function to read a quantity from the file
         bool readChunk(void *data, uint64_t frame, const char *name, size_t expected_size, unsigned int cur_n=0);
 
@@ -86,13 +98,20 @@ class PYBIND11_EXPORT GSDReader
         uint64_t m_frame;                                            //!< Cached frame
         std::shared_ptr< SnapshotSystemData<float> > m_snapshot;   //!< The snapshot to read
         gsd_handle m_handle;                                         //!< Handle to the file
+        bool m_distributed;                                          //!< True if all ranks read a slice of the file
 
         //! Helper function to read a type list from the file
         std::vector<std::string> readTypes(uint64_t frame, const char *name);
 
+        //! Helper function to get the rows of a chunk with N rows that this rank reads
+        void getSlice(unsigned int N, unsigned int& begin, unsigned int& end) const;
+
+        //! Helper function to read this rank's slice of a per-particle or per-group chunk
+        bool readChunkSlice(void *data, uint64_t frame, const char *name, size_t row_size, unsigned int N);
+
         // helper functions to read sections of the file
-        void readHeader();
-        void readParticles();
+        unsigned int readHeader();
+        void readParticles(unsigned int N);
         void readTopology();
     };
 
@@ -39,6 +39,8 @@
 #include "GPUArray.h"
 #include "MemoryTraceback.h"
 
+#include <algorithm>
+#include <cstdint>
 #include <type_traits>
 #include <string>
 #include <unistd.h>
@@ -218,7 +220,8 @@ class GlobalArray : public GPUArrayBase<T, GlobalArray<T> >
     public:
         //! Empty constructor
         GlobalArray()
-            : m_num_elements(0), m_pitch(0), m_height(0), m_acquired(false), m_align_bytes(0), m_is_managed(false)
+            : m_num_elements(0), m_pitch(0), m_height(0), m_acquired(false), m_version(0), m_align_bytes(0),
+              m_is_managed(false)
             { }
 
         /*! Allocate a 1D array in managed memory
@@ -233,8 +236,8 @@ class GlobalArray : public GPUArrayBase<T, GlobalArray<T> >
             m_fallback((exec_conf->allConcurrentManagedAccess() || (force_managed && exec_conf->isCUDAEnabled())) ?
                 GPUArray<T>() : GPUArray<T>(num_elements, exec_conf)),
             #endif
-            m_num_elements(num_elements), m_pitch(num_elements), m_height(1), m_acquired(false), m_tag(tag),
-            m_align_bytes(0),
+            m_num_elements(num_elements), m_pitch(num_elements), m_height(1), m_acquired(false), m_version(0),
+            m_tag(tag), m_align_bytes(0),
             m_is_managed(exec_conf->allConcurrentManagedAccess() || (force_managed && exec_conf->isCUDAEnabled()))
             {
             #ifndef ALWAYS_USE_MANAGED_MEMORY
@@ -267,7 +270,7 @@ class GlobalArray : public GPUArrayBase<T, GlobalArray<T> >
               m_fallback(from.m_fallback),
               #endif
               m_num_elements(from.m_num_elements),
-              m_pitch(from.m_pitch), m_height(from.m_height), m_acquired(false),
+              m_pitch(from.m_pitch), m_height(from.m_height), m_acquired(false), m_version(0),
               m_tag(from.m_tag), m_align_bytes(from.m_align_bytes),
               m_is_managed(false)
             {
@@ -306,6 +309,7 @@ class GlobalArray : public GPUArrayBase<T, GlobalArray<T> >
                 m_pitch = rhs.m_pitch;
                 m_height = rhs.m_height;
                 m_acquired = false;
+                m_version = std::max(m_version, rhs.m_version) + 1;
                 m_align_bytes = rhs.m_align_bytes;
                 m_tag = rhs.m_tag;
 
@@ -348,6 +352,7 @@ class GlobalArray : public GPUArrayBase<T, GlobalArray<T> >
               m_pitch(std::move(other.m_pitch)),
               m_height(std::move(other.m_height)),
               m_acquired(std::move(other.m_acquired)),
+              m_version(other.m_version),
               m_tag(std::move(other.m_tag)),
               m_align_bytes(std::move(other.m_align_bytes)),
               m_is_managed(std::move(other.m_is_managed))
@@ -372,6 +377,7 @@ class GlobalArray : public GPUArrayBase<T, GlobalArray<T> >
                 m_pitch = std::move(other.m_pitch);
                 m_height = std::move(other.m_height);
                 m_acquired = std::move(other.m_acquired);
+                m_version = std::max(m_version, other.m_version) + 1;
                 m_tag = std::move(other.m_tag);
                 m_align_bytes = std::move(other.m_align_bytes);
                 m_is_managed = std::move(other.m_is_managed);
@@ -395,7 +401,7 @@ class GlobalArray : public GPUArrayBase<T, GlobalArray<T> >
             m_fallback((exec_conf->allConcurrentManagedAccess() || (force_managed && exec_conf->isCUDAEnabled())) ?
                 GPUArray<T>() : GPUArray<T>(width, height, exec_conf)),
             #endif
-            m_height(height), m_acquired(false), m_align_bytes(0),
+            m_height(height), m_acquired(false), m_version(0), m_align_bytes(0),
             m_is_managed(exec_conf->allConcurrentManagedAccess() || (force_managed && exec_conf->isCUDAEnabled()))
             {
             #ifndef ALWAYS_USE_MANAGED_MEMORY
@@ -444,6 +450,20 @@ class GlobalArray : public GPUArrayBase<T, GlobalArray<T> >
             #ifndef ALWAYS_USE_MANAGED_MEMORY
             m_fallback.swap(from.m_fallback);
             #endif
+
+            // the contents of both arrays changed
+            m_version = from.m_version = std::max(m_version, from.m_version) + 1;
+            }
+
+        //! Get the modification version of the array
+        /*! The version increases whenever the contents of the array may have changed, i.e. when a handle acquired
+            with a mode other than access_mode::read is released, or when the array is resized, assigned, or swapped.
+            Read only access leaves the version unchanged. Caches derived from the array
+            contents compare versions to determine whether they are stale.
+        */
+        uint64_t getVersion() const
+            {
+            return m_version;
             }
 
         //! Get the underlying raw pointer
@@ -521,6 +541,8 @@ class GlobalArray : public GPUArrayBase<T, GlobalArray<T> >
         */
         inline void resize(size_t num_elements)
             {
+            m_version++;
+
             #ifndef ALWAYS_USE_MANAGED_MEMORY
             if (! this->m_exec_conf || ! m_is_managed)
                 {
@@ -569,6 +591,7 @@ class GlobalArray : public GPUArrayBase<T, GlobalArray<T> >
         inline void resize(size_t width, size_t height)
             {
             assert(this->m_exec_conf);
+            m_version++;
 
             #ifndef ALWAYS_USE_MANAGED_MEMORY
             if (! m_is_managed)
@@ -678,6 +701,7 @@ class GlobalArray : public GPUArrayBase<T, GlobalArray<T> >
         size_t m_height; //!< Height of 2D array
 
         mutable bool m_acquired;       //!< Tracks if the array is already acquired
+        mutable uint64_t m_version;    //!< Incremented on every (potential) modification of the contents
 
         std::string m_tag;     //!< Name tag of this buffer (optional)
 
@@ -809,11 +833,18 @@ inline ArrayHandleDispatch<T> GlobalArray<T>::acquire(const access_location::Enu
     {
     #ifndef ALWAYS_USE_MANAGED_MEMORY
     if (!this->m_exec_conf || ! m_is_managed)
-        return m_fallback.acquire(location, mode
+        {
+        ArrayHandleDispatch<T> dispatch = m_fallback.acquire(location, mode
             #ifdef ENABLE_HIP
                              , async
             #endif
             );
+
+        // the contents change when a writable handle is released
+        if (mode != access_mode::read)
+            dispatch.incrementVersionOnRelease(&m_version);
+        return dispatch;
+        }
     #endif
 
     if (m_acquired)
@@ -844,5 +875,8 @@ inline ArrayHandleDispatch<T> GlobalArray<T>::acquire(const access_location::Enu
         }
     #endif
 
-    return GlobalArrayDispatch<T>(m_data.get(), *this);
+    ArrayHandleDispatch<T> dispatch = GlobalArrayDispatch<T>(m_data.get(), *this);
+    if (mode != access_mode::read)
+        dispatch.incrementVersionOnRelease(&m_version);
+    return dispatch;
     }
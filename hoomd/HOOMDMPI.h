@@ -22,7 +22,9 @@
 
 #include <mpi.h>
 
+#include <cstring>
 #include <sstream>
+#include <type_traits>
 #include <vector>
 
 #include <cereal/types/set.hpp>
@@ -416,6 +418,66 @@ void all_gather_v(const T& in_value, std::vector<T> & out_values, const MPI_Comm
     delete[] rbuf;
     }
 
+//! Wrapper around MPI_Alltoallv that exchanges vectors of plain data between all ranks
+/*! \param in_values Values to send, one vector per destination rank
+    \param out_values Values received, one vector per source rank
+    \param mpi_comm The MPI communicator
+
+    T must be trivially copyable, the values are sent as raw bytes without serialization. The order of the values
+    sent from one rank to another is preserved.
+*/
+template<typename T>
+void all_to_all_v(const std::vector< std::vector<T> >& in_values, std::vector< std::vector<T> >& out_values,
+                  const MPI_Comm mpi_comm)
+    {
+    static_assert(std::is_trivially_copyable<T>::value, "all_to_all_v requires a trivially copyable type");
+
+    int size;
+    MPI_Comm_size(mpi_comm, &size);
+
+    assert(in_values.size() == (unsigned int) size);
+
+    std::vector<int> send_counts(size);
+    std::vector<int> send_displs(size);
+    std::vector<int> recv_counts(size);
+    std::vector<int> recv_displs(size);
+
+    // exchange the number of bytes to send to every rank
+    for (unsigned int i = 0; i < (unsigned int) size; i++)
+        send_counts[i] = (int)(in_values[i].size() * sizeof(T));
+
+    MPI_Alltoall(&send_counts.front(), 1, MPI_INT, &recv_counts.front(), 1, MPI_INT, mpi_comm);
+
+    // pack send buffer
+    size_t send_len = 0;
+    size_t recv_len = 0;
+    for (unsigned int i = 0; i < (unsigned int) size; i++)
+        {
+        send_displs[i] = (int) send_len;
+        recv_displs[i] = (int) recv_len;
+        send_len += send_counts[i];
+        recv_len += recv_counts[i];
+        }
+
+    std::vector<char> sbuf(send_len + 1);
+    std::vector<char> rbuf(recv_len + 1);
+    for (unsigned int i = 0; i < (unsigned int) size; i++)
+        if (send_counts[i])
+            memcpy(&sbuf[send_displs[i]], in_values[i].data(), send_counts[i]);
+
+    MPI_Alltoallv(&sbuf.front(), &send_counts.front(), &send_displs.front(), MPI_BYTE,
+                  &rbuf.front(), &recv_counts.front(), &recv_displs.front(), MPI_BYTE, mpi_comm);
+
+    // unpack receive buffer
+    out_values.resize(size);
+    for (unsigned int i = 0; i < (unsigned int) size; i++)
+        {
+        out_values[i].resize(recv_counts[i] / sizeof(T));
+        if (recv_counts[i])
+            memcpy(out_values[i].data(), &rbuf[recv_displs[i]], recv_counts[i]);
+        }
+    }
+
 //! Wrapper around MPI_Send that handles any serializable object
 template<typename T>
 void send(const T& val,const unsigned int dest, const MPI_Comm mpi_comm)
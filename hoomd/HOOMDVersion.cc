@@ -36,6 +36,9 @@ std::string BuildInfo::getCompileFlags()
 #ifdef ENABLE_HPMC_MIXED_PRECISION
     o << "HPMC_MIXED ";
 #endif
+#ifdef ENABLE_MPCD_MIXED_PRECISION
+    o << "MPCD_MIXED ";
+#endif
 #endif
 
 #ifdef ENABLE_MPI
@@ -333,7 +333,6 @@ void IMDInterface::processIMD_MDCOMM(unsigned int n)
 
     if (m_force)
         {
-        ArrayHandle< unsigned int > h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
         m_force->setForce(0,0,0);
         for (unsigned int i = 0; i < n; i++)
             {
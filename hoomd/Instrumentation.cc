@@ -0,0 +1,262 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+/*! \file Instrumentation.cc
+    \brief Defines the Instrumentation class
+*/
+
+#include "Instrumentation.h"
+
+#include <pybind11/stl.h>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <stdexcept>
+
+#ifdef __GNUG__
+#include <cxxabi.h>
+#include <cstdlib>
+#endif
+
+using namespace std;
+namespace py = pybind11;
+
+std::atomic<uint64_t> Instrumentation::s_next_id(1);
+
+Instrumentation::Instrumentation(unsigned int pid, unsigned int trace_capacity, unsigned int window)
+    : m_id(s_next_id++), m_pid(pid), m_trace_capacity(trace_capacity), m_window(std::max(window, 1u)),
+      m_t0(std::chrono::steady_clock::now()), m_timestep(0)
+    {
+    }
+
+/*! \param name Name of the region
+    \returns The region id
+*/
+unsigned int Instrumentation::registerRegion(const std::string& name)
+    {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = std::find(m_names.begin(), m_names.end(), name);
+    if (it != m_names.end())
+        return (unsigned int)(it - m_names.begin());
+
+    m_names.push_back(name);
+    m_stats.emplace_back();
+    m_stats.back().samples.resize(m_window);
+    return (unsigned int)(m_names.size() - 1);
+    }
+
+unsigned int Instrumentation::getNumRegions() const
+    {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return (unsigned int)m_names.size();
+    }
+
+std::vector<std::string> Instrumentation::getRegionNames() const
+    {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_names;
+    }
+
+void Instrumentation::acquireThreadBuffer(ThreadCache& cache)
+    {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    std::unique_ptr<ThreadBuffer>& buf = m_buffers[std::this_thread::get_id()];
+    if (!buf)
+        {
+        buf.reset(new ThreadBuffer());
+        buf->events.resize(m_trace_capacity);
+        buf->step_time.resize(m_names.size(), 0);
+        buf->step_calls.resize(m_names.size(), 0);
+        buf->tid = (unsigned int)(m_buffers.size() - 1);
+        }
+
+    cache.owner = m_id;
+    cache.buf = buf.get();
+    }
+
+/*! \param timestep The time step that has just completed
+
+    Must not be called while other threads are recording.
+*/
+void Instrumentation::endStep(uint64_t timestep)
+    {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    for (unsigned int region = 0; region < m_names.size(); ++region)
+        {
+        int64_t total = 0;
+        unsigned int calls = 0;
+        for (auto& entry : m_buffers)
+            {
+            ThreadBuffer& buf = *entry.second;
+            if (region < buf.step_time.size())
+                {
+                total += buf.step_time[region];
+                calls += buf.step_calls[region];
+                buf.step_time[region] = 0;
+                buf.step_calls[region] = 0;
+                }
+            }
+
+        // only steps on which the region executed contribute to its statistics
+        if (calls)
+            {
+            RegionStats& stats = m_stats[region];
+            stats.samples[stats.n_samples % m_window] = total;
+            stats.n_samples++;
+            }
+        }
+
+    m_timestep.store(timestep, std::memory_order_relaxed);
+    }
+
+unsigned int Instrumentation::findRegion(const std::string& name) const
+    {
+    auto it = std::find(m_names.begin(), m_names.end(), name);
+    if (it == m_names.end())
+        throw std::runtime_error("Unknown instrumented region " + name);
+    return (unsigned int)(it - m_names.begin());
+    }
+
+std::vector<int64_t> Instrumentation::getSamples(const std::string& name) const
+    {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const RegionStats& stats = m_stats[findRegion(name)];
+    size_t n = (size_t)std::min<uint64_t>(stats.n_samples, m_window);
+    return std::vector<int64_t>(stats.samples.begin(), stats.samples.begin() + n);
+    }
+
+/*! \param name Name of the region
+    \param q Percentile in [0,100]
+    \returns The q-th percentile (nearest rank) of the step times in the window, or 0 if there are no samples
+*/
+double Instrumentation::getPercentile(const std::string& name, double q) const
+    {
+    if (q < 0.0 || q > 100.0)
+        throw std::runtime_error("Percentile must be in [0,100]");
+
+    std::vector<int64_t> samples = getSamples(name);
+    if (samples.empty())
+        return 0.0;
+
+    size_t k = (size_t)std::ceil(q / 100.0 * double(samples.size()));
+    k = std::min(std::max(k, (size_t)1), samples.size()) - 1;
+    std::nth_element(samples.begin(), samples.begin() + k, samples.end());
+    return double(samples[k]) * 1e-6;
+    }
+
+double Instrumentation::getMean(const std::string& name) const
+    {
+    std::vector<int64_t> samples = getSamples(name);
+    if (samples.empty())
+        return 0.0;
+
+    double sum = 0.0;
+    for (int64_t t : samples)
+        sum += double(t);
+    return sum / double(samples.size()) * 1e-6;
+    }
+
+unsigned int Instrumentation::getNumSamples(const std::string& name) const
+    {
+    return (unsigned int)getSamples(name).size();
+    }
+
+/*! \param filename File to write
+
+    Events are written as complete ("X") events with times in microseconds. Each thread becomes a track,
+    each MPI rank a process.
+*/
+void Instrumentation::writeTrace(const std::string& filename) const
+    {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    std::ofstream f(filename.c_str());
+    if (!f.good())
+        throw std::runtime_error("Error opening trace file " + filename);
+
+    // escape region names for JSON
+    std::vector<std::string> names(m_names.size());
+    for (unsigned int i = 0; i < m_names.size(); ++i)
+        {
+        for (char c : m_names[i])
+            {
+            if (c == '"' || c == '\\')
+                names[i] += '\\';
+            names[i] += c;
+            }
+        }
+
+    f << std::fixed << std::setprecision(3);
+    f << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    for (auto& entry : m_buffers)
+        {
+        const ThreadBuffer& buf = *entry.second;
+        uint64_t n = std::min<uint64_t>(buf.n_events, m_trace_capacity);
+
+        // oldest event first
+        for (uint64_t i = buf.n_events - n; i < buf.n_events; ++i)
+            {
+            const Event& e = buf.events[i % m_trace_capacity];
+            if (!first)
+                f << ",";
+            first = false;
+            f << "\n{\"name\":\"" << names[e.region] << "\",\"ph\":\"X\""
+              << ",\"ts\":" << double(e.start) * 1e-3
+              << ",\"dur\":" << double(e.duration) * 1e-3
+              << ",\"pid\":" << m_pid << ",\"tid\":" << buf.tid
+              << ",\"args\":{\"timestep\":" << e.timestep << "}}";
+            }
+        }
+    f << "\n]}\n";
+    }
+
+void Instrumentation::reset()
+    {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    for (auto& entry : m_buffers)
+        {
+        ThreadBuffer& buf = *entry.second;
+        buf.n_events = 0;
+        std::fill(buf.step_time.begin(), buf.step_time.end(), 0);
+        std::fill(buf.step_calls.begin(), buf.step_calls.end(), 0);
+        }
+
+    for (auto& stats : m_stats)
+        stats.n_samples = 0;
+    }
+
+std::string Instrumentation::demangle(const char *name)
+    {
+    #ifdef __GNUG__
+    int status = 0;
+    char *demangled = abi::__cxa_demangle(name, NULL, NULL, &status);
+    if (status == 0 && demangled)
+        {
+        std::string result(demangled);
+        std::free(demangled);
+        return result;
+        }
+    #endif
+    return std::string(name);
+    }
+
+void export_Instrumentation(py::module& m)
+    {
+    py::class_<Instrumentation, std::shared_ptr<Instrumentation> >(m,"Instrumentation")
+    .def(py::init<unsigned int, unsigned int, unsigned int>())
+    .def("getRegionNames", &Instrumentation::getRegionNames)
+    .def("getPercentile", &Instrumentation::getPercentile)
+    .def("getMean", &Instrumentation::getMean)
+    .def("getNumSamples", &Instrumentation::getNumSamples)
+    .def("writeTrace", &Instrumentation::writeTrace)
+    .def("reset", &Instrumentation::reset)
+    ;
+    }
@@ -0,0 +1,241 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+/*! \file Instrumentation.h
+    \brief Declares the Instrumentation class
+*/
+
+#ifdef __HIPCC__
+#error This header cannot be compiled by nvcc
+#endif
+
+#include <pybind11/pybind11.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <typeinfo>
+#include <vector>
+
+#ifndef __INSTRUMENTATION_H__
+#define __INSTRUMENTATION_H__
+
+//! Low overhead timing of the phases of a time step
+/*! Unlike Profiler, which looks up a string-keyed tree on every push(), Instrumentation refers to regions by
+    integer ids that are registered once by name before the run. Timing a region takes two clock reads and a
+    write into a buffer owned by the calling thread. Each thread acquires its buffer under a lock on first use,
+    after that recording is lock free.
+
+    Every buffer keeps the most recent trace events in a fixed-size ring, which writeTrace() exports in the
+    Chrome trace event format (readable by Perfetto and chrome://tracing). At the end of every time step,
+    endStep() adds up the time spent in each region and appends it to a window of recent step times per region,
+    from which getPercentile() computes running percentiles. Regions that did not execute during a step do not
+    add a sample.
+
+    Instrumentation does not synchronize with the GPU. On the GPU, the recorded times are those seen by the
+    host, which includes waiting on kernels only where the code already synchronizes.
+
+    \ingroup utils
+*/
+class PYBIND11_EXPORT Instrumentation
+    {
+    public:
+        //! A single timed region in the trace
+        struct Event
+            {
+            int64_t start;          //!< Start time (ns)
+            int64_t duration;       //!< Duration (ns)
+            uint64_t timestep;      //!< Time step during which the region executed
+            unsigned int region;    //!< Region id
+            };
+
+        //! Times a region for the lifetime of the object
+        /*! Does nothing when constructed with a null Instrumentation.
+         */
+        class ScopedRegion
+            {
+            public:
+                //! Start timing
+                ScopedRegion(Instrumentation *instrumentation, unsigned int region)
+                    : m_instrumentation(instrumentation), m_region(region),
+                      m_start(instrumentation ? instrumentation->now() : 0)
+                    {
+                    }
+
+                //! Stop timing and record the region
+                ~ScopedRegion()
+                    {
+                    if (m_instrumentation)
+                        m_instrumentation->record(m_region, m_start, m_instrumentation->now());
+                    }
+
+                ScopedRegion(const ScopedRegion&) = delete;
+                ScopedRegion& operator=(const ScopedRegion&) = delete;
+
+            private:
+                Instrumentation *m_instrumentation; //!< Instrumentation to record into
+                unsigned int m_region;              //!< Region being timed
+                int64_t m_start;                    //!< Start time (ns)
+            };
+
+        //! Constructor
+        /*! \param pid Process id written to the trace (the MPI rank)
+            \param trace_capacity Number of trace events kept per thread
+            \param window Number of steps kept per region for percentiles
+         */
+        Instrumentation(unsigned int pid=0, unsigned int trace_capacity=65536, unsigned int window=1000);
+
+        //! Register a region, or return the id of an existing region with the same name
+        unsigned int registerRegion(const std::string& name);
+
+        //! Register a region named after the dynamic type of an object
+        /*! \param prefix Category of the region
+            \param obj Object to name the region after
+
+            The n-th object of the same type in a category (n > 0) gets a suffix #n, as counted by
+            \a counts which the caller resets for every registration pass.
+         */
+        template<class T>
+        unsigned int registerRegion(const std::string& prefix, const T& obj, std::map<std::string, unsigned int>& counts)
+            {
+            std::string name = prefix + ":" + demangle(typeid(obj).name());
+            unsigned int n = counts[name]++;
+            if (n > 0)
+                name += "#" + std::to_string(n);
+            return registerRegion(name);
+            }
+
+        //! Get the number of registered regions
+        unsigned int getNumRegions() const;
+
+        //! Get the names of all registered regions, by id
+        std::vector<std::string> getRegionNames() const;
+
+        //! Get the current time
+        int64_t now() const
+            {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - m_t0).count();
+            }
+
+        //! Record a region that executed from \a start to \a end
+        void record(unsigned int region, int64_t start, int64_t end)
+            {
+            ThreadBuffer& buf = getThreadBuffer();
+            if (region >= buf.step_time.size())
+                {
+                buf.step_time.resize(region+1, 0);
+                buf.step_calls.resize(region+1, 0);
+                }
+            buf.step_time[region] += end - start;
+            buf.step_calls[region]++;
+
+            if (m_trace_capacity)
+                {
+                Event& e = buf.events[buf.n_events % m_trace_capacity];
+                e.start = start;
+                e.duration = end - start;
+                e.timestep = m_timestep.load(std::memory_order_relaxed);
+                e.region = region;
+                buf.n_events++;
+                }
+            }
+
+        //! Set the time step written to subsequent trace events
+        void setTimestep(uint64_t timestep)
+            {
+            m_timestep.store(timestep, std::memory_order_relaxed);
+            }
+
+        //! Finish a time step and add the per-region step times to the percentile windows
+        void endStep(uint64_t timestep);
+
+        //! Get a percentile of the per-step time spent in a region, in milliseconds
+        double getPercentile(const std::string& name, double q) const;
+
+        //! Get the mean per-step time spent in a region over the window, in milliseconds
+        double getMean(const std::string& name) const;
+
+        //! Get the number of steps in the window of a region
+        unsigned int getNumSamples(const std::string& name) const;
+
+        //! Write the trace events of all threads in the Chrome trace event format
+        void writeTrace(const std::string& filename) const;
+
+        //! Discard all trace events and step samples
+        void reset();
+
+        //! Demangle a type name
+        static std::string demangle(const char *name);
+
+    private:
+        //! Per-thread event storage
+        struct ThreadBuffer
+            {
+            std::vector<Event> events;          //!< Ring buffer of trace events
+            uint64_t n_events = 0;              //!< Number of events recorded so far
+            std::vector<int64_t> step_time;     //!< Time per region in the current step (ns)
+            std::vector<unsigned int> step_calls; //!< Number of calls per region in the current step
+            unsigned int tid = 0;               //!< Thread index written to the trace
+            };
+
+        //! Per-region window of step times
+        struct RegionStats
+            {
+            std::vector<int64_t> samples;       //!< Ring buffer of step times (ns)
+            uint64_t n_samples = 0;             //!< Number of steps recorded so far
+            };
+
+        //! Cache of the buffer of the calling thread
+        struct ThreadCache
+            {
+            uint64_t owner = 0;                 //!< Id of the Instrumentation that owns buf
+            ThreadBuffer *buf = nullptr;        //!< Buffer of this thread
+            };
+
+        //! Get the buffer of the calling thread
+        ThreadBuffer& getThreadBuffer()
+            {
+            thread_local ThreadCache cache;
+            if (cache.owner != m_id)
+                acquireThreadBuffer(cache);
+            return *cache.buf;
+            }
+
+        //! Look up or create the buffer of the calling thread (slow path)
+        void acquireThreadBuffer(ThreadCache& cache);
+
+        //! Find a region by name, throw if not found
+        unsigned int findRegion(const std::string& name) const;
+
+        //! Copy the valid samples of a region
+        std::vector<int64_t> getSamples(const std::string& name) const;
+
+        const uint64_t m_id;                    //!< Unique id of this instance
+        const unsigned int m_pid;               //!< Process id in the trace
+        const unsigned int m_trace_capacity;    //!< Events kept per thread
+        const unsigned int m_window;            //!< Step samples kept per region
+        const std::chrono::steady_clock::time_point m_t0;   //!< Reference time
+
+        std::atomic<uint64_t> m_timestep;       //!< Current time step
+
+        mutable std::mutex m_mutex;             //!< Protects registration, buffer creation and readout
+        std::vector<std::string> m_names;       //!< Region names by id
+        std::vector<RegionStats> m_stats;       //!< Step time windows by region id
+        std::map<std::thread::id, std::unique_ptr<ThreadBuffer> > m_buffers;    //!< Per-thread buffers
+
+        static std::atomic<uint64_t> s_next_id; //!< Next instance id
+    };
+
+//! Exports the Instrumentation class to python
+#ifndef __HIPCC__
+void export_Instrumentation(pybind11::module& m);
+#endif
+
+#endif
@@ -308,8 +308,12 @@ Scalar Integrator::computeTotalMomentum(unsigned int timestep)
 void Integrator::computeNetForce(unsigned int timestep)
     {
     std::vector< std::shared_ptr<ForceCompute> >::iterator force_compute;
-    for (force_compute = m_forces.begin(); force_compute != m_forces.end(); ++force_compute)
-        (*force_compute)->compute(timestep);
+    Instrumentation *instrumentation = getInstrumentation(m_force_regions, m_forces.size());
+    for (unsigned int i = 0; i < m_forces.size(); ++i)
+        {
+        Instrumentation::ScopedRegion region(instrumentation, instrumentation ? m_force_regions[i] : 0);
+        m_forces[i]->compute(timestep);
+        }
 
     if (m_prof)
         {
@@ -413,8 +417,13 @@ void Integrator::computeNetForce(unsigned int timestep)
     // compute all the constraint forces next
     // constraint forces only apply a force, not a torque
     std::vector< std::shared_ptr<ForceConstraint> >::iterator force_constraint;
-    for (force_constraint = m_constraint_forces.begin(); force_constraint != m_constraint_forces.end(); ++force_constraint)
-        (*force_constraint)->compute(timestep);
+    Instrumentation *constraint_instrumentation = getInstrumentation(m_constraint_regions, m_constraint_forces.size());
+    for (unsigned int i = 0; i < m_constraint_forces.size(); ++i)
+        {
+        Instrumentation::ScopedRegion region(constraint_instrumentation,
+            constraint_instrumentation ? m_constraint_regions[i] : 0);
+        m_constraint_forces[i]->compute(timestep);
+        }
 
     if (m_prof)
         {
@@ -499,10 +508,12 @@ void Integrator::computeNetForceGPU(unsigned int timestep)
 
     // compute all the normal forces first
 
-    std::vector< std::shared_ptr<ForceCompute> >::iterator force_compute;
-
-    for (force_compute = m_forces.begin(); force_compute != m_forces.end(); ++force_compute)
-        (*force_compute)->compute(timestep);
+    Instrumentation *instrumentation = getInstrumentation(m_force_regions, m_forces.size());
+    for (unsigned int i = 0; i < m_forces.size(); ++i)
+        {
+        Instrumentation::ScopedRegion region(instrumentation, instrumentation ? m_force_regions[i] : 0);
+        m_forces[i]->compute(timestep);
+        }
 
     if (m_prof)
         {
@@ -691,9 +702,13 @@ void Integrator::computeNetForceGPU(unsigned int timestep)
     #endif
 
     // compute all the constraint forces next
-    std::vector< std::shared_ptr<ForceConstraint> >::iterator force_constraint;
-    for (force_constraint = m_constraint_forces.begin(); force_constraint != m_constraint_forces.end(); ++force_constraint)
-        (*force_constraint)->compute(timestep);
+    Instrumentation *constraint_instrumentation = getInstrumentation(m_constraint_regions, m_constraint_forces.size());
+    for (unsigned int i = 0; i < m_constraint_forces.size(); ++i)
+        {
+        Instrumentation::ScopedRegion region(constraint_instrumentation,
+            constraint_instrumentation ? m_constraint_regions[i] : 0);
+        m_constraint_forces[i]->compute(timestep);
+        }
 
     if (m_prof)
         {
@@ -866,6 +881,24 @@ void Integrator::prepRun(unsigned int timestep)
     {
     }
 
+/** Registers one region per force and constraint compute. Call again after changing the list of forces.
+*/
+void Integrator::setInstrumentation(std::shared_ptr<Instrumentation> instrumentation)
+    {
+    m_instrumentation = instrumentation;
+    m_force_regions.clear();
+    m_constraint_regions.clear();
+
+    if (!m_instrumentation)
+        return;
+
+    std::map<std::string, unsigned int> counts;
+    for (auto& force : m_forces)
+        m_force_regions.push_back(m_instrumentation->registerRegion("force", *force, counts));
+    for (auto& constraint : m_constraint_forces)
+        m_constraint_regions.push_back(m_instrumentation->registerRegion("constraint", *constraint, counts));
+    }
+
 #ifdef ENABLE_MPI
 /** @param tstep Time step for which to determine the flags
 
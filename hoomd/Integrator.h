@@ -12,6 +12,7 @@
 #include "ForceConstraint.h"
 #include "HalfStepHook.h"
 #include "ParticleGroup.h"
+#include "Instrumentation.h"
 #include <string>
 #include <vector>
 #include <pybind11/pybind11.h>
@@ -67,6 +68,20 @@ class PYBIND11_EXPORT Integrator : public Updater
         /// Take one timestep forward
         virtual void update(unsigned int timestep);
 
+        /// Allow update() to leave the end of the step to the next call to update()
+        /** @param defer True when nothing accesses the particle data before the next call to update()
+
+            System sets this before every call to update(). The base class ignores it.
+        */
+        virtual void setDeferStepEnd(bool defer)
+            {
+            }
+
+        /// Complete a step left unfinished by the last call to update()
+        virtual void finishStep()
+            {
+            }
+
         /// Add a ForceCompute to the list
         virtual void addForceCompute(std::shared_ptr<ForceCompute> fc);
 
@@ -143,6 +158,11 @@ class PYBIND11_EXPORT Integrator : public Updater
         /// Prepare for the run
         virtual void prepRun(unsigned int timestep);
 
+        /// Set the instrumentation used to time the force and constraint computes
+        /** @param instrumentation Instrumentation to record into, null to disable
+        */
+        virtual void setInstrumentation(std::shared_ptr<Instrumentation> instrumentation);
+
         #ifdef ENABLE_MPI
         /// Set the communicator to use
         /** @param comm The Communicator
@@ -166,6 +186,21 @@ class PYBIND11_EXPORT Integrator : public Updater
         /// The HalfStepHook, if active
         std::shared_ptr<HalfStepHook> m_half_step_hook;
 
+        /// Per-region timing, null when disabled
+        std::shared_ptr<Instrumentation> m_instrumentation;
+
+        /// Instrumented region of each force compute
+        std::vector<unsigned int> m_force_regions;
+
+        /// Instrumented region of each constraint force
+        std::vector<unsigned int> m_constraint_regions;
+
+        /// Get the instrumentation if @a regions has been registered for all @a n computes
+        Instrumentation *getInstrumentation(const std::vector<unsigned int>& regions, size_t n) const
+            {
+            return (m_instrumentation && regions.size() == n) ? m_instrumentation.get() : nullptr;
+            }
+
         /// helper function to compute initial accelerations
         void computeAccelerations(unsigned int timestep);
 
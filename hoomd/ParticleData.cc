@@ -272,6 +272,47 @@ void ParticleData::notifyParticleSort()
     m_sort_signal.emit();
     }
 
+/*! \param n_prev Number of local particles before the rearrangement
+    \param new_idx New index of every particle that was local before, NOT_LOCAL if it has been removed. The vector is
+           swapped with an internal buffer, its contents are undefined on return.
+
+    Listeners may read the permutation with getParticleReorder() while they are notified, see ParticleReorder.
+*/
+void ParticleData::notifyParticleSort(unsigned int n_prev, std::vector<unsigned int>& new_idx)
+    {
+    m_reorder.new_idx.swap(new_idx);
+    notifyParticleReorder(n_prev);
+    }
+
+/*! \param n_prev Number of local particles before the rearrangement
+
+    \pre m_reorder.new_idx holds the new index of every particle
+*/
+void ParticleData::notifyParticleReorder(unsigned int n_prev)
+    {
+    m_reorder.known = true;
+    m_reorder.n_prev = n_prev;
+    notifyParticleSort();
+    m_reorder.known = false;
+    }
+
+const GlobalArray< unsigned int >& ParticleData::getIdentityIndices() const
+    {
+    // the array only grows, its elements never change
+    if (m_identity_idx.getNumElements() < getN())
+        {
+        GlobalArray<unsigned int> identity_idx(getMaxN(), m_exec_conf);
+        m_identity_idx.swap(identity_idx);
+        TAG_ALLOCATION(m_identity_idx);
+
+        ArrayHandle<unsigned int> h_identity_idx(m_identity_idx, access_location::host, access_mode::overwrite);
+        for (unsigned int idx = 0; idx < m_identity_idx.getNumElements(); ++idx)
+            h_identity_idx.data[idx] = idx;
+        }
+
+    return m_identity_idx;
+    }
+
 /*! This function is called any time the ghost particles are removed
  *
  * The rationale is that a subscriber (i.e. the Communicator) can perform clean-up for ghost particles
@@ -754,35 +795,13 @@ void ParticleData::reallocate(unsigned int max_n)
     m_max_particle_num_signal.emit();
     }
 
-/*! Rebuild the cached vector of active tags, if necessary
-*/
-void ParticleData::maybe_rebuild_tag_cache()
-    {
-    if(!m_invalid_cached_tags)
-        return;
-
-    // GlobalVector checks if the resize is necessary
-    m_cached_tag_set.resize(m_tag_set.size());
-
-    // iterate over each element in the set, building a mapping
-    // from dense array indices to sparse particle tag indices
-    unsigned int i(0);
-    for(std::set<unsigned int>::const_iterator it(m_tag_set.begin());
-        it != m_tag_set.end(); ++it, ++i)
-        {
-        m_cached_tag_set[i] = *it;
-        }
-
-    m_invalid_cached_tags = false;
-    }
-
 /*! \return true If and only if all particles are in the simulation box
 */
 template <class Real>
-bool ParticleData::inBox(const SnapshotParticleData<Real> &snap)
+bool ParticleData::inBox(const SnapshotParticleData<Real> &snap, bool distributed)
     {
     bool in_box = true;
-    if (m_exec_conf->getRank() == 0)
+    if (distributed || m_exec_conf->getRank() == 0)
         {
         Scalar3 lo = m_global_box.getLo();
         Scalar3 hi = m_global_box.getHi();
@@ -808,7 +827,16 @@ bool ParticleData::inBox(const SnapshotParticleData<Real> &snap)
     #ifdef ENABLE_MPI
     if (m_decomposition)
         {
-        bcast(in_box, 0, m_exec_conf->getMPICommunicator());
+        if (distributed)
+            {
+            int all_in_box = in_box;
+            MPI_Allreduce(MPI_IN_PLACE, &all_in_box, 1, MPI_INT, MPI_LAND, m_exec_conf->getMPICommunicator());
+            in_box = all_in_box;
+            }
+        else
+            {
+            bcast(in_box, 0, m_exec_conf->getMPICommunicator());
+            }
         }
     #endif
     return in_box;
@@ -902,11 +930,6 @@ void ParticleData::initializeFromSnapshot(const SnapshotParticleData<Real>& snap
                 throw std::runtime_error("Error initializing ParticleData");
                 }
 
-            const Index3D& di = m_decomposition->getDomainIndexer();
-            unsigned int n_ranks = m_exec_conf->getNRanks();
-
-            BoxDim global_box = m_global_box;
-
             // loop over particles in snapshot, place them into domains
             for (typename std::vector< vec3<Real> >::const_iterator it=snapshot.pos.begin(); it != snapshot.pos.end(); it++)
                 {
@@ -920,57 +943,8 @@ void ParticleData::initializeFromSnapshot(const SnapshotParticleData<Real>& snap
 
                 // determine domain the particle is placed into
                 Scalar3 pos = vec_to_scalar3(*it);
-                Scalar3 f = m_global_box.makeFraction(pos);
-                int i= int(f.x * ((Scalar)di.getW()));
-                int j= int(f.y * ((Scalar)di.getH()));
-                int k= int(f.z * ((Scalar)di.getD()));
-
-                // wrap particles that are exactly on a boundary
-                // we only need to wrap in the negative direction, since
-                // processor ids are rounded toward zero
-                char3 flags = make_char3(0,0,0);
-                if (i == (int) di.getW())
-                    {
-                    i = 0;
-                    flags.x = 1;
-                    }
-
-                if (j == (int) di.getH())
-                    {
-                    j = 0;
-                    flags.y = 1;
-                    }
-
-                if (k == (int) di.getD())
-                    {
-                    k = 0;
-                    flags.z = 1;
-                    }
-
                 int3 img = snapshot.image[snap_idx];
-
-                // only wrap if the particles is on one of the boundaries
-                uchar3 periodic = make_uchar3(flags.x,flags.y,flags.z);
-                global_box.setPeriodic(periodic);
-                global_box.wrap(pos, img, flags);
-
-                // place particle using actual domain fractions, not global box fraction
-                unsigned int rank = m_decomposition->placeParticle(m_global_box, pos, h_cart_ranks.data);
-
-                if (rank >= n_ranks)
-                    {
-                    m_exec_conf->msg->error() << "init.*: Particle " << snap_idx << " out of bounds." << std::endl;
-                    m_exec_conf->msg->error() << "Cartesian coordinates: " << std::endl;
-                    m_exec_conf->msg->error() << "x: " << pos.x << " y: " << pos.y << " z: " << pos.z << std::endl;
-                    m_exec_conf->msg->error() << "Fractional coordinates: " << std::endl;
-                    m_exec_conf->msg->error() << "f.x: " << f.x << " f.y: " << f.y << " f.z: " << f.z << std::endl;
-                    Scalar3 lo = m_global_box.getLo();
-                    Scalar3 hi = m_global_box.getHi();
-                    m_exec_conf->msg->error() << "Global box lo: (" << lo.x << ", " << lo.y << ", " << lo.z << ")" << std::endl;
-                    m_exec_conf->msg->error() << "           hi: (" << hi.x << ", " << hi.y << ", " << hi.z << ")" << std::endl;
-
-                    throw std::runtime_error("Error initializing from snapshot.");
-                    }
+                unsigned int rank = placeSnapshotParticle(pos, img, snap_idx, h_cart_ranks.data);
 
                 // fill up per-processor data structures
                 pos_proc[rank].push_back(pos);
@@ -1005,9 +979,6 @@ void ParticleData::initializeFromSnapshot(const SnapshotParticleData<Real>& snap
         // broadcast global number of particles
         bcast(nglobal, root, mpi_comm);
 
-        // resize array for reverse-lookup tags
-        m_rtag.resize(nglobal);
-
         // Local particle data
         std::vector<Scalar3> pos;
         std::vector<Scalar3> vel;
@@ -1042,24 +1013,11 @@ void ParticleData::initializeFromSnapshot(const SnapshotParticleData<Real>& snap
         scatter_v(N_proc, m_nparticles, root, mpi_comm);
 
 
-            {
-            // reset all reverse lookup tags to NOT_LOCAL flag
-            ArrayHandle<unsigned int> h_rtag(getRTags(), access_location::host, access_mode::overwrite);
-
-            // we have to reset all previous rtags, to remove 'leftover' ghosts
-            unsigned int max_tag = (unsigned int)m_rtag.size();
-            for (unsigned int tag = 0; tag < max_tag; tag++)
-                h_rtag.data[tag] = NOT_LOCAL;
-            }
+        // reset all reverse lookup tags to NOT_LOCAL flag, to remove 'leftover' ghosts
+        resetRTags(nglobal, m_nparticles);
 
         // update list of active tags
-        for (unsigned int tag = 0; tag < nglobal; tag++)
-            {
-            m_tag_set.insert(tag);
-            }
-
-        // Now that active tag list has changed, invalidate the cache
-        m_invalid_cached_tags = true;
+        m_tag_set.assignRange(nglobal);
 
         // resize particle data
         resize(m_nparticles);
@@ -1077,7 +1035,7 @@ void ParticleData::initializeFromSnapshot(const SnapshotParticleData<Real>& snap
         ArrayHandle< Scalar3 > h_inertia(m_inertia, access_location::host, access_mode::overwrite);
         ArrayHandle< unsigned int > h_tag(m_tag, access_location::host, access_mode::overwrite);
         ArrayHandle< unsigned int > h_comm_flag(m_comm_flags, access_location::host, access_mode::overwrite);
-        ArrayHandle< unsigned int > h_rtag(m_rtag, access_location::host, access_mode::readwrite);
+        TagIndexHandle h_rtag(*this, access_mode::readwrite);
 
         for (unsigned int idx = 0; idx < m_nparticles; idx++)
             {
@@ -1088,7 +1046,7 @@ void ParticleData::initializeFromSnapshot(const SnapshotParticleData<Real>& snap
             h_diameter.data[idx] = diameter[idx];
             h_image.data[idx] = image[idx];
             h_tag.data[idx] = tag[idx];
-            h_rtag.data[tag[idx]] = idx;
+            h_rtag.set(tag[idx], idx);
             h_body.data[idx] = body[idx];
             h_orientation.data[idx] = orientation[idx];
             h_angmom.data[idx] = angmom[idx];
@@ -1108,10 +1066,7 @@ void ParticleData::initializeFromSnapshot(const SnapshotParticleData<Real>& snap
             }
 
         // allocate array for reverse lookup tags
-        m_rtag.resize(snapshot.size);
-
-        // Now that active tag list has changed, invalidate the cache
-        m_invalid_cached_tags = true;
+        resetRTags(snapshot.size, snapshot.size);
 
         // allocate particle data such that we can accommodate the particles
         resize(snapshot.size);
@@ -1127,7 +1082,7 @@ void ParticleData::initializeFromSnapshot(const SnapshotParticleData<Real>& snap
         ArrayHandle< Scalar4 > h_angmom(m_angmom, access_location::host, access_mode::overwrite);
         ArrayHandle< Scalar3 > h_inertia(m_inertia, access_location::host, access_mode::overwrite);
         ArrayHandle< unsigned int > h_tag(m_tag, access_location::host, access_mode::overwrite);
-        ArrayHandle< unsigned int > h_rtag(m_rtag, access_location::host, access_mode::readwrite);
+        TagIndexHandle h_rtag(*this, access_mode::readwrite);
 
         for (unsigned int snap_idx = 0; snap_idx < snapshot.size; snap_idx++)
             {
@@ -1150,7 +1105,7 @@ void ParticleData::initializeFromSnapshot(const SnapshotParticleData<Real>& snap
             h_diameter.data[nglobal] = snapshot.diameter[snap_idx];
             h_image.data[nglobal] = snapshot.image[snap_idx];
             h_tag.data[nglobal] = nglobal;
-            h_rtag.data[nglobal] = nglobal;
+            h_rtag.set(nglobal, nglobal);
             h_body.data[nglobal] = snapshot.body[snap_idx];
             h_orientation.data[nglobal] = quat_to_scalar4(snapshot.orientation[snap_idx]);
             h_angmom.data[nglobal] = quat_to_scalar4(snapshot.angmom[snap_idx]);
@@ -1161,13 +1116,11 @@ void ParticleData::initializeFromSnapshot(const SnapshotParticleData<Real>& snap
         m_nparticles = nglobal;
 
         // update list of active tags
-        for (unsigned int tag = 0; tag < nglobal; tag++)
-            {
-            m_tag_set.insert(tag);
-            }
+        m_tag_set.assignRange(nglobal);
 
         // rtag size reflects actual number of tags
-        m_rtag.resize(nglobal);
+        if (!m_rtag_map)
+            m_rtag.resize(nglobal);
 
         // initialize type mapping
         m_type_mapping = snapshot.type_mapping;
@@ -1190,6 +1143,275 @@ void ParticleData::initializeFromSnapshot(const SnapshotParticleData<Real>& snap
     m_num_types_signal.emit();
     }
 
+#ifdef ENABLE_MPI
+/*! \param pos Position of the particle, wrapped into the box when it is exactly on an upper boundary
+    \param img Image of the particle, updated when the position is wrapped
+    \param idx Index of the particle (for error messages)
+    \param cart_ranks Map from cartesian domain index to rank
+
+    \returns the rank of the domain the particle is placed into
+*/
+unsigned int ParticleData::placeSnapshotParticle(Scalar3& pos, int3& img, unsigned int idx,
+                                                 const unsigned int *cart_ranks)
+    {
+    const Index3D& di = m_decomposition->getDomainIndexer();
+    unsigned int n_ranks = m_exec_conf->getNRanks();
+
+    BoxDim global_box = m_global_box;
+
+    Scalar3 f = m_global_box.makeFraction(pos);
+    int i= int(f.x * ((Scalar)di.getW()));
+    int j= int(f.y * ((Scalar)di.getH()));
+    int k= int(f.z * ((Scalar)di.getD()));
+
+    // wrap particles that are exactly on a boundary
+    // we only need to wrap in the negative direction, since
+    // processor ids are rounded toward zero
+    char3 flags = make_char3(0,0,0);
+    if (i == (int) di.getW())
+        {
+        i = 0;
+        flags.x = 1;
+        }
+
+    if (j == (int) di.getH())
+        {
+        j = 0;
+        flags.y = 1;
+        }
+
+    if (k == (int) di.getD())
+        {
+        k = 0;
+        flags.z = 1;
+        }
+
+    // only wrap if the particles is on one of the boundaries
+    uchar3 periodic = make_uchar3(flags.x,flags.y,flags.z);
+    global_box.setPeriodic(periodic);
+    global_box.wrap(pos, img, flags);
+
+    // place particle using actual domain fractions, not global box fraction
+    unsigned int rank = m_decomposition->placeParticle(m_global_box, pos, cart_ranks);
+
+    if (rank >= n_ranks)
+        {
+        m_exec_conf->msg->errorAllRanks() << "init.*: Particle " << idx << " out of bounds." << std::endl;
+        m_exec_conf->msg->errorAllRanks() << "Cartesian coordinates: " << std::endl;
+        m_exec_conf->msg->errorAllRanks() << "x: " << pos.x << " y: " << pos.y << " z: " << pos.z << std::endl;
+        m_exec_conf->msg->errorAllRanks() << "Fractional coordinates: " << std::endl;
+        m_exec_conf->msg->errorAllRanks() << "f.x: " << f.x << " f.y: " << f.y << " f.z: " << f.z << std::endl;
+        Scalar3 lo = m_global_box.getLo();
+        Scalar3 hi = m_global_box.getHi();
+        m_exec_conf->msg->errorAllRanks() << "Global box lo: (" << lo.x << ", " << lo.y << ", " << lo.z << ")" << std::endl;
+        m_exec_conf->msg->errorAllRanks() << "           hi: (" << hi.x << ", " << hi.y << ", " << hi.z << ")" << std::endl;
+
+        throw std::runtime_error("Error initializing from snapshot.");
+        }
+
+    return rank;
+    }
+
+//! Initialize from a snapshot that is distributed over the ranks
+/*! \param snapshot The part of the initial particle data held by this rank
+    \param owner Filled with the rank that owns each particle of \a snapshot after initialization
+
+    Every rank holds a contiguous slice of the particles, in rank order: the particle with index i in the snapshot
+    on rank r gets the tag i plus the total number of particles on ranks 0 to r-1. Each rank places the particles of
+    its slice into domains and all ranks exchange the particles with a single all-to-all communication. No rank
+    holds the full particle data at any time.
+
+    \a owner serves as the directory that BondedGroupData::initializeFromDistributedSnapshot() uses to route the
+    bonded groups to the ranks that own their members.
+
+    \pre The type mapping and the global box are the same on all ranks.
+ */
+template <class Real>
+void ParticleData::initializeFromDistributedSnapshot(const SnapshotParticleData<Real>& snapshot,
+                                                     std::vector<unsigned int>& owner)
+    {
+    m_exec_conf->msg->notice(4) << "ParticleData: initializing from distributed snapshot" << std::endl;
+
+    if (!m_decomposition)
+        {
+        m_exec_conf->msg->error() << "init.*: distributed snapshots require a domain decomposition." << endl;
+        throw std::runtime_error("Error initializing particle data.");
+        }
+
+    const MPI_Comm mpi_comm = m_exec_conf->getMPICommunicator();
+    unsigned int n_ranks = m_exec_conf->getNRanks();
+
+    // check the input for errors, the ranks agree on the result before any collective call
+    unsigned char error = 0;
+    if (! snapshot.validate())
+        {
+        m_exec_conf->msg->errorAllRanks() << "init.*: invalid particle data snapshot."
+                                          << std::endl << std::endl;
+        error = 1;
+        }
+    else if (snapshot.type_mapping.size() == 0)
+        {
+        m_exec_conf->msg->errorAllRanks() << "Number of particle types must be greater than 0." << endl;
+        error = 1;
+        }
+    MPI_Allreduce(MPI_IN_PLACE, &error, 1, MPI_UNSIGNED_CHAR, MPI_LOR, mpi_comm);
+    if (error)
+        throw std::runtime_error("Error initializing particle data.");
+
+    // it is an error for particles to be initialized outside of their box
+    if (!inBox(snapshot, true))
+        {
+        m_exec_conf->msg->warning() << "Not all particles were found inside the given box" << endl;
+        throw runtime_error("Error initializing ParticleData");
+        }
+
+    // remove all ghost particles
+    removeAllGhostParticles();
+
+    // clear set of active tags
+    m_tag_set.clear();
+
+    // clear reservoir of recycled tags
+    while (! m_recycled_tags.empty())
+        m_recycled_tags.pop();
+
+    // the tag of the first particle in this slice and the global number of particles
+    unsigned int n_slice = snapshot.size;
+    unsigned int tag_offset = 0;
+    MPI_Exscan(&n_slice, &tag_offset, 1, MPI_UNSIGNED, MPI_SUM, mpi_comm);
+    if (m_exec_conf->getRank() == 0)
+        tag_offset = 0;
+
+    unsigned int nglobal = 0;
+    MPI_Allreduce(&n_slice, &nglobal, 1, MPI_UNSIGNED, MPI_SUM, mpi_comm);
+
+    // place the particles of the slice into domains
+    std::vector< std::vector<pdata_element> > send(n_ranks);
+    owner.resize(n_slice);
+        {
+        ArrayHandle<unsigned int> h_cart_ranks(m_decomposition->getCartRanks(), access_location::host, access_mode::read);
+
+        for (unsigned int snap_idx = 0; snap_idx < n_slice; snap_idx++)
+            {
+            unsigned int tag = tag_offset + snap_idx;
+            Scalar3 pos = vec_to_scalar3(snapshot.pos[snap_idx]);
+            int3 img = snapshot.image[snap_idx];
+            unsigned int rank;
+            try
+                {
+                rank = placeSnapshotParticle(pos, img, tag, h_cart_ranks.data);
+                }
+            catch (const std::runtime_error&)
+                {
+                // the error is raised on all ranks after the loop
+                error = 1;
+                break;
+                }
+            owner[snap_idx] = rank;
+
+            pdata_element p;
+            memset(&p, 0, sizeof(pdata_element));
+            p.pos = make_scalar4(pos.x, pos.y, pos.z, __int_as_scalar(snapshot.type[snap_idx]));
+            p.vel = make_scalar4(snapshot.vel[snap_idx].x,
+                                 snapshot.vel[snap_idx].y,
+                                 snapshot.vel[snap_idx].z,
+                                 snapshot.mass[snap_idx]);
+            p.accel = vec_to_scalar3(snapshot.accel[snap_idx]);
+            p.charge = snapshot.charge[snap_idx];
+            p.diameter = snapshot.diameter[snap_idx];
+            p.image = img;
+            p.body = snapshot.body[snap_idx];
+            p.orientation = quat_to_scalar4(snapshot.orientation[snap_idx]);
+            p.angmom = quat_to_scalar4(snapshot.angmom[snap_idx]);
+            p.inertia = vec_to_scalar3(snapshot.inertia[snap_idx]);
+            p.tag = tag;
+            send[rank].push_back(p);
+            }
+        }
+
+    MPI_Allreduce(MPI_IN_PLACE, &error, 1, MPI_UNSIGNED_CHAR, MPI_LOR, mpi_comm);
+    if (error)
+        throw std::runtime_error("Error initializing from snapshot.");
+
+    // exchange particles, they arrive ordered by tag
+    std::vector< std::vector<pdata_element> > recv;
+    all_to_all_v(send, recv, mpi_comm);
+    send.clear();
+
+    m_nparticles = 0;
+    for (unsigned int rank = 0; rank < n_ranks; rank++)
+        m_nparticles += (unsigned int)recv[rank].size();
+
+    // reset all reverse lookup tags to NOT_LOCAL flag
+    resetRTags(nglobal, m_nparticles);
+
+    // update list of active tags
+    m_tag_set.assignRange(nglobal);
+
+    // resize particle data
+    resize(m_nparticles);
+
+        {
+        // Load particle data
+        ArrayHandle< Scalar4 > h_pos(m_pos, access_location::host, access_mode::overwrite);
+        ArrayHandle< Scalar4 > h_vel(m_vel, access_location::host, access_mode::overwrite);
+        ArrayHandle< Scalar3 > h_accel(m_accel, access_location::host, access_mode::overwrite);
+        ArrayHandle< int3 > h_image(m_image, access_location::host, access_mode::overwrite);
+        ArrayHandle< Scalar > h_charge(m_charge, access_location::host, access_mode::overwrite);
+        ArrayHandle< Scalar > h_diameter(m_diameter, access_location::host, access_mode::overwrite);
+        ArrayHandle< unsigned int > h_body(m_body, access_location::host, access_mode::overwrite);
+        ArrayHandle< Scalar4 > h_orientation(m_orientation, access_location::host, access_mode::overwrite);
+        ArrayHandle< Scalar4 > h_angmom(m_angmom, access_location::host, access_mode::overwrite);
+        ArrayHandle< Scalar3 > h_inertia(m_inertia, access_location::host, access_mode::overwrite);
+        ArrayHandle< unsigned int > h_tag(m_tag, access_location::host, access_mode::overwrite);
+        ArrayHandle< unsigned int > h_comm_flag(m_comm_flags, access_location::host, access_mode::overwrite);
+        TagIndexHandle h_rtag(*this, access_mode::readwrite);
+
+        unsigned int idx = 0;
+        for (unsigned int rank = 0; rank < n_ranks; rank++)
+            {
+            for (const pdata_element& p : recv[rank])
+                {
+                h_pos.data[idx] = p.pos;
+                h_vel.data[idx] = p.vel;
+                h_accel.data[idx] = p.accel;
+                h_charge.data[idx] = p.charge;
+                h_diameter.data[idx] = p.diameter;
+                h_image.data[idx] = p.image;
+                h_tag.data[idx] = p.tag;
+                h_rtag.set(p.tag, idx);
+                h_body.data[idx] = p.body;
+                h_orientation.data[idx] = p.orientation;
+                h_angmom.data[idx] = p.angmom;
+                h_inertia.data[idx] = p.inertia;
+
+                h_comm_flag.data[idx] = 0; // initialize with zero
+                idx++;
+                }
+            }
+        }
+
+    // initialize type mapping
+    m_type_mapping = snapshot.type_mapping;
+
+    // copy over accel_set flag from snapshot
+    m_accel_set = snapshot.is_accel_set;
+
+    // set global number of particles
+    setNGlobal(nglobal);
+
+    // notify listeners about resorting of local particles
+    notifyParticleSort();
+
+    // zero the origin
+    m_origin = make_scalar3(0,0,0);
+    m_o_image = make_int3(0,0,0);
+
+    // notify listeners that number of types has changed
+    m_num_types_signal.emit();
+    }
+#endif
+
 //! take a particle data snapshot
 /* \param snapshot The snapshot to write to
    \returns a map to lookup the snapshot index from a particle tag
@@ -1215,7 +1437,7 @@ std::map<unsigned int, unsigned int> ParticleData::takeSnapshot(SnapshotParticle
     ArrayHandle< Scalar4 >  h_angmom(m_angmom, access_location::host, access_mode::read);
     ArrayHandle< Scalar3 >  h_inertia(m_inertia, access_location::host, access_mode::read);
     ArrayHandle< unsigned int > h_tag(m_tag, access_location::host, access_mode::read);
-    ArrayHandle< unsigned int > h_rtag(m_rtag, access_location::host, access_mode::read);
+    TagIndexHandle h_rtag(*this, access_mode::read);
 
 #ifdef ENABLE_MPI
     if (m_decomposition)
@@ -1328,12 +1550,13 @@ std::map<unsigned int, unsigned int> ParticleData::takeSnapshot(SnapshotParticle
 
             // add particles to snapshot
             assert(m_tag_set.size() == getNGlobal());
-            std::set<unsigned int>::const_iterator tag_set_it = m_tag_set.begin();
+            unsigned int tag = 0;
 
             std::map<unsigned int, std::pair<unsigned int, unsigned int> >::iterator rank_rtag_it;
             for (unsigned int snap_id = 0; snap_id < getNGlobal(); snap_id++)
                 {
-                unsigned int tag = *tag_set_it;
+                // iterate through active tags in ascending order
+                tag = snap_id ? m_tag_set.next(tag) : m_tag_set.min();
                 assert(tag <= getMaximumTag());
                 rank_rtag_it = rank_rtag_map.find(tag);
 
@@ -1370,8 +1593,6 @@ std::map<unsigned int, unsigned int> ParticleData::takeSnapshot(SnapshotParticle
                 Scalar3 tmp = vec_to_scalar3(snapshot.pos[snap_id]);
                 m_global_box.wrap(tmp, snapshot.image[snap_id]);
                 snapshot.pos[snap_id] = vec3<Real>(tmp);
-
-                std::advance(tag_set_it, 1);
                 }
             }
         }
@@ -1382,14 +1603,14 @@ std::map<unsigned int, unsigned int> ParticleData::takeSnapshot(SnapshotParticle
         snapshot.resize(getNGlobal());
 
         assert(m_tag_set.size() == m_nparticles);
-        std::set<unsigned int>::const_iterator it = m_tag_set.begin();
+        unsigned int tag = 0;
 
         // iterate through active tags
         for (unsigned int snap_id = 0; snap_id < m_nparticles; snap_id++)
             {
-            unsigned int tag = *it;
+            tag = snap_id ? m_tag_set.next(tag) : m_tag_set.min();
             assert(tag <= getMaximumTag());
-            unsigned int idx = h_rtag.data[tag];
+            unsigned int idx = h_rtag[tag];
             assert(idx < m_nparticles);
 
             // store tag in index map
@@ -1415,8 +1636,6 @@ std::map<unsigned int, unsigned int> ParticleData::takeSnapshot(SnapshotParticle
             Scalar3 tmp = vec_to_scalar3(snapshot.pos[snap_id]);
             m_global_box.wrap(tmp, snapshot.image[snap_id]);
             snapshot.pos[snap_id] = vec3<Real>(tmp);
-
-            std::advance(it, 1);
             }
         }
 
@@ -2151,9 +2370,12 @@ void ParticleData::setType(unsigned int tag, unsigned int typ)
 #endif
     if (found)
         {
-        ArrayHandle< Scalar4 > h_pos(m_pos, access_location::host, access_mode::readwrite);
-        h_pos.data[idx].w = __int_as_scalar(typ);
-        // signal that the types have changed
+            {
+            ArrayHandle< Scalar4 > h_pos(m_pos, access_location::host, access_mode::readwrite);
+            h_pos.data[idx].w = __int_as_scalar(typ);
+            }
+
+        // signal that the types have changed, after releasing the positions so that listeners can read them
         notifyParticleSort();
         }
     }
@@ -2247,31 +2469,30 @@ unsigned int ParticleData::addParticle(unsigned int type)
         // Otherwise, generate a new tag
         tag = getNGlobal();
 
-        assert(m_rtag.size() == getNGlobal());
+        assert(m_rtag_map || m_rtag.size() == getNGlobal());
         }
 
     // add to set of active tags
     m_tag_set.insert(tag);
 
-    // invalidate the active tag cache
-    m_invalid_cached_tags = true;
-
     // resize array of global reverse lookup tags
-    m_rtag.resize(getMaximumTag()+1);
+    if (!m_rtag_map)
+        {
+        m_rtag.resize(getMaximumTag()+1);
+        }
 
         {
         // update reverse-lookup table
-        ArrayHandle<unsigned int> h_rtag(m_rtag, access_location::host, access_mode::readwrite);
-        assert(h_rtag.data[tag] = NOT_LOCAL);
+        TagIndexHandle h_rtag(*this, access_mode::readwrite);
         if (m_exec_conf->getRank() == 0)
             {
             // we add the particle at the end
-            h_rtag.data[tag] = getN();
+            h_rtag.set(tag, getN());
             }
         else
             {
             // not on this processor
-            h_rtag.data[tag] = NOT_LOCAL;
+            h_rtag.set(tag, NOT_LOCAL);
             }
         }
 
@@ -2338,14 +2559,14 @@ void ParticleData::removeParticle(unsigned int tag)
     removeAllGhostParticles();
 
     // sanity check
-    if (tag >= m_rtag.size())
+    if (getMaximumTag() == UINT_MAX || tag > getMaximumTag())
         {
         m_exec_conf->msg->error() << "Trying to remove particle " << tag << " which does not exist!" << endl;
         throw runtime_error("Error removing particle");
         }
 
     // Local particle index
-    unsigned int idx = m_rtag[tag];
+    unsigned int idx = getRTag(tag);
 
     bool is_local = idx < getN();
     assert(is_local || idx == NOT_LOCAL);
@@ -2378,7 +2599,7 @@ void ParticleData::removeParticle(unsigned int tag)
         }
 
     // delete from map
-    m_rtag[tag] = NOT_LOCAL;
+    TagIndexHandle(*this, access_mode::readwrite).set(tag, NOT_LOCAL);
 
     if (is_local)
         {
@@ -2398,7 +2619,7 @@ void ParticleData::removeParticle(unsigned int tag)
             ArrayHandle<unsigned int> h_body(getBodies(), access_location::host, access_mode::readwrite);
             ArrayHandle<Scalar4> h_orientation(getOrientationArray(), access_location::host, access_mode::readwrite);
             ArrayHandle<unsigned int> h_tag(getTags(), access_location::host, access_mode::readwrite);
-            ArrayHandle<unsigned int> h_rtag(getRTags(), access_location::host, access_mode::readwrite);
+            TagIndexHandle h_rtag(*this, access_mode::readwrite);
             ArrayHandle<unsigned int> h_comm_flag(m_comm_flags, access_location::host, access_mode::readwrite);
 
             h_pos.data[idx] = h_pos.data[size-1];
@@ -2413,7 +2634,7 @@ void ParticleData::removeParticle(unsigned int tag)
             h_comm_flag.data[idx] = h_comm_flag.data[size-1];
 
             unsigned int last_tag = h_tag.data[size-1];
-            h_rtag.data[last_tag] = idx;
+            h_rtag.set(last_tag, idx);
             }
 
         // update particle number
@@ -2426,9 +2647,6 @@ void ParticleData::removeParticle(unsigned int tag)
     // maintain a stack of deleted group tags for future recycling
     m_recycled_tags.push(tag);
 
-    // invalidate active tag cache
-    m_invalid_cached_tags = true;
-
     // update global particle number
     setNGlobal(getNGlobal()-1);
 
@@ -2449,9 +2667,78 @@ unsigned int ParticleData::getNthTag(unsigned int n)
 
     assert(m_tag_set.size() == getNGlobal());
 
-    // maybe_rebuild_tag_cache only rebuilds if necessary
-    maybe_rebuild_tag_cache();
-    return m_cached_tag_set[n];
+    return m_tag_set.nth(n);
+    }
+
+/*! \param compact True to look up local and ghost particles in a hash map, false to use a dense array
+
+    The dense reverse lookup is indexed by tag and is allocated for the global number of particles on every rank.
+    The compact lookup stores only the local and ghost tags, so that the memory per rank scales with the size of the
+    domain. It is supported on the CPU only. Methods that need the dense array access it through getRTags(), which
+    throws an error with a compact lookup.
+
+    \pre No ParticleGroup or Communicator has been constructed for this particle data yet, as they size their own
+          per-tag arrays on construction.
+*/
+void ParticleData::setCompactTagLookup(bool compact)
+    {
+    if (compact == getCompactTagLookup())
+        return;
+
+    #ifdef ENABLE_HIP
+    if (compact && m_exec_conf->isCUDAEnabled())
+        {
+        m_exec_conf->msg->error() << "The compact tag lookup is not supported on the GPU." << std::endl;
+        throw std::runtime_error("Error setting the tag lookup");
+        }
+    #endif
+
+    unsigned int n = getN() + getNGhosts();
+    ArrayHandle<unsigned int> h_tag(m_tag, access_location::host, access_mode::read);
+
+    if (compact)
+        {
+        m_rtag_map.reset(new TagIndexMap());
+        m_rtag_map->reserve(n);
+        for (unsigned int idx = 0; idx < n; idx++)
+            m_rtag_map->set(h_tag.data[idx], idx);
+
+        // release the dense array
+        GlobalVector<unsigned int>(m_exec_conf).swap(m_rtag);
+        TAG_ALLOCATION(m_rtag);
+        }
+    else
+        {
+        m_rtag_map.reset();
+        resetRTags(getNumTags(), n);
+
+        ArrayHandle<unsigned int> h_rtag(m_rtag, access_location::host, access_mode::readwrite);
+        for (unsigned int idx = 0; idx < n; idx++)
+            h_rtag.data[h_tag.data[idx]] = idx;
+        }
+
+    m_tag_set.setCompact(compact);
+    }
+
+/*! \param n_tags Number of global tags
+    \param n_local Number of tags that will be inserted on this rank
+
+    All tags are set to NOT_LOCAL.
+*/
+void ParticleData::resetRTags(unsigned int n_tags, unsigned int n_local)
+    {
+    if (m_rtag_map)
+        {
+        m_rtag_map->clear();
+        m_rtag_map->reserve(n_local);
+        return;
+        }
+
+    m_rtag.resize(n_tags);
+
+    ArrayHandle<unsigned int> h_rtag(m_rtag, access_location::host, access_mode::overwrite);
+    for (unsigned int tag = 0; tag < n_tags; tag++)
+        h_rtag.data[tag] = NOT_LOCAL;
     }
 
 void export_BoxDim(py::module& m)
@@ -2512,6 +2799,10 @@ template ParticleData::ParticleData(const SnapshotParticleData<double>& snapshot
                                           );
 template void ParticleData::initializeFromSnapshot<double>(const SnapshotParticleData<double> & snapshot, bool ignore_bodies);
 template std::map<unsigned int, unsigned int> ParticleData::takeSnapshot<double>(SnapshotParticleData<double> &snapshot);
+#ifdef ENABLE_MPI
+template void ParticleData::initializeFromDistributedSnapshot<double>(const SnapshotParticleData<double> & snapshot,
+                                                                      std::vector<unsigned int>& owner);
+#endif
 
 
 template ParticleData::ParticleData(const SnapshotParticleData<float>& snapshot,
@@ -2521,6 +2812,10 @@ template ParticleData::ParticleData(const SnapshotParticleData<float>& snapshot,
                                           );
 template void ParticleData::initializeFromSnapshot<float>(const SnapshotParticleData<float> & snapshot, bool ignore_bodies);
 template std::map<unsigned int, unsigned int> ParticleData::takeSnapshot<float>(SnapshotParticleData<float> &snapshot);
+#ifdef ENABLE_MPI
+template void ParticleData::initializeFromDistributedSnapshot<float>(const SnapshotParticleData<float> & snapshot,
+                                                                     std::vector<unsigned int>& owner);
+#endif
 
 
 void export_ParticleData(py::module& m)
@@ -2668,7 +2963,7 @@ void ParticleData::removeParticles(std::vector<pdata_element>& out, std::vector<
         {
         // access particle data tags and rtags
         ArrayHandle<unsigned int> h_tag(getTags(), access_location::host, access_mode::read);
-        ArrayHandle<unsigned int> h_rtag(getRTags(), access_location::host, access_mode::readwrite);
+        TagIndexHandle h_rtag(*this, access_mode::readwrite);
         ArrayHandle<unsigned int> h_comm_flags(getCommFlags(), access_location::host, access_mode::read);
 
         // set all rtags of ptls with comm_flag != 0 to NOT_LOCAL and count removed particles
@@ -2678,7 +2973,7 @@ void ParticleData::removeParticles(std::vector<pdata_element>& out, std::vector<
                 {
                 unsigned int tag = h_tag.data[i];
                 assert(tag <= getMaximumTag());
-                h_rtag.data[tag] = NOT_LOCAL;
+                h_rtag.set(tag, NOT_LOCAL);
                 num_remove_ptls++;
                 }
         }
@@ -2711,7 +3006,7 @@ void ParticleData::removeParticles(std::vector<pdata_element>& out, std::vector<
 
         ArrayHandle<unsigned int> h_tag(getTags(), access_location::host, access_mode::readwrite);
 
-        ArrayHandle<unsigned int> h_rtag(getRTags(), access_location::host, access_mode::read);
+        TagIndexHandle h_rtag(*this, access_mode::read);
 
         ArrayHandle<unsigned int> h_comm_flags(getCommFlags(), access_location::host, access_mode::readwrite);
 
@@ -2730,13 +3025,17 @@ void ParticleData::removeParticles(std::vector<pdata_element>& out, std::vector<
         ArrayHandle<Scalar> h_net_virial_alt(m_net_virial_alt, access_location::host, access_mode::overwrite);
         ArrayHandle<unsigned int> h_tag_alt(m_tag_alt, access_location::host, access_mode::overwrite);
 
+        // record where every particle goes, for the listeners
+        m_reorder.new_idx.resize(old_nparticles);
+
         unsigned int n =0;
         unsigned int m = 0;
         unsigned int net_virial_pitch = (unsigned int)m_net_virial.getPitch();
         for (unsigned int i = 0; i < old_nparticles; ++i)
             {
             unsigned int tag = h_tag.data[i];
-            if (h_rtag.data[tag] != NOT_LOCAL)
+            m_reorder.new_idx[i] = h_rtag[tag] != NOT_LOCAL ? n : NOT_LOCAL;
+            if (h_rtag[tag] != NOT_LOCAL)
                 {
                 // copy over to alternate pdata arrays
                 h_pos_alt.data[n] = h_pos.data[i];
@@ -2804,7 +3103,7 @@ void ParticleData::removeParticles(std::vector<pdata_element>& out, std::vector<
     swapTags();
 
         {
-        ArrayHandle<unsigned int> h_rtag(getRTags(), access_location::host, access_mode::readwrite);
+        TagIndexHandle h_rtag(*this, access_mode::readwrite);
         ArrayHandle<unsigned int> h_tag(getTags(), access_location::host, access_mode::read);
 
         // recompute rtags (particles have moved)
@@ -2813,14 +3112,14 @@ void ParticleData::removeParticles(std::vector<pdata_element>& out, std::vector<
             // reset rtag of this ptl
             unsigned int tag = h_tag.data[idx];
             assert(tag <= getMaximumTag());
-            h_rtag.data[tag] = idx;
+            h_rtag.set(tag, idx);
             }
         }
 
     if (m_prof) m_prof->pop();
 
     // notify subscribers that particle data order has been changed
-    notifyParticleSort();
+    notifyParticleReorder(old_nparticles);
     }
 
 //! Remove particles from local domain and append new particle data
@@ -2852,7 +3151,7 @@ void ParticleData::addParticles(const std::vector<pdata_element>& in)
         ArrayHandle<Scalar4> h_net_torque(getNetTorqueArray(), access_location::host, access_mode::readwrite);
         ArrayHandle<Scalar> h_net_virial(getNetVirial(), access_location::host, access_mode::readwrite);
         ArrayHandle<unsigned int> h_tag(getTags(), access_location::host, access_mode::readwrite);
-        ArrayHandle<unsigned int> h_rtag(getRTags(), access_location::host, access_mode::readwrite);
+        TagIndexHandle h_rtag(*this, access_mode::readwrite);
         ArrayHandle<unsigned int> h_comm_flags(m_comm_flags, access_location::host, access_mode::readwrite);
 
         unsigned int net_virial_pitch = (unsigned int)m_net_virial.getPitch();
@@ -2888,14 +3187,15 @@ void ParticleData::addParticles(const std::vector<pdata_element>& in)
             // reset rtag of this ptl
             unsigned int tag = h_tag.data[idx];
             assert(tag <= getMaximumTag());
-            h_rtag.data[tag] = idx;
+            h_rtag.set(tag, idx);
             }
         }
 
     if (m_prof) m_prof->pop();
 
-    // notify subscribers that particle data order has been changed
-    notifyParticleSort();
+    // notify subscribers that particles have been appended, the others keep their index
+    m_reorder.new_idx.clear();
+    notifyParticleReorder(old_nparticles);
     }
 
 #ifdef ENABLE_HIP
@@ -18,6 +18,7 @@
 #include "HOOMDMath.h"
 #include "GlobalArray.h"
 #include "GPUVector.h"
+#include "TagIndexMap.h"
 #include "GlobalArray.h"
 #include "PythonLocalDataAccess.h"
 
@@ -269,6 +270,24 @@ struct pdata_element
     Scalar net_virial[6];      //!< net virial
     };
 
+//! Describes a rearrangement of the local particles
+/*! A rearrangement is known when the class that reorders the particles passes the permutation to
+    ParticleData::notifyParticleSort(). Listeners may then read it with ParticleData::getParticleReorder() to update
+    their per-index data instead of rebuilding it.
+
+    Particles with an index beyond the end of  new_idx keep their index. Particles that have been added are stored
+    at the indices from  n_prev to ParticleData::getN().
+ */
+struct ParticleReorder
+    {
+    //! Constructor
+    ParticleReorder() : known(false), n_prev(0) { }
+
+    bool known;                             //!< True while listeners are notified of a known rearrangement
+    unsigned int n_prev;                    //!< Number of local particles before the rearrangement
+    std::vector<unsigned int> new_idx;      //!< New index of every particle, NOT_LOCAL if it has been removed
+    };
+
 //! Manages all of the data arrays for the particles
 /*! <h1> General </h1>
     ParticleData stores and manages particle coordinates, velocities, accelerations, type,
@@ -608,8 +627,39 @@ class PYBIND11_EXPORT ParticleData
         //! Return tags
         const GlobalArray< unsigned int >& getTags() const { return m_tag; }
 
+        //! Return an array that maps every local particle index onto itself
+        /*! Groups that contain every particle use it as their index list, see ParticleGroup.
+            \returns An array of at least getN() elements, where element i holds i
+        */
+        const GlobalArray< unsigned int >& getIdentityIndices() const;
+
         //! Return reverse-lookup tags
-        const GlobalVector< unsigned int >& getRTags() const { return m_rtag; }
+        /*! \note The dense array is not available with a compact tag lookup, see setCompactTagLookup()
+         */
+        const GlobalVector< unsigned int >& getRTags() const
+            {
+            if (m_rtag_map)
+                {
+                m_exec_conf->msg->error() << "This method does not support the compact tag lookup." << std::endl;
+                throw std::runtime_error("Error accessing reverse-lookup tags");
+                }
+            return m_rtag;
+            }
+
+        //! Return the dense reverse-lookup array, which is empty with a compact tag lookup
+        const GlobalVector< unsigned int >& getRTagArray() const { return m_rtag; }
+
+        //! Return the compact reverse-lookup map, or nullptr if the lookup is dense
+        TagIndexMap *getRTagMap() const { return m_rtag_map.get(); }
+
+        //! Switch between the dense and the compact reverse tag lookup
+        void setCompactTagLookup(bool compact);
+
+        //! Test if the reverse tag lookup is compact
+        bool getCompactTagLookup() const
+            {
+            return bool(m_rtag_map);
+            }
 
         //! Return body ids
         const GlobalArray< unsigned int >& getBodies() const { return m_body; }
@@ -736,6 +786,18 @@ class PYBIND11_EXPORT ParticleData
         //! Notify listeners that the particles have been rearranged in memory
         void notifyParticleSort();
 
+        //! Notify listeners that the particles have been rearranged by a known permutation
+        void notifyParticleSort(unsigned int n_prev, std::vector<unsigned int>& new_idx);
+
+        //! Get the rearrangement that listeners are currently notified of
+        /*! \returns The permutation of the local particles, which is only known while the sort signal is emitted
+                     by notifyParticleSort(unsigned int, std::vector<unsigned int>&)
+        */
+        const ParticleReorder& getParticleReorder() const
+            {
+            return m_reorder;
+            }
+
         //! Connects a function to be called every time the box size is changed
         Nano::Signal<void ()>& getBoxChangeSignal()
             {
@@ -861,9 +923,9 @@ class PYBIND11_EXPORT ParticleData
         //! Get the current index of a particle with a given global tag
         inline unsigned int getRTag(unsigned int tag) const
             {
-            assert(tag < m_rtag.size());
-            ArrayHandle< unsigned int> h_rtag(m_rtag,access_location::host, access_mode::read);
-            unsigned int idx = h_rtag.data[tag];
+            assert(m_rtag_map || tag < m_rtag.size());
+            TagIndexHandle h_rtag(*this, access_mode::read);
+            unsigned int idx = h_rtag[tag];
 #ifdef ENABLE_MPI
             assert(m_decomposition || idx < getN());
 #endif
@@ -874,16 +936,13 @@ class PYBIND11_EXPORT ParticleData
         //! Return true if particle is local (= owned by this processor)
         bool isParticleLocal(unsigned int tag) const
              {
-             assert(tag < m_rtag.size());
-             ArrayHandle< unsigned int> h_rtag(m_rtag,access_location::host, access_mode::read);
-             return h_rtag.data[tag] < getN();
+             return getRTag(tag) < getN();
              }
 
         //! Return true if the tag is active
         bool isTagActive(unsigned int tag) const
             {
-            std::set<unsigned int>::const_iterator it = m_tag_set.find(tag);
-            return it != m_tag_set.end();
+            return m_tag_set.contains(tag);
             }
 
         /*! Return the maximum particle tag in the simulation
@@ -894,7 +953,13 @@ class PYBIND11_EXPORT ParticleData
             if (m_tag_set.empty())
                 return UINT_MAX;
             else
-                return *m_tag_set.rbegin();
+                return m_tag_set.max();
+            }
+
+        //! Return the number of tags that have been handed out, including the tags of removed particles
+        unsigned int getNumTags() const
+            {
+            return getNGlobal() + (unsigned int)m_recycled_tags.size();
             }
 
         //! Get the orientation of a particle with a given tag
@@ -999,6 +1064,13 @@ class PYBIND11_EXPORT ParticleData
         template <class Real>
         void initializeFromSnapshot(const SnapshotParticleData<Real> & snapshot, bool ignore_bodies=false);
 
+        #ifdef ENABLE_MPI
+        //! Initialize from a snapshot that is distributed over the ranks
+        template <class Real>
+        void initializeFromDistributedSnapshot(const SnapshotParticleData<Real> & snapshot,
+                                               std::vector<unsigned int>& owner);
+        #endif
+
         //! Take a snapshot
         template <class Real>
         std::map<unsigned int, unsigned int> takeSnapshot(SnapshotParticleData<Real> &snapshot);
@@ -1163,6 +1235,7 @@ class PYBIND11_EXPORT ParticleData
         GlobalArray<int3> m_image;                     //!< particle images
         GlobalArray<unsigned int> m_tag;               //!< particle tags
         GlobalVector<unsigned int> m_rtag;             //!< reverse lookup tags
+        std::unique_ptr<TagIndexMap> m_rtag_map;       //!< reverse lookup of local and ghost tags, replaces m_rtag if set
         GlobalArray<unsigned int> m_body;              //!< rigid body ids
         GlobalArray< Scalar4 > m_orientation;          //!< Orientation quaternion for each particle (ignored if not anisotropic)
         GlobalArray< Scalar4 > m_angmom;               //!< Angular momementum quaternion for each particle
@@ -1170,9 +1243,9 @@ class PYBIND11_EXPORT ParticleData
         GlobalArray<unsigned int> m_comm_flags;        //!< Array of communication flags
 
         std::stack<unsigned int> m_recycled_tags;    //!< Global tags of removed particles
-        std::set<unsigned int> m_tag_set;            //!< Lookup table for tags by active index
-        std::vector<unsigned int> m_cached_tag_set;   //!< Cached constant-time lookup table for tags by active index
-        bool m_invalid_cached_tags;                  //!< true if m_cached_tag_set needs to be rebuilt
+        ActiveTagSet m_tag_set;                      //!< Lookup table for tags by active index
+        ParticleReorder m_reorder;                   //!< The rearrangement that listeners are notified of
+        mutable GlobalArray<unsigned int> m_identity_idx; //!< Index of every local particle, in index order
 
         /* Alternate particle data arrays are provided for fast swapping in and out of particle data
            The size of these arrays is updated in sync with the main particle data arrays.
@@ -1219,6 +1292,9 @@ class PYBIND11_EXPORT ParticleData
         unsigned int m_memory_advice_last_Nmax;      //!< Nmax at which memory hints were last set
         #endif
 
+        //! Helper function to notify listeners of the rearrangement stored in m_reorder
+        void notifyParticleReorder(unsigned int n_prev);
+
         //! Helper function to allocate particle data
         void allocate(unsigned int N);
 
@@ -1231,15 +1307,21 @@ class PYBIND11_EXPORT ParticleData
         //! Helper function to reallocate particle data
         void reallocate(unsigned int max_n);
 
-        //! Helper function to rebuild the active tag cache if necessary
-        void maybe_rebuild_tag_cache();
+        //! Helper function to reset the reverse lookup before the local particles are inserted
+        void resetRTags(unsigned int n_tags, unsigned int n_local);
 
         //! Helper function to check that particles of a snapshot are in the box
         /*! \return true If and only if all particles are in the simulation box
          * \param Snapshot to check
+         * \param distributed True if every rank holds a part of the snapshot
          */
         template <class Real>
-        bool inBox(const SnapshotParticleData<Real>& snap);
+        bool inBox(const SnapshotParticleData<Real>& snap, bool distributed=false);
+
+        #ifdef ENABLE_MPI
+        //! Helper function to find the rank that a snapshot particle is placed on
+        unsigned int placeSnapshotParticle(Scalar3& pos, int3& img, unsigned int idx, const unsigned int *cart_ranks);
+        #endif
 
         //! Update the CUDA memory hints
         void setGPUAdvice();
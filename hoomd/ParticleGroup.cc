@@ -7,6 +7,8 @@
 
 #include "hoomd/RandomNumbers.h"
 #include "hoomd/RNGIdentifiers.h"
+#include "filter/ParticleFilterAll.h"
+#include "filter/ParticleFilterType.h"
 
 #ifdef ENABLE_HIP
 #include "ParticleGroup.cuh"
@@ -226,6 +228,8 @@ ParticleGroup::ParticleGroup(std::shared_ptr<SystemDefinition> sysdef,
       m_particles_sorted(true),
       m_reallocated(false),
       m_global_ptl_num_change(false),
+      m_all_members(false),
+      m_type_members(false),
       m_selector(selector),
       m_update_tags(update_tags),
       m_warning_printed(false)
@@ -264,14 +268,15 @@ ParticleGroup::ParticleGroup(std::shared_ptr<SystemDefinition> sysdef, const std
       m_particles_sorted(true),
       m_reallocated(false),
       m_global_ptl_num_change(false),
+      m_all_members(false),
+      m_type_members(false),
       m_update_tags(false),
       m_warning_printed(false)
     {
     // check input
-    unsigned int max_tag = m_pdata->getMaximumTag();
     for (std::vector<unsigned int>::const_iterator it = member_tags.begin(); it != member_tags.end(); ++it)
         {
-        if (*it > max_tag)
+        if (!m_pdata->isTagActive(*it))
             {
             m_exec_conf->msg->error() << "group.*: Member " << *it << " does not exist in particle data." << std::endl;
             throw std::runtime_error("Error creating ParticleGroup\n");
@@ -312,7 +317,7 @@ ParticleGroup::ParticleGroup(std::shared_ptr<SystemDefinition> sysdef, const std
     m_is_member.swap(is_member);
     TAG_ALLOCATION(m_is_member);
 
-    GlobalArray<unsigned int> is_member_tag(m_pdata->getRTags().size(), m_pdata->getExecConf());
+    GlobalArray<unsigned int> is_member_tag(getTagHashSize(), m_pdata->getExecConf());
     m_is_member_tag.swap(is_member_tag);
     TAG_ALLOCATION(m_is_member_tag);
 
@@ -372,57 +377,92 @@ void ParticleGroup::updateMemberTags(bool force_update) const
         // notice message
         m_pdata->getExecConf()->msg->notice(7) << "ParticleGroup: rebuilding tags" << std::endl;
 
-        // assign all of the particles that belong to the group
-        // for each particle in the (global) data
-        vector<unsigned int> member_tags = m_selector->getSelectedTags(m_sysdef);
+        // groups that follow the particle number and select all particles or types are represented implicitly
+        std::shared_ptr<ParticleFilterType> type_filter;
+        if (m_update_tags)
+            type_filter = std::dynamic_pointer_cast<ParticleFilterType>(m_selector);
+        m_all_members = m_update_tags && std::dynamic_pointer_cast<ParticleFilterAll>(m_selector);
+        m_type_members = bool(type_filter);
 
-        #ifdef ENABLE_MPI
-        if (m_pdata->getDomainDecomposition())
+        if (m_all_members)
             {
-            // combine lists from all processors
-            std::vector< std::vector<unsigned int> > member_tags_proc(m_exec_conf->getNRanks());
-            all_gather_v(member_tags, member_tags_proc, m_exec_conf->getMPICommunicator());
+            // the member tags and indices are those of the particle data
+            GlobalArray<unsigned int> member_tags_array;
+            m_member_tags.swap(member_tags_array);
 
-            assert(member_tags_proc.size() == m_exec_conf->getNRanks());
+            GlobalArray<unsigned int> member_idx;
+            m_member_idx.swap(member_idx);
+            }
+        else
+            {
+            // assign all of the particles that belong to the group
+            // for each particle in the (global) data
+            vector<unsigned int> member_tags = m_selector->getSelectedTags(m_sysdef);
 
-            // combine all tags into an ordered set
-            unsigned int n_ranks = m_exec_conf->getNRanks();
-            std::set<unsigned int> tag_set;
-            for (unsigned int irank = 0; irank < n_ranks; ++irank)
+            #ifdef ENABLE_MPI
+            if (m_pdata->getDomainDecomposition())
                 {
-                tag_set.insert(member_tags_proc[irank].begin(), member_tags_proc[irank].end());
+                // combine lists from all processors
+                std::vector< std::vector<unsigned int> > member_tags_proc(m_exec_conf->getNRanks());
+                all_gather_v(member_tags, member_tags_proc, m_exec_conf->getMPICommunicator());
+
+                assert(member_tags_proc.size() == m_exec_conf->getNRanks());
+
+                // combine all tags into an ordered set
+                unsigned int n_ranks = m_exec_conf->getNRanks();
+                std::set<unsigned int> tag_set;
+                for (unsigned int irank = 0; irank < n_ranks; ++irank)
+                    {
+                    tag_set.insert(member_tags_proc[irank].begin(), member_tags_proc[irank].end());
+                    }
+
+                // construct list
+                member_tags.clear();
+                member_tags.insert(member_tags.begin(), tag_set.begin(), tag_set.end());
                 }
+            #endif
 
-            // construct list
-            member_tags.clear();
-            member_tags.insert(member_tags.begin(), tag_set.begin(), tag_set.end());
-            }
-        #endif
+            // store member tags in GlobalArray
+            GlobalArray<unsigned int> member_tags_array(member_tags.size(), m_pdata->getExecConf());
+            m_member_tags.swap(member_tags_array);
+            TAG_ALLOCATION(m_member_tags);
 
-        // store member tags in GlobalArray
-        GlobalArray<unsigned int> member_tags_array(member_tags.size(), m_pdata->getExecConf());
-        m_member_tags.swap(member_tags_array);
-        TAG_ALLOCATION(m_member_tags);
+            // sort member tags
+            std::sort(member_tags.begin(), member_tags.end());
 
-        // sort member tags
-        std::sort(member_tags.begin(), member_tags.end());
+                {
+                ArrayHandle<unsigned int> h_member_tags(m_member_tags, access_location::host, access_mode::overwrite);
+                std::copy(member_tags.begin(), member_tags.end(), h_member_tags.data);
+                }
 
-            {
-            ArrayHandle<unsigned int> h_member_tags(m_member_tags, access_location::host, access_mode::overwrite);
-            std::copy(member_tags.begin(), member_tags.end(), h_member_tags.data);
+            // the local members of a group of types are not limited by the member tags, which are only updated
+            // with the global particle number
+            GlobalArray<unsigned int> member_idx(m_type_members ? m_pdata->getMaxN() : member_tags.size(),
+                m_pdata->getExecConf());
+            m_member_idx.swap(member_idx);
+            TAG_ALLOCATION(m_member_idx);
             }
 
-        GlobalArray<unsigned int> member_idx(member_tags.size(), m_pdata->getExecConf());
-        m_member_idx.swap(member_idx);
-        TAG_ALLOCATION(m_member_idx);
+        if (m_type_members)
+            {
+            // flag the selected types
+            GlobalArray<unsigned int> is_member_type(m_pdata->getNTypes(), m_pdata->getExecConf());
+            m_is_member_type.swap(is_member_type);
+            TAG_ALLOCATION(m_is_member_type);
+
+            ArrayHandle<unsigned int> h_is_member_type(m_is_member_type, access_location::host, access_mode::overwrite);
+            std::fill(h_is_member_type.data, h_is_member_type.data + m_pdata->getNTypes(), 0);
+            for (const std::string& type_name : type_filter->getTypes())
+                h_is_member_type.data[m_pdata->getTypeByName(type_name)] = 1;
+            }
         }
 
     // one byte per particle to indicate membership in the group, initialize with current number of local particles
-    GlobalArray<unsigned int> is_member(m_pdata->getMaxN(), m_pdata->getExecConf());
+    GlobalArray<unsigned int> is_member(m_all_members ? 0 : m_pdata->getMaxN(), m_pdata->getExecConf());
     m_is_member.swap(is_member);
     TAG_ALLOCATION(m_is_member);
 
-    GlobalArray<unsigned int> is_member_tag(m_pdata->getRTags().size(), m_pdata->getExecConf());
+    GlobalArray<unsigned int> is_member_tag(getTagHashSize(), m_pdata->getExecConf());
     m_is_member_tag.swap(is_member_tag);
     TAG_ALLOCATION(m_is_member_tag);
 
@@ -435,12 +475,16 @@ void ParticleGroup::updateMemberTags(bool force_update) const
 
 void ParticleGroup::reallocate() const
     {
-    m_is_member.resize(m_pdata->getMaxN());
+    if (!m_all_members)
+        m_is_member.resize(m_pdata->getMaxN());
+
+    if (m_type_members)
+        m_member_idx.resize(m_pdata->getMaxN());
 
-    if (m_is_member_tag.getNumElements() != m_pdata->getRTags().size())
+    if (m_is_member_tag.getNumElements() != getTagHashSize())
         {
         // reallocate if necessary
-        GlobalArray<unsigned int> is_member_tag(m_pdata->getRTags().size(), m_exec_conf);
+        GlobalArray<unsigned int> is_member_tag(getTagHashSize(), m_exec_conf);
         m_is_member_tag.swap(is_member_tag);
         TAG_ALLOCATION(m_is_member_tag);
 
@@ -512,37 +556,10 @@ std::shared_ptr<ParticleGroup> ParticleGroup::groupUnion(std::shared_ptr<Particl
     // vector to store the new list of tags
     vector<unsigned int> member_tags;
 
-    if (a != b)
-        {
-        unsigned int n_a = a->getNumMembersGlobal();
-        unsigned int n_b = b->getNumMembersGlobal();
-
-        // make the union
-        ArrayHandle<unsigned int> h_members_a(a->m_member_tags, access_location::host, access_mode::read);
-        ArrayHandle<unsigned int> h_members_b(b->m_member_tags, access_location::host, access_mode::read);
-
-        insert_iterator< vector<unsigned int> > ii(member_tags, member_tags.begin());
-        set_union(h_members_a.data,
-                  h_members_a.data + n_a,
-                  h_members_b.data,
-                  h_members_b.data + n_b,
-                  ii);
-        }
-    else
-        {
-        unsigned int n_a = a->getNumMembersGlobal();
-
-        // If the two arguments are the same, just return a copy of the whole group (we cannot
-        // acquire the member_tags array twice)
-        ArrayHandle<unsigned int> h_members_a(a->m_member_tags, access_location::host, access_mode::read);
-
-        insert_iterator< vector<unsigned int> > ii(member_tags, member_tags.begin());
-        std::copy(h_members_a.data,
-                  h_members_a.data + n_a,
-                  ii);
-        }
-
-
+    // make the union
+    vector<unsigned int> members_a = a->getMemberTags();
+    vector<unsigned int> members_b = b->getMemberTags();
+    set_union(members_a.begin(), members_a.end(), members_b.begin(), members_b.end(), back_inserter(member_tags));
 
     // create the new particle group
     std::shared_ptr<ParticleGroup> new_group(new ParticleGroup(a->m_sysdef, member_tags));
@@ -563,34 +580,11 @@ std::shared_ptr<ParticleGroup> ParticleGroup::groupIntersection(std::shared_ptr<
     // vector to store the new list of tags
     vector<unsigned int> member_tags;
 
-    if (a != b)
-        {
-        unsigned int n_a = a->getNumMembersGlobal();
-        unsigned int n_b = b->getNumMembersGlobal();
-
-        // make the intersection
-        ArrayHandle<unsigned int> h_members_a(a->m_member_tags, access_location::host, access_mode::read);
-        ArrayHandle<unsigned int> h_members_b(b->m_member_tags, access_location::host, access_mode::read);
-
-        insert_iterator< vector<unsigned int> > ii(member_tags, member_tags.begin());
-        set_intersection(h_members_a.data,
-                         h_members_a.data + n_a,
-                         h_members_b.data,
-                         h_members_b.data + n_b,
-                         ii);
-        }
-    else
-        {
-        unsigned int n_a = a->getNumMembersGlobal();
-        // If the two arguments are the same, just return a copy of the whole group (we cannot
-        // acquire the member_tags array twice)
-        ArrayHandle<unsigned int> h_members_a(a->m_member_tags, access_location::host, access_mode::read);
-
-        insert_iterator< vector<unsigned int> > ii(member_tags, member_tags.begin());
-        std::copy(h_members_a.data,
-                  h_members_a.data + n_a,
-                  ii);
-        }
+    // make the intersection
+    vector<unsigned int> members_a = a->getMemberTags();
+    vector<unsigned int> members_b = b->getMemberTags();
+    set_intersection(members_a.begin(), members_a.end(), members_b.begin(), members_b.end(),
+        back_inserter(member_tags));
 
     // create the new particle group
     std::shared_ptr<ParticleGroup> new_group(new ParticleGroup(a->m_sysdef, member_tags));
@@ -611,44 +605,64 @@ std::shared_ptr<ParticleGroup> ParticleGroup::groupDifference(std::shared_ptr<Pa
     // vector to store the new list of tags
     vector<unsigned int> member_tags;
 
-    if (a != b)
-        {
-        unsigned int n_a = a->getNumMembersGlobal();
-        unsigned int n_b = b->getNumMembersGlobal();
-        // make the difference
-        ArrayHandle<unsigned int> h_members_a(a->m_member_tags, access_location::host, access_mode::read);
-        ArrayHandle<unsigned int> h_members_b(b->m_member_tags, access_location::host, access_mode::read);
+    // make the difference
+    vector<unsigned int> members_a = a->getMemberTags();
+    vector<unsigned int> members_b = b->getMemberTags();
+    set_difference(members_a.begin(), members_a.end(), members_b.begin(), members_b.end(),
+        back_inserter(member_tags));
 
-        insert_iterator< vector<unsigned int> > ii(member_tags, member_tags.begin());
-        set_difference(h_members_a.data,
-                  h_members_a.data + n_a,
-                  h_members_b.data,
-                  h_members_b.data + n_b,
-                  ii);
+    // create the new particle group
+    std::shared_ptr<ParticleGroup> new_group(new ParticleGroup(a->m_sysdef, member_tags));
+
+    // return the newly created group
+    return new_group;
+    }
+
+/*! \returns The tags of all members, in sorted order
+ */
+std::vector<unsigned int> ParticleGroup::getMemberTags() const
+    {
+    unsigned int n_members = getNumMembersGlobal();
+    std::vector<unsigned int> member_tags(n_members);
+
+    if (m_all_members)
+        {
+        for (unsigned int i = 0; i < n_members; ++i)
+            member_tags[i] = m_pdata->getNthTag(i);
         }
     else
         {
-        // If the two arguments are the same, just return an empty group (we cannot
-        // acquire the member_tags array twice)
+        ArrayHandle<unsigned int> h_member_tags(m_member_tags, access_location::host, access_mode::read);
+        std::copy(h_member_tags.data, h_member_tags.data + n_members, member_tags.begin());
         }
 
+    return member_tags;
+    }
 
-    // create the new particle group
-    std::shared_ptr<ParticleGroup> new_group(new ParticleGroup(a->m_sysdef, member_tags));
+/*! \returns the number of elements of the by-tag-lookup table, which is empty if membership is not looked up by tag
+ */
+unsigned int ParticleGroup::getTagHashSize() const
+    {
+    // groups of all particles and of types do not look up membership by tag
+    if (m_all_members || m_type_members || m_pdata->getCompactTagLookup())
+        return 0;
 
-    // return the newly created group
-    return new_group;
+    return m_pdata->getNumTags();
     }
 
 /*! Builds the by-tag-lookup table for group membership
  */
 void ParticleGroup::buildTagHash() const
     {
+    // membership is looked up in the sorted member tags or by type instead
+    if (getTagHashSize() == 0)
+        return;
+
     ArrayHandle<unsigned int> h_is_member_tag(m_is_member_tag, access_location::host, access_mode::overwrite);
     ArrayHandle<unsigned int> h_member_tags(m_member_tags, access_location::host, access_mode::read);
 
     // reset member ship flags
-    memset(h_is_member_tag.data, 0, sizeof(unsigned int)*(m_pdata->getRTags().size()));
+    memset(h_is_member_tag.data, 0, sizeof(unsigned int)*m_is_member_tag.getNumElements());
 
     size_t num_members = m_member_tags.getNumElements();
     for (size_t member = 0; member < num_members; member++)
@@ -675,28 +689,34 @@ void ParticleGroup::rebuildIndexList() const
     else
     #endif
         {
-
-        // rebuild the membership flags for the  indices in the group and construct member list
-        ArrayHandle<unsigned int> h_is_member(m_is_member, access_location::host, access_mode::readwrite);
-        ArrayHandle<unsigned int> h_is_member_tag(m_is_member_tag, access_location::host, access_mode::read);
-        ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
-        ArrayHandle<unsigned int> h_member_idx(m_member_idx, access_location::host, access_mode::readwrite);
         unsigned int nparticles = m_pdata->getN();
-        unsigned int cur_member = 0;
-        for (unsigned int idx = 0; idx < nparticles; idx ++)
+
+        if (m_all_members)
             {
-            assert(h_tag.data[idx] <= m_pdata->getMaximumTag());
-            unsigned int is_member = h_is_member_tag.data[h_tag.data[idx]];
-            h_is_member.data[idx] =  is_member;
-            if (is_member)
+            // every local particle is a member, in index order
+            m_num_local_members = nparticles;
+            }
+        else
+            {
+            // rebuild the membership flags for the  indices in the group and construct member list
+            ArrayHandle<unsigned int> h_is_member(m_is_member, access_location::host, access_mode::readwrite);
+            ArrayHandle<unsigned int> h_member_idx(m_member_idx, access_location::host, access_mode::readwrite);
+
+            flagMembers(0, nparticles, h_is_member.data);
+
+            unsigned int cur_member = 0;
+            for (unsigned int idx = 0; idx < nparticles; idx ++)
                 {
-                h_member_idx.data[cur_member] = idx;
-                cur_member++;
+                if (h_is_member.data[idx])
+                    {
+                    h_member_idx.data[cur_member] = idx;
+                    cur_member++;
+                    }
                 }
-            }
 
-        m_num_local_members = cur_member;
-        assert(m_num_local_members <= m_member_tags.getNumElements());
+            m_num_local_members = cur_member;
+            assert(m_num_local_members <= m_member_idx.getNumElements());
+            }
         }
 
     // index has been rebuilt
@@ -711,10 +731,138 @@ void ParticleGroup::rebuildIndexList() const
     #endif
     }
 
+/*! \param first First local index to look up
+    \param last One past the last local index to look up
+    \param is_member Membership flags by local index, set to 1 for members and 0 otherwise
+*/
+void ParticleGroup::flagMembers(unsigned int first, unsigned int last, unsigned int *is_member) const
+    {
+    if (m_type_members)
+        {
+        ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_is_member_type(m_is_member_type, access_location::host, access_mode::read);
+        unsigned int ntypes = (unsigned int)m_is_member_type.getNumElements();
+
+        for (unsigned int idx = first; idx < last; idx ++)
+            {
+            // types added after the group was created are not selected
+            unsigned int typ = __scalar_as_int(h_postype.data[idx].w);
+            is_member[idx] = typ < ntypes ? h_is_member_type.data[typ] : 0;
+            }
+        }
+    else if (m_pdata->getCompactTagLookup())
+        {
+        // look up the tags in the sorted member tags
+        ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_member_tags(m_member_tags, access_location::host, access_mode::read);
+        const unsigned int *first_tag = h_member_tags.data;
+        const unsigned int *last_tag = h_member_tags.data + m_member_tags.getNumElements();
+
+        for (unsigned int idx = first; idx < last; idx ++)
+            is_member[idx] = std::binary_search(first_tag, last_tag, h_tag.data[idx]) ? 1 : 0;
+        }
+    else
+        {
+        ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_is_member_tag(m_is_member_tag, access_location::host, access_mode::read);
+
+        for (unsigned int idx = first; idx < last; idx ++)
+            {
+            assert(h_tag.data[idx] <= m_pdata->getMaximumTag());
+            is_member[idx] = h_is_member_tag.data[h_tag.data[idx]];
+            }
+        }
+    }
+
+/*! \param reorder The rearrangement of the local particles
+
+    \pre m_is_member and m_member_idx reflect the particle order before the rearrangement
+    \post m_is_member and m_member_idx are updated in O(number of local members + number of added particles)
+*/
+void ParticleGroup::applyReorder(const ParticleReorder& reorder) const
+    {
+    unsigned int nparticles = m_pdata->getN();
+
+    if (m_all_members)
+        {
+        m_num_local_members = nparticles;
+        return;
+        }
+
+    ArrayHandle<unsigned int> h_is_member(m_is_member, access_location::host, access_mode::readwrite);
+    ArrayHandle<unsigned int> h_member_idx(m_member_idx, access_location::host, access_mode::readwrite);
+
+    // clear the flags at the old indices and move the members that stay to their new indices
+    unsigned int n_reordered = (unsigned int)reorder.new_idx.size();
+    unsigned int cur_member = 0;
+    for (unsigned int i = 0; i < m_num_local_members; ++i)
+        {
+        unsigned int idx = h_member_idx.data[i];
+        h_is_member.data[idx] = 0;
+
+        unsigned int new_idx = idx < n_reordered ? reorder.new_idx[idx] : idx;
+        if (new_idx != NOT_LOCAL)
+            h_member_idx.data[cur_member++] = new_idx;
+        }
+
+    for (unsigned int i = 0; i < cur_member; ++i)
+        h_is_member.data[h_member_idx.data[i]] = 1;
+
+    // look up the particles that have been added
+    if (reorder.n_prev < nparticles)
+        {
+        flagMembers(reorder.n_prev, nparticles, h_is_member.data);
+
+        for (unsigned int idx = reorder.n_prev; idx < nparticles; idx ++)
+            {
+            if (h_is_member.data[idx])
+                h_member_idx.data[cur_member++] = idx;
+            }
+        }
+
+    // keep the members in index order for cache efficient access
+    std::sort(h_member_idx.data, h_member_idx.data + cur_member);
+
+    m_num_local_members = cur_member;
+    assert(m_num_local_members <= m_member_idx.getNumElements());
+    }
+
+/*! The index lists are updated right away, while the particle data arrays are released. A known rearrangement is
+    applied to the current members, otherwise the lists are rebuilt.
+*/
+void ParticleGroup::slotParticleSort()
+    {
+    // the index lists are rebuilt along with the member tags
+    if (m_global_ptl_num_change)
+        {
+        m_particles_sorted = true;
+        return;
+        }
+
+    bool update_gpu_advice = false;
+    if (m_reallocated)
+        {
+        reallocate();
+        m_reallocated = false;
+        update_gpu_advice = true;
+        }
+
+    const ParticleReorder& reorder = m_pdata->getParticleReorder();
+    if (reorder.known && !m_exec_conf->isCUDAEnabled())
+        applyReorder(reorder);
+    else
+        rebuildIndexList();
+
+    m_particles_sorted = false;
+
+    if (update_gpu_advice)
+        updateGPUAdvice();
+    }
+
 void ParticleGroup::updateGPUAdvice() const
     {
     #if defined(ENABLE_HIP) && defined(__HIP_PLATFORM_NVCC__)
-    if (m_exec_conf->isCUDAEnabled() && m_exec_conf->allConcurrentManagedAccess())
+    if (m_exec_conf->isCUDAEnabled() && m_exec_conf->allConcurrentManagedAccess() && !m_all_members)
         {
         // split preferred location of group indices across GPUs
         auto gpu_map = m_exec_conf->getGPUIds();
@@ -742,35 +890,57 @@ void ParticleGroup::updateGPUAdvice() const
 //! rebuild index list on the GPU
 void ParticleGroup::rebuildIndexListGPU() const
     {
+    if (m_all_members)
+        {
+        m_num_local_members = m_pdata->getN();
+        return;
+        }
+
     ArrayHandle<unsigned int> d_is_member(m_is_member, access_location::device, access_mode::overwrite);
-    ArrayHandle<unsigned int> d_is_member_tag(m_is_member_tag, access_location::device, access_mode::read);
     ArrayHandle<unsigned int> d_member_idx(m_member_idx, access_location::device, access_mode::overwrite);
-    ArrayHandle<unsigned int> d_tag(m_pdata->getTags(), access_location::device, access_mode::read);
 
     // get temporary buffer
     ScopedAllocation<unsigned int> d_tmp(m_pdata->getExecConf()->getCachedAllocator(), m_pdata->getN());
 
     // reset membership properties
-    if (m_member_tags.getNumElements() > 0)
+    if (m_type_members)
         {
+        ArrayHandle<Scalar4> d_postype(m_pdata->getPositions(), access_location::device, access_mode::read);
+        ArrayHandle<unsigned int> d_is_member_type(m_is_member_type, access_location::device, access_mode::read);
+
+        gpu_rebuild_index_list_type(m_pdata->getN(),
+                           (unsigned int)m_is_member_type.getNumElements(),
+                           d_is_member_type.data,
+                           d_is_member.data,
+                           d_postype.data);
+        }
+    else if (m_member_tags.getNumElements() > 0)
+        {
+        ArrayHandle<unsigned int> d_is_member_tag(m_is_member_tag, access_location::device, access_mode::read);
+        ArrayHandle<unsigned int> d_tag(m_pdata->getTags(), access_location::device, access_mode::read);
+
         gpu_rebuild_index_list(m_pdata->getN(),
                            d_is_member_tag.data,
                            d_is_member.data,
                            d_tag.data);
-        if (m_exec_conf->isCUDAErrorCheckingEnabled())
-            CHECK_CUDA_ERROR();
-
-        gpu_compact_index_list(m_pdata->getN(),
-                           d_is_member.data,
-                           d_member_idx.data,
-                           m_num_local_members,
-                           d_tmp.data,
-                           m_pdata->getExecConf()->getCachedAllocator());
-        if (m_exec_conf->isCUDAErrorCheckingEnabled())
-            CHECK_CUDA_ERROR();
         }
     else
+        {
         m_num_local_members = 0;
+        return;
+        }
+
+    if (m_exec_conf->isCUDAErrorCheckingEnabled())
+        CHECK_CUDA_ERROR();
+
+    gpu_compact_index_list(m_pdata->getN(),
+                       d_is_member.data,
+                       d_member_idx.data,
+                       m_num_local_members,
+                       d_tmp.data,
+                       m_pdata->getExecConf()->getCachedAllocator());
+    if (m_exec_conf->isCUDAErrorCheckingEnabled())
+        CHECK_CUDA_ERROR();
     }
 #endif
 
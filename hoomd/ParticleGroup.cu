@@ -34,6 +34,22 @@ __global__ void gpu_rebuild_index_list_kernel(unsigned int N,
     d_is_member[idx] = d_is_member_tag[tag];
     }
 
+//! GPU kernel to look up group membership by particle type
+__global__ void gpu_rebuild_index_list_type_kernel(unsigned int N,
+                                                   unsigned int n_types,
+                                                   const Scalar4 *d_postype,
+                                                   const unsigned int *d_is_member_type,
+                                                   unsigned int *d_is_member)
+    {
+    unsigned int idx = blockIdx.x * blockDim.x + threadIdx.x;
+
+    if (idx >= N) return;
+
+    unsigned int typ = __scalar_as_int(d_postype[idx].w);
+
+    d_is_member[idx] = typ < n_types ? d_is_member_type[typ] : 0;
+    }
+
 __global__ void gpu_scatter_member_indices(unsigned int N,
     const unsigned int *d_scan,
     const unsigned int *d_is_member,
@@ -75,6 +91,35 @@ hipError_t gpu_rebuild_index_list(unsigned int N,
     return hipSuccess;
     }
 
+//! GPU method for rebuilding the membership flags of a ParticleGroup of types
+/*! \param N number of local particles
+    \param n_types Number of entries in \a d_is_member_type
+    \param d_is_member_type Lookup table for type -> group membership
+    \param d_is_member Array of membership flags
+    \param d_postype Array of particle positions and types
+*/
+hipError_t gpu_rebuild_index_list_type(unsigned int N,
+                                   unsigned int n_types,
+                                   const unsigned int *d_is_member_type,
+                                   unsigned int *d_is_member,
+                                   const Scalar4 *d_postype)
+    {
+    assert(d_is_member);
+    assert(d_is_member_type);
+    assert(d_postype);
+
+    unsigned int block_size = 256;
+    unsigned int n_blocks = N/block_size + 1;
+
+    hipLaunchKernelGGL(gpu_rebuild_index_list_type_kernel, dim3(n_blocks), dim3(block_size), 0, 0,
+         N,
+         n_types,
+         d_postype,
+         d_is_member_type,
+         d_is_member);
+    return hipSuccess;
+    }
+
 //! GPU method for compacting the group member indices
 /*! \param N number of local particles
     \param d_is_member_tag Global lookup table for tag -> group membership
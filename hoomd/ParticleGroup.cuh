@@ -4,6 +4,7 @@
 
 // Maintainer: jglaser
 #include "CachedAllocator.h"
+#include "HOOMDMath.h"
 
 /*! \file ParticleGroup.cuh
     \brief Contains GPU kernel code used by ParticleGroup
@@ -17,6 +18,13 @@ hipError_t gpu_rebuild_index_list(unsigned int N,
                                    unsigned int *d_is_member,
                                    unsigned int *d_tag);
 
+//! GPU method for rebuilding the membership flags of a ParticleGroup of types
+hipError_t gpu_rebuild_index_list_type(unsigned int N,
+                                   unsigned int n_types,
+                                   const unsigned int *d_is_member_type,
+                                   unsigned int *d_is_member,
+                                   const Scalar4 *d_postype);
+
 //! GPU method for compacting the group member indices
 /*! \param N number of local particles
     \param d_is_member_tag Global lookup table for tag -> group membership
@@ -133,6 +133,15 @@ class PYBIND11_EXPORT ParticleFilterRigidCenter : public ParticleFilter
     Thirdly, a dynamic bitset is used to store one bit per particle for efficient O(1) tests if a given particle is in
     the group.
 
+    When the particles are rearranged by a known permutation (see ParticleReorder), the index list and the bitset are
+    updated by applying the permutation to the current members and looking up only the particles that have been added.
+    Otherwise they are rebuilt from all local particles.
+
+    Groups that follow the global particle number and select all particles, or all particles of some types, are
+    represented implicitly. A group of all particles stores no per-particle arrays, its member tags are those of the
+    particle data and its index list is ParticleData::getIdentityIndices(). A group of types looks up membership by the
+    particle type instead of by tag. Its member tags are updated when the global particle number changes.
+
     Finally, the common use case on the GPU using groups will include running one thread per particle in the group.
     For that it needs a list of indices of all the particles in the group. To facilitates this, the list of indices
     in the group will be stored in a GPUArray.
@@ -146,7 +155,7 @@ class PYBIND11_EXPORT ParticleGroup
         // @{
 
         //! Constructs an empty particle group
-        ParticleGroup() : m_num_local_members(0) {};
+        ParticleGroup() : m_num_local_members(0), m_all_members(false), m_type_members(false) {};
 
         //! Constructs a particle group of all particles that meet the given selection
         ParticleGroup(std::shared_ptr<SystemDefinition> sysdef, std::shared_ptr<ParticleFilter> selector,
@@ -177,6 +186,9 @@ class PYBIND11_EXPORT ParticleGroup
             {
             checkRebuild();
 
+            if (m_all_members)
+                return m_pdata->getNGlobal();
+
             return (unsigned int)m_member_tags.getNumElements();
             }
 
@@ -199,6 +211,9 @@ class PYBIND11_EXPORT ParticleGroup
             checkRebuild();
 
             assert(i < getNumMembersGlobal());
+            if (m_all_members)
+                return m_pdata->getNthTag(i);
+
             ArrayHandle<unsigned int> h_member_tags(m_member_tags, access_location::host, access_mode::read);
             return h_member_tags.data[i];
             }
@@ -216,6 +231,9 @@ class PYBIND11_EXPORT ParticleGroup
             checkRebuild();
 
             assert(j < getNumMembers());
+            if (m_all_members)
+                return j;
+
             ArrayHandle<unsigned int> h_handle(m_member_idx, access_location::host, access_mode::read);
             unsigned int idx = h_handle.data[j];
             assert(idx < m_pdata->getN());
@@ -232,6 +250,9 @@ class PYBIND11_EXPORT ParticleGroup
             {
             checkRebuild();
 
+            if (m_all_members)
+                return true;
+
             ArrayHandle<unsigned int> h_handle(m_is_member, access_location::host, access_mode::read);
             return h_handle.data[idx] == 1;
             }
@@ -247,6 +268,9 @@ class PYBIND11_EXPORT ParticleGroup
             {
             checkRebuild();
 
+            if (m_all_members)
+                return m_pdata->getIdentityIndices();
+
             return m_member_idx;
             }
 
@@ -339,6 +363,9 @@ class PYBIND11_EXPORT ParticleGroup
         mutable bool m_particles_sorted;                //!< True if particle have been sorted since last rebuild
         mutable bool m_reallocated;                     //!< True if particle data arrays have been reallocated
         mutable bool m_global_ptl_num_change;           //!< True if the global particle number changed
+        mutable bool m_all_members;                     //!< True if every particle in the system is a member
+        mutable bool m_type_members;                    //!< True if membership is given by the particle type
+        mutable GlobalArray<unsigned int> m_is_member_type; //!< One entry per type, == 1 if the type is selected
 
         mutable GlobalArray<unsigned int> m_is_member_tag;  //!< One byte per particle, == 1 if tag is a member of the group
         std::shared_ptr<ParticleFilter> m_selector; //!< The associated particle selector
@@ -356,12 +383,24 @@ class PYBIND11_EXPORT ParticleGroup
         /// Number of rotational degrees of freedom in the group
         Scalar m_rotational_dof=0;
 
+        //! Helper function to get the size of the by-tag-lookup table
+        unsigned int getTagHashSize() const;
+
         //! Helper function to resize array of member tags
         void reallocate() const;
 
         //! Helper function to rebuild the index lists after the particles have been sorted
         void rebuildIndexList() const;
 
+        //! Helper function to apply a known rearrangement of the particles to the index lists
+        void applyReorder(const ParticleReorder& reorder) const;
+
+        //! Helper function to look up the membership of a range of local particles
+        void flagMembers(unsigned int first, unsigned int last, unsigned int *is_member) const;
+
+        //! Helper function to get the sorted member tags
+        std::vector<unsigned int> getMemberTags() const;
+
         //! Helper function to rebuild internal arrays
         void checkRebuild() const
             {
@@ -396,10 +435,7 @@ class PYBIND11_EXPORT ParticleGroup
             }
 
         //! Helper function to be called when the particles are resorted
-        void slotParticleSort()
-            {
-            m_particles_sorted = true;
-            }
+        void slotParticleSort();
 
         //! Update the GPU memory advice
         void updateGPUAdvice() const;
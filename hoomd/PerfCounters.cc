@@ -0,0 +1,187 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+/*! \file PerfCounters.cc
+    \brief Defines the PerfCounters class
+*/
+
+#include "PerfCounters.h"
+
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#ifdef ENABLE_TBB
+#include <tbb/task_scheduler_observer.h>
+
+//! Attaches the threads that enter the TBB task scheduler to a PerfCounters object
+class PerfCountersObserver : public tbb::task_scheduler_observer
+    {
+    public:
+        //! Start observing the task scheduler
+        /*! \param counters Counters to attach the threads to
+         */
+        PerfCountersObserver(PerfCounters& counters) : m_counters(counters)
+            {
+            observe(true);
+            }
+
+        //! Stop observing before the counters are closed
+        virtual ~PerfCountersObserver()
+            {
+            observe(false);
+            }
+
+        //! Called by every thread that enters the task scheduler
+        virtual void on_scheduler_entry(bool is_worker)
+            {
+            m_counters.attachThread();
+            }
+
+    private:
+        PerfCounters& m_counters;   //!< Counters to attach the threads to
+    };
+#endif
+
+PerfCounters::PerfCounters() : m_available(false)
+    {
+    #ifdef __linux__
+    attachThread();
+    m_available = !m_fd.empty();
+    #endif
+
+    #ifdef ENABLE_TBB
+    if (m_available)
+        m_observer.reset(new PerfCountersObserver(*this));
+    #endif
+    }
+
+PerfCounters::~PerfCounters()
+    {
+    #ifdef ENABLE_TBB
+    m_observer.reset();
+    #endif
+
+    #ifdef __linux__
+    for (unsigned int i = 0; i < m_fd.size(); ++i)
+        close(m_fd[i]);
+    #endif
+    }
+
+/*! \param fd Array of num_counters file descriptors to fill
+    \returns true if all counters could be opened
+
+    When not all counters can be opened, the open ones are closed again.
+*/
+bool PerfCounters::openCounters(int *fd)
+    {
+    #ifdef __linux__
+    const uint64_t config[num_counters] = {PERF_COUNT_HW_CPU_CYCLES,
+                                           PERF_COUNT_HW_INSTRUCTIONS,
+                                           PERF_COUNT_HW_CACHE_MISSES};
+
+    bool success = true;
+    for (unsigned int i = 0; i < num_counters; ++i)
+        {
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = config[i];
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+
+        // this thread, any cpu, no group
+        fd[i] = (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+        if (fd[i] < 0)
+            success = false;
+        }
+
+    if (!success)
+        {
+        for (unsigned int i = 0; i < num_counters; ++i)
+            {
+            if (fd[i] >= 0)
+                close(fd[i]);
+            }
+        }
+    return success;
+    #else
+    return false;
+    #endif
+    }
+
+/*! Threads that are already counted are ignored. The counters of a thread remain readable after it exits.
+*/
+void PerfCounters::attachThread()
+    {
+    #ifdef __linux__
+    long tid = syscall(SYS_gettid);
+
+        {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_threads.insert(tid).second)
+            return;
+        }
+
+    int fd[num_counters];
+    if (openCounters(fd))
+        {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_fd.insert(m_fd.end(), fd, fd + num_counters);
+        }
+    #endif
+    }
+
+unsigned int PerfCounters::getNumThreads() const
+    {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return (unsigned int)(m_fd.size() / num_counters);
+    }
+
+void PerfCounters::read(uint64_t *values) const
+    {
+    for (unsigned int i = 0; i < num_counters; ++i)
+        values[i] = 0;
+
+    #ifdef __linux__
+    if (!m_available)
+        return;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (unsigned int j = 0; j < m_fd.size(); ++j)
+        {
+        // value, time enabled, time running
+        uint64_t buf[3];
+        if (::read(m_fd[j], buf, sizeof(buf)) != (ssize_t)sizeof(buf))
+            continue;
+
+        unsigned int i = j % num_counters;
+        if (buf[2] > 0 && buf[2] < buf[1])
+            values[i] += (uint64_t)(double(buf[0]) * double(buf[1]) / double(buf[2]));
+        else
+            values[i] += buf[0];
+        }
+    #endif
+    }
+
+const char *PerfCounters::getName(unsigned int i)
+    {
+    switch (i)
+        {
+        case cycles:
+            return "cycles";
+        case instructions:
+            return "instructions";
+        case llc_misses:
+            return "LLC misses";
+        default:
+            return "";
+        }
+    }
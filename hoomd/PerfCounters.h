@@ -0,0 +1,99 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+/*! \file PerfCounters.h
+    \brief Declares the PerfCounters class
+*/
+
+#ifdef __HIPCC__
+#error This header cannot be compiled by nvcc
+#endif
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <vector>
+
+#ifndef __PERF_COUNTERS_H__
+#define __PERF_COUNTERS_H__
+
+class PerfCountersObserver;
+
+//! Hardware performance counters of the calling process
+/*! Opens the CPU cycle, retired instruction and last level cache miss counters with the Linux perf_event_open
+    system call. Each counted thread has its own set of counters, and read() returns the sum over all of them. The
+    thread that constructs the object is counted from the start. Other threads are counted after they call
+    attachThread(). In TBB enabled builds, a task scheduler observer attaches every thread that enters the task
+    scheduler, including the workers of a thread pool that was created before the counters. Work that a thread did
+    before it was attached is not counted.
+
+    The counters can be unavailable: on other operating systems, on virtual machines without a PMU, or when
+    /proc/sys/kernel/perf_event_paranoid forbids user space counting. isAvailable() reports this, and read()
+    returns zeros.
+
+    When the kernel multiplexes more counters than the hardware provides, the values are scaled by the fraction of
+    time each counter was active.
+
+    \ingroup utils
+*/
+class PerfCounters
+    {
+    public:
+        //! Available counters
+        enum counter
+            {
+            cycles = 0,     //!< CPU cycles
+            instructions,   //!< Retired instructions
+            llc_misses,     //!< Last level cache misses
+            num_counters
+            };
+
+        //! Size of a cache line, used to estimate memory traffic from cache misses
+        static const unsigned int cache_line_size = 64;
+
+        //! Open the counters
+        PerfCounters();
+
+        //! Close the counters
+        ~PerfCounters();
+
+        PerfCounters(const PerfCounters&) = delete;
+        PerfCounters& operator=(const PerfCounters&) = delete;
+
+        //! Check whether all counters could be opened
+        bool isAvailable() const
+            {
+            return m_available;
+            }
+
+        //! Count the calling thread
+        void attachThread();
+
+        //! Get the number of counted threads
+        unsigned int getNumThreads() const;
+
+        //! Read the current counter values, summed over all counted threads
+        /*! \param values Array of num_counters values to fill
+         */
+        void read(uint64_t *values) const;
+
+        //! Get the name of a counter
+        static const char *getName(unsigned int i);
+
+    private:
+        std::vector<int> m_fd;          //!< File descriptors of the counters, num_counters per counted thread
+        std::set<long> m_threads;       //!< Thread ids of the counted threads
+        mutable std::mutex m_mutex;     //!< Protects m_fd and m_threads
+        bool m_available;               //!< True if the counters of the constructing thread are open
+
+        #ifdef ENABLE_TBB
+        std::unique_ptr<PerfCountersObserver> m_observer;   //!< Attaches the TBB threads
+        #endif
+
+        //! Open the counters of the calling thread
+        bool openCounters(int *fd);
+    };
+
+#endif
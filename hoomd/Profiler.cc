@@ -10,8 +10,14 @@
 
 #include "Profiler.h"
 
+#ifdef ENABLE_MPI
+#include "HOOMDMPI.h"
+#endif
+
+#include <algorithm>
 #include <iomanip>
 #include <sstream>
+#include <vector>
 
 
 using namespace std;
@@ -69,6 +75,21 @@ int64_t ProfileDataElem::getTotalMemByteCount() const
     return total;
     }
 
+/*! \param total Array of PerfCounters::num_counters values to fill
+*/
+void ProfileDataElem::getChildCounterTotal(int64_t *total) const
+    {
+    for (unsigned int j = 0; j < PerfCounters::num_counters; j++)
+        total[j] = 0;
+
+    map<string, ProfileDataElem>::const_iterator i;
+    for (i = m_children.begin(); i != m_children.end(); ++i)
+        {
+        for (unsigned int j = 0; j < PerfCounters::num_counters; j++)
+            total[j] += (*i).second.m_counter_total[j];
+        }
+    }
+
 /*! Recursive output routine to write results from this profile node and all sub nodes printed in
     a tree.
     \param o stream to write output to
@@ -76,8 +97,10 @@ int64_t ProfileDataElem::getTotalMemByteCount() const
     \param tab_level Current number of tabs in the tree
     \param total_time Total number of nanoseconds taken by this node
     \param name_width Maximum name width for all siblings of this node (used to align output columns)
+    \param counters Set to true to output the hardware counters
  */
-void ProfileDataElem::output(std::ostream &o, const std::string& name, int tab_level, int64_t total_time, int name_width) const
+void ProfileDataElem::output(std::ostream &o, const std::string& name, int tab_level, int64_t total_time, int name_width,
+                             bool counters) const
     {
     // create a tab string to output for the current tab level
     string tabs = "";
@@ -98,7 +121,7 @@ void ProfileDataElem::output(std::ostream &o, const std::string& name, int tab_l
         bytes = double(getTotalMemByteCount())/sec;
         }
 
-    output_line(o, name, sec, perc, flops, bytes, name_width);
+    output_line(o, name, sec, perc, flops, bytes, name_width, counters ? m_counter_total : NULL);
 
     // start by determining the name width
     map<string, ProfileDataElem>::const_iterator i;
@@ -115,7 +138,7 @@ void ProfileDataElem::output(std::ostream &o, const std::string& name, int tab_l
     // output each of the children
     for (i = m_children.begin(); i != m_children.end(); ++i)
         {
-        (*i).second.output(o, (*i).first, tab_level+1, total_time, child_max_width);
+        (*i).second.output(o, (*i).first, tab_level+1, total_time, child_max_width, counters);
         }
 
     // output an "Self" item to account for time actually spent in this data elem
@@ -126,11 +149,16 @@ void ProfileDataElem::output(std::ostream &o, const std::string& name, int tab_l
         double flops = double(m_flop_count)/sec;
         double bytes = double(m_mem_byte_count)/sec;
 
+        int64_t self_counters[PerfCounters::num_counters];
+        getChildCounterTotal(self_counters);
+        for (unsigned int j = 0; j < PerfCounters::num_counters; j++)
+            self_counters[j] = m_counter_total[j] - self_counters[j];
+
         // don't print Self unless perc is significant
         if (perc >= 0.1)
             {
             o << tabs << "        ";
-            output_line(o, "Self", sec, perc, flops, bytes, child_max_width);
+            output_line(o, "Self", sec, perc, flops, bytes, child_max_width, counters ? self_counters : NULL);
             }
         }
     }
@@ -141,7 +169,8 @@ void ProfileDataElem::output_line(std::ostream &o,
                                   double perc,
                                   double flops,
                                   double bytes,
-                                  unsigned int name_width) const
+                                  unsigned int name_width,
+                                  const int64_t *counters) const
     {
     o << setiosflags(ios::fixed);
 
@@ -185,26 +214,57 @@ void ProfileDataElem::output_line(std::ostream &o,
             o << bytes/1e9 << " GiB/s ";
         }
 
+    // hardware counters, the bandwidth is estimated from one cache line per last level cache miss
+    if (counters)
+        {
+        double ipc = counters[PerfCounters::cycles] > 0 ?
+            double(counters[PerfCounters::instructions]) / double(counters[PerfCounters::cycles]) : 0.0;
+        double bw = double(counters[PerfCounters::llc_misses]) * PerfCounters::cache_line_size / sec;
+        o << "| IPC " << setprecision(2) << setw(4) << ipc;
+        o << " | " << setprecision(3) << setw(9) << double(counters[PerfCounters::llc_misses]) << " LLC misses";
+        o << " | ~" << setprecision(3) << setw(7) << bw/1e9 << " GiB/s ";
+        }
+
     o << endl;
     }
 
 ////////////////////////////////////////////////////////////////////
 // Profiler
 
-Profiler::Profiler(const std::string& name) : m_name(name)
+/*! \param name Name of the root category
+    \param perf_counters Set to true to record hardware performance counters
+
+    The counters are only recorded when they can be opened, check hasPerfCounters().
+*/
+Profiler::Profiler(const std::string& name, bool perf_counters) : m_name(name)
     {
     // push the root onto the top of the stack so that it is the default
     m_stack.push(&m_root);
 
+    if (perf_counters)
+        {
+        m_counters.reset(new PerfCounters());
+        if (!m_counters->isAvailable())
+            m_counters.reset();
+        }
+
     // record the start of this profile
     m_root.m_start_time = m_clk.getTime();
 
+    if (m_counters)
+        {
+        uint64_t values[PerfCounters::num_counters];
+        m_counters->read(values);
+        for (unsigned int i = 0; i < PerfCounters::num_counters; i++)
+            m_root.m_counter_start[i] = int64_t(values[i]);
+        }
+
     #ifdef SCOREP_USER_ENABLE
     SCOREP_USER_REGION_BEGIN(m_root.m_scorep_region, name.c_str(),SCOREP_USER_REGION_TYPE_COMMON )
     #endif
     }
 
-void Profiler::output(std::ostream &o)
+void Profiler::sampleRoot(std::ostream &o)
     {
     // perform a sanity check, but don't bail out
     if (m_stack.top() != &m_root)
@@ -219,9 +279,131 @@ void Profiler::output(std::ostream &o)
     // outputting a profile implicitly calls for a time sample
     m_root.m_elapsed_time = m_clk.getTime() - m_root.m_start_time;
 
+    if (m_counters)
+        {
+        uint64_t values[PerfCounters::num_counters];
+        m_counters->read(values);
+        for (unsigned int i = 0; i < PerfCounters::num_counters; i++)
+            m_root.m_counter_total[i] = int64_t(values[i]) - m_root.m_counter_start[i];
+        }
+    }
+
+void Profiler::output(std::ostream &o)
+    {
+    sampleRoot(o);
+
     // startup the recursive output process
-    m_root.output(o, m_name, 0, m_root.m_elapsed_time, (int)m_name.size());
+    m_root.output(o, m_name, 0, m_root.m_elapsed_time, (int)m_name.size(), hasPerfCounters());
+    }
+
+#ifdef ENABLE_MPI
+//! Flattened profile: the elapsed time and hardware counters of every category, keyed by its path in the tree
+typedef std::map<std::vector<std::string>, std::vector<int64_t> > FlatProfile;
+
+//! Helper function to flatten a profile tree
+static void flatten_profile(const ProfileDataElem& elem, std::vector<std::string>& path, FlatProfile& flat)
+    {
+    std::vector<int64_t>& values = flat[path];
+    values.push_back(elem.m_elapsed_time);
+    for (unsigned int i = 0; i < PerfCounters::num_counters; i++)
+        values.push_back(elem.m_counter_total[i]);
+
+    for (auto& child : elem.m_children)
+        {
+        path.push_back(child.first);
+        flatten_profile(child.second, path, flat);
+        path.pop_back();
+        }
+    }
+
+/*! \param o Stream to output to (only written on rank 0)
+    \param mpi_comm MPI communicator to aggregate over
+
+    Every category lists the minimum, mean and maximum over the ranks that executed it of its time and, when
+    hardware counters are enabled, of its instructions per cycle, last level cache misses and estimated memory
+    bandwidth. A category not executed on every rank shows the number of ranks that did. All ranks of \a mpi_comm
+    must call this method.
+*/
+void Profiler::outputAggregated(std::ostream &o, const MPI_Comm mpi_comm)
+    {
+    sampleRoot(o);
+
+    FlatProfile flat;
+    std::vector<std::string> path(1, m_name);
+    flatten_profile(m_root, path, flat);
+
+    // counters are only aggregated if all ranks have them
+    unsigned int counters = hasPerfCounters();
+    MPI_Allreduce(MPI_IN_PLACE, &counters, 1, MPI_UNSIGNED, MPI_MIN, mpi_comm);
+
+    std::vector<FlatProfile> flat_ranks;
+    gather_v(flat, flat_ranks, 0, mpi_comm);
+
+    int rank;
+    MPI_Comm_rank(mpi_comm, &rank);
+    if (rank != 0)
+        return;
+
+    // collect the values of each category over ranks, ordered as a depth-first traversal of the tree
+    std::map<std::vector<std::string>, std::vector<std::vector<int64_t> > > merged;
+    for (const FlatProfile& flat_rank : flat_ranks)
+        for (auto& entry : flat_rank)
+            merged[entry.first].push_back(entry.second);
+
+    o << m_name << " over " << flat_ranks.size() << " ranks (min / mean / max)" << endl;
+    o << setiosflags(ios::fixed);
+    for (auto& entry : merged)
+        {
+        const std::vector<std::string>& key = entry.first;
+        const std::vector<std::vector<int64_t> >& values = entry.second;
+
+        for (unsigned int i = 1; i < key.size(); i++)
+            o << "    ";
+        o << key.back() << ":";
+        if (values.size() != flat_ranks.size())
+            o << " (" << values.size() << " ranks)";
+        o << endl;
+
+        // compute the statistics of the time and each derived counter quantity
+        std::vector<double> sec, ipc, misses, bw;
+        for (const std::vector<int64_t>& v : values)
+            {
+            double s = double(v[0])/1e9;
+            sec.push_back(s);
+            if (counters)
+                {
+                const int64_t *c = &v[1];
+                ipc.push_back(c[PerfCounters::cycles] > 0 ?
+                    double(c[PerfCounters::instructions]) / double(c[PerfCounters::cycles]) : 0.0);
+                misses.push_back(double(c[PerfCounters::llc_misses]));
+                bw.push_back(s > 0 ? double(c[PerfCounters::llc_misses]) * PerfCounters::cache_line_size / s / 1e9
+                                   : 0.0);
+                }
+            }
+
+        auto output_stat = [&](const std::string& label, const std::vector<double>& x, int precision,
+                               const std::string& unit)
+            {
+            if (x.empty())
+                return;
+            double sum = 0.0;
+            for (double xi : x)
+                sum += xi;
+            for (unsigned int i = 0; i < key.size(); i++)
+                o << "    ";
+            o << setw(12) << left << label << right << setprecision(precision)
+              << setw(12) << *std::min_element(x.begin(), x.end()) << " / "
+              << setw(12) << sum/double(x.size()) << " / "
+              << setw(12) << *std::max_element(x.begin(), x.end()) << unit << endl;
+            };
+
+        output_stat("time", sec, 4, " s");
+        output_stat("IPC", ipc, 2, "");
+        output_stat("LLC misses", misses, 0, "");
+        output_stat("~bandwidth", bw, 3, " GiB/s");
+        }
     }
+#endif
 
 /*! \param o Stream to output to
     \param prof Profiler to print
@@ -248,7 +430,7 @@ string print_profiler(Profiler *prof)
 void export_Profiler(py::module& m)
     {
     py::class_<Profiler>(m,"Profiler")
-    .def(py::init<const std::string&>())
+    .def(py::init<const std::string&, bool>(), py::arg("name"), py::arg("perf_counters")=false)
     .def("__str__", &print_profiler)
     ;
     }
@@ -14,6 +14,7 @@
 
 #include "ExecutionConfiguration.h"
 #include "ClockSource.h"
+#include "PerfCounters.h"
 
 #ifdef ENABLE_HIP
 #include <hip/hip_runtime.h>
@@ -26,6 +27,7 @@
 #include <string>
 #include <stack>
 #include <map>
+#include <memory>
 #include <iostream>
 #include <cassert>
 
@@ -67,7 +69,13 @@ class PYBIND11_EXPORT ProfileDataElem
             #ifdef SCOREP_USER_ENABLE
             , m_scorep_region(SCOREP_USER_INVALID_REGION)
             #endif
-            {}
+            {
+            for (unsigned int i = 0; i < PerfCounters::num_counters; i++)
+                {
+                m_counter_start[i] = 0;
+                m_counter_total[i] = 0;
+                }
+            }
 
         //! Returns the total elapsed time of this nodes children
         int64_t getChildElapsedTime() const;
@@ -75,9 +83,12 @@ class PYBIND11_EXPORT ProfileDataElem
         int64_t getTotalFlopCount() const;
         //! Returns the total memory byte count of this node + children
         int64_t getTotalMemByteCount() const;
+        //! Returns the hardware counter totals of this nodes children
+        void getChildCounterTotal(int64_t *total) const;
 
         //! Output helper function
-        void output(std::ostream &o, const std::string &name, int tab_level, int64_t total_time, int name_width) const;
+        void output(std::ostream &o, const std::string &name, int tab_level, int64_t total_time, int name_width,
+                    bool counters) const;
         //! Another output helper function
         void output_line(std::ostream &o,
                          const std::string &name,
@@ -85,7 +96,8 @@ class PYBIND11_EXPORT ProfileDataElem
                          double perc,
                          double flops,
                          double bytes,
-                         unsigned int name_width) const;
+                         unsigned int name_width,
+                         const int64_t *counters) const;
 
         std::map<std::string, ProfileDataElem> m_children; //!< Child nodes of this profile
 
@@ -94,6 +106,9 @@ class PYBIND11_EXPORT ProfileDataElem
         int64_t m_flop_count;   //!< A running total of floating point operations
         int64_t m_mem_byte_count;   //!< A running total of memory bytes transferred
 
+        int64_t m_counter_start[PerfCounters::num_counters];    //!< Hardware counters at the most recent push
+        int64_t m_counter_total[PerfCounters::num_counters];    //!< Running totals of the hardware counters
+
         #ifdef SCOREP_USER_ENABLE
         SCOREP_User_RegionHandle m_scorep_region;   //!< ScoreP region identifier
         #endif
@@ -117,14 +132,27 @@ class PYBIND11_EXPORT ProfileDataElem
     These methods automatically synchronize with the asynchronous GPU execution stream in order
     to provide accurate timing information.
 
-    These profiles can of course be output via normal ostream operators.
+    When constructed with \a perf_counters, every push() and pop() also samples the hardware performance
+    counters (see PerfCounters) and the output adds the instructions per cycle, the last level cache misses and
+    an estimate of the memory bandwidth (one cache line per miss) of each category. The counters are summed over all
+    threads that execute TBB tasks. Reading the counters costs a few system calls per thread, so only enable them
+    for profiling runs.
+
+    These profiles can of course be output via normal ostream operators. With MPI, outputAggregated() combines
+    the profiles of all ranks.
     \ingroup utils
     */
 class PYBIND11_EXPORT Profiler
     {
     public:
         //! Constructs an empty profiler and starts its timer ticking
-        Profiler(const std::string& name = "Profile");
+        Profiler(const std::string& name = "Profile", bool perf_counters = false);
+
+        //! Check whether hardware performance counters are being recorded
+        bool hasPerfCounters() const
+            {
+            return bool(m_counters);
+            }
         //! Pushes a new sub-category into the current category
         void push(const std::string& name);
         //! Pops back up to the next super-category
@@ -135,11 +163,20 @@ class PYBIND11_EXPORT Profiler
         //! Pops back up to the next super-category & syncs the GPUs
         void pop(std::shared_ptr<const ExecutionConfiguration> exec_conf, uint64_t flop_count = 0, uint64_t byte_count = 0);
 
+        #ifdef ENABLE_MPI
+        //! Output the minimum, mean and maximum over all ranks of every category
+        void outputAggregated(std::ostream &o, const MPI_Comm mpi_comm);
+        #endif
+
     private:
         ClockSource m_clk;  //!< Clock to provide timing information
         std::string m_name; //!< The name of this profile
         ProfileDataElem m_root; //!< The root profile element
         std::stack<ProfileDataElem *> m_stack;  //!< A stack of data elements for the push/pop structure
+        std::unique_ptr<PerfCounters> m_counters;   //!< Hardware counters (null when disabled or unavailable)
+
+        //! Take the final time and counter sample of the root element
+        void sampleRoot(std::ostream &o);
 
         //! Output helper function
         void output(std::ostream &o);
@@ -201,14 +238,23 @@ inline void Profiler::push(const std::string& name)
     ProfileDataElem *cur = m_stack.top();
 
     // then creating (or accessing) the named sample and setting the start time
-    cur->m_children[name].m_start_time = t;
+    ProfileDataElem& child = cur->m_children[name];
+    child.m_start_time = t;
+
+    if (m_counters)
+        {
+        uint64_t values[PerfCounters::num_counters];
+        m_counters->read(values);
+        for (unsigned int i = 0; i < PerfCounters::num_counters; i++)
+            child.m_counter_start[i] = int64_t(values[i]);
+        }
 
     // and updating the stack
-    m_stack.push(&cur->m_children[name]);
+    m_stack.push(&child);
 
     #ifdef SCOREP_USER_ENABLE
     // log Score-P region
-    SCOREP_USER_REGION_BEGIN( cur->m_children[name].m_scorep_region, name.c_str(),SCOREP_USER_REGION_TYPE_COMMON )
+    SCOREP_USER_REGION_BEGIN( child.m_scorep_region, name.c_str(),SCOREP_USER_REGION_TYPE_COMMON )
     #endif
     }
 
@@ -232,6 +278,14 @@ inline void Profiler::pop(uint64_t flop_count, uint64_t byte_count)
     #endif
     cur->m_elapsed_time += t - cur->m_start_time;
 
+    if (m_counters)
+        {
+        uint64_t values[PerfCounters::num_counters];
+        m_counters->read(values);
+        for (unsigned int i = 0; i < PerfCounters::num_counters; i++)
+            cur->m_counter_total[i] += int64_t(values[i]) - cur->m_counter_start[i];
+        }
+
     // and increasing the flop and mem counters
     cur->m_flop_count += flop_count;
     cur->m_mem_byte_count += byte_count;
@@ -24,6 +24,7 @@ namespace hoomd {
 struct RNGIdentifier
     {
     static const uint32_t ComputeFreeVolume = 0x23ed56f2;
+    static const uint32_t ComputeFreeVolumeShift = 0x5e6f7a31;
     static const uint32_t HPMCMonoShuffle = 0xfa870af6;
     static const uint32_t HPMCMonoTrialMove = 0x754dea60;
     static const uint32_t HPMCMonoShift = 0xf4a3210e;
@@ -95,8 +95,12 @@ void SFCPackTuner::update(unsigned int timestep)
     // apply that sort order to the particles
     applySortOrder();
 
-    // trigger sort signal (this also forces particle migration)
-    m_pdata->notifyParticleSort();
+    // trigger sort signal (this also forces particle migration), along with the permutation if it is known on the host
+    if (m_new_idx.size() == m_pdata->getN())
+        m_pdata->notifyParticleSort(m_pdata->getN(), m_new_idx);
+    else
+        m_pdata->notifyParticleSort();
+    m_new_idx.clear();
 
     #ifdef ENABLE_MPI
     if (m_comm)
@@ -123,7 +127,7 @@ void SFCPackTuner::applySortOrder()
     ArrayHandle<Scalar4> h_angmom(m_pdata->getAngularMomentumArray(), access_location::host, access_mode::readwrite);
     ArrayHandle<Scalar3> h_inertia(m_pdata->getMomentsOfInertiaArray(), access_location::host, access_mode::readwrite);
     ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::readwrite);
-    ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::readwrite);
+    TagIndexHandle h_rtag(*m_pdata, access_mode::readwrite);
 
     // construct a temporary holding array for the sorted data
     Scalar4 *scal4_tmp = new Scalar4[m_pdata->getN()];
@@ -239,9 +243,14 @@ void SFCPackTuner::applySortOrder()
     // rebuild global rtag
     for (unsigned int i = 0; i < m_pdata->getN(); i++)
         {
-        h_rtag.data[h_tag.data[i]] = i;
+        h_rtag.set(h_tag.data[i], i);
         }
 
+    // record the new index of every particle for the listeners
+    m_new_idx.resize(m_pdata->getN());
+    for (unsigned int i = 0; i < m_pdata->getN(); i++)
+        m_new_idx[m_sort_order[i]] = i;
+
     delete[] scal_tmp;
     delete[] scal4_tmp;
     delete[] scal3_tmp;
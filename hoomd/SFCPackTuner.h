@@ -106,6 +106,7 @@ class PYBIND11_EXPORT SFCPackTuner : public Tuner
 
     private:
         std::vector<unsigned int> m_sort_order;             //!< Generated sort order of the particles
+        std::vector<unsigned int> m_new_idx;                //!< New index of every particle after the sort
         std::vector< std::pair<unsigned int, unsigned int> > m_particle_bins;    //!< Binned particles
         std::shared_ptr<Trigger> m_trigger;
 
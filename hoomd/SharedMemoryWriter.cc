@@ -0,0 +1,348 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+/*! \file SharedMemoryWriter.cc
+    \brief Defines the SharedMemoryWriter class
+*/
+
+#include "SharedMemoryWriter.h"
+
+#ifdef ENABLE_MPI
+#include "Communicator.h"
+#endif
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+using namespace std;
+namespace py = pybind11;
+
+static_assert(sizeof(std::atomic<uint64_t>) == sizeof(uint64_t), "atomic<uint64_t> must not add storage");
+
+//! Round up to a multiple of the cache line size
+static uint64_t align_cache_line(uint64_t offset)
+    {
+    return (offset + 63) & ~uint64_t(63);
+    }
+
+//! Atomic view of a 64 bit counter in the shared memory segment
+static std::atomic<uint64_t>& as_atomic(uint64_t& value)
+    {
+    return *reinterpret_cast<std::atomic<uint64_t>*>(&value);
+    }
+
+/*! \param sysdef SystemDefinition containing the ParticleData to publish
+    \param name Name of the shared memory segment (without the leading /)
+    \param group Group of particles to include in the frames
+    \param n_slots Number of frames in the ring buffer
+
+    The segment is not created until analyze() is called.
+*/
+SharedMemoryWriter::SharedMemoryWriter(std::shared_ptr<SystemDefinition> sysdef,
+                                       const std::string& name,
+                                       std::shared_ptr<ParticleGroup> group,
+                                       unsigned int n_slots)
+    : Analyzer(sysdef), m_name(name), m_group(group), m_n_slots(n_slots), m_frame(0),
+      m_segment(nullptr), m_segment_bytes(0), m_header(nullptr)
+    {
+    m_exec_conf->msg->notice(5) << "Constructing SharedMemoryWriter: " << name << " " << n_slots << endl;
+
+    if (name.empty() || name.find('/') != std::string::npos || name.size() > 250)
+        {
+        m_exec_conf->msg->error() << "write.SharedMemory: Invalid segment name " << name << endl;
+        throw std::invalid_argument("Invalid shared memory segment name");
+        }
+
+    if (n_slots < 2)
+        {
+        m_exec_conf->msg->error() << "write.SharedMemory: n_slots must be at least 2" << endl;
+        throw std::invalid_argument("Invalid number of shared memory slots");
+        }
+
+    m_log_writer = pybind11::none();
+    }
+
+SharedMemoryWriter::~SharedMemoryWriter()
+    {
+    m_exec_conf->msg->notice(5) << "Destroying SharedMemoryWriter" << endl;
+    destroySegment();
+    }
+
+/*! \param log_names Names of the log quantities stored in every frame
+
+    An existing segment with the same name, e.g. left behind by a crashed run, is replaced.
+*/
+void SharedMemoryWriter::createSegment(const std::vector<std::string>& log_names)
+    {
+    m_log_names = log_names;
+    unsigned int max_N = m_group->getNumMembersGlobal();
+    unsigned int n_types = m_pdata->getNTypes();
+    unsigned int n_log = (unsigned int)m_log_names.size();
+
+    uint64_t names_offset = align_cache_line(sizeof(shm_header));
+    uint64_t slot_offset = align_cache_line(names_offset + uint64_t(n_types + n_log) * shm_name_length);
+    uint64_t position_offset = align_cache_line(sizeof(shm_slot_header));
+    uint64_t orientation_offset = align_cache_line(position_offset + uint64_t(max_N) * 3 * sizeof(float));
+    uint64_t typeid_offset = align_cache_line(orientation_offset + uint64_t(max_N) * 4 * sizeof(float));
+    uint64_t log_offset = align_cache_line(typeid_offset + uint64_t(max_N) * sizeof(uint32_t));
+    uint64_t slot_bytes = align_cache_line(log_offset + uint64_t(n_log) * sizeof(double));
+    m_segment_bytes = slot_offset + slot_bytes * m_n_slots;
+
+    std::string shm_name = "/" + m_name;
+    shm_unlink(shm_name.c_str());
+    int fd = shm_open(shm_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0)
+        {
+        m_exec_conf->msg->error() << "write.SharedMemory: Unable to create shared memory segment " << shm_name
+                                  << ": " << strerror(errno) << endl;
+        throw std::runtime_error("Error creating shared memory segment");
+        }
+
+    if (ftruncate(fd, m_segment_bytes) != 0)
+        {
+        int err = errno;
+        close(fd);
+        shm_unlink(shm_name.c_str());
+        m_exec_conf->msg->error() << "write.SharedMemory: Unable to allocate " << m_segment_bytes
+                                  << " bytes of shared memory: " << strerror(err) << endl;
+        throw std::runtime_error("Error creating shared memory segment");
+        }
+
+    void *segment = mmap(nullptr, m_segment_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (segment == MAP_FAILED)
+        {
+        shm_unlink(shm_name.c_str());
+        m_exec_conf->msg->error() << "write.SharedMemory: Unable to map shared memory segment " << shm_name
+                                  << ": " << strerror(errno) << endl;
+        throw std::runtime_error("Error creating shared memory segment");
+        }
+    m_segment = segment;
+
+    // the new segment is zero filled, which marks all slots as empty
+    m_header = reinterpret_cast<shm_header*>(m_segment);
+    m_header->version = 1;
+    m_header->n_slots = m_n_slots;
+    m_header->slot_offset = slot_offset;
+    m_header->slot_bytes = slot_bytes;
+    m_header->max_N = max_N;
+    m_header->n_types = n_types;
+    m_header->n_log = n_log;
+    m_header->dimensions = m_sysdef->getNDimensions();
+    m_header->position_offset = position_offset;
+    m_header->orientation_offset = orientation_offset;
+    m_header->typeid_offset = typeid_offset;
+    m_header->log_offset = log_offset;
+
+    char *names = reinterpret_cast<char*>(m_segment) + names_offset;
+    for (unsigned int i = 0; i < n_types; i++)
+        strncpy(names + i * shm_name_length, m_pdata->getNameByType(i).c_str(), shm_name_length - 1);
+    for (unsigned int i = 0; i < n_log; i++)
+        strncpy(names + (n_types + i) * shm_name_length, m_log_names[i].c_str(), shm_name_length - 1);
+
+    // readers check the magic last
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(m_header->magic, "HOOMDSHM", 8);
+
+    m_exec_conf->msg->notice(2) << "write.SharedMemory: Created shared memory segment " << shm_name << " ("
+                                << m_segment_bytes << " bytes)" << endl;
+    }
+
+void SharedMemoryWriter::destroySegment()
+    {
+    if (!m_segment)
+        return;
+
+    munmap(m_segment, m_segment_bytes);
+    shm_unlink(("/" + m_name).c_str());
+    m_segment = nullptr;
+    m_header = nullptr;
+    }
+
+/*! \param slot Slot to write to
+
+    Copies the positions directly from the local particle data into the segment, without an intermediate snapshot.
+*/
+void SharedMemoryWriter::writeParticlesLocal(char *slot)
+    {
+    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
+    TagIndexHandle h_rtag(*m_pdata, access_mode::read);
+
+    float *position = reinterpret_cast<float*>(slot + m_header->position_offset);
+    float *orientation = reinterpret_cast<float*>(slot + m_header->orientation_offset);
+    uint32_t *type_id = reinterpret_cast<uint32_t*>(slot + m_header->typeid_offset);
+
+    unsigned int N = m_group->getNumMembersGlobal();
+    for (unsigned int group_idx = 0; group_idx < N; group_idx++)
+        {
+        unsigned int idx = h_rtag[m_group->getMemberTag(group_idx)];
+        Scalar4 postype = h_pos.data[idx];
+        Scalar4 q = h_orientation.data[idx];
+
+        position[group_idx*3 + 0] = float(postype.x);
+        position[group_idx*3 + 1] = float(postype.y);
+        position[group_idx*3 + 2] = float(postype.z);
+        orientation[group_idx*4 + 0] = float(q.x);
+        orientation[group_idx*4 + 1] = float(q.y);
+        orientation[group_idx*4 + 2] = float(q.z);
+        orientation[group_idx*4 + 3] = float(q.w);
+        type_id[group_idx] = __scalar_as_int(postype.w);
+        }
+    }
+
+/*! \param slot Slot to write to
+    \param snapshot Snapshot of the particle data, gathered to the root rank
+    \param map Map from particle tag to snapshot index
+*/
+void SharedMemoryWriter::writeParticlesSnapshot(char *slot,
+                                                const SnapshotParticleData<float>& snapshot,
+                                                const std::map<unsigned int, unsigned int>& map)
+    {
+    float *position = reinterpret_cast<float*>(slot + m_header->position_offset);
+    float *orientation = reinterpret_cast<float*>(slot + m_header->orientation_offset);
+    uint32_t *type_id = reinterpret_cast<uint32_t*>(slot + m_header->typeid_offset);
+
+    unsigned int N = m_group->getNumMembersGlobal();
+    for (unsigned int group_idx = 0; group_idx < N; group_idx++)
+        {
+        auto it = map.find(m_group->getMemberTag(group_idx));
+        assert(it != map.end());
+        unsigned int idx = it->second;
+
+        position[group_idx*3 + 0] = snapshot.pos[idx].x;
+        position[group_idx*3 + 1] = snapshot.pos[idx].y;
+        position[group_idx*3 + 2] = snapshot.pos[idx].z;
+        orientation[group_idx*4 + 0] = snapshot.orientation[idx].s;
+        orientation[group_idx*4 + 1] = snapshot.orientation[idx].v.x;
+        orientation[group_idx*4 + 2] = snapshot.orientation[idx].v.y;
+        orientation[group_idx*4 + 3] = snapshot.orientation[idx].v.z;
+        type_id[group_idx] = snapshot.type[idx];
+        }
+    }
+
+/*! \param timestep Current time step of the simulation
+
+    The first call to analyze() creates the shared memory segment. Every call fills the next slot of the ring buffer
+    and then publishes it by incrementing the frame counter in the header.
+*/
+void SharedMemoryWriter::analyze(unsigned int timestep)
+    {
+    if (m_prof)
+        m_prof->push("Dump shared memory");
+
+    // evaluate the log quantities on all ranks, computing them may require communication
+    std::vector<std::string> log_names;
+    std::vector<double> log_values;
+    if (!m_log_writer.is_none())
+        {
+        py::dict log = m_log_writer.attr("log")();
+        for (auto item : log)
+            {
+            log_names.push_back(py::cast<std::string>(item.first));
+            log_values.push_back(py::cast<double>(item.second));
+            }
+        }
+
+    bool root = true;
+    bool gather = false;
+#ifdef ENABLE_MPI
+    root = m_exec_conf->isRoot();
+    gather = bool(m_pdata->getDomainDecomposition());
+#endif
+
+    // gather the particles to the root rank when the system is decomposed
+    SnapshotParticleData<float> snapshot;
+    std::map<unsigned int, unsigned int> map;
+    if (gather)
+        map = m_pdata->takeSnapshot<float>(snapshot);
+
+    if (!root)
+        {
+        if (m_prof)
+            m_prof->pop();
+        return;
+        }
+
+    if (!m_segment)
+        createSegment(log_names);
+
+    unsigned int N = m_group->getNumMembersGlobal();
+    if (N > m_header->max_N)
+        {
+        m_exec_conf->msg->error() << "write.SharedMemory: The number of particles (" << N
+                                  << ") exceeds the size of the shared memory segment (" << m_header->max_N << ")"
+                                  << endl;
+        throw std::runtime_error("Error writing shared memory frame");
+        }
+
+    char *slot = reinterpret_cast<char*>(m_segment) + m_header->slot_offset
+                 + (m_frame % m_n_slots) * m_header->slot_bytes;
+    shm_slot_header *slot_header = reinterpret_cast<shm_slot_header*>(slot);
+
+    // mark the slot as being written before touching its contents
+    as_atomic(slot_header->seq).store(2*m_frame + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    const BoxDim& box = m_pdata->getGlobalBox();
+    Scalar3 L = box.getL();
+    slot_header->timestep = timestep;
+    slot_header->N = N;
+    slot_header->box[0] = L.x;
+    slot_header->box[1] = L.y;
+    slot_header->box[2] = L.z;
+    slot_header->box[3] = box.getTiltFactorXY();
+    slot_header->box[4] = box.getTiltFactorXZ();
+    slot_header->box[5] = box.getTiltFactorYZ();
+
+    if (gather)
+        writeParticlesSnapshot(slot, snapshot, map);
+    else
+        writeParticlesLocal(slot);
+
+    // quantities that are no longer logged are published as NaN
+    double *log = reinterpret_cast<double*>(slot + m_header->log_offset);
+    for (unsigned int i = 0; i < m_log_names.size(); i++)
+        {
+        log[i] = std::numeric_limits<double>::quiet_NaN();
+        for (unsigned int j = 0; j < log_names.size(); j++)
+            {
+            if (log_names[j] == m_log_names[i])
+                {
+                log[i] = log_values[j];
+                break;
+                }
+            }
+        }
+
+    // publish the frame
+    as_atomic(slot_header->seq).store(2*m_frame + 2, std::memory_order_release);
+    as_atomic(m_header->frame).store(m_frame + 1, std::memory_order_release);
+    m_frame++;
+
+    if (m_prof)
+        m_prof->pop();
+    }
+
+void export_SharedMemoryWriter(py::module& m)
+    {
+    py::class_<SharedMemoryWriter, Analyzer, std::shared_ptr<SharedMemoryWriter> >(m, "SharedMemoryWriter")
+        .def(py::init< std::shared_ptr<SystemDefinition>, std::string, std::shared_ptr<ParticleGroup>,
+                       unsigned int>())
+        .def_property("log_writer", &SharedMemoryWriter::getLogWriter, &SharedMemoryWriter::setLogWriter)
+        .def_property_readonly("name", &SharedMemoryWriter::getName)
+        .def_property_readonly("n_slots", &SharedMemoryWriter::getNSlots)
+        .def_property_readonly("filter", [](const std::shared_ptr<SharedMemoryWriter> writer)
+                                             {
+                                             return writer->getGroup()->getFilter();
+                                             })
+    ;
+    }
@@ -0,0 +1,165 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#pragma once
+
+#include "Analyzer.h"
+#include "ParticleGroup.h"
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+/*! \file SharedMemoryWriter.h
+    \brief Declares the SharedMemoryWriter class
+*/
+
+#ifdef __HIPCC__
+#error This header cannot be compiled by nvcc
+#endif
+
+#include <pybind11/pybind11.h>
+
+//! Header at the start of the shared memory segment written by SharedMemoryWriter
+/*! All offsets are in bytes from the start of the segment. The names of the particle types and the log quantities
+    follow the header as null terminated strings of shm_name_length bytes each. The frame slots follow the names.
+*/
+struct shm_header
+    {
+    char magic[8];              //!< "HOOMDSHM"
+    uint32_t version;           //!< Layout version
+    uint32_t n_slots;           //!< Number of frame slots in the ring buffer
+    uint64_t slot_offset;       //!< Offset of the first slot
+    uint64_t slot_bytes;        //!< Size of one slot
+    uint32_t max_N;             //!< Maximum number of particles in a frame
+    uint32_t n_types;           //!< Number of particle type names
+    uint32_t n_log;             //!< Number of log quantities per frame
+    uint32_t dimensions;        //!< Dimensionality of the system
+    uint64_t frame;             //!< Number of frames completely written (accessed atomically)
+    uint64_t position_offset;   //!< Offset of the positions (float, max_N*3) within a slot
+    uint64_t orientation_offset;//!< Offset of the orientations (float, max_N*4) within a slot
+    uint64_t typeid_offset;     //!< Offset of the type ids (uint32, max_N) within a slot
+    uint64_t log_offset;        //!< Offset of the log quantities (double, n_log) within a slot
+    };
+
+//! Header at the start of every frame slot
+/*! \a seq is odd while the writer fills the slot with frame f (seq = 2f+1) and even when the slot holds the complete
+    frame f (seq = 2f+2). Readers copy the slot and accept the copy when \a seq has the same even value before and
+    after.
+*/
+struct shm_slot_header
+    {
+    uint64_t seq;               //!< Sequence number (accessed atomically)
+    uint64_t timestep;          //!< Time step of the frame
+    uint32_t N;                 //!< Number of particles in the frame
+    uint32_t reserved;          //!< Padding
+    double box[6];              //!< Lx, Ly, Lz, xy, xz, yz
+    };
+
+//! Length of the type and log quantity names in the shared memory segment, including the terminating null
+const unsigned int shm_name_length = 64;
+
+//! Analyzer that publishes frames to a POSIX shared memory ring buffer
+/*! SharedMemoryWriter copies the positions, orientations and type ids of the particles in the group, in tag order,
+    and a set of scalar log quantities into a POSIX shared memory segment every time analyze() is called. Analysis
+    processes on the same node map the segment and read frames in place, without any serialization or file system
+    traffic.
+
+    The segment holds a ring buffer of \a n_slots frames and is protected by a sequence lock per slot. The writer
+    never waits for readers: a reader that falls more than \a n_slots - 1 frames behind detects the overwritten slot by
+    its sequence number and skips ahead. The layout is given by shm_header and shm_slot_header.
+
+    The segment is created on the first call to analyze(), sized for the number of particles in the group and the log
+    quantities present at that time, and unlinked when the writer is destroyed. With domain decomposition, the frame
+    is gathered to and written by the root rank.
+
+    \ingroup analyzers
+*/
+class PYBIND11_EXPORT SharedMemoryWriter : public Analyzer
+    {
+    public:
+        //! Construct the writer
+        SharedMemoryWriter(std::shared_ptr<SystemDefinition> sysdef,
+                           const std::string& name,
+                           std::shared_ptr<ParticleGroup> group,
+                           unsigned int n_slots);
+
+        //! Destructor
+        ~SharedMemoryWriter();
+
+        //! Publish the data for the current timestep
+        void analyze(unsigned int timestep);
+
+        std::string getName()
+            {
+            return m_name;
+            }
+
+        unsigned int getNSlots()
+            {
+            return m_n_slots;
+            }
+
+        std::shared_ptr<ParticleGroup> getGroup()
+            {
+            return m_group;
+            }
+
+        /// Set the log writer
+        void setLogWriter(pybind11::object log_writer)
+            {
+            m_log_writer = log_writer;
+            }
+
+        /// Get the log writer
+        pybind11::object getLogWriter()
+            {
+            return m_log_writer;
+            }
+
+        /// Get needed pdata flags
+        virtual PDataFlags getRequestedPDataFlags()
+            {
+            PDataFlags flags;
+
+            if (!m_log_writer.is_none())
+                {
+                flags.set();
+                }
+
+            return flags;
+            }
+
+    private:
+        std::string m_name;                     //!< Name of the shared memory segment
+        std::shared_ptr<ParticleGroup> m_group; //!< Group of particles to publish
+        unsigned int m_n_slots;                 //!< Number of frame slots
+        uint64_t m_frame;                       //!< Index of the next frame
+
+        void *m_segment;                        //!< Mapped shared memory segment
+        size_t m_segment_bytes;                 //!< Size of the mapped segment
+        shm_header *m_header;                   //!< Header of the segment
+
+        std::vector<std::string> m_log_names;   //!< Names of the log quantities, fixed when the segment is created
+
+        /// Callback returning a dict of the scalar log quantities
+        pybind11::object m_log_writer;
+
+        //! Create the shared memory segment
+        void createSegment(const std::vector<std::string>& log_names);
+
+        //! Unmap and unlink the shared memory segment
+        void destroySegment();
+
+        //! Write the particles of the group into a slot from the local particle data
+        void writeParticlesLocal(char *slot);
+
+        //! Write the particles of the group into a slot from a snapshot
+        void writeParticlesSnapshot(char *slot,
+                                    const SnapshotParticleData<float>& snapshot,
+                                    const std::map<unsigned int, unsigned int>& map);
+    };
+
+//! Exports the SharedMemoryWriter class to python
+void export_SharedMemoryWriter(pybind11::module& m);
@@ -16,6 +16,7 @@
 #endif
 
 // #include <pybind11/pybind11.h>
+#include <sstream>
 #include <stdexcept>
 #include <time.h>
 #include <pybind11/cast.h>
@@ -43,7 +44,7 @@ PyObject* walltimeLimitExceptionTypeObj = 0;
 */
 System::System(std::shared_ptr<SystemDefinition> sysdef, unsigned int initial_tstep)
         : m_sysdef(sysdef), m_start_tstep(initial_tstep), m_end_tstep(0), m_cur_tstep(initial_tstep),
-          m_profile(false)
+          m_profile(false), m_profile_counters(false)
     {
     // sanity check
     assert(m_sysdef);
@@ -94,6 +95,7 @@ void System::run(unsigned int nsteps, bool write_at_start)
     // initialize the last status time
     m_initial_time = m_clk.getTime();
     setupProfiling();
+    setupInstrumentation();
 
     // preset the flags before the run loop so that any analyzers/updaters run on step 0 have the info they need
     // but set the flags before prepRun, as prepRun may remove some flags that it cannot generate on the first step
@@ -118,30 +120,44 @@ void System::run(unsigned int nsteps, bool write_at_start)
         m_integrator->prepRun(m_cur_tstep);
         }
 
+    Instrumentation *instrumentation = m_instrumentation.get();
+
     // execute analyzers on initial step if requested
     if (write_at_start)
         {
-        for (auto &analyzer_trigger_pair: m_analyzers)
+        for (unsigned int i = 0; i < m_analyzers.size(); i++)
             {
+            auto &analyzer_trigger_pair = m_analyzers[i];
             if ((*analyzer_trigger_pair.second)(m_cur_tstep))
+                {
+                Instrumentation::ScopedRegion region(instrumentation, m_analyzer_regions[i]);
                 analyzer_trigger_pair.first->analyze(m_cur_tstep);
+                }
             }
         }
 
     // run the steps
     for (unsigned int count = 0; count < nsteps; count++)
         {
-        for (auto &tuner: m_tuners)
+        for (unsigned int i = 0; i < m_tuners.size(); i++)
             {
+            auto &tuner = m_tuners[i];
             if ((*tuner->getTrigger())(m_cur_tstep))
+                {
+                Instrumentation::ScopedRegion region(instrumentation, m_tuner_regions[i]);
                 tuner->update(m_cur_tstep);
+                }
             }
 
         // execute updaters
-        for (auto &updater_trigger_pair: m_updaters)
+        for (unsigned int i = 0; i < m_updaters.size(); i++)
             {
+            auto &updater_trigger_pair = m_updaters[i];
             if ((*updater_trigger_pair.second)(m_cur_tstep))
+                {
+                Instrumentation::ScopedRegion region(instrumentation, m_updater_regions[i]);
                 updater_trigger_pair.first->update(m_cur_tstep);
+                }
             }
 
         // look ahead to the next time step and see which analyzers and updaters will be executed
@@ -150,22 +166,38 @@ void System::run(unsigned int nsteps, bool write_at_start)
 
         // execute the integrator
         if (m_integrator)
+            {
+            // the integrator may finish this step together with the next one when nothing runs in between
+            m_integrator->setDeferStepEnd(count + 1 < nsteps && isIdleStep(m_cur_tstep+1));
+
+            Instrumentation::ScopedRegion region(instrumentation, m_integrator_region);
             m_integrator->update(m_cur_tstep);
+            }
 
         m_cur_tstep++;
 
         // execute analyzers after incrementing the step counter
-        for (auto &analyzer_trigger_pair: m_analyzers)
+        for (unsigned int i = 0; i < m_analyzers.size(); i++)
             {
+            auto &analyzer_trigger_pair = m_analyzers[i];
             if ((*analyzer_trigger_pair.second)(m_cur_tstep))
+                {
+                Instrumentation::ScopedRegion region(instrumentation, m_analyzer_regions[i]);
                 analyzer_trigger_pair.first->analyze(m_cur_tstep);
+                }
             }
 
+        if (instrumentation)
+            instrumentation->endStep(m_cur_tstep);
+
         updateTPS();
 
         // quit if Ctrl-C was pressed
         if (g_sigint_recvd)
             {
+            if (m_integrator)
+                m_integrator->finishStep();
+
             g_sigint_recvd = 0;
             PyErr_SetString(PyExc_KeyboardInterrupt, "");
             throw pybind11::error_already_set();
@@ -173,6 +205,9 @@ void System::run(unsigned int nsteps, bool write_at_start)
             }
         }
 
+    if (m_profiler)
+        outputProfile();
+
     #ifdef ENABLE_MPI
     // make sure all ranks return the same TPS after the run completes
     if (m_comm)
@@ -183,6 +218,17 @@ void System::run(unsigned int nsteps, bool write_at_start)
     #endif
     }
 
+/*! Instrumentation is cheap enough to remain enabled for production runs. Enabling it again keeps the
+    existing samples and trace.
+*/
+void System::enableInstrumentation(bool enable)
+    {
+    if (enable && !m_instrumentation)
+        m_instrumentation = std::shared_ptr<Instrumentation>(new Instrumentation(m_exec_conf->getRank()));
+    else if (!enable)
+        m_instrumentation = std::shared_ptr<Instrumentation>();
+    }
+
 void System::updateTPS()
     {
     m_last_walltime = double(m_clk.getTime() - m_initial_time) / double(1e9);
@@ -192,10 +238,12 @@ void System::updateTPS()
     }
 
 /*! \param enable Set to true to enable profiling during calls to run()
+    \param perf_counters Set to true to also record hardware performance counters
 */
-void System::enableProfiler(bool enable)
+void System::enableProfiler(bool enable, bool perf_counters)
     {
     m_profile = enable;
+    m_profile_counters = perf_counters;
     }
 
 /*! \param logger Logger to register computes and updaters with
@@ -245,10 +293,35 @@ void System::setAutotunerParams(bool enabled, unsigned int period)
 
 // --------- Steps in the simulation run implemented in helper functions
 
+/*! With MPI, the profile combines all ranks and this method must be called on all ranks. The profile is
+    printed and kept for getProfile() on the root rank.
+*/
+void System::outputProfile()
+    {
+    std::ostringstream s;
+    #ifdef ENABLE_MPI
+    if (m_comm)
+        m_profiler->outputAggregated(s, m_exec_conf->getMPICommunicator());
+    else
+    #endif
+        s << *m_profiler;
+
+    m_profile_output = s.str();
+    if (m_exec_conf->isRoot())
+        m_exec_conf->msg->notice(1) << m_profile_output;
+    }
+
 void System::setupProfiling()
     {
     if (m_profile)
-        m_profiler = std::shared_ptr<Profiler>(new Profiler("Simulation"));
+        {
+        m_profiler = std::shared_ptr<Profiler>(new Profiler("Simulation", m_profile_counters));
+        if (m_profile_counters && !m_profiler->hasPerfCounters())
+            {
+            m_exec_conf->msg->warning() << "Hardware performance counters are not available, "
+                                        << "check /proc/sys/kernel/perf_event_paranoid" << std::endl;
+            }
+        }
     else
         m_profiler = std::shared_ptr<Profiler>();
 
@@ -286,6 +359,37 @@ void System::setupProfiling()
 #endif
     }
 
+void System::setupInstrumentation()
+    {
+    // region ids are always sized to match the operations, the run loop indexes them unconditionally
+    m_tuner_regions.assign(m_tuners.size(), 0);
+    m_updater_regions.assign(m_updaters.size(), 0);
+    m_analyzer_regions.assign(m_analyzers.size(), 0);
+    m_integrator_region = 0;
+
+    if (m_instrumentation)
+        {
+        std::map<std::string, unsigned int> counts;
+        for (unsigned int i = 0; i < m_tuners.size(); i++)
+            m_tuner_regions[i] = m_instrumentation->registerRegion("tuner", *m_tuners[i], counts);
+        for (unsigned int i = 0; i < m_updaters.size(); i++)
+            m_updater_regions[i] = m_instrumentation->registerRegion("updater", *m_updaters[i].first, counts);
+        for (unsigned int i = 0; i < m_analyzers.size(); i++)
+            m_analyzer_regions[i] = m_instrumentation->registerRegion("analyzer", *m_analyzers[i].first, counts);
+        if (m_integrator)
+            m_integrator_region = m_instrumentation->registerRegion("integrator", *m_integrator, counts);
+        m_instrumentation->setTimestep(m_cur_tstep);
+        }
+
+    if (m_integrator)
+        m_integrator->setInstrumentation(m_instrumentation);
+
+#ifdef ENABLE_MPI
+    if (m_comm)
+        m_comm->setInstrumentation(m_instrumentation);
+#endif
+    }
+
 void System::resetStats()
     {
     if (m_integrator)
@@ -336,6 +440,33 @@ PDataFlags System::determineFlags(unsigned int tstep)
     return flags;
     }
 
+/*! \param tstep Time step to check
+
+    \returns true when no analyzer, updater, or tuner is executed on \a tstep
+*/
+bool System::isIdleStep(unsigned int tstep)
+    {
+    for (auto &analyzer_trigger_pair: m_analyzers)
+        {
+        if ((*analyzer_trigger_pair.second)(tstep))
+            return false;
+        }
+
+    for (auto &updater_trigger_pair: m_updaters)
+        {
+        if ((*updater_trigger_pair.second)(tstep))
+            return false;
+        }
+
+    for (auto &tuner: m_tuners)
+        {
+        if ((*tuner->getTrigger())(tstep))
+            return false;
+        }
+
+    return true;
+    }
+
 void export_System(py::module& m)
     {
     py::bind_vector<std::vector<std::pair<std::shared_ptr<Analyzer>,
@@ -353,7 +484,10 @@ void export_System(py::module& m)
 
     .def("registerLogger", &System::registerLogger)
     .def("setAutotunerParams", &System::setAutotunerParams)
-    .def("enableProfiler", &System::enableProfiler)
+    .def("enableProfiler", &System::enableProfiler, py::arg("enable"), py::arg("perf_counters")=false)
+    .def("getProfile", &System::getProfile)
+    .def("enableInstrumentation", &System::enableInstrumentation)
+    .def("getInstrumentation", &System::getInstrumentation)
     .def("run", &System::run)
 
     .def("getLastTPS", &System::getLastTPS)
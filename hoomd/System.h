@@ -11,6 +11,7 @@
 #include "Logger.h"
 #include "Trigger.h"
 #include "Tuner.h"
+#include "Instrumentation.h"
 
 #include <string>
 #include <vector>
@@ -102,7 +103,22 @@ class PYBIND11_EXPORT System
         void run(unsigned int nsteps, bool write_at_start=false);
 
         //! Configures profiling of runs
-        void enableProfiler(bool enable);
+        void enableProfiler(bool enable, bool perf_counters=false);
+
+        //! Get the profile of the last profiled run
+        std::string getProfile() const
+            {
+            return m_profile_output;
+            }
+
+        /// Enable or disable per-region timing of runs
+        void enableInstrumentation(bool enable);
+
+        /// Get the instrumentation, null when disabled
+        std::shared_ptr<Instrumentation> getInstrumentation() const
+            {
+            return m_instrumentation;
+            }
 
         //! Register logger
         void registerLogger(std::shared_ptr<Logger> logger);
@@ -188,6 +204,12 @@ class PYBIND11_EXPORT System
         std::shared_ptr<Integrator> m_integrator;     //!< Integrator that advances time in this System
         std::shared_ptr<SystemDefinition> m_sysdef;   //!< SystemDefinition for this System
         std::shared_ptr<Profiler> m_profiler;         //!< Profiler to profile runs
+        std::shared_ptr<Instrumentation> m_instrumentation; //!< Per-region timing of runs
+
+        std::vector<unsigned int> m_tuner_regions;    //!< Instrumented region of each tuner
+        std::vector<unsigned int> m_updater_regions;  //!< Instrumented region of each updater
+        std::vector<unsigned int> m_analyzer_regions; //!< Instrumented region of each analyzer
+        unsigned int m_integrator_region=0;           //!< Instrumented region of the integrator
 
 #ifdef ENABLE_MPI
         std::shared_ptr<Communicator> m_comm;         //!< Communicator to use
@@ -199,6 +221,8 @@ class PYBIND11_EXPORT System
         ClockSource m_clk;              //!< A clock counting time from the beginning of the run
 
         bool m_profile;         //!< True if runs should be profiled
+        bool m_profile_counters;    //!< True if profiles should include hardware performance counters
+        std::string m_profile_output;   //!< Profile of the last profiled run
 
         /// Particle data flags to always set
         PDataFlags m_default_flags;
@@ -207,12 +231,21 @@ class PYBIND11_EXPORT System
         //! Sets up m_profiler and attaches/detaches to/from all computes, updaters, and analyzers
         void setupProfiling();
 
+        //! Outputs the profile at the end of a run
+        void outputProfile();
+
+        /// Register instrumented regions and attach the instrumentation to the integrator and communicator
+        void setupInstrumentation();
+
         //! Resets stats for all contained classes
         void resetStats();
 
         //! Get the flags needed for a particular step
         PDataFlags determineFlags(unsigned int tstep);
 
+        //! Check whether nothing besides the integrator runs on a particular step
+        bool isIdleStep(unsigned int tstep);
+
         /// Record the initial time of the last run
         int64_t m_initial_time=0;
 
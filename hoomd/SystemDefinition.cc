@@ -67,14 +67,76 @@ SystemDefinition::SystemDefinition(unsigned int N,
     \param snapshot Snapshot to use
     \param exec_conf Execution configuration to run on
     \param decomposition (optional) The domain decomposition layout
+    \param distributed (optional) True if every rank holds a slice of the particles and bonded groups
+    \param compact_tag_lookup (optional) True to look up particles and bonded groups by tag in per-rank hash maps
+
+    With \a distributed, the snapshot on every rank holds a contiguous slice of the particles and of each type of
+    bonded group, in rank order, and the same box, dimensions and type mappings. The ranks exchange the slices
+    directly, without gathering the system on the root rank. See ParticleData::initializeFromDistributedSnapshot().
+
+    With \a compact_tag_lookup, no rank allocates reverse-lookup arrays for the global number of particles or groups,
+    see ParticleData::setCompactTagLookup(). Together with \a distributed, the dense arrays are never allocated.
 */
 template <class Real>
 SystemDefinition::SystemDefinition(std::shared_ptr< SnapshotSystemData<Real> > snapshot,
                                    std::shared_ptr<ExecutionConfiguration> exec_conf,
-                                   std::shared_ptr<DomainDecomposition> decomposition)
+                                   std::shared_ptr<DomainDecomposition> decomposition,
+                                   bool distributed,
+                                   bool compact_tag_lookup)
     {
     setNDimensions(snapshot->dimensions);
 
+    if (distributed)
+        {
+        #ifdef ENABLE_MPI
+        if (!decomposition)
+            {
+            exec_conf->msg->error() << "Distributed snapshots require a domain decomposition" << endl;
+            throw runtime_error("Error initializing SystemDefinition");
+            }
+
+        m_particle_data = std::shared_ptr<ParticleData>(new ParticleData(0,
+                     snapshot->global_box,
+                     1,
+                     exec_conf,
+                     decomposition));
+        m_particle_data->setCompactTagLookup(compact_tag_lookup);
+
+        std::vector<unsigned int> owner;
+        m_particle_data->initializeFromDistributedSnapshot(snapshot->particle_data, owner);
+
+        m_bond_data = std::shared_ptr<BondData>(new BondData(m_particle_data, 0));
+        m_bond_data->setCompactTagLookup(compact_tag_lookup);
+        m_bond_data->initializeFromDistributedSnapshot(snapshot->bond_data, owner);
+
+        m_angle_data = std::shared_ptr<AngleData>(new AngleData(m_particle_data, 0));
+        m_angle_data->setCompactTagLookup(compact_tag_lookup);
+        m_angle_data->initializeFromDistributedSnapshot(snapshot->angle_data, owner);
+
+        m_dihedral_data = std::shared_ptr<DihedralData>(new DihedralData(m_particle_data, 0));
+        m_dihedral_data->setCompactTagLookup(compact_tag_lookup);
+        m_dihedral_data->initializeFromDistributedSnapshot(snapshot->dihedral_data, owner);
+
+        m_improper_data = std::shared_ptr<ImproperData>(new ImproperData(m_particle_data, 0));
+        m_improper_data->setCompactTagLookup(compact_tag_lookup);
+        m_improper_data->initializeFromDistributedSnapshot(snapshot->improper_data, owner);
+
+        m_constraint_data = std::shared_ptr<ConstraintData>(new ConstraintData(m_particle_data, 0));
+        m_constraint_data->setCompactTagLookup(compact_tag_lookup);
+        m_constraint_data->initializeFromDistributedSnapshot(snapshot->constraint_data, owner);
+
+        m_pair_data = std::shared_ptr<PairData>(new PairData(m_particle_data, 0));
+        m_pair_data->setCompactTagLookup(compact_tag_lookup);
+        m_pair_data->initializeFromDistributedSnapshot(snapshot->pair_data, owner);
+
+        m_integrator_data = std::shared_ptr<IntegratorData>(new IntegratorData());
+        return;
+        #else
+        exec_conf->msg->error() << "Distributed snapshots require MPI" << endl;
+        throw runtime_error("Error initializing SystemDefinition");
+        #endif
+        }
+
     m_particle_data = std::shared_ptr<ParticleData>(new ParticleData(snapshot->particle_data,
                  snapshot->global_box,
                  exec_conf,
@@ -97,6 +159,24 @@ SystemDefinition::SystemDefinition(std::shared_ptr< SnapshotSystemData<Real> > s
     m_constraint_data = std::shared_ptr<ConstraintData>(new ConstraintData(m_particle_data, snapshot->constraint_data));
     m_pair_data = std::shared_ptr<PairData>(new PairData(m_particle_data, snapshot->pair_data));
     m_integrator_data = std::shared_ptr<IntegratorData>(new IntegratorData());
+
+    setCompactTagLookup(compact_tag_lookup);
+    }
+
+/*! \param compact True to look up particles and bonded groups by tag in per-rank hash maps
+
+    \pre No ParticleGroup or Communicator has been constructed for this system yet.
+    \sa ParticleData::setCompactTagLookup()
+*/
+void SystemDefinition::setCompactTagLookup(bool compact)
+    {
+    m_particle_data->setCompactTagLookup(compact);
+    m_bond_data->setCompactTagLookup(compact);
+    m_angle_data->setCompactTagLookup(compact);
+    m_dihedral_data->setCompactTagLookup(compact);
+    m_improper_data->setCompactTagLookup(compact);
+    m_constraint_data->setCompactTagLookup(compact);
+    m_pair_data->setCompactTagLookup(compact);
     }
 
 /*! Sets the dimensionality of the system.  When quantities involving the dof of
@@ -170,13 +250,17 @@ void SystemDefinition::initializeFromSnapshot(std::shared_ptr< SnapshotSystemDat
 // instantiate both float and double methods
 template SystemDefinition::SystemDefinition(std::shared_ptr< SnapshotSystemData<float> > snapshot,
                                                    std::shared_ptr<ExecutionConfiguration> exec_conf,
-                                                   std::shared_ptr<DomainDecomposition> decomposition);
+                                                   std::shared_ptr<DomainDecomposition> decomposition,
+                                                   bool distributed,
+                                                   bool compact_tag_lookup);
 template std::shared_ptr< SnapshotSystemData<float> > SystemDefinition::takeSnapshot<float>();
 template void SystemDefinition::initializeFromSnapshot<float>(std::shared_ptr< SnapshotSystemData<float> > snapshot);
 
 template SystemDefinition::SystemDefinition(std::shared_ptr< SnapshotSystemData<double> > snapshot,
                                                    std::shared_ptr<ExecutionConfiguration> exec_conf,
-                                                   std::shared_ptr<DomainDecomposition> decomposition);
+                                                   std::shared_ptr<DomainDecomposition> decomposition,
+                                                   bool distributed,
+                                                   bool compact_tag_lookup);
 template std::shared_ptr< SnapshotSystemData<double> > SystemDefinition::takeSnapshot<double>();
 template void SystemDefinition::initializeFromSnapshot<double>(std::shared_ptr< SnapshotSystemData<double> > snapshot);
 
@@ -187,11 +271,17 @@ void export_SystemDefinition(py::module& m)
     .def(py::init<unsigned int, const BoxDim&, unsigned int, unsigned int, unsigned int, unsigned int, unsigned int, std::shared_ptr<ExecutionConfiguration> >())
     .def(py::init<unsigned int, const BoxDim&, unsigned int, unsigned int, unsigned int, unsigned int, unsigned int, std::shared_ptr<ExecutionConfiguration>, std::shared_ptr<DomainDecomposition> >())
     .def(py::init<std::shared_ptr< SnapshotSystemData<float> >, std::shared_ptr<ExecutionConfiguration>, std::shared_ptr<DomainDecomposition> >())
+    .def(py::init<std::shared_ptr< SnapshotSystemData<float> >, std::shared_ptr<ExecutionConfiguration>, std::shared_ptr<DomainDecomposition>, bool >())
+    .def(py::init<std::shared_ptr< SnapshotSystemData<float> >, std::shared_ptr<ExecutionConfiguration>, std::shared_ptr<DomainDecomposition>, bool, bool >())
     .def(py::init<std::shared_ptr< SnapshotSystemData<float> >, std::shared_ptr<ExecutionConfiguration> >())
     .def(py::init<std::shared_ptr< SnapshotSystemData<double> >, std::shared_ptr<ExecutionConfiguration>, std::shared_ptr<DomainDecomposition> >())
+    .def(py::init<std::shared_ptr< SnapshotSystemData<double> >, std::shared_ptr<ExecutionConfiguration>, std::shared_ptr<DomainDecomposition>, bool >())
+    .def(py::init<std::shared_ptr< SnapshotSystemData<double> >, std::shared_ptr<ExecutionConfiguration>, std::shared_ptr<DomainDecomposition>, bool, bool >())
     .def(py::init<std::shared_ptr< SnapshotSystemData<double> >, std::shared_ptr<ExecutionConfiguration> >())
     .def("setNDimensions", &SystemDefinition::setNDimensions)
     .def("getNDimensions", &SystemDefinition::getNDimensions)
+    .def("setCompactTagLookup", &SystemDefinition::setCompactTagLookup)
+    .def("getCompactTagLookup", &SystemDefinition::getCompactTagLookup)
     .def("getParticleData", &SystemDefinition::getParticleData)
     .def("getBondData", &SystemDefinition::getBondData)
     .def("getAngleData", &SystemDefinition::getAngleData)
@@ -89,7 +89,9 @@ class PYBIND11_EXPORT SystemDefinition
         template <class Real>
         SystemDefinition(std::shared_ptr<SnapshotSystemData<Real> > snapshot,
                          std::shared_ptr<ExecutionConfiguration> exec_conf=std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration()),
-                         std::shared_ptr<DomainDecomposition> decomposition=std::shared_ptr<DomainDecomposition>());
+                         std::shared_ptr<DomainDecomposition> decomposition=std::shared_ptr<DomainDecomposition>(),
+                         bool distributed=false,
+                         bool compact_tag_lookup=false);
 
         //! Set the dimensionality of the system
         void setNDimensions(unsigned int);
@@ -143,6 +145,15 @@ class PYBIND11_EXPORT SystemDefinition
             return m_pair_data;
             }
 
+        //! Switch the particle and bonded group data between the dense and the compact reverse tag lookup
+        void setCompactTagLookup(bool compact);
+
+        //! Test if the reverse tag lookup is compact
+        bool getCompactTagLookup() const
+            {
+            return m_particle_data->getCompactTagLookup();
+            }
+
         //! Return a snapshot of the current system data
         template <class Real>
         std::shared_ptr< SnapshotSystemData<Real> > takeSnapshot();
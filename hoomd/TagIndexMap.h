@@ -0,0 +1,440 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+/*! \file TagIndexMap.h
+    \brief Declares the TagIndexMap, TagIndexHandle and ActiveTagSet classes
+*/
+
+#ifdef __HIPCC__
+#error This header cannot be compiled by nvcc
+#endif
+
+#ifndef __TAG_INDEX_MAP_H__
+#define __TAG_INDEX_MAP_H__
+
+#include "GPUArray.h"
+
+#include <iterator>
+#include <set>
+#include <vector>
+
+//! Hash map from global tags to local indices
+/*! ParticleData and BondedGroupData look up the local index of a particle or group by its global tag. By default,
+    this reverse lookup is a dense array indexed by tag, which every rank allocates for the global number of tags.
+    TagIndexMap stores only the tags that are present on this rank, so its memory scales with the number of local
+    and ghost particles.
+
+    The map uses open addressing with linear probing. Erased keys are removed by shifting the following keys of the
+    same probe sequence back, so that there are no tombstones and lookups stay short after many migrations. The
+    capacity is a power of two and at least twice the number of stored keys.
+
+    Lookups of absent tags return not_found, which has the same value as NOT_LOCAL and GROUP_NOT_LOCAL.
+*/
+class TagIndexMap
+    {
+    public:
+        //! Value returned for tags that are not in the map
+        static const unsigned int not_found = 0xffffffff;
+
+        //! Construct an empty map
+        TagIndexMap()
+            : m_size(0), m_mask(0)
+            {
+            }
+
+        //! Get the index of a tag
+        /*! \param tag Global tag to look up
+            \returns the index of the tag, or not_found
+         */
+        unsigned int find(unsigned int tag) const
+            {
+            if (m_size == 0)
+                return not_found;
+
+            for (unsigned int slot = hash(tag) & m_mask; ; slot = (slot + 1) & m_mask)
+                {
+                unsigned int key = m_keys[slot];
+                if (key == tag)
+                    return m_values[slot];
+                if (key == empty)
+                    return not_found;
+                }
+            }
+
+        //! Set the index of a tag
+        /*! \param tag Global tag
+            \param idx Local index, not_found removes the tag from the map
+         */
+        void set(unsigned int tag, unsigned int idx)
+            {
+            if (idx == not_found)
+                {
+                erase(tag);
+                return;
+                }
+
+            // keep the load factor at or below one half
+            if (2*(m_size + 1) > m_keys.size())
+                rehash(m_keys.empty() ? min_capacity : 2*(unsigned int)m_keys.size());
+
+            unsigned int slot = hash(tag) & m_mask;
+            while (m_keys[slot] != empty && m_keys[slot] != tag)
+                slot = (slot + 1) & m_mask;
+
+            if (m_keys[slot] == empty)
+                {
+                m_keys[slot] = tag;
+                m_size++;
+                }
+            m_values[slot] = idx;
+            }
+
+        //! Remove a tag from the map
+        /*! \param tag Global tag to remove, absent tags are ignored
+         */
+        void erase(unsigned int tag)
+            {
+            if (m_size == 0)
+                return;
+
+            unsigned int slot = hash(tag) & m_mask;
+            while (m_keys[slot] != tag)
+                {
+                if (m_keys[slot] == empty)
+                    return;
+                slot = (slot + 1) & m_mask;
+                }
+
+            // shift back the following keys whose probe sequence passes through the freed slot
+            unsigned int hole = slot;
+            for (unsigned int next = (hole + 1) & m_mask; m_keys[next] != empty; next = (next + 1) & m_mask)
+                {
+                unsigned int home = hash(m_keys[next]) & m_mask;
+                if (((next - home) & m_mask) >= ((next - hole) & m_mask))
+                    {
+                    m_keys[hole] = m_keys[next];
+                    m_values[hole] = m_values[next];
+                    hole = next;
+                    }
+                }
+            m_keys[hole] = empty;
+            m_size--;
+            }
+
+        //! Remove all tags, keeping the capacity
+        void clear()
+            {
+            std::fill(m_keys.begin(), m_keys.end(), empty);
+            m_size = 0;
+            }
+
+        //! Make room for a number of tags without rehashing
+        /*! \param n Number of tags
+         */
+        void reserve(unsigned int n)
+            {
+            unsigned int capacity = m_keys.empty() ? min_capacity : (unsigned int)m_keys.size();
+            while (capacity < 2*n)
+                capacity *= 2;
+            if (capacity > m_keys.size())
+                rehash(capacity);
+            }
+
+        //! Get the number of tags in the map
+        unsigned int size() const
+            {
+            return m_size;
+            }
+
+        //! Get the number of slots
+        unsigned int getCapacity() const
+            {
+            return (unsigned int)m_keys.size();
+            }
+
+    private:
+        static const unsigned int empty = 0xffffffff;   //!< Key of an unused slot
+        static const unsigned int min_capacity = 16;    //!< Capacity of the first allocation
+
+        std::vector<unsigned int> m_keys;      //!< Tag in every slot
+        std::vector<unsigned int> m_values;    //!< Index in every slot
+        unsigned int m_size;                   //!< Number of stored tags
+        unsigned int m_mask;                   //!< Capacity - 1
+
+        //! Scramble the bits of a tag, consecutive tags map to distant slots
+        static unsigned int hash(unsigned int tag)
+            {
+            tag ^= tag >> 16;
+            tag *= 0x85ebca6b;
+            tag ^= tag >> 13;
+            tag *= 0xc2b2ae35;
+            tag ^= tag >> 16;
+            return tag;
+            }
+
+        //! Reinsert all tags into a table of a new capacity
+        /*! \param capacity New number of slots, a power of two
+         */
+        void rehash(unsigned int capacity)
+            {
+            std::vector<unsigned int> keys(capacity, empty);
+            std::vector<unsigned int> values(capacity);
+            unsigned int mask = capacity - 1;
+
+            for (unsigned int i = 0; i < m_keys.size(); i++)
+                {
+                if (m_keys[i] == empty)
+                    continue;
+
+                unsigned int slot = hash(m_keys[i]) & mask;
+                while (keys[slot] != empty)
+                    slot = (slot + 1) & mask;
+                keys[slot] = m_keys[i];
+                values[slot] = m_values[i];
+                }
+
+            m_keys.swap(keys);
+            m_values.swap(values);
+            m_mask = mask;
+            }
+    };
+
+//! Host access to a reverse tag lookup in the dense or in the compact layout
+/*! In the dense layout, the reverse lookup is an array indexed by tag. In the compact layout, that array is empty
+    and the lookups go to a TagIndexMap. Code that supports both layouts reads and writes the reverse lookup through
+    this handle instead of through an ArrayHandle of the dense array:
+    \code
+    TagIndexHandle h_rtag(*m_pdata, access_mode::readwrite);
+    unsigned int idx = h_rtag[tag];
+    h_rtag.set(tag, NOT_LOCAL);
+    \endcode
+
+    The dense array stays acquired for the lifetime of the handle, like with ArrayHandle.
+*/
+class TagIndexHandle
+    {
+    public:
+        //! Acquire the reverse lookup of a ParticleData or BondedGroupData object
+        /*! \param data Object that provides getRTagArray() and getRTagMap()
+            \param mode Access mode for the dense array
+         */
+        template<class Data>
+        TagIndexHandle(const Data& data, const access_mode::Enum mode)
+            : m_dense(data.getRTagArray(), access_location::host, mode), m_map(data.getRTagMap())
+            {
+            }
+
+        //! Get the index of a tag
+        unsigned int operator[](unsigned int tag) const
+            {
+            return m_map ? m_map->find(tag) : m_dense.data[tag];
+            }
+
+        //! Set the index of a tag, NOT_LOCAL removes the tag from the compact layout
+        void set(unsigned int tag, unsigned int idx)
+            {
+            if (m_map)
+                m_map->set(tag, idx);
+            else
+                m_dense.data[tag] = idx;
+            }
+
+    private:
+        ArrayHandle<unsigned int> m_dense;   //!< Handle to the dense array, empty in the compact layout
+        TagIndexMap *m_map;                  //!< Map of the compact layout, nullptr in the dense layout
+    };
+
+//! Set of the active global tags
+/*! Tags are handed out consecutively and the tags of removed particles or groups are recycled, so the active tags
+    are usually a contiguous range with a few holes. In the compact layout, the set stores that range and the holes,
+    and its memory scales with the number of removed tags. In the dense layout, it stores every active tag in a
+    std::set and caches them in a vector for constant time access by index.
+*/
+class ActiveTagSet
+    {
+    public:
+        //! Construct an empty set in the dense layout
+        ActiveTagSet()
+            : m_compact(false), m_end(0), m_invalid_cache(true)
+            {
+            }
+
+        //! Switch between the dense and the compact layout
+        /*! \param compact True to store the range of tags and the holes
+         */
+        void setCompact(bool compact)
+            {
+            if (compact == m_compact)
+                return;
+
+            if (compact)
+                {
+                m_end = m_tags.empty() ? 0 : *m_tags.rbegin() + 1;
+                m_holes.clear();
+                unsigned int next = 0;
+                for (unsigned int tag : m_tags)
+                    {
+                    for (; next < tag; ++next)
+                        m_holes.insert(m_holes.end(), next);
+                    next = tag + 1;
+                    }
+                std::set<unsigned int>().swap(m_tags);
+                std::vector<unsigned int>().swap(m_cache);
+                }
+            else
+                {
+                for (unsigned int tag = 0; tag < m_end; ++tag)
+                    if (m_holes.find(tag) == m_holes.end())
+                        m_tags.insert(m_tags.end(), tag);
+                m_holes.clear();
+                m_end = 0;
+                }
+
+            m_compact = compact;
+            m_invalid_cache = true;
+            }
+
+        //! Remove all tags
+        void clear()
+            {
+            m_tags.clear();
+            m_holes.clear();
+            m_end = 0;
+            m_invalid_cache = true;
+            }
+
+        //! Set the active tags to 0, 1, ..., n-1
+        void assignRange(unsigned int n)
+            {
+            clear();
+            if (m_compact)
+                m_end = n;
+            else
+                for (unsigned int tag = 0; tag < n; ++tag)
+                    m_tags.insert(m_tags.end(), tag);
+            }
+
+        //! Add a tag
+        void insert(unsigned int tag)
+            {
+            if (!m_compact)
+                m_tags.insert(tag);
+            else if (tag < m_end)
+                m_holes.erase(tag);
+            else
+                {
+                for (; m_end < tag; ++m_end)
+                    m_holes.insert(m_holes.end(), m_end);
+                m_end = tag + 1;
+                }
+            m_invalid_cache = true;
+            }
+
+        //! Remove a tag
+        void erase(unsigned int tag)
+            {
+            if (!m_compact)
+                m_tags.erase(tag);
+            else if (tag + 1 == m_end)
+                {
+                // shrink the range past the holes at its end
+                for (--m_end; !m_holes.empty() && *m_holes.rbegin() + 1 == m_end; --m_end)
+                    m_holes.erase(std::prev(m_holes.end()));
+                }
+            else if (tag < m_end)
+                m_holes.insert(tag);
+            m_invalid_cache = true;
+            }
+
+        //! Test if a tag is active
+        bool contains(unsigned int tag) const
+            {
+            if (!m_compact)
+                return m_tags.find(tag) != m_tags.end();
+            return tag < m_end && m_holes.find(tag) == m_holes.end();
+            }
+
+        //! Get the number of active tags
+        unsigned int size() const
+            {
+            return m_compact ? m_end - (unsigned int)m_holes.size() : (unsigned int)m_tags.size();
+            }
+
+        //! Test if there are no active tags
+        bool empty() const
+            {
+            return size() == 0;
+            }
+
+        //! Get the smallest active tag
+        /*! \pre The set is not empty
+         */
+        unsigned int min() const
+            {
+            if (!m_compact)
+                return *m_tags.begin();
+
+            unsigned int tag = 0;
+            for (auto it = m_holes.begin(); it != m_holes.end() && *it == tag; ++it)
+                ++tag;
+            return tag;
+            }
+
+        //! Get the largest active tag
+        /*! \pre The set is not empty
+         */
+        unsigned int max() const
+            {
+            return m_compact ? m_end - 1 : *m_tags.rbegin();
+            }
+
+        //! Get the n-th smallest active tag
+        /*! \param n Index of the tag, smaller than size()
+         */
+        unsigned int nth(unsigned int n)
+            {
+            if (m_compact)
+                {
+                // every hole below the result shifts it by one
+                unsigned int tag = n;
+                for (unsigned int hole : m_holes)
+                    {
+                    if (hole > tag)
+                        break;
+                    ++tag;
+                    }
+                return tag;
+                }
+
+            if (m_invalid_cache)
+                {
+                m_cache.assign(m_tags.begin(), m_tags.end());
+                m_invalid_cache = false;
+                }
+            return m_cache[n];
+            }
+
+        //! Get the smallest active tag larger than a given tag
+        /*! \param tag Active tag, smaller than max()
+         */
+        unsigned int next(unsigned int tag) const
+            {
+            if (!m_compact)
+                return *m_tags.upper_bound(tag);
+
+            for (++tag; m_holes.find(tag) != m_holes.end(); ++tag)
+                ;
+            return tag;
+            }
+
+    private:
+        bool m_compact;                        //!< True in the compact layout
+        std::set<unsigned int> m_tags;         //!< Active tags in the dense layout
+        std::vector<unsigned int> m_cache;     //!< Active tags by index in the dense layout
+        unsigned int m_end;                    //!< One past the largest tag of the range in the compact layout
+        std::set<unsigned int> m_holes;        //!< Inactive tags below m_end in the compact layout
+        bool m_invalid_cache;                  //!< True if m_cache needs to be rebuilt
+    };
+
+#endif
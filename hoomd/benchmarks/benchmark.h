@@ -0,0 +1,369 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+/*! \file benchmark.h
+    \brief Helps microbenchmarks time kernels, generate configurations and report results
+    \details Benchmark executables are built on the unit test framework: every benchmark is a UP_TEST that times its
+        kernels with BenchmarkRunner::run(), and the executable defines its main() with HOOMD_UP_MAIN(). Failed
+        assertions in the set up of a benchmark are reported like failed unit tests. Configurations are generated
+        deterministically from fixed seeds so that results are comparable between builds.
+    \note This file should be included only once and by a file that will compile into a benchmark executable
+*/
+
+#include "hoomd/test/upp11_config.h"
+
+#include "hoomd/ClockSource.h"
+#include "hoomd/HOOMDVersion.h"
+#include "hoomd/RandomNumbers.h"
+#include "hoomd/SnapshotSystemData.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+//! Result of a single benchmark
+struct BenchmarkResult
+    {
+    std::string name;           //!< Name of the timed kernel
+    std::string config;         //!< Name of the configuration
+    std::vector<std::pair<std::string, double> > params;  //!< Parameters of the configuration
+    std::string mode;           //!< Execution mode (cpu or gpu)
+    unsigned int threads;       //!< Number of CPU threads
+    unsigned int N;             //!< Number of particles (0 when not applicable)
+    unsigned int iterations;    //!< Calls per sample
+    std::vector<double> samples;    //!< Time per call of each sample (ns)
+    std::map<std::string, double> metrics;  //!< Derived metrics
+    };
+
+//! Times benchmarks and writes the results
+/*! The unit test framework owns the command line, so the runner is configured with environment variables:
+     - `HOOMD_BENCHMARK_JSON=<file>` write the results to \a file
+     - `HOOMD_BENCHMARK_FILTER=<text>` only run benchmarks whose name or configuration contains \a text
+     - `HOOMD_BENCHMARK_QUICK=1` only run the smallest configurations
+     - `HOOMD_BENCHMARK_REPEAT=<n>` number of samples per benchmark (default 7)
+     - `HOOMD_BENCHMARK_MIN_TIME=<s>` minimum duration of a sample (default 0.05)
+
+    A benchmark is a callable in the style of Compute::benchmark(): it takes a number of iterations and returns the
+    time per iteration in milliseconds, synchronizing with the GPU where needed. run() first determines the number of
+    iterations that takes at least the minimum time, then takes the configured number of samples and reports their
+    median. The median and the spread between samples make results reproducible on a quiet machine.
+
+    Each benchmark executable defines one global BenchmarkRunner. The JSON file is rewritten after every benchmark,
+    so it is complete when the executable exits.
+*/
+class BenchmarkRunner
+    {
+    public:
+        //! Benchmark kernel: returns the time per iteration (ms) of the given number of iterations
+        typedef std::function<double (unsigned int)> Kernel;
+
+        //! Read the configuration from the environment
+        BenchmarkRunner(const std::string& suite)
+            : m_suite(suite), m_quick(false), m_repeat(7), m_min_time(0.05)
+            {
+            if (const char *value = std::getenv("HOOMD_BENCHMARK_JSON"))
+                m_json = value;
+            if (const char *value = std::getenv("HOOMD_BENCHMARK_FILTER"))
+                m_filter = value;
+            if (const char *value = std::getenv("HOOMD_BENCHMARK_QUICK"))
+                m_quick = std::string(value) != "" && std::string(value) != "0";
+            if (const char *value = std::getenv("HOOMD_BENCHMARK_REPEAT"))
+                m_repeat = std::max(1, std::atoi(value));
+            if (const char *value = std::getenv("HOOMD_BENCHMARK_MIN_TIME"))
+                m_min_time = std::atof(value);
+            }
+
+        //! Check if only the smallest configurations should run
+        bool quick() const
+            {
+            return m_quick;
+            }
+
+        //! Get the system sizes to benchmark
+        std::vector<unsigned int> sizes() const
+            {
+            if (m_quick)
+                return {4096};
+            return {4096, 32768, 262144};
+            }
+
+        //! Check if a benchmark is selected by the filter
+        bool selected(const std::string& name, const std::string& config) const
+            {
+            return m_filter.empty() || name.find(m_filter) != std::string::npos
+                                    || config.find(m_filter) != std::string::npos;
+            }
+
+        //! Time a kernel
+        /*! \param exec_conf Execution configuration the kernel runs with
+            \param name Name of the timed kernel
+            \param config Name of the configuration
+            \param params Parameters of the configuration
+            \param N Number of particles, used for the time per particle (0 if not applicable)
+            \param pairs Number of pairs (or other interactions) processed per call, used for the throughput
+            \param kernel Kernel to time
+            \returns The result, which the caller may add metrics to before the next call to run()
+        */
+        BenchmarkResult& run(std::shared_ptr<const ExecutionConfiguration> exec_conf,
+                             const std::string& name,
+                             const std::string& config,
+                             const std::vector<std::pair<std::string, double> >& params,
+                             unsigned int N,
+                             double pairs,
+                             Kernel kernel)
+            {
+            // write the results of the previous benchmark, including the metrics added by the caller
+            write();
+
+            BenchmarkResult result;
+            result.name = name;
+            result.config = config;
+            result.params = params;
+            result.mode = exec_conf->isCUDAEnabled() ? "gpu" : "cpu";
+            result.threads = exec_conf->getNumThreads();
+            result.N = N;
+
+            // find the number of iterations that takes at least the minimum time
+            unsigned int iterations = 1;
+            double t = kernel(iterations);
+            while (t * 1e-3 * iterations < m_min_time && iterations < (1u << 30))
+                {
+                iterations = std::max(iterations * 2,
+                    (unsigned int)std::min(1e9, std::ceil(m_min_time / std::max(t * 1e-3, 1e-9) * 1.2)));
+                t = kernel(iterations);
+                }
+            result.iterations = iterations;
+
+            for (int i = 0; i < m_repeat; i++)
+                result.samples.push_back(kernel(iterations) * 1e6);
+
+            double median = getMedian(result.samples);
+            UP_ASSERT(median > 0);
+            result.metrics["time_ns"] = median;
+            result.metrics["time_min_ns"] = *std::min_element(result.samples.begin(), result.samples.end());
+            result.metrics["time_max_ns"] = *std::max_element(result.samples.begin(), result.samples.end());
+            if (N > 0)
+                result.metrics["ns_per_particle"] = median / double(N);
+            if (pairs > 0)
+                {
+                result.metrics["pairs"] = pairs;
+                result.metrics["pairs_per_s"] = pairs / median * 1e9;
+                }
+
+            std::cout << std::left << std::setw(32) << name << std::setw(12) << config;
+            for (auto& p : params)
+                std::cout << " " << p.first << "=" << p.second;
+            std::cout << std::right << std::fixed << std::setprecision(1)
+                      << " | " << std::setw(12) << median * 1e-3 << " us";
+            if (N > 0)
+                std::cout << " | " << std::setw(8) << std::setprecision(2) << median / double(N) << " ns/particle";
+            if (pairs > 0)
+                std::cout << " | " << std::setw(8) << std::setprecision(3) << std::scientific << pairs / median * 1e9
+                          << " pairs/s" << std::fixed;
+            std::cout << std::endl;
+
+            m_results.push_back(result);
+            return m_results.back();
+            }
+
+        //! Write the remaining results
+        ~BenchmarkRunner()
+            {
+            write();
+            }
+
+    private:
+        std::string m_suite;        //!< Name of the benchmark suite
+        std::string m_json;         //!< File to write results to
+        std::string m_filter;       //!< Benchmark filter
+        bool m_quick;               //!< Only run the smallest configurations
+        int m_repeat;               //!< Number of samples per benchmark
+        double m_min_time;          //!< Minimum duration of a sample (s)
+        std::vector<BenchmarkResult> m_results;   //!< Results so far
+
+        //! Write all results so far to the JSON file
+        void write()
+            {
+            if (m_json.empty() || m_results.empty())
+                return;
+
+            std::ofstream f(m_json.c_str());
+            if (!f.good())
+                {
+                std::cerr << "Error opening " << m_json << std::endl;
+                return;
+                }
+
+            char date[32];
+            time_t now = time(NULL);
+            strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", localtime(&now));
+
+            f << std::setprecision(12);
+            f << "{\n\"context\": {";
+            f << "\"suite\": " << quote(m_suite);
+            f << ", \"hoomd_version\": " << quote(hoomd::BuildInfo::getVersion());
+            f << ", \"compiler\": " << quote(hoomd::BuildInfo::getCXXCompiler());
+            f << ", \"compile_flags\": " << quote(hoomd::BuildInfo::getCompileFlags());
+            f << ", \"repeat\": " << m_repeat;
+            f << ", \"min_time\": " << m_min_time;
+            f << ", \"date\": " << quote(date);
+            f << "},\n\"benchmarks\": [";
+            for (unsigned int i = 0; i < m_results.size(); i++)
+                {
+                const BenchmarkResult& r = m_results[i];
+                f << (i > 0 ? ",\n" : "\n");
+                f << "{\"name\": " << quote(r.name) << ", \"config\": " << quote(r.config);
+                f << ", \"params\": {";
+                for (unsigned int j = 0; j < r.params.size(); j++)
+                    f << (j > 0 ? ", " : "") << quote(r.params[j].first) << ": " << r.params[j].second;
+                f << "}, \"mode\": " << quote(r.mode) << ", \"threads\": " << r.threads;
+                f << ", \"N\": " << r.N << ", \"iterations\": " << r.iterations;
+                f << ", \"samples_ns\": [";
+                for (unsigned int j = 0; j < r.samples.size(); j++)
+                    f << (j > 0 ? ", " : "") << r.samples[j];
+                f << "]";
+                for (auto& m : r.metrics)
+                    f << ", " << quote(m.first) << ": " << m.second;
+                f << "}";
+                }
+            f << "\n]\n}\n";
+            }
+
+        //! Get the median of a set of samples
+        static double getMedian(std::vector<double> x)
+            {
+            std::sort(x.begin(), x.end());
+            size_t n = x.size();
+            return (n % 2) ? x[n/2] : 0.5 * (x[n/2-1] + x[n/2]);
+            }
+
+        //! Quote a string for JSON
+        static std::string quote(const std::string& s)
+            {
+            std::string result = "\"";
+            for (char c : s)
+                {
+                if (c == '"' || c == '\\')
+                    result += '\\';
+                if (c == '\n')
+                    result += "\\n";
+                else
+                    result += c;
+                }
+            return result + "\"";
+            }
+    };
+
+//! Time a callable in the style of Compute::benchmark()
+/*! \param f Callable executing one iteration, taking the iteration index
+    \param num_iters Number of iterations
+    \returns Milliseconds per iteration
+
+    Use for kernels without a benchmark() method of their own. \a f must synchronize with the GPU itself.
+*/
+template<class F>
+double benchmark_loop(F f, unsigned int num_iters)
+    {
+    ClockSource t;
+    uint64_t start_time = t.getTime();
+    for (unsigned int i = 0; i < num_iters; i++)
+        f(i);
+    uint64_t total_time_ns = t.getTime() - start_time;
+    return double(total_time_ns) / 1e6 / double(num_iters);
+    }
+
+//! Generate a simple cubic lattice configuration with random displacements
+/*! \param N Number of particles
+    \param density Number density
+    \param jitter Maximum displacement from the lattice sites, in units of the lattice spacing
+    \param seed Random number seed
+
+    The first \a N sites of the smallest cubic lattice with at least \a N sites are occupied by particles of type A,
+    in the order of a path that visits neighboring sites one after another. Particles with consecutive tags are
+    therefore nearest neighbors. A \a jitter below 0.5 never places particles closer than (1-2 jitter) lattice
+    spacings.
+*/
+inline std::shared_ptr< SnapshotSystemData<Scalar> > make_lattice_snapshot(unsigned int N, Scalar density,
+                                                                          Scalar jitter=Scalar(0.1),
+                                                                          unsigned int seed=1)
+    {
+    unsigned int M = (unsigned int)std::ceil(std::cbrt(double(N)) - 1e-9);
+    Scalar L = std::cbrt(Scalar(N) / density);
+    Scalar a = L / Scalar(M);
+
+    std::shared_ptr< SnapshotSystemData<Scalar> > snapshot(new SnapshotSystemData<Scalar>());
+    snapshot->global_box = BoxDim(L);
+    SnapshotParticleData<Scalar>& pdata = snapshot->particle_data;
+    pdata.resize(N);
+    pdata.type_mapping.push_back("A");
+
+    hoomd::RandomGenerator rng(seed, 0x42656e63);
+    hoomd::UniformDistribution<Scalar> uniform(-jitter, jitter);
+    Scalar3 lo = snapshot->global_box.getLo();
+
+    // walk the lattice back and forth so that consecutive sites are neighbors
+    unsigned int n = 0;
+    for (unsigned int k = 0; k < M && n < N; k++)
+        {
+        for (unsigned int jj = 0; jj < M && n < N; jj++)
+            {
+            unsigned int j = (k % 2) ? M - 1 - jj : jj;
+            for (unsigned int ii = 0; ii < M && n < N; ii++)
+                {
+                unsigned int i = ((k * M + jj) % 2) ? M - 1 - ii : ii;
+                pdata.pos[n] = vec3<Scalar>(lo.x + (Scalar(i) + Scalar(0.5) + uniform(rng)) * a,
+                                            lo.y + (Scalar(j) + Scalar(0.5) + uniform(rng)) * a,
+                                            lo.z + (Scalar(k) + Scalar(0.5) + uniform(rng)) * a);
+                n++;
+                }
+            }
+        }
+
+    return snapshot;
+    }
+
+//! Generate a configuration of linear polymers
+/*! \param N Number of particles
+    \param density Number density
+    \param chain_length Number of monomers per chain
+    \param seed Random number seed
+
+    Chains follow the path of make_lattice_snapshot(), bonds connect consecutive monomers with a bond of type
+    backbone.
+*/
+inline std::shared_ptr< SnapshotSystemData<Scalar> > make_polymer_snapshot(unsigned int N, Scalar density,
+                                                                          unsigned int chain_length,
+                                                                          unsigned int seed=1)
+    {
+    std::shared_ptr< SnapshotSystemData<Scalar> > snapshot = make_lattice_snapshot(N, density, Scalar(0.05), seed);
+
+    BondData::Snapshot& bonds = snapshot->bond_data;
+    bonds.type_mapping.push_back("backbone");
+    for (unsigned int i = 0; i+1 < N; i++)
+        {
+        if ((i+1) % chain_length == 0)
+            continue;
+
+        BondData::members_t bond;
+        bond.tag[0] = i;
+        bond.tag[1] = i+1;
+        bonds.groups.push_back(bond);
+        bonds.type_id.push_back(0);
+        }
+    bonds.size = (unsigned int)bonds.groups.size();
+
+    return snapshot;
+    }
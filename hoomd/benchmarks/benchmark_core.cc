@@ -0,0 +1,167 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+/*! \file benchmark_core.cc
+    \brief Benchmarks the cell list, the space filling curve sort and GSD output
+*/
+
+// this include is necessary to get MPI included before anything else to support intel MPI
+#include "hoomd/ExecutionConfiguration.h"
+
+#include "hoomd/CellList.h"
+#include "hoomd/GSDDumpWriter.h"
+#include "hoomd/SFCPackTuner.h"
+#include "hoomd/SystemDefinition.h"
+#include "hoomd/filter/ParticleFilterAll.h"
+
+#ifdef ENABLE_HIP
+#include "hoomd/CellListGPU.h"
+#include "hoomd/SFCPackTunerGPU.h"
+#endif
+
+#include <cstdio>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "hoomd/benchmarks/benchmark.h"
+
+using namespace std;
+
+//! Global runner of the benchmarks in this executable
+BenchmarkRunner benchmarks("core");
+
+HOOMD_UP_MAIN();
+
+//! Densities of the benchmark configurations
+const std::vector<Scalar> densities = {Scalar(0.3), Scalar(0.85)};
+
+//! Call a benchmark with every lattice configuration
+/*! \param exec_conf Execution configuration to construct the systems with
+    \param f Benchmark taking the system definition, the name of the configuration and its parameters
+*/
+template<class F>
+void for_each_lattice(std::shared_ptr<ExecutionConfiguration> exec_conf, F f)
+    {
+    for (unsigned int N : benchmarks.sizes())
+        {
+        for (Scalar density : densities)
+            {
+            std::vector<std::pair<std::string, double> > params = {{"density", density}};
+            std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(make_lattice_snapshot(N, density),
+                                                                          exec_conf));
+            f(sysdef, "lj", params);
+            }
+        }
+    }
+
+//! Benchmark CellList::compute
+template<class CL>
+void cell_list_benchmark(std::shared_ptr<ExecutionConfiguration> exec_conf, const std::string& name)
+    {
+    for_each_lattice(exec_conf, [&](std::shared_ptr<SystemDefinition> sysdef, const std::string& config,
+                                    const std::vector<std::pair<std::string, double> >& params)
+        {
+        if (!benchmarks.selected(name, config))
+            return;
+
+        std::shared_ptr<CellList> cl(new CL(sysdef));
+        cl->setNominalWidth(Scalar(2.8));
+        cl->setRadius(1);
+        cl->setFlagIndex();
+        benchmarks.run(exec_conf, name, config, params, sysdef->getParticleData()->getN(), 0,
+                       [cl](unsigned int n) { return cl->benchmark(n); });
+        });
+    }
+
+//! Benchmark SFCPackTuner::update
+template<class Sorter>
+void sfc_pack_benchmark(std::shared_ptr<ExecutionConfiguration> exec_conf, const std::string& name)
+    {
+    for_each_lattice(exec_conf, [&](std::shared_ptr<SystemDefinition> sysdef, const std::string& config,
+                                    const std::vector<std::pair<std::string, double> >& params)
+        {
+        if (!benchmarks.selected(name, config))
+            return;
+
+        std::shared_ptr<Trigger> trigger(new PeriodicTrigger(1));
+        std::shared_ptr<SFCPackTuner> sorter(new Sorter(sysdef, trigger));
+        benchmarks.run(exec_conf, name, config, params, sysdef->getParticleData()->getN(), 0,
+                       [sorter, exec_conf](unsigned int n)
+                            {
+                            return benchmark_loop([&](unsigned int i)
+                                {
+                                sorter->update(i);
+                                #ifdef ENABLE_HIP
+                                if (exec_conf->isCUDAEnabled())
+                                    hipDeviceSynchronize();
+                                #endif
+                                }, n);
+                            });
+        });
+    }
+
+//! Benchmark GSDDumpWriter::analyze
+/*! Writes to a temporary file in the working directory and reports the bytes written per second.
+ */
+void gsd_write_benchmark(std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    const std::string name = "GSDDumpWriter";
+    for_each_lattice(exec_conf, [&](std::shared_ptr<SystemDefinition> sysdef, const std::string& config,
+                                    const std::vector<std::pair<std::string, double> >& params)
+        {
+        if (!benchmarks.selected(name, config))
+            return;
+
+        std::string fname = "benchmark_core_" + std::to_string(getpid()) + ".gsd";
+        std::shared_ptr<ParticleGroup> group(new ParticleGroup(sysdef,
+            std::shared_ptr<ParticleFilter>(new ParticleFilterAll())));
+        std::shared_ptr<GSDDumpWriter> writer(new GSDDumpWriter(sysdef, fname, group, "wb", true));
+
+        // write every frame with the same time step, GSD does not require increasing steps
+        unsigned int frames = 0;
+        BenchmarkResult& result = benchmarks.run(exec_conf, name, config, params,
+                                                 sysdef->getParticleData()->getN(), 0,
+            [writer, &frames](unsigned int n)
+                {
+                return benchmark_loop([&](unsigned int) { writer->analyze(frames++); }, n);
+                });
+
+        // flush by closing the file, then measure its size
+        writer.reset();
+        struct stat st;
+        UP_ASSERT_EQUAL(stat(fname.c_str(), &st), 0);
+        UP_ASSERT(frames > 0);
+        double bytes_per_frame = double(st.st_size) / double(frames);
+        result.metrics["bytes_per_frame"] = bytes_per_frame;
+        result.metrics["bytes_per_s"] = bytes_per_frame / result.metrics["time_ns"] * 1e9;
+        remove(fname.c_str());
+        });
+    }
+
+UP_TEST( CellList_benchmark )
+    {
+    cell_list_benchmark<CellList>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)), "CellList");
+    }
+
+UP_TEST( SFCPackTuner_benchmark )
+    {
+    sfc_pack_benchmark<SFCPackTuner>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)), "SFCPackTuner");
+    }
+
+UP_TEST( GSDDumpWriter_benchmark )
+    {
+    gsd_write_benchmark(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+
+#ifdef ENABLE_HIP
+UP_TEST( CellListGPU_benchmark )
+    {
+    cell_list_benchmark<CellListGPU>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU)), "CellListGPU");
+    }
+
+UP_TEST( SFCPackTunerGPU_benchmark )
+    {
+    sfc_pack_benchmark<SFCPackTunerGPU>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU)), "SFCPackTunerGPU");
+    }
+#endif
@@ -0,0 +1,68 @@
+# Copyright (c) 2009-2021 The Regents of the University of Michigan
+# This file is part of the HOOMD-blue project, released under the BSD 3-Clause
+# License.
+
+"""Compare two sets of microbenchmark results.
+
+Usage::
+
+    python3 compare_benchmarks.py baseline.json new.json [--threshold 0.1]
+
+Lists the ratio of the median time of every benchmark present in both files
+and exits with a non-zero status when any benchmark is slower than the baseline
+by more than the threshold (a fraction of the baseline time).
+"""
+
+import argparse
+import json
+import sys
+
+
+def load(filename):
+    """Load benchmark results keyed by name, configuration, and parameters."""
+    with open(filename) as f:
+        data = json.load(f)
+
+    results = {}
+    for b in data['benchmarks']:
+        params = ' '.join(
+            f'{k}={v:g}' for k, v in sorted(b['params'].items()))
+        key = (b['name'], b['config'], b.get('mode', 'cpu'), b['N'], params)
+        results[key] = b
+    return data['context'], results
+
+
+def main():
+    """Compare the benchmark results."""
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[0])
+    parser.add_argument('baseline')
+    parser.add_argument('new')
+    parser.add_argument('--threshold', type=float, default=0.1)
+    args = parser.parse_args()
+
+    base_context, base = load(args.baseline)
+    new_context, new = load(args.new)
+    print(f"baseline: {base_context['hoomd_version']} {base_context['date']}")
+    print(f"new:      {new_context['hoomd_version']} {new_context['date']}")
+
+    regressions = 0
+    for key in sorted(base.keys() & new.keys()):
+        ratio = new[key]['time_ns'] / base[key]['time_ns']
+        name, config, mode, N, params = key
+        flag = ''
+        if ratio > 1 + args.threshold:
+            flag = ' SLOWER'
+            regressions += 1
+        elif ratio < 1 - args.threshold:
+            flag = ' faster'
+        print(f'{name:32} {config:10} {mode:4} N={N:<8} {params:24} '
+              f'{ratio:6.3f}{flag}')
+
+    for key in sorted(base.keys() - new.keys()):
+        print(f'missing in {args.new}: {key}')
+
+    return 1 if regressions else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -62,6 +62,12 @@ class PYBIND11_EXPORT ParticleFilterType : public ParticleFilter
             return member_tags;
             }
 
+        /// Get the names of the selected types
+        const std::unordered_set<std::string>& getTypes() const
+            {
+            return m_types;
+            }
+
     protected:
         std::unordered_set<std::string> m_types;   ///< Set of types to select
     };
@@ -22,6 +22,10 @@
 #include <pybind11/pybind11.h>
 #endif
 
+#ifdef ENABLE_TBB
+#include <tbb/parallel_for.h>
+#endif
+
 namespace hpmc
 {
 
@@ -69,15 +73,17 @@ bool test_scaled_overlap(const vec3<Scalar>& r_ij,
 
     \b Computing \f$ \lambda \f$ <br>
 
-    In the initial version of the code, a completely general way of computing *\f$ \lambda \f$* is implemented.
-    It uses a binary search tree and the existing test_overlap code to find which bin a given pair of particles sits in.
-    Future versions of the code may use shape specific data to compute *\f$ \lambda \f$* directly.
+    Shapes that specialize contact_scale (see HasContactScale) compute *\f$ \lambda \f$* directly from the scale
+    factor of the separation at which the pair touches, with one query per pair. For all other shapes, a completely
+    general method is used: a binary search over the bins with the existing test_overlap code finds which bin a given
+    pair of particles sits in.
 
     Outside of that AnalyzerSDF is a pretty basic histogramming code. The only other notable features in the design
     are:
       - Suitably chosen navg results in the average being written out just before a restart - enabling full restart
         capabilities.
       - Fully uses the MPI domain decomposition to compute the SDF fast in large jobs.
+      - Particles on the local rank are processed in parallel with TBB.
 
     \b Storage <br>
 
@@ -140,6 +146,7 @@ class AnalyzerSDF : public Analyzer
         bool m_is_initialized;                  //!< Bool indicating if we have initialized the file yet
         bool m_appending;                       //!< Flag indicating this file is being appended to
         std::vector<unsigned int> m_hist;       //!< Raw histogram data
+        std::vector<size_t> m_min_bin;          //!< Minimum bin of each local particle
 
         unsigned int m_iavg;                    //!< Current count of the number of steps averaged
         Scalar m_last_max_diam;                 //!< Last recorded maximum diameter
@@ -343,8 +350,17 @@ void AnalyzerSDF<Shape>::countHistogram(unsigned int timestep)
 
     const std::vector<param_type, managed_allocator<param_type> > & params = m_mc->getParams();
 
+    const unsigned int N = m_pdata->getN();
+    m_min_bin.resize(N);
+
     // loop through N particles
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
+    #ifdef ENABLE_TBB
+    tbb::parallel_for(tbb::blocked_range<unsigned int>(0, N),
+        [&](const tbb::blocked_range<unsigned int>& r) {
+    for (unsigned int i = r.begin(); i != r.end(); ++i)
+    #else
+    for (unsigned int i = 0; i < N; i++)
+    #endif
         {
         size_t min_bin = m_hist.size();
 
@@ -407,11 +423,18 @@ void AnalyzerSDF<Shape>::countHistogram(unsigned int timestep)
                 } // end loop over AABB nodes
             } // end loop over images
 
-        // record the minimum bin
-        if ((unsigned int)min_bin < m_hist.size())
-            m_hist[min_bin]++;
-
+        m_min_bin[i] = min_bin;
         } // end loop over all particles
+    #ifdef ENABLE_TBB
+        });
+    #endif
+
+    // record the minimum bins
+    for (unsigned int i = 0; i < N; i++)
+        {
+        if (m_min_bin[i] < m_hist.size())
+            m_hist[m_min_bin[i]]++;
+        }
     }
 
 /*! \param r_ij Vector pointing from particle i to j (already wrapped into the box)
@@ -422,7 +445,10 @@ void AnalyzerSDF<Shape>::countHistogram(unsigned int timestep)
 
     \returns s bin index
 
-    In the first general version, computeBin uses a binary search tree to determine
+    When the shape specializes contact_scale, computeBin computes the scale factor at which the
+    pair touches, and the bin follows from \f$ \lambda = 1 - s \f$ directly.
+
+    Otherwise, computeBin uses a binary search tree to determine
     the bin. In this way, only a test_overlap method is needed, no extra math. The
     binary search works by first ensuring that the particle does not overlap at the
     left boundary and does overlap a the right. Then it picks a new point halfway between
@@ -436,6 +462,30 @@ size_t AnalyzerSDF<Shape>:: computeBin(const vec3<Scalar>& r_ij,
                              const typename Shape::param_type& params_i,
                              const typename Shape::param_type& params_j)
     {
+    if (HasContactScale<Shape>::value)
+        {
+        // coincident particles overlap at any scale
+        if (dot(r_ij, r_ij) == Scalar(0.0))
+            return -1;
+
+        // need a dummy error counter
+        unsigned int dummy = 0;
+
+        Shape shape_i(orientation_i, params_i);
+        Shape shape_j(orientation_j, params_j);
+        Scalar lambda = Scalar(1.0) - Scalar(contact_scale(r_ij, shape_i, shape_j, dummy));
+
+        // the particles already overlap at the left boundary
+        if (lambda <= Scalar(0.0))
+            return -1;
+
+        // the particles do not overlap at the right boundary
+        if (lambda >= double(m_hist.size())*m_dl)
+            return m_hist.size();
+
+        return std::min(size_t(lambda / m_dl), m_hist.size() - 1);
+        }
+
     size_t L=0;
     size_t R=m_hist.size();
 
@@ -25,10 +25,38 @@
 
 #include <pybind11/pybind11.h>
 
+#ifdef ENABLE_TBB
+#include <tbb/parallel_reduce.h>
+#endif
+
 
 namespace hpmc
 {
 
+namespace detail
+{
+
+//! Radical inverse of an integer, the Halton sequence in one dimension
+/*! \param i Index in the sequence
+    \param base Prime base of this dimension
+    \returns the digits of \a i in base \a base, mirrored at the decimal point
+*/
+inline Scalar radicalInverse(unsigned int i, unsigned int base)
+    {
+    Scalar inv_base = Scalar(1.0)/Scalar(base);
+    Scalar f = inv_base;
+    Scalar result(0.0);
+    while (i > 0)
+        {
+        result += f*Scalar(i % base);
+        i /= base;
+        f *= inv_base;
+        }
+    return result;
+    }
+
+} // end namespace detail
+
 //! Template class for a free volume integration analyzer
 /*!
     \ingroup hpmc_integrators
@@ -52,6 +80,49 @@ class ComputeFreeVolume : public Compute
             m_n_sample = n_sample;
             }
 
+        //! Get the number of MC samples
+        unsigned int getNumSamples()
+            {
+            return m_n_sample;
+            }
+
+        //! Get the number of MC samples taken in the last computation, on all ranks
+        unsigned int getNumSamplesTaken()
+            {
+            return m_n_sample_taken;
+            }
+
+        //! Set whether to place the test particles on a quasi-random (Halton) sequence
+        void setQuasiRandom(bool quasi_random)
+            {
+            m_quasi_random = quasi_random;
+            }
+
+        //! Get whether the test particles are placed on a quasi-random sequence
+        bool getQuasiRandom()
+            {
+            return m_quasi_random;
+            }
+
+        //! Set the relative error of the free volume at which to stop sampling
+        /*! \param target_rel_error Target relative error, 0 to always perform the number of samples set
+         */
+        void setTargetRelativeError(Scalar target_rel_error)
+            {
+            if (target_rel_error < Scalar(0.0))
+                {
+                m_exec_conf->msg->error() << "compute.free_volume: target_rel_error must be non-negative" << std::endl;
+                throw std::runtime_error("Error setting free volume parameters");
+                }
+            m_target_rel_error = target_rel_error;
+            }
+
+        //! Get the target relative error
+        Scalar getTargetRelativeError()
+            {
+            return m_target_rel_error;
+            }
+
         //! Set the type of depletant particle
         void setTestParticleType(unsigned int type)
             {
@@ -84,6 +155,9 @@ class ComputeFreeVolume : public Compute
 
         unsigned int m_type;                                     //!< Type of depletant particle to generate
         unsigned int m_n_sample;                                 //!< Number of sampling depletants to generate
+        unsigned int m_n_sample_taken;                           //!< Number of depletants generated in the last compute
+        bool m_quasi_random;                                     //!< True if positions follow a Halton sequence
+        Scalar m_target_rel_error;                               //!< Stop sampling at this relative error (if > 0)
         unsigned int m_seed;                                     //!< The RNG seed
         const std::string m_suffix;                              //!< Log suffix
 
@@ -97,7 +171,8 @@ ComputeFreeVolume< Shape >::ComputeFreeVolume(std::shared_ptr<SystemDefinition>
                                                     std::shared_ptr<CellList> cl,
                                                     unsigned int seed,
                                                     std::string suffix)
-    : Compute(sysdef), m_mc(mc), m_cl(cl), m_type(0), m_n_sample(0), m_seed(seed), m_suffix(suffix)
+    : Compute(sysdef), m_mc(mc), m_cl(cl), m_type(0), m_n_sample(0), m_n_sample_taken(0),
+      m_quasi_random(false), m_target_rel_error(0.0), m_seed(seed), m_suffix(suffix)
     {
     this->m_exec_conf->msg->notice(5) << "Constructing ComputeFreeVolume" << std::endl;
 
@@ -130,14 +205,23 @@ void ComputeFreeVolume<Shape>::compute(unsigned int timestep)
     }
 
 /*! \return the current free volume estimate by MC integration
+
+    The test particles are sampled in batches when a target relative error is set, and sampling stops at the first
+    batch after which the binomial standard error of the free volume fraction falls below the target. The samples
+    within a batch are processed in parallel.
 */
 template<class Shape>
 void ComputeFreeVolume<Shape>::computeFreeVolume(unsigned int timestep)
     {
     unsigned int overlap_count = 0;
-    unsigned int err_count = 0;
+    unsigned int n_sample_taken = 0;
     unsigned int ndim = this->m_sysdef->getNDimensions();
 
+    unsigned int n_ranks = 1;
+    #ifdef ENABLE_MPI
+    n_ranks = this->m_exec_conf->getNRanks();
+    #endif
+
     this->m_exec_conf->msg->notice(5) << "HPMC computing free volume " << timestep << std::endl;
 
     // update AABB tree
@@ -148,8 +232,9 @@ void ComputeFreeVolume<Shape>::computeFreeVolume(unsigned int timestep)
 
     if (m_prof) m_prof->push("Free volume");
 
-    // only check if AABB tree is populated
-    if (m_pdata->getN() + m_pdata->getNGhosts())
+    // only check if AABB tree is populated, all ranks take part in the batches below
+    bool has_particles = m_pdata->getN() + m_pdata->getNGhosts() > 0;
+
         {
         // access particle data and system box
         ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(), access_location::host, access_mode::read);
@@ -163,22 +248,41 @@ void ComputeFreeVolume<Shape>::computeFreeVolume(unsigned int timestep)
         const Index2D& overlap_idx = m_mc->getOverlapIndexer();
 
         // generate n_sample random test depletants in the global box
-        unsigned int n_sample = m_n_sample;
+        unsigned int n_sample = m_n_sample / n_ranks;
 
-        #ifdef ENABLE_MPI
-        n_sample /= this->m_exec_conf->getNRanks();
-        #endif
+        // randomly shift the quasi-random sequence (Cranley-Patterson rotation), so that the estimate is unbiased
+        hoomd::RandomGenerator rng_shift(hoomd::RNGIdentifier::ComputeFreeVolumeShift, m_seed, m_exec_conf->getRank(), timestep);
+        Scalar3 shift;
+        shift.x = hoomd::detail::generate_canonical<Scalar>(rng_shift);
+        shift.y = hoomd::detail::generate_canonical<Scalar>(rng_shift);
+        shift.z = hoomd::detail::generate_canonical<Scalar>(rng_shift);
 
-        for (unsigned int i = 0; i < n_sample; i++)
+        // test if the i-th test depletant overlaps with any particle
+        auto test_sample = [&](unsigned int i) -> bool
             {
+            if (!has_particles)
+                return false;
+
             // select a random particle coordinate in the box
             hoomd::RandomGenerator rng_i(hoomd::RNGIdentifier::ComputeFreeVolume, m_seed, m_exec_conf->getRank(), i, timestep);
 
-            Scalar xrand = hoomd::detail::generate_canonical<Scalar>(rng_i);
-            Scalar yrand = hoomd::detail::generate_canonical<Scalar>(rng_i);
-            Scalar zrand = hoomd::detail::generate_canonical<Scalar>(rng_i);
+            Scalar3 f;
+            if (m_quasi_random)
+                {
+                f.x = detail::radicalInverse(i, 2) + shift.x;
+                f.y = detail::radicalInverse(i, 3) + shift.y;
+                f.z = detail::radicalInverse(i, 5) + shift.z;
+                f.x -= floor(f.x);
+                f.y -= floor(f.y);
+                f.z -= floor(f.z);
+                }
+            else
+                {
+                f.x = hoomd::detail::generate_canonical<Scalar>(rng_i);
+                f.y = hoomd::detail::generate_canonical<Scalar>(rng_i);
+                f.z = hoomd::detail::generate_canonical<Scalar>(rng_i);
+                }
 
-            Scalar3 f = make_scalar3(xrand, yrand, zrand);
             vec3<Scalar> pos_i = vec3<Scalar>(box.makeCoordinates(f));
 
             Shape shape_i(quat<Scalar>(), params[m_type]);
@@ -188,7 +292,7 @@ void ComputeFreeVolume<Shape>::computeFreeVolume(unsigned int timestep)
                 }
 
             // check for overlaps with neighboring particle's positions
-            bool overlap=false;
+            unsigned int err_count = 0;
             detail::AABB aabb_i_local = shape_i.getAABB(vec3<Scalar>(0,0,0));
 
             // All image boxes (including the primary)
@@ -228,8 +332,7 @@ void ComputeFreeVolume<Shape>::computeFreeVolume(unsigned int timestep)
                                     && check_circumsphere_overlap(r_ij, shape_i, shape_j)
                                     && test_overlap(r_ij, shape_i, shape_j, err_count))
                                     {
-                                    overlap = true;
-                                    break;
+                                    return true;
                                     }
                                 }
                             }
@@ -239,21 +342,67 @@ void ComputeFreeVolume<Shape>::computeFreeVolume(unsigned int timestep)
                         // skip ahead
                         cur_node_idx += aabb_tree.getNodeSkip(cur_node_idx);
                         }
-
-                    if (overlap)
-                        break;
                     }  // end loop over AABB nodes
-
-                if (overlap)
-                    break;
                 } // end loop over images
 
-            if (overlap)
+            return false;
+            };
+
+        // without a target error, take all samples at once
+        unsigned int n_batch = n_sample;
+        if (m_target_rel_error > Scalar(0.0))
+            n_batch = std::min(n_sample, std::max(n_sample/64, 1024u));
+
+        while (n_sample_taken < n_sample)
+            {
+            unsigned int begin = n_sample_taken;
+            unsigned int end = std::min(n_sample, begin + n_batch);
+
+            #ifdef ENABLE_TBB
+            overlap_count += tbb::parallel_reduce(tbb::blocked_range<unsigned int>(begin, end),
+                0u,
+                [&](const tbb::blocked_range<unsigned int>& r, unsigned int count)->unsigned int {
+                for (unsigned int i = r.begin(); i != r.end(); ++i)
+            #else
+            for (unsigned int i = begin; i < end; ++i)
+            #endif
                 {
-                overlap_count++;
+                if (test_sample(i))
+                    {
+                    #ifdef ENABLE_TBB
+                    count++;
+                    #else
+                    overlap_count++;
+                    #endif
+                    }
+                } // end loop through all samples
+            #ifdef ENABLE_TBB
+            return count;
+            }, [](unsigned int x, unsigned int y)->unsigned int { return x+y; } );
+            #endif
+
+            n_sample_taken = end;
+
+            if (m_target_rel_error > Scalar(0.0) && n_sample_taken < n_sample)
+                {
+                // all ranks take the same decision
+                unsigned int counts[2] = {overlap_count, n_sample_taken};
+                #ifdef ENABLE_MPI
+                if (m_comm)
+                    {
+                    MPI_Allreduce(MPI_IN_PLACE, counts, 2, MPI_UNSIGNED, MPI_SUM, m_exec_conf->getMPICommunicator());
+                    }
+                #endif
+
+                // relative standard error of the free volume fraction 1-p, with p estimated as (k+1)/(n+2) to avoid
+                // a vanishing error estimate before the first overlap (or free sample) has been found
+                Scalar n = Scalar(counts[1]);
+                Scalar p = (Scalar(counts[0]) + Scalar(1.0))/(n + Scalar(2.0));
+                Scalar rel_error = sqrt(p/((Scalar(1.0)-p)*n));
+                if (rel_error <= m_target_rel_error)
+                    break;
                 }
-            } // end loop through all particles
-
+            }
         } // end lexical scope
 
     #ifdef ENABLE_MPI
@@ -265,6 +414,8 @@ void ComputeFreeVolume<Shape>::computeFreeVolume(unsigned int timestep)
 
     if (m_prof) m_prof->pop();
 
+    m_n_sample_taken = n_sample_taken * n_ranks;
+
     ArrayHandle<unsigned int> h_n_overlap_all(m_n_overlap_all, access_location::host, access_mode::overwrite);
     *h_n_overlap_all.data = overlap_count;
     }
@@ -284,15 +435,8 @@ Scalar ComputeFreeVolume<Shape>::getLogValue(const std::string& quantity, unsign
         // access counters
         ArrayHandle<unsigned int> h_n_overlap_all(m_n_overlap_all, access_location::host, access_mode::read);
 
-        // generate n_sample random test depletants in the global box
-        unsigned int n_sample = m_n_sample;
-
-        #ifdef ENABLE_MPI
-        // in MPI, for small n_sample we can encounter round-off issues
-        unsigned int n_ranks = this->m_exec_conf->getNRanks();
-        n_sample = (n_sample/n_ranks)*n_ranks;
-        #endif
-
+        // number of test depletants generated on all ranks
+        unsigned int n_sample = m_n_sample_taken;
 
         // total free volume
         const BoxDim& global_box = this->m_pdata->getGlobalBox();
@@ -317,6 +461,10 @@ template < class Shape > void export_ComputeFreeVolume(pybind11::module& m, cons
                 std::string >())
         .def("setNumSamples", &ComputeFreeVolume<Shape>::setNumSamples)
         .def("setTestParticleType", &ComputeFreeVolume<Shape>::setTestParticleType)
+        .def_property("quasi_random", &ComputeFreeVolume<Shape>::getQuasiRandom,
+                      &ComputeFreeVolume<Shape>::setQuasiRandom)
+        .def_property("target_rel_error", &ComputeFreeVolume<Shape>::getTargetRelativeError,
+                      &ComputeFreeVolume<Shape>::setTargetRelativeError)
         ;
     }
 
@@ -237,6 +237,9 @@ void ComputeFreeVolumeGPU<Shape>::computeFreeVolume(unsigned int timestep)
 
         #ifdef ENABLE_MPI
         n_sample /= this->m_exec_conf->getNRanks();
+        this->m_n_sample_taken = n_sample * this->m_exec_conf->getNRanks();
+        #else
+        this->m_n_sample_taken = n_sample;
         #endif
 
         detail::hpmc_free_volume_args_t free_volume_args(n_sample,
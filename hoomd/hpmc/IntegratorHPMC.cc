@@ -21,6 +21,8 @@ IntegratorHPMC::IntegratorHPMC(std::shared_ptr<SystemDefinition> sysdef,
                                unsigned int seed)
     : Integrator(sysdef, 0.005), m_seed(seed),  m_translation_move_probability(32768), m_nselect(4),
       m_nominal_width(1.0), m_extra_ghost_width(0), m_external_base(NULL), m_patch_log(false),
+      m_patch_energy(0.0), m_patch_energy_delta(0.0), m_patch_energy_valid(false), m_patch_energy_n_updates(0),
+      m_patch_energy_resync_period(100), m_patch_energy_pos_version(0), m_patch_energy_orientation_version(0),
       m_past_first_run(false)
       #ifdef ENABLE_MPI
       ,m_communicator_ghost_width_connected(false),
@@ -238,6 +240,18 @@ bool IntegratorHPMC::checkParticleOrientations()
     \returns false if resize results in overlaps
 */
 bool IntegratorHPMC::attemptBoxResize(unsigned int timestep, const BoxDim& new_box)
+    {
+    scaleParticlesToBox(new_box);
+
+    // check overlaps
+    return !this->countOverlaps(true);
+    }
+
+/*! \param new_box new box dimensions
+
+    Scales the particle positions with the box, sets the new box and communicates the moved particles.
+*/
+void IntegratorHPMC::scaleParticlesToBox(const BoxDim& new_box)
     {
     unsigned int N = m_pdata->getN();
 
@@ -269,9 +283,6 @@ bool IntegratorHPMC::attemptBoxResize(unsigned int timestep, const BoxDim& new_b
 
     // we have moved particles, communicate those changes
     this->communicate(false);
-
-    // check overlaps
-    return !this->countOverlaps(true);
     }
 
 /*! \param mode 0 -> Absolute count, 1 -> relative to the start of the run, 2 -> relative to the last executed step
@@ -447,16 +447,99 @@ class PYBIND11_EXPORT IntegratorHPMC : public Integrator
             return 0.0;
             }
 
+        //! Get the total patch energy, tracked incrementally between full evaluations
+        /*! \param timestep the current time step
+            \returns the total patch energy
+
+            The energy changes of the local moves accepted since the last call are added to the cached value. The
+            total is computed in full with computePatchEnergy() when no valid value is cached, when the positions
+            or orientations were modified since the value was cached by anything other than the integrator (e.g. a
+            custom updater), and after getPatchEnergyResyncPeriod() incremental updates, which bounds the round-off
+            accumulated from the single precision energy differences.
+        */
+        double getTotalPatchEnergy(unsigned int timestep)
+            {
+            // local energy change and number of ranks with a stale total
+            double buf[2] = {m_patch_energy_delta, isTotalPatchEnergyCurrent() ? 0.0 : 1.0};
+            #ifdef ENABLE_MPI
+            if (m_pdata->getDomainDecomposition())
+                {
+                MPI_Allreduce(MPI_IN_PLACE, buf, 2, MPI_DOUBLE, MPI_SUM, m_exec_conf->getMPICommunicator());
+                }
+            #endif
+
+            if (buf[1] > 0.0 || m_patch_energy_n_updates >= m_patch_energy_resync_period)
+                {
+                setTotalPatchEnergy(computePatchEnergy(timestep));
+                }
+            else
+                {
+                m_patch_energy += buf[0];
+                m_patch_energy_delta = 0.0;
+                }
+            return m_patch_energy;
+            }
+
+        //! Set the total patch energy of the current configuration
+        /*! \param energy total patch energy from a full evaluation, e.g. after a collective move
+        */
+        void setTotalPatchEnergy(double energy)
+            {
+            m_patch_energy = energy;
+            m_patch_energy_delta = 0.0;
+            m_patch_energy_valid = true;
+            m_patch_energy_n_updates = 0;
+            recordPatchEnergyVersion();
+            }
+
+        //! Restore the total patch energy of a configuration after a rejected collective move
+        /*! \param energy total patch energy of the restored configuration, as returned by getTotalPatchEnergy()
+
+            The restored value counts as an incremental update, since it was not evaluated in full.
+        */
+        void restoreTotalPatchEnergy(double energy)
+            {
+            m_patch_energy = energy;
+            m_patch_energy_delta = 0.0;
+            m_patch_energy_valid = true;
+            m_patch_energy_n_updates++;
+            recordPatchEnergyVersion();
+            }
+
+        //! Invalidate the cached total patch energy
+        /*! Call after any change to the particles that is not tracked by the local moves.
+        */
+        void invalidateTotalPatchEnergy()
+            {
+            m_patch_energy_valid = false;
+            }
+
+        //! Set the number of incremental updates after which the total patch energy is recomputed in full
+        void setPatchEnergyResyncPeriod(unsigned int period)
+            {
+            m_patch_energy_resync_period = period;
+            }
+
+        //! Get the number of incremental updates after which the total patch energy is recomputed in full
+        unsigned int getPatchEnergyResyncPeriod()
+            {
+            return m_patch_energy_resync_period;
+            }
+
         //! Prepare for the run
         virtual void prepRun(unsigned int timestep)
             {
             m_past_first_run = true;
+
+            // particles may have been modified between runs
+            m_patch_energy_valid = false;
             }
 
         //! Set the patch energy
         virtual void setPatchEnergy(std::shared_ptr< PatchEnergy > patch)
             {
             m_patch = patch;
+            m_patch_energy_valid = false;
             }
 
         //! Enable the patch energy only for logging
@@ -465,6 +548,7 @@ class PYBIND11_EXPORT IntegratorHPMC : public Integrator
         void disablePatchEnergyLogOnly(bool log)
             {
             m_patch_log = log;
+            m_patch_energy_valid = false;
             }
 
         //! Get the seed
@@ -501,6 +585,9 @@ class PYBIND11_EXPORT IntegratorHPMC : public Integrator
         #endif
 
     protected:
+        //! Scale the particle positions with the box and set the new box
+        void scaleParticlesToBox(const BoxDim& new_box);
+
         unsigned int m_seed;                        //!< Random number seed
         unsigned int m_translation_move_probability;     //!< Fraction of moves that are translation moves.
         unsigned int m_nselect;                     //!< Number of particles to select for trial moves
@@ -522,6 +609,14 @@ class PYBIND11_EXPORT IntegratorHPMC : public Integrator
         std::shared_ptr< PatchEnergy > m_patch;     //!< Patchy Interaction
         bool m_patch_log;                           //!< If true, only use patch energy for logging
 
+        double m_patch_energy;                      //!< Cached total patch energy
+        double m_patch_energy_delta;                //!< Local patch energy change of accepted moves not yet in the total
+        bool m_patch_energy_valid;                  //!< True when m_patch_energy holds the current total
+        unsigned int m_patch_energy_n_updates;      //!< Number of incremental updates since the last full evaluation
+        unsigned int m_patch_energy_resync_period;  //!< Number of incremental updates between full evaluations
+        uint64_t m_patch_energy_pos_version;        //!< Version of the positions tracked by m_patch_energy
+        uint64_t m_patch_energy_orientation_version; //!< Version of the orientations tracked by m_patch_energy
+
         bool m_past_first_run;                      //!< Flag to test if the first run() has started
         //! Update the nominal width of the cells
         /*! This method is virtual so that derived classes can set appropriate widths
@@ -531,6 +626,21 @@ class PYBIND11_EXPORT IntegratorHPMC : public Integrator
             {
             }
 
+        //! Check whether the cached total patch energy still describes the local particles
+        bool isTotalPatchEnergyCurrent()
+            {
+            return m_patch_energy_valid
+                && m_pdata->getPositions().getVersion() == m_patch_energy_pos_version
+                && m_pdata->getOrientationArray().getVersion() == m_patch_energy_orientation_version;
+            }
+
+        //! Record the versions of the particle data arrays that the cached total patch energy describes
+        void recordPatchEnergyVersion()
+            {
+            m_patch_energy_pos_version = m_pdata->getPositions().getVersion();
+            m_patch_energy_orientation_version = m_pdata->getOrientationArray().getVersion();
+            }
+
         //! Return the requested ghost layer width
         virtual Scalar getGhostLayerWidth(unsigned int)
             {
@@ -9,9 +9,11 @@
     \brief Declaration of IntegratorHPMC
 */
 
+#include <algorithm>
 #include <iostream>
 #include <iomanip>
 #include <sstream>
+#include <unordered_map>
 
 #include "hoomd/Integrator.h"
 #include "HPMCPrecisionSetup.h"
@@ -26,6 +28,7 @@
 #include "ShapeSpheropolyhedron.h"
 
 #ifdef ENABLE_TBB
+#include <atomic>
 #include <thread>
 #include <tbb/blocked_range.h>
 #include <tbb/enumerable_thread_specific.h>
@@ -40,6 +43,7 @@
 
 #ifndef __HIPCC__
 #include <pybind11/pybind11.h>
+#include <Eigen/Dense>
 #endif
 
 namespace hpmc
@@ -468,6 +472,36 @@ class IntegratorHPMCMono : public IntegratorHPMC
         bool m_quermass;                                         //!< True if quermass integration mode is enabled
         Scalar m_sweep_radius;                                   //!< Radius of sphere to sweep shapes by
 
+        /* Contact list for box moves */
+
+        std::vector< std::pair<unsigned int, unsigned int> > m_contact_list; //!< Particle pairs within m_contact_r_list
+        std::vector<Scalar3> m_contact_ref_fraction;  //!< Fractional particle coordinates when the list was built
+        BoxDim m_contact_ref_box;                     //!< Global box when the contact list was built
+        Scalar m_contact_r_list;                      //!< Cutoff distance of the contact list
+        bool m_contact_list_valid;                    //!< True if the contact list may be used
+
+        /* Separating axes of nearby pairs, keyed by the pair of tags, lower tag first. Each axis points from the
+           particle with the lower tag towards the one with the higher tag. Only kept for shapes with
+           UsesSeparatingAxis. */
+        std::unordered_map<uint64_t, vec3<OverlapReal> > m_sep_axis_cache;
+
+        //! Test for overlap in a trial move, starting from the separating axis last found for the pair
+        inline bool testOverlapCached(unsigned int tag_i, unsigned int tag_j, const vec3<Scalar>& r_ij,
+                                      const Shape& shape_i, const Shape& shape_j, unsigned int& err)
+            {
+            // periodic images of the same particle would share an entry
+            if (!UsesSeparatingAxis<Shape>::value || tag_i == tag_j)
+                return test_overlap(r_ij, shape_i, shape_j, err);
+
+            const bool flip = tag_i > tag_j;
+            const uint64_t key = flip ? (uint64_t(tag_j) << 32 | tag_i) : (uint64_t(tag_i) << 32 | tag_j);
+            vec3<OverlapReal>& cached_axis = m_sep_axis_cache[key];
+            vec3<OverlapReal> axis = flip ? -cached_axis : cached_axis;
+            bool overlap = test_overlap_warm(r_ij, shape_i, shape_j, err, axis);
+            cached_axis = flip ? -axis : axis;
+            return overlap;
+            }
+
         //! Test whether to reject the current particle move based on depletants
         #ifndef ENABLE_TBB
         inline bool checkDepletantOverlap(unsigned int i, vec3<Scalar> pos_i, Shape shape_i, unsigned int typ_i,
@@ -481,6 +515,12 @@ class IntegratorHPMCMono : public IntegratorHPMC
             tbb::enumerable_thread_specific< hoomd::RandomGenerator >& rng_depletants_parallel);
         #endif
 
+        //! Check for overlaps after a box change using the contact list
+        bool checkContactOverlaps();
+
+        //! Check for overlaps with the AABB tree and rebuild the contact list
+        bool rebuildContactList(Scalar d_max);
+
         //! Set the nominal width appropriate for looped moves
         virtual void updateCellWidth();
 
@@ -498,12 +538,17 @@ class IntegratorHPMCMono : public IntegratorHPMC
             // anything that changes the box (i.e. NPT, box_resize) is also moving the particles,
             // so use it as a sign to rebuild the AABB tree
             m_aabb_tree_invalid = true;
+            m_patch_energy_valid = false;
             }
 
         //! callback so that the particle sort signal can invalidate the AABB tree
         virtual void slotSorted()
             {
             m_aabb_tree_invalid = true;
+            m_contact_list_valid = false;
+
+            // particles may have migrated, drop their separating axes
+            m_sep_axis_cache.clear();
             }
     };
 
@@ -517,7 +562,9 @@ IntegratorHPMCMono<Shape>::IntegratorHPMCMono(std::shared_ptr<SystemDefinition>
               m_hasOrientation(true),
               m_extra_image_width(0.0),
               m_quermass(false),
-              m_sweep_radius(0.0)
+              m_sweep_radius(0.0),
+              m_contact_r_list(0.0),
+              m_contact_list_valid(false)
     {
     // allocate the parameter storage, setting the managed flag
     m_params = std::vector<param_type, managed_allocator<param_type> >(m_pdata->getNTypes(),
@@ -756,6 +803,10 @@ void IntegratorHPMCMono<Shape>::update(unsigned int timestep)
     m_exec_conf->msg->notice(10) << "HPMCMono update: " << timestep << std::endl;
     IntegratorHPMC::update(timestep);
 
+    // the accepted moves can only be added to the total patch energy if nothing else modified the particles
+    if (!isTotalPatchEnergyCurrent())
+        m_patch_energy_valid = false;
+
     // get needed vars
     ArrayHandle<hpmc_counters_t> h_counters(m_count_total, access_location::host, access_mode::readwrite);
     hpmc_counters_t& counters = h_counters.data[0];
@@ -823,6 +874,10 @@ void IntegratorHPMCMono<Shape>::update(unsigned int timestep)
     // access interaction matrix
     ArrayHandle<unsigned int> h_overlaps(m_overlaps, access_location::host, access_mode::read);
 
+    // bound the memory held by separating axes of pairs that are no longer close
+    if (m_sep_axis_cache.size() > 32*size_t(m_pdata->getN() + m_pdata->getNGhosts()))
+        m_sep_axis_cache.clear();
+
     // loop over local particles nselect times
     for (unsigned int i_nselect = 0; i_nselect < m_nselect; i_nselect++)
         {
@@ -831,6 +886,7 @@ void IntegratorHPMCMono<Shape>::update(unsigned int timestep)
         ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::readwrite);
         ArrayHandle<Scalar> h_diameter(m_pdata->getDiameters(), access_location::host, access_mode::read);
         ArrayHandle<Scalar> h_charge(m_pdata->getCharges(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
 
         //access move sizes
         ArrayHandle<Scalar> h_d(m_d, access_location::host, access_mode::read);
@@ -977,7 +1033,8 @@ void IntegratorHPMCMono<Shape>::update(unsigned int timestep)
                                 counters.overlap_checks++;
                                 if (h_overlaps.data[m_overlap_idx(typ_i, typ_j)]
                                     && check_circumsphere_overlap(r_ij, shape_i, shape_j)
-                                    && test_overlap(r_ij, shape_i, shape_j, counters.overlap_err_count))
+                                    && testOverlapCached(h_tag.data[i], h_tag.data[j], r_ij, shape_i, shape_j,
+                                                         counters.overlap_err_count))
                                     {
                                     overlap = true;
                                     break;
@@ -1088,6 +1145,9 @@ void IntegratorHPMCMono<Shape>::update(unsigned int timestep)
                     } // end loop over images
                 } // end if (m_patch)
 
+            // patch contribution alone, for the incremental total patch energy
+            double patch_energy_diff = patch_field_energy_diff;
+
             // Add external energetic contribution
             if (m_external)
                 {
@@ -1127,6 +1187,9 @@ void IntegratorHPMCMono<Shape>::update(unsigned int timestep)
                 // update position of particle
                 h_postype.data[i] = make_scalar4(pos_i.x,pos_i.y,pos_i.z,postype_i.w);
 
+                // patch_energy_diff is U_old - U_new
+                m_patch_energy_delta -= patch_energy_diff;
+
                 if (shape_i.hasOrientation())
                     {
                     h_orientation.data[i] = quat_to_scalar4(shape_i.orientation);
@@ -1194,6 +1257,18 @@ void IntegratorHPMCMono<Shape>::update(unsigned int timestep)
     // all particle have been moved, the aabb tree is now invalid
     m_aabb_tree_invalid = true;
 
+    // the trial moves do not evaluate a log-only patch energy
+    if (m_patch_log)
+        {
+        m_patch_energy_valid = false;
+        }
+    else if (m_patch_energy_valid)
+        {
+        // the energy changes of the accepted moves are in m_patch_energy_delta
+        m_patch_energy_n_updates++;
+        recordPatchEnergyVersion();
+        }
+
     // set current MPS value
     hpmc_counters_t run_counters = getCounters(1);
     double cur_time = double(m_clock.getTime()) / Scalar(1e9);
@@ -1203,12 +1278,14 @@ void IntegratorHPMCMono<Shape>::update(unsigned int timestep)
 /*! \param timestep current step
     \param early_exit exit at first overlap found if true
     \returns number of overlaps if early_exit=false, 1 if early_exit=true
+
+    With TBB, the particles are split between threads. When \a early_exit is set, the first thread to find an
+    overlap signals the others to stop at their next particle.
 */
 template <class Shape>
 unsigned int IntegratorHPMCMono<Shape>::countOverlaps(bool early_exit)
     {
     unsigned int overlap_count = 0;
-    unsigned int err_count = 0;
 
     // build an up to date AABB tree
     buildAABBTree();
@@ -1226,8 +1303,24 @@ unsigned int IntegratorHPMCMono<Shape>::countOverlaps(bool early_exit)
     ArrayHandle<unsigned int> h_overlaps(m_overlaps, access_location::host, access_mode::read);
 
     // Loop over all particles
+    #ifdef ENABLE_TBB
+    std::atomic<bool> found_overlap(false);
+    overlap_count = tbb::parallel_reduce(tbb::blocked_range<unsigned int>(0, m_pdata->getN()),
+        0u,
+        [&](const tbb::blocked_range<unsigned int>& r, unsigned int overlap_count)->unsigned int {
+        for (unsigned int i = r.begin(); i != r.end(); ++i)
+    #else
     for (unsigned int i = 0; i < m_pdata->getN(); i++)
+    #endif
         {
+        #ifdef ENABLE_TBB
+        // another thread already found an overlap
+        if (early_exit && found_overlap.load(std::memory_order_relaxed))
+            break;
+        #endif
+
+        unsigned int err_count = 0;
+
         // read in the current position and orientation
         Scalar4 postype_i = h_postype.data[i];
         Scalar4 orientation_i = h_orientation.data[i];
@@ -1279,6 +1372,10 @@ unsigned int IntegratorHPMCMono<Shape>::countOverlaps(bool early_exit)
                                 overlap_count++;
                                 if (early_exit)
                                     {
+                                    #ifdef ENABLE_TBB
+                                    found_overlap.store(true, std::memory_order_relaxed);
+                                    #endif
+
                                     // exit early from loop over neighbor particles
                                     break;
                                     }
@@ -1309,6 +1406,14 @@ unsigned int IntegratorHPMCMono<Shape>::countOverlaps(bool early_exit)
             break;
             }
         } // end loop over particles
+    #ifdef ENABLE_TBB
+    return overlap_count;
+    }, [](unsigned int x, unsigned int y)->unsigned int { return x+y; } );
+
+    // more than one thread may have found an overlap before stopping
+    if (early_exit && overlap_count > 1)
+        overlap_count = 1;
+    #endif
 
     if (this->m_prof) this->m_prof->pop(this->m_exec_conf);
 
@@ -1361,8 +1466,8 @@ float IntegratorHPMCMono<Shape>::computePatchEnergy(unsigned int timestep)
     // Loop over all particles
     #ifdef ENABLE_TBB
     energy = tbb::parallel_reduce(tbb::blocked_range<unsigned int>(0, m_pdata->getN()),
-        0.0f,
-        [&](const tbb::blocked_range<unsigned int>& r, float energy)->float {
+        0.0,
+        [&](const tbb::blocked_range<unsigned int>& r, double energy)->double {
         for (unsigned int i = r.begin(); i != r.end(); ++i)
     #else
     for (unsigned int i = 0; i < m_pdata->getN(); i++)
@@ -1449,7 +1554,7 @@ float IntegratorHPMCMono<Shape>::computePatchEnergy(unsigned int timestep)
         } // end loop over particles
     #ifdef ENABLE_TBB
     return energy;
-    }, [](float x, float y)->float { return x+y; } );
+    }, [](double x, double y)->double { return x+y; } );
     #endif
 
     if (this->m_prof) this->m_prof->pop(this->m_exec_conf);
@@ -1553,6 +1658,7 @@ void IntegratorHPMCMono<Shape>::setParam(unsigned int typ,  const param_type& pa
         }
 
     updateCellWidth();
+    m_contact_list_valid = false;
     }
 
 template <class Shape>
@@ -1568,6 +1674,7 @@ void IntegratorHPMCMono<Shape>::setInteractionMatrix(std::pair<std::string, std:
     h_overlaps.data[m_overlap_idx(typj,typi)] = check_overlaps;
 
     m_image_list_valid = false;
+    m_contact_list_valid = false;
     }
 
 template <class Shape>
@@ -1938,6 +2045,8 @@ void IntegratorHPMCMono<Shape>::limitMoveDistances()
 
 /*! Function for finding all overlaps in a system by particle tag. returns an unraveled form of an NxN matrix
  * with true/false indicating the overlap status of the ith and jth particle
+ *
+ * The pairs are sorted by tag so that the result does not depend on the particle order or the number of threads.
  */
 template <class Shape>
 std::vector<std::pair<unsigned int, unsigned int> > IntegratorHPMCMono<Shape>::mapOverlaps()
@@ -1952,12 +2061,14 @@ std::vector<std::pair<unsigned int, unsigned int> > IntegratorHPMCMono<Shape>::m
 
     unsigned int N = m_pdata->getN();
 
+    #ifdef ENABLE_TBB
+    tbb::enumerable_thread_specific< std::vector<std::pair<unsigned int, unsigned int> > > thread_overlaps;
+    #else
     std::vector<std::pair<unsigned int, unsigned int> > overlap_vector;
+    #endif
 
     m_exec_conf->msg->notice(10) << "HPMC overlap mapping" << std::endl;
 
-    unsigned int err_count = 0;
-
     // build an up to date AABB tree
     buildAABBTree();
     // update the image list
@@ -1969,8 +2080,17 @@ std::vector<std::pair<unsigned int, unsigned int> > IntegratorHPMCMono<Shape>::m
     ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
 
     // Loop over all particles
+    #ifdef ENABLE_TBB
+    tbb::parallel_for(tbb::blocked_range<unsigned int>(0, N),
+        [&](const tbb::blocked_range<unsigned int>& r) {
+        std::vector<std::pair<unsigned int, unsigned int> >& overlap_vector = thread_overlaps.local();
+        for (unsigned int i = r.begin(); i != r.end(); ++i)
+    #else
     for (unsigned int i = 0; i < N; i++)
+    #endif
         {
+        unsigned int err_count = 0;
+
         // read in the current position and orientation
         Scalar4 postype_i = h_postype.data[i];
         Scalar4 orientation_i = h_orientation.data[i];
@@ -2032,6 +2152,15 @@ std::vector<std::pair<unsigned int, unsigned int> > IntegratorHPMCMono<Shape>::m
                 } // end loop over AABB nodes
             } // end loop over images
         } // end loop over particles
+    #ifdef ENABLE_TBB
+        });
+
+    std::vector<std::pair<unsigned int, unsigned int> > overlap_vector;
+    for (const auto& v : thread_overlaps)
+        overlap_vector.insert(overlap_vector.end(), v.begin(), v.end());
+    #endif
+
+    std::sort(overlap_vector.begin(), overlap_vector.end());
     return overlap_vector;
     }
 
@@ -3203,11 +3332,29 @@ inline bool IntegratorHPMCMono<Shape>::checkDepletantOverlap(unsigned int i, vec
     return accept;
     }
 
+/*! Box moves of serial CPU simulations check only the pairs in the contact list when possible. Otherwise, and in
+    all other cases, the overlaps are counted with the AABB tree as in the base class.
+*/
 template<class Shape>
 bool IntegratorHPMCMono<Shape>::attemptBoxResize(unsigned int timestep, const BoxDim& new_box)
     {
-    // call parent class method
-    bool result = IntegratorHPMC::attemptBoxResize(timestep, new_box);
+    bool use_contact_list = !m_exec_conf->isCUDAEnabled();
+    #ifdef ENABLE_MPI
+    if (m_pdata->getDomainDecomposition())
+        use_contact_list = false;
+    #endif
+
+    bool result;
+    if (use_contact_list)
+        {
+        scaleParticlesToBox(new_box);
+        result = !checkContactOverlaps();
+        }
+    else
+        {
+        // call parent class method
+        result = IntegratorHPMC::attemptBoxResize(timestep, new_box);
+        }
 
     if (result)
         {
@@ -3221,6 +3368,236 @@ bool IntegratorHPMCMono<Shape>::attemptBoxResize(unsigned int timestep, const Bo
     return result;
     }
 
+/*! \returns true if any pair of particles overlaps
+
+    The contact list holds all pairs closer than m_contact_r_list in a reference configuration. A pair that is not in
+    the list can only come into contact when the box deformation since then shrinks separations by a factor s and the
+    particles move by at most delta, such that s*m_contact_r_list - 2*delta is less than the maximum contact distance.
+    As long as this is not the case, only the pairs in the list need to be checked. Otherwise, all pairs are checked
+    with the AABB tree and the list is rebuilt for the current configuration.
+*/
+template<class Shape>
+bool IntegratorHPMCMono<Shape>::checkContactOverlaps()
+    {
+    const BoxDim& box = m_pdata->getGlobalBox();
+    unsigned int ndim = m_sysdef->getNDimensions();
+    unsigned int N = m_pdata->getN();
+    Scalar d_max = getMaxCoreDiameter();
+
+    // minimum image convention only finds the overlapping image when it is closer than half the box width
+    Scalar3 npd = box.getNearestPlaneDistance();
+    Scalar min_npd = std::min(npd.x, npd.y);
+    if (ndim == 3)
+        min_npd = std::min(min_npd, npd.z);
+
+    if (!m_contact_list_valid || m_contact_ref_fraction.size() != N || min_npd <= Scalar(2.0)*d_max)
+        return rebuildContactList(d_max);
+
+    // smallest factor by which the box deformation since the list build shrinks any separation vector
+    Eigen::Matrix3d h_ref, h_cur;
+    for (unsigned int k = 0; k < 3; k++)
+        {
+        Scalar3 a_ref = m_contact_ref_box.getLatticeVector(k);
+        Scalar3 a_cur = box.getLatticeVector(k);
+        h_ref.col(k) << a_ref.x, a_ref.y, a_ref.z;
+        h_cur.col(k) << a_cur.x, a_cur.y, a_cur.z;
+        }
+    Eigen::Matrix3d deformation = h_cur * h_ref.inverse();
+    if (ndim == 2)
+        {
+        // the z extent of 2D boxes is irrelevant
+        deformation.row(2) << 0, 0, 1;
+        deformation.col(2) << 0, 0, 1;
+        }
+    Scalar s_min = Scalar(Eigen::JacobiSVD<Eigen::Matrix3d>(deformation).singularValues().minCoeff());
+
+    if (this->m_prof) this->m_prof->push(this->m_exec_conf, "HPMC contact list");
+
+    ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_overlaps(m_overlaps, access_location::host, access_mode::read);
+
+    // largest particle displacement since the list build, in the current box
+    vec3<Scalar> a1(box.getLatticeVector(0));
+    vec3<Scalar> a2(box.getLatticeVector(1));
+    vec3<Scalar> a3(box.getLatticeVector(2));
+    Scalar max_disp_sq(0.0);
+    for (unsigned int i = 0; i < N; i++)
+        {
+        Scalar4 postype_i = h_postype.data[i];
+        Scalar3 df = box.makeFraction(make_scalar3(postype_i.x, postype_i.y, postype_i.z))
+            - m_contact_ref_fraction[i];
+
+        // periodic wrapping shifts the pair images, which the criterion allows for
+        df.x -= rint(df.x);
+        df.y -= rint(df.y);
+        df.z = (ndim == 3) ? df.z - rint(df.z) : Scalar(0.0);
+
+        vec3<Scalar> disp = df.x*a1 + df.y*a2 + df.z*a3;
+        max_disp_sq = std::max(max_disp_sq, dot(disp, disp));
+        }
+
+    if (s_min*m_contact_r_list - Scalar(2.0)*slow::sqrt(max_disp_sq) < d_max)
+        {
+        if (this->m_prof) this->m_prof->pop(this->m_exec_conf);
+        return rebuildContactList(d_max);
+        }
+
+    bool overlap = false;
+    unsigned int err_count = 0;
+    for (auto it = m_contact_list.begin(); it != m_contact_list.end(); ++it)
+        {
+        unsigned int i = it->first;
+        unsigned int j = it->second;
+        Scalar4 postype_i = h_postype.data[i];
+        Scalar4 postype_j = h_postype.data[j];
+        unsigned int typ_i = __scalar_as_int(postype_i.w);
+        unsigned int typ_j = __scalar_as_int(postype_j.w);
+
+        if (!h_overlaps.data[m_overlap_idx(typ_i,typ_j)])
+            continue;
+
+        vec3<Scalar> r_ij = box.minImage(vec3<Scalar>(postype_j) - vec3<Scalar>(postype_i));
+        Shape shape_i(quat<Scalar>(h_orientation.data[i]), m_params[typ_i]);
+        Shape shape_j(quat<Scalar>(h_orientation.data[j]), m_params[typ_j]);
+
+        if (check_circumsphere_overlap(r_ij, shape_i, shape_j)
+            && test_overlap(r_ij, shape_i, shape_j, err_count)
+            && test_overlap(-r_ij, shape_j, shape_i, err_count))
+            {
+            overlap = true;
+            break;
+            }
+        }
+
+    if (this->m_prof) this->m_prof->pop(this->m_exec_conf);
+
+    return overlap;
+    }
+
+/*! \param d_max Maximum contact distance of any two particles
+    \returns true if any pair of particles overlaps
+
+    Checks all pairs for overlaps with the AABB tree while collecting the interacting pairs within the list cutoff.
+    The list is only kept when the traversal completes, i.e. when there are no overlaps, and the box is at least twice
+    the cutoff wide so that each pair is in the list once. Changes to the shapes or the interaction matrix invalidate
+    the list.
+*/
+template<class Shape>
+bool IntegratorHPMCMono<Shape>::rebuildContactList(Scalar d_max)
+    {
+    m_contact_list_valid = false;
+
+    const BoxDim& box = m_pdata->getGlobalBox();
+    unsigned int ndim = m_sysdef->getNDimensions();
+    unsigned int N = m_pdata->getN();
+
+    // the list cutoff extends past the contact distance to keep the list valid for some time
+    Scalar r_list = Scalar(1.25)*d_max;
+
+    Scalar3 npd = box.getNearestPlaneDistance();
+    Scalar min_npd = std::min(npd.x, npd.y);
+    if (ndim == 3)
+        min_npd = std::min(min_npd, npd.z);
+
+    if (min_npd <= Scalar(2.0)*r_list)
+        return countOverlaps(true) > 0;
+
+    // build an up to date AABB tree
+    buildAABBTree();
+
+    if (this->m_prof) this->m_prof->push(this->m_exec_conf, "HPMC contact list");
+
+    // the box is large enough that only the adjacent images need to be searched
+    std::vector< vec3<Scalar> > images;
+    vec3<Scalar> a1(box.getLatticeVector(0));
+    vec3<Scalar> a2(box.getLatticeVector(1));
+    vec3<Scalar> a3(box.getLatticeVector(2));
+    int l_max = (ndim == 3) ? 1 : 0;
+    for (int h = -1; h <= 1; h++)
+        for (int k = -1; k <= 1; k++)
+            for (int l = -l_max; l <= l_max; l++)
+                images.push_back(Scalar(h)*a1 + Scalar(k)*a2 + Scalar(l)*a3);
+
+    ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_overlaps(m_overlaps, access_location::host, access_mode::read);
+
+    m_contact_list.clear();
+    m_contact_ref_fraction.resize(N);
+
+    bool overlap = false;
+    unsigned int err_count = 0;
+    for (unsigned int i = 0; i < N && !overlap; i++)
+        {
+        Scalar4 postype_i = h_postype.data[i];
+        unsigned int typ_i = __scalar_as_int(postype_i.w);
+        Shape shape_i(quat<Scalar>(h_orientation.data[i]), m_params[typ_i]);
+        vec3<Scalar> pos_i = vec3<Scalar>(postype_i);
+        m_contact_ref_fraction[i] = box.makeFraction(vec_to_scalar3(pos_i));
+
+        for (unsigned int cur_image = 0; cur_image < images.size() && !overlap; cur_image++)
+            {
+            // particle AABBs lie within a circumsphere radius, at most d_max, of the particle positions
+            vec3<Scalar> pos_i_image = pos_i + images[cur_image];
+            detail::AABB aabb(pos_i_image, r_list + d_max);
+
+            // stackless search
+            for (unsigned int cur_node_idx = 0; cur_node_idx < m_aabb_tree.getNumNodes() && !overlap; cur_node_idx++)
+                {
+                if (detail::overlap(m_aabb_tree.getNodeAABB(cur_node_idx), aabb))
+                    {
+                    if (m_aabb_tree.isNodeLeaf(cur_node_idx))
+                        {
+                        for (unsigned int cur_p = 0; cur_p < m_aabb_tree.getNodeNumParticles(cur_node_idx); cur_p++)
+                            {
+                            unsigned int j = m_aabb_tree.getNodeParticle(cur_node_idx, cur_p);
+
+                            // list each pair once
+                            if (j <= i)
+                                continue;
+
+                            Scalar4 postype_j = h_postype.data[j];
+                            unsigned int typ_j = __scalar_as_int(postype_j.w);
+                            vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_i_image;
+                            if (!h_overlaps.data[m_overlap_idx(typ_i,typ_j)] || dot(r_ij, r_ij) > r_list*r_list)
+                                continue;
+
+                            m_contact_list.push_back(std::make_pair(i, j));
+
+                            Shape shape_j(quat<Scalar>(h_orientation.data[j]), m_params[typ_j]);
+
+                            if (check_circumsphere_overlap(r_ij, shape_i, shape_j)
+                                && test_overlap(r_ij, shape_i, shape_j, err_count)
+                                && test_overlap(-r_ij, shape_j, shape_i, err_count))
+                                {
+                                overlap = true;
+                                break;
+                                }
+                            }
+                        }
+                    }
+                else
+                    {
+                    // skip ahead
+                    cur_node_idx += m_aabb_tree.getNodeSkip(cur_node_idx);
+                    }
+                } // end loop over AABB nodes
+            } // end loop over images
+        } // end loop over particles
+
+    if (!overlap)
+        {
+        m_contact_ref_box = box;
+        m_contact_r_list = r_list;
+        m_contact_list_valid = true;
+        }
+
+    if (this->m_prof) this->m_prof->pop(this->m_exec_conf);
+
+    return overlap;
+    }
+
 //! Export the IntegratorHPMCMono class to python
 /*! \param name Name of the class in the exported python module
     \tparam Shape An instantiation of IntegratorHPMCMono<Shape> will be exported
@@ -485,6 +485,9 @@ void IntegratorHPMCMonoGPU< Shape >::update(unsigned int timestep)
     {
     IntegratorHPMC::update(timestep);
 
+    // the GPU kernels do not accumulate the patch energy changes of accepted moves
+    this->m_patch_energy_valid = false;
+
     if (this->m_patch && !this->m_patch_log)
         {
         ArrayHandle<Scalar> h_additive_cutoff(m_additive_cutoff, access_location::host, access_mode::overwrite);
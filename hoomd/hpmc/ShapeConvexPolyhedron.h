@@ -20,7 +20,9 @@
 #else
 #define DEVICE
 #define HOSTDEVICE
+#include <algorithm>
 #include <iostream>
+#include <vector>
 #if defined (__SSE__)
 #include <immintrin.h>
 #endif
@@ -40,9 +42,16 @@ namespace detail
     makes them rounded convex polyhedra. Coordinates are stored with x, y, and z in separate arrays
     to support vector intrinsics on the CPU. These arrays are stored in ManagedArray to support
     arbitrary numbers of verticles.
+
+    Polyhedra with at least hill_climb_min_verts vertices also store the vertex adjacency graph of
+    their convex hull in compressed row form. On the CPU, the support function climbs this graph
+    instead of scanning all vertices.
 */
 struct PolyhedronVertices : ShapeParams
     {
+    /// Minimum number of vertices for which the adjacency graph is built
+    static const unsigned int hill_climb_min_verts = 64;
+
     /// Default constructor initializes zero values.
     DEVICE PolyhedronVertices()
         : n_hull_verts(0),
@@ -145,6 +154,8 @@ struct PolyhedronVertices : ShapeParams
                  hull_verts[i] = (unsigned int)indexBuffer[i];
             }
 
+        buildAdjacency(managed);
+
         if (N >= 1)
             {
             std::vector<OverlapReal> vertex_radii(N, sweep_radius);
@@ -156,6 +167,53 @@ struct PolyhedronVertices : ShapeParams
             }
         }
 
+    /** Build the vertex adjacency graph of the convex hull
+
+        Each edge of a hull triangle connects two vertices. Vertices that are not on the hull have
+        no neighbors and are never visited by the support function. The graph is left empty for
+        shapes with few vertices, where a scan over all vertices is faster.
+
+        @param managed Set to true to store the graph in managed memory
+    */
+    void buildAdjacency(bool managed)
+        {
+        hull_adj_offset = ManagedArray<unsigned int>();
+        hull_adj = ManagedArray<unsigned int>();
+        if (N < hill_climb_min_verts || n_hull_verts < 3)
+            return;
+
+        std::vector< std::vector<unsigned int> > neighbors(N);
+        for (unsigned int t = 0; t + 2 < n_hull_verts; t += 3)
+            {
+            for (unsigned int k = 0; k < 3; ++k)
+                {
+                unsigned int a = hull_verts[t + k];
+                unsigned int b = hull_verts[t + (k+1)%3];
+                neighbors[a].push_back(b);
+                neighbors[b].push_back(a);
+                }
+            }
+
+        unsigned int n_adj = 0;
+        for (auto& nbrs : neighbors)
+            {
+            std::sort(nbrs.begin(), nbrs.end());
+            nbrs.erase(std::unique(nbrs.begin(), nbrs.end()), nbrs.end());
+            n_adj += (unsigned int)nbrs.size();
+            }
+
+        hull_adj_offset = ManagedArray<unsigned int>(N+1, managed);
+        hull_adj = ManagedArray<unsigned int>(n_adj, managed);
+        unsigned int offset = 0;
+        for (unsigned int i = 0; i < N; ++i)
+            {
+            hull_adj_offset[i] = offset;
+            for (unsigned int j : neighbors[i])
+                hull_adj[offset++] = j;
+            }
+        hull_adj_offset[N] = offset;
+        }
+
     /// Construct from a Python dictionary
     PolyhedronVertices(pybind11::dict v, bool managed=false)
         : PolyhedronVertices((unsigned int)pybind11::len(v["vertices"]), managed)
@@ -249,6 +307,14 @@ struct PolyhedronVertices : ShapeParams
     /// Number of vertices in the convex hull
     unsigned int n_hull_verts;
 
+    /** Neighbors of vertex i on the convex hull are hull_adj[hull_adj_offset[i]] up to
+        hull_adj[hull_adj_offset[i+1]]. Empty when the graph is not built. Not used on the GPU.
+    */
+    ManagedArray<unsigned int> hull_adj_offset;
+
+    /// Adjacency lists of the convex hull vertices
+    ManagedArray<unsigned int> hull_adj;
+
     /// Number of vertices
     unsigned int N;
 
@@ -282,8 +348,12 @@ class SupportFuncConvexPolyhedron
         */
         DEVICE SupportFuncConvexPolyhedron(const PolyhedronVertices& _verts,
             OverlapReal extra_sweep_radius=OverlapReal(0.0))
-            : verts(_verts), sweep_radius(extra_sweep_radius)
+            : verts(_verts), sweep_radius(extra_sweep_radius), start_idx(0)
             {
+            #ifndef __HIPCC__
+            if (verts.hull_adj_offset.size() > 0)
+                start_idx = verts.hull_verts[0];
+            #endif
             }
 
         /** Compute the support function
@@ -298,6 +368,11 @@ class SupportFuncConvexPolyhedron
 
             if (verts.N > 0)
                 {
+                #ifndef __HIPCC__
+                if (verts.hull_adj_offset.size() > 0)
+                    return support(climb(n), n);
+                #endif
+
                 #if !defined(__HIPCC__) && defined(__AVX__) && (defined(SINGLE_PRECISION) || defined(ENABLE_HPMC_MIXED_PRECISION))
                 // process dot products with AVX 8 at a time on the CPU when working with more than
                 // 4 verts
@@ -455,11 +530,7 @@ class SupportFuncConvexPolyhedron
                     }
                 #endif
 
-                vec3<OverlapReal> v(verts.x[max_idx], verts.y[max_idx], verts.z[max_idx]);
-                if (sweep_radius != OverlapReal(0.0))
-                    return v + (sweep_radius * fast::rsqrt(dot(n,n))) * n;
-                else
-                    return v;
+                return support(max_idx, n);
                 } // end if(verts.N > 0)
             else
                 {
@@ -471,8 +542,56 @@ class SupportFuncConvexPolyhedron
             }
 
     private:
+        /// Support point of vertex idx in the direction n, including the sweep radius
+        DEVICE vec3<OverlapReal> support(unsigned int idx, const vec3<OverlapReal>& n) const
+            {
+            vec3<OverlapReal> v(verts.x[idx], verts.y[idx], verts.z[idx]);
+            if (sweep_radius != OverlapReal(0.0))
+                return v + (sweep_radius * fast::rsqrt(dot(n,n))) * n;
+            else
+                return v;
+            }
+
+        #ifndef __HIPCC__
+        /** Find the vertex furthest in the direction of n by hill climbing
+
+            On a convex hull, a vertex with no neighbor further in the direction n is the furthest
+            vertex overall. The climb starts from the result of the previous call, because the
+            search directions of successive XenoCollide and GJK iterations change slowly.
+
+            @param n Normal vector input (in the local frame)
+            @returns Index of the furthest vertex
+        */
+        unsigned int climb(const vec3<OverlapReal>& n) const
+            {
+            unsigned int cur = start_idx;
+            OverlapReal cur_dot = dot(n, vec3<OverlapReal>(verts.x[cur], verts.y[cur], verts.z[cur]));
+            while (true)
+                {
+                unsigned int next = cur;
+                const unsigned int end = verts.hull_adj_offset[cur+1];
+                for (unsigned int k = verts.hull_adj_offset[cur]; k < end; ++k)
+                    {
+                    const unsigned int j = verts.hull_adj[k];
+                    OverlapReal d = dot(n, vec3<OverlapReal>(verts.x[j], verts.y[j], verts.z[j]));
+                    if (d > cur_dot)
+                        {
+                        cur_dot = d;
+                        next = j;
+                        }
+                    }
+                if (next == cur)
+                    break;
+                cur = next;
+                }
+            start_idx = cur;
+            return cur;
+            }
+        #endif
+
         const PolyhedronVertices& verts;      //!< Vertices of the polyhedron
         const OverlapReal sweep_radius; //!< Extra sweep radius
+        mutable unsigned int start_idx; //!< Vertex to start the next hill climb from
     };
 
 /** Geometric primitives for closest point calculation
@@ -823,6 +942,80 @@ DEVICE inline bool test_overlap(const vec3<Scalar>& r_ab,
     */
     }
 
+/** Convex polyhedron overlap test starting from a candidate separating axis
+
+    @param r_ab Vector defining the position of shape b relative to shape a (r_b - r_a)
+    @param a first shape
+    @param b second shape
+    @param err in/out variable incremented when error conditions occur in the overlap test
+    @param sep_axis In/out candidate separating axis in the space frame, zero if there is none
+    @returns true when *a* and *b* overlap, and false when they are disjoint
+*/
+template<>
+DEVICE inline bool test_overlap_warm(const vec3<Scalar>& r_ab,
+                                     const ShapeConvexPolyhedron& a,
+                                     const ShapeConvexPolyhedron& b,
+                                     unsigned int& err,
+                                     vec3<OverlapReal>& sep_axis)
+    {
+    vec3<OverlapReal> dr(r_ab);
+    quat<OverlapReal> q_a(a.orientation);
+
+    OverlapReal DaDb = a.getCircumsphereDiameter() + b.getCircumsphereDiameter();
+
+    // the axis is kept in the space frame, because the orientation of a changes between tests
+    vec3<OverlapReal> axis = rotate(conj(q_a), sep_axis);
+    bool overlap = detail::xenocollide_3d(detail::SupportFuncConvexPolyhedron(a.verts,OverlapReal(0.0)),
+                                          detail::SupportFuncConvexPolyhedron(b.verts,OverlapReal(0.0)),
+                                          rotate(conj(q_a), dr),
+                                          conj(q_a) * quat<OverlapReal>(b.orientation),
+                                          DaDb/OverlapReal(2.0),
+                                          err,
+                                          &axis);
+    if (!overlap)
+        sep_axis = rotate(q_a, axis);
+    return overlap;
+    }
+
+template<>
+struct UsesSeparatingAxis<ShapeConvexPolyhedron>
+    {
+    static const bool value = true;
+    };
+
+/** Convex polyhedron contact scale
+
+    @param r_ab Vector defining the position of shape b relative to shape a (r_b - r_a), must be nonzero
+    @param a first shape
+    @param b second shape
+    @param err in/out variable incremented when error conditions occur
+    @returns the largest s such that *a* and *b* overlap when *b* is placed at s*r_ab relative to *a*
+*/
+template<>
+DEVICE inline OverlapReal contact_scale(const vec3<Scalar>& r_ab,
+                                        const ShapeConvexPolyhedron& a,
+                                        const ShapeConvexPolyhedron& b,
+                                        unsigned int& err)
+    {
+    vec3<OverlapReal> dr(r_ab);
+    quat<OverlapReal> q_a(a.orientation);
+
+    OverlapReal DaDb = a.getCircumsphereDiameter() + b.getCircumsphereDiameter();
+
+    return detail::xenocollide_contact_3d(detail::SupportFuncConvexPolyhedron(a.verts,OverlapReal(0.0)),
+                                          detail::SupportFuncConvexPolyhedron(b.verts,OverlapReal(0.0)),
+                                          rotate(conj(q_a), dr),
+                                          conj(q_a) * quat<OverlapReal>(b.orientation),
+                                          DaDb/OverlapReal(2.0),
+                                          err);
+    }
+
+template<>
+struct HasContactScale<ShapeConvexPolyhedron>
+    {
+    static const bool value = true;
+    };
+
 /** Test for the overlap of a third convex polyhedron with the intersection of two convex polyhedra
 
     @param a First shape to test
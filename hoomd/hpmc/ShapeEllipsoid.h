@@ -8,6 +8,7 @@
 #include "HPMCPrecisionSetup.h"
 #include "hoomd/VectorMath.h"
 #include "ShapeSphere.h"    //< For the base template of test_overlap
+#include "XenoCollide3D.h"
 
 #ifdef __HIPCC__
 #define DEVICE __device__
@@ -419,6 +420,39 @@ DEVICE inline int test_overlap_ellipsoids(OverlapReal *M1, OverlapReal *M2)
     return ELLIPSOID_OVERLAP_ERROR;
     }
 
+/** Support function of an ellipsoid for use with XenoCollide
+
+    The support point A^2 n / |A n| of the ellipsoid with semi-axes A is invariant to the scale of n, so the
+    directions passed in by the XenoCollide algorithms need not be normalized.
+*/
+class SupportFuncEllipsoid
+    {
+    public:
+        /** Construct a support function for an ellipsoid
+
+            @param _axes Semi-axes of the ellipsoid
+        */
+        DEVICE SupportFuncEllipsoid(const EllipsoidParams& _axes)
+            : axes(_axes)
+            {
+            }
+
+        /** Compute the support function
+
+            @param n Normal vector input (in the local frame)
+            @returns Local coords of the point furthest in the direction of n
+        */
+        DEVICE vec3<OverlapReal> operator() (const vec3<OverlapReal>& n) const
+            {
+            vec3<OverlapReal> numerator(axes.x*axes.x*n.x, axes.y*axes.y*n.y, axes.z*axes.z*n.z);
+            vec3<OverlapReal> dvec(axes.x*n.x, axes.y*n.y, axes.z*n.z);
+            return numerator * fast::rsqrt(dot(dvec, dvec));
+            }
+
+    private:
+        const EllipsoidParams& axes;    //!< Semi-axes of the ellipsoid
+    };
+
 }; // end namespace detail
 
 /** Ellipsoid overlap test
@@ -462,6 +496,45 @@ DEVICE inline bool test_overlap<ShapeEllipsoid,ShapeEllipsoid>(const vec3<Scalar
     return ret_val == ELLIPSOID_OVERLAP_TRUE;
     }
 
+/** Ellipsoid contact scale
+
+    @param r_ab Vector defining the position of shape b relative to shape a (r_b - r_a), must be nonzero
+    @param a Shape a
+    @param b Shape b
+    @param err in/out variable incremented when error conditions occur
+    @returns the largest s such that *a* and *b* overlap when *b* is placed at s*r_ab relative to *a*
+*/
+template <>
+DEVICE inline OverlapReal contact_scale<ShapeEllipsoid,ShapeEllipsoid>(const vec3<Scalar>& r_ab,
+                                                                       const ShapeEllipsoid& a,
+                                                                       const ShapeEllipsoid& b,
+                                                                       unsigned int& err)
+    {
+    vec3<OverlapReal> dr(r_ab);
+
+    //shortcut if ellipsoids are actually spheres
+    if(a.axes.x==a.axes.y && a.axes.x==a.axes.z && b.axes.x==b.axes.y && b.axes.x==b.axes.z)
+       {
+       return (a.axes.x + b.axes.x) * fast::rsqrt(dot(dr,dr));
+       }
+
+    quat<OverlapReal> q_a(a.orientation);
+    OverlapReal DaDb = a.getCircumsphereDiameter() + b.getCircumsphereDiameter();
+
+    return detail::xenocollide_contact_3d(detail::SupportFuncEllipsoid(a.axes),
+                                          detail::SupportFuncEllipsoid(b.axes),
+                                          rotate(conj(q_a), dr),
+                                          conj(q_a) * quat<OverlapReal>(b.orientation),
+                                          DaDb/OverlapReal(2.0),
+                                          err);
+    }
+
+template<>
+struct HasContactScale<ShapeEllipsoid>
+    {
+    static const bool value = true;
+    };
+
 #ifndef __HIPCC__
 template<>
 inline std::string getShapeSpec(const ShapeEllipsoid& ellipsoid)
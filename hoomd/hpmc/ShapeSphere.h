@@ -437,6 +437,54 @@ DEVICE inline bool test_overlap(const vec3<Scalar>& r_ab, const ShapeA &a, const
     return true;
     }
 
+//! Overlap test seeded with a separating axis found by an earlier test of the same pair
+/*! \param r_ab Vector defining the position of shape b relative to shape a (r_b - r_a)
+    \param a first shape
+    \param b second shape
+    \param err Incremented if there is an error condition. Left unchanged otherwise.
+    \param sep_axis In/out candidate separating axis in the space frame, zero if there is none
+    \returns true when *a* and *b* overlap, and false when they are disjoint
+
+    The default implementation ignores *sep_axis*. Shapes that specialize this function also specialize
+    UsesSeparatingAxis, so that the integrator keeps the axes of nearby pairs between trial moves.
+*/
+template <class ShapeA, class ShapeB>
+DEVICE inline bool test_overlap_warm(const vec3<Scalar>& r_ab, const ShapeA& a, const ShapeB& b, unsigned int& err,
+    vec3<OverlapReal>& sep_axis)
+    {
+    return test_overlap(r_ab, a, b, err);
+    }
+
+//! True for shapes that make use of the separating axis in test_overlap_warm
+template <class Shape>
+struct UsesSeparatingAxis
+    {
+    static const bool value = false;
+    };
+
+//! Scale factor of the separation at which two shapes touch
+/*! \param r_ab Vector defining the position of shape b relative to shape a (r_b - r_a), must be nonzero
+    \param a first shape
+    \param b second shape
+    \param err Incremented if there is an error condition. Left unchanged otherwise.
+    \returns the largest s such that *a* and *b* overlap when *b* is placed at s*r_ab relative to *a*
+
+    The default implementation is never called. Shapes that specialize this function also specialize HasContactScale,
+    other shapes have to bisect test_overlap to locate the contact.
+*/
+template <class ShapeA, class ShapeB>
+DEVICE inline OverlapReal contact_scale(const vec3<Scalar>& r_ab, const ShapeA& a, const ShapeB& b, unsigned int& err)
+    {
+    return OverlapReal(0.0);
+    }
+
+//! True for shapes that specialize contact_scale
+template <class Shape>
+struct HasContactScale
+    {
+    static const bool value = false;
+    };
+
 //! Sphere-Sphere overlap
 /*! \param r_ab Vector defining the position of shape b relative to shape a (r_b - r_a)
     \param a first shape
@@ -467,6 +515,29 @@ DEVICE inline bool test_overlap<ShapeSphere, ShapeSphere>(const vec3<Scalar>& r_
         }
     }
 
+//! Sphere-Sphere contact scale
+/*! \param r_ab Vector defining the position of shape b relative to shape a (r_b - r_a), must be nonzero
+    \param a first shape
+    \param b second shape
+    \param err in/out variable incremented when error conditions occur
+    \returns the largest s such that *a* and *b* overlap when *b* is placed at s*r_ab relative to *a*
+
+    \ingroup shape
+*/
+template <>
+DEVICE inline OverlapReal contact_scale<ShapeSphere, ShapeSphere>(const vec3<Scalar>& r_ab, const ShapeSphere& a,
+    const ShapeSphere& b, unsigned int& err)
+    {
+    vec3<OverlapReal> dr(r_ab);
+    return (a.params.radius + b.params.radius) * fast::rsqrt(dot(dr,dr));
+    }
+
+template <>
+struct HasContactScale<ShapeSphere>
+    {
+    static const bool value = true;
+    };
+
 //! Test for overlap of a third particle with the intersection of two shapes
 /*! \param a First shape to test
     \param b Second shape to test
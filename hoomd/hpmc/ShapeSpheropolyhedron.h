@@ -181,6 +181,82 @@ DEVICE inline bool test_overlap(const vec3<Scalar>& r_ab,
     */
     }
 
+//! Spheropolyhedron overlap test starting from a candidate separating axis
+/*! \param r_ab Vector defining the position of shape b relative to shape a (r_b - r_a)
+    \param a first shape
+    \param b second shape
+    \param err in/out variable incremented when error conditions occur in the overlap test
+    \param sep_axis In/out candidate separating axis in the space frame, zero if there is none
+    \returns true when *a* and *b* overlap, and false when they are disjoint
+
+    \ingroup shape
+*/
+template<>
+DEVICE inline bool test_overlap_warm(const vec3<Scalar>& r_ab,
+                                     const ShapeSpheropolyhedron& a,
+                                     const ShapeSpheropolyhedron& b,
+                                     unsigned int& err,
+                                     vec3<OverlapReal>& sep_axis)
+    {
+    vec3<OverlapReal> dr(r_ab);
+    quat<OverlapReal> q_a(a.orientation);
+
+    OverlapReal DaDb = a.getCircumsphereDiameter() + b.getCircumsphereDiameter();
+
+    // the axis is kept in the space frame, because the orientation of a changes between tests
+    vec3<OverlapReal> axis = rotate(conj(q_a), sep_axis);
+    bool overlap = detail::xenocollide_3d(detail::SupportFuncConvexPolyhedron(a.verts,a.verts.sweep_radius),
+                                          detail::SupportFuncConvexPolyhedron(b.verts,b.verts.sweep_radius),
+                                          rotate(conj(q_a), dr),
+                                          conj(q_a) * quat<OverlapReal>(b.orientation),
+                                          DaDb/OverlapReal(2.0),
+                                          err,
+                                          &axis);
+    if (!overlap)
+        sep_axis = rotate(q_a, axis);
+    return overlap;
+    }
+
+template<>
+struct UsesSeparatingAxis<ShapeSpheropolyhedron>
+    {
+    static const bool value = true;
+    };
+
+//! Spheropolyhedron contact scale
+/*! \param r_ab Vector defining the position of shape b relative to shape a (r_b - r_a), must be nonzero
+    \param a first shape
+    \param b second shape
+    \param err in/out variable incremented when error conditions occur
+    \returns the largest s such that *a* and *b* overlap when *b* is placed at s*r_ab relative to *a*
+
+    \ingroup shape
+*/
+template<>
+DEVICE inline OverlapReal contact_scale(const vec3<Scalar>& r_ab,
+                                        const ShapeSpheropolyhedron& a,
+                                        const ShapeSpheropolyhedron& b,
+                                        unsigned int& err)
+    {
+    vec3<OverlapReal> dr(r_ab);
+    quat<OverlapReal> q_a(a.orientation);
+
+    OverlapReal DaDb = a.getCircumsphereDiameter() + b.getCircumsphereDiameter();
+
+    return detail::xenocollide_contact_3d(detail::SupportFuncConvexPolyhedron(a.verts,a.verts.sweep_radius),
+                                          detail::SupportFuncConvexPolyhedron(b.verts,b.verts.sweep_radius),
+                                          rotate(conj(q_a), dr),
+                                          conj(q_a) * quat<OverlapReal>(b.orientation),
+                                          DaDb/OverlapReal(2.0),
+                                          err);
+    }
+
+template<>
+struct HasContactScale<ShapeSpheropolyhedron>
+    {
+    static const bool value = true;
+    };
+
 //! Test for overlap of a third particle with the intersection of two shapes
 /*! \param a First shape to test
     \param b Second shape to test
@@ -328,10 +328,13 @@ inline bool UpdaterBoxMC::box_resize_trial(Scalar Lx,
 
     BoxDim curBox = m_pdata->getGlobalBox();
 
+    double patch_energy_old = 0.0;
+    double patch_energy_new = 0.0;
     if (m_mc->getPatchInteraction())
         {
-        // energy of old configuration
-        deltaE -= m_mc->computePatchEnergy(timestep);
+        // energy of old configuration, tracked by the integrator since the last full evaluation
+        patch_energy_old = m_mc->getTotalPatchEnergy(timestep);
+        deltaE -= patch_energy_old;
         }
 
     // Attempt box resize and check for overlaps
@@ -344,7 +347,8 @@ inline bool UpdaterBoxMC::box_resize_trial(Scalar Lx,
 
     if (allowed && m_mc->getPatchInteraction())
         {
-        deltaE += m_mc->computePatchEnergy(timestep);
+        patch_energy_new = m_mc->computePatchEnergy(timestep);
+        deltaE += patch_energy_new;
         }
 
     if (allowed && m_mc->getExternalField())
@@ -359,6 +363,8 @@ inline bool UpdaterBoxMC::box_resize_trial(Scalar Lx,
 
     if (allowed && p < fast::exp(-deltaE))
         {
+        if (m_mc->getPatchInteraction())
+            m_mc->setTotalPatchEnergy(patch_energy_new);
         return true;
         }
     else
@@ -382,6 +388,10 @@ inline bool UpdaterBoxMC::box_resize_trial(Scalar Lx,
 
         // we have moved particles, communicate those changes
         m_mc->communicate(false);
+
+        // the box change signal invalidated the total patch energy, but the configuration is the old one
+        if (m_mc->getPatchInteraction())
+            m_mc->restoreTotalPatchEnergy(patch_energy_old);
         return false;
         }
     }
@@ -11,6 +11,9 @@
 #include "hoomd/RandomNumbers.h"
 #include "hoomd/RNGIdentifiers.h"
 
+#include <algorithm>
+#include <atomic>
+#include <climits>
 #include <set>
 #include <list>
 
@@ -19,230 +22,264 @@
 #include "IntegratorHPMCMono.h"
 
 #ifdef ENABLE_TBB
-#include <tbb/concurrent_unordered_map.h>
 #include <tbb/concurrent_unordered_set.h>
 #include <tbb/concurrent_vector.h>
+#include <tbb/enumerable_thread_specific.h>
 #include <tbb/parallel_for.h>
-#include <tbb/task.h>
-#include <atomic>
 #endif
 
 namespace hpmc
 {
 
-namespace detail
-{
-
-#ifdef ENABLE_TBB
-//! Wrapper around std::atomic_flag to allow use in a std::vector
-class my_atomic_flag
+//! Interaction energy of a particle pair
+/*! \note Outside of namespace detail, whose generic swap() would be ambiguous with std::swap() when sorting
+*/
+struct PairEnergy
     {
-    public:
-        //! Default constructor
-        my_atomic_flag()
-            {
-            f.clear();
-            }
+    PairEnergy() : i(0), j(0), U(0.0f) {}   //!< Default constructor
 
-        //! Copy constructor
-        /*! \note this constructor doesn't really copy the value of its argument,
-            it just reset's the flag to zero
-         */
-        my_atomic_flag(const my_atomic_flag& other)
-            {
-            f.clear();
-            }
+    //! Constructor
+    PairEnergy(unsigned int _i, unsigned int _j, float _U) : i(_i), j(_j), U(_U) {}
 
-        //! Assignment operator (non-atomic)
-        /*! \note this assignment operator doesn't really copy the value of its argument,
-            it just reset's the flag to zero
-         */
-        my_atomic_flag& operator =( const my_atomic_flag& other)
-            {
-            f.clear();
-            return *this;
-            }
+    //! Order by particle pair
+    bool operator<(const PairEnergy& other) const
+        {
+        return i < other.i || (i == other.i && j < other.j);
+        }
 
-        //! Sets flag and returns old value
-        bool test_and_set()
-            {
-            return f.test_and_set();
-            }
+    //! Test if two energies belong to the same particle pair
+    bool samePair(const PairEnergy& other) const
+        {
+        return i == other.i && j == other.j;
+        }
 
-    private:
-        std::atomic_flag f;
+    //! Serialization for MPI
+    template<class Archive>
+    void serialize(Archive & ar)
+        {
+        ar(i, j, U);
+        }
+
+    unsigned int i;     //!< Tag of the first particle
+    unsigned int j;     //!< Tag of the second particle
+    float U;            //!< Interaction energy
     };
-#endif
 
-// Graph class represents a undirected graph
-// using adjacency list representation
-class Graph
+namespace detail
+{
+
+//! Disjoint set forest over the particle tags, for finding the clusters
+/*! Every element stores its parent in the lower and its rank in the upper 32 bits of a single atomic word. A root is
+    linked below another root with one compare and swap that fails if the root has changed in the meantime, so that
+    unite() and find() can be called concurrently without locks (Anderson and Woll 1991). Roots of lower rank are
+    linked below roots of higher rank, ties are broken by index, and find() halves the paths it traverses.
+
+    resize() and connectedComponents() must not be called concurrently with other methods.
+*/
+class UnionFind
     {
     public:
-        Graph() {}      //!< Default constructor
+        UnionFind() : m_n(0) {}      //!< Default constructor
 
-        inline Graph(unsigned int V);   // Constructor
+        //! Reset to N singleton sets
+        inline void resize(unsigned int N);
 
-        inline void resize(unsigned int V);
+        //! Find the root of the set containing v
+        inline unsigned int find(unsigned int v);
 
-        inline void addEdge(unsigned int v, unsigned int w);
+        //! Merge the sets containing v and w
+        inline void unite(unsigned int v, unsigned int w);
 
-        #ifdef ENABLE_TBB
-        inline void connectedComponents(std::vector<tbb::concurrent_vector<unsigned int> >& cc);
-        #else
-        inline void connectedComponents(std::vector<std::vector<unsigned int> >& cc);
-        #endif
+        //! Gather the sets
+        inline void connectedComponents(std::vector<unsigned int>& members, std::vector<unsigned int>& offsets);
 
     private:
-        #ifndef ENABLE_TBB
-        std::multimap<unsigned int,unsigned int> adj;
-        #else
-        tbb::concurrent_unordered_multimap<unsigned int, unsigned int> adj;
-        #endif
-
-        #ifndef ENABLE_TBB
-        std::vector<unsigned int> visited;
-        #else
-        std::vector<my_atomic_flag> visited;
-        #endif
-
-        #ifndef ENABLE_TBB
-        // A function used by DFS
-        inline void DFSUtil(unsigned int v, std::vector<unsigned int>& visited, std::vector<unsigned int>& cur_cc);
-        #endif
-
-        #ifdef ENABLE_TBB
-        class DFSTask : public tbb::task
-            {
-            public:
-                DFSTask(unsigned int _root, std::vector<my_atomic_flag>& _visited,
-                    tbb::concurrent_vector<unsigned int>& _cc,
-                    const tbb::concurrent_unordered_multimap<unsigned int, unsigned int>& _adj)
-                    : root(_root), visited(_visited), cc(_cc), adj(_adj)
-                    { }
-
-                tbb::task* execute()
-                    {
-                    cc.push_back(root);
+        std::vector< std::atomic<uint64_t> > m_node;  //!< Parent (lower 32 bits) and rank (upper 32 bits)
+        unsigned int m_n;                           //!< Number of elements
+        std::vector<unsigned int> m_label;          //!< Temporary cluster labels
+        std::vector<unsigned int> m_cursor;         //!< Temporary insertion position per cluster
+    };
 
-                    unsigned int count = 0;
-                    tbb::task_list list;
+void UnionFind::resize(unsigned int N)
+    {
+    // std::atomic is not movable, allocate a new array when growing
+    if (N > m_node.size())
+        m_node = std::vector< std::atomic<uint64_t> >(N);
 
-                    auto begin = adj.equal_range(root).first;
-                    auto end = adj.equal_range(root).second;
+    for (unsigned int v = 0; v < N; ++v)
+        m_node[v].store(v);
+    m_n = N;
+    }
 
-                    for (auto it = begin; it != end; ++it)
-                        {
-                        unsigned int neighbor = it->second;
-                        if (!visited[neighbor].test_and_set())
-                            {
-                            if (count++ == 0)
-                                {
-                                root = neighbor; // for task recycling
-                                continue;
-                                }
-                            list.push_back(*new(allocate_child()) DFSTask(neighbor, visited, cc, adj));
-                            }
-                        }
+unsigned int UnionFind::find(unsigned int v)
+    {
+    while (true)
+        {
+        uint64_t node = m_node[v].load();
+        unsigned int parent = (unsigned int)node;
+        if (parent == v)
+            return v;
 
-                    if (count)
-                        {
-                        set_ref_count(count);
-                        spawn(list);
+        unsigned int grandparent = (unsigned int)m_node[parent].load();
+        if (grandparent != parent)
+            {
+            // path halving, when the exchange fails another thread has already shortened the path
+            m_node[v].compare_exchange_weak(node, (node & ~uint64_t(0xffffffff)) | grandparent);
+            }
+        v = grandparent;
+        }
+    }
 
-                        recycle_as_safe_continuation();
-                        }
+void UnionFind::unite(unsigned int v, unsigned int w)
+    {
+    while (true)
+        {
+        v = find(v);
+        w = find(w);
+        if (v == w)
+            return;
+
+        uint64_t node_v = m_node[v].load();
+        uint64_t node_w = m_node[w].load();
+        unsigned int rank_v = (unsigned int)(node_v >> 32);
+        unsigned int rank_w = (unsigned int)(node_w >> 32);
+
+        // link the root with the lower (rank, index) below the other one
+        if (rank_v > rank_w || (rank_v == rank_w && v > w))
+            {
+            std::swap(v, w);
+            std::swap(node_v, node_w);
+            std::swap(rank_v, rank_w);
+            }
 
-                    return NULL;
-                    }
+        // fails if v is no longer a root, or its rank changed
+        if ((unsigned int)node_v != v || !m_node[v].compare_exchange_strong(node_v, (node_v & ~uint64_t(0xffffffff)) | w))
+            continue;
 
-            private:
-                unsigned int root;
-                std::vector<my_atomic_flag> & visited;
-                tbb::concurrent_vector<unsigned int>& cc;
-                const tbb::concurrent_unordered_multimap<unsigned int, unsigned int>& adj;
-            };
-        #endif // ENABLE_TBB
+        if (rank_v == rank_w)
+            {
+            // a failed increment only leaves the tree less balanced
+            m_node[w].compare_exchange_strong(node_w, node_w + (uint64_t(1) << 32));
+            }
+        return;
+        }
+    }
 
-    };
+/*! \param members Elements of all sets, ordered by set
+    \param offsets Index of the first element of every set in members, followed by the total number of elements
 
-// Gather connected components in an undirected graph
-#ifdef ENABLE_TBB
-void Graph::connectedComponents(std::vector<tbb::concurrent_vector<unsigned int> >& cc)
-#else
-void Graph::connectedComponents(std::vector<std::vector<unsigned int> >& cc)
-#endif
+    The sets are numbered in the order of their smallest element and list their elements in increasing order.
+*/
+void UnionFind::connectedComponents(std::vector<unsigned int>& members, std::vector<unsigned int>& offsets)
     {
+    m_label.resize(m_n);
+
+    // point every element directly to its root
     #ifdef ENABLE_TBB
-    for (unsigned int v = 0; v < visited.size(); ++v)
+    tbb::parallel_for((unsigned int)0, m_n, [&](unsigned int v)
+    #else
+    for (unsigned int v = 0; v < m_n; ++v)
+    #endif
         {
-        if (! visited[v].test_and_set())
-            {
-            tbb::concurrent_vector<unsigned int> component;
-            DFSTask& a = *new(tbb::task::allocate_root()) DFSTask(v, visited, component, adj);
-            tbb::task::spawn_root_and_wait(a);
-            cc.push_back(component);
-            }
+        m_label[v] = find(v);
         }
-    #else
-    std::fill(visited.begin(), visited.end(), 0);
+    #ifdef ENABLE_TBB
+        );
+    #endif
 
-    // Depth first search
-    for (unsigned int v=0; v<visited.size(); v++)
+    // number the sets by their smallest element, and count their elements
+    m_cursor.assign(m_n, UINT_MAX);
+    offsets.assign(1, 0);
+    for (unsigned int v = 0; v < m_n; ++v)
         {
-        if (visited[v] == false)
+        unsigned int root = m_label[v];
+        if (m_cursor[root] == UINT_MAX)
             {
-            std::vector<unsigned int> cur_cc;
-            DFSUtil(v, visited, cur_cc);
-            cc.push_back(cur_cc);
+            m_cursor[root] = (unsigned int)offsets.size()-1;
+            offsets.push_back(0);
             }
+        m_label[v] = m_cursor[root];
+        offsets[m_label[v]+1]++;
         }
-    #endif
-    }
 
-#ifndef ENABLE_TBB
-void Graph::DFSUtil(unsigned int v, std::vector<unsigned int>& visited, std::vector<unsigned int>& cur_cc)
-    {
-    visited[v] = 1;
-    cur_cc.push_back(v);
-
-    // Recur for all the vertices
-    // adjacent to this vertex
-    auto begin = adj.equal_range(v).first;
-    auto end = adj.equal_range(v).second;
-    for(auto i = begin; i != end; ++i)
+    unsigned int n_sets = (unsigned int)offsets.size()-1;
+    for (unsigned int c = 0; c < n_sets; ++c)
         {
-        if(!visited[i->second])
-            DFSUtil(i->second, visited, cur_cc);
+        offsets[c+1] += offsets[c];
+        m_cursor[c] = offsets[c];
         }
-    }
-#endif
-Graph::Graph(unsigned int V)
-    {
-    #ifndef ENABLE_TBB
-    visited.resize(V, 0);
-    #else
-    visited.resize(V);
-    #endif
+
+    members.resize(m_n);
+    for (unsigned int v = 0; v < m_n; ++v)
+        members[m_cursor[m_label[v]]++] = v;
     }
 
-void Graph::resize(unsigned int V)
+//! Flat per-thread buffers, appended to concurrently and gathered afterwards
+template<class T>
+class ThreadLocalBuffer
     {
-    #ifndef ENABLE_TBB
-    visited.resize(V, 0);
-    #else
-    visited.clear();
-    visited.resize(V);
-    #endif
+    public:
+        //! Get the buffer of the calling thread
+        std::vector<T>& local()
+            {
+            #ifdef ENABLE_TBB
+            return m_buffers.local();
+            #else
+            return m_buffer;
+            #endif
+            }
 
-    adj.clear();
-    }
+        //! Empty all buffers, keeping their memory
+        void clear()
+            {
+            #ifdef ENABLE_TBB
+            for (auto it = m_buffers.begin(); it != m_buffers.end(); ++it)
+                it->clear();
+            #else
+            m_buffer.clear();
+            #endif
+            }
+
+        //! Copy the contents of all buffers into one vector
+        /*! Elements appended by one thread retain their relative order.
+        */
+        void gather(std::vector<T>& out) const
+            {
+            out.clear();
+            #ifdef ENABLE_TBB
+            for (auto it = m_buffers.begin(); it != m_buffers.end(); ++it)
+                out.insert(out.end(), it->begin(), it->end());
+            #else
+            out = m_buffer;
+            #endif
+            }
+
+    private:
+        #ifdef ENABLE_TBB
+        tbb::enumerable_thread_specific< std::vector<T> > m_buffers;   //!< One buffer per thread
+        #else
+        std::vector<T> m_buffer;                                     //!< The buffer
+        #endif
+    };
 
-// method to add an undirected edge
-void Graph::addEdge(unsigned int v, unsigned int w)
+//! Sum the energies of every particle pair
+/*! \param energies List of energy contributions, replaced by one total per pair in order of the pairs
+
+    The contributions to one pair are added in the order in which they appear in the list.
+*/
+inline void sumPairEnergies(std::vector<PairEnergy>& energies)
     {
-    adj.insert(std::make_pair(v,w));
-    adj.insert(std::make_pair(w,v));
+    std::stable_sort(energies.begin(), energies.end());
+
+    unsigned int n = 0;
+    for (unsigned int k = 0; k < energies.size(); ++k)
+        {
+        if (n > 0 && energies[n-1].samePair(energies[k]))
+            energies[n-1].U += energies[k].U;
+        else
+            energies[n++] = energies[k];
+        }
+    energies.resize(n);
     }
 } // end namespace detail
 
@@ -477,13 +514,10 @@ class UpdaterClusters : public Updater
         Scalar m_swap_move_ratio;                   //!< Type swap / geometric move ratio
         Scalar m_flip_probability;                  //!< Cluster flip probability
 
-        #ifdef ENABLE_TBB
-        std::vector<tbb::concurrent_vector<unsigned int> > m_clusters; //!< Cluster components
-        #else
-        std::vector<std::vector<unsigned int> > m_clusters; //!< Cluster components
-        #endif
+        std::vector<unsigned int> m_cluster_members;   //!< Tags of the particles in every cluster, ordered by cluster
+        std::vector<unsigned int> m_cluster_offsets;   //!< Index of the first member of every cluster
 
-        detail::Graph m_G; //!< The graph
+        detail::UnionFind m_G; //!< The clusters
 
         unsigned int m_n_particles_old;                //!< Number of local particles in the old configuration
         detail::AABBTree m_aabb_tree_old;              //!< Locality lookup for old configuration
@@ -495,30 +529,19 @@ class UpdaterClusters : public Updater
 
         std::vector<unsigned int> m_tag_backup;             //!< Old local tags
 
-        #ifndef ENABLE_TBB
-        std::vector<std::pair<unsigned int, unsigned int> > m_overlap;   //!< A local vector of particle pairs due to overlap
-        std::vector<std::pair<unsigned int, unsigned int> > m_interact_old_old;  //!< Pairs interacting old-old
-        std::vector<std::pair<unsigned int, unsigned int> > m_interact_new_old;  //!< Pairs interacting new-old
+        detail::ThreadLocalBuffer< std::pair<unsigned int, unsigned int> > m_bonds; //!< Bonds to merge on rank 0 (MPI)
 
-        std::set<std::pair<unsigned int, unsigned int> > m_interact_new_new;  //!< Pairs interacting new-old
+        #ifndef ENABLE_TBB
         std::set<unsigned int> m_local_reject;                   //!< Set of particles whose clusters moves are rejected
-
-        std::map<std::pair<unsigned int, unsigned int>,float > m_energy_old_old;    //!< Energy of interaction old-old
-        std::map<std::pair<unsigned int, unsigned int>,float > m_energy_new_old;    //!< Energy of interaction old-old
         std::set<unsigned int> m_ptl_reject;              //!< List of ptls that are not transformed
         #else
-        tbb::concurrent_vector<std::pair<unsigned int, unsigned int> > m_overlap;
-        tbb::concurrent_vector<std::pair<unsigned int, unsigned int> > m_interact_old_old;
-        tbb::concurrent_vector<std::pair<unsigned int, unsigned int> > m_interact_new_old;
-
-        tbb::concurrent_unordered_set<std::pair<unsigned int, unsigned int> > m_interact_new_new;
         tbb::concurrent_unordered_set<unsigned int> m_local_reject;
-
-        tbb::concurrent_unordered_map<std::pair<unsigned int, unsigned int>,float > m_energy_old_old;
-        tbb::concurrent_unordered_map<std::pair<unsigned int, unsigned int>,float > m_energy_new_old;
         tbb::concurrent_unordered_set<unsigned int> m_ptl_reject;              //!< List of ptls that are not transformed
         #endif
 
+        detail::ThreadLocalBuffer<PairEnergy> m_energy_old_old;   //!< Energy contributions of interaction old-old
+        detail::ThreadLocalBuffer<PairEnergy> m_energy_new_old;   //!< Energy contributions of interaction new-old
+
         #ifdef ENABLE_TBB
         tbb::concurrent_vector<vec3<Scalar> > m_random_position;
         tbb::concurrent_vector<quat<Scalar> > m_random_orientation;
@@ -534,6 +557,25 @@ class UpdaterClusters : public Updater
         hpmc_clusters_counters_t m_count_run_start;             //!< Count saved at run() start
         hpmc_clusters_counters_t m_count_step_start;            //!< Count saved at the start of the last step
 
+        //! Add a bond between two particles to the clusters
+        /*! \param i Tag of the first particle
+            \param j Tag of the second particle
+
+            The bond is merged right away, or, with domain decomposition, buffered for rank 0. May be called
+            concurrently.
+        */
+        void addBond(unsigned int i, unsigned int j)
+            {
+            #ifdef ENABLE_MPI
+            if (m_comm)
+                {
+                m_bonds.local().push_back(std::make_pair(i,j));
+                return;
+                }
+            #endif
+            m_G.unite(i,j);
+            }
+
         //! Find interactions between particles due to overlap and depletion interaction
         /*! \param timestep Current time step
             \param pivot The current pivot point
@@ -602,10 +644,7 @@ void UpdaterClusters<Shape>::findInteractions(unsigned int timestep, vec3<Scalar
     ArrayHandle<unsigned int> h_overlaps(m_mc->getInteractionMatrix(), access_location::host, access_mode::read);
 
     // clear the local bond and rejection lists
-    m_overlap.clear();
-    m_interact_old_old.clear();
-    m_interact_new_old.clear();
-    m_interact_new_new.clear();
+    m_bonds.clear();
     m_local_reject.clear();
 
     auto patch = m_mc->getPatchInteraction();
@@ -704,17 +743,9 @@ void UpdaterClusters<Shape>::findInteractions(unsigned int timestep, vec3<Scalar
                                         assert(it!=map.end());
                                         new_tag_j = it->second;
                                         }
-                                    auto p = std::make_pair(new_tag_i,new_tag_j);
-
-                                    // if particle interacts in different image already, add to that energy
-                                    float U = 0.0;
-                                        {
-                                        auto it_energy = m_energy_old_old.find(p);
-                                        if (it_energy != m_energy_old_old.end())
-                                            U = it_energy->second;
-                                        }
 
-                                    U += patch->energy(vec3<float>(r_ij), typ_i,
+                                    // contributions from different images are summed up on rank 0
+                                    float U = patch->energy(vec3<float>(r_ij), typ_i,
                                                         quat<float>(orientation_i),
                                                         float(d_i),
                                                         float(charge_i),
@@ -723,8 +754,7 @@ void UpdaterClusters<Shape>::findInteractions(unsigned int timestep, vec3<Scalar
                                                         float(m_diameter_backup[j]),
                                                         float(m_charge_backup[j]));
 
-                                    // update map
-                                    m_energy_old_old[p] = U;
+                                    m_energy_old_old.local().push_back(PairEnergy(new_tag_i, new_tag_j, U));
 
                                     int3 delta_img = m_image_backup[i] - m_image_backup[j];
                                     bool interacts_via_pbc = delta_img.x || delta_img.y || delta_img.z;
@@ -838,7 +868,7 @@ void UpdaterClusters<Shape>::findInteractions(unsigned int timestep, vec3<Scalar
                                         reject = true;
 
                                     // add connection
-                                    m_overlap.push_back(std::make_pair(h_tag.data[i],new_tag_j));
+                                    addBond(h_tag.data[i],new_tag_j);
 
                                     if (reject)
                                         {
@@ -910,17 +940,8 @@ void UpdaterClusters<Shape>::findInteractions(unsigned int timestep, vec3<Scalar
 
                                 if (rsq_ij <= rcut_ij*rcut_ij)
                                     {
-                                    auto p = std::make_pair(h_tag.data[i], new_tag_j);
-
-                                    // if particle interacts in different image already, add to that energy
-                                    float U = 0.0;
-                                        {
-                                        auto it_energy = m_energy_new_old.find(p);
-                                        if (it_energy != m_energy_new_old.end())
-                                            U = it_energy->second;
-                                        }
-
-                                    U += patch->energy(vec3<float>(r_ij), typ_i,
+                                    // contributions from different images are summed up on rank 0
+                                    float U = patch->energy(vec3<float>(r_ij), typ_i,
                                                             quat<float>(shape_i.orientation),
                                                             float(h_diameter.data[i]),
                                                             float(h_charge.data[i]),
@@ -929,8 +950,7 @@ void UpdaterClusters<Shape>::findInteractions(unsigned int timestep, vec3<Scalar
                                                             float(m_diameter_backup[j]),
                                                             float(m_charge_backup[j]));
 
-                                    // update map
-                                    m_energy_new_old[p] = U;
+                                    m_energy_new_old.local().push_back(PairEnergy(h_tag.data[i], new_tag_j, U));
 
                                     int3 delta_img = h_image.data[i] - m_image_backup[j];
                                     bool interacts_via_pbc = delta_img.x || delta_img.y || delta_img.z;
@@ -1046,7 +1066,7 @@ void UpdaterClusters<Shape>::findInteractions(unsigned int timestep, vec3<Scalar
                                         m_local_reject.insert(h_tag.data[i]);
                                         m_local_reject.insert(h_tag.data[j]);
 
-                                        m_interact_new_new.insert(std::make_pair(h_tag.data[i],h_tag.data[j]));
+                                        addBond(h_tag.data[i],h_tag.data[j]);
                                         }
                                     } // end if overlap
 
@@ -1074,10 +1094,6 @@ void UpdaterClusters<Shape>::findInteractions(unsigned int timestep, vec3<Scalar
     if (m_mc->getQuermassMode())
         throw std::runtime_error("update.clusters() doesn't support quermass mode\n");
 
-    // clear the local bond and rejection lists
-    this->m_interact_old_old.clear();
-    this->m_interact_new_old.clear();
-
     // for every depletant type
     for (unsigned int type_d = 0; type_d < this->m_pdata->getNTypes(); ++type_d)
         {
@@ -1157,7 +1173,7 @@ void UpdaterClusters<Shape>::findInteractions(unsigned int timestep, vec3<Scalar
                                             new_tag_j = it->second;
                                             }
 
-                                        this->m_interact_old_old.push_back(std::make_pair(new_tag_i,new_tag_j));
+                                        this->addBond(new_tag_i,new_tag_j);
 
                                         int3 delta_img = this->m_image_backup[i] - this->m_image_backup[j];
                                         bool interacts_via_pbc = delta_img.x || delta_img.y || delta_img.z;
@@ -1255,7 +1271,7 @@ void UpdaterClusters<Shape>::findInteractions(unsigned int timestep, vec3<Scalar
                                         h_overlaps.data[overlap_idx(typ_j,type_d)] &&
                                         rsq_ij <= RaRb*RaRb)
                                         {
-                                        this->m_interact_new_old.push_back(std::make_pair(h_tag.data[i],new_tag_j));
+                                        this->addBond(h_tag.data[i],new_tag_j);
 
                                         int3 delta_img = h_image.data[i] - this->m_image_backup[j];
                                         bool interacts_via_pbc = delta_img.x || delta_img.y || delta_img.z;
@@ -1359,7 +1375,7 @@ void UpdaterClusters<Shape>::findInteractions(unsigned int timestep, vec3<Scalar
                                                 this->m_local_reject.insert(h_tag.data[i]);
                                                 this->m_local_reject.insert(h_tag.data[j]);
 
-                                                this->m_interact_new_new.insert(std::make_pair(h_tag.data[i],h_tag.data[j]));
+                                                this->addBond(h_tag.data[i],h_tag.data[j]);
                                                 }
                                             } // end if overlap
 
@@ -1615,55 +1631,51 @@ void UpdaterClusters<Shape>::update(unsigned int timestep)
 
     if (m_prof) m_prof->push(m_exec_conf,"HPMC Clusters");
 
+    // one set per particle, findInteractions() merges the sets of bonded particles
+    if (master)
+        m_G.resize(m_pdata->getNGlobal());
+
     // determine which particles interact
     findInteractions(timestep, pivot, q, swap, line, map);
 
     if (m_prof) m_prof->push(m_exec_conf,"Move");
 
     // collect interactions on rank 0
+    std::vector< std::pair<unsigned int, unsigned int> > bonds;
+    std::vector<PairEnergy> energy_old_old;
+    std::vector<PairEnergy> energy_new_old;
+
+    m_bonds.gather(bonds);
+    if (m_mc->getPatchInteraction())
+        {
+        m_energy_old_old.gather(energy_old_old);
+        m_energy_new_old.gather(energy_new_old);
+        }
+
+    #ifdef ENABLE_MPI
+    std::vector< std::vector<std::pair<unsigned int, unsigned int> > > all_bonds;
     #ifndef ENABLE_TBB
-    std::vector< std::vector<std::pair<unsigned int, unsigned int> > > all_overlap;
-    std::vector< std::vector<std::pair<unsigned int, unsigned int> > > all_interact_old_old;
-    std::vector< std::vector<std::pair<unsigned int, unsigned int> > > all_interact_new_old;
-    std::vector< std::set<std::pair<unsigned int, unsigned int> > > all_interact_new_new;
     std::vector< std::set<unsigned int> > all_local_reject;
-
-    std::vector< std::map<std::pair<unsigned int, unsigned int>, float> > all_energy_old_old;
-    std::vector< std::map<std::pair<unsigned int, unsigned int>, float> > all_energy_new_old;
     #else
-    std::vector< tbb::concurrent_vector<std::pair<unsigned int, unsigned int> > > all_overlap;
-    std::vector< tbb::concurrent_vector<std::pair<unsigned int, unsigned int> > > all_interact_old_old;
-    std::vector< tbb::concurrent_vector<std::pair<unsigned int, unsigned int> > > all_interact_new_old;
-    std::vector< tbb::concurrent_unordered_set<std::pair<unsigned int, unsigned int> > > all_interact_new_new;
     std::vector< tbb::concurrent_unordered_set<unsigned int> > all_local_reject;
-
-    std::vector< tbb::concurrent_unordered_map<std::pair<unsigned int, unsigned int>, float> > all_energy_old_old;
-    std::vector< tbb::concurrent_unordered_map<std::pair<unsigned int, unsigned int>, float> > all_energy_new_old;
     #endif
+    std::vector< std::vector<PairEnergy> > all_energy_old_old;
+    std::vector< std::vector<PairEnergy> > all_energy_new_old;
 
-    #ifdef ENABLE_MPI
     if (m_comm)
         {
         // combine lists from different ranks
-        gather_v(m_overlap, all_overlap, 0, m_exec_conf->getMPICommunicator());
-        gather_v(m_interact_old_old, all_interact_old_old, 0, m_exec_conf->getMPICommunicator());
-        gather_v(m_interact_new_old, all_interact_new_old, 0, m_exec_conf->getMPICommunicator());
-        gather_v(m_interact_new_new, all_interact_new_new, 0, m_exec_conf->getMPICommunicator());
+        gather_v(bonds, all_bonds, 0, m_exec_conf->getMPICommunicator());
         gather_v(m_local_reject, all_local_reject, 0, m_exec_conf->getMPICommunicator());
-        }
-    #endif
 
-    if (m_mc->getPatchInteraction())
-        {
-        // collect energies on rank 0
-        #ifdef ENABLE_MPI
-        if (m_comm)
+        if (m_mc->getPatchInteraction())
             {
-            gather_v(m_energy_old_old, all_energy_old_old, 0, m_exec_conf->getMPICommunicator());
-            gather_v(m_energy_new_old, all_energy_new_old, 0, m_exec_conf->getMPICommunicator());
+            // collect energies on rank 0
+            gather_v(energy_old_old, all_energy_old_old, 0, m_exec_conf->getMPICommunicator());
+            gather_v(energy_new_old, all_energy_new_old, 0, m_exec_conf->getMPICommunicator());
             }
-        #endif
         }
+    #endif
 
     if (this->m_prof)
         this->m_prof->push("fill");
@@ -1672,16 +1684,6 @@ void UpdaterClusters<Shape>::update(unsigned int timestep)
         {
         // fill in the cluster bonds, using bond formation probability defined in Liu and Luijten
 
-        if (m_prof)
-            m_prof->push("realloc");
-
-        // resize the number of graph nodes in place
-        m_G.resize(snap.size);
-
-        if (m_prof)
-            m_prof->pop();
-
-
         #ifdef ENABLE_MPI
         if (m_comm)
             {
@@ -1693,351 +1695,108 @@ void UpdaterClusters<Shape>::update(unsigned int timestep)
                     m_ptl_reject.insert(*it_j);
                     }
                 }
-            }
-        #endif
-
-        if (line && !swap)
-            {
-            if (m_prof)
-                m_prof->push("new new");
-
-            #ifdef ENABLE_MPI
-            if (m_comm)
-                {
-                for (auto it_i = all_interact_new_new.begin(); it_i != all_interact_new_new.end(); ++it_i)
-                    {
-                    for (auto it_j = it_i->begin(); it_j != it_i->end(); ++it_j)
-                        {
-                        unsigned int i = it_j->first;
-                        unsigned int j = it_j->second;
-
-                        m_G.addEdge(i, j);
-                        }
-                    }
-                }
-            else
-            #endif
-                {
-                #ifdef ENABLE_TBB
-                tbb::parallel_for(m_interact_new_new.range(), [&] (decltype(m_interact_new_new.range()) r)
-                #else
-                auto &r = m_interact_new_new;
-                #endif
-                    {
-                    for (auto it = r.begin(); it != r.end(); ++it)
-                        {
-                        unsigned int i = it->first;
-                        unsigned int j = it->second;
-
-                        m_G.addEdge(i,j);
-                        }
-                    }
-                #ifdef ENABLE_TBB
-                    );
-                #endif
-                }
-
-            if (m_prof)
-                m_prof->pop();
-            }
-
-        #ifdef ENABLE_MPI
-        if (m_comm)
-            {
-            for (auto it_i = all_interact_new_old.begin(); it_i != all_interact_new_old.end(); ++it_i)
-                {
-                for (auto it_j = it_i->begin(); it_j != it_i->end(); ++it_j)
-                    {
-                    unsigned int i = it_j->first;
-                    unsigned int j = it_j->second;
-
-                    m_G.addEdge(i, j);
-                    }
-                }
-            }
-        else
-        #endif
-            {
-            #ifdef ENABLE_TBB
-            tbb::parallel_for(m_interact_new_old.range(), [&] (decltype(m_interact_new_old.range()) r)
-            #else
-            auto &r = m_interact_new_old;
-            #endif
-                {
-                for (auto it = r.begin(); it != r.end(); ++it)
-                    {
-                    unsigned int i = it->first;
-                    unsigned int j = it->second;
-
-                    m_G.addEdge(i,j);
-                    }
-                }
-            #ifdef ENABLE_TBB
-                );
-            #endif
-            }
-
-
-        if (m_prof)
-            m_prof->push("overlap");
-
-        #ifdef ENABLE_MPI
-        if (m_comm)
-            {
-            for (auto it_i = all_overlap.begin(); it_i != all_overlap.end(); ++it_i)
-                {
-                for (auto it_j = it_i->begin(); it_j != it_i->end(); ++it_j)
-                    {
-                    unsigned int i = it_j->first;
-                    unsigned int j = it_j->second;
-
-                    m_G.addEdge(i,j);
-                    }
-                }
-            }
-        else
-        #endif
-            {
-            #ifdef ENABLE_TBB
-            tbb::parallel_for(m_overlap.range(), [&] (decltype(m_overlap.range()) r)
-            #else
-            auto &r = m_overlap;
-            #endif
-                {
-                for (auto it = r.begin(); it != r.end(); ++it)
-                    {
-                    unsigned int i = it->first;
-                    unsigned int j = it->second;
-
-                    m_G.addEdge(i,j);
-                    }
-                }
-            #ifdef ENABLE_TBB
-                );
-            #endif
-            }
-
-        if (m_prof)
-            m_prof->pop();
 
-
-        // interactions due to hard depletant-excluded volume overlaps (not used in base class)
-        #ifdef ENABLE_MPI
-        if (m_comm)
-            {
-            for (auto it_i = all_interact_old_old.begin(); it_i != all_interact_old_old.end(); ++it_i)
+            // without domain decomposition, the bonds have been merged by findInteractions() already
+            for (auto it_i = all_bonds.begin(); it_i != all_bonds.end(); ++it_i)
                 {
                 for (auto it_j = it_i->begin(); it_j != it_i->end(); ++it_j)
                     {
-                    unsigned int i = it_j->first;
-                    unsigned int j = it_j->second;
-
-                    m_G.addEdge(i, j);
+                    m_G.unite(it_j->first, it_j->second);
                     }
                 }
-            }
-        else
-        #endif
-            {
-            #ifdef ENABLE_TBB
-            tbb::parallel_for(m_interact_old_old.range(), [&] (decltype(m_interact_old_old.range()) r)
-            #else
-            auto &r = m_interact_old_old;
-            #endif
-                {
-                for (auto it = r.begin(); it != r.end(); ++it)
-                    {
-                    unsigned int i = it->first;
-                    unsigned int j = it->second;
-
-                    m_G.addEdge(i,j);
-                    }
-                }
-            #ifdef ENABLE_TBB
-                );
-            #endif
-            }
-
-        #ifdef ENABLE_MPI
-        if (m_comm)
-            {
-            for (auto it_i = all_interact_new_old.begin(); it_i != all_interact_new_old.end(); ++it_i)
-                {
-                for (auto it_j = it_i->begin(); it_j != it_i->end(); ++it_j)
-                    {
-                    unsigned int i = it_j->first;
-                    unsigned int j = it_j->second;
 
-                    m_G.addEdge(i, j);
-                    }
-                }
+            // every pair is found on one rank only
+            energy_old_old.clear();
+            energy_new_old.clear();
+            for (auto it = all_energy_old_old.begin(); it != all_energy_old_old.end(); ++it)
+                energy_old_old.insert(energy_old_old.end(), it->begin(), it->end());
+            for (auto it = all_energy_new_old.begin(); it != all_energy_new_old.end(); ++it)
+                energy_new_old.insert(energy_new_old.end(), it->begin(), it->end());
             }
-        else
         #endif
-            {
-            #ifdef ENABLE_TBB
-            tbb::parallel_for(m_interact_new_old.range(), [&] (decltype(m_interact_new_old.range()) r)
-            #else
-            auto &r = m_interact_new_old;
-            #endif
-                {
-                for (auto it = r.begin(); it != r.end(); ++it)
-                    {
-                    unsigned int i = it->first;
-                    unsigned int j = it->second;
-
-                    m_G.addEdge(i,j);
-                    }
-                }
-            #ifdef ENABLE_TBB
-                );
-            #endif
-            }
 
         if (m_mc->getPatchInteraction())
             {
-            // sum up interaction energies
-            #ifdef ENABLE_TBB
-            tbb::concurrent_unordered_map< std::pair<unsigned int, unsigned int>, float> delta_U;
-            #else
-            std::map< std::pair<unsigned int, unsigned int>, float> delta_U;
-            #endif
-
-            #ifdef ENABLE_MPI
-            if (m_comm)
+            if (m_prof)
+                m_prof->push("energy");
+
+            // sum up interaction energies over all images
+            detail::sumPairEnergies(energy_old_old);
+            detail::sumPairEnergies(energy_new_old);
+
+            // energy differences of all pairs interacting in either configuration
+            std::vector<PairEnergy> delta_U;
+            delta_U.reserve(energy_old_old.size() + energy_new_old.size());
+            auto it_old = energy_old_old.begin();
+            auto it_new = energy_new_old.begin();
+            while (it_old != energy_old_old.end() || it_new != energy_new_old.end())
                 {
-                for (auto it_i = all_energy_old_old.begin(); it_i != all_energy_old_old.end(); ++it_i)
+                if (it_new == energy_new_old.end() || (it_old != energy_old_old.end() && *it_old < *it_new))
                     {
-                    for (auto it_j = it_i->begin(); it_j != it_i->end(); ++it_j)
-                        {
-                        float delU = -it_j->second;
-                        unsigned int i = it_j->first.first;
-                        unsigned int j = it_j->first.second;
-
-                        auto p = std::make_pair(i,j);
-
-                        // add to energy
-                        auto it = delta_U.find(p);
-                        if (it != delta_U.end())
-                            delU += it->second;
-
-                        // update map with new interaction energy
-                        delta_U[p] = delU;
-                        }
+                    delta_U.push_back(PairEnergy(it_old->i, it_old->j, -it_old->U));
+                    ++it_old;
                     }
-                }
-            else
-            #endif
-                {
-                for (auto it = m_energy_old_old.begin(); it != m_energy_old_old.end(); ++it)
+                else if (it_old == energy_old_old.end() || *it_new < *it_old)
                     {
-                    float delU = -it->second;
-                    unsigned int i = it->first.first;
-                    unsigned int j = it->first.second;
-
-                    auto p = std::make_pair(i,j);
-
-                    // add to energy
-                    auto itj = delta_U.find(p);
-                    if (itj != delta_U.end())
-                        delU += itj->second;
-
-                    // update map with new interaction energy
-                    delta_U[p] = delU;
+                    delta_U.push_back(*it_new);
+                    ++it_new;
                     }
-                }
-
-            #ifdef ENABLE_MPI
-            if (m_comm)
-                {
-                for (auto it_i = all_energy_new_old.begin(); it_i != all_energy_new_old.end(); ++it_i)
-                    {
-                    for (auto it_j = it_i->begin(); it_j != it_i->end(); ++it_j)
-                        {
-                        float delU = it_j->second;
-                        unsigned int i = it_j->first.first;
-                        unsigned int j = it_j->first.second;
-
-                        // consider each pair uniquely
-                        auto p = std::make_pair(i,j);
-
-                        // add to energy
-                        auto it = delta_U.find(p);
-                        if (it != delta_U.end())
-                            delU += it->second;
-
-                        // update map with new interaction energy
-                        delta_U[p] = delU;
-                        }
-                    }
-                }
-            else
-            #endif
-                {
-                for (auto it = m_energy_new_old.begin(); it != m_energy_new_old.end(); ++it)
+                else
                     {
-                    float delU = it->second;
-                    unsigned int i = it->first.first;
-                    unsigned int j = it->first.second;
-
-                    auto p = std::make_pair(i,j);
-
-                    // add to energy
-                    auto itj = delta_U.find(p);
-                    if (itj != delta_U.end())
-                        delU += itj->second;
-
-                    // update map with new interaction energy
-                    delta_U[p] = delU;
+                    delta_U.push_back(PairEnergy(it_new->i, it_new->j, it_new->U + -it_old->U));
+                    ++it_old;
+                    ++it_new;
                     }
                 }
 
             #ifdef ENABLE_TBB
-            tbb::parallel_for(delta_U.range(), [&] (decltype(delta_U.range()) r)
+            tbb::parallel_for((unsigned int)0, (unsigned int)delta_U.size(), [&](unsigned int k)
             #else
-            auto &r = delta_U;
+            for (unsigned int k = 0; k < delta_U.size(); ++k)
             #endif
                 {
-                for (auto it = r.begin(); it != r.end(); ++it)
-                    {
-                    float delU = it->second;
-                    unsigned int i = it->first.first;
-                    unsigned int j = it->first.second;
+                float delU = delta_U[k].U;
+                unsigned int i = delta_U[k].i;
+                unsigned int j = delta_U[k].j;
 
-                    // create a RNG specific to this particle pair
-                    hoomd::RandomGenerator rng_ij(hoomd::RNGIdentifier::UpdaterClustersPairwise, this->m_seed, timestep, std::min(i,j), std::max(i,j));
+                // create a RNG specific to this particle pair
+                hoomd::RandomGenerator rng_ij(hoomd::RNGIdentifier::UpdaterClustersPairwise, this->m_seed, timestep, std::min(i,j), std::max(i,j));
 
-                    float pij = 1.0f-exp(-delU);
-                    if (hoomd::detail::generate_canonical<float>(rng_ij) <= pij) // GCA
-                        {
-                        // add bond
-                        m_G.addEdge(i,j);
-                        }
+                float pij = 1.0f-exp(-delU);
+                if (hoomd::detail::generate_canonical<float>(rng_ij) <= pij) // GCA
+                    {
+                    // add bond
+                    m_G.unite(i,j);
                     }
                 }
             #ifdef ENABLE_TBB
                 );
             #endif
+
+            if (m_prof)
+                m_prof->pop();
             } // end if (patch)
 
         if (this->m_prof) this->m_prof->push("connected components");
         // compute connected components
-        m_clusters.clear();
-        m_G.connectedComponents(m_clusters);
+        m_G.connectedComponents(m_cluster_members, m_cluster_offsets);
         if (this->m_prof) this->m_prof->pop();
 
         if (this->m_prof) this->m_prof->push("reject");
 
         // move every cluster independently
-        m_count_total.n_clusters += m_clusters.size();
+        unsigned int n_clusters = (unsigned int)m_cluster_offsets.size()-1;
+        m_count_total.n_clusters += n_clusters;
 
-        for (unsigned int icluster = 0; icluster < m_clusters.size(); icluster++)
+        for (unsigned int icluster = 0; icluster < n_clusters; icluster++)
             {
-            m_count_total.n_particles_in_clusters += m_clusters[icluster].size();
+            const unsigned int *begin = m_cluster_members.data() + m_cluster_offsets[icluster];
+            const unsigned int *end = m_cluster_members.data() + m_cluster_offsets[icluster+1];
+            m_count_total.n_particles_in_clusters += end - begin;
 
             // if any particle in the cluster is rejected, the cluster is not transformed
             bool reject = false;
-            for (auto it = m_clusters[icluster].begin(); it != m_clusters[icluster].end(); ++it)
+            for (auto it = begin; it != end; ++it)
                 {
                 bool mpi = false;
                 #ifdef ENABLE_MPI
@@ -2057,7 +1816,7 @@ void UpdaterClusters<Shape>::update(unsigned int timestep)
                 int n_A_old = 0, n_A_new = 0;
                 int n_B_old = 0, n_B_new = 0;
 
-                for (auto it = m_clusters[icluster].begin(); it != m_clusters[icluster].end(); ++it)
+                for (auto it = begin; it != end; ++it)
                     {
                     unsigned int i = *it;
                     if (snap.type[i] == m_ab_types[0])
@@ -2079,7 +1838,7 @@ void UpdaterClusters<Shape>::update(unsigned int timestep)
             if (reject || !flip)
                 {
                 // revert cluster
-                for (auto it = m_clusters[icluster].begin(); it != m_clusters[icluster].end(); ++it)
+                for (auto it = begin; it != end; ++it)
                     {
                     // particle index
                     unsigned int i = *it;
@@ -2108,7 +1867,7 @@ void UpdaterClusters<Shape>::update(unsigned int timestep)
                 }
             else if (flip)
                 {
-                for (auto it = m_clusters[icluster].begin(); it != m_clusters[icluster].end(); ++it)
+                for (auto it = begin; it != end; ++it)
                     {
                     // particle index
                     unsigned int i = *it;
@@ -2196,6 +1955,9 @@ void UpdaterClusters<Shape>::update(unsigned int timestep)
 
     if (m_prof) m_prof->pop(m_exec_conf);
 
+    // the cluster moves are not tracked by the incremental patch energy
+    m_mc->invalidateTotalPatchEnergy();
+
     m_mc->communicate(true);
     }
 
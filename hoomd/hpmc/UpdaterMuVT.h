@@ -1376,6 +1376,9 @@ void UpdaterMuVT<Shape>::update(unsigned int timestep)
         }
     #endif
 
+    // particles have been inserted or removed
+    m_mc->invalidateTotalPatchEnergy();
+
     if (m_prof) m_prof->pop();
     }
 
@@ -2167,7 +2170,7 @@ bool UpdaterMuVT<Shape>::moveDepletantsIntoOldPosition(unsigned int timestep, un
         ArrayHandle<Scalar4> h_postype(this->m_pdata->getPositions(), access_location::host, access_mode::read);
         ArrayHandle<Scalar4> h_orientation(this->m_pdata->getOrientationArray(), access_location::host, access_mode::read);
         ArrayHandle<unsigned int> h_tag(this->m_pdata->getTags(), access_location::host, access_mode::read);
-        ArrayHandle<unsigned int> h_rtag(this->m_pdata->getRTags(), access_location::host, access_mode::read);
+        TagIndexHandle h_rtag(*this->m_pdata, access_mode::read);
         ArrayHandle<unsigned int> h_overlaps(this->m_mc->getInteractionMatrix(), access_location::host, access_mode::read);
 
         auto& params = this->m_mc->getParams();
@@ -2272,7 +2275,7 @@ bool UpdaterMuVT<Shape>::moveDepletantsIntoOldPosition(unsigned int timestep, un
                     } // end loop over images
 
                 // resolve the updated particle tag
-                unsigned int j = h_rtag.data[tag];
+                unsigned int j = h_rtag[tag];
                 assert(j < this->m_pdata->getN());
 
                 // load the old position and orientation of the updated particle
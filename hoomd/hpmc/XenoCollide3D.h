@@ -39,6 +39,8 @@ const unsigned int XENOCOLLIDE_3D_MAX_ITERATIONS = 1024;
     \param q Orientation of shape B in frame A
     \param R Approximate radius of Minkowski difference for scaling tolerance value
     \param err_count Error counter to increment whenever an infinite loop is encountered
+    \param sep_axis If not NULL, a candidate separating axis in frame A (zero if there is none). When the shapes are
+           disjoint, it is set to an axis that separates them.
     \returns true when the two shapes overlap and false when they are disjoint.
 
     XenoCollide is a generic algorithm for detecting overlaps between two shapes. It operates with the support function
@@ -60,6 +62,11 @@ const unsigned int XENOCOLLIDE_3D_MAX_ITERATIONS = 1024;
     The recommended way of using this code is to specify the support functor in the same file as the shape data
     (e.g. ShapeConvexPolyhedron.h). Then include XenoCollide3D.h and call xenocollide_3d where needed.
 
+    **Warm start**
+    When a separating axis is passed in *sep_axis*, a single evaluation of the support function is enough to prove that
+    the shapes are still disjoint if the axis still separates them. Callers that test the same pair repeatedly with small
+    displacements can keep the axis returned by the previous test to skip the full search for most disjoint pairs.
+
     **Normalization**
     In _Games Programming Gems_, the book normalizes all vectors passed into S. This is unnecessary in some circumstances
     and we avoid it for performance reasons. Support functions that require the use of normal n vectors should normalize
@@ -73,7 +80,8 @@ DEVICE inline bool xenocollide_3d(const SupportFuncA& sa,
                                   const vec3<OverlapReal>& ab_t,
                                   const quat<OverlapReal>& q,
                                   const OverlapReal R,
-                                  unsigned int& err_count)
+                                  unsigned int& err_count,
+                                  vec3<OverlapReal>* sep_axis = NULL)
     {
     // This implementation of XenoCollide is hand-written from the description of the algorithm on page 171 of _Games
     // Programming Gems 7_
@@ -90,6 +98,13 @@ DEVICE inline bool xenocollide_3d(const SupportFuncA& sa,
         return true;
         }
 
+    // the shapes are disjoint if the origin is outside the support plane of the candidate separating axis
+    if (sep_axis && (sep_axis->x != OverlapReal(0.0) || sep_axis->y != OverlapReal(0.0) || sep_axis->z != OverlapReal(0.0)))
+        {
+        if (dot(S(*sep_axis), *sep_axis) < OverlapReal(0.0))
+            return false;
+        }
+
     // Phase 1: Portal Discovery
     // ------
     // Find the origin ray v0 from the origin to an interior point of the Minkowski difference.
@@ -104,7 +119,10 @@ DEVICE inline bool xenocollide_3d(const SupportFuncA& sa,
 
     /* if (dot(v1, v1 - v0) <= 0) // by convexity */
     if (dot(v1, v0) > OverlapReal(0.0))
+        {
+        if (sep_axis) *sep_axis = -v0;
         return false;   // origin is outside v1 support plane
+        }
 
     // find support v2 perpendicular to v0, v1 plane
     n = cross(v1, v0);
@@ -117,7 +135,10 @@ DEVICE inline bool xenocollide_3d(const SupportFuncA& sa,
     v2 = S(n); // Convexity should guarantee ||v2|| > 0, but v2 == v1 may be possible in edge cases of {B}-{A}
     // particles do not overlap if origin outside v2 support plane
     if (dot(v2, n) < OverlapReal(0.0))
+        {
+        if (sep_axis) *sep_axis = n;
         return false;
+        }
 
     // Find next support direction perpendicular to plane (v1,v0,v2)
     n = cross(v1 - v0, v2 - v0);
@@ -145,7 +166,10 @@ DEVICE inline bool xenocollide_3d(const SupportFuncA& sa,
         // Get the next support point
         v3 = S(n);
         if (dot(v3, n) <= 0)
+            {
+            if (sep_axis) *sep_axis = n;
             return false; // check if origin outside v3 support plane
+            }
 
         // If origin lies on opposite side of a plane from the third support point, use outer-facing plane normal
         // to find a new support point.
@@ -199,6 +223,7 @@ DEVICE inline bool xenocollide_3d(const SupportFuncA& sa,
         // if (origin outside support plane) return false
         if (dot(v4, n) < OverlapReal(0.0))
             {
+            if (sep_axis) *sep_axis = n;
             return false;
             }
 
@@ -211,7 +236,11 @@ DEVICE inline bool xenocollide_3d(const SupportFuncA& sa,
 
         // First, check if v4 is on plane (v2,v1,v3)
         if (fabs(d) < tol)
+            {
+            // the portal normal separates the shapes to within the tolerance, so it makes a good candidate next time
+            if (sep_axis) *sep_axis = n;
             return false; // no more refinement possible, but not intersection detected
+            }
 
         // Second, check if origin is on plane (v2,v1,v3) and has been missed by other checks
         d = dot(v1 * tol_multiplier, n);
@@ -278,6 +307,140 @@ DEVICE inline bool xenocollide_3d(const SupportFuncA& sa,
 
         }
     }
+
+//! Scale factor of the separation at which two shapes touch, by ray casting the Minkowski difference in 3D
+/*! \tparam SupportFuncA Support function class type for shape A
+    \tparam SupportFuncB Support function class type for shape B
+    \param sa Support function for shape A
+    \param sb Support function for shape B
+    \param ab_t Vector pointing from a's center to b's center, in frame A
+    \param q Orientation of shape B in frame A
+    \param R Approximate radius of Minkowski difference for scaling tolerance value
+    \param err_count Error counter to increment whenever an infinite loop is encountered
+    \returns the largest s such that the shapes overlap when b is placed at s*ab_t
+
+    The shapes overlap at the separation s*ab_t when (1-s)*ab_t lies inside their Minkowski difference. This function
+    casts the ray from the interior point ab_t through the origin onto the boundary of the Minkowski difference, using
+    the portal discovery and refinement phases of xenocollide_3d(). Instead of stopping once the origin is found to
+    be inside or outside, the portal is refined until it lies on the boundary to within the tolerance, and the ray is
+    intersected with it. The shapes overlap at ab_t itself if and only if the result is at least 1.
+
+    Both shapes must contain their centers.
+
+    \ingroup minkowski
+*/
+template<class SupportFuncA, class SupportFuncB>
+DEVICE inline OverlapReal xenocollide_contact_3d(const SupportFuncA& sa,
+                                                 const SupportFuncB& sb,
+                                                 const vec3<OverlapReal>& ab_t,
+                                                 const quat<OverlapReal>& q,
+                                                 const OverlapReal R,
+                                                 unsigned int& err_count)
+    {
+    vec3<OverlapReal> v0, v1, v2, v3, v4, n;
+    CompositeSupportFunc3D<SupportFuncA, SupportFuncB> S(sa, sb, ab_t, q);
+    const OverlapReal precision_tol = OverlapReal(1e-7);        // precision tolerance for single-precision floats near 1.0
+    const OverlapReal contact_tol = OverlapReal(1e-6);          // relative accuracy of the boundary point
+
+    // Phase 1: Portal Discovery
+    v0 = ab_t;
+
+    // find support v1 along the ray
+    v1 = S(-v0);
+
+    // find support v2 perpendicular to v0, v1 plane
+    n = cross(v1, v0);
+    if (fabs(n.x) < precision_tol && fabs(n.y) < precision_tol && fabs(n.z) < precision_tol)
+        {
+        // v1 is on the ray, and its support plane is perpendicular to it
+        return dot(v0 - v1, v0) / dot(v0, v0);
+        }
+
+    v2 = S(n);
+
+    // Find next support direction perpendicular to plane (v1,v0,v2)
+    n = cross(v1 - v0, v2 - v0);
+    // Maintain known handedness of the portal: make sure plane normal points towards the ray
+    if (dot(n, v0) > OverlapReal(0.0))
+        {
+        v1.swap(v2);
+        n = -n;
+        }
+
+    // while (ray does not intersect candidate) choose new candidate
+    unsigned int count = 0;
+    while (true)
+        {
+        count++;
+
+        if (count >= XENOCOLLIDE_3D_MAX_ITERATIONS)
+            {
+            err_count++;
+            break;
+            }
+
+        v3 = S(n);
+
+        // the ray passes through the origin, so the side tests of xenocollide_3d() apply unchanged
+        if (dot(cross(v1, v3), v0) < OverlapReal(0.0))
+            {
+            v2 = v3;
+            n = cross(v1 - v0, v2 - v0);
+            continue;
+            }
+        if (dot(cross(v3, v2), v0) < OverlapReal(0.0))
+            {
+            v1 = v3;
+            n = cross(v1 - v0, v2 - v0);
+            continue;
+            }
+
+        break;
+        }
+
+    // Phase 2: Portal Refinement
+    count = 0;
+    while (true)
+        {
+        count++;
+
+        n = cross(v2 - v1, v3 - v1); // by construction, this is the outer-facing normal
+
+        // find support in direction of portal's outer facing normal
+        v4 = S(n);
+
+        // stop when the support plane is within the tolerance of the portal
+        if (dot(v4 - v1, n) <= contact_tol * R * fast::sqrt(dot(n,n)))
+            break;
+
+        if (count >= XENOCOLLIDE_3D_MAX_ITERATIONS)
+            {
+            err_count++;
+            break;
+            }
+
+        // Choose new portal, the one of (v4,v2,v3), (v1,v4,v3), (v1,v2,v4) that the ray passes through
+        vec3<OverlapReal> x = cross(v4, v0);
+        if (dot(v1, x) > OverlapReal(0.0))
+            {
+            if (dot(v2, x) > OverlapReal(0.0))
+                v1 = v4;    // Inside v1 & inside v2 ==> eliminate v1
+            else
+                v3 = v4;                   // Inside v1 & outside v2 ==> eliminate v3
+            }
+        else
+            {
+            if (dot(v3, x) > OverlapReal(0.0))
+                v2 = v4;    // Outside v1 & inside v3 ==> eliminate v2
+            else
+                v1 = v4;                   // Outside v1 & outside v3 ==> eliminate v1
+            }
+        }
+
+    // intersect the ray (1-s)*v0 with the portal plane
+    return dot(v0 - v1, n) / dot(v0, n);
+    }
+
 } // end namespace hpmc::detail
 
 }; // end namespace hpmc
@@ -0,0 +1,155 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+/*! \file benchmark_overlap.cc
+    \brief Benchmarks the pair overlap checks of HPMC shapes
+*/
+
+// this include is necessary to get MPI included before anything else to support intel MPI
+#include "hoomd/ExecutionConfiguration.h"
+
+#include "hoomd/hpmc/Moves.h"
+#include "hoomd/hpmc/ShapeConvexPolyhedron.h"
+#include "hoomd/hpmc/ShapeEllipsoid.h"
+#include "hoomd/hpmc/ShapeSphere.h"
+#include "hoomd/hpmc/ShapeSpheropolyhedron.h"
+
+#include "hoomd/benchmarks/benchmark.h"
+
+using namespace std;
+using namespace hpmc;
+using namespace hpmc::detail;
+
+//! Global runner of the benchmarks in this executable
+BenchmarkRunner benchmarks("hpmc");
+
+HOOMD_UP_MAIN();
+
+//! Number of particle pairs tested per iteration
+const unsigned int n_pairs = 4096;
+
+//! Benchmark test_overlap for one shape
+/*! \param name Name of the shape
+    \param param Shape parameters
+    \param seed Random number seed
+
+    Pairs of randomly oriented shapes are placed at random separations between one half and one times the
+    circumsphere diameter, where the circumsphere check passes and the overlap check of the shape decides. The
+    shapes are constructed inside the loop as in the HPMC kernels.
+*/
+template<class Shape>
+void overlap_benchmark(const std::string& name, const typename Shape::param_type& param, unsigned int seed=1)
+    {
+    const std::string config = "random";
+    if (!benchmarks.selected(name, config))
+        return;
+
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+
+    hoomd::RandomGenerator rng(seed, 0x6f766572);
+    Shape ref(quat<Scalar>(), param);
+    OverlapReal d = ref.getCircumsphereDiameter();
+
+    std::vector< vec3<Scalar> > r_ab(n_pairs);
+    std::vector< quat<Scalar> > q_a(n_pairs);
+    std::vector< quat<Scalar> > q_b(n_pairs);
+    for (unsigned int i = 0; i < n_pairs; i++)
+        {
+        vec3<Scalar> dir;
+        hoomd::SpherePointGenerator<Scalar>()(rng, dir);
+        r_ab[i] = dir * Scalar(d) * hoomd::UniformDistribution<Scalar>(Scalar(0.5), Scalar(1.0))(rng);
+        q_a[i] = generateRandomOrientation(rng, 3);
+        q_b[i] = generateRandomOrientation(rng, 3);
+        }
+
+    unsigned int overlaps = 0;
+    auto kernel = [&](unsigned int num_iters)
+        {
+        return benchmark_loop([&](unsigned int)
+            {
+            unsigned int err = 0;
+            for (unsigned int i = 0; i < n_pairs; i++)
+                {
+                Shape shape_a(q_a[i], param);
+                Shape shape_b(q_b[i], param);
+                overlaps += test_overlap(r_ab[i], shape_a, shape_b, err);
+                }
+            }, num_iters);
+        };
+
+    BenchmarkResult& result = benchmarks.run(exec_conf, "test_overlap<" + name + ">", config, {}, 0, n_pairs,
+                                             kernel);
+
+    // count the overlapping pairs once, and keep the compiler from eliminating the checks
+    overlaps = 0;
+    kernel(1);
+    UP_ASSERT(overlaps > 0);
+    result.metrics["overlap_fraction"] = double(overlaps) / double(n_pairs);
+    }
+
+//! Make the vertices of a convex polyhedron
+/*! \param verts Vertices
+    \param sweep_radius Sweep radius
+*/
+PolyhedronVertices make_polyhedron(const std::vector< vec3<OverlapReal> >& verts, OverlapReal sweep_radius=0)
+    {
+    return PolyhedronVertices(verts, sweep_radius, 0);
+    }
+
+//! Make the vertices of a cube with unit edge length
+std::vector< vec3<OverlapReal> > cube_vertices()
+    {
+    std::vector< vec3<OverlapReal> > verts;
+    for (int i = 0; i < 8; i++)
+        verts.push_back(vec3<OverlapReal>((i & 1) ? 0.5 : -0.5, (i & 2) ? 0.5 : -0.5, (i & 4) ? 0.5 : -0.5));
+    return verts;
+    }
+
+//! Make the vertices of a convex polyhedron with many vertices, all on the unit sphere
+std::vector< vec3<OverlapReal> > sphere_vertices(unsigned int n)
+    {
+    // golden spiral
+    std::vector< vec3<OverlapReal> > verts;
+    const double golden_angle = M_PI * (3.0 - std::sqrt(5.0));
+    for (unsigned int i = 0; i < n; i++)
+        {
+        double z = 1.0 - 2.0 * (double(i) + 0.5) / double(n);
+        double r = std::sqrt(1.0 - z*z);
+        double phi = golden_angle * double(i);
+        verts.push_back(vec3<OverlapReal>(OverlapReal(r*cos(phi)), OverlapReal(r*sin(phi)), OverlapReal(z)));
+        }
+    return verts;
+    }
+
+UP_TEST( ShapeSphere_overlap_benchmark )
+    {
+    SphereParams sphere;
+    sphere.radius = OverlapReal(0.5);
+    sphere.ignore = 0;
+    sphere.isOriented = false;
+    overlap_benchmark<ShapeSphere>("ShapeSphere", sphere);
+    }
+
+UP_TEST( ShapeEllipsoid_overlap_benchmark )
+    {
+    EllipsoidParams ellipsoid;
+    ellipsoid.x = OverlapReal(0.5);
+    ellipsoid.y = OverlapReal(0.25);
+    ellipsoid.z = OverlapReal(0.15);
+    ellipsoid.ignore = 0;
+    overlap_benchmark<ShapeEllipsoid>("ShapeEllipsoid", ellipsoid);
+    }
+
+UP_TEST( ShapeConvexPolyhedron_overlap_benchmark )
+    {
+    overlap_benchmark<ShapeConvexPolyhedron>("ShapeConvexPolyhedron:cube", make_polyhedron(cube_vertices()));
+    overlap_benchmark<ShapeConvexPolyhedron>("ShapeConvexPolyhedron:64", make_polyhedron(sphere_vertices(64)));
+    overlap_benchmark<ShapeConvexPolyhedron>("ShapeConvexPolyhedron:1024", make_polyhedron(sphere_vertices(1024)));
+    }
+
+UP_TEST( ShapeSpheropolyhedron_overlap_benchmark )
+    {
+    overlap_benchmark<ShapeSpheropolyhedron>("ShapeSpheropolyhedron:cube",
+                                             make_polyhedron(cube_vertices(), OverlapReal(0.1)));
+    }
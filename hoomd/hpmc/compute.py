@@ -21,12 +21,26 @@ class free_volume(Compute):
         type (str): Type of particle to use for integration
         nsample (int): Number of samples to use in MC integration
         suffix (str): Suffix to use for log quantity
+        quasi_random (bool): Place the test particles on a randomly shifted Halton sequence
+        target_rel_error (float): Stop sampling once the estimated relative error of the free volume is below this
+            value
 
     :py:class`free_volume` computes the free volume of a particle assembly using stochastic integration with a test particle type.
     It works together with an HPMC integrator, which defines the particle types used in the simulation.
     As parameters it requires the number of MC integration samples (*nsample*), and the type of particle (*test_type*)
     to use for the integration.
 
+    With *quasi_random*, the test particle positions follow a low discrepancy (Halton) sequence instead of independent
+    random numbers, which reduces the integration error for the same *nsample*. The sequence is shifted by a random
+    offset at every evaluation, so that the estimate remains unbiased.
+
+    When *target_rel_error* is set, the test particles are inserted in batches and sampling stops after the first
+    batch at which the binomial standard error of the free volume, relative to the estimate, is below the target.
+    *nsample* then sets the maximum number of samples. This error estimate is conservative with *quasi_random*.
+
+    Test particles are inserted in parallel when HOOMD is built with TBB. *quasi_random* and *target_rel_error* are
+    only supported on the CPU.
+
     Once initialized, the compute provides a log quantity
     called **hpmc_free_volume**, that can be logged via ``hoomd.analyze.log``.
     If a suffix is specified, the log quantities name will be
@@ -36,10 +50,11 @@ class free_volume(Compute):
 
         mc = hpmc.integrate.sphere(seed=415236)
         compute.free_volume(mc=mc, seed=123, test_type='B', nsample=1000)
+        compute.free_volume(mc=mc, seed=123, test_type='B', nsample=100000, quasi_random=True, target_rel_error=0.01)
         log = analyze.log(quantities=['hpmc_free_volume'], period=100, filename='log.dat', overwrite=True)
 
     """
-    def __init__(self, mc, seed, suffix='', test_type=None, nsample=None):
+    def __init__(self, mc, seed, suffix='', test_type=None, nsample=None, quasi_random=False, target_rel_error=None):
 
         # initialize base class
         _compute.__init__(self);
@@ -124,6 +139,13 @@ class free_volume(Compute):
             self.cpp_compute.setTestParticleType(itype)
         if nsample is not None:
             self.cpp_compute.setNumSamples(int(nsample))
+        if quasi_random or target_rel_error is not None:
+            if hoomd.context.current.device.cpp_exec_conf.isCUDAEnabled():
+                hoomd.context.current.device.cpp_msg.error("compute.free_volume: quasi_random and target_rel_error are not supported on the GPU.\n");
+                raise RuntimeError("Error initializing compute.free_volume");
+            self.cpp_compute.quasi_random = bool(quasi_random)
+            if target_rel_error is not None:
+                self.cpp_compute.target_rel_error = float(target_rel_error)
 
         hoomd.context.current.system.addCompute(self.cpp_compute, self.compute_name)
         self.enabled = True
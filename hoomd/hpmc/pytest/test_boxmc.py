@@ -244,6 +244,30 @@ def test_disk_compression(betaP, box_move, simulation_factory,
     assert sim.state.box != initial_box
 
 
+@pytest.mark.parametrize("box_move", box_moves_attrs)
+def test_cube_compression(box_move, simulation_factory,
+                          lattice_snapshot_factory):
+    """Test that box moves of dense anisotropic shapes create no overlaps."""
+    n = 6
+    snap = lattice_snapshot_factory(dimensions=3, n=n, a=1.1)
+
+    boxmc = hoomd.hpmc.update.BoxMC(betaP=hoomd.variant.Constant(20), seed=1)
+    setattr(boxmc, box_move['move'], box_move['params'])
+
+    sim = simulation_factory(snap)
+    sim.operations.updaters.append(boxmc)
+    mc = hoomd.hpmc.integrate.ConvexPolyhedron(d=0.05, a=0.05, seed=1)
+    mc.shape['A'] = dict(vertices=[(x, y, z) for x in (-0.5, 0.5)
+                                   for y in (-0.5, 0.5)
+                                   for z in (-0.5, 0.5)])
+    sim.operations.integrator = mc
+
+    sim.run(500)
+
+    # the box moves checked only near contacts, count all overlaps
+    assert mc.overlaps == 0
+
+
 @pytest.mark.parametrize("box_move", box_moves_attrs)
 def test_counters(box_move, simulation_factory, lattice_snapshot_factory,
                   counter_attrs):
@@ -85,6 +85,79 @@ UP_TEST( support )
     UP_ASSERT(v1 == v2);
     }
 
+UP_TEST( support_hill_climb )
+    {
+    // many vertices on a golden spiral over the unit sphere, with every fourth one pulled inside the hull
+    vector< vec3<OverlapReal> > vlist;
+    const unsigned int n = 4*PolyhedronVertices::hill_climb_min_verts;
+    const double golden_angle = M_PI * (3.0 - std::sqrt(5.0));
+    for (unsigned int i = 0; i < n; i++)
+        {
+        double z = 1.0 - 2.0 * (double(i) + 0.5) / double(n);
+        double r = std::sqrt(1.0 - z*z);
+        double phi = golden_angle * double(i);
+        OverlapReal scale = (i % 4 == 3) ? OverlapReal(0.5) : OverlapReal(1.0);
+        vlist.push_back(scale*vec3<OverlapReal>(OverlapReal(r*cos(phi)), OverlapReal(r*sin(phi)), OverlapReal(z)));
+        }
+    PolyhedronVertices verts(vlist, 0, 0);
+    UP_ASSERT(verts.hull_adj_offset.size() > 0);
+
+    // the same shape without the adjacency graph scans all vertices
+    PolyhedronVertices verts_scan(verts);
+    verts_scan.hull_adj_offset = ManagedArray<unsigned int>();
+    verts_scan.hull_adj = ManagedArray<unsigned int>();
+
+    // reuse the support functions so that each climb starts from the last result
+    SupportFuncConvexPolyhedron sa(verts);
+    SupportFuncConvexPolyhedron sb(verts_scan);
+    hoomd::RandomGenerator rng(123, 456);
+    for (unsigned int i = 0; i < 1000; i++)
+        {
+        vec3<OverlapReal> dir;
+        hoomd::SpherePointGenerator<OverlapReal>()(rng, dir);
+        vec3<OverlapReal> v1 = sa(dir);
+        vec3<OverlapReal> v2 = sb(dir);
+        MY_CHECK_CLOSE(dot(dir, v1), dot(dir, v2), tol);
+        }
+    }
+
+UP_TEST( overlap_warm_start )
+    {
+    // a pair of cubes in random walks, with the separating axis carried from one test to the next
+    vector< vec3<OverlapReal> > vlist;
+    for (int i = 0; i < 8; i++)
+        vlist.push_back(vec3<OverlapReal>((i & 1) ? 0.5 : -0.5, (i & 2) ? 0.5 : -0.5, (i & 4) ? 0.5 : -0.5));
+    PolyhedronVertices verts(vlist, 0, 0);
+
+    hoomd::RandomGenerator rng(123, 789);
+    vec3<Scalar> r_ab(1.2, 0.1, 0.0);
+    quat<Scalar> o_a, o_b;
+    vec3<OverlapReal> axis;
+    unsigned int n_overlap = 0;
+    for (unsigned int i = 0; i < 10000; i++)
+        {
+        r_ab = r_ab + vec3<Scalar>(hoomd::UniformDistribution<Scalar>(-0.02, 0.02)(rng),
+                                   hoomd::UniformDistribution<Scalar>(-0.02, 0.02)(rng),
+                                   hoomd::UniformDistribution<Scalar>(-0.02, 0.02)(rng));
+        // keep the pair close
+        if (dot(r_ab, r_ab) > 4.0)
+            r_ab = r_ab * Scalar(0.5);
+        move_rotate<3>(o_a, rng, 0.05);
+        move_rotate<3>(o_b, rng, 0.05);
+
+        ShapeConvexPolyhedron a(o_a, verts);
+        ShapeConvexPolyhedron b(o_b, verts);
+        bool cold = test_overlap(r_ab, a, b, err_count);
+        bool warm = test_overlap_warm(r_ab, a, b, err_count, axis);
+        UP_ASSERT_EQUAL(cold, warm);
+        n_overlap += cold;
+        }
+
+    // both outcomes should have been tested
+    UP_ASSERT(n_overlap > 0);
+    UP_ASSERT(n_overlap < 10000);
+    }
+
 /*! Not sure how best to test this because not sure what a valid support has to be...
 UP_TEST( composite_support )
     {
@@ -929,3 +1002,42 @@ UP_TEST( overlap_two_cubes_no_rot_sphere_sweep )
     UP_ASSERT(!err_count);
     UP_ASSERT(!result);
     }
+
+UP_TEST( contact_scale_cubes )
+    {
+    quat<Scalar> o;
+
+    // build a cube
+    vector< vec3<OverlapReal> > vlist;
+    vlist.push_back(vec3<OverlapReal>(-0.5,-0.5,-0.5));
+    vlist.push_back(vec3<OverlapReal>(0.5,-0.5,-0.5));
+    vlist.push_back(vec3<OverlapReal>(0.5,0.5,-0.5));
+    vlist.push_back(vec3<OverlapReal>(-0.5,0.5,-0.5));
+    vlist.push_back(vec3<OverlapReal>(-0.5,-0.5,0.5));
+    vlist.push_back(vec3<OverlapReal>(0.5,-0.5,0.5));
+    vlist.push_back(vec3<OverlapReal>(0.5,0.5,0.5));
+    vlist.push_back(vec3<OverlapReal>(-0.5,0.5,0.5));
+    PolyhedronVertices verts(vlist, 0, 0);
+
+    ShapeConvexPolyhedron a(o, verts);
+    ShapeConvexPolyhedron b(o, verts);
+
+    // face to face contact at a separation of 1
+    vec3<Scalar> r_ab(2,0,0);
+    MY_CHECK_CLOSE(contact_scale(r_ab,a,b,err_count), 0.5, tol_small);
+    MY_CHECK_CLOSE(contact_scale(-r_ab,b,a,err_count), 0.5, tol_small);
+    UP_ASSERT(!err_count);
+
+    // rotate b by 45 degrees about z, its edge touches the face of a at 0.5 + sqrt(2)/2
+    b.orientation = quat<Scalar>::fromAxisAngle(vec3<Scalar>(0,0,1), Scalar(M_PI/4));
+    MY_CHECK_CLOSE(contact_scale(r_ab,a,b,err_count), (0.5 + sqrt(2.0)/2.0)/2.0, tol_small);
+    UP_ASSERT(!err_count);
+
+    // in an arbitrary direction, the shapes overlap just inside the contact and are disjoint just outside
+    r_ab = vec3<Scalar>(0.3,-1.1,0.7);
+    Scalar s = contact_scale(r_ab,a,b,err_count);
+    UP_ASSERT(!err_count);
+    UP_ASSERT(test_overlap(r_ab*(s*Scalar(0.999)),a,b,err_count));
+    UP_ASSERT(!test_overlap(r_ab*(s*Scalar(1.001)),a,b,err_count));
+    UP_ASSERT(!err_count);
+    }
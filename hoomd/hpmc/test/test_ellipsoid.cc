@@ -887,3 +887,35 @@ UP_TEST( overlap_ellipsoid_rot2 )
     UP_ASSERT(test_overlap(r_ij,a,b,err_count));
     UP_ASSERT(test_overlap(-r_ij,b,a,err_count));
     }
+
+UP_TEST( contact_scale_ellipsoid )
+    {
+    quat<Scalar> o;
+
+    EllipsoidParams axes;
+    axes.x = 3;
+    axes.y = 1;
+    axes.z = 2;
+    axes.ignore = 0;
+    ShapeEllipsoid a(o, axes);
+    ShapeEllipsoid b(o, axes);
+
+    // contact along the principal axes
+    MY_CHECK_CLOSE(contact_scale(vec3<Scalar>(12,0,0),a,b,err_count), 0.5, tol_small);
+    MY_CHECK_CLOSE(contact_scale(vec3<Scalar>(0,4,0),a,b,err_count), 0.5, tol_small);
+    MY_CHECK_CLOSE(contact_scale(vec3<Scalar>(0,0,-8),a,b,err_count), 0.5, tol_small);
+    UP_ASSERT(!err_count);
+
+    // rotate b by 90 degrees about z, its short axis points along x
+    b.orientation = quat<Scalar>::fromAxisAngle(vec3<Scalar>(0,0,1), Scalar(M_PI/2));
+    MY_CHECK_CLOSE(contact_scale(vec3<Scalar>(8,0,0),a,b,err_count), 0.5, tol_small);
+    UP_ASSERT(!err_count);
+
+    // in an arbitrary direction, the shapes overlap just inside the contact and are disjoint just outside
+    vec3<Scalar> r_ab(1.3,-2.1,0.7);
+    Scalar s = contact_scale(r_ab,a,b,err_count);
+    UP_ASSERT(!err_count);
+    UP_ASSERT(test_overlap(r_ab*(s*Scalar(0.999)),a,b,err_count));
+    UP_ASSERT(!test_overlap(r_ab*(s*Scalar(1.001)),a,b,err_count));
+    UP_ASSERT(!err_count);
+    }
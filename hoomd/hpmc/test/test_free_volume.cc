@@ -0,0 +1,118 @@
+
+#include "hoomd/ExecutionConfiguration.h"
+#include "hoomd/BoxDim.h"
+#include "hoomd/HOOMDMath.h"
+#include "hoomd/SystemDefinition.h"
+
+#include "hoomd/test/upp11_config.h"
+
+HOOMD_UP_MAIN();
+
+#include "hoomd/hpmc/ComputeFreeVolume.h"
+#include "hoomd/hpmc/IntegratorHPMCMono.h"
+#include "hoomd/hpmc/ShapeSphere.h"
+
+#include <iostream>
+
+#include <pybind11/pybind11.h>
+#include <memory>
+
+using namespace hpmc;
+using namespace hpmc::detail;
+
+//! Exact free volume of a sphere of radius 1.0 for a test sphere of radius 0.5 in a box of length 4
+const Scalar exact_free_volume = Scalar(64.0) - Scalar(4.0/3.0*M_PI*1.5*1.5*1.5);
+
+//! Build a single sphere system and a free volume compute for spherical test particles
+std::shared_ptr< ComputeFreeVolume<ShapeSphere> > make_free_volume(std::shared_ptr<SystemDefinition> sysdef)
+    {
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+
+        {
+        ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::overwrite);
+        h_pos.data[0] = make_scalar4(0, 0, 0, __int_as_scalar(0));
+        }
+
+    std::shared_ptr< IntegratorHPMCMono<ShapeSphere> > mc(new IntegratorHPMCMono<ShapeSphere>(sysdef, 11));
+    SphereParams params;
+    params.ignore = 0;
+    params.isOriented = false;
+    params.radius = 1.0;
+    mc->setParam(0, params);
+    params.radius = 0.5;
+    mc->setParam(1, params);
+
+    std::shared_ptr<CellList> cl(new CellList(sysdef));
+    std::shared_ptr< ComputeFreeVolume<ShapeSphere> > free_volume(
+        new ComputeFreeVolume<ShapeSphere>(sysdef, mc, cl, 123, ""));
+    free_volume->setTestParticleType(1);
+    return free_volume;
+    }
+
+//! Average the free volume estimate over a number of time steps
+Scalar average_free_volume(std::shared_ptr< ComputeFreeVolume<ShapeSphere> > free_volume, unsigned int n_steps)
+    {
+    Scalar avg = 0;
+    for (unsigned int t = 0; t < n_steps; t++)
+        avg += free_volume->getLogValue("hpmc_free_volume", t);
+    return avg / Scalar(n_steps);
+    }
+
+//! Check that the quasi-random estimate agrees with the pseudo-random estimate and the exact free volume
+UP_TEST( free_volume_quasi_random )
+    {
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(1, BoxDim(4.0), 2, 0, 0, 0, 0, exec_conf));
+    std::shared_ptr< ComputeFreeVolume<ShapeSphere> > free_volume = make_free_volume(sysdef);
+    free_volume->setNumSamples(100000);
+
+    // the standard error of the pseudo-random average is about 0.1%
+    Scalar pseudo = average_free_volume(free_volume, 5);
+    UP_ASSERT_EQUAL(free_volume->getNumSamplesTaken(), 100000);
+
+    free_volume->setQuasiRandom(true);
+    UP_ASSERT(free_volume->getQuasiRandom());
+    Scalar quasi = average_free_volume(free_volume, 5);
+    UP_ASSERT_EQUAL(free_volume->getNumSamplesTaken(), 100000);
+
+    MY_CHECK_CLOSE(pseudo, exact_free_volume, 0.01);
+    MY_CHECK_CLOSE(quasi, exact_free_volume, 0.01);
+    MY_CHECK_CLOSE(quasi, pseudo, 0.01);
+    }
+
+//! Check that sampling stops early once the target relative error is reached, and that the error is met
+UP_TEST( free_volume_target_rel_error )
+    {
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(1, BoxDim(4.0), 2, 0, 0, 0, 0, exec_conf));
+    std::shared_ptr< ComputeFreeVolume<ShapeSphere> > free_volume = make_free_volume(sysdef);
+
+    unsigned int n_max = 1000000;
+    Scalar target = 0.01;
+    free_volume->setNumSamples(n_max);
+    free_volume->setTargetRelativeError(target);
+
+    UP_ASSERT_EXCEPTION(std::runtime_error, [&]{free_volume->setTargetRelativeError(-1.0);});
+
+    // the rms relative deviation from the exact free volume meets the target
+    Scalar sum_sq = 0;
+    unsigned int n_steps = 20;
+    for (unsigned int t = 0; t < n_steps; t++)
+        {
+        Scalar V = free_volume->getLogValue("hpmc_free_volume", t);
+        unsigned int n_taken = free_volume->getNumSamplesTaken();
+
+        // the excluded volume fraction p is about 0.22, the target needs p/((1-p)*target^2) samples
+        UP_ASSERT(n_taken < n_max / 10);
+        UP_ASSERT(n_taken >= 2800);
+
+        Scalar rel = (V - exact_free_volume) / exact_free_volume;
+        sum_sq += rel*rel;
+        }
+    UP_ASSERT(sqrt(sum_sq / Scalar(n_steps)) <= target);
+
+    // without a target, all samples are taken
+    free_volume->setTargetRelativeError(0.0);
+    free_volume->getLogValue("hpmc_free_volume", n_steps);
+    UP_ASSERT_EQUAL(free_volume->getNumSamplesTaken(), n_max);
+    }
@@ -0,0 +1,144 @@
+
+#include "hoomd/ExecutionConfiguration.h"
+#include "hoomd/BoxDim.h"
+#include "hoomd/HOOMDMath.h"
+#include "hoomd/SystemDefinition.h"
+
+#include "hoomd/test/upp11_config.h"
+
+HOOMD_UP_MAIN();
+
+#include "hoomd/hpmc/IntegratorHPMCMono.h"
+#include "hoomd/hpmc/ShapeSphere.h"
+
+#include <iostream>
+
+#include <pybind11/pybind11.h>
+#include <memory>
+
+using namespace hpmc;
+using namespace hpmc::detail;
+
+//! Square well patch interaction
+class SquareWell : public PatchEnergy
+    {
+    public:
+        virtual Scalar getRCut()
+            {
+            return Scalar(1.5);
+            }
+
+        virtual float energy(const vec3<float>& r_ij,
+            unsigned int type_i,
+            const quat<float>& q_i,
+            float d_i,
+            float charge_i,
+            unsigned int type_j,
+            const quat<float>& q_j,
+            float d_j,
+            float charge_j)
+            {
+            return dot(r_ij, r_ij) < 1.5f*1.5f ? -0.37f : 0.0f;
+            }
+    };
+
+//! Build a system of hard spheres on a simple cubic lattice with a square well patch interaction
+std::shared_ptr< IntegratorHPMCMono<ShapeSphere> > make_patch_system(std::shared_ptr<SystemDefinition> sysdef)
+    {
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+
+        {
+        ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::overwrite);
+        unsigned int n = 6;
+        for (unsigned int i = 0; i < pdata->getN(); i++)
+            {
+            Scalar x = Scalar(i % n) * Scalar(1.1) - Scalar(3.0);
+            Scalar y = Scalar((i / n) % n) * Scalar(1.1) - Scalar(3.0);
+            Scalar z = Scalar(i / (n*n)) * Scalar(1.1) - Scalar(3.0);
+            h_pos.data[i] = make_scalar4(x, y, z, __int_as_scalar(0));
+            }
+        }
+
+    std::shared_ptr< IntegratorHPMCMono<ShapeSphere> > mc(new IntegratorHPMCMono<ShapeSphere>(sysdef, 2345));
+    SphereParams params;
+    params.radius = 0.5;
+    params.ignore = 0;
+    params.isOriented = false;
+    mc->setParam(0, params);
+    mc->setD("A", 0.1);
+    mc->setPatchEnergy(std::shared_ptr<PatchEnergy>(new SquareWell()));
+    return mc;
+    }
+
+//! Check that the incrementally tracked total patch energy agrees with a full evaluation over many sweeps
+UP_TEST( patch_energy_tracking )
+    {
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    BoxDim box(12.0);
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(216, box, 1, 0, 0, 0, 0, exec_conf));
+    std::shared_ptr< IntegratorHPMCMono<ShapeSphere> > mc = make_patch_system(sysdef);
+
+    // only resynchronize at the end, so that the comparisons check the incremental updates
+    unsigned int n_steps = 200;
+    mc->setPatchEnergyResyncPeriod(n_steps);
+    mc->prepRun(0);
+
+    double initial_energy = mc->getTotalPatchEnergy(0);
+    UP_ASSERT(initial_energy < 0.0);
+
+    bool changed = false;
+    for (unsigned int t = 1; t < n_steps; t++)
+        {
+        mc->update(t);
+        double total = mc->getTotalPatchEnergy(t);
+        changed = changed || total != initial_energy;
+        if (t % 20 == 0)
+            MY_CHECK_CLOSE(total, mc->computePatchEnergy(t), 1e-3);
+        }
+
+    // second neighbor pairs have moved in and out of the well
+    UP_ASSERT(changed);
+    MY_CHECK_CLOSE(mc->getTotalPatchEnergy(n_steps), mc->computePatchEnergy(n_steps), 1e-3);
+    }
+
+//! Check that modifications of the particles outside of the integrator are detected
+UP_TEST( patch_energy_external_change )
+    {
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    BoxDim box(12.0);
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(216, box, 1, 0, 0, 0, 0, exec_conf));
+    std::shared_ptr< IntegratorHPMCMono<ShapeSphere> > mc = make_patch_system(sysdef);
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+
+    mc->prepRun(0);
+    for (unsigned int t = 0; t < 10; t++)
+        mc->update(t);
+    double energy = mc->getTotalPatchEnergy(10);
+    MY_CHECK_CLOSE(energy, mc->computePatchEnergy(10), 1e-3);
+
+    // reading the particles keeps the cached total
+    uint64_t version = pdata->getPositions().getVersion();
+        {
+        ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::read);
+        }
+    UP_ASSERT_EQUAL(pdata->getPositions().getVersion(), version);
+
+    // move a corner particle far away from all others, as a custom updater would
+        {
+        ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::readwrite);
+        for (unsigned int i = 0; i < pdata->getN(); i++)
+            {
+            if (h_pos.data[i].x < Scalar(-2.5) && h_pos.data[i].y < Scalar(-2.5) && h_pos.data[i].z < Scalar(-2.5))
+                {
+                h_pos.data[i].x = Scalar(5.5);
+                h_pos.data[i].y = Scalar(5.5);
+                h_pos.data[i].z = Scalar(5.5);
+                break;
+                }
+            }
+        }
+
+    double moved_energy = mc->computePatchEnergy(10);
+    UP_ASSERT(moved_energy > energy);
+    MY_CHECK_CLOSE(mc->getTotalPatchEnergy(10), moved_energy, 1e-3);
+    }
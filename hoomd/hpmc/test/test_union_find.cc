@@ -0,0 +1,116 @@
+#include "hoomd/test/upp11_config.h"
+
+HOOMD_UP_MAIN();
+
+#include "hoomd/hpmc/UpdaterClusters.h"
+
+#include <iostream>
+
+#include <pybind11/pybind11.h>
+
+#ifdef ENABLE_TBB
+#include <tbb/parallel_for.h>
+#endif
+
+#include "hoomd/RandomNumbers.h"
+
+using namespace hpmc;
+using namespace hpmc::detail;
+
+UP_TEST( basic )
+    {
+    UnionFind uf;
+    uf.resize(6);
+
+    uf.unite(4, 1);
+    uf.unite(5, 3);
+    uf.unite(3, 4);
+
+    UP_ASSERT_EQUAL(uf.find(1), uf.find(5));
+    UP_ASSERT(uf.find(0) != uf.find(1));
+    UP_ASSERT(uf.find(2) != uf.find(1));
+
+    // sets are ordered by their smallest element
+    std::vector<unsigned int> members, offsets;
+    uf.connectedComponents(members, offsets);
+    UP_ASSERT_EQUAL(offsets.size(), 4);
+    UP_ASSERT_EQUAL(offsets[0], 0);
+    UP_ASSERT_EQUAL(offsets[1], 1);
+    UP_ASSERT_EQUAL(offsets[2], 5);
+    UP_ASSERT_EQUAL(offsets[3], 6);
+
+    unsigned int expected[] = {0, 1, 3, 4, 5, 2};
+    for (unsigned int i = 0; i < 6; i++)
+        UP_ASSERT_EQUAL(members[i], expected[i]);
+
+    // resize resets all sets
+    uf.resize(3);
+    uf.connectedComponents(members, offsets);
+    UP_ASSERT_EQUAL(offsets.size(), 4);
+    }
+
+UP_TEST( chains )
+    {
+    // random bonds between neighbors on a ring of particles, merged concurrently
+    const unsigned int N = 10000;
+    hoomd::RandomGenerator rng(1, 2);
+
+    std::vector<unsigned int> bonded(N);
+    for (unsigned int i = 0; i < N; i++)
+        bonded[i] = hoomd::UniformIntDistribution(3)(rng) != 0;
+
+    UnionFind uf;
+    uf.resize(N);
+
+    #ifdef ENABLE_TBB
+    tbb::parallel_for((unsigned int)0, N, [&](unsigned int i)
+    #else
+    for (unsigned int i = 0; i < N; i++)
+    #endif
+        {
+        if (bonded[i])
+            uf.unite(i, (i+1) % N);
+        }
+    #ifdef ENABLE_TBB
+        );
+    #endif
+
+    std::vector<unsigned int> members, offsets;
+    uf.connectedComponents(members, offsets);
+
+    // every unbonded particle ends a chain, the last chain wraps around to the first one
+    unsigned int n_chains = 0;
+    for (unsigned int i = 0; i < N; i++)
+        n_chains += !bonded[i];
+    UP_ASSERT_EQUAL(offsets.size()-1, n_chains);
+    UP_ASSERT_EQUAL(offsets.back(), N);
+
+    for (unsigned int c = 0; c < n_chains; c++)
+        {
+        unsigned int root = uf.find(members[offsets[c]]);
+        for (unsigned int k = offsets[c]; k < offsets[c+1]; k++)
+            {
+            UP_ASSERT_EQUAL(uf.find(members[k]), root);
+            if (k > offsets[c])
+                UP_ASSERT(members[k] > members[k-1]);
+            }
+        }
+    }
+
+UP_TEST( pair_energies )
+    {
+    std::vector<PairEnergy> energies;
+    energies.push_back(PairEnergy(1, 2, 1.0f));
+    energies.push_back(PairEnergy(0, 5, 2.0f));
+    energies.push_back(PairEnergy(1, 2, 0.5f));
+    energies.push_back(PairEnergy(2, 1, 4.0f));
+
+    sumPairEnergies(energies);
+    UP_ASSERT_EQUAL(energies.size(), 3);
+    UP_ASSERT(energies[0].samePair(PairEnergy(0, 5, 0.0f)));
+    UP_ASSERT_EQUAL(energies[0].U, 2.0f);
+    UP_ASSERT(energies[1].samePair(PairEnergy(1, 2, 0.0f)));
+    UP_ASSERT_EQUAL(energies[1].U, 1.5f);
+    UP_ASSERT(energies[2].samePair(PairEnergy(2, 1, 0.0f)));
+    UP_ASSERT_EQUAL(energies[2].U, 4.0f);
+    }
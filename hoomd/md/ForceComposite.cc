@@ -769,7 +769,7 @@ void ForceComposite::computeForces(unsigned int timestep)
 
     // access particle data
     ArrayHandle<unsigned int> h_body(m_pdata->getBodies(), access_location::host, access_mode::read);
-    ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
+    TagIndexHandle h_rtag(*m_pdata, access_mode::read);
     ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
     ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(), access_location::host, access_mode::read);
     ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
@@ -816,7 +816,7 @@ void ForceComposite::computeForces(unsigned int timestep)
         unsigned int central_tag = h_body.data[first_idx];
 
         assert(central_tag <= m_pdata->getMaximumTag());
-        unsigned int central_idx = h_rtag.data[central_tag];
+        unsigned int central_idx = h_rtag[central_tag];
 
         if (central_idx >= nptl_local) continue;
 
@@ -940,7 +940,7 @@ void ForceComposite::updateCompositeParticles(unsigned int timestep)
     */
 
     ArrayHandle<unsigned int> h_body(m_pdata->getBodies(), access_location::host, access_mode::read);
-    ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
+    TagIndexHandle h_rtag(*m_pdata, access_mode::read);
     ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
 
     // access body positions and orientations
@@ -963,7 +963,7 @@ void ForceComposite::updateCompositeParticles(unsigned int timestep)
 
         // body tag equals tag for central ptl
         assert(central_tag <= m_pdata->getMaximumTag());
-        unsigned int central_idx = h_rtag.data[central_tag];
+        unsigned int central_idx = h_rtag[central_tag];
 
         if (central_idx == NOT_LOCAL && iptl >= m_pdata->getN())
             continue;
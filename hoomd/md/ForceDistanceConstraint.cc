@@ -55,15 +55,15 @@ Scalar ForceDistanceConstraint::getNDOFRemoved(std::shared_ptr<ParticleGroup> qu
     unsigned int half_dof_removed = 0;
 
     unsigned int n_constraint = m_cdata->getN()+m_cdata->getNGhosts();
-    ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
+    TagIndexHandle h_rtag(*m_pdata, access_mode::read);
     unsigned int n_particles = m_pdata->getN();
 
     for (unsigned int i = 0; i < n_constraint; i++)
         {
         auto constraint = m_cdata->getMembersByIndex(i);
 
-        unsigned int idx_a = h_rtag.data[constraint.tag[0]];
-        unsigned int idx_b = h_rtag.data[constraint.tag[1]];
+        unsigned int idx_a = h_rtag[constraint.tag[0]];
+        unsigned int idx_b = h_rtag[constraint.tag[1]];
 
         if (idx_a < n_particles && query->isMember(idx_a))
             half_dof_removed++;
@@ -140,7 +140,7 @@ void ForceDistanceConstraint::fillMatrixVector(unsigned int timestep)
     // access particle data
     ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
     ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::read);
-    ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
+    TagIndexHandle h_rtag(*m_pdata, access_mode::read);
     ArrayHandle<Scalar4> h_netforce(m_pdata->getNetForce(), access_location::host, access_mode::read);
 
     // access matrix elements
@@ -162,8 +162,8 @@ void ForceDistanceConstraint::fillMatrixVector(unsigned int timestep)
 
         // transform a and b into indices into the particle data arrays
         // (MEM TRANSFER: 4 integers)
-        unsigned int idx_a = h_rtag.data[constraint.tag[0]];
-        unsigned int idx_b = h_rtag.data[constraint.tag[1]];
+        unsigned int idx_a = h_rtag[constraint.tag[0]];
+        unsigned int idx_b = h_rtag[constraint.tag[1]];
 
         if (idx_a >= max_local || idx_b >= max_local)
             {
@@ -198,8 +198,8 @@ void ForceDistanceConstraint::fillMatrixVector(unsigned int timestep)
 
             // transform a and b into indices into the particle data arrays
             // (MEM TRANSFER: 4 integers)
-            unsigned int idx_m_a = h_rtag.data[constraint_m.tag[0]];
-            unsigned int idx_m_b = h_rtag.data[constraint_m.tag[1]];
+            unsigned int idx_m_a = h_rtag[constraint_m.tag[0]];
+            unsigned int idx_m_b = h_rtag[constraint_m.tag[1]];
             assert(idx_m_a <= m_pdata->getN()+m_pdata->getNGhosts());
             assert(idx_m_b <= m_pdata->getN()+m_pdata->getNGhosts());
 
@@ -282,9 +282,9 @@ void ForceDistanceConstraint::checkConstraints(unsigned int timestep)
         Scalar d = m_cdata->getValueByIndex(n-1);
 
         ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
-        ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
-        Scalar4 pos_a = h_pos.data[h_rtag.data[tag_a]];
-        Scalar4 pos_b = h_pos.data[h_rtag.data[tag_b]];
+        TagIndexHandle h_rtag(*m_pdata, access_mode::read);
+        Scalar4 pos_a = h_pos.data[h_rtag[tag_a]];
+        Scalar4 pos_b = h_pos.data[h_rtag[tag_b]];
 
         vec3<Scalar> rn = m_pdata->getBox().minImage(vec3<Scalar>(pos_a)-vec3<Scalar>(pos_b));
         m_exec_conf->msg->warning() << "Constraint " << h_group_tag.data[n-1] << " between particles "
@@ -411,7 +411,7 @@ void ForceDistanceConstraint::computeConstraintForces(unsigned int timestep)
 
     // access particle data arrays
     ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
-    ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
+    TagIndexHandle h_rtag(*m_pdata, access_mode::read);
 
     // access force and virial arrays
     ArrayHandle<Scalar4> h_force(m_force, access_location::host, access_mode::overwrite);
@@ -436,8 +436,8 @@ void ForceDistanceConstraint::computeConstraintForces(unsigned int timestep)
         assert(constraint.tag[1] <= m_pdata->getMaximumTag());
 
         // transform a and b into indices into the particle data arrays
-        unsigned int idx_a = h_rtag.data[constraint.tag[0]];
-        unsigned int idx_b = h_rtag.data[constraint.tag[1]];
+        unsigned int idx_a = h_rtag[constraint.tag[0]];
+        unsigned int idx_b = h_rtag[constraint.tag[1]];
         assert(idx_a < m_pdata->getN()+m_pdata->getNGhosts());
         assert(idx_b < m_pdata->getN()+m_pdata->getNGhosts());
 
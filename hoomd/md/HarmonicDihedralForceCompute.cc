@@ -152,7 +152,10 @@ void HarmonicDihedralForceCompute::computeForces(unsigned int timestep)
     assert(m_pdata);
     // access the particle data arrays
     ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
-    ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
+
+    // access the dihedrals sorted by particle index, with members already resolved
+    ArrayHandle<DihedralData::members_t> h_dihedrals(m_dihedral_data->getIndexTable(), access_location::host, access_mode::read);
+    ArrayHandle<typeval_t> h_typeval(m_dihedral_data->getIndexTableTypeVal(), access_location::host, access_mode::read);
 
     ArrayHandle<Scalar4> h_force(m_force,access_location::host, access_mode::overwrite);
     ArrayHandle<Scalar> h_virial(m_virial,access_location::host, access_mode::overwrite);
@@ -165,7 +168,7 @@ void HarmonicDihedralForceCompute::computeForces(unsigned int timestep)
     assert(h_force.data);
     assert(h_virial.data);
     assert(h_pos.data);
-    assert(h_rtag.data);
+    assert(h_dihedrals.data);
 
     size_t virial_pitch = m_virial.getPitch();
 
@@ -176,23 +179,19 @@ void HarmonicDihedralForceCompute::computeForces(unsigned int timestep)
     const unsigned int size = (unsigned int)m_dihedral_data->getN();
     for (unsigned int i = 0; i < size; i++)
         {
-        // lookup the tag of each of the particles participating in the dihedral
-        const ImproperData::members_t& dihedral = m_dihedral_data->getMembersByIndex(i);
-        assert(dihedral.tag[0] <= m_pdata->getMaximumTag());
-        assert(dihedral.tag[1] <= m_pdata->getMaximumTag());
-        assert(dihedral.tag[2] <= m_pdata->getMaximumTag());
-        assert(dihedral.tag[3] <= m_pdata->getMaximumTag());
-
-        // transform a, b, and c into indices into the particle data arrays
-        // MEM TRANSFER: 6 ints
-        unsigned int idx_a = h_rtag.data[dihedral.tag[0]];
-        unsigned int idx_b = h_rtag.data[dihedral.tag[1]];
-        unsigned int idx_c = h_rtag.data[dihedral.tag[2]];
-        unsigned int idx_d = h_rtag.data[dihedral.tag[3]];
+        // lookup the index of each of the particles participating in the dihedral
+        // MEM TRANSFER: 4 ints
+        const DihedralData::members_t& dihedral_idx = h_dihedrals.data[i];
+        unsigned int idx_a = dihedral_idx.idx[0];
+        unsigned int idx_b = dihedral_idx.idx[1];
+        unsigned int idx_c = dihedral_idx.idx[2];
+        unsigned int idx_d = dihedral_idx.idx[3];
 
         // throw an error if this angle is incomplete
         if (idx_a == NOT_LOCAL|| idx_b == NOT_LOCAL || idx_c == NOT_LOCAL || idx_d == NOT_LOCAL)
             {
+            ArrayHandle<unsigned int> h_group(m_dihedral_data->getIndexTableGroups(), access_location::host, access_mode::read);
+            DihedralData::members_t dihedral = m_dihedral_data->getMembersByIndex(h_group.data[i]);
             this->m_exec_conf->msg->error() << "dihedral.harmonic: dihedral " <<
                 dihedral.tag[0] << " " << dihedral.tag[1] << " " << dihedral.tag[2] << " " << dihedral.tag[3]
                 << " incomplete." << endl << endl;
@@ -258,7 +257,7 @@ void HarmonicDihedralForceCompute::computeForces(unsigned int timestep)
         if (c_abcd > 1.0) c_abcd = 1.0;
         if (c_abcd < -1.0) c_abcd = -1.0;
 
-        unsigned int dihedral_type = m_dihedral_data->getTypeByIndex(i);
+        unsigned int dihedral_type = h_typeval.data[i].type;
         int multi = (int)m_multi[dihedral_type];
         Scalar p = Scalar(1.0);
         Scalar dfab = Scalar(0.0);
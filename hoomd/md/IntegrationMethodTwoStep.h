@@ -92,6 +92,13 @@ class Communicator;
     -# each integration method only applies these operations to the particles contained within its group (exceptions
        are allowed when box rescaling is needed)
 
+    <b>Fused steps</b>
+
+    When nothing accesses the particle data between two time steps, IntegratorTwoStep may defer integrateStepTwo()
+    of one step and call integrateFusedStep() at the start of the next. Methods that implement it in a single pass
+    read and write each particle once per time step instead of twice. The result must be identical to calling the two
+    steps in turn.
+
     <b>Design items still left to do:</b>
 
     Interaction with logger: perhaps the integrator should forward log value queries on to the integration method?
@@ -120,6 +127,24 @@ class PYBIND11_EXPORT IntegrationMethodTwoStep
             {
             }
 
+        //! Performs the second step of the integration of the previous time step and the first step of this one
+        /*! \param timestep Current time step
+
+            The base class calls integrateStepTwo(timestep-1) and integrateStepOne(timestep) in turn. Methods that
+            return true from hasFusedStep() override this to update each particle in a single pass.
+        */
+        virtual void integrateFusedStep(unsigned int timestep)
+            {
+            integrateStepTwo(timestep-1);
+            integrateStepOne(timestep);
+            }
+
+        //! Returns true if the method implements integrateFusedStep() in a single pass over the particles
+        virtual bool hasFusedStep()
+            {
+            return false;
+            }
+
         //! Sets the profiler for the integration method to use
         void setProfiler(std::shared_ptr<Profiler> prof);
 
@@ -16,7 +16,8 @@ using namespace std;
 
 IntegratorTwoStep::IntegratorTwoStep(std::shared_ptr<SystemDefinition> sysdef, Scalar deltaT)
     : Integrator(sysdef, deltaT), m_prepared(false), m_gave_warning(false),
-    m_aniso_mode(Automatic)
+    m_aniso_mode(Automatic), m_fuse_steps(false), m_defer_step_end(false), m_step_two_pending(false),
+    m_pending_timestep(0)
     {
     m_exec_conf->msg->notice(5) << "Constructing IntegratorTwoStep" << endl;
     }
@@ -100,13 +101,29 @@ void IntegratorTwoStep::update(unsigned int timestep)
     if (m_prof)
         m_prof->push("Integrate");
 
-    // perform the first step of the integration on all groups
-    for (auto& method : m_methods)
+    // complete the second step of the last time step together with the first step of this one
+    if (m_step_two_pending && m_pending_timestep + 1 != timestep)
+        finishStep();
+
+    if (m_step_two_pending)
         {
-        // deltaT should probably be passed as an argument, but that would require modifying many
-        // files. Work around this by calling setDeltaT every timestep.
-        method->setDeltaT(m_deltaT);
-        method->integrateStepOne(timestep);
+        for (auto& method : m_methods)
+            {
+            method->setDeltaT(m_deltaT);
+            method->integrateFusedStep(timestep);
+            }
+        m_step_two_pending = false;
+        }
+    else
+        {
+        // perform the first step of the integration on all groups
+        for (auto& method : m_methods)
+            {
+            // deltaT should probably be passed as an argument, but that would require modifying many
+            // files. Work around this by calling setDeltaT every timestep.
+            method->setDeltaT(m_deltaT);
+            method->integrateStepOne(timestep);
+            }
         }
 
     if (m_prof)
@@ -145,9 +162,17 @@ void IntegratorTwoStep::update(unsigned int timestep)
     if (m_prof)
         m_prof->push("Integrate");
 
-    // perform the second step of the integration on all groups
-    for (auto& method : m_methods)
-        method->integrateStepTwo(timestep);
+    // perform the second step of the integration on all groups, or leave it to the next time step
+    if (canDeferStepTwo())
+        {
+        m_step_two_pending = true;
+        m_pending_timestep = timestep;
+        }
+    else
+        {
+        for (auto& method : m_methods)
+            method->integrateStepTwo(timestep);
+        }
 
     /* NOTE: For composite particles, it is assumed that positions and orientations are not updated
        in the second step.
@@ -162,6 +187,44 @@ void IntegratorTwoStep::update(unsigned int timestep)
         m_prof->pop();
     }
 
+/*! \post The velocities of all particles are at the full step
+*/
+void IntegratorTwoStep::finishStep()
+    {
+    if (!m_step_two_pending)
+        return;
+
+    if (m_prof)
+        m_prof->push("Integrate");
+
+    for (auto& method : m_methods)
+        method->integrateStepTwo(m_pending_timestep);
+    m_step_two_pending = false;
+
+    if (m_prof)
+        m_prof->pop();
+    }
+
+/*! The second step may be deferred when fused steps are enabled, System allows it, the system is integrated on
+    the CPU, and all methods implement a fused step.
+*/
+bool IntegratorTwoStep::canDeferStepTwo()
+    {
+    if (!m_fuse_steps || !m_defer_step_end || m_methods.size() == 0)
+        return false;
+
+    if (m_exec_conf->isCUDAEnabled())
+        return false;
+
+    for (auto& method : m_methods)
+        {
+        if (!method->hasFusedStep())
+            return false;
+        }
+
+    return true;
+    }
+
 /*! \param deltaT new deltaT to set
     \post \a deltaT is also set on all contained integration methods
 */
@@ -383,6 +446,8 @@ const std::string IntegratorTwoStep::getAnisotropicMode()
 */
 void IntegratorTwoStep::prepRun(unsigned int timestep)
     {
+    finishStep();
+
     bool aniso = false;
 
     // set (an-)isotropic integration mode
@@ -505,6 +570,7 @@ void export_IntegratorTwoStep(py::module& m)
         .def_property("aniso",
                       &IntegratorTwoStep::getAnisotropicMode,
                       &IntegratorTwoStep::setAnisotropicMode)
+        .def_property("fuse_steps", &IntegratorTwoStep::getFuseSteps, &IntegratorTwoStep::setFuseSteps)
 
         ;
     }
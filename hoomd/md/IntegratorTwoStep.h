@@ -31,6 +31,12 @@
     one and two, and which can use the updated particle positions and velocities to update any slaved degrees
     of freedom (rigid bodies).
 
+    When fused steps are enabled and System reports that nothing accesses the particle data before the next step,
+    update() skips the second step and leaves the velocities at the half step. The next call to update() then
+    completes it together with the first step of the new time step in IntegrationMethodTwoStep::integrateFusedStep().
+    This is done only on the CPU and when every method implements the fused step. finishStep() completes a deferred
+    step early.
+
     \ingroup updaters
 */
 class PYBIND11_EXPORT IntegratorTwoStep : public Integrator
@@ -62,6 +68,27 @@ class PYBIND11_EXPORT IntegratorTwoStep : public Integrator
         /// Take one timestep forward
         virtual void update(unsigned int timestep);
 
+        /// Allow update() to leave the end of the step to the next call to update()
+        virtual void setDeferStepEnd(bool defer)
+            {
+            m_defer_step_end = defer;
+            }
+
+        /// Complete a step left unfinished by the last call to update()
+        virtual void finishStep();
+
+        /// Set whether to fuse the second step with the first step of the next time step when possible
+        void setFuseSteps(bool fuse_steps)
+            {
+            m_fuse_steps = fuse_steps;
+            }
+
+        /// Get whether to fuse the second step with the first step of the next time step when possible
+        bool getFuseSteps()
+            {
+            return m_fuse_steps;
+            }
+
         /// Change the timestep
         virtual void setDeltaT(Scalar deltaT);
 
@@ -121,12 +148,20 @@ class PYBIND11_EXPORT IntegratorTwoStep : public Integrator
         /// Helper method to test if all added methods have valid restart information
         bool isValidRestart();
 
+        /// Helper method to test if the second step may be deferred to the next time step
+        bool canDeferStepTwo();
+
         std::vector< std::shared_ptr<IntegrationMethodTwoStep> > m_methods;   //!< List of all the integration methods
 
         bool m_prepared;              //!< True if preprun has been called
         bool m_gave_warning;          //!< True if a warning has been given about no methods added
         AnisotropicMode m_aniso_mode; //!< Anisotropic mode for this integrator
 
+        bool m_fuse_steps;            //!< True if the second step may be fused with the first step of the next one
+        bool m_defer_step_end;        //!< True if nothing accesses the particle data before the next time step
+        bool m_step_two_pending;      //!< True if the second step of the last time step has not been performed
+        unsigned int m_pending_timestep; //!< Time step of the pending second step
+
         std::vector< std::shared_ptr<ForceComposite> > m_composite_forces; //!< A list of active composite forces
     };
 
@@ -241,7 +241,7 @@ void MolecularForceCompute::initMolecules()
 
     ArrayHandle<unsigned int> h_molecule_tag(m_molecule_tag, access_location::host, access_mode::read);
     ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
-    ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
+    TagIndexHandle h_rtag(*m_pdata, access_mode::read);
 
     std::set<unsigned int> local_molecule_tags;
 
@@ -284,7 +284,7 @@ void MolecularForceCompute::initMolecules()
         if (mol_tag == NO_MOLECULE) continue;
 
         unsigned int lowest_tag = lowest_tag_by_molecule[mol_tag];
-        unsigned int lowest_idx = h_rtag.data[lowest_tag];
+        unsigned int lowest_idx = h_rtag[lowest_tag];
         assert(lowest_idx < m_pdata->getN() + m_pdata->getNGhosts());
 
         local_molecules_sorted[lowest_idx].insert(tag);
@@ -353,7 +353,7 @@ void MolecularForceCompute::initMolecules()
         for (std::set<unsigned int>::iterator it_tag = it_mol->second.begin(); it_tag != it_mol->second.end(); ++it_tag)
             {
             unsigned int n = h_molecule_length.data[i_mol]++;
-            unsigned int ptl_idx = h_rtag.data[*it_tag];
+            unsigned int ptl_idx = h_rtag[*it_tag];
             assert(ptl_idx < m_pdata->getN() + m_pdata->getNGhosts());
             h_molecule_list.data[m_molecule_indexer(n, i_mol)] = ptl_idx;
             h_molecule_idx.data[ptl_idx] = i_mol;
@@ -305,11 +305,11 @@ void MuellerPlatheFlow::search_min_max_velocity(void)
 void MuellerPlatheFlow::update_min_max_velocity(void)
     {
     if(m_prof) m_prof->push("MuellerPlatheFlow::update");
-    ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
+    TagIndexHandle h_rtag(*m_pdata, access_mode::read);
     const unsigned int min_tag = __scalar_as_int(m_last_min_vel.z);
-    const unsigned int min_idx = h_rtag.data[min_tag];
+    const unsigned int min_idx = h_rtag[min_tag];
     const unsigned int max_tag = __scalar_as_int(m_last_max_vel.z);
-    const unsigned int max_idx = h_rtag.data[max_tag];
+    const unsigned int max_idx = h_rtag[max_tag];
     const unsigned int Ntotal = m_pdata->getN()+m_pdata->getNGhosts();
     //Is my particle local on the processor?
     if( min_idx < Ntotal || max_idx < Ntotal)
@@ -163,11 +163,11 @@ NeighborList::NeighborList(std::shared_ptr<SystemDefinition> sysdef, Scalar _r_c
     // allocate initial memory allowing 4 exclusions per particle (will grow to match specified exclusions)
 
     // note: this breaks O(N/P) memory scaling
-    GlobalVector<unsigned int> n_ex_tag(m_pdata->getRTags().size(), m_exec_conf);
+    GlobalVector<unsigned int> n_ex_tag(m_pdata->getNumTags(), m_exec_conf);
     m_n_ex_tag.swap(n_ex_tag);
     TAG_ALLOCATION(m_n_ex_tag);
 
-    GlobalArray<unsigned int> ex_list_tag(m_pdata->getRTags().size(), 1, m_exec_conf);
+    GlobalArray<unsigned int> ex_list_tag(m_pdata->getNumTags(), 1, m_exec_conf);
     m_ex_list_tag.swap(ex_list_tag);
     TAG_ALLOCATION(m_ex_list_tag);
 
@@ -626,7 +626,7 @@ void NeighborList::clearExclusions()
     // reallocate list of exclusions per tag if necessary
     if (m_need_reallocate_exlist)
         {
-        m_n_ex_tag.resize(m_pdata->getRTags().size());
+        m_n_ex_tag.resize(m_pdata->getNumTags());
 
         // slave the width of the exclusion list to the capacity of the number of exclusions array
         // in order to amortize reallocation costs
@@ -656,7 +656,7 @@ unsigned int NeighborList::getNumExclusions(unsigned int size)
     {
     ArrayHandle<unsigned int> h_n_ex_tag(m_n_ex_tag, access_location::host, access_mode::read);
     unsigned int count = 0;
-    unsigned int ntags = (unsigned int)m_pdata->getRTags().size();
+    unsigned int ntags = m_pdata->getNumTags();
     for (unsigned int tag = 0; tag <= ntags; tag++)
         {
         if (! m_pdata->isTagActive(tag))
@@ -752,7 +752,7 @@ void NeighborList::countExclusions()
     for (unsigned int c=0; c <= MAX_COUNT_EXCLUDED+1; ++c)
         excluded_count[c] = 0;
 
-    unsigned int max_tag = (unsigned int)m_pdata->getRTags().size();
+    unsigned int max_tag = m_pdata->getNumTags();
     for (unsigned int i = 0; i < max_tag; i++)
         {
         num_excluded = h_n_ex_tag.data[i];
@@ -999,7 +999,7 @@ bool NeighborList::isExcluded(unsigned int tag1, unsigned int tag2)
 void NeighborList::addOneThreeExclusionsFromTopology()
     {
     std::shared_ptr<BondData> bond_data = m_sysdef->getBondData();
-    const unsigned int myNAtoms = (unsigned int)m_pdata->getRTags().size();
+    const unsigned int myNAtoms = m_pdata->getNumTags();
     const unsigned int MAXNBONDS = 7+1; //! assumed maximum number of bonds per atom plus one entry for the number of bonds.
     const unsigned int nBonds = bond_data->getNGlobal();
 
@@ -1078,7 +1078,7 @@ void NeighborList::addOneThreeExclusionsFromTopology()
 void NeighborList::addOneFourExclusionsFromTopology()
     {
     std::shared_ptr<BondData> bond_data = m_sysdef->getBondData();
-    const unsigned int myNAtoms = (unsigned int)m_pdata->getRTags().size();
+    const unsigned int myNAtoms = m_pdata->getNumTags();
     const unsigned int MAXNBONDS = 7+1; //! assumed maximum number of bonds per atom plus one entry for the number of bonds.
     const unsigned int nBonds = bond_data->getNGlobal();
 
@@ -1399,7 +1399,7 @@ void NeighborList::updateExListIdx()
 
     // access data
     ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
-    ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
+    TagIndexHandle h_rtag(*m_pdata, access_mode::read);
 
     ArrayHandle<unsigned int> h_n_ex_tag(m_n_ex_tag, access_location::host, access_mode::read);
     ArrayHandle<unsigned int> h_ex_list_tag(m_ex_list_tag, access_location::host, access_mode::read);
@@ -1420,7 +1420,7 @@ void NeighborList::updateExListIdx()
         for (unsigned int offset = 0; offset < n; offset++)
             {
             unsigned int ex_tag = h_ex_list_tag.data[m_ex_list_indexer_tag(tag,offset)];
-            unsigned int ex_idx = h_rtag.data[ex_tag];
+            unsigned int ex_idx = h_rtag[ex_tag];
 
             // store excluded particle idx
             h_ex_list_idx.data[m_ex_list_indexer(idx, offset)] = ex_idx;
@@ -1578,7 +1578,7 @@ void NeighborList::growExclusionList()
     {
     unsigned int new_height = m_ex_list_indexer.getH() + 1;
 
-    m_ex_list_tag.resize(m_pdata->getRTags().size(), new_height);
+    m_ex_list_tag.resize(m_pdata->getNumTags(), new_height);
     m_ex_list_idx.resize(m_pdata->getMaxN(), new_height);
 
     // update the indexers
@@ -195,7 +195,6 @@ void PotentialBond< evaluator >::computeForces(unsigned int timestep)
 
     // access the particle data arrays
     ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
-    ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
     ArrayHandle<Scalar> h_diameter(m_pdata->getDiameters(), access_location::host, access_mode::read);
     ArrayHandle<Scalar> h_charge(m_pdata->getCharges(), access_location::host, access_mode::read);
 
@@ -228,8 +227,9 @@ void PotentialBond< evaluator >::computeForces(unsigned int timestep)
     for (unsigned int i = 0; i< 6; i++)
         bond_virial[i]=Scalar(0.0);
 
-    ArrayHandle<typename BondData::members_t> h_bonds(m_bond_data->getMembersArray(), access_location::host, access_mode::read);
-    ArrayHandle<typeval_t> h_typeval(m_bond_data->getTypeValArray(), access_location::host, access_mode::read);
+    // the index table lists the bonds sorted by particle index, with members already resolved
+    ArrayHandle<typename BondData::members_t> h_bonds(m_bond_data->getIndexTable(), access_location::host, access_mode::read);
+    ArrayHandle<typeval_t> h_typeval(m_bond_data->getIndexTableTypeVal(), access_location::host, access_mode::read);
 
     unsigned int max_local = m_pdata->getN() + m_pdata->getNGhosts();
 
@@ -238,21 +238,19 @@ void PotentialBond< evaluator >::computeForces(unsigned int timestep)
 
     for (unsigned int i = 0; i < size; i++)
         {
-        // lookup the tag of each of the particles participating in the bond
+        // lookup the index of each of the particles participating in the bond
+        // (MEM TRANSFER: 2 integers)
         const typename BondData::members_t& bond = h_bonds.data[i];
-        assert(bond.tag[0] < m_pdata->getMaximumTag()+1);
-        assert(bond.tag[1] < m_pdata->getMaximumTag()+1);
-
-        // transform a and b into indices into the particle data arrays
-        // (MEM TRANSFER: 4 integers)
-        unsigned int idx_a = h_rtag.data[bond.tag[0]];
-        unsigned int idx_b = h_rtag.data[bond.tag[1]];
+        unsigned int idx_a = bond.idx[0];
+        unsigned int idx_b = bond.idx[1];
 
         // throw an error if this bond is incomplete
         if (idx_a >= max_local || idx_b >= max_local)
             {
+            ArrayHandle<unsigned int> h_group(m_bond_data->getIndexTableGroups(), access_location::host, access_mode::read);
+            typename BondData::members_t bond_tags = m_bond_data->getMembersByIndex(h_group.data[i]);
             this->m_exec_conf->msg->error() << "bond." << evaluator::getName() << ": bond " <<
-                bond.tag[0] << " " << bond.tag[1] << " incomplete." << std::endl << std::endl;
+                bond_tags.tag[0] << " " << bond_tags.tag[1] << " incomplete." << std::endl << std::endl;
             throw std::runtime_error("Error in bond calculation");
             }
 
@@ -853,7 +853,7 @@ inline void PotentialPair< evaluator >::computeEnergyBetweenSets(   InputIterato
     energy = Scalar(0.0);
 
     ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
-    ArrayHandle< unsigned int > h_rtags(m_pdata->getRTags(), access_location::host, access_mode::read);
+    TagIndexHandle h_rtags(*m_pdata, access_mode::read);
     ArrayHandle<Scalar> h_diameter(m_pdata->getDiameters(), access_location::host, access_mode::read);
     ArrayHandle<Scalar> h_charge(m_pdata->getCharges(), access_location::host, access_mode::read);
 
@@ -865,7 +865,7 @@ inline void PotentialPair< evaluator >::computeEnergyBetweenSets(   InputIterato
     // for each particle in tags1
     while (first1 != last1)
         {
-        unsigned int i = h_rtags.data[*first1]; first1++;
+        unsigned int i = h_rtags[*first1]; first1++;
         if (i >= m_pdata->getN()) // not owned by this processor.
             continue;
         // access the particle's position and type (MEM TRANSFER: 4 scalars)
@@ -887,7 +887,7 @@ inline void PotentialPair< evaluator >::computeEnergyBetweenSets(   InputIterato
         for (InputIterator iter = first2; iter != last2; ++iter)
             {
             // access the index of this neighbor (MEM TRANSFER: 1 scalar)
-            unsigned int j = h_rtags.data[*iter];
+            unsigned int j = h_rtags[*iter];
             if (j >= m_pdata->getN() + m_pdata->getNGhosts()) // not on this processor at all
                 continue;
             // calculate dr_ji (MEM TRANSFER: 3 scalars / FLOPS: 3)
@@ -9,6 +9,8 @@
 #include <stdexcept>
 #include <memory>
 #include <fstream>
+#include <vector>
+#include <algorithm>
 
 #include "hoomd/HOOMDMath.h"
 #include "hoomd/Index1D.h"
@@ -29,6 +31,22 @@
 
 #include <pybind11/pybind11.h>
 
+#ifdef ENABLE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+#endif
+
+//! Neighbor of a particle cached by PotentialTersoff before the triplet loops
+struct tersoff_neighbor
+    {
+    Scalar3 dx;                //!< Minimum image vector r_i - r_j
+    Scalar rsq;                //!< Squared distance between i and j
+    unsigned int idx;          //!< Local index of neighbor j
+    unsigned int type;         //!< Type of neighbor j
+    unsigned int typpair_idx;  //!< Index of the (i,j) type pair
+    };
+
 //! Template class for computing three-body potentials
 /*! <b>Overview:</b>
     PotentialTersoff computes standard three-body potentials and forces between all particles in the
@@ -107,6 +125,7 @@ class PotentialTersoff : public ForceCompute
         GPUArray<param_type> m_params;   //!< Pair parameters per type pair
         std::string m_prof_name;                    //!< Cached profiler name
         std::string m_log_name;                     //!< Cached log name
+        std::vector<tersoff_neighbor> m_nbrs;       //!< Neighbor cache of the current particle (serial code path)
 
         //! Actually compute the forces
         virtual void computeForces(unsigned int timestep);
@@ -267,103 +286,165 @@ Scalar PotentialTersoff< evaluator >::getLogValue(const std::string& quantity, u
     that it is up to date before proceeding.
 
     \param timestep specifies the current time step of the simulation
+
+    Before looping over the triplets of particle i, the neighbors of i that lie within the largest cutoff of any
+    type pair involving i are cached in a compact list (see tersoff_neighbor). The minimum image separations,
+    squared distances and type pair indices are computed only once per neighbor and the j/k loops read only
+    this list. Neighbors outside of the largest cutoff never contribute to the force, because all evaluators
+    test their distances against the cutoff of the i-j type pair.
+
+    When TBB is enabled, particles are distributed over threads. Forces and virials are accumulated into
+    per-thread buffers and summed at the end, because the three-body terms also act on the neighbors j and k.
 */
 template< class evaluator >
 void PotentialTersoff< evaluator >::computeForces(unsigned int timestep)
     {
-    // *****  check if we need the structure of the Tersoff or the RevCross potential for evaluation
-    if (evaluator::flag_for_RevCross )
-	{
-	// ***** RevCross potential
-        // start by updating the neighborlist
-        m_nlist->compute(timestep);
-
-        // start the profile for this compute
-        if (m_prof) m_prof->push(m_prof_name);
-
-        // The three-body potentials can't handle a half neighbor list, so check now.
-        bool third_law = m_nlist->getStorageMode() == NeighborList::half;
-        if (third_law)
+    // start by updating the neighborlist
+    m_nlist->compute(timestep);
+
+    // start the profile for this compute
+    if (m_prof) m_prof->push(m_prof_name);
+
+    // The three-body potentials can't handle a half neighbor list, so check now.
+    bool third_law = m_nlist->getStorageMode() == NeighborList::half;
+    if (third_law)
+        {
+        const std::string name = evaluator::flag_for_RevCross ? "PotentialRevCross" : "PotentialTersoff";
+        m_exec_conf->msg->error() << std::endl << name << " cannot handle a half neighborlist"
+                                  << std::endl;
+        throw std::runtime_error("Error computing forces in " + name);
+        }
+
+    // access the neighbor list, particle data, and system box
+    ArrayHandle<unsigned int> h_n_neigh(m_nlist->getNNeighArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_nlist(m_nlist->getNListArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_head_list(m_nlist->getHeadList(), access_location::host, access_mode::read);
+
+    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+
+    //force and virial arrays
+    ArrayHandle<Scalar4> h_force(m_force,access_location::host, access_mode::overwrite);
+    ArrayHandle<Scalar> h_virial(m_virial,access_location::host, access_mode::overwrite);
+
+    PDataFlags flags = this->m_pdata->getFlags();
+    bool compute_virial = flags[pdata_flag::pressure_tensor];
+
+    const BoxDim& box = m_pdata->getBox();
+    ArrayHandle<Scalar> h_rcutsq(m_rcutsq, access_location::host, access_mode::read);
+    ArrayHandle<param_type> h_params(m_params, access_location::host, access_mode::read);
+
+    const unsigned int N = m_pdata->getN();
+    const unsigned int n_total = m_pdata->getN() + m_pdata->getNGhosts();
+    const unsigned int virial_pitch = (unsigned int)m_virial_pitch;
+
+    // need to start from a zero force, energy
+    memset(h_force.data, 0, sizeof(Scalar4)*n_total);
+    memset(h_virial.data, 0, sizeof(Scalar)*6*m_virial_pitch);
+
+    unsigned int ntypes = m_pdata->getNTypes();
+
+    // largest cutoff of any type pair involving a given type, used to prune the cached neighbor lists
+    std::vector<Scalar> rcutsq_max(ntypes, Scalar(0.0));
+    for (unsigned int typ_a = 0; typ_a < ntypes; ++typ_a)
+        for (unsigned int typ_b = 0; typ_b < ntypes; ++typ_b)
+            rcutsq_max[typ_a] = std::max(rcutsq_max[typ_a], h_rcutsq.data[m_typpair_idx(typ_a, typ_b)]);
+
+    #ifdef ENABLE_TBB
+    // per-thread force and virial accumulators and neighbor caches
+    Scalar4 zero_force = make_scalar4(0.0, 0.0, 0.0, 0.0);
+    tbb::enumerable_thread_specific< std::vector<Scalar4> > thread_force(n_total, zero_force);
+    tbb::enumerable_thread_specific< std::vector<Scalar> > thread_virial(compute_virial ? 6*virial_pitch : 0,
+                                                                         Scalar(0.0));
+    tbb::enumerable_thread_specific< std::vector<tersoff_neighbor> > thread_nbrs;
+
+    tbb::parallel_for(tbb::blocked_range<unsigned int>(0, N),
+        [&](const tbb::blocked_range<unsigned int>& r) {
+        Scalar4 *force = thread_force.local().data();
+        Scalar *virial = thread_virial.local().data();
+        std::vector<tersoff_neighbor>& nbrs = thread_nbrs.local();
+
+        for (unsigned int i = r.begin(); i != r.end(); ++i)
+    #else
+    Scalar4 *force = h_force.data;
+    Scalar *virial = h_virial.data;
+    std::vector<tersoff_neighbor>& nbrs = m_nbrs;
+
+    // for each particle
+    for (unsigned int i = 0; i < N; i++)
+    #endif
+        {
+        // access the particle's position and type (MEM TRANSFER: 4 scalars)
+        Scalar3 posi = make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z);
+        unsigned int typei = __scalar_as_int(h_pos.data[i].w);
+        const unsigned int head_i = h_head_list.data[i];
+        // sanity check
+        assert(typei < m_pdata->getNTypes());
+
+        // cache the neighbors within range of particle i
+        nbrs.clear();
+        const unsigned int n_neigh = (unsigned int)h_n_neigh.data[i];
+        for (unsigned int j = 0; j < n_neigh; j++)
             {
-            m_exec_conf->msg->error() << std::endl << "PotentialRevCross cannot handle a half neighborlist"
-                                      << std::endl;
-            throw std::runtime_error("Error computing forces in PotentialRevCross");
-            }
+            // access the index of neighbor j (MEM TRANSFER: 1 scalar)
+            unsigned int jj = h_nlist.data[head_i + j];
+            assert(jj < m_pdata->getN() + m_pdata->getNGhosts());
 
-        // access the neighbor list, particle data, and system box
-        ArrayHandle<unsigned int> h_n_neigh(m_nlist->getNNeighArray(), access_location::host, access_mode::read);
-        ArrayHandle<unsigned int> h_nlist(m_nlist->getNListArray(), access_location::host, access_mode::read);
-        ArrayHandle<unsigned int> h_head_list(m_nlist->getHeadList(), access_location::host, access_mode::read);
+            // access the position and type of particle j
+            Scalar4 postypej = h_pos.data[jj];
+            Scalar3 posj = make_scalar3(postypej.x, postypej.y, postypej.z);
+            unsigned int typej = __scalar_as_int(postypej.w);
+            assert(typej < m_pdata->getNTypes());
 
-        ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+            // calculate dr_ij and apply periodic boundary conditions (MEM TRANSFER: 3 scalars / FLOPS: 3)
+            Scalar3 dxij = box.minImage(posi - posj);
 
-        //force and virial arrays
-        ArrayHandle<Scalar4> h_force(m_force,access_location::host, access_mode::overwrite);
-        ArrayHandle<Scalar> h_virial(m_virial,access_location::host, access_mode::overwrite);
+            // compute rij_sq (FLOPS: 5)
+            Scalar rij_sq = dot(dxij, dxij);
 
-        PDataFlags flags = this->m_pdata->getFlags();
-        bool compute_virial = flags[pdata_flag::pressure_tensor];
+            if (rij_sq < rcutsq_max[typei])
+                {
+                tersoff_neighbor nbr;
+                nbr.dx = dxij;
+                nbr.rsq = rij_sq;
+                nbr.idx = jj;
+                nbr.type = typej;
+                nbr.typpair_idx = m_typpair_idx(typei, typej);
+                nbrs.push_back(nbr);
+                }
+            }
 
-        const BoxDim& box = m_pdata->getBox();
-        ArrayHandle<Scalar> h_ronsq(m_ronsq, access_location::host, access_mode::read);
-        ArrayHandle<Scalar> h_rcutsq(m_rcutsq, access_location::host, access_mode::read);
-        ArrayHandle<param_type> h_params(m_params, access_location::host, access_mode::read);
+        const unsigned int size = (unsigned int)nbrs.size();
 
-        // need to start from a zero force, energy
-        memset(h_force.data, 0, sizeof(Scalar4)*(m_pdata->getN()+m_pdata->getNGhosts()));
-        memset(h_virial.data, 0, sizeof(Scalar)*6*m_virial_pitch);
+        // initialize current force and potential energy of particle i to 0
+        Scalar3 fi = make_scalar3(0.0, 0.0, 0.0);
+        Scalar pei = 0.0;
 
-        // for each particle
-        for (int i = 0; i < (int)m_pdata->getN(); i++)
-            {
-            // access the particle's position and type (MEM TRANSFER: 4 scalars)
-            Scalar3 posi = make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z);
-            unsigned int typei = __scalar_as_int(h_pos.data[i].w);
-            const unsigned int head_i = h_head_list.data[i];
-            // sanity check
-            assert(typei < m_pdata->getNTypes());
-
-            // initialize current force and potential energy of particle i to 0
-            Scalar3 fi = make_scalar3(0.0, 0.0, 0.0);
-            Scalar pei = 0.0;
-
-            Scalar virialixx(0.0);
-            Scalar virialixy(0.0);
-            Scalar virialixz(0.0);
-            Scalar virialiyy(0.0);
-            Scalar virialiyz(0.0);
-            Scalar virializz(0.0);
+        Scalar viriali_xx(0.0);
+        Scalar viriali_xy(0.0);
+        Scalar viriali_xz(0.0);
+        Scalar viriali_yy(0.0);
+        Scalar viriali_yz(0.0);
+        Scalar viriali_zz(0.0);
 
+        // *****  check if we need the structure of the Tersoff or the RevCross potential for evaluation
+        if (evaluator::flag_for_RevCross)
+            {
+            // ***** RevCross potential
             // loop over all of the neighbors of this particle
-            const unsigned int size = (unsigned int)h_n_neigh.data[i];
             for (unsigned int j = 0; j < size; j++)
                 {
-                // access the index of neighbor j (MEM TRANSFER: 1 scalar)
-                unsigned int jj = h_nlist.data[head_i + j];
-                assert(jj < m_pdata->getN() + m_pdata->getNGhosts());
-
-                // access the position and type of particle j
-                Scalar3 posj = make_scalar3(h_pos.data[jj].x, h_pos.data[jj].y, h_pos.data[jj].z);
-                unsigned int typej = __scalar_as_int(h_pos.data[jj].w);
-                assert(typej < m_pdata->getNTypes());
+                const tersoff_neighbor& nbr_j = nbrs[j];
+                unsigned int jj = nbr_j.idx;
+                Scalar3 dxij = nbr_j.dx;
+                Scalar rij_sq = nbr_j.rsq;
 
                 // initialize the current force and potential energy of particle j to 0
                 Scalar3 fj = make_scalar3(0.0, 0.0, 0.0);
                 Scalar pej = 0.0;
 
-                // calculate dr_ij (MEM TRANSFER: 3 scalars / FLOPS: 3)
-                Scalar3 dxij = posi - posj;
-
-                // apply periodic boundary conditions
-                dxij = box.minImage(dxij);
-
-                // compute rij_sq (FLOPS: 5)
-                Scalar rij_sq = dot(dxij, dxij);
-
                 // get parameters for this type pair
-                unsigned int typpair_idx = m_typpair_idx(typei, typej);
-                param_type param = h_params.data[typpair_idx];
-                Scalar rcutsq = h_rcutsq.data[typpair_idx];
+                param_type param = h_params.data[nbr_j.typpair_idx];
+                Scalar rcutsq = h_rcutsq.data[nbr_j.typpair_idx];
 
                 // evaluate the base repulsive and attractive terms
                 Scalar invratio = 0.0;
@@ -376,7 +457,6 @@ void PotentialTersoff< evaluator >::computeForces(unsigned int timestep)
                 // (since nl are type-wise I can not even merge them because i, j and k could be different types)
                 if (evaluated)
                     {
-            	//printf("\nEvaluating the pair (i,j)=(%d, %d)  from inside HOOMD CPU",i,jj);
                     // evaluate the force and energy from the ij interaction
                     Scalar force_divr = Scalar(0.0);
                     Scalar potential_eng = Scalar(0.0);
@@ -385,95 +465,82 @@ void PotentialTersoff< evaluator >::computeForces(unsigned int timestep)
 
                     // add this force to particle i
                     fi += force_divr * dxij;
-                    pei += potential_eng ;
+                    pei += potential_eng;
 
                     // add this force to particle j
                     fj += Scalar(-1.0) * force_divr * dxij;
-                    pej += potential_eng ;
+                    pej += potential_eng;
 
                     //vir contribute for i j direct interaction on particle i and j
-            	if (compute_virial)
-            	    {
-                	    virialixx += force_divr*dxij.x*dxij.x;
-                	    virialixy += force_divr*dxij.x*dxij.y;
-                	    virialixz += force_divr*dxij.x*dxij.z;
-                	    virialiyy += force_divr*dxij.y*dxij.y;
-                	    virialiyz += force_divr*dxij.y*dxij.z;
-            	    	    virializz += force_divr*dxij.z*dxij.z;
-            	    }
+                    if (compute_virial)
+                        {
+                        viriali_xx += force_divr*dxij.x*dxij.x;
+                        viriali_xy += force_divr*dxij.x*dxij.y;
+                        viriali_xz += force_divr*dxij.x*dxij.z;
+                        viriali_yy += force_divr*dxij.y*dxij.y;
+                        viriali_yz += force_divr*dxij.y*dxij.z;
+                        viriali_zz += force_divr*dxij.z*dxij.z;
+                        }
 
                     // evaluate the force from the ik interactions
-                    for (unsigned int k = j+1; k < size; k++)                    //I want to account only a single time for each triplets
+                    for (unsigned int k = j+1; k < size; k++) //I want to account only a single time for each triplets
                         {
-                        // access the index of neighbor k
-                        unsigned int kk = h_nlist.data[head_i + k];
-                        assert(kk < m_pdata->getN());
-
-                        // access the position and type of neighbor k
-                        Scalar3 posk = make_scalar3(h_pos.data[kk].x, h_pos.data[kk].y, h_pos.data[kk].z);
-                        unsigned int typek = __scalar_as_int(h_pos.data[kk].w);
-                        assert(typek < m_pdata->getNTypes());
+                        const tersoff_neighbor& nbr_k = nbrs[k];
+                        unsigned int kk = nbr_k.idx;
+                        Scalar3 dxik = nbr_k.dx;
+                        Scalar rik_sq = nbr_k.rsq;
 
                         // access the type pair parameters for i and k
-                        typpair_idx = m_typpair_idx(typei, typek);
-                        param_type temp_param = h_params.data[typpair_idx];             // use this to control the species wich have to interact
-
-                        // compute dr_ik
-                        Scalar3 dxik = posi - posk;
-                        // apply periodic boundary conditions
-                        dxik = box.minImage(dxik);
-                        // compute rik_sq
-                        Scalar rik_sq = dot(dxik, dxik);
+                        param_type temp_param = h_params.data[nbr_k.typpair_idx]; // use this to control the species wich have to interact
 
                         // check if k interacts using a temporary evaluator to analyze i-k parameters
                         evaluator temp_eval(rij_sq, rcutsq, temp_param);
                         temp_eval.setRik(rik_sq);
                         bool temp_evaluated = temp_eval.areInteractive();
 
-            	    // 3 Body interaction ******
+                        // 3 Body interaction ******
                         if (temp_evaluated)
                             {
-            		eval.setRik(rik_sq);
+                            eval.setRik(rik_sq);
                             // compute the total force and energy
                             Scalar3 fk = make_scalar3(0.0, 0.0, 0.0);
                             Scalar3 force_divr_ij_vec = make_scalar3(0.0, 0.0, 0.0);
                             Scalar3 force_divr_ik_vec = make_scalar3(0.0, 0.0, 0.0);
-                            bool evaluatedk = eval.evalForceik(invratio,invratio2, Scalar(0.0), Scalar(0.0), force_divr_ij_vec, force_divr_ik_vec);
-            	            // k interacts with the i-j as an additional third body
-                            if(evaluatedk)
-                            	{
-				// I stored the modulus of the force in the first component
-				Scalar force_divr_ij=force_divr_ij_vec.x;
-				Scalar force_divr_ik=force_divr_ik_vec.x;
-
-                            	// add the force to particle i
-                            	fi += force_divr_ij * dxij + force_divr_ik * dxik;
-
-                            	// add the force to particle j (FLOPS: 17)
-                            	fj += force_divr_ij * dxij * Scalar(-1.0);
-
-                            	// add the force to particle k
-                            	fk += force_divr_ik * dxik * Scalar(-1.0);
-
-                            	if (compute_virial)
-                               	{
-                            		//***look at 3 body pressure notes
-                            		//i just need a single term to account for all of the 3 body virial that i decide to store in the i particle's data
-                            		//and i just defined the diagonal component of pressure tensor, I don't know how the off diagonal terms can be included
-                            		virialixx += (force_divr_ij*dxij.x*dxij.x + force_divr_ik*dxik.x*dxik.x);
-                            		virialiyy += (force_divr_ij*dxij.y*dxij.y + force_divr_ik*dxik.y*dxik.y);
-                            		virializz += (force_divr_ij*dxij.z*dxij.z + force_divr_ik*dxik.z*dxik.z);
-                            		virialixy += (force_divr_ij*dxij.x*dxij.y + force_divr_ik*dxik.x*dxik.y);
-                              			virialixz += (force_divr_ij*dxij.x*dxij.z + force_divr_ik*dxik.x*dxik.z);
-                            			virialiyz += (force_divr_ij*dxij.y*dxij.z + force_divr_ik*dxik.y*dxik.z);
-                                   	}
-
-
-                            	// increment the force for particle k
-                            	unsigned int mem_idx = kk;
-                            	h_force.data[mem_idx].x += fk.x;
-                            	h_force.data[mem_idx].y += fk.y;
-                            	h_force.data[mem_idx].z += fk.z;
+                            bool evaluatedk = eval.evalForceik(invratio, invratio2, Scalar(0.0), Scalar(0.0), force_divr_ij_vec, force_divr_ik_vec);
+                            // k interacts with the i-j as an additional third body
+                            if (evaluatedk)
+                                {
+                                // I stored the modulus of the force in the first component
+                                Scalar force_divr_ij = force_divr_ij_vec.x;
+                                Scalar force_divr_ik = force_divr_ik_vec.x;
+
+                                // add the force to particle i
+                                fi += force_divr_ij * dxij + force_divr_ik * dxik;
+
+                                // add the force to particle j (FLOPS: 17)
+                                fj += force_divr_ij * dxij * Scalar(-1.0);
+
+                                // add the force to particle k
+                                fk += force_divr_ik * dxik * Scalar(-1.0);
+
+                                if (compute_virial)
+                                    {
+                                    //***look at 3 body pressure notes
+                                    //i just need a single term to account for all of the 3 body virial that i decide to store in the i particle's data
+                                    //and i just defined the diagonal component of pressure tensor, I don't know how the off diagonal terms can be included
+                                    viriali_xx += (force_divr_ij*dxij.x*dxij.x + force_divr_ik*dxik.x*dxik.x);
+                                    viriali_yy += (force_divr_ij*dxij.y*dxij.y + force_divr_ik*dxik.y*dxik.y);
+                                    viriali_zz += (force_divr_ij*dxij.z*dxij.z + force_divr_ik*dxik.z*dxik.z);
+                                    viriali_xy += (force_divr_ij*dxij.x*dxij.y + force_divr_ik*dxik.x*dxik.y);
+                                    viriali_xz += (force_divr_ij*dxij.x*dxij.z + force_divr_ik*dxik.x*dxik.z);
+                                    viriali_yz += (force_divr_ij*dxij.y*dxij.z + force_divr_ik*dxik.y*dxik.z);
+                                    }
+
+                                // increment the force for particle k
+                                unsigned int mem_idx = kk;
+                                force[mem_idx].x += fk.x;
+                                force[mem_idx].y += fk.y;
+                                force[mem_idx].z += fk.z;
                                 }
                             }
                         }
@@ -481,98 +548,15 @@ void PotentialTersoff< evaluator >::computeForces(unsigned int timestep)
 
                 // increment the force and potential energy for particle j
                 unsigned int mem_idx = jj;
-                h_force.data[mem_idx].x += fj.x;
-                h_force.data[mem_idx].y += fj.y;
-                h_force.data[mem_idx].z += fj.z;
-                h_force.data[mem_idx].w += pej;
-
-                }
-
-            // finally, increment the force and potential energy for particle i
-            unsigned int mem_idx = i;
-            h_force.data[mem_idx].x += fi.x;
-            h_force.data[mem_idx].y += fi.y;
-            h_force.data[mem_idx].z += fi.z;
-            h_force.data[mem_idx].w += pei;
-
-            //imcrement vir for i
-            if (compute_virial)
-                {
-                h_virial.data[0*m_virial_pitch+mem_idx] += virialixx;
-                h_virial.data[1*m_virial_pitch+mem_idx] += virialixy;
-                h_virial.data[2*m_virial_pitch+mem_idx] += virialixz;
-                h_virial.data[3*m_virial_pitch+mem_idx] += virialiyy;
-                h_virial.data[4*m_virial_pitch+mem_idx] += virialiyz;
-                h_virial.data[5*m_virial_pitch+mem_idx] += virializz;
+                force[mem_idx].x += fj.x;
+                force[mem_idx].y += fj.y;
+                force[mem_idx].z += fj.z;
+                force[mem_idx].w += pej;
                 }
-
             }
-	}
-    else
-        {
-        // ****** Tersoff or SquareDensity potential
-        // start by updating the neighborlist
-        m_nlist->compute(timestep);
-
-        // start the profile for this compute
-        if (m_prof) m_prof->push(m_prof_name);
-
-        // The three-body potentials can't handle a half neighbor list, so check now.
-        bool third_law = m_nlist->getStorageMode() == NeighborList::half;
-        if (third_law)
-            {
-            m_exec_conf->msg->error() << std::endl << "PotentialTersoff cannot handle a half neighborlist"
-                                      << std::endl;
-            throw std::runtime_error("Error computing forces in PotentialTersoff");
-            }
-
-        // access the neighbor list, particle data, and system box
-        ArrayHandle<unsigned int> h_n_neigh(m_nlist->getNNeighArray(), access_location::host, access_mode::read);
-        ArrayHandle<unsigned int> h_nlist(m_nlist->getNListArray(), access_location::host, access_mode::read);
-        ArrayHandle<unsigned int> h_head_list(m_nlist->getHeadList(), access_location::host, access_mode::read);
-
-        ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
-
-
-        //force and virial arrays
-        ArrayHandle<Scalar4> h_force(m_force,access_location::host, access_mode::overwrite);
-        ArrayHandle<Scalar> h_virial(m_virial,access_location::host, access_mode::overwrite);
-
-        PDataFlags flags = this->m_pdata->getFlags();
-        bool compute_virial = flags[pdata_flag::pressure_tensor];
-
-        const BoxDim& box = m_pdata->getBox();
-        ArrayHandle<Scalar> h_ronsq(m_ronsq, access_location::host, access_mode::read);
-        ArrayHandle<Scalar> h_rcutsq(m_rcutsq, access_location::host, access_mode::read);
-        ArrayHandle<param_type> h_params(m_params, access_location::host, access_mode::read);
-
-        // need to start from a zero force, energy
-        memset(h_force.data, 0, sizeof(Scalar4)*(m_pdata->getN()+m_pdata->getNGhosts()));
-        memset(h_virial.data, 0, sizeof(Scalar)*6*m_virial_pitch);
-
-        unsigned int ntypes = m_pdata->getNTypes();
-
-        // for each particle
-        for (int i = 0; i < (int)m_pdata->getN(); i++)
+        else
             {
-            // access the particle's position and type (MEM TRANSFER: 4 scalars)
-            Scalar3 posi = make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z);
-            unsigned int typei = __scalar_as_int(h_pos.data[i].w);
-            const unsigned int head_i = h_head_list.data[i];
-            // sanity check
-            assert(typei < m_pdata->getNTypes());
-
-            // initialize current force and potential energy of particle i to 0
-            Scalar3 fi = make_scalar3(0.0, 0.0, 0.0);
-            Scalar pei = 0.0;
-
-            Scalar viriali_xx(0.0);
-            Scalar viriali_xy(0.0);
-            Scalar viriali_xz(0.0);
-            Scalar viriali_yy(0.0);
-            Scalar viriali_yz(0.0);
-            Scalar viriali_zz(0.0);
-
+            // ****** Tersoff or SquareDensity potential
             Scalar phi_ab[ntypes];
 
             // reset phi
@@ -582,37 +566,19 @@ void PotentialTersoff< evaluator >::computeForces(unsigned int timestep)
                 }
 
             // all neighbors of this particle
-            const unsigned int size = (unsigned int)h_n_neigh.data[i];
             if (evaluator::hasPerParticleEnergy())
                 {
                 for (unsigned int j = 0; j < size; j++)
                     {
-                    // access the index of neighbor j (MEM TRANSFER: 1 scalar)
-                    unsigned int jj = h_nlist.data[head_i + j];
-                    assert(jj < m_pdata->getN() + m_pdata->getNGhosts());
-
-                    // access the position and type of particle j
-                    Scalar3 posj = make_scalar3(h_pos.data[jj].x, h_pos.data[jj].y, h_pos.data[jj].z);
-                    unsigned int typej = __scalar_as_int(h_pos.data[jj].w);
-                    assert(typej < m_pdata->getNTypes());
-
-                    // calculate dr_ij (MEM TRANSFER: 3 scalars / FLOPS: 3)
-                    Scalar3 dxij = posi - posj;
-
-                    // apply periodic boundary conditions
-                    dxij = box.minImage(dxij);
-
-                    // compute rij_sq (FLOPS: 5)
-                    Scalar rij_sq = dot(dxij, dxij);
+                    const tersoff_neighbor& nbr_j = nbrs[j];
 
                     // get parameters for this type pair
-                    unsigned int typpair_idx = m_typpair_idx(typei, typej);
-                    param_type param = h_params.data[typpair_idx];
-                    Scalar rcutsq = h_rcutsq.data[typpair_idx];
+                    param_type param = h_params.data[nbr_j.typpair_idx];
+                    Scalar rcutsq = h_rcutsq.data[nbr_j.typpair_idx];
 
                     // evaluate the scalar per-neighbor contribution
-                    evaluator eval(rij_sq, rcutsq, param);
-                    eval.evalPhi(phi_ab[typej]);
+                    evaluator eval(nbr_j.rsq, rcutsq, param);
+                    eval.evalPhi(phi_ab[nbr_j.type]);
                     }
 
                 // self-energy
@@ -631,32 +597,19 @@ void PotentialTersoff< evaluator >::computeForces(unsigned int timestep)
             // loop over all of the neighbors of this particle
             for (unsigned int j = 0; j < size; j++)
                 {
-                // access the index of neighbor j (MEM TRANSFER: 1 scalar)
-                unsigned int jj = h_nlist.data[head_i + j];
-                assert(jj < m_pdata->getN() + m_pdata->getNGhosts());
-
-                // access the position and type of particle j
-                Scalar3 posj = make_scalar3(h_pos.data[jj].x, h_pos.data[jj].y, h_pos.data[jj].z);
-                unsigned int typej = __scalar_as_int(h_pos.data[jj].w);
-                assert(typej < m_pdata->getNTypes());
+                const tersoff_neighbor& nbr_j = nbrs[j];
+                unsigned int jj = nbr_j.idx;
+                unsigned int typej = nbr_j.type;
+                Scalar3 dxij = nbr_j.dx;
+                Scalar rij_sq = nbr_j.rsq;
 
                 // initialize the current force and potential energy of particle j to 0
                 Scalar3 fj = make_scalar3(0.0, 0.0, 0.0);
                 Scalar pej = 0.0;
 
-                // calculate dr_ij (MEM TRANSFER: 3 scalars / FLOPS: 3)
-                Scalar3 dxij = posi - posj;
-
-                // apply periodic boundary conditions
-                dxij = box.minImage(dxij);
-
-                // compute rij_sq (FLOPS: 5)
-                Scalar rij_sq = dot(dxij, dxij);
-
                 // get parameters for this type pair
-                unsigned int typpair_idx = m_typpair_idx(typei, typej);
-                param_type param = h_params.data[typpair_idx];
-                Scalar rcutsq = h_rcutsq.data[typpair_idx];
+                param_type param = h_params.data[nbr_j.typpair_idx];
+                Scalar rcutsq = h_rcutsq.data[nbr_j.typpair_idx];
 
                 // evaluate the base repulsive and attractive terms
                 Scalar fR = 0.0;
@@ -679,32 +632,18 @@ void PotentialTersoff< evaluator >::computeForces(unsigned int timestep)
                         {
                         for (unsigned int k = 0; k < size; k++)
                             {
-                            // access the index of neighbor k
-                            unsigned int kk = h_nlist.data[head_i + k];
-                            assert(kk < m_pdata->getN());
-
-                            // access the position and type of neighbor k
-                            Scalar3 posk = make_scalar3(h_pos.data[kk].x, h_pos.data[kk].y, h_pos.data[kk].z);
-                            unsigned int typek = __scalar_as_int(h_pos.data[kk].w);
-                            assert(typek < m_pdata->getNTypes());
+                            const tersoff_neighbor& nbr_k = nbrs[k];
 
                             // access the type pair parameters for i and k
-                            typpair_idx = m_typpair_idx(typei, typek);
-                            param_type temp_param = h_params.data[typpair_idx];
+                            param_type temp_param = h_params.data[nbr_k.typpair_idx];
 
                             evaluator temp_eval(rij_sq, rcutsq, temp_param);
                             bool temp_evaluated = temp_eval.areInteractive();
 
-                            if (kk != jj && temp_evaluated)
+                            if (nbr_k.idx != jj && temp_evaluated)
                                 {
-                                // compute drik
-                                Scalar3 dxik = posi - posk;
-
-                                // apply periodic boundary conditions
-                                dxik = box.minImage(dxik);
-
-                                // compute rik_sq
-                                Scalar rik_sq = dot(dxik, dxik);
+                                Scalar3 dxik = nbr_k.dx;
+                                Scalar rik_sq = nbr_k.rsq;
 
                                 // compute the bond angle (if needed)
                                 Scalar cos_th = Scalar(0.0);
@@ -764,36 +703,23 @@ void PotentialTersoff< evaluator >::computeForces(unsigned int timestep)
                         // evaluate the force from the ik interactions
                         for (unsigned int k = 0; k < size; k++)
                             {
-                            // access the index of neighbor k
-                            unsigned int kk = h_nlist.data[head_i + k];
-                            assert(kk < m_pdata->getN());
-
-                            // access the position and type of neighbor k
-                            Scalar3 posk = make_scalar3(h_pos.data[kk].x, h_pos.data[kk].y, h_pos.data[kk].z);
-                            unsigned int typek = __scalar_as_int(h_pos.data[kk].w);
-                            assert(typek < m_pdata->getNTypes());
+                            const tersoff_neighbor& nbr_k = nbrs[k];
 
                             // access the type pair parameters for i and k
-                            typpair_idx = m_typpair_idx(typei, typek);
-                            param_type temp_param = h_params.data[typpair_idx];
+                            param_type temp_param = h_params.data[nbr_k.typpair_idx];
 
                             evaluator temp_eval(rij_sq, rcutsq, temp_param);
                             bool temp_evaluated = temp_eval.areInteractive();
 
-                            if (kk != jj && temp_evaluated)
+                            if (nbr_k.idx != jj && temp_evaluated)
                                 {
+                                unsigned int kk = nbr_k.idx;
+                                Scalar3 dxik = nbr_k.dx;
+                                Scalar rik_sq = nbr_k.rsq;
+
                                 // create variable for the force on k
                                 Scalar3 fk = make_scalar3(0.0, 0.0, 0.0);
 
-                                // compute dr_ik
-                                Scalar3 dxik = posi - posk;
-
-                                // apply periodic boundary conditions
-                                dxik = box.minImage(dxik);
-
-                                // compute rik_sq
-                                Scalar rik_sq = dot(dxik, dxik);
-
                                 // compute the bond angle (if needed)
                                 Scalar cos_th = Scalar(0.0);
                                 if (evaluator::needsAngle())
@@ -853,20 +779,20 @@ void PotentialTersoff< evaluator >::computeForces(unsigned int timestep)
 
                                 // increment the force for particle k
                                 unsigned int mem_idx = kk;
-                                h_force.data[mem_idx].x += fk.x;
-                                h_force.data[mem_idx].y += fk.y;
-                                h_force.data[mem_idx].z += fk.z;
+                                force[mem_idx].x += fk.x;
+                                force[mem_idx].y += fk.y;
+                                force[mem_idx].z += fk.z;
 
                                 if (compute_virial)
                                     {
                                     Scalar force_div2r_ij = Scalar(0.5)*force_divr_ij.z;
                                     Scalar force_div2r_ik = Scalar(0.5)*force_divr_ik.z;
-                                    h_virial.data[0*m_virial_pitch+mem_idx] += force_div2r_ij*dxij.x*dxij.x + force_div2r_ik*dxik.x*dxik.x;
-                                    h_virial.data[1*m_virial_pitch+mem_idx] += force_div2r_ij*dxij.x*dxij.y + force_div2r_ik*dxik.x*dxik.y;
-                                    h_virial.data[2*m_virial_pitch+mem_idx] += force_div2r_ij*dxij.x*dxij.z + force_div2r_ik*dxik.x*dxik.z;
-                                    h_virial.data[3*m_virial_pitch+mem_idx] += force_div2r_ij*dxij.y*dxij.y + force_div2r_ik*dxik.y*dxik.y;
-                                    h_virial.data[4*m_virial_pitch+mem_idx] += force_div2r_ij*dxij.y*dxij.z + force_div2r_ik*dxik.y*dxik.z;
-                                    h_virial.data[5*m_virial_pitch+mem_idx] += force_div2r_ij*dxij.z*dxij.z + force_div2r_ik*dxik.z*dxik.z;
+                                    virial[0*virial_pitch+mem_idx] += force_div2r_ij*dxij.x*dxij.x + force_div2r_ik*dxik.x*dxik.x;
+                                    virial[1*virial_pitch+mem_idx] += force_div2r_ij*dxij.x*dxij.y + force_div2r_ik*dxik.x*dxik.y;
+                                    virial[2*virial_pitch+mem_idx] += force_div2r_ij*dxij.x*dxij.z + force_div2r_ik*dxik.x*dxik.z;
+                                    virial[3*virial_pitch+mem_idx] += force_div2r_ij*dxij.y*dxij.y + force_div2r_ik*dxik.y*dxik.y;
+                                    virial[4*virial_pitch+mem_idx] += force_div2r_ij*dxij.y*dxij.z + force_div2r_ik*dxik.y*dxik.z;
+                                    virial[5*virial_pitch+mem_idx] += force_div2r_ij*dxij.z*dxij.z + force_div2r_ik*dxik.z*dxik.z;
                                     }
                                 }
                             }
@@ -874,39 +800,70 @@ void PotentialTersoff< evaluator >::computeForces(unsigned int timestep)
                     }
                 // increment the force and potential energy for particle j
                 unsigned int mem_idx = jj;
-                h_force.data[mem_idx].x += fj.x;
-                h_force.data[mem_idx].y += fj.y;
-                h_force.data[mem_idx].z += fj.z;
-                h_force.data[mem_idx].w += pej;
+                force[mem_idx].x += fj.x;
+                force[mem_idx].y += fj.y;
+                force[mem_idx].z += fj.z;
+                force[mem_idx].w += pej;
 
                 if (compute_virial)
                     {
-                    h_virial.data[0*m_virial_pitch+mem_idx] += virialj_xx;
-                    h_virial.data[1*m_virial_pitch+mem_idx] += virialj_xy;
-                    h_virial.data[2*m_virial_pitch+mem_idx] += virialj_xz;
-                    h_virial.data[3*m_virial_pitch+mem_idx] += virialj_yy;
-                    h_virial.data[4*m_virial_pitch+mem_idx] += virialj_yz;
-                    h_virial.data[5*m_virial_pitch+mem_idx] += virialj_zz;
+                    virial[0*virial_pitch+mem_idx] += virialj_xx;
+                    virial[1*virial_pitch+mem_idx] += virialj_xy;
+                    virial[2*virial_pitch+mem_idx] += virialj_xz;
+                    virial[3*virial_pitch+mem_idx] += virialj_yy;
+                    virial[4*virial_pitch+mem_idx] += virialj_yz;
+                    virial[5*virial_pitch+mem_idx] += virialj_zz;
                     }
                 }
-            // finally, increment the force and potential energy for particle i
-            unsigned int mem_idx = i;
-            h_force.data[mem_idx].x += fi.x;
-            h_force.data[mem_idx].y += fi.y;
-            h_force.data[mem_idx].z += fi.z;
-            h_force.data[mem_idx].w += pei;
-
-            if (compute_virial)
+            }
+
+        // finally, increment the force and potential energy for particle i
+        unsigned int mem_idx = i;
+        force[mem_idx].x += fi.x;
+        force[mem_idx].y += fi.y;
+        force[mem_idx].z += fi.z;
+        force[mem_idx].w += pei;
+
+        if (compute_virial)
+            {
+            virial[0*virial_pitch+mem_idx] += viriali_xx;
+            virial[1*virial_pitch+mem_idx] += viriali_xy;
+            virial[2*virial_pitch+mem_idx] += viriali_xz;
+            virial[3*virial_pitch+mem_idx] += viriali_yy;
+            virial[4*virial_pitch+mem_idx] += viriali_yz;
+            virial[5*virial_pitch+mem_idx] += viriali_zz;
+            }
+        }
+    #ifdef ENABLE_TBB
+        });
+
+    // sum up the per-thread contributions
+    tbb::parallel_for(tbb::blocked_range<unsigned int>(0, n_total),
+        [&](const tbb::blocked_range<unsigned int>& r) {
+        for (auto it = thread_force.begin(); it != thread_force.end(); ++it)
+            {
+            const Scalar4 *f = it->data();
+            for (unsigned int i = r.begin(); i != r.end(); ++i)
+                {
+                h_force.data[i].x += f[i].x;
+                h_force.data[i].y += f[i].y;
+                h_force.data[i].z += f[i].z;
+                h_force.data[i].w += f[i].w;
+                }
+            }
+
+        if (compute_virial)
+            {
+            for (auto it = thread_virial.begin(); it != thread_virial.end(); ++it)
                 {
-                h_virial.data[0*m_virial_pitch+mem_idx] += viriali_xx;
-                h_virial.data[1*m_virial_pitch+mem_idx] += viriali_xy;
-                h_virial.data[2*m_virial_pitch+mem_idx] += viriali_xz;
-                h_virial.data[3*m_virial_pitch+mem_idx] += viriali_yy;
-                h_virial.data[4*m_virial_pitch+mem_idx] += viriali_yz;
-                h_virial.data[5*m_virial_pitch+mem_idx] += viriali_zz;
+                const Scalar *v = it->data();
+                for (unsigned int k = 0; k < 6; ++k)
+                    for (unsigned int i = r.begin(); i != r.end(); ++i)
+                        h_virial.data[k*virial_pitch+i] += v[k*virial_pitch+i];
                 }
             }
-        }
+        });
+    #endif
 
     if (m_prof) m_prof->pop();
     }
@@ -0,0 +1,432 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+/*! \file StructureAnalyzer.cc
+    \brief Defines the StructureAnalyzer class
+*/
+
+#include "StructureAnalyzer.h"
+
+#include <pybind11/stl.h>
+
+#include <cmath>
+#include <stdexcept>
+
+using namespace std;
+namespace py = pybind11;
+
+/*! \param sysdef System to analyze
+    \param nlist Neighbor list providing the pairs
+    \param r_max Maximum pair distance of the radial distribution functions
+    \param n_bins Number of radial bins
+    \param grid Number of mesh points along each box vector for S(q)
+*/
+StructureAnalyzer::StructureAnalyzer(std::shared_ptr<SystemDefinition> sysdef,
+                                     std::shared_ptr<NeighborList> nlist,
+                                     Scalar r_max,
+                                     unsigned int n_bins,
+                                     unsigned int grid)
+    : Analyzer(sysdef), m_nlist(nlist), m_r_max(r_max), m_n_bins(n_bins), m_grid(grid), m_n_frames(0),
+      m_kiss_fft(NULL), m_dq(0)
+    {
+    m_exec_conf->msg->notice(5) << "Constructing StructureAnalyzer" << endl;
+
+    if (r_max <= Scalar(0.0) || n_bins == 0)
+        {
+        m_exec_conf->msg->error() << "StructureAnalyzer: r_max and the number of bins must be positive" << endl;
+        throw std::invalid_argument("Invalid StructureAnalyzer parameters");
+        }
+
+    if (grid < 2)
+        {
+        m_exec_conf->msg->error() << "StructureAnalyzer: The grid must have at least 2 points" << endl;
+        throw std::invalid_argument("Invalid StructureAnalyzer parameters");
+        }
+
+    // all pairs within r_max must be in the neighbor list
+    unsigned int n_types = m_pdata->getNTypes();
+    m_r_cut_nlist = std::make_shared<GlobalArray<Scalar> >(n_types*n_types, m_exec_conf);
+    setNlistRCut();
+    m_nlist->addRCutMatrix(m_r_cut_nlist);
+
+    bool twod = m_sysdef->getNDimensions() == 2;
+    m_mesh_dim = make_uint3(grid, grid, twod ? 1 : grid);
+    unsigned int n_cells = m_mesh_dim.x * m_mesh_dim.y * m_mesh_dim.z;
+    m_density.resize(n_cells);
+
+    // only the root rank transforms the summed density
+    if (m_exec_conf->getRank() == 0)
+        {
+        // kiss FFT expects data in row major format
+        int dims[3];
+        dims[0] = m_mesh_dim.z;
+        dims[1] = m_mesh_dim.y;
+        dims[2] = m_mesh_dim.x;
+        m_kiss_fft = twod ? kiss_fftnd_alloc(dims+1, 2, 0, NULL, NULL) : kiss_fftnd_alloc(dims, 3, 0, NULL, NULL);
+        m_fft_in.resize(n_cells);
+        m_fft_out.resize(n_cells);
+        }
+
+    reset();
+
+    m_pdata->getNumTypesChangeSignal().connect<StructureAnalyzer, &StructureAnalyzer::slotNumTypesChange>(this);
+    }
+
+StructureAnalyzer::~StructureAnalyzer()
+    {
+    m_exec_conf->msg->notice(5) << "Destroying StructureAnalyzer" << endl;
+
+    m_pdata->getNumTypesChangeSignal().disconnect<StructureAnalyzer, &StructureAnalyzer::slotNumTypesChange>(this);
+    m_nlist->removeRCutMatrix(m_r_cut_nlist);
+
+    if (m_kiss_fft)
+        free(m_kiss_fft);
+    }
+
+void StructureAnalyzer::setNlistRCut()
+    {
+    ArrayHandle<Scalar> h_r_cut(*m_r_cut_nlist, access_location::host, access_mode::overwrite);
+    for (unsigned int i = 0; i < m_r_cut_nlist->getNumElements(); i++)
+        h_r_cut.data[i] = m_r_max;
+    }
+
+/*! The histograms are sized by the number of type pairs, so the accumulated frames are discarded.
+*/
+void StructureAnalyzer::slotNumTypesChange()
+    {
+    unsigned int n_types = m_pdata->getNTypes();
+    m_r_cut_nlist->resize(n_types*n_types);
+    setNlistRCut();
+    m_nlist->notifyRCutMatrixChange();
+
+    reset();
+    }
+
+void StructureAnalyzer::reset()
+    {
+    Index2DUpperTriangular type_pair_idx(m_pdata->getNTypes());
+    m_rdf.assign(type_pair_idx.getNumElements() * m_n_bins, 0.0);
+    m_pair_counts.assign(type_pair_idx.getNumElements() * m_n_bins, 0);
+    m_sq_sum.clear();
+    m_sq_count.clear();
+    m_dq = 0;
+    m_n_frames = 0;
+    }
+
+/*! \param timestep Current time step
+*/
+void StructureAnalyzer::analyze(unsigned int timestep)
+    {
+    if (m_prof)
+        m_prof->push("Structure");
+
+    accumulateRDF(timestep);
+    accumulateStructureFactor();
+    m_n_frames++;
+
+    if (m_prof)
+        m_prof->pop();
+    }
+
+/*! \param timestep Current time step
+
+    Pairs are counted in units of half pairs: a pair that is stored once in a half neighbor list counts 2. Pairs with a
+    ghost particle are stored on both ranks and pairs in a full neighbor list are stored twice, so each of these
+    entries counts 1.
+*/
+void StructureAnalyzer::accumulateRDF(unsigned int timestep)
+    {
+    m_nlist->compute(timestep);
+
+    bool third_law = m_nlist->getStorageMode() == NeighborList::half;
+
+    ArrayHandle<unsigned int> h_n_neigh(m_nlist->getNNeighArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_nlist(m_nlist->getNListArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_head_list(m_nlist->getHeadList(), access_location::host, access_mode::read);
+
+    unsigned int N = m_pdata->getN();
+    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+
+    const BoxDim& box = m_pdata->getGlobalBox();
+    unsigned int n_types = m_pdata->getNTypes();
+    Index2DUpperTriangular type_pair_idx(n_types);
+
+    std::fill(m_pair_counts.begin(), m_pair_counts.end(), 0);
+    std::vector<unsigned int> type_counts(n_types, 0);
+
+    Scalar r_max_sq = m_r_max * m_r_max;
+    Scalar bins_per_r = Scalar(m_n_bins) / m_r_max;
+
+    for (unsigned int i = 0; i < N; i++)
+        {
+        Scalar3 pi = make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z);
+        unsigned int typei = __scalar_as_int(h_pos.data[i].w);
+        type_counts[typei]++;
+
+        const unsigned int head = h_head_list.data[i];
+        const unsigned int size = h_n_neigh.data[i];
+        for (unsigned int k = 0; k < size; k++)
+            {
+            unsigned int j = h_nlist.data[head + k];
+
+            Scalar3 dx = make_scalar3(h_pos.data[j].x, h_pos.data[j].y, h_pos.data[j].z) - pi;
+            dx = box.minImage(dx);
+            Scalar rsq = dot(dx, dx);
+            if (rsq >= r_max_sq)
+                continue;
+
+            unsigned int typej = __scalar_as_int(h_pos.data[j].w);
+            unsigned int bin = std::min((unsigned int)(slow::sqrt(rsq) * bins_per_r), m_n_bins - 1);
+            m_pair_counts[type_pair_idx(typei, typej) * m_n_bins + bin] += (third_law && j < N) ? 2 : 1;
+            }
+        }
+
+    #ifdef ENABLE_MPI
+    if (m_pdata->getDomainDecomposition())
+        {
+        MPI_Allreduce(MPI_IN_PLACE, type_counts.data(), n_types, MPI_UNSIGNED, MPI_SUM,
+                      m_exec_conf->getMPICommunicator());
+        }
+    #endif
+
+    // normalize by the pair density of an ideal gas in this frame
+    double V = box.getVolume(m_sysdef->getNDimensions() == 2);
+    for (unsigned int a = 0; a < n_types; a++)
+        {
+        for (unsigned int b = a; b < n_types; b++)
+            {
+            double n_pairs = (a == b) ? 0.5 * double(type_counts[a]) * double(type_counts[a] - 1)
+                                      : double(type_counts[a]) * double(type_counts[b]);
+            if (n_pairs <= 0)
+                continue;
+
+            double norm = 0.5 * V / n_pairs;
+            unsigned int offset = type_pair_idx(a, b) * m_n_bins;
+            for (unsigned int bin = 0; bin < m_n_bins; bin++)
+                m_rdf[offset + bin] += norm * double(m_pair_counts[offset + bin]);
+            }
+        }
+    }
+
+void StructureAnalyzer::accumulateStructureFactor()
+    {
+    const BoxDim& box = m_pdata->getGlobalBox();
+    bool twod = m_sysdef->getNDimensions() == 2;
+    uint3 dim = m_mesh_dim;
+
+    // assign the local particles to the mesh with cloud-in-cell weights
+    std::fill(m_density.begin(), m_density.end(), Scalar(0.0));
+        {
+        ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+        for (unsigned int i = 0; i < m_pdata->getN(); i++)
+            {
+            Scalar3 f = box.makeFraction(make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z));
+            Scalar3 u = make_scalar3(f.x * Scalar(dim.x), f.y * Scalar(dim.y), f.z * Scalar(dim.z));
+            int ix = int(floor(u.x));
+            int iy = int(floor(u.y));
+            int iz = twod ? 0 : int(floor(u.z));
+            Scalar wx[2] = {Scalar(1.0) - (u.x - Scalar(ix)), u.x - Scalar(ix)};
+            Scalar wy[2] = {Scalar(1.0) - (u.y - Scalar(iy)), u.y - Scalar(iy)};
+            Scalar wz[2] = {Scalar(1.0), Scalar(0.0)};
+            if (!twod)
+                {
+                wz[0] = Scalar(1.0) - (u.z - Scalar(iz));
+                wz[1] = u.z - Scalar(iz);
+                }
+
+            for (int l = 0; l < (twod ? 1 : 2); l++)
+                {
+                unsigned int z = (unsigned int)((iz + l + int(dim.z)) % int(dim.z));
+                for (int m = 0; m < 2; m++)
+                    {
+                    unsigned int y = (unsigned int)((iy + m + int(dim.y)) % int(dim.y));
+                    for (int n = 0; n < 2; n++)
+                        {
+                        unsigned int x = (unsigned int)((ix + n + int(dim.x)) % int(dim.x));
+                        m_density[x + dim.x * (y + dim.y * z)] += wx[n] * wy[m] * wz[l];
+                        }
+                    }
+                }
+            }
+        }
+
+    // sum the density of all ranks on the root rank
+    unsigned int N = m_pdata->getNGlobal();
+    #ifdef ENABLE_MPI
+    if (m_pdata->getDomainDecomposition())
+        {
+        if (m_exec_conf->getRank() == 0)
+            MPI_Reduce(MPI_IN_PLACE, m_density.data(), (int)m_density.size(), MPI_HOOMD_SCALAR, MPI_SUM, 0,
+                       m_exec_conf->getMPICommunicator());
+        else
+            MPI_Reduce(m_density.data(), NULL, (int)m_density.size(), MPI_HOOMD_SCALAR, MPI_SUM, 0,
+                       m_exec_conf->getMPICommunicator());
+        }
+    #endif
+
+    if (m_exec_conf->getRank() != 0 || N == 0)
+        return;
+
+    for (unsigned int cell = 0; cell < m_density.size(); cell++)
+        {
+        m_fft_in[cell].r = (kiss_fft_scalar) m_density[cell];
+        m_fft_in[cell].i = (kiss_fft_scalar) 0.0;
+        }
+    kiss_fftnd(m_kiss_fft, m_fft_in.data(), m_fft_out.data());
+
+    // reciprocal lattice vectors
+    Scalar3 a1 = box.getLatticeVector(0);
+    Scalar3 a2 = box.getLatticeVector(1);
+    Scalar3 a3 = box.getLatticeVector(2);
+    Scalar V_box = box.getVolume();
+    Scalar3 b1 = Scalar(2.0*M_PI)*make_scalar3(a2.y*a3.z-a2.z*a3.y, a2.z*a3.x-a2.x*a3.z, a2.x*a3.y-a2.y*a3.x)/V_box;
+    Scalar3 b2 = Scalar(2.0*M_PI)*make_scalar3(a3.y*a1.z-a3.z*a1.y, a3.z*a1.x-a3.x*a1.z, a3.x*a1.y-a3.y*a1.x)/V_box;
+    Scalar3 b3 = Scalar(2.0*M_PI)*make_scalar3(a1.y*a2.z-a1.z*a2.y, a1.z*a2.x-a1.x*a2.z, a1.x*a2.y-a1.y*a2.x)/V_box;
+
+    // only use wave vectors below the Nyquist wave number along every box vector
+    double q_max = 0.5 * std::min(dim.x * slow::sqrt(dot(b1, b1)), dim.y * slow::sqrt(dot(b2, b2)));
+    double q_min = std::min(slow::sqrt(dot(b1, b1)), slow::sqrt(dot(b2, b2)));
+    if (!twod)
+        {
+        q_max = std::min(q_max, 0.5 * dim.z * slow::sqrt(dot(b3, b3)));
+        q_min = std::min(q_min, double(slow::sqrt(dot(b3, b3))));
+        }
+
+    // the bins are fixed by the box of the first frame
+    if (m_dq == 0)
+        {
+        m_dq = q_min;
+        m_sq_sum.assign((unsigned int)ceil(q_max / m_dq), 0.0);
+        m_sq_count.assign(m_sq_sum.size(), 0.0);
+        }
+
+    for (unsigned int cell = 0; cell < m_density.size(); cell++)
+        {
+        // Miller indices
+        int3 n = make_int3(cell % dim.x, (cell / dim.x) % dim.y, cell / (dim.x * dim.y));
+        if (n.x >= (int)(dim.x/2 + dim.x%2))
+            n.x -= (int) dim.x;
+        if (n.y >= (int)(dim.y/2 + dim.y%2))
+            n.y -= (int) dim.y;
+        if (n.z >= (int)(dim.z/2 + dim.z%2))
+            n.z -= (int) dim.z;
+
+        if (n.x == 0 && n.y == 0 && n.z == 0)
+            continue;
+
+        Scalar3 k = Scalar(n.x)*b1 + Scalar(n.y)*b2 + Scalar(n.z)*b3;
+        double q = slow::sqrt(dot(k, k));
+        unsigned int bin = (unsigned int)(q / m_dq);
+        if (q >= q_max || bin >= m_sq_sum.size())
+            continue;
+
+        // deconvolve the cloud-in-cell assignment window
+        double w = 1.0;
+        int nn[3] = {n.x, n.y, n.z};
+        unsigned int dd[3] = {dim.x, dim.y, dim.z};
+        for (unsigned int d = 0; d < (twod ? 2u : 3u); d++)
+            {
+            if (nn[d] != 0)
+                {
+                double arg = M_PI * double(nn[d]) / double(dd[d]);
+                double sinc = sin(arg) / arg;
+                w *= sinc * sinc;
+                }
+            }
+
+        double re = m_fft_out[cell].r;
+        double im = m_fft_out[cell].i;
+        m_sq_sum[bin] += (re*re + im*im) / (double(N) * w * w);
+        m_sq_count[bin] += 1.0;
+        }
+    }
+
+std::vector<double> StructureAnalyzer::getBinCenters()
+    {
+    std::vector<double> r(m_n_bins);
+    double dr = double(m_r_max) / double(m_n_bins);
+    for (unsigned int bin = 0; bin < m_n_bins; bin++)
+        r[bin] = (double(bin) + 0.5) * dr;
+    return r;
+    }
+
+/*! The histograms are summed over all ranks. This method must be called on all ranks.
+*/
+std::vector<double> StructureAnalyzer::getRDF()
+    {
+    std::vector<double> rdf(m_rdf);
+
+    #ifdef ENABLE_MPI
+    if (m_pdata->getDomainDecomposition())
+        {
+        MPI_Allreduce(MPI_IN_PLACE, rdf.data(), (int)rdf.size(), MPI_DOUBLE, MPI_SUM,
+                      m_exec_conf->getMPICommunicator());
+        }
+    #endif
+
+    if (m_n_frames == 0)
+        return rdf;
+
+    double dr = double(m_r_max) / double(m_n_bins);
+    bool twod = m_sysdef->getNDimensions() == 2;
+    for (unsigned int bin = 0; bin < m_n_bins; bin++)
+        {
+        double r_lo = double(bin) * dr;
+        double r_hi = r_lo + dr;
+        double shell = twod ? M_PI * (r_hi*r_hi - r_lo*r_lo)
+                            : 4.0/3.0 * M_PI * (r_hi*r_hi*r_hi - r_lo*r_lo*r_lo);
+        for (unsigned int offset = 0; offset < rdf.size(); offset += m_n_bins)
+            rdf[offset + bin] /= shell * double(m_n_frames);
+        }
+
+    return rdf;
+    }
+
+/*! The wave number bins are set on the first accumulated frame.
+*/
+std::vector<double> StructureAnalyzer::getQ()
+    {
+    std::vector<double> q(m_sq_sum.size());
+    for (unsigned int bin = 0; bin < q.size(); bin++)
+        q[bin] = (double(bin) + 0.5) * m_dq;
+
+    #ifdef ENABLE_MPI
+    if (m_pdata->getDomainDecomposition())
+        bcast(q, 0, m_exec_conf->getMPICommunicator());
+    #endif
+
+    return q;
+    }
+
+/*! S(q) is computed on the root rank and broadcast to all ranks. This method must be called on all ranks.
+*/
+std::vector<double> StructureAnalyzer::getStructureFactor()
+    {
+    std::vector<double> sq(m_sq_sum.size());
+    for (unsigned int bin = 0; bin < sq.size(); bin++)
+        sq[bin] = m_sq_count[bin] > 0 ? m_sq_sum[bin] / m_sq_count[bin] : 0.0;
+
+    #ifdef ENABLE_MPI
+    if (m_pdata->getDomainDecomposition())
+        bcast(sq, 0, m_exec_conf->getMPICommunicator());
+    #endif
+
+    return sq;
+    }
+
+void export_StructureAnalyzer(py::module& m)
+    {
+    py::class_<StructureAnalyzer, Analyzer, std::shared_ptr<StructureAnalyzer> >(m, "StructureAnalyzer")
+        .def(py::init< std::shared_ptr<SystemDefinition>, std::shared_ptr<NeighborList>, Scalar, unsigned int,
+                       unsigned int >())
+        .def("reset", &StructureAnalyzer::reset)
+        .def("getBinCenters", &StructureAnalyzer::getBinCenters)
+        .def("getRDF", &StructureAnalyzer::getRDF)
+        .def("getQ", &StructureAnalyzer::getQ)
+        .def("getStructureFactor", &StructureAnalyzer::getStructureFactor)
+        .def_property_readonly("num_frames", &StructureAnalyzer::getNumFrames)
+        .def_property_readonly("r_max", &StructureAnalyzer::getRMax)
+        .def_property_readonly("bins", &StructureAnalyzer::getNBins)
+        .def_property_readonly("grid", &StructureAnalyzer::getGrid)
+    ;
+    }
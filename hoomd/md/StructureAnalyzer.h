@@ -0,0 +1,131 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#ifndef __STRUCTURE_ANALYZER_H__
+#define __STRUCTURE_ANALYZER_H__
+
+#include "hoomd/Analyzer.h"
+#include "NeighborList.h"
+
+#include "hoomd/extern/kiss_fftnd.h"
+
+#include <memory>
+#include <vector>
+
+/*! \file StructureAnalyzer.h
+    \brief Declares the StructureAnalyzer class
+*/
+
+#ifdef __HIPCC__
+#error This header cannot be compiled by nvcc
+#endif
+
+#include <pybind11/pybind11.h>
+
+//! Accumulates radial distribution functions and the static structure factor on the fly
+/*! StructureAnalyzer histograms the pair distances of the pairs in the neighbor list for every unordered pair of
+    particle types each time analyze() is called. The neighbor list already enumerates these pairs for the pair
+    potentials, so no additional pair search is needed. StructureAnalyzer registers \a r_max as a cutoff with the
+    neighbor list so that all pairs within \a r_max are present. Pairs that the neighbor list excludes (e.g. bonded
+    pairs) do not contribute.
+
+    The static structure factor S(q) of all particles is computed on a \a grid^3 mesh (\a grid^2 in 2D): the particle
+    density is assigned to the mesh with cloud-in-cell weights, transformed with KISS FFT, deconvolved by the
+    assignment window, and averaged over spherical shells in q. With domain decomposition, the density meshes of the
+    ranks are summed on the root rank, which performs the transform. S(q) is accurate for q well below the Nyquist
+    wave number of the mesh.
+
+    Histograms are normalized per frame, so the results remain valid when the box or the number of particles changes.
+    The radial distribution functions are accumulated per rank and reduced across ranks when they are requested.
+
+    \ingroup analyzers
+*/
+class PYBIND11_EXPORT StructureAnalyzer : public Analyzer
+    {
+    public:
+        //! Constructor
+        StructureAnalyzer(std::shared_ptr<SystemDefinition> sysdef,
+                          std::shared_ptr<NeighborList> nlist,
+                          Scalar r_max,
+                          unsigned int n_bins,
+                          unsigned int grid);
+
+        //! Destructor
+        virtual ~StructureAnalyzer();
+
+        //! Accumulate the structure of the current configuration
+        virtual void analyze(unsigned int timestep);
+
+        //! Discard all accumulated frames
+        void reset();
+
+        //! Get the number of accumulated frames
+        unsigned int getNumFrames()
+            {
+            return m_n_frames;
+            }
+
+        //! Get the centers of the radial bins
+        std::vector<double> getBinCenters();
+
+        //! Get the radial distribution functions (n_type_pairs x n_bins, row major)
+        std::vector<double> getRDF();
+
+        //! Get the centers of the wave number bins
+        std::vector<double> getQ();
+
+        //! Get the structure factor in each wave number bin
+        std::vector<double> getStructureFactor();
+
+        Scalar getRMax()
+            {
+            return m_r_max;
+            }
+
+        unsigned int getNBins()
+            {
+            return m_n_bins;
+            }
+
+        unsigned int getGrid()
+            {
+            return m_grid;
+            }
+
+    protected:
+        std::shared_ptr<NeighborList> m_nlist;              //!< Neighbor list providing the pairs
+        std::shared_ptr<GlobalArray<Scalar> > m_r_cut_nlist; //!< Cutoff matrix registered with the neighbor list
+        Scalar m_r_max;                                     //!< Maximum pair distance
+        unsigned int m_n_bins;                              //!< Number of radial bins
+        unsigned int m_grid;                                //!< Number of mesh points along each box vector
+        unsigned int m_n_frames;                            //!< Number of accumulated frames
+
+        std::vector<double> m_rdf;          //!< Normalized pair histograms of this rank, summed over frames
+        std::vector<unsigned int> m_pair_counts; //!< Pair histogram of the current frame
+
+        uint3 m_mesh_dim;                   //!< Mesh dimensions
+        std::vector<Scalar> m_density;      //!< Density mesh of this rank
+        std::vector<kiss_fft_cpx> m_fft_in; //!< FFT input
+        std::vector<kiss_fft_cpx> m_fft_out;//!< FFT output
+        kiss_fftnd_cfg m_kiss_fft;          //!< FFT plan, only allocated on the root rank
+        double m_dq;                        //!< Width of the wave number bins
+        std::vector<double> m_sq_sum;       //!< Sum of S(k) in each wave number bin
+        std::vector<double> m_sq_count;     //!< Number of wave vectors in each wave number bin
+
+        //! Set the cutoff of all type pairs in the neighbor list
+        void setNlistRCut();
+
+        //! Handle a change in the number of types
+        void slotNumTypesChange();
+
+        //! Histogram the pairs of the neighbor list
+        void accumulateRDF(unsigned int timestep);
+
+        //! Compute S(q) of the current configuration
+        void accumulateStructureFactor();
+    };
+
+//! Exports the StructureAnalyzer class to python
+void export_StructureAnalyzer(pybind11::module& m);
+
+#endif // __STRUCTURE_ANALYZER_H__
@@ -0,0 +1,451 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+/*! \file TimeCorrelator.cc
+    \brief Defines the MultipleTauCorrelator and TimeCorrelator classes
+*/
+
+#include "TimeCorrelator.h"
+
+#include <pybind11/stl.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+namespace py = pybind11;
+
+/*! \param n_values Number of values in each sample
+    \param p Number of lags per level
+    \param m Number of samples averaged when moving to the next level, must divide \a p
+    \param squared_difference Set to true to correlate with squared differences instead of products
+*/
+MultipleTauCorrelator::MultipleTauCorrelator(unsigned int n_values,
+                                             unsigned int p,
+                                             unsigned int m,
+                                             bool squared_difference)
+    : m_n_values(n_values), m_p(p), m_m(m), m_squared_difference(squared_difference), m_buffer(n_values)
+    {
+    reset();
+    }
+
+void MultipleTauCorrelator::reset()
+    {
+    m_levels.clear();
+    addLevel();
+    }
+
+void MultipleTauCorrelator::addLevel()
+    {
+    Level level;
+    level.shift.resize(m_p * m_n_values);
+    level.head = 0;
+    level.n_valid = 0;
+    level.accum.assign(m_n_values, 0.0);
+    level.n_accum = 0;
+    level.sums.assign(m_p, 0.0);
+    level.counts.assign(m_p, 0.0);
+    m_levels.push_back(level);
+    }
+
+/*! \param k Level
+    \param values Sample to add
+*/
+void MultipleTauCorrelator::add(unsigned int k, const double *values)
+    {
+    if (k >= m_levels.size())
+        addLevel();
+
+    Level& level = m_levels[k];
+
+    // shift the register and insert the new sample at the head
+    level.head = (level.head + m_p - 1) % m_p;
+    std::copy(values, values + m_n_values, level.shift.begin() + level.head * m_n_values);
+    if (level.n_valid < m_p)
+        level.n_valid++;
+
+    // the lags below p/m are covered by the previous level
+    unsigned int j_start = (k == 0) ? 0 : m_p / m_m;
+    const double *a = &level.shift[level.head * m_n_values];
+    for (unsigned int j = j_start; j < level.n_valid; j++)
+        {
+        const double *b = &level.shift[((level.head + j) % m_p) * m_n_values];
+        double sum = 0.0;
+        if (m_squared_difference)
+            {
+            for (unsigned int i = 0; i < m_n_values; i++)
+                sum += (a[i] - b[i]) * (a[i] - b[i]);
+            }
+        else
+            {
+            for (unsigned int i = 0; i < m_n_values; i++)
+                sum += a[i] * b[i];
+            }
+        level.sums[j] += sum;
+        level.counts[j] += 1.0;
+        }
+
+    // pass the block average on to the next level
+    for (unsigned int i = 0; i < m_n_values; i++)
+        level.accum[i] += values[i];
+    level.n_accum++;
+
+    if (level.n_accum == m_m)
+        {
+        for (unsigned int i = 0; i < m_n_values; i++)
+            {
+            m_buffer[i] = level.accum[i] / double(m_m);
+            level.accum[i] = 0.0;
+            }
+        level.n_accum = 0;
+
+        // adding a level invalidates the reference to this level
+        add(k + 1, m_buffer.data());
+        }
+    }
+
+/*! \param lags Output lags in units of the sampling interval
+    \param sums Output correlation sums at each lag
+    \param counts Output number of correlated sample pairs at each lag
+
+    Only the lags with at least one sample pair are returned, in increasing order.
+*/
+void MultipleTauCorrelator::getCorrelation(std::vector<unsigned int>& lags,
+                                           std::vector<double>& sums,
+                                           std::vector<double>& counts) const
+    {
+    lags.clear();
+    sums.clear();
+    counts.clear();
+
+    unsigned int block = 1;
+    for (unsigned int k = 0; k < m_levels.size(); k++)
+        {
+        unsigned int j_start = (k == 0) ? 0 : m_p / m_m;
+        for (unsigned int j = j_start; j < m_p; j++)
+            {
+            if (m_levels[k].counts[j] == 0.0)
+                continue;
+
+            lags.push_back(j * block);
+            sums.push_back(m_levels[k].sums[j]);
+            counts.push_back(m_levels[k].counts[j]);
+            }
+        block *= m_m;
+        }
+    }
+
+/*! \param sysdef System to analyze
+    \param group Particles to compute the mean squared displacement and velocity autocorrelation of
+    \param thermo Compute providing the pressure tensor, NULL to skip the stress autocorrelation
+    \param period Number of time steps between samples
+    \param points_per_level Number of lags per correlator level
+    \param averaging Number of samples averaged when moving to the next level
+    \param msd Set to true to compute the mean squared displacement
+    \param vacf Set to true to compute the velocity autocorrelation function
+*/
+TimeCorrelator::TimeCorrelator(std::shared_ptr<SystemDefinition> sysdef,
+                               std::shared_ptr<ParticleGroup> group,
+                               std::shared_ptr<ComputeThermo> thermo,
+                               unsigned int period,
+                               unsigned int points_per_level,
+                               unsigned int averaging,
+                               bool msd,
+                               bool vacf)
+    : Analyzer(sysdef), m_group(group), m_thermo(thermo), m_period(period), m_n_samples(0),
+      m_first_member(0), m_n_local_members(0)
+    {
+    m_exec_conf->msg->notice(5) << "Constructing TimeCorrelator" << endl;
+
+    if (period == 0)
+        {
+        m_exec_conf->msg->error() << "TimeCorrelator: The period must be positive" << endl;
+        throw std::invalid_argument("Invalid TimeCorrelator parameters");
+        }
+
+    if (averaging < 2 || points_per_level < averaging || points_per_level % averaging != 0)
+        {
+        m_exec_conf->msg->error() << "TimeCorrelator: points_per_level must be a multiple of averaging, "
+                                  << "and averaging must be at least 2" << endl;
+        throw std::invalid_argument("Invalid TimeCorrelator parameters");
+        }
+
+    unsigned int n_members = m_group->getNumMembersGlobal();
+    if ((msd || vacf) && n_members == 0)
+        {
+        m_exec_conf->msg->error() << "TimeCorrelator: The group is empty" << endl;
+        throw std::invalid_argument("Invalid TimeCorrelator parameters");
+        }
+
+    // the group is fixed at construction
+    m_member_tags.resize(n_members);
+    for (unsigned int i = 0; i < n_members; i++)
+        m_member_tags[i] = m_group->getMemberTag(i);
+
+    // assign a contiguous range of members to each rank
+    unsigned int n_ranks = 1;
+    unsigned int rank = 0;
+    #ifdef ENABLE_MPI
+    if (m_pdata->getDomainDecomposition())
+        {
+        n_ranks = m_exec_conf->getNRanks();
+        rank = m_exec_conf->getRank();
+        }
+    #endif
+
+    m_member_offsets.resize(n_ranks + 1);
+    for (unsigned int r = 0; r <= n_ranks; r++)
+        m_member_offsets[r] = (unsigned int)((uint64_t)r * n_members / n_ranks);
+    m_first_member = m_member_offsets[rank];
+    m_n_local_members = m_member_offsets[rank + 1] - m_first_member;
+
+    if (msd || vacf)
+        m_recv_buf.resize(3 * m_n_local_members);
+
+    if (msd)
+        m_msd.reset(new MultipleTauCorrelator(3 * m_n_local_members, points_per_level, averaging, true));
+    if (vacf)
+        m_vacf.reset(new MultipleTauCorrelator(3 * m_n_local_members, points_per_level, averaging, false));
+
+    // the pressure tensor is known on all ranks, so every rank correlates it
+    if (m_thermo)
+        {
+        unsigned int n_components = m_sysdef->getNDimensions() == 2 ? 1 : 3;
+        m_stress.reset(new MultipleTauCorrelator(n_components, points_per_level, averaging, false));
+        }
+    }
+
+TimeCorrelator::~TimeCorrelator()
+    {
+    m_exec_conf->msg->notice(5) << "Destroying TimeCorrelator" << endl;
+    }
+
+PDataFlags TimeCorrelator::getRequestedPDataFlags()
+    {
+    PDataFlags flags(0);
+    if (m_thermo)
+        flags[pdata_flag::pressure_tensor] = 1;
+    return flags;
+    }
+
+void TimeCorrelator::reset()
+    {
+    if (m_msd)
+        m_msd->reset();
+    if (m_vacf)
+        m_vacf->reset();
+    if (m_stress)
+        m_stress->reset();
+    m_n_samples = 0;
+    }
+
+/*! \param velocity Set to true to collect velocities, false to collect unwrapped positions
+    \returns The values of the group members correlated on this rank, ordered by tag
+
+    Each rank looks up the members that are local to it and sends their values to the ranks that correlate them. An
+    error is raised on all ranks when a member is no longer in the system.
+*/
+const double *TimeCorrelator::gatherMemberValues(bool velocity)
+    {
+    bool decomposed = false;
+    #ifdef ENABLE_MPI
+    decomposed = (bool) m_pdata->getDomainDecomposition();
+    #endif
+
+    unsigned int n_ranks = (unsigned int)m_member_offsets.size() - 1;
+    std::vector< std::vector<MemberValue> > send(decomposed ? n_ranks : 0);
+    unsigned int n_found = 0;
+
+        {
+        ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::read);
+        ArrayHandle<int3> h_image(m_pdata->getImages(), access_location::host, access_mode::read);
+        TagIndexHandle h_rtag(*m_pdata, access_mode::read);
+
+        const BoxDim& box = m_pdata->getGlobalBox();
+
+        // the members are sorted by tag, so the rank that correlates them only moves forward
+        unsigned int owner = 0;
+        for (unsigned int member = 0; member < m_member_tags.size(); member++)
+            {
+            unsigned int tag = m_member_tags[member];
+            if (!m_pdata->isTagActive(tag))
+                continue;
+            unsigned int idx = h_rtag[tag];
+            if (idx >= m_pdata->getN())
+                continue;
+            n_found++;
+
+            Scalar3 v;
+            if (velocity)
+                v = make_scalar3(h_vel.data[idx].x, h_vel.data[idx].y, h_vel.data[idx].z);
+            else
+                v = box.shift(make_scalar3(h_pos.data[idx].x, h_pos.data[idx].y, h_pos.data[idx].z),
+                              h_image.data[idx]);
+
+            if (decomposed)
+                {
+                while (member >= m_member_offsets[owner + 1])
+                    owner++;
+                MemberValue value;
+                value.member = member;
+                value.v[0] = v.x;
+                value.v[1] = v.y;
+                value.v[2] = v.z;
+                send[owner].push_back(value);
+                }
+            else
+                {
+                m_recv_buf[3 * member] = v.x;
+                m_recv_buf[3 * member + 1] = v.y;
+                m_recv_buf[3 * member + 2] = v.z;
+                }
+            }
+        }
+
+    #ifdef ENABLE_MPI
+    if (decomposed)
+        {
+        MPI_Allreduce(MPI_IN_PLACE, &n_found, 1, MPI_UNSIGNED, MPI_SUM, m_exec_conf->getMPICommunicator());
+        }
+    #endif
+
+    if (n_found != m_member_tags.size())
+        {
+        m_exec_conf->msg->error() << "TimeCorrelator: " << m_member_tags.size() - n_found
+                                  << " group members have been removed from the system" << endl;
+        throw std::runtime_error("Error computing time correlations");
+        }
+
+    #ifdef ENABLE_MPI
+    if (decomposed)
+        {
+        std::vector< std::vector<MemberValue> > recv;
+        all_to_all_v(send, recv, m_exec_conf->getMPICommunicator());
+
+        for (unsigned int r = 0; r < n_ranks; r++)
+            {
+            for (const MemberValue& value : recv[r])
+                {
+                unsigned int i = value.member - m_first_member;
+                m_recv_buf[3 * i] = value.v[0];
+                m_recv_buf[3 * i + 1] = value.v[1];
+                m_recv_buf[3 * i + 2] = value.v[2];
+                }
+            }
+        }
+    #endif
+
+    return m_recv_buf.data();
+    }
+
+/*! \param timestep Current time step
+*/
+void TimeCorrelator::analyze(unsigned int timestep)
+    {
+    if (m_prof)
+        m_prof->push("Correlator");
+
+    if (m_msd)
+        m_msd->add(gatherMemberValues(false));
+
+    if (m_vacf)
+        m_vacf->add(gatherMemberValues(true));
+
+    if (m_stress)
+        {
+        m_thermo->compute(timestep);
+        PressureTensor P = m_thermo->getPressureTensor();
+        double values[3] = {P.xy, P.xz, P.yz};
+        m_stress->add(values);
+        }
+
+    m_n_samples++;
+
+    if (m_prof)
+        m_prof->pop();
+    }
+
+/*! All correlators receive the same samples and therefore have the same lags.
+*/
+std::vector<unsigned int> TimeCorrelator::getLags()
+    {
+    std::vector<unsigned int> lags;
+    std::vector<double> sums, counts;
+
+    if (m_msd)
+        m_msd->getCorrelation(lags, sums, counts);
+    else if (m_vacf)
+        m_vacf->getCorrelation(lags, sums, counts);
+    else if (m_stress)
+        m_stress->getCorrelation(lags, sums, counts);
+
+    for (unsigned int i = 0; i < lags.size(); i++)
+        lags[i] *= m_period;
+
+    return lags;
+    }
+
+/*! \param correlator Correlator to normalize
+    \param n_items Number of items (particles or components) in a sample
+    \param reduce Set to true to sum the correlation over all ranks
+
+    \returns The correlation averaged over sample pairs and items, empty when \a correlator is NULL
+*/
+std::vector<double> TimeCorrelator::getCorrelation(const std::unique_ptr<MultipleTauCorrelator>& correlator,
+                                                   unsigned int n_items,
+                                                   bool reduce)
+    {
+    std::vector<unsigned int> lags;
+    std::vector<double> sums, counts;
+    if (!correlator)
+        return sums;
+
+    correlator->getCorrelation(lags, sums, counts);
+
+    #ifdef ENABLE_MPI
+    if (reduce && m_pdata->getDomainDecomposition())
+        {
+        MPI_Allreduce(MPI_IN_PLACE, sums.data(), (int)sums.size(), MPI_DOUBLE, MPI_SUM,
+                      m_exec_conf->getMPICommunicator());
+        }
+    #endif
+
+    for (unsigned int i = 0; i < sums.size(); i++)
+        sums[i] /= counts[i] * double(n_items);
+
+    return sums;
+    }
+
+/*! This method must be called on all ranks.
+*/
+std::vector<double> TimeCorrelator::getMSD()
+    {
+    return getCorrelation(m_msd, (unsigned int)m_member_tags.size(), true);
+    }
+
+/*! This method must be called on all ranks.
+*/
+std::vector<double> TimeCorrelator::getVACF()
+    {
+    return getCorrelation(m_vacf, (unsigned int)m_member_tags.size(), true);
+    }
+
+std::vector<double> TimeCorrelator::getStressACF()
+    {
+    return getCorrelation(m_stress, m_sysdef->getNDimensions() == 2 ? 1 : 3, false);
+    }
+
+void export_TimeCorrelator(py::module& m)
+    {
+    py::class_<TimeCorrelator, Analyzer, std::shared_ptr<TimeCorrelator> >(m, "TimeCorrelator")
+        .def(py::init< std::shared_ptr<SystemDefinition>, std::shared_ptr<ParticleGroup>,
+                       std::shared_ptr<ComputeThermo>, unsigned int, unsigned int, unsigned int, bool, bool >())
+        .def("reset", &TimeCorrelator::reset)
+        .def("getLags", &TimeCorrelator::getLags)
+        .def("getMSD", &TimeCorrelator::getMSD)
+        .def("getVACF", &TimeCorrelator::getVACF)
+        .def("getStressACF", &TimeCorrelator::getStressACF)
+        .def_property_readonly("num_samples", &TimeCorrelator::getNumSamples)
+    ;
+    }
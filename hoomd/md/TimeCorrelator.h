@@ -0,0 +1,180 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#ifndef __TIME_CORRELATOR_H__
+#define __TIME_CORRELATOR_H__
+
+#include "hoomd/Analyzer.h"
+#include "hoomd/ParticleGroup.h"
+#include "ComputeThermo.h"
+
+#include <memory>
+#include <vector>
+
+/*! \file TimeCorrelator.h
+    \brief Declares the MultipleTauCorrelator and TimeCorrelator classes
+*/
+
+#ifdef __HIPCC__
+#error This header cannot be compiled by nvcc
+#endif
+
+#include <pybind11/pybind11.h>
+
+//! Correlates a stream of samples with the multiple-tau block averaging scheme
+/*! Each sample is a vector of \a n_values values. Level 0 stores the last \a p samples in a shift register and
+    correlates every new sample with them, giving lags 0 to p-1. Every \a m samples of level k are averaged and pushed
+    into level k+1, whose shift register covers lags p/m*m^(k+1) to (p-1)*m^(k+1). Levels are added as the lags grow,
+    so the memory grows as n_values * p * log_m(T) for T samples.
+
+    Two correlation operations are supported: the sum of the products a(t)*a(t+tau) over all values (for
+    autocorrelation functions), and the sum of the squared differences (a(t+tau) - a(t))^2 (for mean squared
+    displacements). The sums and the number of correlated sample pairs are accumulated separately so that the sums of
+    several correlators can be reduced before normalizing.
+*/
+class PYBIND11_EXPORT MultipleTauCorrelator
+    {
+    public:
+        //! Constructor
+        MultipleTauCorrelator(unsigned int n_values,
+                              unsigned int p,
+                              unsigned int m,
+                              bool squared_difference);
+
+        //! Add a sample
+        void add(const double *values)
+            {
+            add(0, values);
+            }
+
+        //! Discard all samples
+        void reset();
+
+        //! Get the accumulated correlation
+        void getCorrelation(std::vector<unsigned int>& lags,
+                            std::vector<double>& sums,
+                            std::vector<double>& counts) const;
+
+    private:
+        //! One level of the correlator
+        struct Level
+            {
+            std::vector<double> shift;      //!< Shift register of p samples
+            unsigned int head;              //!< Position of the newest sample in the shift register
+            unsigned int n_valid;           //!< Number of samples in the shift register
+            std::vector<double> accum;      //!< Sum of the samples to pass to the next level
+            unsigned int n_accum;           //!< Number of samples in accum
+            std::vector<double> sums;       //!< Correlation sums for each lag
+            std::vector<double> counts;     //!< Number of correlated sample pairs for each lag
+            };
+
+        unsigned int m_n_values;            //!< Number of values in a sample
+        unsigned int m_p;                   //!< Number of lags per level
+        unsigned int m_m;                   //!< Number of samples averaged when moving to the next level
+        bool m_squared_difference;          //!< Correlate with squared differences instead of products
+        std::vector<Level> m_levels;        //!< Levels of the correlator
+        std::vector<double> m_buffer;       //!< Averaged sample passed to the next level
+
+        //! Add a sample to a level
+        void add(unsigned int k, const double *values);
+
+        //! Append an empty level
+        void addLevel();
+    };
+
+//! Computes time correlation functions on the fly with multiple-tau correlators
+/*! TimeCorrelator samples the system each time analyze() is called and accumulates the mean squared displacement and
+    the velocity autocorrelation function of the particles in a group, and the autocorrelation function of the
+    off-diagonal components of the pressure tensor computed by a ComputeThermo. Each quantity is accumulated with a
+    MultipleTauCorrelator, so the correlation functions cover lags from one sampling period to the length of the run
+    in O(log T) memory. Samples must be taken every \a period time steps.
+
+    The mean squared displacement is computed from the unwrapped positions. The averaging in the higher levels smooths
+    the trajectory over the block length, which is small compared to the lags of those levels.
+
+    With domain decomposition, each rank correlates a fixed, contiguous range of the group members (in tag order), so
+    that the correlator state does not migrate with the particles. At every sample, each rank sends the values of its
+    local members to the ranks that correlate them, and the correlation sums are reduced across ranks when they are
+    requested.
+
+    \ingroup analyzers
+*/
+class PYBIND11_EXPORT TimeCorrelator : public Analyzer
+    {
+    public:
+        //! Constructor
+        TimeCorrelator(std::shared_ptr<SystemDefinition> sysdef,
+                       std::shared_ptr<ParticleGroup> group,
+                       std::shared_ptr<ComputeThermo> thermo,
+                       unsigned int period,
+                       unsigned int points_per_level,
+                       unsigned int averaging,
+                       bool msd,
+                       bool vacf);
+
+        //! Destructor
+        virtual ~TimeCorrelator();
+
+        //! Sample the system
+        virtual void analyze(unsigned int timestep);
+
+        //! Request the pressure tensor when the stress autocorrelation is computed
+        virtual PDataFlags getRequestedPDataFlags();
+
+        //! Discard all samples
+        void reset();
+
+        //! Get the number of samples
+        unsigned int getNumSamples()
+            {
+            return m_n_samples;
+            }
+
+        //! Get the lags of the correlation functions in time steps
+        std::vector<unsigned int> getLags();
+
+        //! Get the mean squared displacement
+        std::vector<double> getMSD();
+
+        //! Get the velocity autocorrelation function
+        std::vector<double> getVACF();
+
+        //! Get the autocorrelation function of the off-diagonal pressure tensor components
+        std::vector<double> getStressACF();
+
+    protected:
+        std::shared_ptr<ParticleGroup> m_group;     //!< Particles to correlate
+        std::shared_ptr<ComputeThermo> m_thermo;    //!< Pressure tensor source, may be NULL
+        unsigned int m_period;                      //!< Number of time steps between samples
+        unsigned int m_n_samples;                   //!< Number of samples taken
+
+        std::vector<unsigned int> m_member_tags;    //!< Tags of the group members, sorted
+        unsigned int m_first_member;                //!< First group member correlated on this rank
+        unsigned int m_n_local_members;             //!< Number of group members correlated on this rank
+        std::vector<double> m_recv_buf;             //!< Per-particle values correlated on this rank
+        std::vector<unsigned int> m_member_offsets; //!< First group member correlated on each rank, and the total
+
+        //! Values of one group member sent to the rank that correlates it
+        struct MemberValue
+            {
+            unsigned int member;    //!< Index of the member in m_member_tags
+            double v[3];            //!< Position or velocity of the member
+            };
+
+        std::unique_ptr<MultipleTauCorrelator> m_msd;       //!< Correlator of the unwrapped positions
+        std::unique_ptr<MultipleTauCorrelator> m_vacf;      //!< Correlator of the velocities
+        std::unique_ptr<MultipleTauCorrelator> m_stress;    //!< Correlator of the pressure tensor
+
+        //! Collect the per-particle values correlated on this rank
+        const double *gatherMemberValues(bool velocity);
+
+        //! Normalize the correlation of a correlator
+        std::vector<double> getCorrelation(const std::unique_ptr<MultipleTauCorrelator>& correlator,
+                                           unsigned int n_items,
+                                           bool reduce);
+    };
+
+//! Exports the TimeCorrelator class to python
+void export_TimeCorrelator(pybind11::module& m);
+
+#endif // __TIME_CORRELATOR_H__
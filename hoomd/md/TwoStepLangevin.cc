@@ -402,6 +402,130 @@ void TwoStepLangevin::integrateStepTwo(unsigned int timestep)
         m_prof->pop();
     }
 
+/*! \param timestep Current time step
+    \post Particle velocities are moved forward from timestep-1/2 to timestep+1/2 and positions to timestep+1
+
+    Equivalent to integrateStepTwo(timestep-1) followed by integrateStepOne(timestep) for isotropic integration, but
+    each particle is read and written once. The random forces belong to the second step of timestep-1.
+*/
+void TwoStepLangevin::integrateFusedStep(unsigned int timestep)
+    {
+    if (m_aniso)
+        {
+        IntegrationMethodTwoStep::integrateFusedStep(timestep);
+        return;
+        }
+
+    unsigned int group_size = m_group->getNumMembers();
+
+    // profile this step
+    if (m_prof)
+        m_prof->push("Langevin fused step");
+
+    ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar3> h_accel(m_pdata->getAccelerations(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::readwrite);
+    ArrayHandle<int3> h_image(m_pdata->getImages(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar> h_diameter(m_pdata->getDiameters(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_net_force(m_pdata->getNetForce(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar> h_gamma(m_gamma, access_location::host, access_mode::read);
+
+    const BoxDim& box = m_pdata->getBox();
+
+    // the second step belongs to the previous time step
+    const unsigned int timestep_two = timestep - 1;
+    const Scalar currentTemp = (*m_T)(timestep_two);
+    const unsigned int D = m_sysdef->getNDimensions();
+
+    // energy transferred over the previous time step
+    Scalar bd_energy_transfer = 0;
+
+    for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
+        {
+        unsigned int j = m_group->getMemberIndex(group_idx);
+        unsigned int ptag = h_tag.data[j];
+        Scalar4 pos = h_pos.data[j];
+        Scalar4 vel = h_vel.data[j];
+        Scalar3 accel;
+
+        // Initialize the RNG
+        RandomGenerator rng(RNGIdentifier::TwoStepLangevin, m_seed, ptag, timestep_two);
+
+        // first, calculate the BD forces
+        // Generate three random numbers
+        hoomd::UniformDistribution<Scalar> uniform(Scalar(-1), Scalar(1));
+        Scalar rx = uniform(rng);
+        Scalar ry = uniform(rng);
+        Scalar rz = uniform(rng);
+
+        Scalar gamma;
+        if (m_use_alpha)
+            gamma = m_alpha*h_diameter.data[j];
+        else
+            {
+            unsigned int type = __scalar_as_int(pos.w);
+            gamma = h_gamma.data[type];
+            }
+
+        // compute the bd force
+        Scalar coeff = fast::sqrt(Scalar(6.0) *gamma*currentTemp/m_deltaT);
+        if (m_noiseless_t)
+            coeff = Scalar(0.0);
+        Scalar bd_fx = rx*coeff - gamma*vel.x;
+        Scalar bd_fy = ry*coeff - gamma*vel.y;
+        Scalar bd_fz = rz*coeff - gamma*vel.z;
+
+        if (D < 3)
+            bd_fz = Scalar(0.0);
+
+        // v(t) = v(t-deltaT/2) + 1/2 * a(t)*deltaT, where a(t) includes the bd forces
+        Scalar minv = Scalar(1.0) / vel.w;
+        accel.x = (h_net_force.data[j].x + bd_fx)*minv;
+        accel.y = (h_net_force.data[j].y + bd_fy)*minv;
+        accel.z = (h_net_force.data[j].z + bd_fz)*minv;
+
+        vel.x += Scalar(1.0/2.0)*accel.x*m_deltaT;
+        vel.y += Scalar(1.0/2.0)*accel.y*m_deltaT;
+        vel.z += Scalar(1.0/2.0)*accel.z*m_deltaT;
+
+        // tally the energy transfer from the bd thermal reservoir to the particles
+        if (m_tally) bd_energy_transfer += bd_fx * vel.x + bd_fy * vel.y + bd_fz * vel.z;
+
+        // r(t+deltaT) = r(t) + v(t)*deltaT + (1/2)a(t)*deltaT^2
+        pos.x += vel.x*m_deltaT + Scalar(1.0/2.0)*accel.x*m_deltaT*m_deltaT;
+        pos.y += vel.y*m_deltaT + Scalar(1.0/2.0)*accel.y*m_deltaT*m_deltaT;
+        pos.z += vel.z*m_deltaT + Scalar(1.0/2.0)*accel.z*m_deltaT*m_deltaT;
+        box.wrap(pos, h_image.data[j]);
+
+        // v(t+deltaT/2) = v(t) + (1/2)a*deltaT
+        vel.x += Scalar(1.0/2.0)*accel.x*m_deltaT;
+        vel.y += Scalar(1.0/2.0)*accel.y*m_deltaT;
+        vel.z += Scalar(1.0/2.0)*accel.z*m_deltaT;
+
+        h_pos.data[j] = pos;
+        h_vel.data[j] = vel;
+        h_accel.data[j] = accel;
+        }
+
+    // update energy reservoir
+    if (m_tally)
+        {
+        #ifdef ENABLE_MPI
+        if (m_comm)
+            {
+            MPI_Allreduce(MPI_IN_PLACE, &bd_energy_transfer, 1, MPI_HOOMD_SCALAR, MPI_SUM, m_exec_conf->getMPICommunicator());
+            }
+        #endif
+        m_reservoir_energy -= bd_energy_transfer*m_deltaT;
+        m_extra_energy_overdeltaT = 0.5*bd_energy_transfer;
+        }
+
+    // done profiling
+    if (m_prof)
+        m_prof->pop();
+    }
+
 void export_TwoStepLangevin(py::module& m)
     {
     py::class_<TwoStepLangevin, TwoStepLangevinBase, std::shared_ptr<TwoStepLangevin> >(m, "TwoStepLangevin")
@@ -64,6 +64,15 @@ class PYBIND11_EXPORT TwoStepLangevin : public TwoStepLangevinBase
         /// Performs the second step of the integration
         virtual void integrateStepTwo(unsigned int timestep);
 
+        /// Performs the second step of the previous time step and the first step of this one in one pass
+        virtual void integrateFusedStep(unsigned int timestep);
+
+        /// The fused step is implemented for the translational degrees of freedom
+        virtual bool hasFusedStep()
+            {
+            return !m_aniso;
+            }
+
     protected:
         /// The energy of the reservoir the system is coupled to.
         Scalar m_reservoir_energy;
@@ -368,6 +368,104 @@ void TwoStepNVE::integrateStepTwo(unsigned int timestep)
         m_prof->pop();
     }
 
+/*! \param timestep Current time step
+    \post Particle velocities are moved forward from timestep-1/2 to timestep+1/2 and positions to timestep+1
+
+    Equivalent to integrateStepTwo(timestep-1) followed by integrateStepOne(timestep) for isotropic integration, but
+    each particle is read and written once.
+*/
+void TwoStepNVE::integrateFusedStep(unsigned int timestep)
+    {
+    if (m_aniso)
+        {
+        IntegrationMethodTwoStep::integrateFusedStep(timestep);
+        return;
+        }
+
+    unsigned int group_size = m_group->getNumMembers();
+
+    // profile this step
+    if (m_prof)
+        m_prof->push("NVE fused step");
+
+    ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar3> h_accel(m_pdata->getAccelerations(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::readwrite);
+    ArrayHandle<int3> h_image(m_pdata->getImages(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar4> h_net_force(m_pdata->getNetForce(), access_location::host, access_mode::read);
+
+    const BoxDim& box = m_pdata->getBox();
+
+    for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
+        {
+        unsigned int j = m_group->getMemberIndex(group_idx);
+
+        Scalar4 vel = h_vel.data[j];
+        Scalar3 accel;
+
+        // v(t) = v(t-deltaT/2) + 1/2 * a(t)*deltaT
+        if (m_zero_force)
+            {
+            accel.x = accel.y = accel.z = 0.0;
+            }
+        else
+            {
+            Scalar minv = Scalar(1.0) / vel.w;
+            accel.x = h_net_force.data[j].x*minv;
+            accel.y = h_net_force.data[j].y*minv;
+            accel.z = h_net_force.data[j].z*minv;
+            }
+
+        vel.x += Scalar(1.0/2.0)*accel.x*m_deltaT;
+        vel.y += Scalar(1.0/2.0)*accel.y*m_deltaT;
+        vel.z += Scalar(1.0/2.0)*accel.z*m_deltaT;
+
+        if (m_limit)
+            {
+            Scalar v = sqrt(vel.x*vel.x+vel.y*vel.y+vel.z*vel.z);
+            if ( (v*m_deltaT) > m_limit_val)
+                {
+                vel.x = vel.x / v * m_limit_val / m_deltaT;
+                vel.y = vel.y / v * m_limit_val / m_deltaT;
+                vel.z = vel.z / v * m_limit_val / m_deltaT;
+                }
+            }
+
+        // r(t+deltaT) = r(t) + v(t)*deltaT + (1/2)a(t)*deltaT^2
+        Scalar dx = vel.x*m_deltaT + Scalar(1.0/2.0)*accel.x*m_deltaT*m_deltaT;
+        Scalar dy = vel.y*m_deltaT + Scalar(1.0/2.0)*accel.y*m_deltaT*m_deltaT;
+        Scalar dz = vel.z*m_deltaT + Scalar(1.0/2.0)*accel.z*m_deltaT*m_deltaT;
+
+        if (m_limit)
+            {
+            Scalar len = sqrt(dx*dx + dy*dy + dz*dz);
+            if (len > m_limit_val)
+                {
+                dx = dx / len * m_limit_val;
+                dy = dy / len * m_limit_val;
+                dz = dz / len * m_limit_val;
+                }
+            }
+
+        h_pos.data[j].x += dx;
+        h_pos.data[j].y += dy;
+        h_pos.data[j].z += dz;
+        box.wrap(h_pos.data[j], h_image.data[j]);
+
+        // v(t+deltaT/2) = v(t) + (1/2)a*deltaT
+        vel.x += Scalar(1.0/2.0)*accel.x*m_deltaT;
+        vel.y += Scalar(1.0/2.0)*accel.y*m_deltaT;
+        vel.z += Scalar(1.0/2.0)*accel.z*m_deltaT;
+
+        h_vel.data[j] = vel;
+        h_accel.data[j] = accel;
+        }
+
+    // done profiling
+    if (m_prof)
+        m_prof->pop();
+    }
+
 void export_TwoStepNVE(py::module& m)
     {
     py::class_<TwoStepNVE, IntegrationMethodTwoStep, std::shared_ptr<TwoStepNVE> >(m, "TwoStepNVE")
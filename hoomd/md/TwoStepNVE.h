@@ -55,6 +55,15 @@ class PYBIND11_EXPORT TwoStepNVE : public IntegrationMethodTwoStep
         //! Performs the second step of the integration
         virtual void integrateStepTwo(unsigned int timestep);
 
+        //! Performs the second step of the previous time step and the first step of this one in one pass
+        virtual void integrateFusedStep(unsigned int timestep);
+
+        //! The fused step is implemented for the translational degrees of freedom
+        virtual bool hasFusedStep()
+            {
+            return !m_aniso;
+            }
+
     protected:
         bool m_limit;       //!< True if we should limit the distance a particle moves in one step
         Scalar m_limit_val; //!< The maximum distance a particle is to move in one step
@@ -383,6 +383,87 @@ void TwoStepNVTMTK::integrateStepTwo(unsigned int timestep)
         m_prof->pop();
     }
 
+/*! \param timestep Current time step
+    \post Particle velocities are moved forward from timestep-1/2 to timestep+1/2 and positions to timestep+1
+
+    Equivalent to integrateStepTwo(timestep-1) followed by integrateStepOne(timestep) for isotropic integration, but
+    each particle is read and written once. Both halves rescale the velocities with the same thermostat factor, which
+    is only advanced at the end of the first step.
+*/
+void TwoStepNVTMTK::integrateFusedStep(unsigned int timestep)
+    {
+    if (m_aniso)
+        {
+        IntegrationMethodTwoStep::integrateFusedStep(timestep);
+        return;
+        }
+
+    if (m_group->getNumMembersGlobal() == 0)
+        {
+        m_exec_conf->msg->error() << "integrate.nvt(): Integration group empty." << std::endl;
+        throw std::runtime_error("Error during NVT integration.");
+        }
+
+    unsigned int group_size = m_group->getNumMembers();
+
+    // profile this step
+    if (m_prof)
+        m_prof->push("NVT fused step");
+
+    // scope array handles for proper releasing before calling the thermo compute
+    {
+    ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar3> h_accel(m_pdata->getAccelerations(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::readwrite);
+    ArrayHandle<int3> h_image(m_pdata->getImages(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar4> h_net_force(m_pdata->getNetForce(), access_location::host, access_mode::read);
+
+    const BoxDim& box = m_pdata->getBox();
+
+    for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
+        {
+        unsigned int j = m_group->getMemberIndex(group_idx);
+
+        // load variables
+        Scalar3 v = make_scalar3(h_vel.data[j].x, h_vel.data[j].y, h_vel.data[j].z);
+        Scalar3 pos = make_scalar3(h_pos.data[j].x, h_pos.data[j].y, h_pos.data[j].z);
+        Scalar3 net_force = make_scalar3(h_net_force.data[j].x,h_net_force.data[j].y,h_net_force.data[j].z);
+
+        // second half step of the previous time step
+        Scalar m = h_vel.data[j].w;
+        Scalar minv = Scalar(1.0) / m;
+        Scalar3 accel = net_force*minv;
+
+        v *= m_exp_thermo_fac;
+        v += Scalar(1.0/2.0) * m_deltaT * accel;
+
+        // first half step of this time step
+        v = v + Scalar(1.0/2.0)*accel*m_deltaT;
+        v *= m_exp_thermo_fac;
+        pos += m_deltaT * v;
+
+        // store updated variables
+        h_vel.data[j].x = v.x;
+        h_vel.data[j].y = v.y;
+        h_vel.data[j].z = v.z;
+
+        h_pos.data[j].x = pos.x;
+        h_pos.data[j].y = pos.y;
+        h_pos.data[j].z = pos.z;
+        box.wrap(h_pos.data[j], h_image.data[j]);
+
+        h_accel.data[j] = accel;
+        }
+    }
+
+    // get temperature and advance thermostat
+    advanceThermostat(timestep);
+
+    // done profiling
+    if (m_prof)
+        m_prof->pop();
+    }
+
 void TwoStepNVTMTK::advanceThermostat(unsigned int timestep, bool broadcast)
     {
     IntegratorVariables v = getIntegratorVariables();
@@ -97,6 +97,15 @@ class PYBIND11_EXPORT TwoStepNVTMTK : public IntegrationMethodTwoStep
         //! Performs the second step of the integration
         virtual void integrateStepTwo(unsigned int timestep);
 
+        //! Performs the second step of the previous time step and the first step of this one in one pass
+        virtual void integrateFusedStep(unsigned int timestep);
+
+        //! The fused step is implemented for the translational degrees of freedom
+        virtual bool hasFusedStep()
+            {
+            return !m_aniso;
+            }
+
         //! Get needed pdata flags
         /*! in anisotropic mode, we need the rotational kinetic energy
         */
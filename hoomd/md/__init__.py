@@ -7,6 +7,7 @@
 Perform Molecular Dynamics simulations with HOOMD-blue.
 """
 
+from hoomd.md import analyze
 from hoomd.md import angle
 from hoomd.md import bond
 from hoomd.md import charge
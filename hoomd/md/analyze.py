@@ -0,0 +1,355 @@
+# Copyright (c) 2009-2021 The Regents of the University of Michigan
+# This file is part of the HOOMD-blue project, released under the BSD 3-Clause
+# License.
+
+"""Analyze the system during the simulation."""
+
+import numpy as np
+
+import hoomd
+from hoomd.md import _md
+from hoomd.md.nlist import NList
+from hoomd.data.parameterdicts import ParameterDict
+from hoomd.data.typeconverter import OnlyType
+from hoomd.filter import ParticleFilter, All
+from hoomd.operation import Writer
+from hoomd.trigger import Periodic
+
+
+class Structure(Writer):
+    r"""Accumulate radial distribution functions and the structure factor.
+
+    Args:
+        trigger (hoomd.trigger.Trigger): Select the timesteps to analyze.
+        nlist (`hoomd.md.nlist.NList`): Neighbor list.
+        r_max (float): Maximum pair distance :math:`[\mathrm{length}]`.
+        bins (int): Number of radial bins. Defaults to 100.
+        grid (int): Number of mesh points along each box vector used to
+            compute the structure factor. Defaults to 32.
+
+    `Structure` accumulates the radial distribution function
+    :math:`g_{ab}(r)` of every unordered pair of particle types and the static
+    structure factor :math:`S(q)` of all particles each time it triggers. The
+    results are averages over all analyzed frames.
+
+    :math:`g_{ab}(r)` is histogrammed from the pairs in *nlist*, so the pair
+    search is shared with the pair potentials that use the same neighbor list.
+    `Structure` adds *r_max* to the cutoffs of *nlist*, which increases the
+    cost of the neighbor list when *r_max* exceeds the pair potential cutoffs.
+    Pairs excluded from *nlist* (e.g. bonded pairs) do not contribute.
+
+    :math:`S(q)` is computed from the particle density on a *grid* :sup:`3`
+    mesh (*grid* :sup:`2` in 2D) with a fast Fourier transform and averaged
+    over shells of width :math:`\min_i |\vec{b}_i|`, where :math:`\vec{b}_i`
+    are the reciprocal lattice vectors of the box at the first analyzed
+    frame. Only wave numbers below the Nyquist wave number of the mesh are
+    reported.
+
+    Note:
+        With MPI domain decomposition, the accumulated histograms are reduced
+        across ranks when the results are accessed. Access the results on all
+        ranks.
+
+    Example::
+
+        nl = hoomd.md.nlist.Cell()
+        structure = hoomd.md.analyze.Structure(
+            trigger=hoomd.trigger.Periodic(1000), nlist=nl, r_max=4.0)
+        sim.operations.writers.append(structure)
+        sim.run(100000)
+        g_AA = structure.rdf[('A', 'A')]
+
+    Attributes:
+        trigger (hoomd.trigger.Trigger): Select the timesteps to analyze.
+        nlist (`hoomd.md.nlist.NList`): Neighbor list.
+        r_max (float): Maximum pair distance :math:`[\mathrm{length}]`.
+        bins (int): Number of radial bins.
+        grid (int): Number of mesh points along each box vector.
+    """
+
+    def __init__(self, trigger, nlist, r_max, bins=100, grid=32):
+        super().__init__(trigger)
+
+        self._nlist = OnlyType(NList)(nlist)
+        self._param_dict.update(
+            ParameterDict(r_max=float(r_max), bins=int(bins), grid=int(grid)))
+
+    def _attach(self):
+        if not self._nlist._added:
+            self._nlist._add(self._simulation)
+        else:
+            if self._simulation != self._nlist._simulation:
+                raise RuntimeError("{} object's neighbor list is used in a "
+                                   "different simulation.".format(type(self)))
+        if not self.nlist._attached:
+            self.nlist._attach()
+
+        self._cpp_obj = _md.StructureAnalyzer(
+            self._simulation.state._cpp_sys_def, self.nlist._cpp_obj,
+            self.r_max, self.bins, self.grid)
+        super()._attach()
+
+    @property
+    def nlist(self):
+        return self._nlist
+
+    @nlist.setter
+    def nlist(self, value):
+        if self._attached:
+            raise RuntimeError("nlist cannot be set after scheduling.")
+        else:
+            self._nlist = OnlyType(NList)(value)
+
+    @property
+    def _children(self):
+        return [self.nlist]
+
+    @property
+    def num_frames(self):
+        """int: Number of frames accumulated."""
+        if not self._attached:
+            return 0
+        return self._cpp_obj.num_frames
+
+    @property
+    def bin_centers(self):
+        """(*bins*, ) `numpy.ndarray` of ``numpy.float64``: Centers of the \
+        radial bins :math:`[\\mathrm{length}]`."""
+        dr = self.r_max / self.bins
+        return (np.arange(self.bins) + 0.5) * dr
+
+    @property
+    def rdf(self):
+        """dict[tuple[str, str], numpy.ndarray]: Radial distribution \
+        functions.
+
+        The keys are the unordered pairs of type names ``(a, b)`` with ``a``
+        before ``b`` in the list of types. Each value is a (*bins*, ) array.
+        `None` when no frames have been accumulated.
+        """
+        if self.num_frames == 0:
+            return None
+
+        types = self._simulation.state.particle_types
+        rdf = np.array(self._cpp_obj.getRDF()).reshape(-1, self.bins)
+        pairs = [(a, b)
+                 for i, a in enumerate(types)
+                 for b in types[i:]]
+        return {pair: rdf[i] for i, pair in enumerate(pairs)}
+
+    @property
+    def q(self):
+        """(*N_q*, ) `numpy.ndarray` of ``numpy.float64``: Centers of the wave \
+        number bins :math:`[\\mathrm{length}^{-1}]`.
+
+        `None` when no frames have been accumulated.
+        """
+        if self.num_frames == 0:
+            return None
+        return np.array(self._cpp_obj.getQ())
+
+    @property
+    def structure_factor(self):
+        """(*N_q*, ) `numpy.ndarray` of ``numpy.float64``: Static structure \
+        factor :math:`S(q)` in each wave number bin.
+
+        `None` when no frames have been accumulated.
+        """
+        if self.num_frames == 0:
+            return None
+        return np.array(self._cpp_obj.getStructureFactor())
+
+    def reset(self):
+        """Discard all accumulated frames."""
+        if self._attached:
+            self._cpp_obj.reset()
+
+
+class Correlator(Writer):
+    r"""Accumulate time correlation functions with multiple-tau correlators.
+
+    Args:
+        period (int): Number of time steps between samples.
+        filter (hoomd.filter.ParticleFilter): Select the particles for the
+            mean squared displacement and the velocity autocorrelation.
+            Defaults to `hoomd.filter.All`.
+        quantities (list[str]): Correlation functions to accumulate, any of
+            ``'msd'``, ``'vacf'``, and ``'stress'``. Defaults to
+            ``['msd', 'vacf']``.
+        points_per_level (int): Number of lags in each correlator level.
+            Defaults to 16.
+        averaging (int): Number of samples averaged when moving to the next
+            level. Must divide *points_per_level*. Defaults to 2.
+
+    `Correlator` samples the system every *period* time steps and accumulates
+    the following correlation functions at lags :math:`\tau`:
+
+    * ``'msd'``: the mean squared displacement
+      :math:`\langle |\vec{r}_i(t + \tau) - \vec{r}_i(t)|^2 \rangle` of the
+      selected particles, using the unwrapped positions.
+    * ``'vacf'``: the velocity autocorrelation function
+      :math:`\langle \vec{v}_i(t) \cdot \vec{v}_i(t + \tau) \rangle` of
+      the selected particles.
+    * ``'stress'``: the autocorrelation function
+      :math:`\langle P_{\alpha\beta}(t) P_{\alpha\beta}(t + \tau) \rangle`
+      of the pressure tensor of all particles, averaged over the off-diagonal
+      components :math:`xy`, :math:`xz`, and :math:`yz` (only :math:`xy` in
+      2D). The shear viscosity follows from the Green-Kubo relation
+      :math:`\eta = \frac{V}{kT} \int_0^\infty \langle P_{xy}(0)
+      P_{xy}(\tau) \rangle d\tau`.
+
+    The correlators use the multiple-tau block averaging scheme: the first
+    level correlates the last *points_per_level* samples at full resolution.
+    Each further level correlates block averages of *averaging* samples of
+    the previous level, so the lags grow geometrically up to the length of the
+    run while the memory only grows logarithmically with the number of
+    samples. The correlation functions are kept in memory; no trajectory needs
+    to be written.
+
+    The set of selected particles is fixed when `Correlator` is attached.
+    The trigger must be a `hoomd.trigger.Periodic` trigger, and its period
+    cannot change after `Correlator` is attached.
+
+    Note:
+        With MPI domain decomposition, each rank correlates a fixed subset of
+        the selected particles and the results are reduced across ranks when
+        they are accessed. Access the results on all ranks.
+
+    Example::
+
+        correlator = hoomd.md.analyze.Correlator(
+            period=10, quantities=['msd', 'stress'])
+        sim.operations.writers.append(correlator)
+        sim.run(1000000)
+        t = correlator.lags * sim.operations.integrator.dt
+        msd = correlator.msd
+
+    Attributes:
+        trigger (hoomd.trigger.Periodic): Select the time steps on which to
+            sample the system.
+        filter (hoomd.filter.ParticleFilter): Select the particles for the
+            mean squared displacement and the velocity autocorrelation.
+        points_per_level (int): Number of lags in each correlator level.
+        averaging (int): Number of samples averaged when moving to the next
+            level.
+    """
+
+    _valid_quantities = ('msd', 'vacf', 'stress')
+
+    def __init__(self,
+                 period,
+                 filter=All(),
+                 quantities=('msd', 'vacf'),
+                 points_per_level=16,
+                 averaging=2):
+        super().__init__(Periodic(int(period)))
+
+        quantities = tuple(quantities)
+        for quantity in quantities:
+            if quantity not in self._valid_quantities:
+                raise ValueError(f"Correlator cannot compute {quantity}.")
+        self._quantities = quantities
+
+        self._param_dict.update(
+            ParameterDict(filter=ParticleFilter,
+                          points_per_level=int(points_per_level),
+                          averaging=int(averaging),
+                          _defaults=dict(filter=filter)))
+
+    def _attach(self):
+        state = self._simulation.state
+        thermo = None
+        if 'stress' in self._quantities:
+            if isinstance(self._simulation.device, hoomd.device.CPU):
+                thermo_cls = _md.ComputeThermo
+            else:
+                thermo_cls = _md.ComputeThermoGPU
+            thermo = thermo_cls(state._cpp_sys_def, state._get_group(All()),
+                                "")
+
+        self._cpp_obj = _md.TimeCorrelator(state._cpp_sys_def,
+                                           state._get_group(self.filter),
+                                           thermo, self.period,
+                                           self.points_per_level,
+                                           self.averaging, 'msd'
+                                           in self._quantities, 'vacf'
+                                           in self._quantities)
+        super()._attach()
+
+    @Writer.trigger.setter
+    def trigger(self, new_trigger):
+        if not isinstance(new_trigger, Periodic):
+            raise ValueError("Correlator requires a hoomd.trigger.Periodic "
+                             "trigger.")
+        if self._attached and new_trigger.period != self.period:
+            raise RuntimeError("The period of Correlator cannot change after "
+                               "it is attached.")
+        Writer.trigger.fset(self, new_trigger)
+
+    @property
+    def period(self):
+        """int: Number of time steps between samples (read only)."""
+        return self.trigger.period
+
+    @property
+    def quantities(self):
+        """tuple[str]: Correlation functions to accumulate."""
+        return self._quantities
+
+    @property
+    def num_samples(self):
+        """int: Number of samples taken."""
+        if not self._attached:
+            return 0
+        return self._cpp_obj.num_samples
+
+    @property
+    def lags(self):
+        """(*N_lags*, ) `numpy.ndarray` of ``numpy.uint32``: Lags of the \
+        correlation functions :math:`[\\mathrm{time\\ steps}]`.
+
+        Only lags that have been sampled at least once are included. `None`
+        when no samples have been taken.
+        """
+        if self.num_samples == 0:
+            return None
+        return np.array(self._cpp_obj.getLags(), dtype=np.uint32)
+
+    def _correlation(self, quantity, getter):
+        if self.num_samples == 0 or quantity not in self._quantities:
+            return None
+        return np.array(getattr(self._cpp_obj, getter)())
+
+    @property
+    def msd(self):
+        """(*N_lags*, ) `numpy.ndarray` of ``numpy.float64``: Mean squared \
+        displacement :math:`[\\mathrm{length}^2]`.
+
+        `None` when ``'msd'`` is not computed or no samples have been taken.
+        """
+        return self._correlation('msd', 'getMSD')
+
+    @property
+    def vacf(self):
+        """(*N_lags*, ) `numpy.ndarray` of ``numpy.float64``: Velocity \
+        autocorrelation function :math:`[\\mathrm{velocity}^2]`.
+
+        `None` when ``'vacf'`` is not computed or no samples have been taken.
+        """
+        return self._correlation('vacf', 'getVACF')
+
+    @property
+    def stress_acf(self):
+        """(*N_lags*, ) `numpy.ndarray` of ``numpy.float64``: Autocorrelation \
+        function of the off-diagonal pressure tensor components \
+        :math:`[\\mathrm{pressure}^2]`.
+
+        `None` when ``'stress'`` is not computed or no samples have been
+        taken.
+        """
+        return self._correlation('stress', 'getStressACF')
+
+    def reset(self):
+        """Discard all samples."""
+        if self._attached:
+            self._cpp_obj.reset()
@@ -0,0 +1,262 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+/*! \file benchmark_md.cc
+    \brief Benchmarks neighbor list builds, pair potentials and PPPM
+*/
+
+// this include is necessary to get MPI included before anything else to support intel MPI
+#include "hoomd/ExecutionConfiguration.h"
+
+#include "hoomd/SystemDefinition.h"
+#include "hoomd/filter/ParticleFilterAll.h"
+#include "hoomd/md/AllPairPotentials.h"
+#include "hoomd/md/NeighborListBinned.h"
+#include "hoomd/md/NeighborListStencil.h"
+#include "hoomd/md/NeighborListTree.h"
+#include "hoomd/md/PPPMForceCompute.h"
+
+#ifdef ENABLE_HIP
+#include "hoomd/md/NeighborListGPUBinned.h"
+#include "hoomd/md/NeighborListGPUStencil.h"
+#include "hoomd/md/NeighborListGPUTree.h"
+#include "hoomd/md/PPPMForceComputeGPU.h"
+#endif
+
+#include "hoomd/benchmarks/benchmark.h"
+
+using namespace std;
+
+//! Global runner of the benchmarks in this executable
+BenchmarkRunner benchmarks("md");
+
+HOOMD_UP_MAIN();
+
+//! Densities of the benchmark configurations
+const std::vector<Scalar> densities = {Scalar(0.3), Scalar(0.85)};
+
+//! Pair cutoff of all benchmarks
+const Scalar r_cut = Scalar(2.5);
+
+//! Neighbor list buffer of all benchmarks
+const Scalar r_buff = Scalar(0.4);
+
+//! Count the pairs in a neighbor list
+double count_pairs(std::shared_ptr<NeighborList> nlist, unsigned int N)
+    {
+    ArrayHandle<unsigned int> h_n_neigh(nlist->getNNeighArray(), access_location::host, access_mode::read);
+    double pairs = 0;
+    for (unsigned int i = 0; i < N; i++)
+        pairs += h_n_neigh.data[i];
+    return pairs;
+    }
+
+//! Construct a neighbor list of the given type with the benchmark cutoff
+template<class NL>
+std::shared_ptr<NeighborList> make_nlist(std::shared_ptr<SystemDefinition> sysdef, bool exclude_bonds)
+    {
+    std::shared_ptr<NeighborList> nlist(new NL(sysdef, r_cut, r_buff));
+    if (exclude_bonds)
+        nlist->addExclusionsFromBonds();
+    return nlist;
+    }
+
+//! Call a benchmark with every configuration
+/*! \param exec_conf Execution configuration to construct the systems with
+    \param polymers Set to true to include the polymer configurations
+    \param f Benchmark taking the system definition, the name of the configuration and its parameters
+*/
+template<class F>
+void for_each_configuration(std::shared_ptr<ExecutionConfiguration> exec_conf, bool polymers, F f)
+    {
+    const unsigned int chain_length = 32;
+    for (unsigned int N : benchmarks.sizes())
+        {
+        for (Scalar density : densities)
+            {
+            std::vector<std::pair<std::string, double> > params = {{"density", density}};
+            std::shared_ptr<SystemDefinition> lj(new SystemDefinition(make_lattice_snapshot(N, density), exec_conf));
+            lj->getParticleData()->setFlags(~PDataFlags(0));
+            f(lj, "lj", params);
+
+            if (!polymers)
+                continue;
+
+            std::vector<std::pair<std::string, double> > polymer_params = {{"density", density},
+                                                                           {"chain_length", double(chain_length)}};
+            std::shared_ptr<SystemDefinition> polymer(new SystemDefinition(
+                make_polymer_snapshot(N, density, chain_length), exec_conf));
+            polymer->getParticleData()->setFlags(~PDataFlags(0));
+            f(polymer, "polymer", polymer_params);
+            }
+        }
+    }
+
+//! Benchmark a neighbor list build
+template<class NL>
+void nlist_benchmark(std::shared_ptr<ExecutionConfiguration> exec_conf, const std::string& name)
+    {
+    for_each_configuration(exec_conf, true, [&](std::shared_ptr<SystemDefinition> sysdef,
+                                                const std::string& config,
+                                                const std::vector<std::pair<std::string, double> >& params)
+        {
+        if (!benchmarks.selected(name, config))
+            return;
+
+        std::shared_ptr<NeighborList> nlist = make_nlist<NL>(sysdef, sysdef->getBondData()->getNGlobal() > 0);
+        auto r_cut_matrix = std::make_shared<GlobalArray<Scalar> >(nlist->getTypePairIndexer().getNumElements(),
+                                                                    exec_conf);
+            {
+            ArrayHandle<Scalar> h_r_cut(*r_cut_matrix, access_location::host, access_mode::overwrite);
+            h_r_cut.data[0] = r_cut;
+            }
+        nlist->addRCutMatrix(r_cut_matrix);
+        nlist->compute(0);
+
+        unsigned int N = sysdef->getParticleData()->getN();
+        double pairs = count_pairs(nlist, N);
+        UP_ASSERT(pairs > 0);
+        benchmarks.run(exec_conf, name, config, params, N, pairs,
+                       [nlist](unsigned int n) { return nlist->benchmark(n); });
+        });
+    }
+
+//! Benchmark a pair potential force evaluation, excluding the neighbor list build
+template<class Potential, class NL>
+void pair_benchmark(std::shared_ptr<ExecutionConfiguration> exec_conf, const std::string& name,
+                    const typename Potential::param_type& param)
+    {
+    for_each_configuration(exec_conf, true, [&](std::shared_ptr<SystemDefinition> sysdef,
+                                                const std::string& config,
+                                                const std::vector<std::pair<std::string, double> >& params)
+        {
+        if (!benchmarks.selected(name, config))
+            return;
+
+        std::shared_ptr<NeighborList> nlist = make_nlist<NL>(sysdef, sysdef->getBondData()->getNGlobal() > 0);
+        std::shared_ptr<Potential> pair(new Potential(sysdef, nlist));
+        pair->setParams(0, 0, param);
+        pair->setRcut(0, 0, r_cut);
+        pair->compute(0);
+
+        unsigned int N = sysdef->getParticleData()->getN();
+        benchmarks.run(exec_conf, name, config, params, N, count_pairs(nlist, N),
+                       [pair](unsigned int n) { return pair->benchmark(n); });
+        });
+    }
+
+//! Benchmark PPPM on a charge neutral system
+template<class PPPM, class NL>
+void pppm_benchmark(std::shared_ptr<ExecutionConfiguration> exec_conf, const std::string& name)
+    {
+    for_each_configuration(exec_conf, false, [&](std::shared_ptr<SystemDefinition> sysdef,
+                                                 const std::string& config,
+                                                 std::vector<std::pair<std::string, double> > params)
+        {
+        if (!benchmarks.selected(name, config))
+            return;
+
+        std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+            {
+            ArrayHandle<Scalar> h_charge(pdata->getCharges(), access_location::host, access_mode::overwrite);
+            ArrayHandle<unsigned int> h_tag(pdata->getTags(), access_location::host, access_mode::read);
+            for (unsigned int i = 0; i < pdata->getN(); i++)
+                h_charge.data[i] = (h_tag.data[i] % 2) ? Scalar(1.0) : Scalar(-1.0);
+            }
+
+        // a grid spacing of about one particle diameter
+        unsigned int grid = 1;
+        while (Scalar(grid) < pdata->getGlobalBox().getL().x)
+            grid *= 2;
+        params.push_back(std::make_pair("grid", double(grid)));
+
+        std::shared_ptr<NeighborList> nlist = make_nlist<NL>(sysdef, false);
+        std::shared_ptr<ParticleGroup> group(new ParticleGroup(sysdef,
+            std::shared_ptr<ParticleFilter>(new ParticleFilterAll())));
+        std::shared_ptr<PPPMForceCompute> pppm(new PPPM(sysdef, nlist, group));
+        pppm->setParams(grid, grid, grid, 5, Scalar(1.0), r_cut);
+        pppm->compute(0);
+
+        benchmarks.run(exec_conf, name, config, params, pdata->getN(), 0,
+                       [pppm](unsigned int n) { return pppm->benchmark(n); });
+        });
+    }
+
+UP_TEST( NeighborListBinned_benchmark )
+    {
+    nlist_benchmark<NeighborListBinned>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)), "NeighborListBinned");
+    }
+
+UP_TEST( NeighborListStencil_benchmark )
+    {
+    nlist_benchmark<NeighborListStencil>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)), "NeighborListStencil");
+    }
+
+UP_TEST( NeighborListTree_benchmark )
+    {
+    nlist_benchmark<NeighborListTree>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)), "NeighborListTree");
+    }
+
+UP_TEST( PotentialPairLJ_benchmark )
+    {
+    pair_benchmark<PotentialPairLJ, NeighborListBinned>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)), "PotentialPairLJ",
+                                                        EvaluatorPairLJ::param_type(Scalar(1.0), Scalar(1.0)));
+    }
+
+UP_TEST( PotentialPairGauss_benchmark )
+    {
+    pair_benchmark<PotentialPairGauss, NeighborListBinned>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)), "PotentialPairGauss",
+                                                           EvaluatorPairGauss::param_type(Scalar(1.0), Scalar(1.0)));
+    }
+
+UP_TEST( PotentialPairYukawa_benchmark )
+    {
+    pair_benchmark<PotentialPairYukawa, NeighborListBinned>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)), "PotentialPairYukawa",
+                                                            EvaluatorPairYukawa::param_type(Scalar(1.0), Scalar(1.0)));
+    }
+
+UP_TEST( PPPMForceCompute_benchmark )
+    {
+    pppm_benchmark<PPPMForceCompute, NeighborListBinned>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)), "PPPMForceCompute");
+    }
+
+#ifdef ENABLE_HIP
+UP_TEST( NeighborListGPUBinned_benchmark )
+    {
+    nlist_benchmark<NeighborListGPUBinned>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU)), "NeighborListGPUBinned");
+    }
+
+UP_TEST( NeighborListGPUStencil_benchmark )
+    {
+    nlist_benchmark<NeighborListGPUStencil>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU)), "NeighborListGPUStencil");
+    }
+
+UP_TEST( NeighborListGPUTree_benchmark )
+    {
+    nlist_benchmark<NeighborListGPUTree>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU)), "NeighborListGPUTree");
+    }
+
+UP_TEST( PotentialPairLJGPU_benchmark )
+    {
+    pair_benchmark<PotentialPairLJGPU, NeighborListGPUBinned>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU)), "PotentialPairLJGPU",
+                                                              EvaluatorPairLJ::param_type(Scalar(1.0), Scalar(1.0)));
+    }
+
+UP_TEST( PotentialPairGaussGPU_benchmark )
+    {
+    pair_benchmark<PotentialPairGaussGPU, NeighborListGPUBinned>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU)), "PotentialPairGaussGPU",
+                                                                 EvaluatorPairGauss::param_type(Scalar(1.0), Scalar(1.0)));
+    }
+
+UP_TEST( PotentialPairYukawaGPU_benchmark )
+    {
+    pair_benchmark<PotentialPairYukawaGPU, NeighborListGPUBinned>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU)), "PotentialPairYukawaGPU",
+                                                                  EvaluatorPairYukawa::param_type(Scalar(1.0), Scalar(1.0)));
+    }
+
+UP_TEST( PPPMForceComputeGPU_benchmark )
+    {
+    pppm_benchmark<PPPMForceComputeGPU, NeighborListGPUBinned>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU)), "PPPMForceComputeGPU");
+    }
+#endif
@@ -117,6 +117,19 @@ class Integrator(_DynamicIntegrator):
             constraint forces applied to the particles in the system.
             The default value of ``None`` initializes an empty list.
 
+        fuse_steps (bool): When True, complete each time step together with
+            the start of the next one on the CPU when possible (default: False).
+
+    When ``fuse_steps`` is True and no analyzer, updater, or tuner runs on the
+    next time step, the second half step velocity update is deferred and
+    performed in the same pass over the particles as the first half step of the
+    next time step. This reduces the memory traffic of the integration methods
+    by about one half. The trajectory is unchanged, and the velocities are
+    always at the full step when any other operation accesses the system or the
+    run ends. Only `hoomd.md.methods.NVE`, `hoomd.md.methods.Langevin`, and
+    `hoomd.md.methods.NVT` implement the fused step, and only for
+    isotropic integration. The integrator uses the normal two step path when
+    any method does not, or when running on the GPU.
 
     The following classes can be used as elements in `methods`
 
@@ -168,10 +181,13 @@ class Integrator(_DynamicIntegrator):
 
         constraints (List[hoomd.md.constrain.ConstraintForce]): List of
             constraint forces applied to the particles in the system.
+
+        fuse_steps (bool): Whether to complete each time step together with
+            the start of the next one when possible.
     """
 
     def __init__(self, dt, aniso='auto', forces=None, constraints=None,
-                 methods=None):
+                 methods=None, fuse_steps=False):
 
         super().__init__(forces, constraints, methods)
 
@@ -179,6 +195,7 @@ class Integrator(_DynamicIntegrator):
             dt=float(dt),
             aniso=OnlyFrom(['true', 'false', 'auto'],
                            preprocess=_preprocess_aniso),
+            fuse_steps=bool(fuse_steps),
             _defaults=dict(aniso="auto")
             )
         if aniso is not None:
@@ -45,10 +45,12 @@
 #include "PotentialTersoff.h"
 #include "PPPMForceCompute.h"
 #include "QuaternionMath.h"
+#include "StructureAnalyzer.h"
 #include "TableAngleForceCompute.h"
 #include "TableDihedralForceCompute.h"
 #include "TablePotential.h"
 #include "TempRescaleUpdater.h"
+#include "TimeCorrelator.h"
 #include "TwoStepBD.h"
 #include "TwoStepBerendsen.h"
 #include "TwoStepLangevinBase.h"
@@ -301,6 +303,8 @@ PYBIND11_MODULE(_md, m)
     export_ForceDistanceConstraint(m);
     export_ForceComposite(m);
     export_PPPMForceCompute(m);
+    export_StructureAnalyzer(m);
+    export_TimeCorrelator(m);
     py::class_< wall_type, std::shared_ptr<wall_type> >(m, "wall_type")
         .def(py::init<>());
     m.def("make_wall_field_params", &make_wall_field_params);
@@ -0,0 +1,105 @@
+import hoomd
+import numpy as np
+import pytest
+
+
+def test_before_attaching():
+    correlator = hoomd.md.analyze.Correlator(period=10)
+    assert correlator.period == 10
+    assert correlator.trigger.period == 10
+    assert correlator.quantities == ('msd', 'vacf')
+    assert correlator.points_per_level == 16
+    assert correlator.averaging == 2
+    assert correlator.num_samples == 0
+    assert correlator.lags is None
+    assert correlator.msd is None
+
+    with pytest.raises(ValueError):
+        hoomd.md.analyze.Correlator(period=10, quantities=['viscosity'])
+
+
+def test_trigger():
+    correlator = hoomd.md.analyze.Correlator(period=10)
+
+    # the period follows the trigger and cannot be set directly
+    correlator.trigger = hoomd.trigger.Periodic(5)
+    assert correlator.period == 5
+    with pytest.raises(AttributeError):
+        correlator.period = 20
+
+    with pytest.raises(ValueError):
+        correlator.trigger = hoomd.trigger.Before(100)
+    assert correlator.period == 5
+
+
+def test_invalid_parameters(simulation_factory, lattice_snapshot_factory):
+    sim = simulation_factory(lattice_snapshot_factory())
+    correlator = hoomd.md.analyze.Correlator(period=1,
+                                             points_per_level=10,
+                                             averaging=3)
+    sim.operations.writers.append(correlator)
+    with pytest.raises(ValueError):
+        sim.run(1)
+
+
+def test_ballistic(simulation_factory, lattice_snapshot_factory):
+    snap = lattice_snapshot_factory(n=4)
+    if snap.exists:
+        snap.particles.velocity[:] = [1, 0, 0]
+    sim = simulation_factory(snap)
+
+    dt = 0.005
+    nve = hoomd.md.methods.NVE(filter=hoomd.filter.All())
+    sim.operations.integrator = hoomd.md.Integrator(dt, methods=[nve])
+    correlator = hoomd.md.analyze.Correlator(period=2,
+                                             points_per_level=8,
+                                             averaging=2)
+    sim.operations.writers.append(correlator)
+    sim.run(400)
+
+    assert correlator.num_samples == 200
+    lags = correlator.lags
+    assert lags[0] == 0
+    assert np.all(np.diff(lags) > 0)
+    assert lags[-1] > 100
+    assert lags[-1] % 2 == 0
+
+    # the block averages of a linear trajectory are linear
+    msd = correlator.msd
+    assert msd.shape == lags.shape
+    np.testing.assert_allclose(msd, (lags * dt)**2, rtol=1e-3, atol=1e-8)
+    np.testing.assert_allclose(correlator.vacf, 1, rtol=1e-5)
+    assert correlator.stress_acf is None
+
+    correlator.reset()
+    assert correlator.num_samples == 0
+    assert correlator.lags is None
+
+    # the period cannot change once the correlator is attached
+    with pytest.raises(RuntimeError):
+        correlator.trigger = hoomd.trigger.Periodic(3)
+    correlator.trigger = hoomd.trigger.Periodic(2, phase=1)
+
+
+def test_stress(simulation_factory, lattice_snapshot_factory):
+    sim = simulation_factory(lattice_snapshot_factory(n=5, a=1.2, r=0.05))
+
+    nlist = hoomd.md.nlist.Cell()
+    lj = hoomd.md.pair.LJ(nlist=nlist, r_cut=2.5)
+    lj.params[('A', 'A')] = dict(epsilon=1, sigma=1)
+    nve = hoomd.md.methods.NVE(filter=hoomd.filter.All())
+    sim.operations.integrator = hoomd.md.Integrator(0.005,
+                                                    methods=[nve],
+                                                    forces=[lj])
+    correlator = hoomd.md.analyze.Correlator(period=1, quantities=['stress'])
+    sim.operations.writers.append(correlator)
+    sim.run(50)
+
+    lags = correlator.lags
+    stress_acf = correlator.stress_acf
+    assert correlator.msd is None
+    assert stress_acf.shape == lags.shape
+    assert np.all(np.isfinite(stress_acf))
+
+    # the autocorrelation at zero lag is the mean square stress
+    assert stress_acf[0] > 0
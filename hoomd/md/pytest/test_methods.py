@@ -547,3 +547,43 @@ def test_nvt_thermalize_thermostat_aniso_dof(simulation_factory,
     xi_rot, eta_rot = nvt.rotational_thermostat_dof
     assert xi_rot != 0.0
     assert eta_rot == 0.0
+
+
+_fused_step_methods = [
+    lambda: hoomd.md.methods.NVE(filter=hoomd.filter.All()),
+    lambda: hoomd.md.methods.Langevin(filter=hoomd.filter.All(), kT=1.5,
+                                      seed=2),
+    lambda: hoomd.md.methods.NVT(filter=hoomd.filter.All(), kT=1.5, tau=0.5),
+]
+
+
+@pytest.mark.parametrize("make_method", _fused_step_methods)
+def test_fuse_steps(simulation_factory, lattice_snapshot_factory, make_method):
+    """Test that fused steps reproduce the two step trajectory."""
+    snap = lattice_snapshot_factory(n=6, a=1.2, r=0.05)
+
+    snapshots = []
+    for fuse_steps in [False, True]:
+        cell = hoomd.md.nlist.Cell()
+        lj = hoomd.md.pair.LJ(nlist=cell)
+        lj.params[('A', 'A')] = dict(sigma=1.0, epsilon=1.0)
+        lj.r_cut[('A', 'A')] = 2.5
+
+        sim = simulation_factory(snap)
+        sim.operations.integrator = hoomd.md.Integrator(
+            dt=0.005,
+            methods=[make_method()],
+            forces=[lj],
+            fuse_steps=fuse_steps)
+        assert sim.operations.integrator.fuse_steps == fuse_steps
+
+        sim.run(20)
+        snapshots.append(sim.state.snapshot)
+
+    if snapshots[0].exists:
+        numpy.testing.assert_allclose(snapshots[0].particles.position,
+                                      snapshots[1].particles.position,
+                                      rtol=1e-6)
+        numpy.testing.assert_allclose(snapshots[0].particles.velocity,
+                                      snapshots[1].particles.velocity,
+                                      rtol=1e-6)
@@ -0,0 +1,99 @@
+import hoomd
+import numpy as np
+import pytest
+
+
+def _make_structure(r_max, bins=40, grid=16):
+    nlist = hoomd.md.nlist.Cell()
+    return hoomd.md.analyze.Structure(trigger=hoomd.trigger.Periodic(1),
+                                      nlist=nlist,
+                                      r_max=r_max,
+                                      bins=bins,
+                                      grid=grid)
+
+
+def test_before_attaching():
+    structure = _make_structure(r_max=2.5)
+    assert structure.r_max == 2.5
+    assert structure.bins == 40
+    assert structure.grid == 16
+    assert structure.num_frames == 0
+    assert structure.rdf is None
+    assert structure.structure_factor is None
+    np.testing.assert_allclose(structure.bin_centers,
+                               (np.arange(40) + 0.5) * 2.5 / 40)
+
+
+def test_invalid_parameters(simulation_factory, lattice_snapshot_factory):
+    sim = simulation_factory(lattice_snapshot_factory(n=8))
+    sim.operations.writers.append(_make_structure(r_max=2.5, grid=1))
+    with pytest.raises(ValueError):
+        sim.run(1)
+
+
+def test_simple_cubic(simulation_factory, lattice_snapshot_factory):
+    sim = simulation_factory(lattice_snapshot_factory(n=8, a=1.0))
+    structure = _make_structure(r_max=2.5)
+    sim.operations.writers.append(structure)
+    sim.run(3)
+
+    assert structure.num_frames == 3
+    rdf = structure.rdf
+    assert list(rdf.keys()) == [('A', 'A')]
+    g = rdf[('A', 'A')]
+    assert g.shape == (40,)
+
+    # the integral of g(r) counts the neighbors in each shell
+    dr = 2.5 / 40
+    r_lo = np.arange(40) * dr
+    shell = 4 / 3 * np.pi * ((r_lo + dr)**3 - r_lo**3)
+    rho = (8**3 - 1) / 8**3
+    n_neigh = np.cumsum(rho * g * shell)
+    r = structure.bin_centers
+    for r_shell, n in [(1.2, 6), (1.5, 18), (1.8, 26), (2.1, 32)]:
+        np.testing.assert_allclose(n_neigh[r < r_shell][-1], n, rtol=1e-5)
+
+    # the first peak is at the lattice constant
+    assert r[np.argmax(g)] == pytest.approx(1.0, abs=dr)
+
+    # the lattice only scatters at wave vectors beyond the Nyquist limit
+    q = structure.q
+    sq = structure.structure_factor
+    assert len(q) == len(sq)
+    assert len(q) > 0
+    assert np.max(q) < 2 * np.pi
+    np.testing.assert_allclose(sq, 0, atol=1e-3)
+
+
+def test_type_pairs(simulation_factory, lattice_snapshot_factory):
+    snap = lattice_snapshot_factory(particle_types=['A', 'B'], n=8, a=1.0)
+    if snap.exists:
+        snap.particles.typeid[:] = np.arange(snap.particles.N) % 2
+    sim = simulation_factory(snap)
+    structure = _make_structure(r_max=2.5)
+    sim.operations.writers.append(structure)
+    sim.run(1)
+
+    rdf = structure.rdf
+    assert list(rdf.keys()) == [('A', 'A'), ('A', 'B'), ('B', 'B')]
+
+    # alternating types along z: the nearest neighbors along z are unlike
+    r = structure.bin_centers
+    first_shell = np.abs(r - 1.0) < 0.1
+    assert np.sum(rdf[('A', 'B')][first_shell]) > 0
+    assert np.sum(rdf[('A', 'A')][first_shell]) > 0
+
+
+def test_reset(simulation_factory, lattice_snapshot_factory):
+    sim = simulation_factory(lattice_snapshot_factory(n=8))
+    structure = _make_structure(r_max=2.5)
+    sim.operations.writers.append(structure)
+    sim.run(2)
+    assert structure.num_frames == 2
+
+    structure.reset()
+    assert structure.num_frames == 0
+    assert structure.rdf is None
+
+    sim.run(1)
+    assert structure.num_frames == 1
@@ -8,6 +8,12 @@
 
 #include <vector>
 
+#ifdef ENABLE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+#endif
+
 using namespace std;
 
 #include <stdexcept>
@@ -309,6 +315,11 @@ Scalar EAMForceCompute::getLogValue(const std::string &quantity, unsigned int ti
 /*! \post The EAM forces are computed for the given timestep. The neighborlist's
  compute method is called to ensure that it is up to date.
  \param timestep specifies the current time step of the simulation
+
+ The computation proceeds in three passes over the local particles: the electron density P, the embedding
+ function F(P) and its derivative dF/dP, and finally the pair forces. In MPI simulations, dF/dP of the ghost
+ particles is communicated between the second and third pass. With TBB enabled, each pass is threaded over
+ particles.
  */
 void EAMForceCompute::computeForces(unsigned int timestep)
     {
@@ -323,6 +334,31 @@ void EAMForceCompute::computeForces(unsigned int timestep)
     // to reduce computations at the cost of memory access complexity: set that flag now
     bool third_law = m_nlist->getStorageMode() == NeighborList::half;
 
+    #ifdef ENABLE_MPI
+    // densities and forces accumulated on ghost particles are not communicated back to their owners
+    if (third_law && m_comm)
+        {
+        m_exec_conf->msg->error() << "EAMForceCompute cannot handle a half neighborlist in multi-processor simulations"
+                                  << endl;
+        throw runtime_error("Error computing forces in EAMForceCompute");
+        }
+    #endif
+
+    const unsigned int N = m_pdata->getN();
+    const unsigned int n_total = m_pdata->getN() + m_pdata->getNGhosts();
+
+    // grow the per-particle buffers, they are kept between calls
+    if (m_density.getNumElements() < n_total)
+        {
+        GPUArray<Scalar> density(n_total, m_exec_conf);
+        m_density.swap(density);
+        }
+    if (m_dFdP.getNumElements() < n_total)
+        {
+        GPUArray<Scalar> dFdP(n_total, m_exec_conf);
+        m_dFdP.swap(dFdP);
+        }
+
     // access the neighbor list
     assert(m_nlist);
     ArrayHandle<unsigned int> h_n_neigh(m_nlist->getNNeighArray(), access_location::host, access_mode::read);
@@ -343,13 +379,6 @@ void EAMForceCompute::computeForces(unsigned int timestep)
     ArrayHandle<Scalar4> h_rphi(m_rphi, access_location::host, access_mode::read);
     ArrayHandle<Scalar4> h_drphi(m_drphi, access_location::host, access_mode::read);
 
-    // index and remainder
-    Scalar position;  // look up position, scalar
-    unsigned int int_position;  // look up index for position, integer
-    unsigned int idxs; // look up index in F, rho, rphi array, considering shift, integer
-    Scalar remainder;  // look up remainder in array, integer
-    Scalar4 v, dv;  // value, d(value)
-
     // there are enough other checks on the input data: but it doesn't hurt to be safe
     assert(h_force.data);
     assert(h_virial.data);
@@ -371,103 +400,157 @@ void EAMForceCompute::computeForces(unsigned int timestep)
     // create a temporary copy of r_cut squared
     Scalar r_cut_sq = m_r_cut * m_r_cut;
 
-    // sum up the number of forces calculated
-    int64_t n_calc = 0;
-
-    // parameters for each particle
-    vector<Scalar> atomElectronDensity;
-    atomElectronDensity.resize(m_pdata->getN());
-    vector<Scalar> atomDerivativeEmbeddingFunction;
-    atomDerivativeEmbeddingFunction.resize(m_pdata->getN());
-    vector<Scalar> atomEmbeddingFunction;
-    atomEmbeddingFunction.resize(m_pdata->getN());
     unsigned int ntypes = m_pdata->getNTypes();
 
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
         {
-        // access the particle's position and type
-        Scalar3 pi = make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z);
-        unsigned int typei = __scalar_as_int(h_pos.data[i].w);
-        const unsigned int head_i = h_head_list.data[i];
+        ArrayHandle<Scalar> h_density(m_density, access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar> h_dFdP(m_dFdP, access_location::host, access_mode::overwrite);
 
-        // sanity check
-        assert(typei < m_pdata->getNTypes());
+        memset((void *) h_density.data, 0, sizeof(Scalar) * n_total);
 
-        // loop over all of the neighbors of this particle
-        const unsigned int size = (unsigned int) h_n_neigh.data[i];
+        // calculate P = sum{rho} for every particle
+        #ifdef ENABLE_TBB
+        // with a half neighbor list, densities of the neighbors are accumulated per thread
+        tbb::enumerable_thread_specific< std::vector<Scalar> > thread_density(third_law ? n_total : 0, Scalar(0.0));
 
-        for (unsigned int j = 0; j < size; j++)
-            {
-            // increment our calculation counter
-            n_calc++;
+        tbb::parallel_for(tbb::blocked_range<unsigned int>(0, N),
+            [&](const tbb::blocked_range<unsigned int>& r) {
+            Scalar *density = third_law ? thread_density.local().data() : h_density.data;
 
-            // access the index of this neighbor
-            unsigned int k = h_nlist.data[head_i + j];
-            // sanity check
-            assert(k < m_pdata->getN());
+            for (unsigned int i = r.begin(); i != r.end(); ++i)
+        #else
+        Scalar *density = h_density.data;
 
-            // calculate dr
-            Scalar3 pk = make_scalar3(h_pos.data[k].x, h_pos.data[k].y, h_pos.data[k].z);
-            Scalar3 dx = pi - pk;
+        for (unsigned int i = 0; i < N; i++)
+        #endif
+            {
+            // access the particle's position and type
+            Scalar3 pi = make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z);
+            unsigned int typei = __scalar_as_int(h_pos.data[i].w);
+            const unsigned int head_i = h_head_list.data[i];
 
-            // access the type of the neighbor particle
-            unsigned int typej = __scalar_as_int(h_pos.data[k].w);
             // sanity check
-            assert(typej < m_pdata->getNTypes());
+            assert(typei < m_pdata->getNTypes());
 
-            // apply periodic boundary conditions
-            dx = box.minImage(dx);
+            Scalar density_i = Scalar(0.0);
 
-            // start computing the force
-            // calculate r squared
-            Scalar rsq = dot(dx, dx);
-            ;
-            // only compute the force if the particles are closer than the cut-off
-            if (rsq < r_cut_sq)
+            // loop over all of the neighbors of this particle
+            const unsigned int size = (unsigned int) h_n_neigh.data[i];
+
+            for (unsigned int j = 0; j < size; j++)
                 {
-                // calculate position r for rho(r)
-                position = sqrt(rsq) * rdr;
-                int_position = (unsigned int) position;
-                int_position = min(int_position, nr - 1);
-                remainder = position - int_position;
-                // calculate P = sum{rho}
-                idxs = int_position + nr * (typej * ntypes + typei);
-                v = h_rho.data[idxs];
-                atomElectronDensity[i] += v.w + v.z * remainder + v.y * remainder * remainder
-                        + v.x * remainder * remainder * remainder;
-                // if third_law, pair it
-                if (third_law)
+                // access the index of this neighbor
+                unsigned int k = h_nlist.data[head_i + j];
+                // sanity check
+                assert(k < m_pdata->getN() + m_pdata->getNGhosts());
+
+                // calculate dr
+                Scalar3 pk = make_scalar3(h_pos.data[k].x, h_pos.data[k].y, h_pos.data[k].z);
+                Scalar3 dx = pi - pk;
+
+                // access the type of the neighbor particle
+                unsigned int typej = __scalar_as_int(h_pos.data[k].w);
+                // sanity check
+                assert(typej < m_pdata->getNTypes());
+
+                // apply periodic boundary conditions
+                dx = box.minImage(dx);
+
+                // calculate r squared
+                Scalar rsq = dot(dx, dx);
+
+                // only compute the density if the particles are closer than the cut-off
+                if (rsq < r_cut_sq)
                     {
-                    idxs = int_position + nr * (typei * ntypes + typej);
-                    v = h_rho.data[idxs];
-                    atomElectronDensity[k] += v.w + v.z * remainder + v.y * remainder * remainder
+                    // calculate position r for rho(r)
+                    Scalar position = sqrt(rsq) * rdr;
+                    unsigned int int_position = (unsigned int) position;
+                    int_position = min(int_position, nr - 1);
+                    Scalar remainder = position - int_position;
+                    // calculate P = sum{rho}
+                    unsigned int idxs = int_position + nr * (typej * ntypes + typei);
+                    Scalar4 v = h_rho.data[idxs];
+                    density_i += v.w + v.z * remainder + v.y * remainder * remainder
                             + v.x * remainder * remainder * remainder;
+                    // if third_law, pair it
+                    if (third_law)
+                        {
+                        idxs = int_position + nr * (typei * ntypes + typej);
+                        v = h_rho.data[idxs];
+                        density[k] += v.w + v.z * remainder + v.y * remainder * remainder
+                                + v.x * remainder * remainder * remainder;
+                        }
                     }
                 }
+
+            density[i] += density_i;
+            }
+        #ifdef ENABLE_TBB
+            });
+
+        // sum up the per-thread densities
+        if (third_law)
+            {
+            for (auto it = thread_density.begin(); it != thread_density.end(); ++it)
+                for (unsigned int i = 0; i < n_total; ++i)
+                    h_density.data[i] += (*it)[i];
+            }
+        #endif
+
+        // compute the embedding function F(P) and its derivative dF/dP
+        #ifdef ENABLE_TBB
+        tbb::parallel_for(tbb::blocked_range<unsigned int>(0, N),
+            [&](const tbb::blocked_range<unsigned int>& r) {
+            for (unsigned int i = r.begin(); i != r.end(); ++i)
+        #else
+        for (unsigned int i = 0; i < N; i++)
+        #endif
+            {
+            unsigned int typei = __scalar_as_int(h_pos.data[i].w);
+            // calculate position rho for F(rho)
+            Scalar position = h_density.data[i] * rdrho;
+            unsigned int int_position = (unsigned int) position;
+            int_position = min(int_position, nrho - 1);
+            Scalar remainder = position - int_position;
+
+            unsigned int idxs = int_position + typei * nrho;
+            Scalar4 v = h_F.data[idxs];
+            Scalar4 dv = h_dF.data[idxs];
+            // compute dF / dP
+            h_dFdP.data[i] = dv.z + dv.y * remainder + dv.x * remainder * remainder;
+            // compute embedded energy F(P), sum up each particle
+            h_force.data[i].w += v.w + v.z * remainder + v.y * remainder * remainder
+                    + v.x * remainder * remainder * remainder;
             }
+        #ifdef ENABLE_TBB
+            });
+        #endif
         }
 
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        {
-        unsigned int typei = __scalar_as_int(h_pos.data[i].w);
-        // calculate position rho for F(rho)
-        position = atomElectronDensity[i] * rdrho;
-        int_position = (unsigned int) position;
-        int_position = min(int_position, nrho - 1);
-        remainder = position - int_position;
-
-        idxs = int_position + typei * nrho;
-        v = h_F.data[idxs];
-        dv = h_dF.data[idxs];
-        // compute dF / dP
-        atomDerivativeEmbeddingFunction[i] = dv.z + dv.y * remainder + dv.x * remainder * remainder;
-        // compute embedded energy F(P), sum up each particle
-        h_force.data[i].w += v.w + v.z * remainder + v.y * remainder * remainder
-                + v.x * remainder * remainder * remainder;
+    #ifdef ENABLE_MPI
+    // the pair forces need dF/dP of the ghost particles
+    if (m_comm)
+        m_comm->updateGhostScalar(m_dFdP);
+    #endif
 
-        }
+    ArrayHandle<Scalar> h_dFdP(m_dFdP, access_location::host, access_mode::read);
+
+    // compute the pair forces
+    #ifdef ENABLE_TBB
+    // with a half neighbor list, forces on the neighbors are accumulated per thread
+    Scalar4 zero_force = make_scalar4(0.0, 0.0, 0.0, 0.0);
+    tbb::enumerable_thread_specific< std::vector<Scalar4> > thread_force(third_law ? n_total : 0, zero_force);
 
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
+    tbb::parallel_for(tbb::blocked_range<unsigned int>(0, N),
+        [&](const tbb::blocked_range<unsigned int>& r) {
+        Scalar4 *force = third_law ? thread_force.local().data() : h_force.data;
+
+        for (unsigned int i = r.begin(); i != r.end(); ++i)
+    #else
+    Scalar4 *force = h_force.data;
+
+    for (unsigned int i = 0; i < N; i++)
+    #endif
         {
         // access the particle's position and type
         Scalar3 pi = make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z);
@@ -489,13 +572,10 @@ void EAMForceCompute::computeForces(unsigned int timestep)
         const unsigned int size = (unsigned int) h_n_neigh.data[i];
         for (unsigned int j = 0; j < size; j++)
             {
-            // increment our calculation counter
-            n_calc++;
-
             // access the index of this neighbor
             unsigned int k = h_nlist.data[head_i + j];
             // sanity check
-            assert(k < m_pdata->getN());
+            assert(k < m_pdata->getN() + m_pdata->getNGhosts());
 
             // calculate \Delta r
             Scalar3 pk = make_scalar3(h_pos.data[k].x, h_pos.data[k].y, h_pos.data[k].z);
@@ -518,19 +598,19 @@ void EAMForceCompute::computeForces(unsigned int timestep)
                 continue;
             Scalar r = sqrt(rsq);
             Scalar inverseR = 1.0 / r;
-            position = r * rdr;
-            int_position = (unsigned int) position;
+            Scalar position = r * rdr;
+            unsigned int int_position = (unsigned int) position;
             int_position = min(int_position, nr - 1);
-            remainder = position - int_position;
+            Scalar remainder = position - int_position;
             // calculate the shift position for type ij
             int shift =
                     (typei >= typej) ?
                             (int) (0.5 * (2 * ntypes - typej - 1) * typej + typei) * nr :
                             (int) (0.5 * (2 * ntypes - typei - 1) * typei + typej) * nr;
 
-            idxs = int_position + shift;
-            v = h_rphi.data[idxs];
-            dv = h_drphi.data[idxs];
+            unsigned int idxs = int_position + shift;
+            Scalar4 v = h_rphi.data[idxs];
+            Scalar4 dv = h_drphi.data[idxs];
             // pair_eng = phi
             Scalar pair_eng = (v.w + v.z * remainder + v.y * remainder * remainder
                     + v.x * remainder * remainder * remainder) * inverseR;
@@ -545,8 +625,8 @@ void EAMForceCompute::computeForces(unsigned int timestep)
             dv = h_drho.data[idxs];
             Scalar derivativeRhoJ = dv.z + dv.y * remainder + dv.x * remainder * remainder;
             // fullDerivativePhi = dF/dP * drho / dr for j + dF/dP * drho / dr for j + phi
-            Scalar fullDerivativePhi = atomDerivativeEmbeddingFunction[i] * derivativeRhoJ
-                    + atomDerivativeEmbeddingFunction[k] * derivativeRhoI + derivativePhi;
+            Scalar fullDerivativePhi = h_dFdP.data[i] * derivativeRhoJ
+                    + h_dFdP.data[k] * derivativeRhoI + derivativePhi;
             // compute forces
             Scalar pairForce = -fullDerivativePhi * inverseR;
             viriali[0] += dx.x * dx.x * pairForce;
@@ -562,30 +642,56 @@ void EAMForceCompute::computeForces(unsigned int timestep)
 
             if (third_law)
                 {
-                h_force.data[k].x -= dx.x * pairForce;
-                h_force.data[k].y -= dx.y * pairForce;
-                h_force.data[k].z -= dx.z * pairForce;
-                h_force.data[k].w += pair_eng * 0.5;
+                force[k].x -= dx.x * pairForce;
+                force[k].y -= dx.y * pairForce;
+                force[k].z -= dx.z * pairForce;
+                force[k].w += pair_eng * 0.5;
                 }
             }
-        h_force.data[i].x += fxi;
-        h_force.data[i].y += fyi;
-        h_force.data[i].z += fzi;
-        h_force.data[i].w += pei;
+        force[i].x += fxi;
+        force[i].y += fyi;
+        force[i].z += fzi;
+        force[i].w += pei;
         for (int k = 0; k < 6; k++)
             h_virial.data[k * virial_pitch + i] += viriali[k];
         }
+    #ifdef ENABLE_TBB
+        });
 
-    int64_t flops = m_pdata->getN() * 5 + n_calc * (3 + 5 + 9 + 1 + 9 + 6 + 8);
-    if (third_law)
-        flops += n_calc * 8;
-    int64_t mem_transfer = m_pdata->getN() * (5 + 4 + 10) * sizeof(Scalar) + n_calc * (1 + 3 + 1) * sizeof(Scalar);
+    // sum up the per-thread forces
     if (third_law)
-        mem_transfer += n_calc * 10 * sizeof(Scalar);
+        {
+        for (auto it = thread_force.begin(); it != thread_force.end(); ++it)
+            for (unsigned int i = 0; i < n_total; ++i)
+                {
+                const Scalar4& f = (*it)[i];
+                h_force.data[i].x += f.x;
+                h_force.data[i].y += f.y;
+                h_force.data[i].z += f.z;
+                h_force.data[i].w += f.w;
+                }
+        }
+    #endif
+
     if (m_prof)
+        {
+        // sum up the number of forces calculated
+        int64_t n_calc = 0;
+        for (unsigned int i = 0; i < N; i++)
+            n_calc += h_n_neigh.data[i];
+        n_calc *= 2;
+
+        int64_t flops = m_pdata->getN() * 5 + n_calc * (3 + 5 + 9 + 1 + 9 + 6 + 8);
+        if (third_law)
+            flops += n_calc * 8;
+        int64_t mem_transfer = m_pdata->getN() * (5 + 4 + 10) * sizeof(Scalar) + n_calc * (1 + 3 + 1) * sizeof(Scalar);
+        if (third_law)
+            mem_transfer += n_calc * 10 * sizeof(Scalar);
         m_prof->pop(flops, mem_transfer);
+        }
     }
 
+
 void EAMForceCompute::set_neighbor_list(std::shared_ptr<NeighborList> nlist)
     {
     m_nlist = nlist;
@@ -91,7 +91,8 @@ protected:
     GPUArray<Scalar4> m_dF;                //!< derivative embedded function and its coefficients
     GPUArray<Scalar4> m_drho;              //!< derivative electron density and its coefficients
     GPUArray<Scalar4> m_drphi;             //!< derivative pair wise function and its coefficients
-    GPUArray<Scalar> m_dFdP;               //!< derivative F / derivative P
+    GPUArray<Scalar> m_dFdP;               //!< derivative F / derivative P of every local and ghost particle
+    GPUArray<Scalar> m_density;            //!< electron density P of every local and ghost particle
 
     //! Actually compute the forces
     virtual void computeForces(unsigned int timestep);
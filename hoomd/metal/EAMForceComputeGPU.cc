@@ -98,8 +98,11 @@ void EAMForceComputeGPU::computeForces(unsigned int timestep)
     ArrayHandle<EAMTexInterData> d_eam_data(m_eam_data, access_location::device, access_mode::read);
 
     // Derivative Embedding Function for each atom
-    GPUArray<Scalar> t_dFdP(m_pdata->getN(), m_exec_conf);
-    m_dFdP.swap(t_dFdP);
+    if (m_dFdP.getNumElements() < m_pdata->getN())
+        {
+        GPUArray<Scalar> t_dFdP(m_pdata->getN(), m_exec_conf);
+        m_dFdP.swap(t_dFdP);
+        }
     ArrayHandle<Scalar> d_dFdP(m_dFdP, access_location::device, access_mode::overwrite);
 
     // Compute energy and forces in GPU
@@ -48,10 +48,11 @@ class eam(force._force):
 
     """
     def __init__(self, file, type, nlist):
-        # Error out in MPI simulations
+        # Error out in MPI simulations on the GPU
         if (hoomd.version.mpi_enabled):
-            if hoomd.context.current.system_definition.getParticleData().getDomainDecomposition():
-                hoomd.context.current.device.cpp_msg.error("pair.eam is not supported in multi-processor simulations.\n\n")
+            if hoomd.context.current.system_definition.getParticleData().getDomainDecomposition() and \
+               hoomd.context.current.device.cpp_exec_conf.isCUDAEnabled():
+                hoomd.context.current.device.cpp_msg.error("pair.eam is not supported in multi-processor simulations on the GPU.\n\n")
                 raise RuntimeError("Error setting up pair potential.")
 
         # initialize the base class
@@ -75,7 +76,9 @@ class eam(force._force):
 
         #Load neighbor list to compute.
         self.cpp_force.set_neighbor_list(self.nlist.cpp_nlist);
-        if hoomd.context.current.device.cpp_exec_conf.isCUDAEnabled():
+        if hoomd.context.current.device.cpp_exec_conf.isCUDAEnabled() or \
+           (hoomd.version.mpi_enabled and
+            hoomd.context.current.system_definition.getParticleData().getDomainDecomposition()):
             self.nlist.cpp_nlist.setStorageMode(_md.NeighborList.storageMode.full);
 
         hoomd.context.current.device.cpp_msg.notice(2, "Set r_cut = " + str(self.r_cut_new) + " from potential`s file '" +  str(file) + "'.\n");
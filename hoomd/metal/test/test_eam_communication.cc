@@ -0,0 +1,191 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+#ifdef ENABLE_MPI
+
+// this has to be included after naming the test module
+#include "hoomd/test/upp11_config.h"
+HOOMD_UP_MAIN()
+
+#include "hoomd/ExecutionConfiguration.h"
+#include "hoomd/Communicator.h"
+#include "hoomd/md/NeighborListBinned.h"
+#include "hoomd/metal/EAMForceCompute.h"
+
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <sstream>
+
+/*! \file test_eam_communication.cc
+    \brief Compares EAM forces on a domain decomposed system with the single-rank result
+    \ingroup unit_tests
+*/
+
+using namespace std;
+
+//! Cutoff of the test potential
+const Scalar eam_r_cut = 2.5;
+
+//! Write an EAM/Alloy file for a single type A with smooth analytic functions
+/*! \param filename Name of the file to write
+
+    F(rho) = -sqrt(rho), rho(r) = exp(-2(r-1)) (1-r/rc)^2 and phi(r) = (exp(-4(r-1.1)) - 2 exp(-2(r-1.1))) (1-r/rc)^2,
+    so that dF/drho depends on the density of the neighbors and the ghost values of dF/drho enter the forces.
+*/
+void write_eam_file(const std::string& filename)
+    {
+    const unsigned int nrho = 1000;
+    const double drho = 0.01;
+    const unsigned int nr = 600;
+    const double dr = 0.005;
+
+    FILE *fp = fopen(filename.c_str(), "w");
+    UP_ASSERT(fp != NULL);
+    fprintf(fp, "unit test potential\n\n\n");
+    fprintf(fp, "1 A\n");
+    fprintf(fp, "%d %g %d %g %g\n", nrho, drho, nr, dr, (double)eam_r_cut);
+    fprintf(fp, "1 1.0 1.0 fcc\n");
+    for (unsigned int i = 0; i < nrho; i++)
+        fprintf(fp, "%.12g\n", -sqrt(i*drho));
+    for (unsigned int i = 0; i < nr; i++)
+        {
+        double r = i*dr;
+        double s = r < eam_r_cut ? (1.0 - r/eam_r_cut)*(1.0 - r/eam_r_cut) : 0.0;
+        fprintf(fp, "%.12g\n", exp(-2.0*(r - 1.0))*s);
+        }
+    for (unsigned int i = 0; i < nr; i++)
+        {
+        double r = i*dr;
+        double s = r < eam_r_cut ? (1.0 - r/eam_r_cut)*(1.0 - r/eam_r_cut) : 0.0;
+        fprintf(fp, "%.12g\n", r*(exp(-4.0*(r - 1.1)) - 2.0*exp(-2.0*(r - 1.1)))*s);
+        }
+    fclose(fp);
+    }
+
+//! Build a perturbed simple cubic lattice of n^3 particles with spacing 1
+SnapshotParticleData<Scalar> make_snapshot(unsigned int n)
+    {
+    SnapshotParticleData<Scalar> snap(n*n*n);
+    snap.type_mapping.push_back("A");
+
+    // every rank generates the same positions
+    srand(12345);
+    Scalar offset = -Scalar(0.5)*Scalar(n) + Scalar(0.5);
+    for (unsigned int i = 0; i < n*n*n; ++i)
+        {
+        Scalar3 delta = make_scalar3(Scalar(0.2)*((Scalar)rand()/(Scalar)RAND_MAX - Scalar(0.5)),
+                                     Scalar(0.2)*((Scalar)rand()/(Scalar)RAND_MAX - Scalar(0.5)),
+                                     Scalar(0.2)*((Scalar)rand()/(Scalar)RAND_MAX - Scalar(0.5)));
+        snap.pos[i] = vec3<Scalar>(offset + Scalar(i % n) + delta.x,
+                                   offset + Scalar((i / n) % n) + delta.y,
+                                   offset + Scalar(i / (n*n)) + delta.z);
+        }
+    return snap;
+    }
+
+//! Compare the EAM forces, virials and energy of a domain decomposed system with the single-rank result
+void test_eam_communication(std::shared_ptr<ExecutionConfiguration> exec_conf,
+                            std::shared_ptr<DomainDecomposition> decomposition)
+    {
+    std::ostringstream filename;
+    filename << "test_eam_communication_" << exec_conf->getRank() << ".eam.alloy";
+    write_eam_file(filename.str());
+
+    unsigned int n = 10;
+    BoxDim box((Scalar)n);
+    SnapshotParticleData<Scalar> snap = make_snapshot(n);
+
+    // reference system, every rank holds all particles
+    std::shared_ptr<SystemDefinition> sysdef_ref(new SystemDefinition(n*n*n, box, 1, 0, 0, 0, 0, exec_conf));
+    std::shared_ptr<ParticleData> pdata_ref = sysdef_ref->getParticleData();
+    pdata_ref->initializeFromSnapshot(snap);
+
+    std::shared_ptr<NeighborList> nlist_ref(new NeighborListBinned(sysdef_ref, eam_r_cut, Scalar(0.4)));
+    nlist_ref->setStorageMode(NeighborList::full);
+    std::shared_ptr<EAMForceCompute> eam_ref(new EAMForceCompute(sysdef_ref, (char *)filename.str().c_str(), 0));
+    eam_ref->set_neighbor_list(nlist_ref);
+
+    // domain decomposed system
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(n*n*n, box, 1, 0, 0, 0, 0, exec_conf));
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+    pdata->setDomainDecomposition(decomposition);
+    pdata->initializeFromSnapshot(snap);
+    UP_ASSERT(pdata->getN() < pdata->getNGlobal());
+
+    std::shared_ptr<Communicator> comm(new Communicator(sysdef, decomposition));
+    std::shared_ptr<NeighborList> nlist(new NeighborListBinned(sysdef, eam_r_cut, Scalar(0.4)));
+    nlist->setStorageMode(NeighborList::full);
+    nlist->setCommunicator(comm);
+    std::shared_ptr<EAMForceCompute> eam(new EAMForceCompute(sysdef, (char *)filename.str().c_str(), 0));
+    eam->set_neighbor_list(nlist);
+    eam->setCommunicator(comm);
+
+    comm->communicate(0);
+    UP_ASSERT(pdata->getNGhosts() > 0);
+
+    eam_ref->compute(0);
+    eam->compute(0);
+
+        {
+        ArrayHandle<Scalar4> h_force(eam->getForceArray(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar> h_virial(eam->getVirialArray(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_tag(pdata->getTags(), access_location::host, access_mode::read);
+        size_t pitch = eam->getVirialArray().getPitch();
+
+        ArrayHandle<Scalar4> h_force_ref(eam_ref->getForceArray(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar> h_virial_ref(eam_ref->getVirialArray(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_rtag_ref(pdata_ref->getRTags(), access_location::host, access_mode::read);
+        size_t pitch_ref = eam_ref->getVirialArray().getPitch();
+
+        // the densities vary between particles, so the forces depend on the ghost values of dF/drho
+        Scalar tol = Scalar(1e-3);
+        for (unsigned int i = 0; i < pdata->getN(); ++i)
+            {
+            unsigned int j = h_rtag_ref.data[h_tag.data[i]];
+            MY_CHECK_SMALL(h_force.data[i].x - h_force_ref.data[j].x, tol);
+            MY_CHECK_SMALL(h_force.data[i].y - h_force_ref.data[j].y, tol);
+            MY_CHECK_SMALL(h_force.data[i].z - h_force_ref.data[j].z, tol);
+            MY_CHECK_SMALL(h_force.data[i].w - h_force_ref.data[j].w, tol);
+            for (unsigned int k = 0; k < 6; ++k)
+                MY_CHECK_SMALL(h_virial.data[k*pitch + i] - h_virial_ref.data[k*pitch_ref + j], tol);
+            }
+        }
+
+    // the energy is reduced over all ranks
+    MY_CHECK_CLOSE(eam->calcEnergySum(), eam_ref->calcEnergySum(), tol_small);
+
+    // contributions to ghost particles are not sent back to their owners
+    nlist->setStorageMode(NeighborList::half);
+    UP_ASSERT_EXCEPTION(std::runtime_error, [&]{ eam->compute(1); });
+
+    remove(filename.str().c_str());
+    }
+
+//! Tests EAM forces with a 2x2x2 domain decomposition
+UP_TEST( eam_communication_test )
+    {
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+
+    // this test needs to be run on eight processors
+    int size;
+    MPI_Comm_size(exec_conf->getHOOMDWorldMPICommunicator(), &size);
+    UP_ASSERT_EQUAL(size,8);
+
+    std::shared_ptr<DomainDecomposition> decomposition(new DomainDecomposition(exec_conf, make_scalar3(10.0, 10.0, 10.0), 2, 2, 2));
+    test_eam_communication(exec_conf, decomposition);
+    }
+
+//! Tests EAM forces with an uneven decomposition along x
+UP_TEST( eam_communication_balanced_test )
+    {
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+
+    std::vector<Scalar> fxs(1), fys(1), fzs(1);
+    fxs[0] = Scalar(0.35); fys[0] = Scalar(0.5); fzs[0] = Scalar(0.6);
+    std::shared_ptr<DomainDecomposition> decomposition(new DomainDecomposition(exec_conf, make_scalar3(10.0, 10.0, 10.0), fxs, fys, fzs));
+    test_eam_communication(exec_conf, decomposition);
+    }
+
+#endif // ENABLE_MPI
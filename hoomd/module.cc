@@ -7,6 +7,7 @@
 #include "ExecutionConfiguration.h"
 #include "ClockSource.h"
 #include "Profiler.h"
+#include "Instrumentation.h"
 #include "ParticleData.h"
 #include "PythonLocalDataAccess.h"
 #include "SystemDefinition.h"
@@ -26,6 +27,7 @@
 #include "DCDDumpWriter.h"
 #include "GetarDumpWriter.h"
 #include "GSDDumpWriter.h"
+#include "SharedMemoryWriter.h"
 #include "Logger.h"
 #include "LogPlainTXT.h"
 #include "LogMatrix.h"
@@ -206,6 +208,7 @@ PYBIND11_MODULE(_hoomd, m)
     export_hoomd_math_functions(m);
     export_ClockSource(m);
     export_Profiler(m);
+    export_Instrumentation(m);
 
     // data structures
     export_HOOMDHostBuffer(m);
@@ -278,6 +281,7 @@ PYBIND11_MODULE(_hoomd, m)
     export_DCDDumpWriter(m);
     getardump::export_GetarDumpWriter(m);
     export_GSDDumpWriter(m);
+    export_SharedMemoryWriter(m);
     export_Logger(m);
     export_LogPlainTXT(m);
     export_LogMatrix(m);
@@ -12,6 +12,11 @@
 #include "hoomd/RandomNumbers.h"
 #include "hoomd/RNGIdentifiers.h"
 
+#ifdef ENABLE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#endif
+
 mpcd::ATCollisionMethod::ATCollisionMethod(std::shared_ptr<mpcd::SystemData> sysdata,
                                            unsigned int cur_timestep,
                                            unsigned int period,
@@ -54,6 +59,9 @@ void mpcd::ATCollisionMethod::rule(unsigned int timestep)
     applyVelocities();
     if (m_prof) m_prof->pop(m_exec_conf);
 
+    // the random velocities are not needed until the next collision
+    m_mpcd_pdata->releaseAlternate();
+
     if (m_prof) m_prof->pop();
     }
 
@@ -64,7 +72,7 @@ void mpcd::ATCollisionMethod::drawVelocities(unsigned int timestep)
     {
     // mpcd particle data
     ArrayHandle<unsigned int> h_tag(m_mpcd_pdata->getTags(), access_location::host, access_mode::read);
-    ArrayHandle<Scalar4> h_alt_vel(m_mpcd_pdata->getAltVelocities(), access_location::host, access_mode::overwrite);
+    ArrayHandle<mpcd::StorageScalar4> h_alt_vel(m_mpcd_pdata->getAltVelocities(), access_location::host, access_mode::overwrite);
     const unsigned int N_mpcd = m_mpcd_pdata->getN() + m_mpcd_pdata->getNVirtual();
     unsigned int N_tot = N_mpcd;
 
@@ -84,14 +92,21 @@ void mpcd::ATCollisionMethod::drawVelocities(unsigned int timestep)
 
     // random velocities are drawn for each particle and stored into the "alternate" arrays
     const Scalar T = (*m_T)(timestep);
+    const Scalar mpcd_mass = m_mpcd_pdata->getMass();
+    #ifdef ENABLE_TBB
+    tbb::parallel_for(tbb::blocked_range<unsigned int>(0, N_tot),
+        [&](const tbb::blocked_range<unsigned int>& r) {
+        for (unsigned int idx = r.begin(); idx != r.end(); ++idx)
+    #else
     for (unsigned int idx=0; idx < N_tot; ++idx)
+    #endif
         {
         unsigned int pidx;
         unsigned int tag; Scalar mass;
         if (idx < N_mpcd)
             {
             pidx = idx;
-            mass = m_mpcd_pdata->getMass();
+            mass = mpcd_mass;
             tag = h_tag.data[idx];
             }
         else
@@ -111,20 +126,23 @@ void mpcd::ATCollisionMethod::drawVelocities(unsigned int timestep)
         // save out velocities
         if (idx < N_mpcd)
             {
-            h_alt_vel.data[pidx] = make_scalar4(vel.x, vel.y, vel.z, __int_as_scalar(mpcd::detail::NO_CELL));
+            h_alt_vel.data[pidx] = mpcd::make_storage_scalar4(vel.x, vel.y, vel.z, __int_as_scalar(mpcd::detail::NO_CELL));
             }
         else
             {
             h_alt_vel_embed->data[pidx] = make_scalar4(vel.x, vel.y, vel.z, mass);
             }
         }
+    #ifdef ENABLE_TBB
+        });
+    #endif
     }
 
 void mpcd::ATCollisionMethod::applyVelocities()
     {
     // mpcd particle data
-    ArrayHandle<Scalar4> h_vel(m_mpcd_pdata->getVelocities(), access_location::host, access_mode::readwrite);
-    ArrayHandle<Scalar4> h_vel_alt(m_mpcd_pdata->getAltVelocities(), access_location::host, access_mode::read);
+    ArrayHandle<mpcd::StorageScalar4> h_vel(m_mpcd_pdata->getVelocities(), access_location::host, access_mode::readwrite);
+    ArrayHandle<mpcd::StorageScalar4> h_vel_alt(m_mpcd_pdata->getAltVelocities(), access_location::host, access_mode::read);
     const unsigned int N_mpcd = m_mpcd_pdata->getN() + m_mpcd_pdata->getNVirtual();
     unsigned int N_tot = N_mpcd;
 
@@ -145,16 +163,22 @@ void mpcd::ATCollisionMethod::applyVelocities()
     ArrayHandle<double4> h_cell_vel(m_thermo->getCellVelocities(), access_location::host, access_mode::read);
     ArrayHandle<double4> h_rand_vel(m_rand_thermo->getCellVelocities(), access_location::host, access_mode::read);
 
+    #ifdef ENABLE_TBB
+    tbb::parallel_for(tbb::blocked_range<unsigned int>(0, N_tot),
+        [&](const tbb::blocked_range<unsigned int>& r) {
+        for (unsigned int idx = r.begin(); idx != r.end(); ++idx)
+    #else
     for (unsigned int idx=0; idx < N_tot; ++idx)
+    #endif
         {
         unsigned int cell, pidx;
         Scalar4 vel_rand;
         if (idx < N_mpcd)
             {
             pidx = idx;
-            const Scalar4 vel_cell = h_vel.data[idx];
+            const Scalar4 vel_cell = mpcd::storage_to_scalar4(h_vel.data[idx]);
             cell = __scalar_as_int(vel_cell.w);
-            vel_rand = h_vel_alt.data[idx];
+            vel_rand = mpcd::storage_to_scalar4(h_vel_alt.data[idx]);
             }
         else
             {
@@ -174,13 +198,16 @@ void mpcd::ATCollisionMethod::applyVelocities()
 
         if (idx < N_mpcd)
             {
-            h_vel.data[pidx] = make_scalar4(vnew.x, vnew.y, vnew.z, __int_as_scalar(cell));
+            h_vel.data[pidx] = mpcd::make_storage_scalar4(vnew.x, vnew.y, vnew.z, __int_as_scalar(cell));
             }
         else
             {
             h_vel_embed->data[pidx] = make_scalar4(vnew.x, vnew.y, vnew.z, vel_rand.w);
             }
         }
+    #ifdef ENABLE_TBB
+        });
+    #endif
     }
 
 /*!
@@ -19,7 +19,7 @@ namespace gpu
 {
 namespace kernel
 {
-__global__ void at_draw_velocity(Scalar4 *d_alt_vel,
+__global__ void at_draw_velocity(mpcd::StorageScalar4 *d_alt_vel,
                                  Scalar4 *d_alt_vel_embed,
                                  const unsigned int *d_tag,
                                  const Scalar mpcd_mass,
@@ -62,7 +62,7 @@ __global__ void at_draw_velocity(Scalar4 *d_alt_vel,
     // save out velocities
     if (idx < N_mpcd)
         {
-        d_alt_vel[pidx] = make_scalar4(vel.x, vel.y, vel.z, __int_as_scalar(mpcd::detail::NO_CELL));
+        d_alt_vel[pidx] = mpcd::make_storage_scalar4(vel.x, vel.y, vel.z, __int_as_scalar(mpcd::detail::NO_CELL));
         }
     else
         {
@@ -70,9 +70,9 @@ __global__ void at_draw_velocity(Scalar4 *d_alt_vel,
         }
     }
 
-__global__ void at_apply_velocity(Scalar4 *d_vel,
+__global__ void at_apply_velocity(mpcd::StorageScalar4 *d_vel,
                                   Scalar4 *d_vel_embed,
-                                  const Scalar4 *d_vel_alt,
+                                  const mpcd::StorageScalar4 *d_vel_alt,
                                   const unsigned int *d_embed_idx,
                                   const Scalar4 *d_vel_alt_embed,
                                   const unsigned int *d_embed_cell_ids,
@@ -91,9 +91,9 @@ __global__ void at_apply_velocity(Scalar4 *d_vel,
     if (idx < N_mpcd)
         {
         pidx = idx;
-        const Scalar4 vel_cell = d_vel[idx];
+        const Scalar4 vel_cell = mpcd::storage_to_scalar4(d_vel[idx]);
         cell = __scalar_as_int(vel_cell.w);
-        vel_rand = d_vel_alt[idx];
+        vel_rand = mpcd::storage_to_scalar4(d_vel_alt[idx]);
         }
     else
         {
@@ -113,7 +113,7 @@ __global__ void at_apply_velocity(Scalar4 *d_vel,
 
     if (idx < N_mpcd)
         {
-        d_vel[pidx] = make_scalar4(vnew.x, vnew.y, vnew.z, __int_as_scalar(cell));
+        d_vel[pidx] = mpcd::make_storage_scalar4(vnew.x, vnew.y, vnew.z, __int_as_scalar(cell));
         }
     else
         {
@@ -123,7 +123,7 @@ __global__ void at_apply_velocity(Scalar4 *d_vel,
 
 } // end namespace kernel
 
-cudaError_t at_draw_velocity(Scalar4 *d_alt_vel,
+cudaError_t at_draw_velocity(mpcd::StorageScalar4 *d_alt_vel,
                              Scalar4 *d_alt_vel_embed,
                              const unsigned int *d_tag,
                              const Scalar mpcd_mass,
@@ -164,9 +164,9 @@ cudaError_t at_draw_velocity(Scalar4 *d_alt_vel,
     return cudaSuccess;
     }
 
-cudaError_t at_apply_velocity(Scalar4 *d_vel,
+cudaError_t at_apply_velocity(mpcd::StorageScalar4 *d_vel,
                               Scalar4 *d_vel_embed,
-                              const Scalar4 *d_vel_alt,
+                              const mpcd::StorageScalar4 *d_vel_alt,
                               const unsigned int *d_embed_idx,
                               const Scalar4 *d_vel_alt_embed,
                               const unsigned int *d_embed_cell_ids,
@@ -13,6 +13,7 @@
 
 #include <cuda_runtime.h>
 
+#include "ParticleDataUtilities.h"
 #include "hoomd/HOOMDMath.h"
 #include "hoomd/Index1D.h"
 
@@ -22,7 +23,7 @@ namespace gpu
 {
 
 //! Draw particle velocities for the Andersen thermostat from Gaussian distribution
-cudaError_t at_draw_velocity(Scalar4 *d_alt_vel,
+cudaError_t at_draw_velocity(mpcd::StorageScalar4 *d_alt_vel,
                              Scalar4 *d_alt_vel_embed,
                              const unsigned int *d_tag,
                              const Scalar mpcd_mass,
@@ -37,9 +38,9 @@ cudaError_t at_draw_velocity(Scalar4 *d_alt_vel,
                              const unsigned int block_size);
 
 //! Apply velocities for the Andersen thermostat
-cudaError_t at_apply_velocity(Scalar4 *d_vel,
+cudaError_t at_apply_velocity(mpcd::StorageScalar4 *d_vel,
                               Scalar4 *d_vel_embed,
-                              const Scalar4 *d_vel_alt,
+                              const mpcd::StorageScalar4 *d_vel_alt,
                               const unsigned int *d_embed_idx,
                               const Scalar4 *d_vel_alt_embed,
                               const unsigned int *d_embed_cell_ids,
@@ -10,6 +10,12 @@
 #include "hoomd/Communicator.h"
 #endif // ENABLE_MPI
 
+#ifdef ENABLE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+#endif
+
 /*!
  * \file mpcd/CellList.cc
  * \brief Definition of mpcd::CellList
@@ -506,8 +512,8 @@ void mpcd::CellList::buildCellList()
 
     uint3 conditions = make_uint3(0,0,0);
 
-    ArrayHandle<Scalar4> h_pos(m_mpcd_pdata->getPositions(), access_location::host, access_mode::read);
-    ArrayHandle<Scalar4> h_vel(m_mpcd_pdata->getVelocities(), access_location::host, access_mode::readwrite);
+    ArrayHandle<mpcd::StorageScalar4> h_pos(m_mpcd_pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<mpcd::StorageScalar4> h_vel(m_mpcd_pdata->getVelocities(), access_location::host, access_mode::readwrite);
     unsigned int N_mpcd = m_mpcd_pdata->getN() + m_mpcd_pdata->getNVirtual();
     unsigned int N_tot = N_mpcd;
 
@@ -534,12 +540,22 @@ void mpcd::CellList::buildCellList()
 
     const Scalar3 global_lo = m_pdata->getGlobalBox().getLo();
 
+    // bin the particles first, stashing the bin into the velocity array (or the embedded cell ids)
+    #ifdef ENABLE_TBB
+    tbb::enumerable_thread_specific<uint3> thread_conditions(make_uint3(0,0,0));
+    tbb::parallel_for(tbb::blocked_range<unsigned int>(0, N_tot),
+        [&](const tbb::blocked_range<unsigned int>& r) {
+        uint3& local_conditions = thread_conditions.local();
+        for (unsigned int cur_p = r.begin(); cur_p != r.end(); ++cur_p)
+    #else
+    uint3& local_conditions = conditions;
     for (unsigned int cur_p = 0; cur_p < N_tot; ++cur_p)
+    #endif
         {
         Scalar4 postype_i;
         if (cur_p < N_mpcd)
             {
-            postype_i = h_pos.data[cur_p];
+            postype_i = mpcd::storage_to_scalar4(h_pos.data[cur_p]);
             }
         else
             {
@@ -547,58 +563,91 @@ void mpcd::CellList::buildCellList()
             }
         Scalar3 pos_i = make_scalar3(postype_i.x, postype_i.y, postype_i.z);
 
+        unsigned int bin_idx = mpcd::detail::NO_CELL;
         if (std::isnan(pos_i.x) || std::isnan(pos_i.y) || std::isnan(pos_i.z))
             {
-            conditions.y = cur_p + 1;
-            continue;
+            // keep the last particle with an error
+            local_conditions.y = std::max(local_conditions.y, cur_p + 1);
             }
+        else
+            {
+            // bin particle assuming orthorhombic box (already validated)
+            const Scalar3 delta = (pos_i - m_grid_shift) - global_lo;
+            int3 global_bin = make_int3((int)std::floor(delta.x / m_cell_size),
+                                        (int)std::floor(delta.y / m_cell_size),
+                                        (int)std::floor(delta.z / m_cell_size));
+
+            // wrap cell back through the boundaries (grid shifting may send +/- 1 outside of range)
+            // this is done using periodic from the "local" box, since this will be periodic
+            // only when there is one rank along the dimension
+            if (periodic.x)
+                {
+                if (global_bin.x == (int)n_global_cells.x)
+                    global_bin.x = 0;
+                else if (global_bin.x == -1)
+                    global_bin.x = n_global_cells.x - 1;
+                }
+            if (periodic.y)
+                {
+                if (global_bin.y == (int)n_global_cells.y)
+                    global_bin.y = 0;
+                else if (global_bin.y == -1)
+                    global_bin.y = n_global_cells.y - 1;
+                }
+            if (periodic.z)
+                {
+                if (global_bin.z == (int)n_global_cells.z)
+                    global_bin.z = 0;
+                else if (global_bin.z == -1)
+                    global_bin.z = n_global_cells.z - 1;
+                }
 
-        // bin particle assuming orthorhombic box (already validated)
-        const Scalar3 delta = (pos_i - m_grid_shift) - global_lo;
-        int3 global_bin = make_int3((int)std::floor(delta.x / m_cell_size),
-                                    (int)std::floor(delta.y / m_cell_size),
-                                    (int)std::floor(delta.z / m_cell_size));
+            // compute the local cell
+            int3 bin = make_int3(global_bin.x - m_origin_idx.x,
+                                 global_bin.y - m_origin_idx.y,
+                                 global_bin.z - m_origin_idx.z);
 
-        // wrap cell back through the boundaries (grid shifting may send +/- 1 outside of range)
-        // this is done using periodic from the "local" box, since this will be periodic
-        // only when there is one rank along the dimension
-        if (periodic.x)
-            {
-            if (global_bin.x == (int)n_global_cells.x)
-                global_bin.x = 0;
-            else if (global_bin.x == -1)
-                global_bin.x = n_global_cells.x - 1;
+            // validate and make sure no particles blew out of the box
+            if ((bin.x < 0 || bin.x >= (int)m_cell_dim.x) ||
+                (bin.y < 0 || bin.y >= (int)m_cell_dim.y) ||
+                (bin.z < 0 || bin.z >= (int)m_cell_dim.z))
+                {
+                local_conditions.z = std::max(local_conditions.z, cur_p + 1);
+                }
+            else
+                {
+                bin_idx = m_cell_indexer(bin.x, bin.y, bin.z);
+                }
             }
-        if (periodic.y)
+
+        // stash the current particle bin into the velocity array
+        if (cur_p < N_mpcd)
             {
-            if (global_bin.y == (int)n_global_cells.y)
-                global_bin.y = 0;
-            else if (global_bin.y == -1)
-                global_bin.y = n_global_cells.y - 1;
+            h_vel.data[cur_p].w = mpcd::int_as_storage_scalar(bin_idx);
             }
-        if (periodic.z)
+        else
             {
-            if (global_bin.z == (int)n_global_cells.z)
-                global_bin.z = 0;
-            else if (global_bin.z == -1)
-                global_bin.z = n_global_cells.z - 1;
+            h_embed_cell_ids->data[cur_p - N_mpcd] = bin_idx;
             }
+        }
+    #ifdef ENABLE_TBB
+        });
 
-        // compute the local cell
-        int3 bin = make_int3(global_bin.x - m_origin_idx.x,
-                             global_bin.y - m_origin_idx.y,
-                             global_bin.z - m_origin_idx.z);
+    for (auto it = thread_conditions.begin(); it != thread_conditions.end(); ++it)
+        {
+        conditions.y = std::max(conditions.y, it->y);
+        conditions.z = std::max(conditions.z, it->z);
+        }
+    #endif
 
-        // validate and make sure no particles blew out of the box
-        if ((bin.x < 0 || bin.x >= (int)m_cell_dim.x) ||
-            (bin.y < 0 || bin.y >= (int)m_cell_dim.y) ||
-            (bin.z < 0 || bin.z >= (int)m_cell_dim.z))
-            {
-            conditions.z = cur_p + 1;
+    // fill the cells in particle order so that the cell list does not depend on the number of threads
+    for (unsigned int cur_p = 0; cur_p < N_tot; ++cur_p)
+        {
+        const unsigned int bin_idx = (cur_p < N_mpcd) ? mpcd::storage_scalar_as_int(h_vel.data[cur_p].w)
+                                                      : h_embed_cell_ids->data[cur_p - N_mpcd];
+        if (bin_idx == mpcd::detail::NO_CELL)
             continue;
-            }
 
-        unsigned int bin_idx = m_cell_indexer(bin.x, bin.y, bin.z);
         unsigned int offset = h_cell_np.data[bin_idx];
         if (offset < m_cell_np_max)
             {
@@ -610,16 +659,6 @@ void mpcd::CellList::buildCellList()
             conditions.x = std::max(conditions.x, offset+1);
             }
 
-        // stash the current particle bin into the velocity array
-        if (cur_p < N_mpcd)
-            {
-            h_vel.data[cur_p].w = __int_as_scalar(bin_idx);
-            }
-        else
-            {
-            h_embed_cell_ids->data[cur_p - N_mpcd] = bin_idx;
-            }
-
         // increment the counter always
         ++h_cell_np.data[bin_idx];
         }
@@ -745,8 +784,8 @@ bool mpcd::CellList::checkConditions()
         Scalar4 pos_empty_i;
         if (n < m_mpcd_pdata->getN() + m_mpcd_pdata->getNVirtual())
             {
-            ArrayHandle<Scalar4> h_pos(m_mpcd_pdata->getPositions(), access_location::host, access_mode::read);
-            pos_empty_i = h_pos.data[n];
+            ArrayHandle<mpcd::StorageScalar4> h_pos(m_mpcd_pdata->getPositions(), access_location::host, access_mode::read);
+            pos_empty_i = mpcd::storage_to_scalar4(h_pos.data[n]);
             if (n < m_mpcd_pdata->getN())
                 m_exec_conf->msg->errorAllRanks() << "MPCD particle is no longer in the simulation box"<<std::endl;
             else
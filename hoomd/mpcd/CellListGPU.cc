@@ -34,8 +34,8 @@ void mpcd::CellListGPU::buildCellList()
     {
     ArrayHandle<unsigned int> d_cell_list(m_cell_list, access_location::device, access_mode::overwrite);
     ArrayHandle<unsigned int> d_cell_np(m_cell_np, access_location::device, access_mode::overwrite);
-    ArrayHandle<Scalar4> d_pos(m_mpcd_pdata->getPositions(), access_location::device, access_mode::read);
-    ArrayHandle<Scalar4> d_vel(m_mpcd_pdata->getVelocities(), access_location::device, access_mode::readwrite);
+    ArrayHandle<mpcd::StorageScalar4> d_pos(m_mpcd_pdata->getPositions(), access_location::device, access_mode::read);
+    ArrayHandle<mpcd::StorageScalar4> d_vel(m_mpcd_pdata->getVelocities(), access_location::device, access_mode::readwrite);
 
     const unsigned int N_mpcd = m_mpcd_pdata->getN() + m_mpcd_pdata->getNVirtual();
     unsigned int N_tot = N_mpcd;
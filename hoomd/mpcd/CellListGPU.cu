@@ -47,9 +47,9 @@ namespace kernel
 __global__ void compute_cell_list(unsigned int *d_cell_np,
                                   unsigned int *d_cell_list,
                                   uint3 *d_conditions,
-                                  Scalar4 *d_vel,
+                                  mpcd::StorageScalar4 *d_vel,
                                   unsigned int *d_embed_cell_ids,
-                                  const Scalar4 *d_pos,
+                                  const mpcd::StorageScalar4 *d_pos,
                                   const Scalar4 *d_pos_embed,
                                   const unsigned int *d_embed_member_idx,
                                   const uchar3 periodic,
@@ -72,7 +72,7 @@ __global__ void compute_cell_list(unsigned int *d_cell_np,
     Scalar4 postype_i;
     if (idx < N_mpcd)
         {
-        postype_i = d_pos[idx];
+        postype_i = mpcd::storage_to_scalar4(d_pos[idx]);
         }
     else
         {
@@ -146,7 +146,7 @@ __global__ void compute_cell_list(unsigned int *d_cell_np,
     // stash the current particle bin into the velocity array
     if (idx < N_mpcd)
         {
-        d_vel[idx].w = __int_as_scalar(bin_idx);
+        d_vel[idx].w = mpcd::int_as_storage_scalar(bin_idx);
         }
     else
         {
@@ -256,9 +256,9 @@ __global__ void cell_apply_sort(unsigned int *d_cell_list,
 cudaError_t mpcd::gpu::compute_cell_list(unsigned int *d_cell_np,
                                          unsigned int *d_cell_list,
                                          uint3 *d_conditions,
-                                         Scalar4 *d_vel,
+                                         mpcd::StorageScalar4 *d_vel,
                                          unsigned int *d_embed_cell_ids,
-                                         const Scalar4 *d_pos,
+                                         const mpcd::StorageScalar4 *d_pos,
                                          const Scalar4 *d_pos_embed,
                                          const unsigned int *d_embed_member_idx,
                                          const uchar3& periodic,
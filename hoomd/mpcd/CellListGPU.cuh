@@ -13,6 +13,7 @@
 
 #include <cuda_runtime.h>
 
+#include "ParticleDataUtilities.h"
 #include "hoomd/BoxDim.h"
 #include "hoomd/HOOMDMath.h"
 #include "hoomd/Index1D.h"
@@ -26,9 +27,9 @@ namespace gpu
 cudaError_t compute_cell_list(unsigned int *d_cell_np,
                               unsigned int *d_cell_list,
                               uint3 *d_conditions,
-                              Scalar4 *d_vel,
+                              mpcd::StorageScalar4 *d_vel,
                               unsigned int *d_embed_cell_ids,
-                              const Scalar4 *d_pos,
+                              const mpcd::StorageScalar4 *d_pos,
                               const Scalar4 *d_pos_embed,
                               const unsigned int *d_embed_member_idx,
                               const uchar3& periodic,
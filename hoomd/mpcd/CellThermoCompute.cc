@@ -11,6 +11,11 @@
 #include "CellThermoCompute.h"
 #include "ReductionOperators.h"
 
+#ifdef ENABLE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#endif
+
 /*!
  * \param sysdata MPCD system data
  * \param suffix Suffix for logged quantities
@@ -77,6 +82,40 @@ void mpcd::CellThermoCompute::compute(unsigned int timestep)
     if (m_prof) m_prof->pop(m_exec_conf);
     }
 
+/*!
+ * \param timestep Current timestep
+ * \returns True if the caller should compute the cell properties in its own pass over the cells
+ *
+ * A fused pass is possible on the CPU when all cells are owned by this rank and no callbacks need to be
+ * overlapped with the calculation. The cell list is brought up to date, and the caller must then fill the
+ * cell velocities (and energies, if requested in getFlags()) of all cells and call finishFusedCompute().
+ * If the properties are already computed at \a timestep, no fused pass is needed and false is returned.
+ */
+bool mpcd::CellThermoCompute::beginFusedCompute(unsigned int timestep)
+    {
+    if (m_exec_conf->isCUDAEnabled() || !m_callbacks.empty()) return false;
+    #ifdef ENABLE_MPI
+    if (m_use_mpi) return false;
+    #endif // ENABLE_MPI
+
+    if (!shouldCompute(timestep)) return false;
+    m_last_computed = timestep;
+
+    // cell list needs to be up to date first
+    m_cl->compute(timestep);
+
+    // ensure optional flags are up to date
+    updateFlags();
+
+    const unsigned int ncells = m_cl->getNCells();
+    if (ncells != m_ncells_alloc)
+        {
+        reallocate(ncells);
+        }
+
+    return true;
+    }
+
 void mpcd::CellThermoCompute::computeCellProperties(unsigned int timestep)
     {
     /*
@@ -123,99 +162,6 @@ void mpcd::CellThermoCompute::computeCellProperties(unsigned int timestep)
     #endif // ENABLE_MPI
     }
 
-namespace mpcd
-{
-namespace detail
-{
-//! Sums properties of an MPCD cell on the CPU
-/*!
- * This lightweight class is used in both beginOuterCellProperties() and
- * calcInnerCellProperties(). The code has been consolidated into one place
- * here to avoid some duplication.
- */
-struct CellPropertySum
-    {
-    //! Constructor
-    /*!
-     * \param cell_list_ Cell list
-     * \param cell_np_ Number of particles per cell
-     * \param cli_ Cell list indexer
-     * \param vel_ MPCD particle velocities
-     * \param mass_ MPCD mass
-     * \param embed_vel_ Embedded particle velocities
-     * \param embed_idx_ Embedded particle indexes
-     * \param N_mpcd_ Number of MPCD particles
-     */
-    CellPropertySum(const unsigned int *cell_list_,
-                    const unsigned int *cell_np_,
-                    const Index2D& cli_,
-                    const Scalar4 *vel_,
-                    const Scalar mass_,
-                    const Scalar4 *embed_vel_,
-                    const unsigned int *embed_idx_,
-                    const unsigned int N_mpcd_)
-        : cell_list(cell_list_), cell_np(cell_np_), cli(cli_), vel(vel_), mass(mass_),
-          embed_vel(embed_vel_), embed_idx(embed_idx_), N_mpcd(N_mpcd_)
-        {}
-
-    //! Computes the total momentum, kinetic energy, and number of particles in a cell
-    /*!
-     * \param momentum Cell momentum (output)
-     * \param ke Cell kinetic energy (output)
-     * \param np Number of particles in cell (output)
-     * \param cell Index of cell to evaluate
-     * \param energy If true, then the kinetic energy is evaluated into \a ke
-     */
-    inline void compute(double4& momentum, double& ke, unsigned int& np, const unsigned int cell, const bool energy)
-        {
-        momentum = make_double4(0.0, 0.0, 0.0, 0.0);
-        ke = 0.0;
-        np = cell_np[cell];
-
-        for (unsigned int offset = 0; offset < np; ++offset)
-            {
-            // Load particle data
-            const unsigned int cur_p = cell_list[cli(offset, cell)];
-            double3 vel_i;
-            double mass_i;
-            if (cur_p < N_mpcd)
-                {
-                Scalar4 vel_cell = vel[cur_p];
-                vel_i = make_double3(vel_cell.x, vel_cell.y, vel_cell.z);
-                mass_i = mass;
-                }
-            else
-                {
-                Scalar4 vel_m = embed_vel[embed_idx[cur_p - N_mpcd]];
-                vel_i = make_double3(vel_m.x, vel_m.y, vel_m.z);
-                mass_i = vel_m.w;
-                }
-
-            // add momentum
-            momentum.x += mass_i * vel_i.x;
-            momentum.y += mass_i * vel_i.y;
-            momentum.z += mass_i * vel_i.z;
-            momentum.w += mass_i;
-
-            // also compute ke of the particle
-            if (energy)
-                ke += 0.5 * mass_i * (vel_i.x * vel_i.x + vel_i.y * vel_i.y + vel_i.z * vel_i.z);
-            }
-    }
-
-    const unsigned int *cell_list;  //!< Cell list
-    const unsigned int *cell_np;    //!< Number of particles per cell
-    const Index2D cli;              //!< Cell list indexer
-
-    const Scalar4 *vel;             //!< MPCD particle velocities
-    const Scalar mass;              //!< MPCD particle mass
-    const Scalar4 *embed_vel;       //!< Embedded particle velocities
-    const unsigned int *embed_idx;  //!< Embedded particle indexes
-    const unsigned int N_mpcd;      //!< Number of MPCD particles
-    };
-} // end namespace detail
-} // end namespace mpcd
-
 #ifdef ENABLE_MPI
 void mpcd::CellThermoCompute::beginOuterCellProperties()
     {
@@ -225,7 +171,7 @@ void mpcd::CellThermoCompute::beginOuterCellProperties()
     const Index2D& cli = m_cl->getCellListIndexer();
 
     // MPCD particle data
-    ArrayHandle<Scalar4> h_vel(m_mpcd_pdata->getVelocities(), access_location::host, access_mode::read);
+    ArrayHandle<mpcd::StorageScalar4> h_vel(m_mpcd_pdata->getVelocities(), access_location::host, access_mode::read);
     const Scalar mpcd_mass = m_mpcd_pdata->getMass();
     const unsigned int N_mpcd = m_mpcd_pdata->getN() + m_mpcd_pdata->getNVirtual();
 
@@ -253,7 +199,13 @@ void mpcd::CellThermoCompute::beginOuterCellProperties()
 
     // Loop over all outer cells and compute total momentum, mass, energy
     const bool need_energy = m_flags[mpcd::detail::thermo_options::energy];
+    #ifdef ENABLE_TBB
+    tbb::parallel_for(tbb::blocked_range<unsigned int>(0, m_vel_comm->getNCells()),
+        [&](const tbb::blocked_range<unsigned int>& r) {
+        for (unsigned int idx = r.begin(); idx != r.end(); ++idx)
+    #else
     for (unsigned int idx=0; idx < m_vel_comm->getNCells(); ++idx)
+    #endif
         {
         const unsigned int cur_cell = h_cells.data[idx];
 
@@ -265,6 +217,9 @@ void mpcd::CellThermoCompute::beginOuterCellProperties()
         if (need_energy)
             h_cell_energy.data[cur_cell] = make_double3(ke, 0.0, __int_as_double(np));
         }
+    #ifdef ENABLE_TBB
+        });
+    #endif
     }
 
 void mpcd::CellThermoCompute::finishOuterCellProperties()
@@ -275,7 +230,14 @@ void mpcd::CellThermoCompute::finishOuterCellProperties()
 
     // Loop over all outer cells and normalize the summed quantities
     const bool need_energy = m_flags[mpcd::detail::thermo_options::energy];
+    const unsigned int ndim = m_sysdef->getNDimensions();
+    #ifdef ENABLE_TBB
+    tbb::parallel_for(tbb::blocked_range<unsigned int>(0, m_vel_comm->getNCells()),
+        [&](const tbb::blocked_range<unsigned int>& r) {
+        for (unsigned int idx = r.begin(); idx != r.end(); ++idx)
+    #else
     for (unsigned int idx=0; idx < m_vel_comm->getNCells(); ++idx)
+    #endif
         {
         const unsigned int cur_cell = h_cells.data[idx];
 
@@ -301,11 +263,14 @@ void mpcd::CellThermoCompute::finishOuterCellProperties()
             if (np > 1)
                 {
                 const double ke_cm = 0.5 * mass * (vel_cm.x*vel_cm.x + vel_cm.y*vel_cm.y + vel_cm.z*vel_cm.z);
-                temp = 2. * (ke - ke_cm) / (m_sysdef->getNDimensions() * (np-1));
+                temp = 2. * (ke - ke_cm) / (ndim * (np-1));
                 }
             h_cell_energy.data[cur_cell] = make_double3(ke, temp, __int_as_double(np));
             }
         }
+    #ifdef ENABLE_TBB
+        });
+    #endif
     }
 #endif // ENABLE_MPI
 
@@ -319,7 +284,7 @@ void mpcd::CellThermoCompute::calcInnerCellProperties()
     // MPCD particle data
     const unsigned int N_mpcd = m_mpcd_pdata->getN() + m_mpcd_pdata->getNVirtual();
     const Scalar mpcd_mass = m_mpcd_pdata->getMass();
-    ArrayHandle<Scalar4> h_vel(m_mpcd_pdata->getVelocities(), access_location::host, access_mode::read);
+    ArrayHandle<mpcd::StorageScalar4> h_vel(m_mpcd_pdata->getVelocities(), access_location::host, access_mode::read);
 
     // Embedded particle data
     std::unique_ptr< ArrayHandle<Scalar4> > h_embed_vel;
@@ -364,42 +329,49 @@ void mpcd::CellThermoCompute::calcInnerCellProperties()
         }
 
     // iterate over all of the inner cells and compute average velocity, energy, temperature
+    // each cell is summed by one thread, so no synchronization is needed
     const bool need_energy = m_flags[mpcd::detail::thermo_options::energy];
-    for (unsigned int k=lo.z; k < hi.z; ++k)
+    const unsigned int ndim = m_sysdef->getNDimensions();
+    const Index3D inner_ci(hi.x - lo.x, hi.y - lo.y, hi.z - lo.z);
+    #ifdef ENABLE_TBB
+    tbb::parallel_for(tbb::blocked_range<unsigned int>(0, inner_ci.getNumElements()),
+        [&](const tbb::blocked_range<unsigned int>& r) {
+        for (unsigned int idx = r.begin(); idx != r.end(); ++idx)
+    #else
+    for (unsigned int idx = 0; idx < inner_ci.getNumElements(); ++idx)
+    #endif
         {
-        for (unsigned int j=lo.y; j < hi.y; ++j)
-            {
-            for (unsigned int i=lo.x; i < hi.x; ++i)
-                {
-                const unsigned int cur_cell = ci(i,j,k);
+        const uint3 inner_cell = inner_ci.getTriple(idx);
+        const unsigned int cur_cell = ci(inner_cell.x + lo.x, inner_cell.y + lo.y, inner_cell.z + lo.z);
 
-                // compute the cell properties
-                double4 momentum; double ke(0.0); unsigned int np(0);
-                summer.compute(momentum, ke, np, cur_cell, need_energy);
+        // compute the cell properties
+        double4 momentum; double ke(0.0); unsigned int np(0);
+        summer.compute(momentum, ke, np, cur_cell, need_energy);
 
-                const double mass = momentum.w;
-                double3 vel_cm = make_double3(0.0,0.0,0.0);
-                if (mass > 0.)
-                    {
-                    vel_cm.x = momentum.x / mass;
-                    vel_cm.y = momentum.y / mass;
-                    vel_cm.z = momentum.z / mass;
-                    }
+        const double mass = momentum.w;
+        double3 vel_cm = make_double3(0.0,0.0,0.0);
+        if (mass > 0.)
+            {
+            vel_cm.x = momentum.x / mass;
+            vel_cm.y = momentum.y / mass;
+            vel_cm.z = momentum.z / mass;
+            }
 
-                h_cell_vel.data[cur_cell] = make_double4(vel_cm.x, vel_cm.y, vel_cm.z, mass);
-                if (need_energy)
-                    {
-                    double temp(0.0);
-                    if (np > 1)
-                        {
-                        const double ke_cm = 0.5 * mass * (vel_cm.x*vel_cm.x + vel_cm.y*vel_cm.y + vel_cm.z*vel_cm.z);
-                        temp = 2. * (ke - ke_cm) / (m_sysdef->getNDimensions() * (np-1));
-                        }
-                    h_cell_energy.data[cur_cell] = make_double3(ke, temp, __int_as_double(np));
-                    }
-                } // i
-            } //j
-        } // k
+        h_cell_vel.data[cur_cell] = make_double4(vel_cm.x, vel_cm.y, vel_cm.z, mass);
+        if (need_energy)
+            {
+            double temp(0.0);
+            if (np > 1)
+                {
+                const double ke_cm = 0.5 * mass * (vel_cm.x*vel_cm.x + vel_cm.y*vel_cm.y + vel_cm.z*vel_cm.z);
+                temp = 2. * (ke - ke_cm) / (ndim * (np-1));
+                }
+            h_cell_energy.data[cur_cell] = make_double3(ke, temp, __int_as_double(np));
+            }
+        }
+    #ifdef ENABLE_TBB
+        });
+    #endif
     }
 
 void mpcd::CellThermoCompute::computeNetProperties()
@@ -28,6 +28,97 @@
 
 namespace mpcd
 {
+namespace detail
+{
+//! Sums properties of an MPCD cell on the CPU
+/*!
+ * This lightweight class is used in beginOuterCellProperties(),
+ * calcInnerCellProperties(), and the fused collision pass of
+ * SRDCollisionMethod. The code has been consolidated into one place
+ * here to avoid some duplication.
+ */
+struct CellPropertySum
+    {
+    //! Constructor
+    /*!
+     * \param cell_list_ Cell list
+     * \param cell_np_ Number of particles per cell
+     * \param cli_ Cell list indexer
+     * \param vel_ MPCD particle velocities
+     * \param mass_ MPCD mass
+     * \param embed_vel_ Embedded particle velocities
+     * \param embed_idx_ Embedded particle indexes
+     * \param N_mpcd_ Number of MPCD particles
+     */
+    CellPropertySum(const unsigned int *cell_list_,
+                    const unsigned int *cell_np_,
+                    const Index2D& cli_,
+                    const mpcd::StorageScalar4 *vel_,
+                    const Scalar mass_,
+                    const Scalar4 *embed_vel_,
+                    const unsigned int *embed_idx_,
+                    const unsigned int N_mpcd_)
+        : cell_list(cell_list_), cell_np(cell_np_), cli(cli_), vel(vel_), mass(mass_),
+          embed_vel(embed_vel_), embed_idx(embed_idx_), N_mpcd(N_mpcd_)
+        {}
+
+    //! Computes the total momentum, kinetic energy, and number of particles in a cell
+    /*!
+     * \param momentum Cell momentum (output)
+     * \param ke Cell kinetic energy (output)
+     * \param np Number of particles in cell (output)
+     * \param cell Index of cell to evaluate
+     * \param energy If true, then the kinetic energy is evaluated into \a ke
+     */
+    inline void compute(double4& momentum, double& ke, unsigned int& np, const unsigned int cell, const bool energy)
+        {
+        momentum = make_double4(0.0, 0.0, 0.0, 0.0);
+        ke = 0.0;
+        np = cell_np[cell];
+
+        for (unsigned int offset = 0; offset < np; ++offset)
+            {
+            // Load particle data
+            const unsigned int cur_p = cell_list[cli(offset, cell)];
+            double3 vel_i;
+            double mass_i;
+            if (cur_p < N_mpcd)
+                {
+                const mpcd::StorageScalar4 vel_cell = vel[cur_p];
+                vel_i = make_double3(vel_cell.x, vel_cell.y, vel_cell.z);
+                mass_i = mass;
+                }
+            else
+                {
+                Scalar4 vel_m = embed_vel[embed_idx[cur_p - N_mpcd]];
+                vel_i = make_double3(vel_m.x, vel_m.y, vel_m.z);
+                mass_i = vel_m.w;
+                }
+
+            // add momentum
+            momentum.x += mass_i * vel_i.x;
+            momentum.y += mass_i * vel_i.y;
+            momentum.z += mass_i * vel_i.z;
+            momentum.w += mass_i;
+
+            // also compute ke of the particle
+            if (energy)
+                ke += 0.5 * mass_i * (vel_i.x * vel_i.x + vel_i.y * vel_i.y + vel_i.z * vel_i.z);
+            }
+    }
+
+    const unsigned int *cell_list;  //!< Cell list
+    const unsigned int *cell_np;    //!< Number of particles per cell
+    const Index2D cli;              //!< Cell list indexer
+
+    const mpcd::StorageScalar4 *vel;    //!< MPCD particle velocities
+    const Scalar mass;              //!< MPCD particle mass
+    const Scalar4 *embed_vel;       //!< Embedded particle velocities
+    const unsigned int *embed_idx;  //!< Embedded particle indexes
+    const unsigned int N_mpcd;      //!< Number of MPCD particles
+    };
+} // end namespace detail
+
 //! Computes the cell (thermodynamic) properties
 class PYBIND11_EXPORT CellThermoCompute : public Compute
     {
@@ -42,6 +133,21 @@ class PYBIND11_EXPORT CellThermoCompute : public Compute
         //! Compute the cell thermodynamic properties
         void compute(unsigned int timestep);
 
+        //! Begin a pass over the cells that computes the cell properties together with a collision
+        bool beginFusedCompute(unsigned int timestep);
+
+        //! Finish a pass over the cells started with beginFusedCompute()
+        void finishFusedCompute()
+            {
+            m_needs_net_reduce = true;
+            }
+
+        //! Get the thermo flags requested for the last call to compute
+        const mpcd::detail::ThermoFlags& getFlags() const
+            {
+            return m_flags;
+            }
+
         //! Get the cell indexer for the attached cell list
         const Index3D& getCellIndexer() const
             {
@@ -49,7 +49,7 @@ void mpcd::CellThermoComputeGPU::beginOuterCellProperties()
     ArrayHandle<unsigned int> d_cell_np(m_cl->getCellSizeArray(), access_location::device, access_mode::read);
     ArrayHandle<unsigned int> d_cell_list(m_cl->getCellList(), access_location::device, access_mode::read);
 
-    ArrayHandle<Scalar4> d_vel(m_mpcd_pdata->getVelocities(), access_location::device, access_mode::read);
+    ArrayHandle<mpcd::StorageScalar4> d_vel(m_mpcd_pdata->getVelocities(), access_location::device, access_mode::read);
 
     if (m_cl->getEmbeddedGroup())
         {
@@ -135,7 +135,7 @@ void mpcd::CellThermoComputeGPU::calcInnerCellProperties()
     ArrayHandle<unsigned int> d_cell_np(m_cl->getCellSizeArray(), access_location::device, access_mode::read);
     ArrayHandle<unsigned int> d_cell_list(m_cl->getCellList(), access_location::device, access_mode::read);
 
-    ArrayHandle<Scalar4> d_vel(m_mpcd_pdata->getVelocities(), access_location::device, access_mode::read);
+    ArrayHandle<mpcd::StorageScalar4> d_vel(m_mpcd_pdata->getVelocities(), access_location::device, access_mode::read);
 
     /*
      * Determine the inner cell indexer and offset. The inner indexer is the cube containing
@@ -54,7 +54,7 @@ __global__ void begin_cell_thermo(double4 *d_cell_vel,
                                   const unsigned int *d_cell_np,
                                   const unsigned int *d_cell_list,
                                   const Index2D cli,
-                                  const Scalar4 *d_vel,
+                                  const mpcd::StorageScalar4 *d_vel,
                                   const unsigned int N_mpcd,
                                   const Scalar mpcd_mass,
                                   const Scalar4 *d_embed_vel,
@@ -79,7 +79,7 @@ __global__ void begin_cell_thermo(double4 *d_cell_vel,
         double mass_i;
         if (cur_p < N_mpcd)
             {
-            Scalar4 vel_cell = d_vel[cur_p];
+            const mpcd::StorageScalar4 vel_cell = d_vel[cur_p];
             vel_i = make_double3(vel_cell.x, vel_cell.y, vel_cell.z);
             mass_i = mpcd_mass;
             }
@@ -216,7 +216,7 @@ __global__ void inner_cell_thermo(double4 *d_cell_vel,
                                   const unsigned int *d_cell_np,
                                   const unsigned int *d_cell_list,
                                   const Index2D cli,
-                                  const Scalar4 *d_vel,
+                                  const mpcd::StorageScalar4 *d_vel,
                                   const unsigned int N_mpcd,
                                   const Scalar mpcd_mass,
                                   const Scalar4 *d_embed_vel,
@@ -247,7 +247,7 @@ __global__ void inner_cell_thermo(double4 *d_cell_vel,
         double mass_i;
         if (cur_p < N_mpcd)
             {
-            Scalar4 vel_cell = d_vel[cur_p];
+            const mpcd::StorageScalar4 vel_cell = d_vel[cur_p];
             vel_i = make_double3(vel_cell.x, vel_cell.y, vel_cell.z);
             mass_i = mpcd_mass;
             }
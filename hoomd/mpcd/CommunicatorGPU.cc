@@ -338,7 +338,7 @@ void mpcd::CommunicatorGPU::setCommFlags(const BoxDim& box)
     if (m_prof) m_prof->push(m_exec_conf, "comm flags");
 
     ArrayHandle<unsigned int> d_comm_flag(m_mpcd_pdata->getCommFlags(), access_location::device, access_mode::overwrite);
-    ArrayHandle<Scalar4> d_pos(m_mpcd_pdata->getPositions(), access_location::device, access_mode::read);
+    ArrayHandle<mpcd::StorageScalar4> d_pos(m_mpcd_pdata->getPositions(), access_location::device, access_mode::read);
 
     m_flags_tuner->begin();
     mpcd::gpu::stage_particles(d_comm_flag.data,
@@ -44,14 +44,14 @@ namespace kernel
  * Checks for particles being out of bounds, and aggregates send flags.
  */
 __global__ void stage_particles(unsigned int *d_comm_flag,
-                                const Scalar4 *d_pos,
+                                const mpcd::StorageScalar4 *d_pos,
                                 unsigned int N,
                                 const BoxDim box)
     {
     const unsigned int idx = blockIdx.x * blockDim.x + threadIdx.x;
     if (idx >= N) return;
 
-    const Scalar4 postype = d_pos[idx];
+    const Scalar4 postype = mpcd::storage_to_scalar4(d_pos[idx]);
     const Scalar3 pos = make_scalar3(postype.x, postype.y, postype.z);
     const Scalar3 lo = box.getLo();
     const Scalar3 hi = box.getHi();
@@ -157,7 +157,7 @@ struct get_migrate_key : public thrust::unary_function<const unsigned int, unsig
  * \returns Accumulated communication flags of all particles
  */
 cudaError_t mpcd::gpu::stage_particles(unsigned int *d_comm_flag,
-                                        const Scalar4 *d_pos,
+                                        const mpcd::StorageScalar4 *d_pos,
                                         const unsigned int N,
                                         const BoxDim& box,
                                         const unsigned int block_size)
@@ -277,8 +277,10 @@ struct wrap_particle_op : public thrust::unary_function<const mpcd::detail::pdat
     __device__ mpcd::detail::pdata_element operator()(const mpcd::detail::pdata_element p)
         {
         mpcd::detail::pdata_element ret = p;
+        Scalar4 postype = mpcd::storage_to_scalar4(p.pos);
         int3 image = make_int3(0,0,0);
-        box.wrap(ret.pos, image);
+        box.wrap(postype, image);
+        ret.pos = mpcd::make_storage_scalar4(postype.x, postype.y, postype.z, postype.w);
         return ret;
         }
      };
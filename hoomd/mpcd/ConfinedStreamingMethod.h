@@ -18,6 +18,11 @@
 #include "StreamingMethod.h"
 #include <pybind11/pybind11.h>
 
+#ifdef ENABLE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#endif
+
 namespace mpcd
 {
 
@@ -105,20 +110,27 @@ void ConfinedStreamingMethod<Geometry>::stream(unsigned int timestep)
 
     const BoxDim& box = m_mpcd_sys->getCellList()->getCoverageBox();
 
-    ArrayHandle<Scalar4> h_pos(m_mpcd_pdata->getPositions(), access_location::host, access_mode::readwrite);
-    ArrayHandle<Scalar4> h_vel(m_mpcd_pdata->getVelocities(), access_location::host, access_mode::readwrite);
+    ArrayHandle<mpcd::StorageScalar4> h_pos(m_mpcd_pdata->getPositions(), access_location::host, access_mode::readwrite);
+    ArrayHandle<mpcd::StorageScalar4> h_vel(m_mpcd_pdata->getVelocities(), access_location::host, access_mode::readwrite);
     const Scalar mass = m_mpcd_pdata->getMass();
 
     // acquire polymorphic pointer to the external field
     const mpcd::ExternalField* field = (m_field) ? m_field->get(access_location::host) : nullptr;
 
+    // particles stream independently
+    #ifdef ENABLE_TBB
+    tbb::parallel_for(tbb::blocked_range<unsigned int>(0, m_mpcd_pdata->getN()),
+        [&](const tbb::blocked_range<unsigned int>& r) {
+        for (unsigned int cur_p = r.begin(); cur_p != r.end(); ++cur_p)
+    #else
     for (unsigned int cur_p = 0; cur_p < m_mpcd_pdata->getN(); ++cur_p)
+    #endif
         {
-        const Scalar4 postype = h_pos.data[cur_p];
+        const Scalar4 postype = mpcd::storage_to_scalar4(h_pos.data[cur_p]);
         Scalar3 pos = make_scalar3(postype.x, postype.y, postype.z);
         const unsigned int type = __scalar_as_int(postype.w);
 
-        const Scalar4 vel_cell = h_vel.data[cur_p];
+        const Scalar4 vel_cell = mpcd::storage_to_scalar4(h_vel.data[cur_p]);
         Scalar3 vel = make_scalar3(vel_cell.x, vel_cell.y, vel_cell.z);
         // estimate next velocity based on current acceleration
         if (field)
@@ -145,9 +157,12 @@ void ConfinedStreamingMethod<Geometry>::stream(unsigned int timestep)
         int3 image = make_int3(0,0,0);
         box.wrap(pos, image);
 
-        h_pos.data[cur_p] = make_scalar4(pos.x, pos.y, pos.z, __int_as_scalar(type));
-        h_vel.data[cur_p] = make_scalar4(vel.x, vel.y, vel.z, __int_as_scalar(mpcd::detail::NO_CELL));
+        h_pos.data[cur_p] = mpcd::make_storage_scalar4(pos.x, pos.y, pos.z, __int_as_scalar(type));
+        h_vel.data[cur_p] = mpcd::make_storage_scalar4(vel.x, vel.y, vel.z, __int_as_scalar(mpcd::detail::NO_CELL));
         }
+    #ifdef ENABLE_TBB
+        });
+    #endif
 
     // particles have moved, so the cell cache is no longer valid
     m_mpcd_pdata->invalidateCellCache();
@@ -183,12 +198,12 @@ void ConfinedStreamingMethod<Geometry>::validate()
 template<class Geometry>
 bool ConfinedStreamingMethod<Geometry>::validateParticles()
     {
-    ArrayHandle<Scalar4> h_pos(m_mpcd_pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<mpcd::StorageScalar4> h_pos(m_mpcd_pdata->getPositions(), access_location::host, access_mode::read);
     ArrayHandle<unsigned int> h_tag(m_mpcd_pdata->getTags(), access_location::host, access_mode::read);
 
     for (unsigned int idx = 0; idx < m_mpcd_pdata->getN(); ++idx)
         {
-        const Scalar4 postype = h_pos.data[idx];
+        const Scalar4 postype = mpcd::storage_to_scalar4(h_pos.data[idx]);
         const Scalar3 pos = make_scalar3(postype.x, postype.y, postype.z);
         if (m_geom->isOutside(pos))
             {
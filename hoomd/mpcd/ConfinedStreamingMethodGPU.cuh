@@ -25,8 +25,8 @@ namespace gpu
 struct stream_args_t
     {
     //! Constructor
-    stream_args_t(Scalar4 *_d_pos,
-                  Scalar4 *_d_vel,
+    stream_args_t(mpcd::StorageScalar4 *_d_pos,
+                  mpcd::StorageScalar4 *_d_vel,
                   const Scalar _mass,
                   const mpcd::ExternalField* _field,
                   const BoxDim& _box,
@@ -36,8 +36,8 @@ struct stream_args_t
         : d_pos(_d_pos), d_vel(_d_vel), mass(_mass), field(_field), box(_box), dt(_dt), N(_N), block_size(_block_size)
         { }
 
-    Scalar4 *d_pos;                     //!< Particle positions
-    Scalar4 *d_vel;                     //!< Particle velocities
+    mpcd::StorageScalar4 *d_pos;        //!< Particle positions
+    mpcd::StorageScalar4 *d_vel;        //!< Particle velocities
     const Scalar mass;                  //!< Particle mass
     const mpcd::ExternalField* field;   //!< Applied external field on particles
     const BoxDim& box;                  //!< Simulation box
@@ -80,8 +80,8 @@ namespace kernel
  * position update step. The particle positions and velocities are updated accordingly.
  */
 template<class Geometry>
-__global__ void confined_stream(Scalar4 *d_pos,
-                                Scalar4 *d_vel,
+__global__ void confined_stream(mpcd::StorageScalar4 *d_pos,
+                                mpcd::StorageScalar4 *d_vel,
                                 const Scalar mass,
                                 const mpcd::ExternalField* field,
                                 const BoxDim box,
@@ -94,11 +94,11 @@ __global__ void confined_stream(Scalar4 *d_pos,
     if (idx >= N)
         return;
 
-    const Scalar4 postype = d_pos[idx];
+    const Scalar4 postype = mpcd::storage_to_scalar4(d_pos[idx]);
     Scalar3 pos = make_scalar3(postype.x, postype.y, postype.z);
     const unsigned int type = __scalar_as_int(postype.w);
 
-    const Scalar4 vel_cell = d_vel[idx];
+    const Scalar4 vel_cell = mpcd::storage_to_scalar4(d_vel[idx]);
     Scalar3 vel = make_scalar3(vel_cell.x, vel_cell.y, vel_cell.z);
     // estimate next velocity based on current acceleration
     if (field)
@@ -125,8 +125,8 @@ __global__ void confined_stream(Scalar4 *d_pos,
     int3 image = make_int3(0,0,0);
     box.wrap(pos, image);
 
-    d_pos[idx] = make_scalar4(pos.x, pos.y, pos.z, __int_as_scalar(type));
-    d_vel[idx] = make_scalar4(vel.x, vel.y, vel.z, __int_as_scalar(mpcd::detail::NO_CELL));
+    d_pos[idx] = mpcd::make_storage_scalar4(pos.x, pos.y, pos.z, __int_as_scalar(type));
+    d_vel[idx] = mpcd::make_storage_scalar4(vel.x, vel.y, vel.z, __int_as_scalar(mpcd::detail::NO_CELL));
     }
 
 } // end namespace kernel
@@ -44,7 +44,7 @@ mpcd::ParticleData::ParticleData(unsigned int N,
                                  unsigned int ndimensions,
                                  std::shared_ptr<ExecutionConfiguration> exec_conf,
                                  std::shared_ptr<DomainDecomposition> decomposition)
-    : m_N(0), m_N_virtual(0), m_N_global(0), m_N_max(0), m_exec_conf(exec_conf), m_mass(1.0), m_valid_cell_cache(false)
+    : m_N(0), m_N_virtual(0), m_N_global(0), m_N_max(0), m_exec_conf(exec_conf), m_mass(1.0), m_valid_cell_cache(false), m_compact_storage(false)
     {
     m_exec_conf->msg->notice(5) << "Constructing MPCD ParticleData" << endl;
 
@@ -72,7 +72,7 @@ mpcd::ParticleData::ParticleData(std::shared_ptr<mpcd::ParticleDataSnapshot> sna
                                  const BoxDim& global_box,
                                  std::shared_ptr<const ExecutionConfiguration> exec_conf,
                                  std::shared_ptr<DomainDecomposition> decomposition)
-    : m_N(0), m_N_virtual(0), m_N_global(0), m_N_max(0), m_exec_conf(exec_conf), m_mass(1.0), m_valid_cell_cache(false)
+    : m_N(0), m_N_virtual(0), m_N_global(0), m_N_max(0), m_exec_conf(exec_conf), m_mass(1.0), m_valid_cell_cache(false), m_compact_storage(false)
     {
     m_exec_conf->msg->notice(5) << "Constructing MPCD ParticleData" << endl;
 
@@ -256,14 +256,17 @@ void mpcd::ParticleData::initializeFromSnapshot(const std::shared_ptr<const mpcd
             allocate(m_N);
 
         // Fill-up particle data arrays
-        ArrayHandle<Scalar4> h_pos(m_pos, access_location::host, access_mode::overwrite);
-        ArrayHandle<Scalar4> h_vel(m_vel, access_location::host, access_mode::overwrite);
+        ArrayHandle<mpcd::StorageScalar4> h_pos(m_pos, access_location::host, access_mode::overwrite);
+        ArrayHandle<mpcd::StorageScalar4> h_vel(m_vel, access_location::host, access_mode::overwrite);
         ArrayHandle<unsigned int> h_tag(m_tag, access_location::host, access_mode::overwrite);
         ArrayHandle<unsigned int> h_comm_flag(m_comm_flags, access_location::host, access_mode::overwrite);
         for (unsigned int idx = 0; idx < m_N; idx++)
             {
-            h_pos.data[idx] = make_scalar4(pos[idx].x,pos[idx].y, pos[idx].z, __int_as_scalar(type[idx]));
-            h_vel.data[idx] = make_scalar4(vel[idx].x, vel[idx].y, vel[idx].z, __int_as_scalar(mpcd::detail::NO_CELL));
+            h_pos.data[idx] = mpcd::make_storage_scalar4(pos[idx].x,pos[idx].y, pos[idx].z, __int_as_scalar(type[idx]));
+            h_vel.data[idx] = mpcd::make_storage_scalar4(vel[idx].x,
+                                                         vel[idx].y,
+                                                         vel[idx].z,
+                                                         __int_as_scalar(mpcd::detail::NO_CELL));
             h_tag.data[idx] = tag[idx];
             h_comm_flag.data[idx] = 0; // initialize with zero by default
             }
@@ -273,20 +276,20 @@ void mpcd::ParticleData::initializeFromSnapshot(const std::shared_ptr<const mpcd
         {
         allocate(snapshot->size);
 
-        ArrayHandle<Scalar4> h_pos(m_pos, access_location::host, access_mode::overwrite);
-        ArrayHandle<Scalar4> h_vel(m_vel, access_location::host, access_mode::overwrite);
+        ArrayHandle<mpcd::StorageScalar4> h_pos(m_pos, access_location::host, access_mode::overwrite);
+        ArrayHandle<mpcd::StorageScalar4> h_vel(m_vel, access_location::host, access_mode::overwrite);
         ArrayHandle<unsigned int> h_tag(m_tag, access_location::host, access_mode::overwrite);
 
         for (unsigned int snap_idx = 0; snap_idx < snapshot->size; ++snap_idx)
             {
-            h_pos.data[nglobal] = make_scalar4(snapshot->position[snap_idx].x,
-                                               snapshot->position[snap_idx].y,
-                                               snapshot->position[snap_idx].z,
-                                               __int_as_scalar(snapshot->type[snap_idx]));
-            h_vel.data[nglobal] = make_scalar4(snapshot->velocity[snap_idx].x,
-                                               snapshot->velocity[snap_idx].y,
-                                               snapshot->velocity[snap_idx].z,
-                                               __int_as_scalar(mpcd::detail::NO_CELL));
+            h_pos.data[nglobal] = mpcd::make_storage_scalar4(snapshot->position[snap_idx].x,
+                                                             snapshot->position[snap_idx].y,
+                                                             snapshot->position[snap_idx].z,
+                                                             __int_as_scalar(snapshot->type[snap_idx]));
+            h_vel.data[nglobal] = mpcd::make_storage_scalar4(snapshot->velocity[snap_idx].x,
+                                                             snapshot->velocity[snap_idx].y,
+                                                             snapshot->velocity[snap_idx].z,
+                                                             __int_as_scalar(mpcd::detail::NO_CELL));
             h_tag.data[nglobal] = nglobal;
             nglobal++;
             }
@@ -367,26 +370,27 @@ void mpcd::ParticleData::initializeRandom(unsigned int N, const BoxDim& local_bo
 
     // allocate and fill up with random values
     allocate(m_N);
-    ArrayHandle<Scalar4> h_pos(m_pos, access_location::host, access_mode::overwrite);
-    ArrayHandle<Scalar4> h_vel(m_vel, access_location::host, access_mode::overwrite);
+    ArrayHandle<mpcd::StorageScalar4> h_pos(m_pos, access_location::host, access_mode::overwrite);
+    ArrayHandle<mpcd::StorageScalar4> h_vel(m_vel, access_location::host, access_mode::overwrite);
     ArrayHandle<unsigned int> h_tag(m_tag, access_location::host, access_mode::overwrite);
     double3 vel_cm = make_double3(0,0,0);
     for (unsigned int i=0; i < m_N; ++i)
         {
-        h_pos.data[i] = make_scalar4(pos_x(mt),
-                                     pos_y(mt),
-                                     (ndimensions == 3) ? pos_z(mt) : Scalar(0.0),
-                                     __int_as_scalar(0));
-        h_vel.data[i] = make_scalar4(vel(mt),
-                                     vel(mt),
-                                     (ndimensions == 3) ? vel(mt) : Scalar(0.0),
-                                     __int_as_scalar(mpcd::detail::NO_CELL));
+        h_pos.data[i] = mpcd::make_storage_scalar4(pos_x(mt),
+                                                   pos_y(mt),
+                                                   (ndimensions == 3) ? pos_z(mt) : Scalar(0.0),
+                                                   __int_as_scalar(0));
+        h_vel.data[i] = mpcd::make_storage_scalar4(vel(mt),
+                                                   vel(mt),
+                                                   (ndimensions == 3) ? vel(mt) : Scalar(0.0),
+                                                   __int_as_scalar(mpcd::detail::NO_CELL));
         h_tag.data[i] = tag_start + i;
 
         // add up total velocity
-        vel_cm.x += h_vel.data[i].x;
-        vel_cm.y += h_vel.data[i].y;
-        vel_cm.z += h_vel.data[i].z;
+        const Scalar4 vel_i = mpcd::storage_to_scalar4(h_vel.data[i]);
+        vel_cm.x += vel_i.x;
+        vel_cm.y += vel_i.y;
+        vel_cm.z += vel_i.z;
         }
 
     // compute average velocity per-particle to remove
@@ -406,9 +410,11 @@ void mpcd::ParticleData::initializeRandom(unsigned int N, const BoxDim& local_bo
     // subtract center-of-mass velocity
     for (unsigned int i=0; i < m_N; ++i)
         {
-        h_vel.data[i].x -= vel_cm.x;
-        h_vel.data[i].y -= vel_cm.y;
-        h_vel.data[i].z -= vel_cm.z;
+        const Scalar4 vel_i = mpcd::storage_to_scalar4(h_vel.data[i]);
+        h_vel.data[i] = mpcd::make_storage_scalar4(vel_i.x - vel_cm.x,
+                                                   vel_i.y - vel_cm.y,
+                                                   vel_i.z - vel_cm.z,
+                                                   vel_i.w);
         }
     }
 
@@ -421,8 +427,8 @@ void mpcd::ParticleData::takeSnapshot(std::shared_ptr<mpcd::ParticleDataSnapshot
     {
     m_exec_conf->msg->notice(4) << "MPCD ParticleData: taking snapshot" << std::endl;
 
-    ArrayHandle<Scalar4> h_pos(m_pos, access_location::host, access_mode::read);
-    ArrayHandle<Scalar4> h_vel(m_vel, access_location::host, access_mode::read);
+    ArrayHandle<mpcd::StorageScalar4> h_pos(m_pos, access_location::host, access_mode::read);
+    ArrayHandle<mpcd::StorageScalar4> h_vel(m_vel, access_location::host, access_mode::read);
     ArrayHandle<unsigned int> h_tag(m_tag, access_location::host, access_mode::read);
 
 #ifdef ENABLE_MPI
@@ -435,9 +441,11 @@ void mpcd::ParticleData::takeSnapshot(std::shared_ptr<mpcd::ParticleDataSnapshot
         std::vector<unsigned int> tag(m_N);
         for (unsigned int idx = 0; idx < m_N; ++idx)
             {
-            pos[idx] = make_scalar3(h_pos.data[idx].x, h_pos.data[idx].y, h_pos.data[idx].z);
-            vel[idx] = make_scalar3(h_vel.data[idx].x, h_vel.data[idx].y, h_vel.data[idx].z);
-            type[idx] = __scalar_as_int(h_pos.data[idx].w);
+            const Scalar4 postype = mpcd::storage_to_scalar4(h_pos.data[idx]);
+            const Scalar4 vel_i = mpcd::storage_to_scalar4(h_vel.data[idx]);
+            pos[idx] = make_scalar3(postype.x, postype.y, postype.z);
+            vel[idx] = make_scalar3(vel_i.x, vel_i.y, vel_i.z);
+            type[idx] = __scalar_as_int(postype.w);
             tag[idx] = h_tag.data[idx];
             }
 
@@ -501,7 +509,7 @@ void mpcd::ParticleData::takeSnapshot(std::shared_ptr<mpcd::ParticleDataSnapshot
             const unsigned int snap_idx = h_tag.data[idx];
 
             // make sure the position stored in the snapshot is within the boundaries
-            Scalar4 postype = h_pos.data[idx];
+            const Scalar4 postype = mpcd::storage_to_scalar4(h_pos.data[idx]);
             Scalar3 pos_i = make_scalar3(postype.x, postype.y, postype.z);
             const unsigned int type_i = __scalar_as_int(postype.w);
             int3 img = make_int3(0,0,0);
@@ -509,7 +517,7 @@ void mpcd::ParticleData::takeSnapshot(std::shared_ptr<mpcd::ParticleDataSnapshot
 
             // push particle into the snapshot
             snapshot->position[snap_idx] = vec3<Scalar>(pos_i);
-            snapshot->velocity[snap_idx] = vec3<Scalar>(h_vel.data[idx]);
+            snapshot->velocity[snap_idx] = vec3<Scalar>(mpcd::storage_to_scalar4(h_vel.data[idx]));
             snapshot->type[snap_idx] = type_i;
             }
         }
@@ -600,6 +608,48 @@ void mpcd::ParticleData::setNGlobal(unsigned int nglobal)
     // TODO: any signaling if needed to subscribers
     }
 
+/*!
+ * \param compact If true, the alternate arrays are only allocated on demand
+ *
+ * Switching to compact storage frees the alternate arrays immediately. Switching back
+ * allocates them so that they persist with the particle data again.
+ */
+void mpcd::ParticleData::setCompactStorage(bool compact)
+    {
+    m_compact_storage = compact;
+    if (m_compact_storage)
+        {
+        releaseAlternate();
+        }
+    else
+        {
+        getAltPositions();
+        getAltVelocities();
+        getAltTags();
+        #ifdef ENABLE_MPI
+        if (m_decomposition)
+            getAltCommFlags();
+        #endif // ENABLE_MPI
+        }
+    }
+
+/*!
+ * The alternate arrays hold no data between operations that use them, so they can be freed
+ * and reallocated the next time they are requested. This does nothing unless storage is compact,
+ * so callers can release the arrays unconditionally when they are done with them.
+ */
+void mpcd::ParticleData::releaseAlternate()
+    {
+    if (!m_compact_storage) return;
+
+    GPUArray<mpcd::StorageScalar4>().swap(m_pos_alt);
+    GPUArray<mpcd::StorageScalar4>().swap(m_vel_alt);
+    GPUArray<unsigned int>().swap(m_tag_alt);
+    #ifdef ENABLE_MPI
+    GPUArray<unsigned int>().swap(m_comm_flags_alt);
+    #endif // ENABLE_MPI
+    }
+
 /*!
  * \param N_max maximum number of particles that can be held in allocation
  *
@@ -611,10 +661,10 @@ void mpcd::ParticleData::allocate(unsigned int N_max)
     m_N_max = N_max;
 
     //! Allocate the particle data
-    GPUArray<Scalar4> pos(N_max, m_exec_conf);
+    GPUArray<mpcd::StorageScalar4> pos(N_max, m_exec_conf);
     m_pos.swap(pos);
 
-    GPUArray<Scalar4> vel(N_max, m_exec_conf);
+    GPUArray<mpcd::StorageScalar4> vel(N_max, m_exec_conf);
     m_vel.swap(vel);
 
     GPUArray<unsigned int> tag(N_max, m_exec_conf);
@@ -628,22 +678,25 @@ void mpcd::ParticleData::allocate(unsigned int N_max)
         }
     #endif // ENABLE_MPI
 
-    // Allocate the alternate data
-    GPUArray<Scalar4> pos_alt(N_max, m_exec_conf);
-    m_pos_alt.swap(pos_alt);
-
-    GPUArray<Scalar4> vel_alt(N_max, m_exec_conf);
-    m_vel_alt.swap(vel_alt);
-
-    GPUArray<unsigned int> tag_alt(N_max, m_exec_conf);
-    m_tag_alt.swap(tag_alt);
+    // Allocate the alternate data, unless it is allocated on demand
+    if (m_compact_storage)
+        {
+        releaseAlternate();
+        }
+    else
+        {
+        allocateAlternate(m_pos_alt);
+        allocateAlternate(m_vel_alt);
+        allocateAlternate(m_tag_alt);
+        #ifdef ENABLE_MPI
+        if (m_decomposition)
+            allocateAlternate(m_comm_flags_alt);
+        #endif // ENABLE_MPI
+        }
 
     #ifdef ENABLE_MPI
     if (m_decomposition)
         {
-        GPUArray<unsigned int> comm_flags_alt(N_max, m_exec_conf);
-        m_comm_flags_alt.swap(comm_flags_alt);
-
         GPUArray<unsigned int> remove_ids(N_max, m_exec_conf);
         m_remove_ids.swap(remove_ids);
 
@@ -681,14 +734,22 @@ void mpcd::ParticleData::reallocate(unsigned int N_max)
         }
     #endif // ENABLE_MPI
 
-    // Reallocate the alternate data
-    m_pos_alt.resize(N_max);
-    m_vel_alt.resize(N_max);
-    m_tag_alt.resize(N_max);
+    // Reallocate the alternate data, or drop it if it will be allocated on demand
+    if (m_compact_storage)
+        {
+        releaseAlternate();
+        }
+    else
+        {
+        m_pos_alt.resize(N_max);
+        m_vel_alt.resize(N_max);
+        m_tag_alt.resize(N_max);
+        }
     #ifdef ENABLE_MPI
     if (m_decomposition)
         {
-        m_comm_flags_alt.resize(N_max);
+        if (!m_compact_storage)
+            m_comm_flags_alt.resize(N_max);
         m_remove_ids.resize(N_max);
 
         #ifdef ENABLE_HIP
@@ -792,8 +853,8 @@ Scalar3 mpcd::ParticleData::getPosition(unsigned int idx) const
         m_exec_conf->msg->error() << "Requested MPCD particle local index " << idx << " is out of range" << endl;
         throw std::runtime_error("Error accessing MPCD particle data.");
         }
-    ArrayHandle<Scalar4> h_pos(m_pos, access_location::host, access_mode::read);
-    const Scalar4 postype = h_pos.data[idx];
+    ArrayHandle<mpcd::StorageScalar4> h_pos(m_pos, access_location::host, access_mode::read);
+    const Scalar4 postype = mpcd::storage_to_scalar4(h_pos.data[idx]);
     return make_scalar3(postype.x, postype.y, postype.z);
     }
 
@@ -809,8 +870,8 @@ unsigned int mpcd::ParticleData::getType(unsigned int idx) const
         m_exec_conf->msg->error() << "Requested MPCD particle local index " << idx << " is out of range" << endl;
         throw std::runtime_error("Error accessing MPCD particle data.");
         }
-    ArrayHandle<Scalar4> h_pos(m_pos, access_location::host, access_mode::read);
-    const Scalar4 postype = h_pos.data[idx];
+    ArrayHandle<mpcd::StorageScalar4> h_pos(m_pos, access_location::host, access_mode::read);
+    const Scalar4 postype = mpcd::storage_to_scalar4(h_pos.data[idx]);
     return __scalar_as_int(postype.w);
     }
 
@@ -826,8 +887,8 @@ Scalar3 mpcd::ParticleData::getVelocity(unsigned int idx) const
         m_exec_conf->msg->error() << "Requested MPCD particle local index " << idx << " is out of range" << endl;
         throw std::runtime_error("Error accessing MPCD particle data.");
         }
-    ArrayHandle<Scalar4> h_vel(m_vel, access_location::host, access_mode::read);
-    const Scalar4 velcell = h_vel.data[idx];
+    ArrayHandle<mpcd::StorageScalar4> h_vel(m_vel, access_location::host, access_mode::read);
+    const Scalar4 velcell = mpcd::storage_to_scalar4(h_vel.data[idx]);
     return make_scalar3(velcell.x, velcell.y, velcell.z);
     }
 
@@ -923,8 +984,8 @@ void mpcd::ParticleData::removeParticles(GPUVector<mpcd::detail::pdata_element>&
         ArrayHandle<mpcd::detail::pdata_element> h_out(out, access_location::host, access_mode::overwrite);
         ArrayHandle<unsigned int> h_remove_idx(m_remove_ids, access_location::host, access_mode::read);
 
-        ArrayHandle<Scalar4> h_pos(m_pos, access_location::host, access_mode::readwrite);
-        ArrayHandle<Scalar4> h_vel(m_vel, access_location::host, access_mode::readwrite);
+        ArrayHandle<mpcd::StorageScalar4> h_pos(m_pos, access_location::host, access_mode::readwrite);
+        ArrayHandle<mpcd::StorageScalar4> h_vel(m_vel, access_location::host, access_mode::readwrite);
         ArrayHandle<unsigned int> h_tag(m_tag, access_location::host, access_mode::readwrite);
         ArrayHandle<unsigned int> h_comm_flags(m_comm_flags, access_location::host, access_mode::readwrite);
 
@@ -984,8 +1045,8 @@ void mpcd::ParticleData::addParticles(const GPUVector<mpcd::detail::pdata_elemen
 
         {
         // access particle data arrays
-        ArrayHandle<Scalar4> h_pos(getPositions(), access_location::host, access_mode::readwrite);
-        ArrayHandle<Scalar4> h_vel(getVelocities(), access_location::host, access_mode::readwrite);
+        ArrayHandle<mpcd::StorageScalar4> h_pos(getPositions(), access_location::host, access_mode::readwrite);
+        ArrayHandle<mpcd::StorageScalar4> h_vel(getVelocities(), access_location::host, access_mode::readwrite);
         ArrayHandle<unsigned int> h_tag(getTags(), access_location::host, access_mode::readwrite);
         ArrayHandle<unsigned int> h_comm_flags(m_comm_flags, access_location::host, access_mode::readwrite);
 
@@ -1088,8 +1149,8 @@ void mpcd::ParticleData::removeParticlesGPU(GPUVector<mpcd::detail::pdata_elemen
         ArrayHandle<mpcd::detail::pdata_element> d_out(out, access_location::device, access_mode::overwrite);
 
         // access particle data arrays to read from
-        ArrayHandle<Scalar4> d_pos(m_pos, access_location::device, access_mode::readwrite);
-        ArrayHandle<Scalar4> d_vel(m_vel, access_location::device, access_mode::readwrite);
+        ArrayHandle<mpcd::StorageScalar4> d_pos(m_pos, access_location::device, access_mode::readwrite);
+        ArrayHandle<mpcd::StorageScalar4> d_vel(m_vel, access_location::device, access_mode::readwrite);
         ArrayHandle<unsigned int> d_tag(m_tag, access_location::device, access_mode::readwrite);
         ArrayHandle<unsigned int> d_comm_flags(m_comm_flags, access_location::device, access_mode::readwrite);
 
@@ -1137,8 +1198,8 @@ void mpcd::ParticleData::addParticlesGPU(const GPUVector<mpcd::detail::pdata_ele
 
         {
         // access particle data arrays
-        ArrayHandle<Scalar4> d_pos(m_pos, access_location::device, access_mode::readwrite);
-        ArrayHandle<Scalar4> d_vel(m_vel, access_location::device, access_mode::readwrite);
+        ArrayHandle<mpcd::StorageScalar4> d_pos(m_pos, access_location::device, access_mode::readwrite);
+        ArrayHandle<mpcd::StorageScalar4> d_vel(m_vel, access_location::device, access_mode::readwrite);
         ArrayHandle<unsigned int> d_tag(m_tag, access_location::device, access_mode::readwrite);
         ArrayHandle<unsigned int> d_comm_flags(m_comm_flags, access_location::device, access_mode::readwrite);
 
@@ -1202,5 +1263,6 @@ void mpcd::detail::export_ParticleData(pybind11::module& m)
     .def("getNameByType", &mpcd::ParticleData::getNameByType)
     .def("getTypeByName", &mpcd::ParticleData::getTypeByName)
     .def_property("mass", &mpcd::ParticleData::getMass, &mpcd::ParticleData::setMass)
+    .def_property("compact_storage", &mpcd::ParticleData::getCompactStorage, &mpcd::ParticleData::setCompactStorage)
     ;
     }
@@ -38,8 +38,8 @@ cudaError_t partition_particles(void *d_tmp,
 
 //! Pack particle data into output buffer and remove marked particles
 cudaError_t remove_particles(mpcd::detail::pdata_element *d_out,
-                             Scalar4 *d_pos,
-                             Scalar4 *d_vel,
+                             mpcd::StorageScalar4 *d_pos,
+                             mpcd::StorageScalar4 *d_vel,
                              unsigned int *d_tag,
                              unsigned int *d_comm_flags,
                              unsigned int *d_remove_ids,
@@ -50,8 +50,8 @@ cudaError_t remove_particles(mpcd::detail::pdata_element *d_out,
 //! Update particle data with new particles
 void add_particles(unsigned int old_nparticles,
                    unsigned int num_add_ptls,
-                   Scalar4 *d_pos,
-                   Scalar4 *d_vel,
+                   mpcd::StorageScalar4 *d_pos,
+                   mpcd::StorageScalar4 *d_vel,
                    unsigned int *d_tag,
                    unsigned int *d_comm_flags,
                    const mpcd::detail::pdata_element *d_in,
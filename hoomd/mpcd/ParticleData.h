@@ -44,10 +44,17 @@ namespace mpcd
 /*!
  * MPCD particles are characterized by position, velocity, and mass. We assume all
  * particles have the same mass. The data is laid out as follows:
- * - position + type in array of Scalar4
- * - velocity + cell index in array of Scalar4
+ * - position + type in array of mpcd::StorageScalar4
+ * - velocity + cell index in array of mpcd::StorageScalar4
  * - tag in array of unsigned int
  *
+ * mpcd::StorageScalar4 is Scalar4 by default. When HOOMD is built with ENABLE_MPCD_MIXED_PRECISION,
+ * it is float4, which halves the memory of the positions and velocities in double precision builds.
+ * The type and cell index in w are stored bit for bit. Methods that read the arrays convert each
+ * entry with mpcd::storage_to_scalar4() and compute in Scalar precision, and they write results
+ * back with mpcd::make_storage_scalar4(). Snapshots are always in Scalar precision, and particles
+ * are communicated in the storage precision.
+ *
  * Unlike the standard ParticleData, a reverse tag mapping is not currently maintained
  * in order to save local memory. (That is, it is possible to read the tag of a local particle,
  * but it is not possible to efficiently find the local particle that has a given
@@ -57,6 +64,15 @@ namespace mpcd
  * are based on around the velocity and cell. For details of what the cell means,
  * refer to the mpcd::CellList.
  *
+ * Alternate position, velocity, and tag arrays are kept for operations like sorting that
+ * write a reordered copy of the data and then swap it in. By default, these arrays are
+ * allocated persistently with the particle data. When compact storage is enabled, the
+ * alternate arrays are only allocated on demand by getAltPositions(), getAltVelocities(),
+ * and getAltTags(), and they are freed again by releaseAlternate(). Methods that use an
+ * alternate array as scratch space (the sorters and the AT collision method) release it when
+ * they are done. This removes the alternate copies between sorts and collisions, which saves at
+ * most about half of the memory per particle.
+ *
  * \todo Because the local cell index changes with position, a signal will be put
  * in place to indicate when the cached cell index is still valid.
  *
@@ -159,13 +175,13 @@ class PYBIND11_EXPORT ParticleData
         std::string getNameByType(unsigned int type) const;
 
         //! Get array of MPCD particle positions
-        const GPUArray<Scalar4>& getPositions() const
+        const GPUArray<mpcd::StorageScalar4>& getPositions() const
             {
             return m_pos;
             }
 
         //! Get array of MPCD particle velocities
-        const GPUArray<Scalar4>& getVelocities() const
+        const GPUArray<mpcd::StorageScalar4>& getVelocities() const
             {
             return m_vel;
             }
@@ -197,6 +213,15 @@ class PYBIND11_EXPORT ParticleData
         //! Get the tag of the particle on the local rank
         unsigned int getTag(unsigned int idx) const;
 
+        //! Get whether the alternate arrays are only allocated on demand
+        bool getCompactStorage() const
+            {
+            return m_compact_storage;
+            }
+
+        //! Set whether the alternate arrays are only allocated on demand
+        void setCompactStorage(bool compact);
+
         //! Set the profiler for the particle data to use
         void setProfiler(std::shared_ptr<Profiler> prof)
             {
@@ -230,8 +255,10 @@ class PYBIND11_EXPORT ParticleData
         //! \name swap methods
         //@{
         //! Get alternate array of MPCD particle positions
-        const GPUArray<Scalar4>& getAltPositions() const
+        const GPUArray<mpcd::StorageScalar4>& getAltPositions()
             {
+            if (m_pos_alt.getNumElements() < m_N_max)
+                allocateAlternate(m_pos_alt);
             return m_pos_alt;
             }
 
@@ -242,8 +269,10 @@ class PYBIND11_EXPORT ParticleData
             }
 
         //! Get alternate array of MPCD particle velocities
-        const GPUArray<Scalar4>& getAltVelocities() const
+        const GPUArray<mpcd::StorageScalar4>& getAltVelocities()
             {
+            if (m_vel_alt.getNumElements() < m_N_max)
+                allocateAlternate(m_vel_alt);
             return m_vel_alt;
             }
 
@@ -254,8 +283,10 @@ class PYBIND11_EXPORT ParticleData
             }
 
         //! Get alternate array of MPCD particle tags
-        const GPUArray<unsigned int>& getAltTags() const
+        const GPUArray<unsigned int>& getAltTags()
             {
+            if (m_tag_alt.getNumElements() < m_N_max)
+                allocateAlternate(m_tag_alt);
             return m_tag_alt;
             }
 
@@ -264,6 +295,15 @@ class PYBIND11_EXPORT ParticleData
             {
             m_tag.swap(m_tag_alt);
             }
+
+        //! Free the alternate arrays if storage is compact
+        void releaseAlternate();
+
+        //! Check whether any of the alternate position, velocity, or tag arrays is allocated
+        bool hasAlternate() const
+            {
+            return !m_pos_alt.isNull() || !m_vel_alt.isNull() || !m_tag_alt.isNull();
+            }
         //@}
 
         //! \name signal methods
@@ -393,8 +433,10 @@ class PYBIND11_EXPORT ParticleData
             }
 
         //! Get the alternate MPCD particle communication flags
-        const GPUArray<unsigned int>& getAltCommFlags() const
+        const GPUArray<unsigned int>& getAltCommFlags()
             {
+            if (m_comm_flags_alt.getNumElements() < m_N_max)
+                allocateAlternate(m_comm_flags_alt);
             return m_comm_flags_alt;
             }
 
@@ -417,8 +459,8 @@ class PYBIND11_EXPORT ParticleData
         std::shared_ptr<DomainDecomposition> m_decomposition;       //!< Domain decomposition
         std::shared_ptr<Profiler> m_prof;                           //!< Profiler
 
-        GPUArray<Scalar4> m_pos;    //!< MPCD particle positions plus type
-        GPUArray<Scalar4> m_vel;    //!< MPCD particle velocities plus cell list id
+        GPUArray<mpcd::StorageScalar4> m_pos;   //!< MPCD particle positions plus type
+        GPUArray<mpcd::StorageScalar4> m_vel;   //!< MPCD particle velocities plus cell list id
         Scalar m_mass;              //!< MPCD particle mass
         GPUArray<unsigned int> m_tag;   //!< MPCD particle tags
         std::vector<std::string> m_type_mapping;  //!< Type name mapping
@@ -426,8 +468,8 @@ class PYBIND11_EXPORT ParticleData
         GPUArray<unsigned int> m_comm_flags;    //!< MPCD particle communication flags
         #endif // ENABLE_MPI
 
-        GPUArray<Scalar4> m_pos_alt;        //!< Alternate position array
-        GPUArray<Scalar4> m_vel_alt;        //!< Alternate velocity array
+        GPUArray<mpcd::StorageScalar4> m_pos_alt;   //!< Alternate position array
+        GPUArray<mpcd::StorageScalar4> m_vel_alt;   //!< Alternate velocity array
         GPUArray<unsigned int> m_tag_alt;   //!< Alternate tag array
         #ifdef ENABLE_MPI
         GPUArray<unsigned int> m_comm_flags_alt;    //!< Alternate communication flags
@@ -443,6 +485,7 @@ class PYBIND11_EXPORT ParticleData
         #endif // ENABLE_MPI
 
         bool m_valid_cell_cache;    //!< Flag for validity of cell cache
+        bool m_compact_storage;     //!< If true, the alternate arrays are only allocated on demand
         SortSignal m_sort_signal;   //!< Signal triggered when particles are sorted
         Nano::Signal<void ()> m_virtual_signal; //!< Signal for number of virtual particles changing
 
@@ -461,6 +504,14 @@ class PYBIND11_EXPORT ParticleData
         //! Reallocate data arrays
         void reallocate(unsigned int N_max);
 
+        //! Allocate an alternate array to hold the maximum number of particles
+        template<class T>
+        void allocateAlternate(GPUArray<T>& alt)
+            {
+            GPUArray<T> new_alt(m_N_max, m_exec_conf);
+            alt.swap(new_alt);
+            }
+
         const static float resize_factor; //!< Amortized growth factor the data arrays
         //! Resize the data
         void resize(unsigned int N);
@@ -19,8 +19,94 @@
  */
 
 #include "hoomd/HOOMDMath.h"
+
+#ifdef __HIPCC__
+#define HOSTDEVICE __host__ __device__
+#else
+#define HOSTDEVICE
+#endif // __HIPCC__
+
 namespace mpcd
 {
+#ifdef ENABLE_MPCD_MIXED_PRECISION
+//! Floating point type that stores the MPCD particle positions and velocities (single precision)
+typedef float StorageScalar;
+//! Floating point type with x,y,z,w elements that stores the MPCD particle positions and velocities
+typedef float4 StorageScalar4;
+#else
+//! Floating point type that stores the MPCD particle positions and velocities (same as Scalar)
+typedef Scalar StorageScalar;
+//! Floating point type with x,y,z,w elements that stores the MPCD particle positions and velocities
+typedef Scalar4 StorageScalar4;
+#endif
+
+//! Stuff an integer into a StorageScalar
+/*!
+ * \param a Integer to store
+ * \returns A StorageScalar with the same bits as \a a, the same as __int_as_scalar() without mixed precision
+ */
+HOSTDEVICE inline StorageScalar int_as_storage_scalar(int a)
+    {
+    #ifdef ENABLE_MPCD_MIXED_PRECISION
+    union
+        {
+        int a; float b;
+        } u;
+    u.a = a;
+    return u.b;
+    #else
+    return __int_as_scalar(a);
+    #endif
+    }
+
+//! Extract an integer from a StorageScalar stuffed by int_as_storage_scalar()
+HOSTDEVICE inline int storage_scalar_as_int(StorageScalar b)
+    {
+    #ifdef ENABLE_MPCD_MIXED_PRECISION
+    union
+        {
+        int a; float b;
+        } u;
+    u.b = b;
+    return u.a;
+    #else
+    return __scalar_as_int(b);
+    #endif
+    }
+
+//! Pack a position or velocity into the storage precision
+/*!
+ * \param x x component
+ * \param y y component
+ * \param z z component
+ * \param w Integer (type or cell index) stuffed by __int_as_scalar()
+ *
+ * The x, y, and z components are rounded to the storage precision. The integer in \a w
+ * is copied bit for bit so that it survives the change of precision.
+ */
+HOSTDEVICE inline StorageScalar4 make_storage_scalar4(Scalar x, Scalar y, Scalar z, Scalar w)
+    {
+    #ifdef ENABLE_MPCD_MIXED_PRECISION
+    return make_float4(float(x), float(y), float(z), int_as_storage_scalar(__scalar_as_int(w)));
+    #else
+    return make_scalar4(x, y, z, w);
+    #endif
+    }
+
+//! Unpack a position or velocity from the storage precision
+/*!
+ * \param v Packed position or velocity
+ * \returns The position or velocity in Scalar precision, with the integer in w copied bit for bit
+ */
+HOSTDEVICE inline Scalar4 storage_to_scalar4(const StorageScalar4& v)
+    {
+    #ifdef ENABLE_MPCD_MIXED_PRECISION
+    return make_scalar4(v.x, v.y, v.z, __int_as_scalar(storage_scalar_as_int(v.w)));
+    #else
+    return v;
+    #endif
+    }
+
 namespace detail
 {
 //! Sentinel value to signify that this particle is not placed in a cell
@@ -30,14 +116,15 @@ const unsigned int NO_CELL = 0xffffffff;
 //! Structure to store packed MPCD particle data
 /*!
  * This structure is used mostly for MPI communication during particle migration.
+ * The position and velocity are sent in the storage precision.
  *
  * \sa mpcd::ParticleData::addParticles
  * \sa mpcd::ParticleData::removeParticles
  */
 struct pdata_element
     {
-    Scalar4 pos;            //!< Position
-    Scalar4 vel;            //!< Velocity
+    StorageScalar4 pos;     //!< Position
+    StorageScalar4 vel;     //!< Velocity
     unsigned int tag;       //!< Global tag
     unsigned int comm_flag; //!< Communication flag
     };
@@ -46,4 +133,6 @@ struct pdata_element
 } // end namespace detail
 } // end namespace mpcd
 
+#undef HOSTDEVICE
+
 #endif // MPCD_PARTICLE_DATA_UTILITIES_H_
@@ -12,6 +12,109 @@
 #include "hoomd/RandomNumbers.h"
 #include "hoomd/RNGIdentifiers.h"
 
+#ifdef ENABLE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#endif
+
+namespace mpcd
+{
+namespace detail
+{
+//! Draw the rotation vector and the thermostat scale factor of a cell
+/*!
+ * \param rotvec Rotation vector (output)
+ * \param factor Scale factor (output)
+ * \param rng Random number generator of the cell
+ * \param use_thermostat If true, draw the scale factor
+ * \param cell_energy Kinetic energy, temperature, and number of particles in the cell
+ * \param ndim Number of dimensions
+ * \param T_set Thermostat temperature
+ */
+inline void drawSRDCell(double3& rotvec,
+                        double& factor,
+                        hoomd::RandomGenerator& rng,
+                        const bool use_thermostat,
+                        const double3& cell_energy,
+                        const unsigned int ndim,
+                        const Scalar T_set)
+    {
+    // draw rotation vector off the surface of the sphere
+    hoomd::SpherePointGenerator<double> sphgen;
+    sphgen(rng, rotvec);
+
+    factor = 1.0;
+    if (use_thermostat)
+        {
+        const unsigned int np = __double_as_int(cell_energy.z);
+        if (np > 1)
+            {
+            // the total number of degrees of freedom in the cell divided by 2
+            const double alpha = ndim*(np-1)/(double)2.;
+
+            // draw a random kinetic energy for the cell at the set temperature
+            hoomd::GammaDistribution<double> gamma_gen(alpha,T_set);
+            const double rand_ke = gamma_gen(rng);
+
+            // generate the scale factor from the current temperature
+            // (don't use the kinetic energy of this cell, since this
+            // is total not relative to COM)
+            const double cur_ke = alpha * cell_energy.y;
+            factor = (cur_ke > 0.) ? fast::sqrt(rand_ke/cur_ke) : 1.;
+            }
+        }
+    }
+
+//! Rotate a particle velocity relative to its cell velocity
+/*!
+ * \param vel Particle velocity
+ * \param avg_vel Cell velocity
+ * \param rot_vec Rotation vector
+ * \param cos_a Cosine of the rotation angle
+ * \param sin_a Sine of the rotation angle
+ * \param factor Scale factor for the relative velocity
+ * \returns The new particle velocity
+ */
+inline double3 rotateSRDVelocity(double3 vel,
+                                 const double4& avg_vel,
+                                 const double3& rot_vec,
+                                 const double cos_a,
+                                 const double sin_a,
+                                 const double factor)
+    {
+    const double one_minus_cos_a = 1.0 - cos_a;
+
+    // subtract average velocity
+    vel.x -= avg_vel.x;
+    vel.y -= avg_vel.y;
+    vel.z -= avg_vel.z;
+
+    // perform the rotation in double precision
+    double3 new_vel;
+    new_vel.x = (cos_a + rot_vec.x*rot_vec.x*one_minus_cos_a) * vel.x;
+    new_vel.x += (rot_vec.x*rot_vec.y*one_minus_cos_a - sin_a*rot_vec.z) * vel.y;
+    new_vel.x += (rot_vec.x*rot_vec.z*one_minus_cos_a + sin_a*rot_vec.y) * vel.z;
+
+    new_vel.y = (cos_a + rot_vec.y*rot_vec.y*one_minus_cos_a) * vel.y;
+    new_vel.y += (rot_vec.x*rot_vec.y*one_minus_cos_a + sin_a*rot_vec.z) * vel.x;
+    new_vel.y += (rot_vec.y*rot_vec.z*one_minus_cos_a - sin_a*rot_vec.x) * vel.z;
+
+    new_vel.z = (cos_a + rot_vec.z*rot_vec.z*one_minus_cos_a) * vel.z;
+    new_vel.z += (rot_vec.x*rot_vec.z*one_minus_cos_a - sin_a*rot_vec.y) * vel.x;
+    new_vel.z += (rot_vec.y*rot_vec.z*one_minus_cos_a + sin_a*rot_vec.x) * vel.y;
+
+    // rescale the temperature
+    new_vel.x *= factor; new_vel.y *= factor; new_vel.z *= factor;
+
+    new_vel.x += avg_vel.x;
+    new_vel.y += avg_vel.y;
+    new_vel.z += avg_vel.z;
+
+    return new_vel;
+    }
+} // end namespace detail
+} // end namespace mpcd
+
 mpcd::SRDCollisionMethod::SRDCollisionMethod(std::shared_ptr<mpcd::SystemData> sysdata,
                                              unsigned int cur_timestep,
                                              unsigned int period,
@@ -36,7 +139,10 @@ mpcd::SRDCollisionMethod::~SRDCollisionMethod()
 
 void mpcd::SRDCollisionMethod::rule(unsigned int timestep)
     {
-    m_thermo->compute(timestep);
+    // on the CPU, the cell properties are computed in the same pass as the collision when possible
+    const bool fused = m_thermo->beginFusedCompute(timestep);
+    if (!fused)
+        m_thermo->compute(timestep);
 
     if (m_prof) m_prof->push(m_exec_conf, "MPCD collide");
     // resize the rotation vectors and rescale factors
@@ -46,11 +152,19 @@ void mpcd::SRDCollisionMethod::rule(unsigned int timestep)
         m_factors.resize(m_cl->getNCells());
         }
 
-    // draw rotation vectors for each cell
-    drawRotationVectors(timestep);
+    if (fused)
+        {
+        collideCells(timestep);
+        m_thermo->finishFusedCompute();
+        }
+    else
+        {
+        // draw rotation vectors for each cell
+        drawRotationVectors(timestep);
 
-    // apply collision rule
-    rotate(timestep);
+        // apply collision rule
+        rotate(timestep);
+        }
     if (m_prof) m_prof->pop(m_exec_conf);
     }
 
@@ -73,56 +187,41 @@ void mpcd::SRDCollisionMethod::drawRotationVectors(unsigned int timestep)
         T_set = (*m_T)(timestep);
         }
 
-    for (unsigned int k=0; k < ci.getD(); ++k)
+    // each cell draws from its own random number stream
+    const unsigned int ndim = m_sysdef->getNDimensions();
+    #ifdef ENABLE_TBB
+    tbb::parallel_for(tbb::blocked_range<unsigned int>(0, ci.getNumElements()),
+        [&](const tbb::blocked_range<unsigned int>& r) {
+        for (unsigned int idx = r.begin(); idx != r.end(); ++idx)
+    #else
+    for (unsigned int idx = 0; idx < ci.getNumElements(); ++idx)
+    #endif
         {
-        for (unsigned int j=0; j < ci.getH(); ++j)
-            {
-            for (unsigned int i=0; i < ci.getW(); ++i)
-                {
-                const int3 global_cell = m_cl->getGlobalCell(make_int3(i,j,k));
-                const unsigned int global_idx = global_ci(global_cell.x, global_cell.y, global_cell.z);
-                const unsigned int idx = ci(i,j,k);
-
-                // Initialize the PRNG using the current cell index, timestep, and seed for the hash
-                hoomd::RandomGenerator rng(hoomd::RNGIdentifier::SRDCollisionMethod, m_seed, global_idx, timestep);
-
-                // draw rotation vector off the surface of the sphere
-                double3 rotvec;
-                hoomd::SpherePointGenerator<double> sphgen;
-                sphgen(rng, rotvec);
-                h_rotvec.data[idx] = rotvec;
-
-                if (use_thermostat)
-                    {
-                    const double3 cell_energy = h_cell_energy->data[idx];
-                    const unsigned int np = __double_as_int(cell_energy.z);
-                    double factor = 1.0;
-                    if (np > 1)
-                        {
-                        // the total number of degrees of freedom in the cell divided by 2
-                        const double alpha = m_sysdef->getNDimensions()*(np-1)/(double)2.;
-
-                        // draw a random kinetic energy for the cell at the set temperature
-                        hoomd::GammaDistribution<double> gamma_gen(alpha,T_set);
-                        const double rand_ke = gamma_gen(rng);
-
-                        // generate the scale factor from the current temperature
-                        // (don't use the kinetic energy of this cell, since this
-                        // is total not relative to COM)
-                        const double cur_ke = alpha * cell_energy.y;
-                        factor = (cur_ke > 0.) ? fast::sqrt(rand_ke/cur_ke) : 1.;
-                        }
-                    h_factors->data[idx] = factor;
-                    }
-                }
-            }
+        const uint3 cell = ci.getTriple(idx);
+        const int3 global_cell = m_cl->getGlobalCell(make_int3(cell.x, cell.y, cell.z));
+        const unsigned int global_idx = global_ci(global_cell.x, global_cell.y, global_cell.z);
+
+        // Initialize the PRNG using the current cell index, timestep, and seed for the hash
+        hoomd::RandomGenerator rng(hoomd::RNGIdentifier::SRDCollisionMethod, m_seed, global_idx, timestep);
+
+        double3 rotvec;
+        double factor;
+        const double3 cell_energy = (use_thermostat) ? h_cell_energy->data[idx] : make_double3(0,0,0);
+        mpcd::detail::drawSRDCell(rotvec, factor, rng, use_thermostat, cell_energy, ndim, T_set);
+
+        h_rotvec.data[idx] = rotvec;
+        if (use_thermostat)
+            h_factors->data[idx] = factor;
         }
+    #ifdef ENABLE_TBB
+        });
+    #endif
     }
 
 void mpcd::SRDCollisionMethod::rotate(unsigned int timestep)
     {
     // acquire MPCD particle data
-    ArrayHandle<Scalar4> h_vel(m_mpcd_pdata->getVelocities(), access_location::host, access_mode::readwrite);
+    ArrayHandle<mpcd::StorageScalar4> h_vel(m_mpcd_pdata->getVelocities(), access_location::host, access_mode::readwrite);
     const unsigned int N_mpcd = m_mpcd_pdata->getN() + m_mpcd_pdata->getNVirtual();
     unsigned int N_tot = N_mpcd;
     // acquire additionally embedded particle data
@@ -143,7 +242,6 @@ void mpcd::SRDCollisionMethod::rotate(unsigned int timestep)
     // load rotation vector and precompute functions for rotation matrix
     ArrayHandle<double3> h_rotvec(m_rotvec, access_location::host, access_mode::read);
     const double cos_a = slow::cos(m_angle);
-    const double one_minus_cos_a = 1.0 - cos_a;
     const double sin_a = slow::sin(m_angle);
 
     // load scale factors if required
@@ -154,7 +252,13 @@ void mpcd::SRDCollisionMethod::rotate(unsigned int timestep)
         h_factors.reset(new ArrayHandle<double>(m_factors, access_location::host, access_mode::read));
         }
 
+    #ifdef ENABLE_TBB
+    tbb::parallel_for(tbb::blocked_range<unsigned int>(0, N_tot),
+        [&](const tbb::blocked_range<unsigned int>& r) {
+        for (unsigned int cur_p = r.begin(); cur_p != r.end(); ++cur_p)
+    #else
     for (unsigned int cur_p = 0; cur_p < N_tot; ++cur_p)
+    #endif
         {
         double3 vel;
         unsigned int cell;
@@ -162,7 +266,7 @@ void mpcd::SRDCollisionMethod::rotate(unsigned int timestep)
         unsigned int idx(0); double mass(0);
         if (cur_p < N_mpcd)
             {
-            const Scalar4 vel_cell = h_vel.data[cur_p];
+            const Scalar4 vel_cell = mpcd::storage_to_scalar4(h_vel.data[cur_p]);
             vel = make_double3(vel_cell.x, vel_cell.y, vel_cell.z);
             cell = __scalar_as_int(vel_cell.w);
             }
@@ -176,52 +280,157 @@ void mpcd::SRDCollisionMethod::rotate(unsigned int timestep)
             cell = h_embed_cell_ids->data[cur_p - N_mpcd];
             }
 
-        // subtract average velocity
-        const double4 avg_vel = h_cell_vel.data[cell];
-        vel.x -= avg_vel.x;
-        vel.y -= avg_vel.y;
-        vel.z -= avg_vel.z;
+        // rotate and rescale the velocity relative to the cell velocity
+        const double factor = (use_thermostat) ? h_factors->data[cell] : 1.0;
+        const double3 new_vel = mpcd::detail::rotateSRDVelocity(vel,
+                                                                h_cell_vel.data[cell],
+                                                                h_rotvec.data[cell],
+                                                                cos_a,
+                                                                sin_a,
+                                                                factor);
 
-        // get rotation vector
-        double3 rot_vec = h_rotvec.data[cell];
+        // set the new velocity
+        if (cur_p < N_mpcd)
+            {
+            h_vel.data[cur_p] = mpcd::make_storage_scalar4(new_vel.x, new_vel.y, new_vel.z, __int_as_scalar(cell));
+            }
+        else
+            {
+            h_vel_embed->data[idx] = make_scalar4(new_vel.x, new_vel.y, new_vel.z, mass);
+            }
+        }
+    #ifdef ENABLE_TBB
+        });
+    #endif
+    }
 
-        // perform the rotation in double precision
-        // TODO: should we optimize out the matrix construction for the CPU?
-        //       Or, consider using vectorization and/or Eigen?
-        double3 new_vel;
-        new_vel.x = (cos_a + rot_vec.x*rot_vec.x*one_minus_cos_a) * vel.x;
-        new_vel.x += (rot_vec.x*rot_vec.y*one_minus_cos_a - sin_a*rot_vec.z) * vel.y;
-        new_vel.x += (rot_vec.x*rot_vec.z*one_minus_cos_a + sin_a*rot_vec.y) * vel.z;
+/*!
+ * \param timestep Current timestep
+ *
+ * Each cell sums the momentum and energy of its particles, stores the cell properties into the
+ * CellThermoCompute, draws its rotation vector, and rotates the velocities of its particles. The
+ * particle velocities are read from memory once and written once, compared to the separate
+ * thermo, draw, and rotation passes that each stream over all particles. Particles that the
+ * mpcd::Sorter has put into cell order are accessed contiguously.
+ */
+void mpcd::SRDCollisionMethod::collideCells(unsigned int timestep)
+    {
+    // cell list
+    const Index3D& ci = m_cl->getCellIndexer();
+    const Index3D& global_ci = m_cl->getGlobalCellIndexer();
+    const Index2D& cli = m_cl->getCellListIndexer();
+    ArrayHandle<unsigned int> h_cell_list(m_cl->getCellList(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_cell_np(m_cl->getCellSizeArray(), access_location::host, access_mode::read);
 
-        new_vel.y = (cos_a + rot_vec.y*rot_vec.y*one_minus_cos_a) * vel.y;
-        new_vel.y += (rot_vec.x*rot_vec.y*one_minus_cos_a + sin_a*rot_vec.z) * vel.x;
-        new_vel.y += (rot_vec.y*rot_vec.z*one_minus_cos_a - sin_a*rot_vec.x) * vel.z;
+    // MPCD particle data
+    ArrayHandle<mpcd::StorageScalar4> h_vel(m_mpcd_pdata->getVelocities(), access_location::host, access_mode::readwrite);
+    const unsigned int N_mpcd = m_mpcd_pdata->getN() + m_mpcd_pdata->getNVirtual();
 
-        new_vel.z = (cos_a + rot_vec.z*rot_vec.z*one_minus_cos_a) * vel.z;
-        new_vel.z += (rot_vec.x*rot_vec.z*one_minus_cos_a - sin_a*rot_vec.y) * vel.x;
-        new_vel.z += (rot_vec.y*rot_vec.z*one_minus_cos_a + sin_a*rot_vec.x) * vel.y;
+    // embedded particle data
+    std::unique_ptr< ArrayHandle<Scalar4> > h_vel_embed;
+    std::unique_ptr< ArrayHandle<unsigned int> > h_embed_group;
+    if (m_embed_group)
+        {
+        h_embed_group.reset(new ArrayHandle<unsigned int>(m_embed_group->getIndexArray(), access_location::host, access_mode::read));
+        h_vel_embed.reset(new ArrayHandle<Scalar4>(m_pdata->getVelocities(), access_location::host, access_mode::readwrite));
+        }
 
-        // rescale the temperature if thermostatting is enabled
-        if (use_thermostat)
+    // cell properties
+    ArrayHandle<double4> h_cell_vel(m_thermo->getCellVelocities(), access_location::host, access_mode::overwrite);
+    ArrayHandle<double3> h_cell_energy(m_thermo->getCellEnergies(), access_location::host, access_mode::overwrite);
+    const bool need_energy = m_thermo->getFlags()[mpcd::detail::thermo_options::energy];
+    mpcd::detail::CellPropertySum summer(h_cell_list.data,
+                                         h_cell_np.data,
+                                         cli,
+                                         h_vel.data,
+                                         m_mpcd_pdata->getMass(),
+                                         (m_embed_group) ? h_vel_embed->data : NULL,
+                                         (m_embed_group) ? h_embed_group->data : NULL,
+                                         N_mpcd);
+
+    // rotation vectors and optional scale factors
+    ArrayHandle<double3> h_rotvec(m_rotvec, access_location::host, access_mode::overwrite);
+    const bool use_thermostat = (m_T) ? true : false;
+    std::unique_ptr< ArrayHandle<double> > h_factors;
+    Scalar T_set(1.0);
+    if (use_thermostat)
+        {
+        h_factors.reset(new ArrayHandle<double>(m_factors, access_location::host, access_mode::overwrite));
+        T_set = (*m_T)(timestep);
+        }
+    const double cos_a = slow::cos(m_angle);
+    const double sin_a = slow::sin(m_angle);
+    const unsigned int ndim = m_sysdef->getNDimensions();
+
+    // each cell is handled by one thread
+    #ifdef ENABLE_TBB
+    tbb::parallel_for(tbb::blocked_range<unsigned int>(0, ci.getNumElements()),
+        [&](const tbb::blocked_range<unsigned int>& r) {
+        for (unsigned int idx = r.begin(); idx != r.end(); ++idx)
+    #else
+    for (unsigned int idx = 0; idx < ci.getNumElements(); ++idx)
+    #endif
+        {
+        // compute the cell properties as CellThermoCompute does
+        double4 momentum; double ke(0.0); unsigned int np(0);
+        summer.compute(momentum, ke, np, idx, need_energy || use_thermostat);
+
+        const double mass = momentum.w;
+        double4 avg_vel = make_double4(0.0, 0.0, 0.0, mass);
+        if (mass > 0.)
             {
-            double factor = h_factors->data[cell];
-            new_vel.x *= factor; new_vel.y *= factor; new_vel.z *= factor;
+            avg_vel.x = momentum.x / mass;
+            avg_vel.y = momentum.y / mass;
+            avg_vel.z = momentum.z / mass;
             }
+        h_cell_vel.data[idx] = avg_vel;
 
-        new_vel.x += avg_vel.x;
-        new_vel.y += avg_vel.y;
-        new_vel.z += avg_vel.z;
-
-        // set the new velocity
-        if (cur_p < N_mpcd)
+        double3 cell_energy = make_double3(ke, 0.0, __int_as_double(np));
+        if (np > 1)
             {
-            h_vel.data[cur_p] = make_scalar4(new_vel.x, new_vel.y, new_vel.z, __int_as_scalar(cell));
+            const double ke_cm = 0.5 * mass * (avg_vel.x*avg_vel.x + avg_vel.y*avg_vel.y + avg_vel.z*avg_vel.z);
+            cell_energy.y = 2. * (ke - ke_cm) / (ndim * (np-1));
             }
-        else
+        if (need_energy)
+            h_cell_energy.data[idx] = cell_energy;
+
+        // draw the rotation vector
+        const uint3 cell = ci.getTriple(idx);
+        const int3 global_cell = m_cl->getGlobalCell(make_int3(cell.x, cell.y, cell.z));
+        const unsigned int global_idx = global_ci(global_cell.x, global_cell.y, global_cell.z);
+        hoomd::RandomGenerator rng(hoomd::RNGIdentifier::SRDCollisionMethod, m_seed, global_idx, timestep);
+
+        double3 rotvec;
+        double factor;
+        mpcd::detail::drawSRDCell(rotvec, factor, rng, use_thermostat, cell_energy, ndim, T_set);
+        h_rotvec.data[idx] = rotvec;
+        if (use_thermostat)
+            h_factors->data[idx] = factor;
+
+        // rotate the velocities of the particles in the cell, which are still in cache
+        for (unsigned int offset = 0; offset < np; ++offset)
             {
-            h_vel_embed->data[idx] = make_scalar4(new_vel.x, new_vel.y, new_vel.z, mass);
+            const unsigned int cur_p = h_cell_list.data[cli(offset, idx)];
+            if (cur_p < N_mpcd)
+                {
+                const Scalar4 vel_cell = mpcd::storage_to_scalar4(h_vel.data[cur_p]);
+                const double3 new_vel = mpcd::detail::rotateSRDVelocity(make_double3(vel_cell.x, vel_cell.y, vel_cell.z),
+                                                                        avg_vel, rotvec, cos_a, sin_a, factor);
+                h_vel.data[cur_p] = mpcd::make_storage_scalar4(new_vel.x, new_vel.y, new_vel.z, vel_cell.w);
+                }
+            else
+                {
+                const unsigned int pidx = h_embed_group->data[cur_p - N_mpcd];
+                const Scalar4 vel_mass = h_vel_embed->data[pidx];
+                const double3 new_vel = mpcd::detail::rotateSRDVelocity(make_double3(vel_mass.x, vel_mass.y, vel_mass.z),
+                                                                        avg_vel, rotvec, cos_a, sin_a, factor);
+                h_vel_embed->data[pidx] = make_scalar4(new_vel.x, new_vel.y, new_vel.z, vel_mass.w);
+                }
             }
         }
+    #ifdef ENABLE_TBB
+        });
+    #endif
     }
 
 /*!
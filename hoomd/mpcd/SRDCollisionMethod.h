@@ -102,6 +102,9 @@ class PYBIND11_EXPORT SRDCollisionMethod : public mpcd::CollisionMethod
 
         //! Apply rotation matrix to velocities
         virtual void rotate(unsigned int timestep);
+
+        //! Compute the cell properties and apply the collision rule in one pass over the cells
+        void collideCells(unsigned int timestep);
     };
 
 namespace detail
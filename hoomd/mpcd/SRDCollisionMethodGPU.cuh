@@ -13,6 +13,7 @@
 
 #include <cuda_runtime.h>
 
+#include "ParticleDataUtilities.h"
 #include "hoomd/HOOMDMath.h"
 #include "hoomd/Index1D.h"
 
@@ -34,7 +35,7 @@ cudaError_t srd_draw_vectors(double3 *d_rotvec,
                              const unsigned int n_dimensions,
                              const unsigned int block_size);
 
-cudaError_t srd_rotate(Scalar4 *d_vel,
+cudaError_t srd_rotate(mpcd::StorageScalar4 *d_vel,
                        Scalar4 *d_vel_embed,
                        const unsigned int *d_embed_group,
                        const unsigned int *d_embed_cell_ids,
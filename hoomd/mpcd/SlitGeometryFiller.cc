@@ -77,8 +77,8 @@ void mpcd::SlitGeometryFiller::computeNumFill()
  */
 void mpcd::SlitGeometryFiller::drawParticles(unsigned int timestep)
     {
-    ArrayHandle<Scalar4> h_pos(m_mpcd_pdata->getPositions(), access_location::host, access_mode::readwrite);
-    ArrayHandle<Scalar4> h_vel(m_mpcd_pdata->getVelocities(), access_location::host, access_mode::readwrite);
+    ArrayHandle<mpcd::StorageScalar4> h_pos(m_mpcd_pdata->getPositions(), access_location::host, access_mode::readwrite);
+    ArrayHandle<mpcd::StorageScalar4> h_vel(m_mpcd_pdata->getVelocities(), access_location::host, access_mode::readwrite);
     ArrayHandle<unsigned int> h_tag(m_mpcd_pdata->getTags(), access_location::host, access_mode::readwrite);
 
     const BoxDim& box = m_pdata->getBox();
@@ -104,20 +104,20 @@ void mpcd::SlitGeometryFiller::drawParticles(unsigned int timestep)
             }
 
         const unsigned int pidx = first_idx + i;
-        h_pos.data[pidx] = make_scalar4(hoomd::UniformDistribution<Scalar>(lo.x, hi.x)(rng),
-                                        hoomd::UniformDistribution<Scalar>(lo.y, hi.y)(rng),
-                                        hoomd::UniformDistribution<Scalar>(lo.z, hi.z)(rng),
-                                        __int_as_scalar(m_type));
+        h_pos.data[pidx] = mpcd::make_storage_scalar4(hoomd::UniformDistribution<Scalar>(lo.x, hi.x)(rng),
+                                                      hoomd::UniformDistribution<Scalar>(lo.y, hi.y)(rng),
+                                                      hoomd::UniformDistribution<Scalar>(lo.z, hi.z)(rng),
+                                                      __int_as_scalar(m_type));
 
         hoomd::NormalDistribution<Scalar> gen(vel_factor, 0.0);
         Scalar3 vel;
         gen(vel.x, vel.y, rng);
         vel.z = gen(rng);
         // TODO: should these be given zero net-momentum contribution (relative to the frame of reference?)
-        h_vel.data[pidx] = make_scalar4(vel.x + sign * m_geom->getVelocity(),
-                                        vel.y,
-                                        vel.z,
-                                        __int_as_scalar(mpcd::detail::NO_CELL));
+        h_vel.data[pidx] = mpcd::make_storage_scalar4(vel.x + sign * m_geom->getVelocity(),
+                                                      vel.y,
+                                                      vel.z,
+                                                      __int_as_scalar(mpcd::detail::NO_CELL));
         h_tag.data[pidx] = tag;
         }
     }
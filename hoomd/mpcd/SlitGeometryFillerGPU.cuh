@@ -14,6 +14,7 @@
 #include <cuda_runtime.h>
 
 #include "SlitGeometry.h"
+#include "ParticleDataUtilities.h"
 #include "hoomd/HOOMDMath.h"
 #include "hoomd/BoxDim.h"
 
@@ -23,8 +24,8 @@ namespace gpu
 {
 
 //! Draw virtual particles in the SlitGeometry
-cudaError_t slit_draw_particles(Scalar4 *d_pos,
-                                Scalar4 *d_vel,
+cudaError_t slit_draw_particles(mpcd::StorageScalar4 *d_pos,
+                                mpcd::StorageScalar4 *d_vel,
                                 unsigned int *d_tag,
                                 const mpcd::detail::SlitGeometry& geom,
                                 const Scalar z_min,
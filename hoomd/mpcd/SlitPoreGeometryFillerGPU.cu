@@ -42,8 +42,8 @@ namespace kernel
  * and local particle index. A random position is drawn within the cuboid. A random velocity
  * is drawn consistent with the speed of the moving wall.
  */
-__global__ void slit_pore_draw_particles(Scalar4 *d_pos,
-                                         Scalar4 *d_vel,
+__global__ void slit_pore_draw_particles(mpcd::StorageScalar4 *d_pos,
+                                         mpcd::StorageScalar4 *d_vel,
                                          unsigned int *d_tag,
                                          const BoxDim box,
                                          const Scalar4 *d_boxes,
@@ -101,20 +101,20 @@ __global__ void slit_pore_draw_particles(Scalar4 *d_pos,
 
     // initialize random number generator for positions and velocity
     hoomd::RandomGenerator rng(hoomd::RNGIdentifier::SlitPoreGeometryFiller, seed, tag, timestep);
-    d_pos[pidx] = make_scalar4(hoomd::UniformDistribution<Scalar>(lo.x, hi.x)(rng),
-                               hoomd::UniformDistribution<Scalar>(lo.y, hi.y)(rng),
-                               hoomd::UniformDistribution<Scalar>(lo.z, hi.z)(rng),
-                               __int_as_scalar(type));
+    d_pos[pidx] = mpcd::make_storage_scalar4(hoomd::UniformDistribution<Scalar>(lo.x, hi.x)(rng),
+                                             hoomd::UniformDistribution<Scalar>(lo.y, hi.y)(rng),
+                                             hoomd::UniformDistribution<Scalar>(lo.z, hi.z)(rng),
+                                             __int_as_scalar(type));
 
     hoomd::NormalDistribution<Scalar> gen(vel_factor, 0.0);
     Scalar3 vel;
     gen(vel.x, vel.y, rng);
     vel.z = gen(rng);
     // TODO: should these be given zero net-momentum contribution (relative to the frame of reference?)
-    d_vel[pidx] = make_scalar4(vel.x,
-                               vel.y,
-                               vel.z,
-                               __int_as_scalar(mpcd::detail::NO_CELL));
+    d_vel[pidx] = mpcd::make_storage_scalar4(vel.x,
+                                             vel.y,
+                                             vel.z,
+                                             __int_as_scalar(mpcd::detail::NO_CELL));
     }
 } // end namespace kernel
 
@@ -138,8 +138,8 @@ __global__ void slit_pore_draw_particles(Scalar4 *d_pos,
  *
  * \sa kernel::slit_pore_draw_particles
  */
-cudaError_t slit_pore_draw_particles(Scalar4 *d_pos,
-                                     Scalar4 *d_vel,
+cudaError_t slit_pore_draw_particles(mpcd::StorageScalar4 *d_pos,
+                                     mpcd::StorageScalar4 *d_vel,
                                      unsigned int *d_tag,
                                      const BoxDim& box,
                                      const Scalar4 *d_boxes,
@@ -110,19 +110,62 @@ void mpcd::Sorter::computeOrder(unsigned int timestep)
  * The sorted order is applied by swapping out the alternate per-particle data
  * arrays. The communication flags are \b not sorted in MPI because by design,
  * the caller is responsible for clearing out any old flags before using them.
+ *
+ * If the particle data uses compact storage, the alternate arrays are not needed.
+ * Instead, the order is applied in place by following each cycle of the permutation.
  */
 void mpcd::Sorter::applyOrder() const
     {
+    if (m_mpcd_pdata->getCompactStorage())
+        {
+        ArrayHandle<unsigned int> h_order(m_order, access_location::host, access_mode::read);
+        ArrayHandle<mpcd::StorageScalar4> h_pos(m_mpcd_pdata->getPositions(), access_location::host, access_mode::readwrite);
+        ArrayHandle<mpcd::StorageScalar4> h_vel(m_mpcd_pdata->getVelocities(), access_location::host, access_mode::readwrite);
+        ArrayHandle<unsigned int> h_tag(m_mpcd_pdata->getTags(), access_location::host, access_mode::readwrite);
+
+        // virtual particles are not sorted, so they are already in place
+        const unsigned int N = m_mpcd_pdata->getN();
+        std::vector<bool> placed(N, false);
+        for (unsigned int start=0; start < N; ++start)
+            {
+            if (placed[start]) continue;
+
+            // hold the data of the first particle of the cycle, which is overwritten first
+            const mpcd::StorageScalar4 pos = h_pos.data[start];
+            const mpcd::StorageScalar4 vel = h_vel.data[start];
+            const unsigned int tag = h_tag.data[start];
+
+            unsigned int idx = start;
+            while (true)
+                {
+                placed[idx] = true;
+                const unsigned int old_idx = h_order.data[idx];
+                if (old_idx == start)
+                    {
+                    h_pos.data[idx] = pos;
+                    h_vel.data[idx] = vel;
+                    h_tag.data[idx] = tag;
+                    break;
+                    }
+                h_pos.data[idx] = h_pos.data[old_idx];
+                h_vel.data[idx] = h_vel.data[old_idx];
+                h_tag.data[idx] = h_tag.data[old_idx];
+                idx = old_idx;
+                }
+            }
+        return;
+        }
+
     // apply the sorted order
         {
         ArrayHandle<unsigned int> h_order(m_order, access_location::host, access_mode::read);
 
-        ArrayHandle<Scalar4> h_pos(m_mpcd_pdata->getPositions(), access_location::host, access_mode::read);
-        ArrayHandle<Scalar4> h_vel(m_mpcd_pdata->getVelocities(), access_location::host, access_mode::read);
+        ArrayHandle<mpcd::StorageScalar4> h_pos(m_mpcd_pdata->getPositions(), access_location::host, access_mode::read);
+        ArrayHandle<mpcd::StorageScalar4> h_vel(m_mpcd_pdata->getVelocities(), access_location::host, access_mode::read);
         ArrayHandle<unsigned int> h_tag(m_mpcd_pdata->getTags(), access_location::host, access_mode::read);
 
-        ArrayHandle<Scalar4> h_pos_alt(m_mpcd_pdata->getAltPositions(), access_location::host, access_mode::overwrite);
-        ArrayHandle<Scalar4> h_vel_alt(m_mpcd_pdata->getAltVelocities(), access_location::host, access_mode::overwrite);
+        ArrayHandle<mpcd::StorageScalar4> h_pos_alt(m_mpcd_pdata->getAltPositions(), access_location::host, access_mode::overwrite);
+        ArrayHandle<mpcd::StorageScalar4> h_vel_alt(m_mpcd_pdata->getAltVelocities(), access_location::host, access_mode::overwrite);
         ArrayHandle<unsigned int> h_tag_alt(m_mpcd_pdata->getAltTags(), access_location::host, access_mode::overwrite);
 
         for (unsigned int idx=0; idx < m_mpcd_pdata->getN(); ++idx)
@@ -94,12 +94,12 @@ void mpcd::SorterGPU::applyOrder() const
         {
         ArrayHandle<unsigned int> d_order(m_order, access_location::device, access_mode::read);
 
-        ArrayHandle<Scalar4> d_pos(m_mpcd_pdata->getPositions(), access_location::device, access_mode::read);
-        ArrayHandle<Scalar4> d_vel(m_mpcd_pdata->getVelocities(), access_location::device, access_mode::read);
+        ArrayHandle<mpcd::StorageScalar4> d_pos(m_mpcd_pdata->getPositions(), access_location::device, access_mode::read);
+        ArrayHandle<mpcd::StorageScalar4> d_vel(m_mpcd_pdata->getVelocities(), access_location::device, access_mode::read);
         ArrayHandle<unsigned int> d_tag(m_mpcd_pdata->getTags(), access_location::device, access_mode::read);
 
-        ArrayHandle<Scalar4> d_pos_alt(m_mpcd_pdata->getAltPositions(), access_location::device, access_mode::overwrite);
-        ArrayHandle<Scalar4> d_vel_alt(m_mpcd_pdata->getAltVelocities(), access_location::device, access_mode::overwrite);
+        ArrayHandle<mpcd::StorageScalar4> d_pos_alt(m_mpcd_pdata->getAltPositions(), access_location::device, access_mode::overwrite);
+        ArrayHandle<mpcd::StorageScalar4> d_vel_alt(m_mpcd_pdata->getAltVelocities(), access_location::device, access_mode::overwrite);
         ArrayHandle<unsigned int> d_tag_alt(m_mpcd_pdata->getAltTags(), access_location::device, access_mode::overwrite);
 
         m_apply_tuner->begin();
@@ -120,17 +120,18 @@ void mpcd::SorterGPU::applyOrder() const
             {
             const unsigned int N = m_mpcd_pdata->getN();
             const unsigned int Nvirtual = m_mpcd_pdata->getNVirtual();
-            cudaMemcpyAsync(d_pos_alt.data + N, d_pos.data + N, Nvirtual*sizeof(Scalar4), cudaMemcpyDeviceToDevice);
-            cudaMemcpyAsync(d_vel_alt.data + N, d_vel.data + N, Nvirtual*sizeof(Scalar4), cudaMemcpyDeviceToDevice);
+            cudaMemcpyAsync(d_pos_alt.data + N, d_pos.data + N, Nvirtual*sizeof(mpcd::StorageScalar4), cudaMemcpyDeviceToDevice);
+            cudaMemcpyAsync(d_vel_alt.data + N, d_vel.data + N, Nvirtual*sizeof(mpcd::StorageScalar4), cudaMemcpyDeviceToDevice);
             cudaMemcpyAsync(d_tag_alt.data + N, d_tag.data + N, Nvirtual*sizeof(unsigned int), cudaMemcpyDeviceToDevice);
             cudaDeviceSynchronize();
             }
         }
 
-    // swap out sorted data
+    // swap out sorted data, and free the old order if storage is compact
     m_mpcd_pdata->swapPositions();
     m_mpcd_pdata->swapVelocities();
     m_mpcd_pdata->swapTags();
+    m_mpcd_pdata->releaseAlternate();
     }
 
 /*!
@@ -37,11 +37,11 @@ namespace kernel
  * Using one thread per particle, particle data is reordered from the old arrays
  * into the new arrays. This coalesces writes but fragments reads.
  */
-__global__ void sort_apply(Scalar4 *d_pos_alt,
-                           Scalar4 *d_vel_alt,
+__global__ void sort_apply(mpcd::StorageScalar4 *d_pos_alt,
+                           mpcd::StorageScalar4 *d_vel_alt,
                            unsigned int *d_tag_alt,
-                           const Scalar4 *d_pos,
-                           const Scalar4 *d_vel,
+                           const mpcd::StorageScalar4 *d_pos,
+                           const mpcd::StorageScalar4 *d_vel,
                            const unsigned int *d_tag,
                            const unsigned int *d_order,
                            const unsigned int N)
@@ -136,11 +136,11 @@ __global__ void sort_gen_reverse(unsigned int *d_rorder,
  *
  * \sa mpcd::gpu::kernel::sort_apply
  */
-cudaError_t sort_apply(Scalar4 *d_pos_alt,
-                       Scalar4 *d_vel_alt,
+cudaError_t sort_apply(mpcd::StorageScalar4 *d_pos_alt,
+                       mpcd::StorageScalar4 *d_vel_alt,
                        unsigned int *d_tag_alt,
-                       const Scalar4 *d_pos,
-                       const Scalar4 *d_vel,
+                       const mpcd::StorageScalar4 *d_pos,
+                       const mpcd::StorageScalar4 *d_vel,
                        const unsigned int *d_tag,
                        const unsigned int *d_order,
                        const unsigned int N,
@@ -41,6 +41,18 @@ using :py:meth:`~hoomd.mpcd.data.system.take_snapshot()` and
     # modify snapshot
     mpcd_sys.restore_snapshot(snap)
 
+To reduce the memory used by large solvents, the scratch copies of the MPCD
+particle data that are used for sorting and for the Andersen thermostat
+collisions can be allocated only when they are needed rather than held for
+the whole simulation::
+
+    mpcd_sys.particles.compact_storage = True
+
+This saves at most about half of the memory per MPCD particle. When HOOMD is
+built with ``ENABLE_MPCD_MIXED_PRECISION``, the positions and velocities are
+also stored in single precision, which halves their memory again in double
+precision builds. Snapshots are always in full precision.
+
 .. rubric:: MPCD and MPI
 
 MPCD supports MPI parallelization through domain decomposition. The MPCD data
@@ -17,7 +17,7 @@ HOOMD_UP_MAIN()
 
 //! Test for basic setup and functionality of the SRD collision method
 template<class CM>
-void at_collision_method_basic_test(std::shared_ptr<ExecutionConfiguration> exec_conf)
+void at_collision_method_basic_test(std::shared_ptr<ExecutionConfiguration> exec_conf, bool compact=false)
     {
     std::shared_ptr< SnapshotSystemData<Scalar> > snap( new SnapshotSystemData<Scalar>() );
     snap->global_box = BoxDim(2.0);
@@ -48,6 +48,7 @@ void at_collision_method_basic_test(std::shared_ptr<ExecutionConfiguration> exec
     // initialize system and collision method
     auto mpcd_sys = std::make_shared<mpcd::SystemData>(mpcd_sys_snap);
     std::shared_ptr<mpcd::ParticleData> pdata_4 = mpcd_sys->getParticleData();
+    pdata_4->setCompactStorage(compact);
 
     // thermos and temperature variant
     auto thermo = std::make_shared<mpcd::CellThermoCompute>(mpcd_sys);
@@ -81,6 +82,9 @@ void at_collision_method_basic_test(std::shared_ptr<ExecutionConfiguration> exec
     UP_ASSERT(collide->peekCollide(1));
     collide->collide(1);
 
+    // the random velocities are released after the collision with compact storage
+    UP_ASSERT(pdata_4->hasAlternate() == !compact);
+
     // ensure that momentum was conserved
     thermo->compute(2);
         {
@@ -182,6 +186,11 @@ UP_TEST( at_collision_method_basic )
     {
     at_collision_method_basic_test<mpcd::ATCollisionMethod>(std::make_shared<ExecutionConfiguration>(ExecutionConfiguration::CPU));
     }
+//! basic test case for MPCD ATCollisionMethod class with compact storage
+UP_TEST( at_collision_method_basic_compact )
+    {
+    at_collision_method_basic_test<mpcd::ATCollisionMethod>(std::make_shared<ExecutionConfiguration>(ExecutionConfiguration::CPU), true);
+    }
 //! test embedding of particles into the MPCD ATCollisionMethod class
 UP_TEST( at_collision_method_embed )
     {
@@ -193,6 +202,11 @@ UP_TEST( at_collision_method_basic_gpu )
     {
     at_collision_method_basic_test<mpcd::ATCollisionMethodGPU>(std::make_shared<ExecutionConfiguration>(ExecutionConfiguration::GPU));
     }
+//! basic test case for MPCD ATCollisionMethodGPU class with compact storage
+UP_TEST( at_collision_method_basic_compact_gpu )
+    {
+    at_collision_method_basic_test<mpcd::ATCollisionMethodGPU>(std::make_shared<ExecutionConfiguration>(ExecutionConfiguration::GPU), true);
+    }
 //! test embedding of particles into the MPCD ATCollisionMethodGPU class
 UP_TEST( at_collision_method_embed_gpu )
     {
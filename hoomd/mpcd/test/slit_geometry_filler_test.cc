@@ -47,8 +47,8 @@ void slit_fill_basic_test(std::shared_ptr<ExecutionConfiguration> exec_conf)
     UP_ASSERT_EQUAL(pdata->getNVirtual(), 2*(2*20*20)*2);
     // count that particles have been placed on the right sides
         {
-        ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::read);
-        ArrayHandle<Scalar4> h_vel(pdata->getVelocities(), access_location::host, access_mode::read);
+        ArrayHandle<mpcd::StorageScalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::read);
+        ArrayHandle<mpcd::StorageScalar4> h_vel(pdata->getVelocities(), access_location::host, access_mode::read);
         ArrayHandle<unsigned int> h_tag(pdata->getTags(), access_location::host, access_mode::read);
 
         // ensure first particle did not get overwritten
@@ -66,7 +66,7 @@ void slit_fill_basic_test(std::shared_ptr<ExecutionConfiguration> exec_conf)
             // tag should equal index on one rank with one filler
             UP_ASSERT_EQUAL(h_tag.data[i], i);
             // type should be set
-            UP_ASSERT_EQUAL(__scalar_as_int(h_pos.data[i].w), 1);
+            UP_ASSERT_EQUAL(mpcd::storage_scalar_as_int(h_pos.data[i].w), 1);
 
             const Scalar z = h_pos.data[i].z;
             if (z < Scalar(-5.0))
@@ -85,8 +85,8 @@ void slit_fill_basic_test(std::shared_ptr<ExecutionConfiguration> exec_conf)
     UP_ASSERT_EQUAL(pdata->getNVirtual(), 2*2*(2*20*20)*2);
     // count that particles have been placed on the right sides
         {
-        ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::read);
-        ArrayHandle<Scalar4> h_vel(pdata->getVelocities(), access_location::host, access_mode::read);
+        ArrayHandle<mpcd::StorageScalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::read);
+        ArrayHandle<mpcd::StorageScalar4> h_vel(pdata->getVelocities(), access_location::host, access_mode::read);
         ArrayHandle<unsigned int> h_tag(pdata->getTags(), access_location::host, access_mode::read);
 
         unsigned int N_lo(0), N_hi(0);
@@ -115,7 +115,7 @@ void slit_fill_basic_test(std::shared_ptr<ExecutionConfiguration> exec_conf)
     UP_ASSERT_EQUAL(pdata->getNVirtual(), 2*(20*20/2)*2);
     // count that particles have been placed on the right sides
         {
-        ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::read);
+        ArrayHandle<mpcd::StorageScalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::read);
         unsigned int N_lo(0), N_hi(0);
         for (unsigned int i=pdata->getN(); i < pdata->getN() + pdata->getNVirtual(); ++i)
             {
@@ -142,13 +142,13 @@ void slit_fill_basic_test(std::shared_ptr<ExecutionConfiguration> exec_conf)
         pdata->removeVirtualParticles();
         filler->fill(3+t);
 
-        ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::read);
-        ArrayHandle<Scalar4> h_vel(pdata->getVelocities(), access_location::host, access_mode::read);
+        ArrayHandle<mpcd::StorageScalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::read);
+        ArrayHandle<mpcd::StorageScalar4> h_vel(pdata->getVelocities(), access_location::host, access_mode::read);
 
         for (unsigned int i=pdata->getN(); i < pdata->getN() + pdata->getNVirtual(); ++i)
             {
             const Scalar z = h_pos.data[i].z;
-            const Scalar4 vel_cell = h_vel.data[i];
+            const Scalar4 vel_cell = mpcd::storage_to_scalar4(h_vel.data[i]);
             const Scalar3 vel = make_scalar3(vel_cell.x, vel_cell.y, vel_cell.z);
             if (z < Scalar(-5.0))
                 {
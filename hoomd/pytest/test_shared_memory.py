@@ -0,0 +1,106 @@
+import os
+
+import hoomd
+import numpy as np
+import pytest
+
+
+def _segment_name():
+    return f'hoomd_test_{os.getpid()}'
+
+
+def test_attach(simulation_factory, two_particle_snapshot_factory):
+    sim = simulation_factory(two_particle_snapshot_factory())
+    writer = hoomd.write.SharedMemory(_segment_name(),
+                                      hoomd.trigger.Periodic(1))
+    sim.operations.writers.append(writer)
+    sim.run(10)
+    assert writer.name == _segment_name()
+    assert writer.n_slots == 4
+
+
+def test_read(simulation_factory, two_particle_snapshot_factory):
+    sim = simulation_factory(two_particle_snapshot_factory())
+    logger = hoomd.logging.Logger(categories=['scalar'])
+    logger.add(sim, quantities=['timestep'])
+    writer = hoomd.write.SharedMemory(_segment_name(),
+                                      hoomd.trigger.Periodic(1),
+                                      n_slots=3,
+                                      log=logger)
+    sim.operations.writers.append(writer)
+    sim.run(5)
+
+    snap = sim.state.snapshot
+    if not snap.exists:
+        return
+
+    reader = hoomd.write.SharedMemoryReader(_segment_name())
+    assert reader.types == list(snap.particles.types)
+    assert reader.dimensions == 3
+    assert len(reader.log_names) == 1
+    assert reader.log_names[0].endswith('timestep')
+
+    n_frames = reader.frame
+    assert n_frames >= 3
+
+    frame = reader.read()
+    assert frame.frame == n_frames - 1
+    assert frame.timestep == sim.timestep
+    np.testing.assert_allclose(frame.box[:3], snap.configuration.box[:3])
+    np.testing.assert_allclose(frame.position,
+                               snap.particles.position,
+                               rtol=1e-6)
+    np.testing.assert_allclose(frame.orientation, snap.particles.orientation)
+    np.testing.assert_array_equal(frame.typeid, snap.particles.typeid)
+    assert frame.log[reader.log_names[0]] == sim.timestep
+
+    # older frames remain available until the ring buffer wraps around
+    previous = reader.read(n_frames - 2)
+    assert previous.timestep == sim.timestep - 1
+    assert reader.read(n_frames - 3) is not None
+    assert reader.read(n_frames - 4) is None
+    assert reader.read(n_frames) is None
+
+    reader.close()
+
+
+def test_invalid_name(simulation_factory, two_particle_snapshot_factory):
+    sim = simulation_factory(two_particle_snapshot_factory())
+    writer = hoomd.write.SharedMemory('invalid/name',
+                                      hoomd.trigger.Periodic(1))
+    sim.operations.writers.append(writer)
+    with pytest.raises(ValueError):
+        sim.run(1)
+
+
+def test_log_none(simulation_factory, two_particle_snapshot_factory):
+    sim = simulation_factory(two_particle_snapshot_factory())
+    logger = hoomd.logging.Logger(categories=['scalar'])
+    logger.add(sim, quantities=['timestep'])
+    writer = hoomd.write.SharedMemory(_segment_name(),
+                                      hoomd.trigger.Periodic(1),
+                                      log=logger)
+    assert writer.log is not None
+    writer.log = None
+    assert writer.log is None
+    writer.log = logger
+    assert writer.log is not None
+    with pytest.raises(ValueError):
+        writer.log = 'timestep'
+
+    sim.operations.writers.append(writer)
+    sim.run(2)
+
+    # quantities that are no longer logged are published as NaN
+    writer.log = None
+    sim.run(1)
+
+    if not sim.state.snapshot.exists:
+        return
+
+    reader = hoomd.write.SharedMemoryReader(_segment_name())
+    assert len(reader.log_names) == 1
+    previous = reader.read(1)
+    assert previous.log[reader.log_names[0]] == previous.timestep
+    assert np.isnan(reader.read().log[reader.log_names[0]])
+    reader.close()
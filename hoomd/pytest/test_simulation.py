@@ -106,6 +106,49 @@ def test_allows_compute_pressure(device, get_snapshot):
     assert sim.always_compute_pressure is True
 
 
+def test_instrument(simulation_factory, get_snapshot, device, tmp_path):
+    sim = hoomd.Simulation(device)
+    assert sim.instrument is False
+    with pytest.raises(RuntimeError):
+        sim.instrument = True
+
+    sim = simulation_factory(get_snapshot())
+    sim.instrument = True
+    assert sim.instrument is True
+
+    sim.operations.integrator = hoomd.md.Integrator(0.005)
+    sim.run(10)
+
+    times = sim.region_times(percentiles=[50, 100])
+    name = next(n for n in times if n.startswith('integrator:'))
+    assert times[name]['mean'] >= 0
+    assert times[name][50] <= times[name][100]
+
+    if device.communicator.num_ranks == 1:
+        filename = tmp_path / 'trace.json'
+        sim.write_trace(str(filename))
+        assert filename.exists()
+
+    sim.instrument = False
+    assert sim.instrument is False
+
+
+def test_profile(simulation_factory, get_snapshot, device):
+    sim = hoomd.Simulation(device)
+    with pytest.raises(RuntimeError):
+        sim.profile()
+
+    sim = simulation_factory(get_snapshot())
+    sim.operations.integrator = hoomd.md.Integrator(0.005)
+    sim.profile(perf_counters=True)
+    sim.run(10)
+    if device.communicator.rank == 0:
+        assert sim.profile_output.startswith('Simulation')
+
+    sim.profile(False)
+    sim.run(1)
+
+
 def test_run(simulation_factory, get_snapshot, device):
     sim = hoomd.Simulation(device)
     with pytest.raises(RuntimeError):
@@ -198,6 +241,47 @@ def test_state_from_gsd(simulation_factory, get_snapshot,
         assert_equivalent_snapshots(snap, sim.state.snapshot)
 
 
+@skip_gsd
+def test_state_from_gsd_topology(device, tmp_path):
+    """Bonded groups are initialized with their member particles."""
+    n = 100
+    snap = gsd.hoomd.Snapshot()
+    snap.configuration.box = [20, 20, 20, 0, 0, 0]
+    snap.particles.N = n
+    snap.particles.types = ['A', 'B']
+    snap.particles.typeid = np.arange(n) % 2
+    snap.particles.position = np.random.RandomState(1).uniform(
+        -10, 10, size=(n, 3))
+    snap.bonds.N = n - 1
+    snap.bonds.types = ['a', 'b']
+    snap.bonds.typeid = np.arange(n - 1) % 2
+    snap.bonds.group = [[i, i + 1] for i in range(n - 1)]
+    snap.angles.N = n - 2
+    snap.angles.types = ['c']
+    snap.angles.typeid = np.zeros(n - 2)
+    snap.angles.group = [[i, i + 1, i + 2] for i in range(n - 2)]
+
+    filename = tmp_path / "topology.gsd"
+    with gsd.hoomd.open(name=filename, mode='wb') as file:
+        file.append(snap)
+
+    sim = hoomd.Simulation(device)
+    sim.create_state_from_gsd(filename)
+    assert sim.state.N_particles == n
+
+    result = sim.state.snapshot
+    if result.exists:
+        np.testing.assert_allclose(result.particles.position,
+                                   snap.particles.position)
+        np.testing.assert_equal(result.particles.typeid, snap.particles.typeid)
+        assert result.bonds.N == n - 1
+        assert result.bonds.types == snap.bonds.types
+        np.testing.assert_equal(result.bonds.typeid, snap.bonds.typeid)
+        np.testing.assert_equal(result.bonds.group, snap.bonds.group)
+        assert result.angles.N == n - 2
+        np.testing.assert_equal(result.angles.group, snap.angles.group)
+
+
 def test_writer_order(simulation_factory, two_particle_snapshot_factory):
     """Ensure that writers run at the end of the loop step."""
 
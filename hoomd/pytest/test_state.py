@@ -161,6 +161,28 @@ def test_modify_snapshot(device, snap):
     assert_snapshots_equal(snap, snap2)
 
 
+def test_compact_tag_lookup(device, snap):
+    if isinstance(device, hoomd.device.GPU):
+        pytest.skip("The compact tag lookup is only available on the CPU")
+
+    sim = Simulation(device)
+    sim.create_state_from_snapshot(snap, compact_tag_lookup=True)
+    assert sim.state.compact_tag_lookup
+
+    snap2 = sim.state.snapshot
+    assert_snapshots_equal(snap, snap2)
+
+    # migrate particles between domains and check that nothing is lost
+    sim.operations.integrator = hoomd.md.Integrator(
+        0.005, methods=[hoomd.md.methods.NVE(filter=hoomd.filter.All())])
+    sim.run(10)
+
+    snap3 = sim.state.snapshot
+    if snap3.exists:
+        assert snap3.particles.N == snap.particles.N
+        numpy.testing.assert_equal(snap3.bonds.group, snap.bonds.group)
+
+
 def test_thermalize_particle_velocity(simulation_factory,
                                       lattice_snapshot_factory):
     snap = lattice_snapshot_factory()
@@ -93,7 +93,10 @@ class Simulation(metaclass=Loggable):
         else:
             self._system_communicator = None
 
-    def create_state_from_gsd(self, filename, frame=-1):
+    def create_state_from_gsd(self,
+                              filename,
+                              frame=-1,
+                              compact_tag_lookup=False):
         """Create the simulation state from a GSD file.
 
         Args:
@@ -101,19 +104,25 @@ class Simulation(metaclass=Loggable):
 
             frame (int): Index of the frame to read from the file. Negative
                 values index back from the last frame in the file.
+
+            compact_tag_lookup (bool): Look up particles and bonded groups by
+                tag in hash maps of the local and ghost tags instead of arrays
+                of the global size on every MPI rank. CPU only.
         """
         if self.state is not None:
             raise RuntimeError("Cannot initialize more than once\n")
         filename = _hoomd.mpi_bcast_str(filename,
                                         self.device._cpp_exec_conf)
-        # Grab snapshot and timestep
-        reader = _hoomd.GSDReader(self.device._cpp_exec_conf,
-                                  filename, abs(frame), frame < 0)
+        # Grab snapshot and timestep. With more than one rank, every rank
+        # reads a slice of the file.
+        reader = _hoomd.GSDReader(self.device._cpp_exec_conf, filename,
+                                  abs(frame), frame < 0, True)
         snapshot = Snapshot._from_cpp_snapshot(reader.getSnapshot(),
                                                self.device.communicator)
 
         step = reader.getTimeStep() if self.timestep is None else self.timestep
-        self._state = State(self, snapshot)
+        self._state = State(self, snapshot, reader.isDistributed(),
+                            compact_tag_lookup)
 
         reader.clearSnapshot()
         # Store System and Reader for Operations
@@ -121,7 +130,7 @@ class Simulation(metaclass=Loggable):
         self._init_communicator()
         self.operations._store_reader(reader)
 
-    def create_state_from_snapshot(self, snapshot):
+    def create_state_from_snapshot(self, snapshot, compact_tag_lookup=False):
         """Create the simulations state from a `Snapshot`.
 
         Args:
@@ -129,6 +138,10 @@ class Simulation(metaclass=Loggable):
                 the state from. A `gsd.hoomd.Snapshot` will first be
                 converted to a `hoomd.Snapshot`.
 
+            compact_tag_lookup (bool): Look up particles and bonded groups by
+                tag in hash maps of the local and ghost tags instead of arrays
+                of the global size on every MPI rank. CPU only.
+
 
         When `timestep` is `None` before calling, `create_state_from_snapshot`
         sets `timestep` to 0.
@@ -138,13 +151,13 @@ class Simulation(metaclass=Loggable):
 
         if isinstance(snapshot, Snapshot):
             # snapshot is hoomd.Snapshot
-            self._state = State(self, snapshot)
+            self._state = State(self, snapshot, False, compact_tag_lookup)
         elif _match_class_path(snapshot, 'gsd.hoomd.Snapshot'):
             # snapshot is gsd.hoomd.Snapshot
             snapshot = Snapshot._from_gsd_snapshot(
                     snapshot, self._device.communicator
                     )
-            self._state = State(self, snapshot)
+            self._state = State(self, snapshot, False, compact_tag_lookup)
         else:
             raise TypeError(
                 "Snapshot must be a hoomd.Snapshot or gsd.hoomd.Snapshot."
@@ -266,6 +279,115 @@ class Simulation(metaclass=Loggable):
             if value:
                 self._state._cpp_sys_def.getParticleData().setPressureFlag()
 
+    @property
+    def instrument(self):
+        """bool: Time the operations on every step (defaults to ``False``).
+
+        When `instrument` is True, `run` records the time spent in each tuner,
+        updater, force, writer, and communication phase on every time step.
+        Recording one region costs two clock reads, small enough to leave
+        enabled for production runs. Use `region_times` and `write_trace` to
+        read the results.
+
+        Note:
+            Times are measured on the host without synchronizing with the GPU.
+        """
+        if not hasattr(self, '_cpp_sys'):
+            return False
+        else:
+            return self._cpp_sys.getInstrumentation() is not None
+
+    @instrument.setter
+    def instrument(self, value):
+        if not hasattr(self, '_cpp_sys'):
+            raise RuntimeError('Cannot enable instrumentation without state')
+        else:
+            self._cpp_sys.enableInstrumentation(value)
+
+    def region_times(self, percentiles=(50, 90, 99)):
+        """Time spent per step in each instrumented region.
+
+        Args:
+            percentiles (list[float]): Percentiles to compute, in [0, 100].
+
+        Returns:
+            dict: For each region name, a dict with the ``mean`` and the
+            requested percentiles (keyed by percentile) of the time spent in
+            the region per step, in milliseconds. Only the most recent 1000
+            steps on which a region executed are included.
+
+        Region names combine the category of the operation (``tuner``,
+        ``updater``, ``integrator``, ``force``, ``constraint``, ``analyzer``,
+        or ``comm``) with its C++ class name.
+        """
+        if not self.instrument:
+            raise RuntimeError('Instrumentation is not enabled')
+
+        cpp_instrumentation = self._cpp_sys.getInstrumentation()
+        result = {}
+        for name in cpp_instrumentation.getRegionNames():
+            times = {'mean': cpp_instrumentation.getMean(name)}
+            for q in percentiles:
+                times[q] = cpp_instrumentation.getPercentile(name, q)
+            result[name] = times
+        return result
+
+    def write_trace(self, filename):
+        """Write the recent instrumented regions as a trace file.
+
+        Args:
+            filename (str): Name of the file to write.
+
+        The file is written in the Chrome trace event JSON format, which can be
+        opened in Perfetto (https://ui.perfetto.dev) or ``chrome://tracing``.
+        With more than one MPI rank, every rank writes its own file with the
+        rank inserted before the extension.
+        """
+        if not self.instrument:
+            raise RuntimeError('Instrumentation is not enabled')
+
+        communicator = self.device.communicator
+        if communicator.num_ranks > 1:
+            base, dot, ext = filename.rpartition('.')
+            if dot:
+                filename = f'{base}.{communicator.rank}.{ext}'
+            else:
+                filename = f'{filename}.{communicator.rank}'
+
+        self._cpp_sys.getInstrumentation().writeTrace(filename)
+
+    def profile(self, enable=True, perf_counters=False):
+        """Profile subsequent runs.
+
+        Args:
+            enable (bool): Set to `True` to profile runs.
+
+            perf_counters (bool): Set to `True` to also record hardware
+                performance counters.
+
+        At the end of every profiled `run`, the time spent in each phase of
+        the run is printed and available in `profile_output`. With more than
+        one MPI rank, the profile lists the minimum, mean, and maximum over
+        the ranks.
+
+        With `perf_counters`, the profile also lists the instructions per
+        cycle, the last level cache misses, and the memory bandwidth of each
+        phase. The bandwidth is estimated as one cache line per miss. The
+        counters require Linux and a ``/proc/sys/kernel/perf_event_paranoid``
+        setting that allows user space counting. The counters include all
+        CPU threads used by the run.
+        """
+        if not hasattr(self, '_cpp_sys'):
+            raise RuntimeError('Cannot enable profiling without state')
+        self._cpp_sys.enableProfiler(enable, perf_counters)
+
+    @property
+    def profile_output(self):
+        """str: Profile of the last profiled run (on the root rank)."""
+        if not hasattr(self, '_cpp_sys'):
+            return ''
+        return self._cpp_sys.getProfile()
+
     def run(self, steps, write_at_start=False):
         """Advance the simulation a number of steps.
 
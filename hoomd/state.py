@@ -59,7 +59,11 @@ class State:
         `State` object.
     """
 
-    def __init__(self, simulation, snapshot):
+    def __init__(self,
+                 simulation,
+                 snapshot,
+                 distributed=False,
+                 compact_tag_lookup=False):
         self._simulation = simulation
         snapshot._broadcast_box()
         domain_decomp = _create_domain_decomposition(
@@ -67,12 +71,14 @@ class State:
             snapshot._cpp_obj._global_box)
 
         if domain_decomp is not None:
+            # a distributed snapshot holds a slice of the system on every rank
             self._cpp_sys_def = _hoomd.SystemDefinition(
                 snapshot._cpp_obj, simulation.device._cpp_exec_conf,
-                domain_decomp)
+                domain_decomp, distributed, compact_tag_lookup)
         else:
             self._cpp_sys_def = _hoomd.SystemDefinition(
                 snapshot._cpp_obj, simulation.device._cpp_exec_conf)
+            self._cpp_sys_def.setCompactTagLookup(compact_tag_lookup)
 
         # Necessary for local snapshot API. This is used to ensure two local
         # snapshots are not contexted at once.
@@ -84,6 +90,17 @@ class State:
         # __hash__ and __eq__ from causing cache errors.
         self._groups = defaultdict(dict)
 
+    @property
+    def compact_tag_lookup(self):
+        """bool: True when particles and bonded groups are looked up by tag \
+        in per-rank hash maps.
+
+        Set with the ``compact_tag_lookup`` argument of
+        `hoomd.Simulation.create_state_from_gsd` and
+        `hoomd.Simulation.create_state_from_snapshot`.
+        """
+        return self._cpp_sys_def.getCompactTagLookup()
+
     @property
     def snapshot(self):
         r"""hoomd.Snapshot: All data of a simulation's current microstate.
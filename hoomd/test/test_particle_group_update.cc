@@ -0,0 +1,128 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+/*! \file test_particle_group_update.cc
+    \brief Unit tests for updating the ParticleGroup index lists when particles are reordered
+    \ingroup unit_tests
+*/
+
+// this include is necessary to get MPI included before anything else to support intel MPI
+#include "hoomd/ExecutionConfiguration.h"
+
+#include <iostream>
+#include <set>
+#include <random>
+
+#include "hoomd/ParticleGroup.h"
+#include "hoomd/SFCPackTuner.h"
+#include "hoomd/filter/ParticleFilterAll.h"
+#include "hoomd/filter/ParticleFilterType.h"
+
+using namespace std;
+
+#include "upp11_config.h"
+
+HOOMD_UP_MAIN();
+
+//! Check the local members of a group against the expected member tags
+void check_group(std::shared_ptr<ParticleData> pdata,
+                 std::shared_ptr<ParticleGroup> group,
+                 const std::set<unsigned int>& expected)
+    {
+    unsigned int n_members = group->getNumMembers();
+    UP_ASSERT_EQUAL(n_members, (unsigned int)expected.size());
+    UP_ASSERT_EQUAL(group->getNumMembersGlobal(), (unsigned int)expected.size());
+
+    // read the index list before acquiring the tags, it may be rebuilt
+    std::vector<unsigned int> member_idx(n_members);
+    for (unsigned int j = 0; j < n_members; ++j)
+        member_idx[j] = group->getMemberIndex(j);
+    std::vector<bool> is_member(pdata->getN());
+    for (unsigned int idx = 0; idx < pdata->getN(); ++idx)
+        is_member[idx] = group->isMember(idx);
+
+    ArrayHandle<unsigned int> h_tag(pdata->getTags(), access_location::host, access_mode::read);
+    for (unsigned int j = 0; j < n_members; ++j)
+        {
+        // the index list is in index order
+        if (j > 0)
+            UP_ASSERT(member_idx[j-1] < member_idx[j]);
+        UP_ASSERT(expected.count(h_tag.data[member_idx[j]]));
+        }
+
+    for (unsigned int idx = 0; idx < pdata->getN(); ++idx)
+        UP_ASSERT_EQUAL(is_member[idx], expected.count(h_tag.data[idx]) > 0);
+    }
+
+//! Sort the particles, change types and add particles, checking the group members after each step
+UP_TEST( ParticleGroup_reorder_test )
+    {
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(100, BoxDim(20.0), 2, 0, 0, 0, 0, exec_conf));
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<Scalar> uniform(-10.0, 10.0);
+    for (unsigned int tag = 0; tag < 100; ++tag)
+        {
+        pdata->setPosition(tag, make_scalar3(uniform(rng), uniform(rng), uniform(rng)));
+        pdata->setType(tag, tag % 3 == 0 ? 1 : 0);
+        }
+
+    std::shared_ptr<ParticleGroup> all(new ParticleGroup(sysdef,
+        std::shared_ptr<ParticleFilter>(new ParticleFilterAll())));
+    std::unordered_set<std::string> type_names = {pdata->getNameByType(1)};
+    std::shared_ptr<ParticleGroup> type1(new ParticleGroup(sysdef,
+        std::shared_ptr<ParticleFilter>(new ParticleFilterType(type_names))));
+
+    std::vector<unsigned int> odd_tags;
+    for (unsigned int tag = 1; tag < 100; tag += 2)
+        odd_tags.push_back(tag);
+    std::shared_ptr<ParticleGroup> odd(new ParticleGroup(sysdef, odd_tags));
+
+    std::set<unsigned int> all_tags, type1_tags, odd_tag_set(odd_tags.begin(), odd_tags.end());
+    for (unsigned int tag = 0; tag < 100; ++tag)
+        {
+        all_tags.insert(tag);
+        if (tag % 3 == 0)
+            type1_tags.insert(tag);
+        }
+
+    check_group(pdata, all, all_tags);
+    check_group(pdata, type1, type1_tags);
+    check_group(pdata, odd, odd_tag_set);
+
+    // a known permutation is applied to the index lists
+    std::shared_ptr<SFCPackTuner> sorter(new SFCPackTuner(sysdef,
+        std::shared_ptr<Trigger>(new PeriodicTrigger(1))));
+    sorter->update(0);
+
+    check_group(pdata, all, all_tags);
+    check_group(pdata, type1, type1_tags);
+    check_group(pdata, odd, odd_tag_set);
+
+    // a group of types follows the particle type
+    pdata->setType(4, 1);
+    type1_tags.insert(4);
+    pdata->setType(9, 0);
+    type1_tags.erase(9);
+
+    UP_ASSERT_EQUAL(type1->getNumMembers(), (unsigned int)type1_tags.size());
+    for (unsigned int j = 0; j < type1->getNumMembers(); ++j)
+        {
+        unsigned int idx = type1->getMemberIndex(j);
+        ArrayHandle<unsigned int> h_tag(pdata->getTags(), access_location::host, access_mode::read);
+        UP_ASSERT(type1_tags.count(h_tag.data[idx]));
+        }
+
+    // added particles are picked up by the implicit groups
+    unsigned int new_tag = pdata->addParticle(1);
+    all_tags.insert(new_tag);
+    type1_tags.insert(new_tag);
+
+    check_group(pdata, all, all_tags);
+    check_group(pdata, type1, type1_tags);
+    check_group(pdata, odd, odd_tag_set);
+    UP_ASSERT_EQUAL(all->getMemberTag(100), new_tag);
+    }
@@ -617,6 +617,46 @@ UP_TEST( ParticleData_test )
     UP_ASSERT(pdata_type_test.getTypeByName("test") == 1);
     }
 
+//! Test that the version of the particle data arrays follows modifications
+UP_TEST( ParticleData_version_test )
+    {
+    BoxDim box(10.0);
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    ParticleData pdata(5, box, 2, exec_conf);
+    unsigned int N = pdata.getN();
+
+    // read only access does not change the version
+    uint64_t version = pdata.getPositions().getVersion();
+        {
+        ArrayHandle<Scalar4> h_pos(pdata.getPositions(), access_location::host, access_mode::read);
+        }
+    UP_ASSERT_EQUAL(pdata.getPositions().getVersion(), version);
+
+    // the version changes when a writable handle is released
+        {
+        ArrayHandle<Scalar4> h_pos(pdata.getPositions(), access_location::host, access_mode::readwrite);
+        h_pos.data[2].z = Scalar(4.0);
+        UP_ASSERT_EQUAL(pdata.getPositions().getVersion(), version);
+        }
+    UP_ASSERT(pdata.getPositions().getVersion() > version);
+
+    // reordering the particles by swapping in the alternate array changes the version
+    version = pdata.getPositions().getVersion();
+        {
+        ArrayHandle<Scalar4> h_pos(pdata.getPositions(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_pos_alt(pdata.getAltPositions(), access_location::host, access_mode::overwrite);
+        for (unsigned int i = 0; i < N; i++)
+            h_pos_alt.data[i] = h_pos.data[N-1-i];
+        }
+    pdata.swapPositions();
+    UP_ASSERT(pdata.getPositions().getVersion() > version);
+
+    // swapping back does not restore an earlier version
+    version = pdata.getPositions().getVersion();
+    pdata.swapPositions();
+    UP_ASSERT(pdata.getPositions().getVersion() > version);
+    }
+
 //! Tests the RandomParticleInitializer class
 UP_TEST( Random_test )
     {
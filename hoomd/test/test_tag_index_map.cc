@@ -0,0 +1,251 @@
+// Copyright (c) 2009-2021 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+/*! \file test_tag_index_map.cc
+    \brief Unit tests for TagIndexMap, ActiveTagSet and the compact tag lookup in ParticleData and BondData
+    \ingroup unit_tests
+*/
+
+// this include is necessary to get MPI included before anything else to support intel MPI
+#include "hoomd/ExecutionConfiguration.h"
+
+#include <iostream>
+#include <map>
+#include <random>
+
+#include "hoomd/TagIndexMap.h"
+#include "hoomd/ParticleData.h"
+#include "hoomd/BondedGroupData.h"
+#include "hoomd/SnapshotSystemData.h"
+
+using namespace std;
+
+#include "upp11_config.h"
+
+HOOMD_UP_MAIN();
+
+//! Compare TagIndexMap against std::map under random insertions and deletions
+UP_TEST( TagIndexMap_random_test )
+    {
+    TagIndexMap map;
+    std::map<unsigned int, unsigned int> ref;
+    std::mt19937 rng(12345);
+    std::uniform_int_distribution<unsigned int> tag_dist(0, 999);
+
+    UP_ASSERT_EQUAL(map.size(), (unsigned int)0);
+    UP_ASSERT_EQUAL(map.find(7), TagIndexMap::not_found);
+
+    for (unsigned int i = 0; i < 20000; ++i)
+        {
+        unsigned int tag = tag_dist(rng);
+        switch (rng() % 3)
+            {
+            case 0:
+            case 1:
+                map.set(tag, i);
+                ref[tag] = i;
+                break;
+            case 2:
+                map.erase(tag);
+                ref.erase(tag);
+                break;
+            }
+
+        // the load factor stays at or below one half
+        UP_ASSERT(2*map.size() <= map.getCapacity());
+        }
+
+    UP_ASSERT_EQUAL(map.size(), (unsigned int)ref.size());
+    for (unsigned int tag = 0; tag < 1000; ++tag)
+        {
+        auto it = ref.find(tag);
+        UP_ASSERT_EQUAL(map.find(tag), it == ref.end() ? TagIndexMap::not_found : it->second);
+        }
+
+    // setting not_found erases the entry
+    unsigned int tag = ref.begin()->first;
+    map.set(tag, TagIndexMap::not_found);
+    UP_ASSERT_EQUAL(map.find(tag), TagIndexMap::not_found);
+    UP_ASSERT_EQUAL(map.size(), (unsigned int)ref.size()-1);
+
+    map.clear();
+    UP_ASSERT_EQUAL(map.size(), (unsigned int)0);
+    UP_ASSERT_EQUAL(map.find(ref.rbegin()->first), TagIndexMap::not_found);
+    }
+
+//! Check that both ActiveTagSet representations give the same answers
+UP_TEST( ActiveTagSet_test )
+    {
+    for (unsigned int compact = 0; compact < 2; ++compact)
+        {
+        ActiveTagSet set;
+        set.setCompact(compact);
+        set.assignRange(10);
+        UP_ASSERT_EQUAL(set.size(), (unsigned int)10);
+        UP_ASSERT_EQUAL(set.min(), (unsigned int)0);
+        UP_ASSERT_EQUAL(set.max(), (unsigned int)9);
+
+        set.erase(3);
+        set.erase(4);
+        set.erase(9);
+        set.erase(8);
+        UP_ASSERT_EQUAL(set.size(), (unsigned int)6);
+        UP_ASSERT(!set.contains(3));
+        UP_ASSERT(set.contains(5));
+        UP_ASSERT_EQUAL(set.max(), (unsigned int)7);
+        UP_ASSERT_EQUAL(set.nth(3), (unsigned int)5);
+        UP_ASSERT_EQUAL(set.next(2), (unsigned int)5);
+
+        // reinsert a hole and grow past the end
+        set.insert(4);
+        set.insert(12);
+        UP_ASSERT_EQUAL(set.size(), (unsigned int)8);
+        UP_ASSERT(set.contains(4));
+        UP_ASSERT(!set.contains(10));
+        UP_ASSERT_EQUAL(set.max(), (unsigned int)12);
+        UP_ASSERT_EQUAL(set.next(7), (unsigned int)12);
+        UP_ASSERT_EQUAL(set.nth(7), (unsigned int)12);
+
+        // switching representation keeps the contents
+        set.setCompact(!compact);
+        UP_ASSERT_EQUAL(set.size(), (unsigned int)8);
+        UP_ASSERT(!set.contains(3));
+        UP_ASSERT_EQUAL(set.nth(3), (unsigned int)4);
+        UP_ASSERT_EQUAL(set.max(), (unsigned int)12);
+
+        set.clear();
+        UP_ASSERT(set.empty());
+        }
+    }
+
+//! Add and remove particles with the compact tag lookup and compare to the dense lookup
+UP_TEST( ParticleData_compact_tag_lookup_test )
+    {
+    Scalar tol = Scalar(1e-6);
+    BoxDim box(10.0);
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    std::shared_ptr<ParticleData> dense(new ParticleData(20, box, 2, exec_conf));
+    std::shared_ptr<ParticleData> compact(new ParticleData(20, box, 2, exec_conf));
+    compact->setCompactTagLookup(true);
+    UP_ASSERT(compact->getCompactTagLookup());
+    UP_ASSERT_EXCEPTION(std::runtime_error, [&]{ compact->getRTags(); });
+
+    for (unsigned int tag = 0; tag < 20; ++tag)
+        {
+        Scalar3 pos = make_scalar3(Scalar(0.1)*tag, Scalar(-0.2)*tag, 0);
+        dense->setPosition(tag, pos);
+        compact->setPosition(tag, pos);
+        }
+
+    // remove some tags, recycle one and append new ones
+    unsigned int removed[] = {3, 17, 19, 0};
+    for (unsigned int tag : removed)
+        {
+        dense->removeParticle(tag);
+        compact->removeParticle(tag);
+        }
+    for (unsigned int i = 0; i < 3; ++i)
+        {
+        UP_ASSERT_EQUAL(dense->addParticle(1), compact->addParticle(1));
+        }
+
+    UP_ASSERT_EQUAL(dense->getNGlobal(), compact->getNGlobal());
+    UP_ASSERT_EQUAL(dense->getNumTags(), compact->getNumTags());
+    UP_ASSERT_EQUAL(dense->getMaximumTag(), compact->getMaximumTag());
+    for (unsigned int n = 0; n < dense->getNGlobal(); ++n)
+        {
+        unsigned int tag = dense->getNthTag(n);
+        UP_ASSERT_EQUAL(compact->getNthTag(n), tag);
+        UP_ASSERT_EQUAL(compact->getRTag(tag), dense->getRTag(tag));
+        UP_ASSERT_EQUAL(compact->getType(tag), dense->getType(tag));
+        }
+    for (unsigned int tag = 0; tag <= dense->getMaximumTag(); ++tag)
+        {
+        UP_ASSERT_EQUAL(compact->isTagActive(tag), dense->isTagActive(tag));
+        }
+
+    // the snapshots agree
+    SnapshotParticleData<Scalar> snap_dense, snap_compact;
+    dense->takeSnapshot(snap_dense);
+    compact->takeSnapshot(snap_compact);
+    UP_ASSERT_EQUAL(snap_dense.size, snap_compact.size);
+    for (unsigned int i = 0; i < snap_dense.size; ++i)
+        {
+        MY_CHECK_CLOSE(snap_dense.pos[i].x, snap_compact.pos[i].x, tol);
+        MY_CHECK_CLOSE(snap_dense.pos[i].y, snap_compact.pos[i].y, tol);
+        UP_ASSERT_EQUAL(snap_dense.type[i], snap_compact.type[i]);
+        }
+
+    // reinitialize from the snapshot in compact mode
+    compact->initializeFromSnapshot(snap_compact);
+    UP_ASSERT_EQUAL(compact->getNGlobal(), snap_compact.size);
+    for (unsigned int tag = 0; tag < snap_compact.size; ++tag)
+        {
+        UP_ASSERT_EQUAL(compact->getRTag(tag), tag);
+        }
+
+    // switching back restores the dense array
+    compact->removeParticle(5);
+    compact->setCompactTagLookup(false);
+    UP_ASSERT(!compact->getCompactTagLookup());
+    ArrayHandle<unsigned int> h_rtag(compact->getRTags(), access_location::host, access_mode::read);
+    UP_ASSERT_EQUAL(compact->getRTags().getNumElements(), compact->getNumTags());
+    ArrayHandle<unsigned int> h_tag(compact->getTags(), access_location::host, access_mode::read);
+    for (unsigned int idx = 0; idx < compact->getN(); ++idx)
+        {
+        UP_ASSERT_EQUAL(h_rtag.data[h_tag.data[idx]], idx);
+        }
+    UP_ASSERT_EQUAL(h_rtag.data[5], NOT_LOCAL);
+    }
+
+//! Add and remove bonds with the compact tag lookup
+UP_TEST( BondData_compact_tag_lookup_test )
+    {
+    BoxDim box(10.0);
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    std::shared_ptr<ParticleData> pdata(new ParticleData(10, box, 1, exec_conf));
+    pdata->setCompactTagLookup(true);
+    BondData bdata(pdata, 2);
+    bdata.setCompactTagLookup(true);
+    UP_ASSERT(bdata.getCompactTagLookup());
+
+    for (unsigned int i = 0; i < 9; ++i)
+        {
+        UP_ASSERT_EQUAL(bdata.addBondedGroup(Bond(i % 2, i, i+1)), i);
+        }
+    bdata.removeBondedGroup(4);
+    bdata.removeBondedGroup(8);
+    UP_ASSERT_EQUAL(bdata.getNGlobal(), (unsigned int)7);
+    UP_ASSERT_EQUAL(bdata.getMaximumTag(), (unsigned int)7);
+    UP_ASSERT_EQUAL(bdata.getNthTag(4), (unsigned int)5);
+    UP_ASSERT_EXCEPTION(std::runtime_error, [&]{ bdata.getGroupByTag(4); });
+    UP_ASSERT_EXCEPTION(std::runtime_error, [&]{ bdata.getRTags(); });
+
+    for (unsigned int n = 0; n < bdata.getNGlobal(); ++n)
+        {
+        unsigned int tag = bdata.getNthTag(n);
+        Bond b = bdata.getGroupByTag(tag);
+        UP_ASSERT_EQUAL(b.type, tag % 2);
+        UP_ASSERT_EQUAL(b.a, tag);
+        UP_ASSERT_EQUAL(b.b, tag+1);
+        }
+
+    // the snapshot round trip keeps the bonds in tag order
+    BondData::Snapshot snap;
+    bdata.takeSnapshot(snap);
+    UP_ASSERT_EQUAL(snap.size, (unsigned int)7);
+    bdata.initializeFromSnapshot(snap);
+    UP_ASSERT_EQUAL(bdata.getNGlobal(), (unsigned int)7);
+    for (unsigned int tag = 0; tag < 7; ++tag)
+        {
+        UP_ASSERT_EQUAL(bdata.getGroupByTag(tag).a, snap.groups[tag].tag[0]);
+        }
+
+    bdata.setCompactTagLookup(false);
+    ArrayHandle<unsigned int> h_rtag(bdata.getRTags(), access_location::host, access_mode::read);
+    for (unsigned int tag = 0; tag < 7; ++tag)
+        {
+        UP_ASSERT_EQUAL(h_rtag.data[tag], tag);
+        }
+    }
@@ -6,10 +6,17 @@
 #include "hoomd/ExecutionConfiguration.h"
 
 #include <iostream>
+#include <sstream>
 
 #include <math.h>
 #include "hoomd/ClockSource.h"
 #include "hoomd/Profiler.h"
+#include "hoomd/PerfCounters.h"
+
+#ifdef ENABLE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#endif
 
 
 #include "upp11_config.h"
@@ -114,6 +121,17 @@ UP_TEST(Profiler_test)
     UP_ASSERT(p.getTotalFlopCount() == 7+8+11);
     UP_ASSERT(p.getTotalMemByteCount() == 9+9+12);
 
+    // hardware counters of the children
+    int64_t counters[PerfCounters::num_counters];
+    p.getChildCounterTotal(counters);
+    UP_ASSERT(counters[PerfCounters::cycles] == 0);
+    p.m_children["A"].m_counter_total[PerfCounters::cycles] = 13;
+    p.m_children["B"].m_counter_total[PerfCounters::cycles] = 14;
+    p.m_children["A"].m_children["C"].m_counter_total[PerfCounters::cycles] = 15;
+    p.getChildCounterTotal(counters);
+    UP_ASSERT(counters[PerfCounters::cycles] == 13+14);
+    UP_ASSERT(counters[PerfCounters::instructions] == 0);
+
     Profiler prof("Main");
     prof.push("Loading");
     Sleep(500);
@@ -136,6 +154,12 @@ UP_TEST(Profiler_test)
 
     std::cout << prof;
 
+    // the profile with counters is also printed when they are not available
+    Profiler prof_counters("Counters", true);
+    prof_counters.push("Work");
+    prof_counters.pop();
+    std::cout << prof_counters;
+
     // This code attempts to reproduce the problem found in ticket #50
     Profiler prof2("test");
     prof2.push("test1");
@@ -145,3 +169,63 @@ UP_TEST(Profiler_test)
     std::cout << prof2;
 
     }
+
+//! Busy loop that retires instructions
+static double busy_work(unsigned int n)
+    {
+    volatile double x = 1.0;
+    for (unsigned int i = 0; i < n; i++)
+        x = x * 1.000001 + 1e-9;
+    return x;
+    }
+
+//! check that the hardware counters count a busy region, when they are available
+UP_TEST(PerfCounters_test)
+    {
+    PerfCounters counters;
+    if (!counters.isAvailable())
+        {
+        std::cout << "Hardware performance counters are not available, skipping" << std::endl;
+        return;
+        }
+    UP_ASSERT(counters.getNumThreads() >= 1);
+
+    uint64_t start[PerfCounters::num_counters];
+    uint64_t end[PerfCounters::num_counters];
+    counters.read(start);
+    busy_work(10000000);
+    counters.read(end);
+
+    // the loop retires several instructions per iteration
+    UP_ASSERT(end[PerfCounters::instructions] > start[PerfCounters::instructions] + 10000000);
+    UP_ASSERT(end[PerfCounters::cycles] > start[PerfCounters::cycles]);
+
+    #ifdef ENABLE_TBB
+    // work done by the task scheduler threads is counted
+    counters.read(start);
+    tbb::parallel_for(tbb::blocked_range<unsigned int>(0, 64),
+        [](const tbb::blocked_range<unsigned int>& r)
+        {
+        for (unsigned int i = r.begin(); i != r.end(); ++i)
+            busy_work(1000000);
+        });
+    counters.read(end);
+    UP_ASSERT(end[PerfCounters::instructions] > start[PerfCounters::instructions] + 64000000);
+    #endif
+
+    // a busy profiled region reports a nonzero IPC
+    Profiler prof("Counters", true);
+    UP_ASSERT(prof.hasPerfCounters());
+    prof.push("Work");
+    busy_work(10000000);
+    prof.pop();
+
+    std::ostringstream out;
+    out << prof;
+    std::string profile = out.str();
+    size_t work = profile.find("Work");
+    UP_ASSERT(work != std::string::npos);
+    size_t ipc = profile.find("IPC", work);
+    UP_ASSERT(ipc != std::string::npos);
+    UP_ASSERT(atof(profile.c_str() + ipc + 3) > 0.0);
+    }
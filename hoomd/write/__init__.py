@@ -1,4 +1,5 @@
 from hoomd.write.custom_writer import CustomWriter
 from hoomd.write.gsd import GSD
 from hoomd.write.dcd import DCD
+from hoomd.write.shared_memory import SharedMemory, SharedMemoryReader
 from hoomd.write.table import Table
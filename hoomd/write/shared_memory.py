@@ -0,0 +1,264 @@
+# Copyright (c) 2009-2021 The Regents of the University of Michigan This file is
+# part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+"""Publish simulation frames to shared memory for live analysis."""
+
+from collections import namedtuple
+from multiprocessing import shared_memory, resource_tracker
+import struct
+
+import numpy as np
+
+from hoomd import _hoomd
+from hoomd.filter import ParticleFilter, All
+from hoomd.data.parameterdicts import ParameterDict
+from hoomd.logging import Logger, LoggerCategories
+from hoomd.operation import Writer
+from hoomd.util import dict_flatten
+
+
+class SharedMemory(Writer):
+    r"""Publish simulation frames to a shared memory ring buffer.
+
+    Args:
+        name (str): Name of the POSIX shared memory segment.
+        trigger (hoomd.trigger.Trigger): Select the timesteps to publish.
+        filter (hoomd.filter.ParticleFilter): Select the particles to publish.
+            Defaults to `hoomd.filter.All`.
+        n_slots (int): Number of frames in the ring buffer. Defaults to 4.
+        log (hoomd.logging.Logger): Provide scalar log quantities to publish.
+            Defaults to `None`.
+
+    `SharedMemory` copies the positions, orientations, and type ids of the
+    selected particles (in ascending tag order), the box, and the scalar
+    quantities in `log` into the shared memory segment ``/name`` each time it
+    triggers. Analysis processes on the same node read the frames in place with
+    `SharedMemoryReader`, without writing trajectory files and without
+    serializing the data.
+
+    The segment is a ring buffer of *n_slots* frames. `SharedMemory` never waits
+    for readers: the oldest frame is overwritten when the buffer is full, and
+    readers detect overwritten frames by their sequence numbers. Choose
+    *n_slots* large enough that readers keep up with the simulation.
+
+    `SharedMemory` creates the segment the first time it triggers, sized for the
+    number of selected particles and the log quantities at that time. The
+    segment is removed when the writer is removed from the simulation. An
+    existing segment with the same name is replaced.
+
+    Note:
+        With MPI domain decomposition, the frames are gathered and published by
+        the root rank.
+
+    Example::
+
+        writer = hoomd.write.SharedMemory(name='hoomd_live',
+                                          trigger=hoomd.trigger.Periodic(100))
+        sim.operations.writers.append(writer)
+
+        # in the analysis process
+        reader = hoomd.write.SharedMemoryReader('hoomd_live')
+        frame = reader.read()
+
+    The layout of the segment is defined in ``SharedMemoryWriter.h``, so that
+    analysis codes in other languages can read it directly.
+
+    Attributes:
+        name (str): Name of the POSIX shared memory segment.
+        trigger (hoomd.trigger.Trigger): Select the timesteps to publish.
+        filter (hoomd.filter.ParticleFilter): Select the particles to publish.
+        n_slots (int): Number of frames in the ring buffer.
+    """
+
+    def __init__(self, name, trigger, filter=All(), n_slots=4, log=None):
+
+        super().__init__(trigger)
+
+        self._param_dict.update(
+            ParameterDict(name=str(name),
+                          filter=ParticleFilter,
+                          n_slots=int(n_slots),
+                          _defaults=dict(filter=filter)))
+
+        self._log = None if log is None else _SharedMemoryLogWriter(log)
+
+    def _attach(self):
+        self._cpp_obj = _hoomd.SharedMemoryWriter(
+            self._simulation.state._cpp_sys_def, self.name,
+            self._simulation.state._get_group(self.filter), self.n_slots)
+        self._cpp_obj.log_writer = self.log
+        super()._attach()
+
+    @property
+    def log(self):
+        """hoomd.logging.Logger: Provide scalar log quantities to publish.
+
+        May be `None`. Only quantities in the **scalar** category are published.
+        Set `log` before the first frame is published; quantities added later
+        are not published. Quantities that are no longer logged, e.g. after
+        setting `log` to `None`, are published as NaN.
+        """
+        return self._log
+
+    @log.setter
+    def log(self, log):
+        if isinstance(log, Logger):
+            log = _SharedMemoryLogWriter(log)
+        elif log is not None:
+            raise ValueError(
+                "SharedMemory.log can only be set with a Logger or None.")
+        if self._attached:
+            self._cpp_obj.log_writer = log
+        self._log = log
+
+
+class _SharedMemoryLogWriter:
+    """Helper class to publish the scalar quantities of a logger."""
+
+    def __init__(self, logger):
+        self.logger = logger
+
+    def log(self):
+        """Get the flattened dictionary of scalar quantities."""
+        log = dict()
+        for key, value in dict_flatten(self.logger.log()).items():
+            log_value, type_category = value
+            if (LoggerCategories[type_category] == LoggerCategories.scalar
+                    and log_value is not None):
+                log['/'.join(key)] = float(log_value)
+        return log
+
+
+_header_format = '=8sIIQQIIIIQQQQQ'
+_slot_header_format = '=QQII6d'
+_name_length = 64
+
+Frame = namedtuple(
+    'Frame',
+    ['frame', 'timestep', 'box', 'position', 'orientation', 'typeid', 'log'])
+Frame.__doc__ = """A frame read from a shared memory segment.
+
+Attributes:
+    frame (int): Index of the frame.
+    timestep (int): Time step of the frame.
+    box (list[float]): Box ``[Lx, Ly, Lz, xy, xz, yz]``.
+    position ((*N*, 3) `numpy.ndarray` of ``numpy.float32``): Positions.
+    orientation ((*N*, 4) `numpy.ndarray` of ``numpy.float32``):
+        Orientations.
+    typeid ((*N*, ) `numpy.ndarray` of ``numpy.uint32``): Type ids.
+    log (dict[str, float]): Log quantities.
+"""
+
+
+class SharedMemoryReader:
+    """Read frames published by `SharedMemory`.
+
+    Args:
+        name (str): Name of the POSIX shared memory segment.
+
+    `SharedMemoryReader` maps the segment written by a `SharedMemory` writer
+    in the same or in another process on the same node.
+
+    Attributes:
+        types (list[str]): Names of the particle types.
+        log_names (list[str]): Names of the published log quantities.
+        dimensions (int): Dimensionality of the system.
+    """
+
+    def __init__(self, name):
+        try:
+            self._shm = shared_memory.SharedMemory(name=name, track=False)
+        except TypeError:
+            # Python < 3.13 registers attached segments with the resource
+            # tracker, which would remove the segment when the reader exits
+            self._shm = shared_memory.SharedMemory(name=name)
+            resource_tracker.unregister(self._shm._name, 'shared_memory')
+
+        self._buf = self._shm.buf
+        header = struct.unpack_from(_header_format, self._buf, 0)
+        (magic, version, self._n_slots, self._slot_offset, self._slot_bytes,
+         self._max_N, n_types, n_log, self.dimensions, _,
+         self._position_offset, self._orientation_offset, self._typeid_offset,
+         self._log_offset) = header
+        if magic != b'HOOMDSHM' or version != 1:
+            self.close()
+            raise RuntimeError(f"{name} is not a HOOMD shared memory segment.")
+
+        names_offset = (struct.calcsize(_header_format) + 63) & ~63
+        names = [
+            bytes(self._buf[names_offset + i * _name_length:names_offset
+                            + (i + 1) * _name_length]).split(b'\0')[0].decode()
+            for i in range(n_types + n_log)
+        ]
+        self.types = names[:n_types]
+        self.log_names = names[n_types:]
+
+    @property
+    def frame(self):
+        """int: Number of frames published so far."""
+        return int(
+            np.frombuffer(self._buf, dtype=np.uint64, count=1, offset=48)[0])
+
+    def read(self, frame=None):
+        """Read a frame.
+
+        Args:
+            frame (int): Index of the frame to read. Defaults to the most
+                recently published frame.
+
+        Returns:
+            Frame: The frame, or `None` when the frame is not available (it
+            has not been published yet or it has already been overwritten).
+        """
+        latest = frame is None
+        while True:
+            if latest:
+                frame = self.frame - 1
+            if frame < 0:
+                return None
+
+            result = self._read_slot(frame)
+            if result is not None or not latest:
+                return result
+
+    def _read_slot(self, frame):
+        """Copy a frame from its slot, or return None when it is invalid."""
+        offset = self._slot_offset + (frame % self._n_slots) * self._slot_bytes
+        expected = 2 * frame + 2
+
+        seq = np.frombuffer(self._buf, dtype=np.uint64, count=1, offset=offset)
+        if int(seq[0]) != expected:
+            return None
+
+        _, timestep, N, _, *box = struct.unpack_from(_slot_header_format,
+                                                     self._buf, offset)
+        position = np.frombuffer(self._buf,
+                                 dtype=np.float32,
+                                 count=N * 3,
+                                 offset=offset
+                                 + self._position_offset).reshape(N, 3).copy()
+        orientation = np.frombuffer(
+            self._buf,
+            dtype=np.float32,
+            count=N * 4,
+            offset=offset + self._orientation_offset).reshape(N, 4).copy()
+        typeid = np.frombuffer(self._buf,
+                               dtype=np.uint32,
+                               count=N,
+                               offset=offset + self._typeid_offset).copy()
+        log_values = np.frombuffer(self._buf,
+                                   dtype=np.float64,
+                                   count=len(self.log_names),
+                                   offset=offset + self._log_offset)
+        log = dict(zip(self.log_names, log_values.tolist()))
+
+        # the writer may have started to overwrite the slot during the copy
+        if int(seq[0]) != expected:
+            return None
+
+        return Frame(frame, timestep, box, position, orientation, typeid, log)
+
+    def close(self):
+        """Unmap the shared memory segment."""
+        self._buf = None
+        self._shm.close()